@@ -0,0 +1,240 @@
+#!/usr/bin/env python3
+
+"""
+Decoder of a dump of the log ring (see LogRing in source/include/logging/cs_LogRing.h).
+
+The log ring holds the most recent binary logs, also after a reset. Dump it with gdb, for example:
+	dump binary value logs.bin _logRing
+Then decode it with:
+	scripts/log-ring-decoder.py logs.bin
+"""
+import argparse
+import os
+import re
+import struct
+
+defaultSourceFilesDir = os.path.abspath(f"{os.path.dirname(os.path.abspath(__file__))}/../source")
+
+# Layout of the log ring state, keep in sync with LogRing.
+LOG_RING_MAGIC = 0x4C4F4752
+STATE_FORMAT = "<IHHHHHHIHH?"
+
+# Log ring record header: size, type, checksum.
+RECORD_HEADER_FORMAT = "<HBB"
+RECORD_HEADER_SIZE = 4
+RECORD_ALIGNMENT = 4
+RECORD_TYPE_PADDING = 0xFF
+
+# Record types, keep in sync with LogRingRecordType in cs_Logger.cpp.
+RECORD_TYPE_LOG = 0
+RECORD_TYPE_LOG_ARRAY = 1
+
+# uart_msg_log_common_header_t: fileNameHash, lineNumber, logLevel, flags.
+LOG_COMMON_HEADER_FORMAT = "<IHBB"
+LOG_COMMON_HEADER_SIZE = 8
+
+# ElementType in cs_UartMsgTypes.h.
+ELEMENT_TYPE_SIGNED_INTEGER = 0
+ELEMENT_TYPE_UNSIGNED_INTEGER = 1
+ELEMENT_TYPE_FLOAT = 2
+
+LOG_LEVELS = {3: "F", 4: "E", 5: "W", 6: "I", 7: "D", 8: "V", 9: "VV"}
+
+FORMAT_SPECIFIER = re.compile(r"%([-+ #0]*\d*(?:\.\d+)?)(hh|h|ll|l|z|j|t|L)?([diuxXfFeEgGcsp%])")
+LOG_CALL = re.compile(r"\b(LOG\w*|_log|_logArray)\s*\(")
+STRING_LITERAL = re.compile(r'"((?:[^"\\]|\\.)*)"')
+
+
+def fileNameHash(fileName):
+	"""
+	Same as fileNameHash() in cs_Logger.h: a hash over the reversed file name, including the null terminator.
+	"""
+	hash = 5381
+	for c in reversed(fileName.encode() + b"\0"):
+		hash = (hash * 33 + c) & 0xFFFFFFFF
+	return hash
+
+
+class SourceFiles:
+	def __init__(self, sourceFilesDir):
+		self.files = {}
+		for root, dirs, files in os.walk(sourceFilesDir):
+			for fileName in files:
+				if fileName.endswith((".cpp", ".h", ".c")):
+					self.files.setdefault(fileNameHash(fileName), os.path.join(root, fileName))
+		self.lines = {}
+
+	def getFileName(self, hash):
+		path = self.files.get(hash)
+		return os.path.basename(path) if path else f"{hash:08X}"
+
+	def getFormat(self, hash, lineNumber):
+		"""
+		Get the format string of the log, of which the ; is at the given line.
+		"""
+		path = self.files.get(hash)
+		if path is None:
+			return None
+		if path not in self.lines:
+			with open(path, errors="replace") as file:
+				self.lines[path] = file.read().split("\n")
+		lines = self.lines[path]
+		if lineNumber < 1 or lineNumber > len(lines):
+			return None
+		# Search back for the start of the log call, a log can span multiple lines.
+		for start in range(lineNumber - 1, max(lineNumber - 20, 0) - 1, -1):
+			text = "\n".join(lines[start:lineNumber])
+			calls = list(LOG_CALL.finditer(text))
+			if calls:
+				literals = STRING_LITERAL.findall(text[calls[-1].end():])
+				if not literals:
+					return ""
+				return bytes("".join(literals), "utf-8").decode("unicode_escape")
+		return None
+
+
+def readLogRing(data):
+	"""
+	Get the type and payload of all records in the dump, oldest first, and whether it's the first unsent record.
+	"""
+	stateSize = struct.calcsize(STATE_FORMAT)
+	magic, bufferSize, head, tail, sent, used, unsent, lostRecords, writeIndex, writeEnd, writing = \
+		struct.unpack_from(STATE_FORMAT, data, 0)
+	if magic != LOG_RING_MAGIC:
+		raise ValueError(f"Invalid magic: {magic:08X}")
+	bufferOffset = len(data) - bufferSize
+	if bufferOffset < stateSize:
+		raise ValueError(f"Dump of {len(data)} bytes is too small for a buffer of {bufferSize} bytes")
+	buffer = data[bufferOffset:]
+	print(f"Log ring: {used} bytes used, {unsent} bytes unsent, {lostRecords} records lost")
+
+	records = []
+	index = tail
+	left = used
+	firstUnsent = False
+	while left > 0:
+		if unsent != 0 and index == sent:
+			firstUnsent = True
+		size, type, checksum = struct.unpack_from(RECORD_HEADER_FORMAT, buffer, index)
+		recordSize = (RECORD_HEADER_SIZE + size + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1)
+		if recordSize > left or index + recordSize > bufferSize:
+			raise ValueError(f"Invalid record at {index}")
+		if type != RECORD_TYPE_PADDING:
+			payload = buffer[index + RECORD_HEADER_SIZE: index + RECORD_HEADER_SIZE + size]
+			total = size + (size >> 8) + type + sum(payload)
+			if (~total & 0xFF) != checksum:
+				print(f"Checksum mismatch of record at {index}")
+			records.append((type, payload, firstUnsent))
+			firstUnsent = False
+		index = (index + recordSize) % bufferSize
+		left -= recordSize
+	return records
+
+
+def unpackInt(data, signed):
+	return int.from_bytes(data, "little", signed=signed)
+
+
+def formatArg(spec, length, conversion, arg):
+	if conversion in "di":
+		return f"%{spec}d" % unpackInt(arg, True)
+	if conversion in "uxXc":
+		return f"%{spec}{conversion}" % unpackInt(arg, False)
+	if conversion == "p":
+		return "0x%x" % unpackInt(arg, False)
+	if conversion in "fFeEgG":
+		value = struct.unpack("<f" if len(arg) == 4 else "<d", arg)[0]
+		return f"%{spec}{conversion}" % value
+	if conversion == "s":
+		return f"%{spec}s" % arg.decode(errors="replace")
+	return "?"
+
+
+def formatLog(fmt, args):
+	result = ""
+	pos = 0
+	argIndex = 0
+	for match in FORMAT_SPECIFIER.finditer(fmt):
+		result += fmt[pos:match.start()]
+		pos = match.end()
+		spec, length, conversion = match.groups()
+		if conversion == "%":
+			result += "%"
+			continue
+		if argIndex >= len(args):
+			result += match.group(0)
+			continue
+		result += formatArg(spec, length, conversion, args[argIndex])
+		argIndex += 1
+	return result + fmt[pos:]
+
+
+def decodeLog(sourceFiles, payload):
+	fileHash, lineNumber, logLevel, flags = struct.unpack_from(LOG_COMMON_HEADER_FORMAT, payload, 0)
+	numArgs = payload[LOG_COMMON_HEADER_SIZE]
+	index = LOG_COMMON_HEADER_SIZE + 1
+	args = []
+	for i in range(numArgs):
+		argSize = payload[index]
+		args.append(payload[index + 1: index + 1 + argSize])
+		index += 1 + argSize
+	fmt = sourceFiles.getFormat(fileHash, lineNumber)
+	if fmt is None:
+		text = "(format not found) " + " ".join(arg.hex() for arg in args)
+	else:
+		text = formatLog(fmt, args)
+	return fileHash, lineNumber, logLevel, text
+
+
+def decodeLogArray(payload):
+	fileHash, lineNumber, logLevel, flags = struct.unpack_from(LOG_COMMON_HEADER_FORMAT, payload, 0)
+	elementType = payload[LOG_COMMON_HEADER_SIZE]
+	elementSize = payload[LOG_COMMON_HEADER_SIZE + 1]
+	data = payload[LOG_COMMON_HEADER_SIZE + 2:]
+	elements = []
+	for i in range(0, len(data) - elementSize + 1, max(elementSize, 1)):
+		element = data[i: i + elementSize]
+		if elementType == ELEMENT_TYPE_SIGNED_INTEGER:
+			elements.append(str(unpackInt(element, True)))
+		elif elementType == ELEMENT_TYPE_FLOAT:
+			elements.append(str(struct.unpack("<f" if elementSize == 4 else "<d", element)[0]))
+		else:
+			elements.append(str(unpackInt(element, False)))
+	return fileHash, lineNumber, logLevel, "[" + ", ".join(elements) + "]"
+
+
+def main():
+	argParser = argparse.ArgumentParser(description="Decoder of a dump of the log ring")
+	argParser.add_argument('dumpFile',
+	                       metavar='path',
+	                       type=str,
+	                       help='The binary dump of the log ring.')
+	argParser.add_argument('--sourceFilesDir',
+	                       '-s',
+	                       dest='sourceFilesDir',
+	                       metavar='path',
+	                       type=str,
+	                       default=f"{defaultSourceFilesDir}",
+	                       help='The path with the bluenet source code files of the firmware that made the dump.')
+	args = argParser.parse_args()
+
+	with open(args.dumpFile, "rb") as file:
+		data = file.read()
+	records = readLogRing(data)
+	sourceFiles = SourceFiles(args.sourceFilesDir)
+	for type, payload, firstUnsent in records:
+		if firstUnsent:
+			print("---- Logs below have not been sent ----")
+		if type == RECORD_TYPE_LOG:
+			fileHash, lineNumber, logLevel, text = decodeLog(sourceFiles, payload)
+		elif type == RECORD_TYPE_LOG_ARRAY:
+			fileHash, lineNumber, logLevel, text = decodeLogArray(payload)
+		else:
+			print(f"Unknown record type {type}")
+			continue
+		fileName = sourceFiles.getFileName(fileHash)
+		print(f"[{fileName}:{lineNumber}] {LOG_LEVELS.get(logLevel, logLevel)} {text}")
+
+
+if __name__ == "__main__":
+	main()
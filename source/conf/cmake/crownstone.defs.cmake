@@ -115,6 +115,10 @@ ADD_DEFINITIONS("-DSERIAL_VERBOSITY=${SERIAL_VERBOSITY}")
 ADD_DEFINITIONS("-DCS_SERIAL_NRF_LOG_ENABLED=${CS_SERIAL_NRF_LOG_ENABLED}")
 ADD_DEFINITIONS("-DCS_SERIAL_BOOTLOADER_NRF_LOG_ENABLED=${CS_SERIAL_BOOTLOADER_NRF_LOG_ENABLED}")
 ADD_DEFINITIONS("-DCS_UART_BINARY_PROTOCOL_ENABLED=${CS_UART_BINARY_PROTOCOL_ENABLED}")
+ADD_DEFINITIONS("-DCS_SERIAL_TX_BUFFER_SIZE=${CS_SERIAL_TX_BUFFER_SIZE}")
+ADD_DEFINITIONS("-DCS_SERIAL_TX_BLOCK_WHEN_FULL=${CS_SERIAL_TX_BLOCK_WHEN_FULL}")
+ADD_DEFINITIONS("-DCS_UART_RX_NUM_FRAMES=${CS_UART_RX_NUM_FRAMES}")
+ADD_DEFINITIONS("-DCS_SERIAL_LOG_RING_SIZE=${CS_SERIAL_LOG_RING_SIZE}")
 
 # UICR options (across firmware and bootloader, needs separate cs_SharedConfig.h file if removed here)
 ADD_DEFINITIONS("-DUICR_DFU_INDEX=${UICR_DFU_INDEX}")
@@ -142,6 +146,19 @@ ADD_DEFINITIONS("-DBUILD_CLOSEST_CROWNSTONE_TRACKER=${BUILD_CLOSEST_CROWNSTONE_T
 # Build for memory usage test
 ADD_DEFINITIONS("-DBUILD_MEM_USAGE_TEST=${BUILD_MEM_USAGE_TEST}")
 
+# Number of CRC lookup tables
+ADD_DEFINITIONS("-DCRC_TABLE_SLICES=${CRC_TABLE_SLICES}")
+
+# Lookup index for exact match filters
+ADD_DEFINITIONS("-DEXACT_MATCH_FILTER_INDEX=${EXACT_MATCH_FILTER_INDEX}")
+
+# Cache of flash record descriptors in storage
+ADD_DEFINITIONS("-DCS_STORAGE_RECORD_CACHE_SIZE=${CS_STORAGE_RECORD_CACHE_SIZE}")
+
+# Combine scans of the same device in the mesh scanner
+ADD_DEFINITIONS("-DCS_MESH_SCANNER_COALESCE_WINDOW_MS=${CS_MESH_SCANNER_COALESCE_WINDOW_MS}")
+ADD_DEFINITIONS("-DCS_MESH_SCANNER_RING_SIZE=${CS_MESH_SCANNER_RING_SIZE}")
+
 # Publish options as CMake options as well
 SET(NRF5_DIR                                    "${NRF5_DIR}"                       CACHE STRING "Nordic SDK Directory" FORCE)
 SET(NORDIC_SDK_VERSION                          "${NORDIC_SDK_VERSION}"             CACHE STRING "Nordic SDK Version" FORCE)
@@ -104,3 +104,12 @@ typedef uint32_t ret_code_t;
 #ifdef __cplusplus
 }
 #endif
+
+#if defined(HOST_TARGET) && defined(__cplusplus)
+// The host implementations of the SDK, see include/host. They are C++, so they're left out when included from C code.
+extern "C++" {
+#include <host/cs_HostSdk.h>
+#include <host/cs_HostFds.h>
+#include <host/cs_HostFstorage.h>
+}
+#endif
@@ -293,6 +293,7 @@ enum class CS_TYPE: uint16_t {
 	EVT_MESH_RSSI_DATA,                               // TODO: remove this type, it's not used.
 	EVT_MESH_TIME_SYNC,                               // A time sync message was received
 	EVT_RECV_MESH_MSG,                                // A mesh message was received.
+	CMD_GET_MESH_STATS,                               // Get mesh statistics, replied via UART.
 
 	// Behaviour
 	CMD_ADD_BEHAVIOUR = InternalBaseBehaviour,        // Add a behaviour.
@@ -346,6 +347,7 @@ enum class CS_TYPE: uint16_t {
 	CMD_GET_GPREGRET,                                 // Get the Nth general purpose retention register as it was on boot.
 	CMD_GET_ADC_CHANNEL_SWAPS,                        // Get number of detected ADC channel swaps.
 	CMD_GET_RAM_STATS,                                // Get RAM statistics.
+	CMD_GET_BOOT_TIMINGS,                             // Get the duration of the boot phases.
 
 	CMD_MICROAPP_GET_INFO,                            // Microapp control command.
 	CMD_MICROAPP_UPLOAD,                              // Microapp control command. The data pointer is assume to remain valid until write is completed!
@@ -566,6 +568,7 @@ typedef  BOOL TYPIFY(CMD_ENABLE_LOG_FILTERED_CURRENT);
 typedef  BOOL TYPIFY(CMD_ENABLE_LOG_POWER);
 typedef  BOOL TYPIFY(CMD_ENABLE_LOG_VOLTAGE);
 typedef  BOOL TYPIFY(CMD_ENABLE_MESH);
+typedef  void TYPIFY(CMD_GET_MESH_STATS);
 typedef  void TYPIFY(CMD_INC_VOLTAGE_RANGE);
 typedef  void TYPIFY(CMD_INC_CURRENT_RANGE);
 typedef  cs_mesh_model_msg_device_register_t TYPIFY(EVT_MESH_TRACKED_DEVICE_REGISTER);
@@ -665,6 +668,7 @@ typedef void TYPIFY(CMD_GET_RESET_REASON);
 typedef uint8_t TYPIFY(CMD_GET_GPREGRET);
 typedef void TYPIFY(CMD_GET_ADC_CHANNEL_SWAPS);
 typedef void TYPIFY(CMD_GET_RAM_STATS);
+typedef void TYPIFY(CMD_GET_BOOT_TIMINGS);
 typedef void TYPIFY(CMD_MICROAPP_GET_INFO);
 typedef microapp_upload_internal_t TYPIFY(CMD_MICROAPP_UPLOAD);
 typedef microapp_ctrl_header_t TYPIFY(CMD_MICROAPP_VALIDATE);
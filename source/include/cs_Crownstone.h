@@ -387,6 +387,20 @@ private:
 
 	static cs_ram_stats_t _ramStats;
 
+	//! Duration of the boot phases.
+	cs_boot_timings_t _bootTimings;
+
+	//! RTC count at the start of the boot, and at the start of the current boot phase.
+	uint32_t _bootStartCount = 0;
+	uint32_t _bootPhaseStartCount = 0;
+
+	/**
+	 * End the current boot phase, and start the next.
+	 *
+	 * @return                    Duration of the phase that ended, in µs.
+	 */
+	uint32_t nextBootPhase();
+
 	/**
 	 * If storage was recovered by erasing all pages, we want to set some state variables
 	 * different than after a factory reset.
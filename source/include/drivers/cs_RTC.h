@@ -76,6 +76,11 @@ public:
 		return (uint32_t)ROUNDED_DIV((uint64_t)65536 * ticks, (uint64_t)65536 * RTC_CLOCK_FREQ / (NRF_RTC0->PRESCALER + 1) / 1000);
 	}
 
+	/** Return time in µs, given time in ticks */
+	inline static uint32_t ticksToUs(uint32_t ticks) {
+		return (uint64_t)ticks * 1000000 * (NRF_RTC0->PRESCALER + 1) / RTC_CLOCK_FREQ;
+	}
+
 	/** Return time in ticks, given time in ms
 	 * Make sure time in ms is not too large! (limit is 512,000 ms with current frequency)
 	 */
@@ -18,24 +18,9 @@ extern "C" {
 
 #include <stdint.h>
 #include <util/cs_BleError.h>
+#include <logging/cs_LogLevels.h>
 
 
-/**
- * The log levels follow more or less common conventions with a few exceptions. There are some modes in which we run
- * where even fatal messages will not be written to console. In production we use SERIAL_NONE, SERIAL_READ_ONLY, or
- * SERIAL_BYTE_PROTOCOL_ONLY.
- */
-#define SERIAL_NONE                 0
-#define SERIAL_READ_ONLY            1
-#define SERIAL_BYTE_PROTOCOL_ONLY   2
-#define SERIAL_FATAL                3
-#define SERIAL_ERROR                4
-#define SERIAL_WARN                 5
-#define SERIAL_INFO                 6
-#define SERIAL_DEBUG                7
-#define SERIAL_VERBOSE              8
-#define SERIAL_VERY_VERBOSE         9
-
 #define SERIAL_CRLF "\r\n"
 
 #ifndef SERIAL_VERBOSITY
@@ -43,6 +28,22 @@ extern "C" {
 #define SERIAL_VERBOSITY SERIAL_NONE
 #endif
 
+/**
+ * Size of the TX buffer in bytes, should be a power of 2.
+ */
+#ifndef CS_SERIAL_TX_BUFFER_SIZE
+#define CS_SERIAL_TX_BUFFER_SIZE 1024
+#endif
+
+/**
+ * What to do when the TX buffer is full.
+ * 0: drop what doesn't fit, and count the dropped bytes.
+ * 1: wait until there is space, like writing without buffer did.
+ */
+#ifndef CS_SERIAL_TX_BLOCK_WHEN_FULL
+#define CS_SERIAL_TX_BLOCK_WHEN_FULL 0
+#endif
+
 typedef enum {
 	SERIAL_ENABLE_NONE      = 0,
 	SERIAL_ENABLE_RX_ONLY   = 1,
@@ -87,9 +88,45 @@ bool serial_tx_ready();
 
 /**
  * Write a single byte.
+ *
+ * The byte is added to the TX buffer, and sent in the background.
  */
 void serial_write(uint8_t val);
 
+/**
+ * Write bytes.
+ *
+ * The bytes are added to the TX buffer, and sent in the background.
+ */
+void serial_write_buffer(const uint8_t* data, uint16_t size);
+
+/**
+ * Check if a number of bytes can be written to the TX buffer.
+ *
+ * Use this before writing a message in multiple parts, so that either the whole message is written, or nothing.
+ * When the bytes don't fit, they are counted as dropped.
+ *
+ * @return     True when the bytes can be written.
+ */
+bool serial_tx_reserve(uint16_t size);
+
+/**
+ * Send all bytes in the TX buffer, and wait until they are sent.
+ *
+ * Busy waits with interrupts blocked, so only use this before a reset, or when handling a fault.
+ */
+void serial_flush();
+
+/**
+ * Get the number of bytes that can be written to the TX buffer, without dropping or waiting.
+ */
+uint16_t serial_tx_free();
+
+/**
+ * Get the total number of bytes that were dropped, because the TX buffer was full.
+ */
+uint32_t serial_get_tx_dropped_bytes();
+
 #ifdef __cplusplus
 }
 #endif
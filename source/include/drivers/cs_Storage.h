@@ -8,7 +8,8 @@
 
 #include <ble/cs_Nordic.h>
 #include <common/cs_Types.h>
-#include <components/libraries/fds/fds.h>
+#include <drivers/cs_StorageRecordCache.h>
+#include <drivers/cs_StorageStats.h>
 #include <storage/cs_StateData.h>
 #include <util/cs_Utils.h>
 
@@ -26,6 +27,13 @@ enum cs_storage_operation_t {
 
 typedef void (*cs_storage_error_callback_t) (cs_storage_operation_t operation, CS_TYPE type, cs_state_id_t id);
 
+/**
+ * Called by readAll() for each stored value.
+ *
+ * The data points to flash, and is only valid during the call. The size is padded to a multiple of 4.
+ */
+typedef void (*cs_storage_read_callback_t) (const cs_state_data_t & data);
+
 /**
  * Class to store items persistently in flash (persistent) memory.
  *
@@ -51,6 +59,10 @@ typedef void (*cs_storage_error_callback_t) (cs_storage_operation_t operation, C
  * collection. You can't write a record while it's already being written. This is what the "busy" functions are for.
  * Each type can be set busy multiple times, for example in case multiple records of the same type are being deleted.
  *
+ * Descriptors of written and read records are kept in a cache, so that writing a record usually doesn't have to search
+ * flash for the previous record first. Writes can be collected in a commit group, so that the records that are not
+ * in the cache are all searched for at once.
+ *
  * FDS internally uses events NRF_EVT_FLASH_OPERATION_SUCCESS and NRF_EVT_FLASH_OPERATION_ERROR.
  * These events don't give any context of the operation, so it is not adviced to use FDS together with something else
  * that writes to flash (like Flash Manager).
@@ -166,6 +178,21 @@ public:
 	 */
 	cs_ret_code_t readNext(cs_state_data_t & data);
 
+	/**
+	 * Read all stored values, in a single pass over flash.
+	 *
+	 * Values are read in the order they are stored, so in case of duplicates (values with same type and id), the
+	 * latest value comes last.
+	 *
+	 * NOTE: no other storage operations should be done during the callback.
+	 *
+	 * @param[in] callback        Function that is called for each stored value.
+	 *
+	 * @retval ERR_SUCCESS                  When all values have been read.
+	 * @retval ERR_BUSY                     When busy, try again later.
+	 */
+	cs_ret_code_t readAll(cs_storage_read_callback_t callback);
+
 	/**
 	 * Write to persistent storage.
 	 *
@@ -181,6 +208,32 @@ public:
 	 */
 	cs_ret_code_t write(const cs_state_data_t & data);
 
+	/**
+	 * Start collecting writes, to write them all at once with commitGroup().
+	 *
+	 * While collecting, write() only checks whether the data can be written, and returns ERR_SUCCESS without writing.
+	 * A later write of the same type and id replaces the collected one, and removing a type and id drops it.
+	 */
+	void beginCommitGroup();
+
+	/**
+	 * Write all writes collected since beginCommitGroup().
+	 *
+	 * Records that are not in the cache are searched for in a single pass over flash.
+	 * Writes that can't be started are reported via the error callback, like a write that failed afterwards.
+	 *
+	 * @retval ERR_SUCCESS                  When all collected writes were started.
+	 * @retval ERR_BUSY                     When some writes were reported via the error callback.
+	 */
+	cs_ret_code_t commitGroup();
+
+	/**
+	 * Get the flash statistics: bytes written and busy retries per type, garbage collections, and searches.
+	 */
+	const StorageStats& getStats() const {
+		return _stats;
+	}
+
 	/**
 	 * Remove value of given type and id.
 	 *
@@ -303,6 +356,24 @@ private:
 	bool _performingFactoryReset = false;
 	std::vector<uint16_t> _busyRecordKeys;
 
+	StorageRecordCache _recordCache;
+	StorageStats _stats;
+
+	/**
+	 * A write collected in a commit group.
+	 *
+	 * recordDesc and recordExists are only valid once found is true.
+	 */
+	struct cs_storage_group_item_t {
+		cs_state_data_t data;
+		fds_record_desc_t recordDesc;
+		bool recordExists;
+		bool found;
+	};
+
+	bool _collectingGroup = false;
+	std::vector<cs_storage_group_item_t> _group;
+
 	/**
 	 * Next page to erase. Used by eraseAllPages().
 	 */
@@ -336,6 +407,23 @@ private:
 	*/
 	ret_code_t writeInternal(const cs_state_data_t & data);
 
+	/**
+	 * Write or update a record, once it's known whether it exists.
+	 *
+	 * @param[in,out] recordDesc                 Descriptor of the existing record, set to the new record afterwards.
+	 */
+	ret_code_t writeRecord(const cs_state_data_t & data, fds_record_desc_t & recordDesc, bool recordExists);
+
+	/**
+	 * Find the records of the collected writes that are not in the cache, with a single pass over flash.
+	 */
+	void findGroupRecords();
+
+	/**
+	 * Drop collected writes of given record key and/or file id.
+	 */
+	void removeFromGroup(const uint16_t* recordKey, const uint16_t* fileId);
+
 	ret_code_t garbageCollectInternal();
 
 	bool isErasingPages();
@@ -0,0 +1,86 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#ifdef HOST_TARGET
+#include <host/cs_HostFds.h>
+#else
+#include <components/libraries/fds/fds.h>
+#endif
+
+#ifndef CS_STORAGE_RECORD_CACHE_SIZE
+#define CS_STORAGE_RECORD_CACHE_SIZE 16
+#endif
+
+/**
+ * Cache of FDS record descriptors, by file id and record key.
+ *
+ * Storage writes a record by updating the previous record with the same file id and record key, which it otherwise
+ * has to find first, by going over all records in flash.
+ *
+ * The cache is direct mapped: each file id and record key can only be at one entry, which is overwritten by another
+ * file id and record key that maps to the same entry. So a lookup can miss, but never returns a wrong descriptor, as
+ * long as entries are removed when their record is removed.
+ *
+ * The descriptor only has to contain the record id: FDS finds the record itself, when the location is not known,
+ * or when it may have been moved by garbage collection.
+ */
+class StorageRecordCache {
+public:
+	static const uint16_t SIZE = CS_STORAGE_RECORD_CACHE_SIZE;
+
+	/**
+	 * Get the descriptor of the record with given file id and record key.
+	 *
+	 * @return                    True when the descriptor was found.
+	 */
+	bool get(uint16_t fileId, uint16_t recordKey, fds_record_desc_t& desc) const;
+
+	/**
+	 * Set the descriptor of the record with given file id and record key.
+	 */
+	void set(uint16_t fileId, uint16_t recordKey, const fds_record_desc_t& desc);
+
+	/**
+	 * Remove the descriptor of the record with given file id and record key.
+	 */
+	void remove(uint16_t fileId, uint16_t recordKey);
+
+	/**
+	 * Remove the descriptors of all records with given record key.
+	 */
+	void removeRecordKey(uint16_t recordKey);
+
+	/**
+	 * Remove the descriptors of all records with given file id.
+	 */
+	void removeFileId(uint16_t fileId);
+
+	/**
+	 * Remove all descriptors.
+	 */
+	void clear();
+
+private:
+#if CS_STORAGE_RECORD_CACHE_SIZE > 0
+	struct entry_t {
+		uint16_t fileId;
+		//! FDS_RECORD_KEY_DIRTY for unused entries.
+		uint16_t recordKey = FDS_RECORD_KEY_DIRTY;
+		fds_record_desc_t desc;
+	};
+
+	entry_t _entries[SIZE];
+
+	static uint16_t getIndex(uint16_t fileId, uint16_t recordKey) {
+		return (recordKey * 31u + fileId) % SIZE;
+	}
+#endif
+};
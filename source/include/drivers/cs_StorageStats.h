@@ -0,0 +1,84 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Flash statistics of a single record key (CS_TYPE).
+ *
+ * bytesWritten:   Bytes written to flash, including the record header.
+ * writes:         Number of writes that were started.
+ * busy:           Number of writes that could not be started, because storage was busy, and have to be retried.
+ */
+struct cs_storage_type_stats_t {
+	uint16_t recordKey;
+	uint32_t bytesWritten;
+	uint32_t writes;
+	uint32_t busy;
+};
+
+/**
+ * Flash statistics of all record keys together.
+ *
+ * gcRuns:         Number of completed garbage collections.
+ * searches:       Number of times all records in flash were searched, to find a record before writing it.
+ * cacheHits:      Number of writes that found the record in the cache.
+ * cacheMisses:    Number of writes that did not find the record in the cache.
+ * groups:         Number of commit groups with at least one write.
+ */
+struct cs_storage_stats_t {
+	uint32_t gcRuns      = 0;
+	uint32_t searches    = 0;
+	uint32_t cacheHits   = 0;
+	uint32_t cacheMisses = 0;
+	uint32_t groups      = 0;
+};
+
+/**
+ * Keeps up the flash statistics of Storage, to see which types wear the flash most.
+ */
+class StorageStats {
+public:
+	void addWrite(uint16_t recordKey, uint32_t numBytes);
+
+	void addBusy(uint16_t recordKey);
+
+	/**
+	 * Get the statistics of a record key.
+	 *
+	 * @return                    Pointer to the statistics, or nullptr when nothing was counted for this record key.
+	 */
+	const cs_storage_type_stats_t* get(uint16_t recordKey) const;
+
+	/**
+	 * Get the statistics of all record keys, ordered by record key.
+	 */
+	const std::vector<cs_storage_type_stats_t>& getTypeStats() const {
+		return _types;
+	}
+
+	cs_storage_stats_t& getTotals() {
+		return _totals;
+	}
+
+	const cs_storage_stats_t& getTotals() const {
+		return _totals;
+	}
+
+	void clear();
+
+private:
+	//! Ordered by record key.
+	std::vector<cs_storage_type_stats_t> _types;
+
+	cs_storage_stats_t _totals;
+
+	cs_storage_type_stats_t& getOrAdd(uint16_t recordKey);
+};
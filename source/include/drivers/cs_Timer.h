@@ -9,10 +9,12 @@
 #include <ble/cs_Nordic.h>
 #include <cfg/cs_Config.h>
 
+#ifndef HOST_TARGET
 extern "C" {
 #include <components/libraries/timer/app_timer.h>
 #include <components/libraries/scheduler/app_scheduler.h>
 }
+#endif
 
 #define HZ_TO_TICKS(hz) APP_TIMER_TICKS(1000/hz)
 #define MS_TO_TICKS(ms) APP_TIMER_TICKS(ms)
@@ -8,6 +8,7 @@
 
 #include <events/cs_Event.h>
 #include <events/cs_EventListener.h>
+#include <events/cs_EventRoutingTable.h>
 
 #define MAX_EVENT_LISTENERS 48
 
@@ -25,6 +26,12 @@ private:
 	//! Count of added listeners
 	uint16_t _listenerCount;
 
+	//! Which listeners want which event types.
+	EventRoutingTable _routes;
+
+	//! Get index of listener, or add it. Returns -1 when there is no space.
+	int16_t getOrAddListenerIndex(EventListener* listener);
+
 public:
 	static EventDispatcher& getInstance() {
 		static EventDispatcher instance;
@@ -34,9 +41,16 @@ public:
 	EventDispatcher(EventDispatcher const&) = delete;
 	void operator=(EventDispatcher const&)  = delete;
 
-	//! Add a listener
+	//! Add a listener that receives all events.
 	bool addListener(EventListener *listener);
 
+	/**
+	 * Add a listener that only receives events of the given types.
+	 *
+	 * When the routing table is full, the listener will receive all events instead.
+	 */
+	bool addListener(EventListener *listener, const CS_TYPE* types, uint8_t typeCount);
+
 	//! Dispatch an event with data
 	void dispatch(event_t & event);
 };
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <cstdint>
+#include <initializer_list>
 #include <events/cs_Event.h>
 
 /**
@@ -30,4 +31,12 @@ public:
 	 * Registers this with the EventDispatcher.
 	 */
 	void listen();
+
+	/**
+	 * Registers this with the EventDispatcher, but only for the given event types.
+	 *
+	 * Use this when handleEvent() handles only a few types: it will then not be called for all other events.
+	 * Make sure to keep the list in sync with the types handled in handleEvent().
+	 */
+	void listen(std::initializer_list<CS_TYPE> types);
 };
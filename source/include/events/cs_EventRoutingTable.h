@@ -0,0 +1,165 @@
+/**
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Bitmask of listeners, bit N is set when the listener at index N of the dispatcher should receive the event.
+ */
+typedef uint64_t event_listener_mask_t;
+
+/**
+ * Maximum number of distinct event types that can have their own subscriber list.
+ * Must be a power of 2.
+ */
+#ifndef MAX_EVENT_ROUTES
+#define MAX_EVENT_ROUTES 64
+#endif
+
+/**
+ * Routing table from event type to the listeners that are interested in that type.
+ *
+ * Listeners either subscribe to a set of types, or subscribe to all types (legacy listeners that handle
+ * the type themselves). Looking up the listeners of a type is an open addressing hash lookup, so dispatching
+ * an event costs only the listeners that actually want it, instead of a virtual call to every listener.
+ *
+ * Only depends on the raw type value, so that it can be used (and benchmarked) without the CS_TYPE definitions.
+ */
+class EventRoutingTable {
+public:
+	static const uint8_t MAX_LISTENERS = sizeof(event_listener_mask_t) * 8;
+
+	EventRoutingTable() {
+		clear();
+	}
+
+	/**
+	 * Remove all routes.
+	 */
+	void clear() {
+		_catchAllMask = 0;
+		for (uint16_t i = 0; i < MAX_EVENT_ROUTES; ++i) {
+			_types[i] = EMPTY_TYPE;
+			_masks[i] = 0;
+		}
+	}
+
+	/**
+	 * Subscribe a listener to a single type.
+	 *
+	 * Returns false when the table is full, or the index is out of range.
+	 */
+	bool subscribe(uint16_t type, uint8_t listenerIndex) {
+		if (listenerIndex >= MAX_LISTENERS || type == EMPTY_TYPE) {
+			return false;
+		}
+		int16_t slot = getOrAddSlot(type);
+		if (slot < 0) {
+			return false;
+		}
+		_masks[slot] |= bit(listenerIndex);
+		return true;
+	}
+
+	/**
+	 * Subscribe a listener to all types.
+	 */
+	bool subscribeAll(uint8_t listenerIndex) {
+		if (listenerIndex >= MAX_LISTENERS) {
+			return false;
+		}
+		_catchAllMask |= bit(listenerIndex);
+		return true;
+	}
+
+	/**
+	 * Get the listeners that should receive an event of given type.
+	 *
+	 * Iterate the bits from low to high to call listeners in order of registration.
+	 */
+	event_listener_mask_t getListeners(uint16_t type) const {
+		int16_t slot = findSlot(type);
+		if (slot < 0) {
+			return _catchAllMask;
+		}
+		return _catchAllMask | _masks[slot];
+	}
+
+	/**
+	 * Number of types that have a route.
+	 */
+	uint16_t getNumRoutes() const {
+		uint16_t count = 0;
+		for (uint16_t i = 0; i < MAX_EVENT_ROUTES; ++i) {
+			if (_types[i] != EMPTY_TYPE) {
+				count++;
+			}
+		}
+		return count;
+	}
+
+private:
+	static_assert((MAX_EVENT_ROUTES & (MAX_EVENT_ROUTES - 1)) == 0, "MAX_EVENT_ROUTES must be a power of 2");
+
+	/**
+	 * Type 0 is reserved (CONFIG_DO_NOT_USE), so it can be used to mark an empty slot.
+	 */
+	static const uint16_t EMPTY_TYPE = 0;
+
+	//! Listeners that get all events.
+	event_listener_mask_t _catchAllMask;
+
+	//! Type of each slot, kept separate from the masks so that probing touches as few cache lines as possible.
+	uint16_t _types[MAX_EVENT_ROUTES];
+
+	//! Listeners of each slot.
+	event_listener_mask_t _masks[MAX_EVENT_ROUTES];
+
+	static event_listener_mask_t bit(uint8_t index) {
+		return static_cast<event_listener_mask_t>(1) << index;
+	}
+
+	static uint16_t hash(uint16_t type) {
+		// Types are clustered per category, so spread them with a multiplicative hash.
+		return static_cast<uint16_t>((type * 40503u) >> 8) & (MAX_EVENT_ROUTES - 1);
+	}
+
+	/**
+	 * Linear probing. Slots are never removed, so an empty slot ends the search.
+	 *
+	 * Returns the slot index of the type, or of the empty slot where it should be added.
+	 * Returns -1 when the type is not found and the table is full.
+	 */
+	int16_t probe(uint16_t type) const {
+		uint16_t slot = hash(type);
+		for (uint16_t i = 0; i < MAX_EVENT_ROUTES; ++i) {
+			if (_types[slot] == type || _types[slot] == EMPTY_TYPE) {
+				return slot;
+			}
+			slot = (slot + 1) & (MAX_EVENT_ROUTES - 1);
+		}
+		return -1;
+	}
+
+	int16_t findSlot(uint16_t type) const {
+		int16_t slot = probe(type);
+		if (slot < 0 || _types[slot] != type) {
+			return -1;
+		}
+		return slot;
+	}
+
+	int16_t getOrAddSlot(uint16_t type) {
+		int16_t slot = probe(type);
+		if (slot >= 0) {
+			_types[slot] = type;
+		}
+		return slot;
+	}
+};
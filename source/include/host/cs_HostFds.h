@@ -0,0 +1,379 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#pragma once
+
+/**
+ * Host implementation of the Flash Data Storage (FDS) module of the SDK.
+ *
+ * Implements the part of the FDS API that is used by Storage, with the same types, error codes and events, so that
+ * code using FDS can be compiled and run on the host.
+ *
+ * The pages are at the end of the host flash (see HostFlash), with the same layout as FDS: virtual pages with a page
+ * tag, records with a 3 word header, followed by the data. Deleted records are marked dirty, and only freed by garbage
+ * collection, which copies the valid records of a page to the swap page.
+ *
+ * Like FDS, write, update, delete and garbage collection are queued, and only executed later: when HostFds::process()
+ * is called. The event of each operation is sent after it has been executed.
+ *
+ * Flash is written in an order that survives power loss at any moment: the record id is written last, so that a
+ * record is only valid once it is complete. Pages left behind by an interrupted garbage collection are repaired by
+ * fds_init().
+ */
+
+#include <host/cs_HostFlash.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Same as app_config.h
+#ifndef FDS_VIRTUAL_PAGES
+#define FDS_VIRTUAL_PAGES 4
+#endif
+#ifndef FDS_VIRTUAL_PAGE_SIZE
+#define FDS_VIRTUAL_PAGE_SIZE 1024
+#endif
+#ifndef FDS_OP_QUEUE_SIZE
+#define FDS_OP_QUEUE_SIZE 4
+#endif
+#ifndef FDS_CRC_CHECK_ON_READ
+#define FDS_CRC_CHECK_ON_READ 1
+#endif
+#ifndef FDS_MAX_USERS
+#define FDS_MAX_USERS 2
+#endif
+
+typedef uint32_t ret_code_t;
+
+#define FDS_ERR_BASE 0x8600
+
+enum {
+	FDS_ERR_OPERATION_TIMEOUT = FDS_ERR_BASE,
+	FDS_ERR_NOT_INITIALIZED,
+	FDS_ERR_UNALIGNED_ADDR,
+	FDS_ERR_INVALID_ARG,
+	FDS_ERR_NULL_ARG,
+	FDS_ERR_NO_OPEN_RECORDS,
+	FDS_ERR_NO_SPACE_IN_FLASH,
+	FDS_ERR_NO_SPACE_IN_QUEUES,
+	FDS_ERR_RECORD_TOO_LARGE,
+	FDS_ERR_NOT_FOUND,
+	FDS_ERR_NO_PAGES,
+	FDS_ERR_USER_LIMIT_REACHED,
+	FDS_ERR_CRC_CHECK_FAILED,
+	FDS_ERR_BUSY,
+	FDS_ERR_INTERNAL,
+};
+
+#define FDS_FILE_ID_INVALID 0xFFFF
+#define FDS_RECORD_KEY_DIRTY 0x0000
+
+/**
+ * Size of the record header in words.
+ */
+#define FDS_HEADER_SIZE 3
+
+/**
+ * Size of the page tag in words.
+ */
+#define FDS_PAGE_TAG_SIZE 2
+
+typedef struct {
+	uint16_t record_key;
+	uint16_t length_words;
+	uint16_t file_id;
+	uint16_t crc16;
+	uint32_t record_id;
+} fds_header_t;
+
+typedef struct {
+	uint32_t record_id;
+	uint32_t const* p_record;
+	uint16_t gc_run_count;
+	bool record_is_open;
+} fds_record_desc_t;
+
+typedef struct {
+	fds_header_t const* p_header;
+	void const* p_data;
+} fds_flash_record_t;
+
+typedef struct {
+	uint16_t file_id;
+	uint16_t key;
+	struct {
+		void const* p_data;
+		uint32_t length_words;
+	} data;
+} fds_record_t;
+
+typedef struct {
+	uint32_t const* p_addr;
+	uint16_t page;
+} fds_find_token_t;
+
+typedef enum {
+	FDS_EVT_INIT,
+	FDS_EVT_WRITE,
+	FDS_EVT_UPDATE,
+	FDS_EVT_DEL_RECORD,
+	FDS_EVT_DEL_FILE,
+	FDS_EVT_GC,
+} fds_evt_id_t;
+
+typedef struct {
+	fds_evt_id_t id;
+	ret_code_t result;
+	union {
+		struct {
+			uint32_t record_id;
+			uint16_t file_id;
+			uint16_t record_key;
+			bool is_record_updated;
+		} write;
+		struct {
+			uint32_t record_id;
+			uint16_t file_id;
+			uint16_t record_key;
+		} del;
+	};
+} fds_evt_t;
+
+typedef struct {
+	uint16_t pages_available;
+	uint16_t open_records;
+	uint16_t valid_records;
+	uint16_t dirty_records;
+	uint16_t words_reserved;
+	uint16_t words_used;
+	uint16_t largest_contig;
+	uint16_t freeable_words;
+	bool corruption;
+} fds_stat_t;
+
+typedef void (*fds_cb_t)(fds_evt_t const* p_evt);
+
+ret_code_t fds_register(fds_cb_t cb);
+ret_code_t fds_init();
+ret_code_t fds_record_write(fds_record_desc_t* p_desc, fds_record_t const* p_record);
+ret_code_t fds_record_update(fds_record_desc_t* p_desc, fds_record_t const* p_record);
+ret_code_t fds_record_delete(fds_record_desc_t* p_desc);
+ret_code_t fds_file_delete(uint16_t file_id);
+ret_code_t fds_gc();
+ret_code_t fds_record_iterate(fds_record_desc_t* p_desc, fds_find_token_t* p_token);
+ret_code_t fds_record_find(uint16_t file_id, uint16_t record_key, fds_record_desc_t* p_desc, fds_find_token_t* p_token);
+ret_code_t fds_record_find_by_key(uint16_t record_key, fds_record_desc_t* p_desc, fds_find_token_t* p_token);
+ret_code_t fds_record_find_in_file(uint16_t file_id, fds_record_desc_t* p_desc, fds_find_token_t* p_token);
+ret_code_t fds_record_open(fds_record_desc_t* p_desc, fds_flash_record_t* p_flash_record);
+ret_code_t fds_record_close(fds_record_desc_t* p_desc);
+ret_code_t fds_record_id_from_desc(fds_record_desc_t const* p_desc, uint32_t* p_record_id);
+ret_code_t fds_descriptor_from_rec_id(fds_record_desc_t* p_desc, uint32_t record_id);
+ret_code_t fds_stat(fds_stat_t* p_stat);
+
+/**
+ * End address of the flash used by FDS: the pages are placed right before it.
+ */
+uint32_t fds_flash_end_addr();
+
+/**
+ * Statistics of the host FDS, to measure the wear and the cost of searching.
+ */
+struct cs_host_fds_stats_t {
+	uint32_t wordsWritten   = 0; // Words written to flash, including headers and records moved by garbage collection.
+	uint32_t recordsWritten = 0; // Records written by write and update operations.
+	uint32_t recordsMoved   = 0; // Records copied to another page by garbage collection.
+	uint32_t pageErases     = 0; // Pages erased.
+	uint32_t gcRuns         = 0; // Garbage collections performed.
+	uint32_t headersRead    = 0; // Record headers read while searching for records via the API (find, iterate).
+	uint32_t headersLocated = 0; // Record headers read by FDS itself, to find a record by its record id.
+	uint32_t opsExecuted    = 0; // Queued operations that have been executed.
+	uint64_t busyTimeUs     = 0; // Simulated flash time spent by executed operations.
+	uint64_t gcTimeUs       = 0; // Simulated flash time spent by garbage collection.
+	uint32_t maxOpTimeUs    = 0; // Longest simulated flash time spent by a single operation.
+};
+
+class HostFds {
+public:
+	static HostFds& getInstance();
+
+	/**
+	 * Open the host flash, with just the FDS pages, in a file, or in memory when no path is given.
+	 *
+	 * A file that does not exist yet is created with erased pages. Afterwards, the state is like after a reboot.
+	 *
+	 * @return                    False when the file could not be opened.
+	 */
+	bool open(const char* path = nullptr);
+
+	/**
+	 * Forget everything that is not on flash, like after a reboot: fds_init() has to be called again.
+	 *
+	 * The registered event handlers are kept.
+	 */
+	void reboot();
+
+	/**
+	 * Close the host flash.
+	 */
+	void close();
+
+	/**
+	 * Execute one queued operation, and send its event.
+	 *
+	 * When power is lost during the operation, no event is sent, and the queue is cleared.
+	 *
+	 * @return                    False when no operation was executed.
+	 */
+	bool processOne();
+
+	/**
+	 * Execute queued operations until the queue is empty, including operations queued by event handlers.
+	 *
+	 * @return                    Number of operations executed.
+	 */
+	uint32_t process();
+
+	/**
+	 * Number of operations in the queue.
+	 */
+	uint16_t getQueueSize() const;
+
+	const cs_host_fds_stats_t& getStats() const;
+
+	void resetStats();
+
+	/**
+	 * Get the FDS pages: FDS_VIRTUAL_PAGES pages of FDS_VIRTUAL_PAGE_SIZE words.
+	 *
+	 * @return                    Pointer to the pages, or nullptr when not initialized.
+	 */
+	const uint32_t* getFlash() const {
+		return _flash;
+	}
+
+	HostFds(HostFds const&) = delete;
+	void operator=(HostFds const&) = delete;
+
+	// Implementation of the FDS API.
+	ret_code_t registerHandler(fds_cb_t cb);
+	ret_code_t init();
+	ret_code_t write(fds_record_desc_t* p_desc, fds_record_t const* p_record, bool update);
+	ret_code_t remove(fds_record_desc_t* p_desc);
+	ret_code_t removeFile(uint16_t fileId);
+	ret_code_t gc();
+	ret_code_t find(
+			uint16_t const* fileId,
+			uint16_t const* recordKey,
+			fds_record_desc_t* p_desc,
+			fds_find_token_t* p_token);
+	ret_code_t openRecord(fds_record_desc_t* p_desc, fds_flash_record_t* p_flash_record);
+	ret_code_t closeRecord(fds_record_desc_t* p_desc);
+	ret_code_t stat(fds_stat_t* p_stat);
+	uint16_t getGcRunCount() const {
+		return _gcRuns;
+	}
+
+private:
+	HostFds() {}
+
+	enum host_fds_op_type_t {
+		HOST_FDS_OP_INIT,
+		HOST_FDS_OP_WRITE,
+		HOST_FDS_OP_UPDATE,
+		HOST_FDS_OP_DEL_RECORD,
+		HOST_FDS_OP_DEL_FILE,
+		HOST_FDS_OP_GC,
+	};
+
+	struct host_fds_op_t {
+		host_fds_op_type_t type;
+		fds_header_t header;
+		void const* data;
+		uint16_t page;
+		//! Record to delete, or to replace when updating.
+		uint32_t oldRecordId;
+	};
+
+	enum host_fds_page_type_t {
+		HOST_FDS_PAGE_ERASED,
+		HOST_FDS_PAGE_DATA,
+		HOST_FDS_PAGE_SWAP,
+	};
+
+	struct host_fds_page_t {
+		host_fds_page_type_t type = HOST_FDS_PAGE_ERASED;
+		//! Offset in words of the first free word.
+		uint16_t writeOffset      = 0;
+		//! Words reserved by queued writes.
+		uint16_t wordsReserved    = 0;
+	};
+
+	const uint32_t* _flash = nullptr;
+
+	fds_cb_t _handlers[FDS_MAX_USERS] = {};
+	uint8_t _numHandlers              = 0;
+	bool _initialized                 = false;
+	bool _initQueued                  = false;
+
+	host_fds_page_t _pages[FDS_VIRTUAL_PAGES];
+	std::vector<host_fds_op_t> _queue;
+	uint32_t _nextRecordId = 1;
+	uint16_t _gcRuns       = 0;
+	uint16_t _openRecords  = 0;
+
+	cs_host_fds_stats_t _stats;
+
+	const uint32_t* getPage(uint16_t page) const {
+		return _flash + page * FDS_VIRTUAL_PAGE_SIZE;
+	}
+
+	/**
+	 * Set the location of the pages in the host flash.
+	 *
+	 * @return                    False when the host flash is too small, or its pages don't fit the virtual pages.
+	 */
+	bool attach();
+
+	/**
+	 * Write words to the host flash: bits can only be cleared.
+	 */
+	void writeWords(const uint32_t* dest, const uint32_t* src, uint16_t numWords);
+
+	/**
+	 * Erase a virtual page: all the host flash pages it consists of.
+	 */
+	void erasePage(uint16_t page);
+
+	/**
+	 * Whether a record is complete, and not deleted.
+	 */
+	bool isValid(const fds_header_t* header) const;
+
+	/**
+	 * Set the page types and write offsets from the page tags and records on flash.
+	 *
+	 * Repairs the pages of a garbage collection that was interrupted by power loss.
+	 */
+	void scanPages();
+
+	/**
+	 * Find the header of a valid record with given record id.
+	 */
+	const uint32_t* findRecord(uint32_t recordId);
+
+	/**
+	 * Find the header of the record of a descriptor, and update the descriptor.
+	 */
+	const uint32_t* locate(fds_record_desc_t* p_desc);
+
+	uint16_t crc(const uint32_t* header, const void* data, uint16_t lengthWords);
+
+	void execute(host_fds_op_t& op, fds_evt_t& event);
+	void executeGc();
+	void dispatch(const fds_evt_t& event);
+};
@@ -0,0 +1,211 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#pragma once
+
+/**
+ * Host implementation of the flash of the nRF52, that the host FDS and fstorage are built on.
+ *
+ * Flash is kept in memory, or in a memory mapped file, so that it persists between runs. Addresses start at 0, like
+ * on the nRF52. Like on flash, writing can only clear bits, and only erasing a whole page sets them again.
+ *
+ * Time is not spent, but simulated: each word write and page erase adds its duration to the busy time, so that the
+ * time spent by flash operations (like garbage collection) can be measured.
+ *
+ * Power loss can be injected: after a given number of flash operations (word writes and page erases), all further
+ * operations are ignored, like the device was turned off in the middle of an operation. After powerOn(), the users of
+ * the flash should be initialized again, like after a reboot.
+ *
+ * Also implements the flash functions of the SoftDevice API, which finish immediately, with a SoC event.
+ */
+
+#include <cstdint>
+#include <vector>
+
+#ifndef NRF_SUCCESS
+#define NRF_SUCCESS 0
+#endif
+
+// Same as nrf_error.h
+#ifndef NRF_ERROR_NO_MEM
+#define NRF_ERROR_NO_MEM 4
+#endif
+#ifndef NRF_ERROR_INVALID_STATE
+#define NRF_ERROR_INVALID_STATE 8
+#endif
+#ifndef NRF_ERROR_INVALID_LENGTH
+#define NRF_ERROR_INVALID_LENGTH 9
+#endif
+#ifndef NRF_ERROR_NULL
+#define NRF_ERROR_NULL 14
+#endif
+#ifndef NRF_ERROR_INVALID_ADDR
+#define NRF_ERROR_INVALID_ADDR 16
+#endif
+#ifndef NRF_ERROR_BUSY
+#define NRF_ERROR_BUSY 17
+#endif
+
+// Same as nrf_soc.h
+enum {
+	NRF_EVT_FLASH_OPERATION_SUCCESS = 2,
+	NRF_EVT_FLASH_OPERATION_ERROR   = 3,
+};
+
+/**
+ * Configuration of the host flash.
+ *
+ * The default durations are in the order of the nRF52832 flash timings.
+ */
+struct cs_host_flash_config_t {
+	//! Size of a page in bytes, must be a multiple of 4.
+	uint32_t pageSize    = 4096;
+	uint32_t numPages    = 128;
+	uint32_t writeWordUs = 41;
+	uint32_t erasePageUs = 85000;
+};
+
+/**
+ * Statistics of the host flash.
+ */
+struct cs_host_flash_stats_t {
+	uint32_t wordsWritten = 0;
+	uint32_t pageErases   = 0;
+	//! Simulated time spent on writing and erasing.
+	uint64_t busyTimeUs   = 0;
+};
+
+typedef void (*cs_host_flash_soc_evt_handler_t)(uint32_t evt);
+
+class HostFlash {
+public:
+	static HostFlash& getInstance();
+
+	/**
+	 * Use a file as flash, or memory when no path is given.
+	 *
+	 * A file that does not exist yet, or has a different size, is (re)created with erased pages.
+	 *
+	 * @return                    False when the file could not be opened.
+	 */
+	bool open(const char* path = nullptr, const cs_host_flash_config_t& config = cs_host_flash_config_t());
+
+	/**
+	 * Write everything to the file, and close it.
+	 */
+	void close();
+
+	bool isOpen() const {
+		return _flash != nullptr;
+	}
+
+	const cs_host_flash_config_t& getConfig() const {
+		return _config;
+	}
+
+	/**
+	 * Size of the flash in bytes.
+	 */
+	uint32_t getSize() const {
+		return _config.pageSize * _config.numPages;
+	}
+
+	/**
+	 * Get a pointer to flash, to read it.
+	 *
+	 * @return                    Pointer, or nullptr when the address range is not in flash.
+	 */
+	const uint8_t* getPointer(uint32_t address, uint32_t size = 1) const;
+
+	/**
+	 * Get the address of a pointer to flash.
+	 */
+	uint32_t getAddress(const void* ptr) const;
+
+	/**
+	 * Write words to flash: bits can only be cleared.
+	 *
+	 * @param[in] address         Address to write to, must be word aligned.
+	 * @return                    False when the address range is not in flash, or when power is lost.
+	 */
+	bool write(uint32_t address, const uint32_t* data, uint32_t numWords);
+
+	/**
+	 * Erase a page.
+	 *
+	 * @return                    False when the page is not in flash, or when power is lost.
+	 */
+	bool erasePage(uint32_t pageNumber);
+
+	/**
+	 * Lose power after this many more flash operations: word writes and page erases.
+	 *
+	 * An operation that is interrupted does not change flash at all.
+	 */
+	void setPowerLossAfter(uint32_t numOperations);
+
+	bool isPowerLost() const {
+		return _powerLost;
+	}
+
+	/**
+	 * Turn power on again, and stop injecting power loss.
+	 */
+	void powerOn();
+
+	const cs_host_flash_stats_t& getStats() const {
+		return _stats;
+	}
+
+	void resetStats();
+
+	/**
+	 * Number of times each page has been erased, since the flash was opened.
+	 */
+	const std::vector<uint32_t>& getEraseCounts() const {
+		return _eraseCounts;
+	}
+
+	/**
+	 * Set the handler of SoC events, sent by the SoftDevice flash functions.
+	 */
+	void setSocEventHandler(cs_host_flash_soc_evt_handler_t handler) {
+		_socEventHandler = handler;
+	}
+
+	void sendSocEvent(uint32_t evt);
+
+	HostFlash(HostFlash const&) = delete;
+	void operator=(HostFlash const&) = delete;
+
+private:
+	HostFlash() {}
+
+	cs_host_flash_config_t _config;
+	uint8_t* _flash = nullptr;
+	std::vector<uint8_t> _memory;
+	int _fd         = -1;
+
+	bool _powerLossEnabled             = false;
+	uint32_t _operationsUntilPowerLoss = 0;
+	bool _powerLost                    = false;
+
+	cs_host_flash_stats_t _stats;
+	std::vector<uint32_t> _eraseCounts;
+	cs_host_flash_soc_evt_handler_t _socEventHandler = nullptr;
+
+	/**
+	 * Count a flash operation.
+	 *
+	 * @return                    False when power is lost.
+	 */
+	bool powerOperation();
+};
+
+// SoftDevice flash functions.
+uint32_t sd_flash_write(uint32_t* p_dst, uint32_t const* p_src, uint32_t size);
+uint32_t sd_flash_page_erase(uint32_t page_number);
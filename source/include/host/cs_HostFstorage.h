@@ -0,0 +1,135 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#pragma once
+
+/**
+ * Host implementation of the nrf_fstorage module of the SDK, with the SoftDevice backend.
+ *
+ * Implements the part of the nrf_fstorage API that is used by MicroappStorage, with the same types, error codes and
+ * events, on top of the host flash (see HostFlash).
+ *
+ * Like nrf_fstorage, writes and erases are queued, and only executed later: when HostFstorage::process() is called.
+ * The event of each operation is sent to the handler of its instance after it has been executed. Reads are executed
+ * immediately.
+ */
+
+#include <host/cs_HostFlash.h>
+
+#include <cstdint>
+#include <vector>
+
+// Same as sdk_config.h
+#ifndef NRF_FSTORAGE_SD_QUEUE_SIZE
+#define NRF_FSTORAGE_SD_QUEUE_SIZE 4
+#endif
+
+typedef enum {
+	NRF_FSTORAGE_EVT_READ_RESULT,
+	NRF_FSTORAGE_EVT_WRITE_RESULT,
+	NRF_FSTORAGE_EVT_ERASE_RESULT,
+} nrf_fstorage_evt_id_t;
+
+typedef struct {
+	nrf_fstorage_evt_id_t id;
+	uint32_t result;
+	uint32_t addr;
+	void const* p_src;
+	uint32_t len;
+	void* p_param;
+} nrf_fstorage_evt_t;
+
+typedef void (*nrf_fstorage_evt_handler_t)(nrf_fstorage_evt_t* p_evt);
+
+typedef struct {
+	uint32_t erase_unit;
+	uint32_t program_unit;
+	bool rmap;
+	bool wmap;
+} nrf_fstorage_info_t;
+
+/**
+ * The backend: there is only one on the host.
+ */
+typedef struct {
+	nrf_fstorage_info_t const* p_flash_info;
+} nrf_fstorage_api_t;
+
+/**
+ * The backend and flash info are set by nrf_fstorage_init(), so instances only define the handler and area.
+ */
+typedef struct {
+	nrf_fstorage_api_t const* p_api          = nullptr;
+	nrf_fstorage_info_t const* p_flash_info  = nullptr;
+	nrf_fstorage_evt_handler_t evt_handler;
+	uint32_t start_addr;
+	uint32_t end_addr;
+} nrf_fstorage_t;
+
+extern nrf_fstorage_api_t nrf_fstorage_sd;
+
+#define NRF_FSTORAGE_DEF(inst) inst
+
+uint32_t nrf_fstorage_init(nrf_fstorage_t* p_fs, nrf_fstorage_api_t* p_api, void* p_param);
+uint32_t nrf_fstorage_read(nrf_fstorage_t const* p_fs, uint32_t src, void* p_dest, uint32_t len);
+uint32_t nrf_fstorage_write(nrf_fstorage_t const* p_fs, uint32_t dest, void const* p_src, uint32_t len, void* p_param);
+uint32_t nrf_fstorage_erase(nrf_fstorage_t const* p_fs, uint32_t page_addr, uint32_t len, void* p_param);
+bool nrf_fstorage_is_busy(nrf_fstorage_t const* p_fs);
+
+class HostFstorage {
+public:
+	static HostFstorage& getInstance();
+
+	/**
+	 * Execute one queued operation, and send its event.
+	 *
+	 * When power is lost during the operation, no event is sent, and the queue is cleared.
+	 *
+	 * @return                    False when no operation was executed.
+	 */
+	bool processOne();
+
+	/**
+	 * Execute queued operations until the queue is empty, including operations queued by event handlers.
+	 *
+	 * @return                    Number of operations executed.
+	 */
+	uint32_t process();
+
+	/**
+	 * Forget the queued operations, like after a reboot.
+	 */
+	void reboot();
+
+	HostFstorage(HostFstorage const&) = delete;
+	void operator=(HostFstorage const&) = delete;
+
+	// Implementation of the nrf_fstorage API.
+	uint32_t init(nrf_fstorage_t* p_fs, nrf_fstorage_api_t* p_api);
+	uint32_t read(nrf_fstorage_t const* p_fs, uint32_t src, void* p_dest, uint32_t len);
+	uint32_t write(nrf_fstorage_t const* p_fs, uint32_t dest, void const* p_src, uint32_t len, void* p_param);
+	uint32_t erase(nrf_fstorage_t const* p_fs, uint32_t pageAddress, uint32_t numPages, void* p_param);
+	bool isBusy(nrf_fstorage_t const* p_fs) const;
+
+private:
+	HostFstorage() {}
+
+	struct host_fstorage_op_t {
+		nrf_fstorage_t const* fs;
+		nrf_fstorage_evt_t event;
+	};
+
+	nrf_fstorage_info_t _flashInfo = {0, sizeof(uint32_t), true, false};
+	std::vector<host_fstorage_op_t> _queue;
+
+	/**
+	 * Check if an address range is in the area of an instance.
+	 */
+	bool isInArea(nrf_fstorage_t const* p_fs, uint32_t address, uint32_t size) const;
+
+	uint32_t execute(host_fstorage_op_t& op);
+};
@@ -0,0 +1,160 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#pragma once
+
+/**
+ * Host stand-ins for the parts of the Nordic SDK and SoftDevice API that are used in the headers of State, Storage,
+ * MicroappStorage, and the scan path, so that those can be compiled on the host.
+ *
+ * Types that are only passed around, like BLE events and timers, are declared but not defined. Functions that these
+ * modules call are implemented in cs_HostSdk.cpp: scheduled events are handled in app_sched_execute(), and errors abort.
+ *
+ * The flash part of the SDK is implemented by HostFlash, HostFds, and HostFstorage.
+ */
+
+#include <host/cs_HostFlash.h>
+
+#include <cstdint>
+
+// Same as nrf_error.h
+#ifndef NRF_ERROR_INTERNAL
+#define NRF_ERROR_INTERNAL 3
+#endif
+#ifndef NRF_ERROR_NOT_FOUND
+#define NRF_ERROR_NOT_FOUND 5
+#endif
+#ifndef NRF_ERROR_NOT_SUPPORTED
+#define NRF_ERROR_NOT_SUPPORTED 6
+#endif
+#ifndef NRF_ERROR_INVALID_PARAM
+#define NRF_ERROR_INVALID_PARAM 7
+#endif
+#ifndef NRF_ERROR_INVALID_FLAGS
+#define NRF_ERROR_INVALID_FLAGS 10
+#endif
+#ifndef NRF_ERROR_INVALID_DATA
+#define NRF_ERROR_INVALID_DATA 11
+#endif
+#ifndef NRF_ERROR_DATA_SIZE
+#define NRF_ERROR_DATA_SIZE 12
+#endif
+#ifndef NRF_ERROR_TIMEOUT
+#define NRF_ERROR_TIMEOUT 13
+#endif
+#ifndef NRF_ERROR_FORBIDDEN
+#define NRF_ERROR_FORBIDDEN 15
+#endif
+
+// Same as ble_types.h
+#define BLE_UUID_TYPE_UNKNOWN 0x00
+
+typedef struct {
+	uint16_t uuid;
+	uint8_t type;
+} ble_uuid_t;
+
+typedef struct {
+	uint8_t uuid128[16];
+} ble_uuid128_t;
+
+// Same as ble_gap.h
+#define BLE_GAP_AD_TYPE_FLAGS 0x01
+#define BLE_GAP_AD_TYPE_16BIT_SERVICE_UUID_MORE_AVAILABLE 0x02
+#define BLE_GAP_AD_TYPE_16BIT_SERVICE_UUID_COMPLETE 0x03
+#define BLE_GAP_AD_TYPE_128BIT_SERVICE_UUID_COMPLETE 0x07
+#define BLE_GAP_AD_TYPE_MANUFACTURER_SPECIFIC_DATA 0xFF
+
+// Same as nrf_soc.h
+#define SOC_ECB_KEY_LENGTH 16
+#define SOC_ECB_CLEARTEXT_LENGTH 16
+#define SOC_ECB_CIPHERTEXT_LENGTH SOC_ECB_CLEARTEXT_LENGTH
+
+typedef struct {
+	uint8_t key[SOC_ECB_KEY_LENGTH];
+	uint8_t cleartext[SOC_ECB_CLEARTEXT_LENGTH];
+	uint8_t ciphertext[SOC_ECB_CIPHERTEXT_LENGTH];
+} nrf_ecb_hal_data_t;
+
+// Only passed by reference.
+typedef struct host_ble_evt_t ble_evt_t;
+typedef struct host_ble_gap_evt_phy_update_request_t ble_gap_evt_phy_update_request_t;
+typedef struct host_ble_gap_evt_data_length_update_request_t ble_gap_evt_data_length_update_request_t;
+typedef struct host_ble_gatts_evt_exchange_mtu_request_t ble_gatts_evt_exchange_mtu_request_t;
+
+// Same as nrf_sdh.h
+typedef enum {
+	NRF_SDH_EVT_STATE_ENABLE_PREPARE,
+	NRF_SDH_EVT_STATE_ENABLED,
+	NRF_SDH_EVT_STATE_DISABLE_PREPARE,
+	NRF_SDH_EVT_STATE_DISABLED,
+} nrf_sdh_state_evt_t;
+
+/**
+ * Whether the SoftDevice is enabled: always on the host.
+ */
+bool nrf_sdh_is_enabled();
+
+// Same as app_timer.h: the user only keeps the data of a timer.
+typedef struct {
+	uint32_t data[8];
+} app_timer_t;
+typedef app_timer_t* app_timer_id_t;
+typedef void (*app_timer_timeout_handler_t)(void* p_context);
+
+#define APP_TIMER_TICKS(ms) (ms)
+
+// Same as app_util.h
+#define ROUNDED_DIV(A, B) (((A) + ((B) / 2)) / (B))
+
+/**
+ * Registers of the RTC, of which only the counter and prescaler are used.
+ *
+ * The counter doesn't run on the host: it stays at 0, unless a test sets it.
+ */
+struct host_rtc_t {
+	uint32_t COUNTER;
+	uint32_t PRESCALER;
+};
+
+host_rtc_t* hostRtc();
+
+#define NRF_RTC0 hostRtc()
+
+// Same as app_scheduler.h
+typedef void (*app_sched_event_handler_t)(void* p_event_data, uint16_t event_size);
+
+/**
+ * Copies the event data, and queues the handler: it's called from app_sched_execute().
+ */
+uint32_t app_sched_event_put(void const* p_event_data, uint16_t event_size, app_sched_event_handler_t handler);
+
+/**
+ * Call the handlers of all queued events, including those that are queued meanwhile.
+ */
+void app_sched_execute();
+
+/**
+ * Called by APP_ERROR_CHECK: logs the error, and aborts.
+ */
+void app_error_handler(uint32_t error_code, uint32_t line_num, const uint8_t* p_file_name);
+
+/**
+ * The interrupt that is being handled: always thread mode on the host.
+ */
+uint32_t __get_IPSR();
+
+/**
+ * Factory information registers, of which only the flash page size is used.
+ */
+struct host_ficr_t {
+	uint32_t CODEPAGESIZE;
+};
+
+host_ficr_t* hostFicr();
+
+#define NRF_FICR hostFicr()
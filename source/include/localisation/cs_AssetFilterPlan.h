@@ -0,0 +1,277 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+#pragma once
+
+#include <protocol/cs_AssetFilterPackets.h>
+#include <protocol/cs_CuckooFilterStructs.h>
+#include <structs/cs_AdStructureIndex.h>
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Result of evaluating all asset filters for a scanned device.
+ */
+struct asset_filter_plan_result_t {
+	/**
+	 * Bit N is set when the filter with index N accepts the device.
+	 * When rejected, only the bit of the exclude filter that rejected the device is set.
+	 */
+	uint8_t filterMask = 0;
+
+	/**
+	 * Whether an exclude filter accepted the device, in which case the device should be ignored.
+	 */
+	bool rejected = false;
+};
+
+/**
+ * Input of the asset filters, shared by all filters with the same input description.
+ */
+struct asset_filter_plan_input_t {
+	AssetFilterInputType type;
+	uint8_t adDataType;
+	uint32_t adDataMask;
+
+	/**
+	 * Bitmask of filters that use this input.
+	 */
+	uint8_t filterMask;
+};
+
+/**
+ * Evaluation plan of the asset filters, compiled when the filters are committed.
+ *
+ * Filters with the same input description share an input: it is extracted from the advertisement only once,
+ * and hashed only once for all cuckoo filters that use it. Inputs that are used by exclude filters are evaluated
+ * first, and evaluation stops at the first exclude filter that accepts the device.
+ *
+ * The plan only holds pointers to the filter data, so it has to be cleared when the filters are modified.
+ */
+class AssetFilterPlan {
+public:
+	static constexpr uint8_t MAX_FILTERS = 8;
+
+	/**
+	 * Remove all filters from the plan.
+	 */
+	void clear() {
+		_inputCount  = 0;
+		_cuckooMask  = 0;
+		_excludeMask = 0;
+	}
+
+	/**
+	 * Add a filter to the plan.
+	 *
+	 * @param[in] filterIndex     Index of the filter: the bit that is set in the result when the filter accepts.
+	 * @param[in] inputType       Input description of the filter.
+	 * @param[in] adDataType      AD type, for input type AdDataType and MaskedAdDataType.
+	 * @param[in] adDataMask      Mask, for input type MaskedAdDataType.
+	 * @param[in] filterType      Type of the filter.
+	 * @param[in] filterData      Pointer to the cuckoo_filter_data_t or exact_match_filter_data_t.
+	 * @param[in] exclude         Whether the filter is an exclude filter.
+	 *
+	 * @return false when the filter index is out of range.
+	 */
+	bool addFilter(
+			uint8_t filterIndex,
+			AssetFilterInputType inputType,
+			uint8_t adDataType,
+			uint32_t adDataMask,
+			AssetFilterType filterType,
+			void* filterData,
+			bool exclude) {
+		if (filterIndex >= MAX_FILTERS) {
+			return false;
+		}
+		uint8_t filterBit = 1 << filterIndex;
+
+		// Only keep the fields that are part of the input description, so that inputs can be compared.
+		if (inputType != AssetFilterInputType::MaskedAdDataType) {
+			adDataMask = 0;
+		}
+		if (inputType == AssetFilterInputType::MacAddress) {
+			adDataType = 0;
+		}
+
+		uint8_t inputIndex = 0;
+		while (inputIndex < _inputCount) {
+			asset_filter_plan_input_t& input = _inputs[inputIndex];
+			if (input.type == inputType && input.adDataType == adDataType && input.adDataMask == adDataMask) {
+				break;
+			}
+			inputIndex++;
+		}
+		if (inputIndex == _inputCount) {
+			_inputs[inputIndex] = asset_filter_plan_input_t{
+					.type       = inputType,
+					.adDataType = adDataType,
+					.adDataMask = adDataMask,
+					.filterMask = 0};
+			_inputCount++;
+		}
+		_inputs[inputIndex].filterMask |= filterBit;
+
+		_filterData[filterIndex] = filterData;
+		if (filterType == AssetFilterType::CuckooFilter) {
+			_cuckooMask |= filterBit;
+		}
+		if (exclude) {
+			_excludeMask |= filterBit;
+		}
+		return true;
+	}
+
+	/**
+	 * Number of distinct inputs.
+	 */
+	uint8_t getInputCount() const { return _inputCount; }
+
+	/**
+	 * Evaluate all filters for a scanned device.
+	 *
+	 * The Ops class performs the actual filter operations, it should have the static functions:
+	 * - cuckoo_key_hash_t hashKey(const uint8_t* key, size_t keyLength)
+	 * - bool cuckooFilterContains(void* filterData, const cuckoo_key_hash_t& keyHash)
+	 * - bool exactMatchFilterContains(void* filterData, const uint8_t* key, size_t keyLength)
+	 *
+	 * @param[in] address         MAC address of the device.
+	 * @param[in] addressLen      Length of the MAC address.
+	 * @param[in] advData         Advertisement data of the device.
+	 * @param[in] advLen          Length of the advertisement data.
+	 * @param[in] adIndex         Index of the AD structures in the advertisement data.
+	 */
+	template <class Ops>
+	asset_filter_plan_result_t evaluate(
+			const uint8_t* address,
+			uint8_t addressLen,
+			const uint8_t* advData,
+			uint8_t advLen,
+			ad_structure_index_t& adIndex) const {
+		asset_filter_plan_result_t result;
+
+		// First the inputs that are used by exclude filters, then the others.
+		for (uint8_t pass = 0; pass < 2; ++pass) {
+			bool excludePass = (pass == 0);
+			for (uint8_t i = 0; i < _inputCount; ++i) {
+				const asset_filter_plan_input_t& input = _inputs[i];
+				bool hasExcludeFilters                 = (input.filterMask & _excludeMask) != 0;
+				if (hasExcludeFilters != excludePass) {
+					continue;
+				}
+				if (evaluateInput<Ops>(input, address, addressLen, advData, advLen, adIndex, result)) {
+					return result;
+				}
+			}
+		}
+		return result;
+	}
+
+private:
+	asset_filter_plan_input_t _inputs[MAX_FILTERS];
+	void* _filterData[MAX_FILTERS] = {};
+	uint8_t _inputCount            = 0;
+
+	/**
+	 * Bitmasks of filters, bit N represents the filter with index N.
+	 */
+	uint8_t _cuckooMask  = 0;
+	uint8_t _excludeMask = 0;
+
+	/**
+	 * Extract the input, and evaluate all filters that use it.
+	 *
+	 * @return true when the device is rejected.
+	 */
+	template <class Ops>
+	bool evaluateInput(
+			const asset_filter_plan_input_t& input,
+			const uint8_t* address,
+			uint8_t addressLen,
+			const uint8_t* advData,
+			uint8_t advLen,
+			ad_structure_index_t& adIndex,
+			asset_filter_plan_result_t& result) const {
+		const uint8_t* key = nullptr;
+		size_t keyLen      = 0;
+
+		// A normal advertisement payload size is 31B at most.
+		// We are also limited by the 32b bitmask.
+		uint8_t maskedData[31];
+
+		switch (input.type) {
+			case AssetFilterInputType::MacAddress: {
+				key    = address;
+				keyLen = addressLen;
+				break;
+			}
+			case AssetFilterInputType::AdDataType:
+			case AssetFilterInputType::MaskedAdDataType: {
+				// Selects the first found field of configured type.
+				uint8_t offset;
+				uint8_t len;
+				if (!adIndex.find(input.adDataType, advData, advLen, offset, len)) {
+					return false;
+				}
+				key    = advData + offset;
+				keyLen = len;
+				if (input.type == AssetFilterInputType::MaskedAdDataType) {
+					if (len > sizeof(maskedData)) {
+						return false;
+					}
+					keyLen = 0;
+					for (uint8_t bitIndex = 0; bitIndex < len; bitIndex++) {
+						if (input.adDataMask & (1u << bitIndex)) {
+							maskedData[keyLen++] = key[bitIndex];
+						}
+					}
+					key = maskedData;
+				}
+				break;
+			}
+			default: {
+				return false;
+			}
+		}
+
+		cuckoo_key_hash_t keyHash = {};
+		if (input.filterMask & _cuckooMask) {
+			keyHash = Ops::hashKey(key, keyLen);
+		}
+
+		uint8_t excludeFilters = input.filterMask & _excludeMask;
+		while (excludeFilters) {
+			uint8_t filterIndex = __builtin_ctz(excludeFilters);
+			excludeFilters &= excludeFilters - 1;
+			if (filterContains<Ops>(filterIndex, keyHash, key, keyLen)) {
+				result.filterMask = 1 << filterIndex;
+				result.rejected   = true;
+				return true;
+			}
+		}
+
+		uint8_t includeFilters = input.filterMask & ~_excludeMask;
+		while (includeFilters) {
+			uint8_t filterIndex = __builtin_ctz(includeFilters);
+			includeFilters &= includeFilters - 1;
+			if (filterContains<Ops>(filterIndex, keyHash, key, keyLen)) {
+				result.filterMask |= 1 << filterIndex;
+			}
+		}
+		return false;
+	}
+
+	template <class Ops>
+	bool filterContains(
+			uint8_t filterIndex, const cuckoo_key_hash_t& keyHash, const uint8_t* key, size_t keyLen) const {
+		if (_cuckooMask & (1 << filterIndex)) {
+			return Ops::cuckooFilterContains(_filterData[filterIndex], keyHash);
+		}
+		return Ops::exactMatchFilterContains(_filterData[filterIndex], key, keyLen);
+	}
+};
@@ -10,10 +10,13 @@
 #include <events/cs_EventListener.h>
 
 #include <localisation/cs_AssetFilterPacketAccessors.h>
+#include <localisation/cs_AssetFilterPlan.h>
 
 #include <optional>
 #include <protocol/cs_AssetFilterPackets.h>
 #include <structs/cs_AssetFilterStructs.h>
+#include <structs/cs_PacketsInternal.h>
+#include <util/cs_ExactMatchFilterIndex.h>
 
 /**
  * Keeps up the asset filters.
@@ -55,6 +58,13 @@ public:
 	 */
 	AssetFilter getFilter(uint8_t index);
 
+	/**
+	 * Evaluate all filters for a scanned device, using the plan compiled at commit.
+	 *
+	 * Only valid when isReady().
+	 */
+	asset_filter_plan_result_t evaluateFilters(const scanned_device_t& device);
+
 	/**
 	 * Returns the index of the filter with given filterId, if any.
 	 */
@@ -115,6 +125,19 @@ private:
 	 */
 	uint32_t _masterCrc;
 
+	/**
+	 * Evaluation plan of the committed filters.
+	 */
+	AssetFilterPlan _plan;
+
+#if EXACT_MATCH_FILTER_INDEX == 1
+	/**
+	 * Lookup index of each exact match filter, at the same index as the filter.
+	 * Built when the plan is compiled, the plan points to these instead of the filter data.
+	 */
+	ExactMatchFilterIndex _exactMatchFilterIndices[MAX_FILTER_IDS];
+#endif
+
 	/**
 	 * When this value is not 0, the filters are being modified.
 	 *
@@ -315,6 +338,11 @@ private:
 	 */
 	void markFiltersCommitted();
 
+	/**
+	 * Compiles the evaluation plan of the filters.
+	 */
+	void compilePlan();
+
 public:
 	/**
 	 * Internal usage.
@@ -78,12 +78,10 @@ private:
 
 
 	/**
-	 * Check if the filter with given index accepts the device, call handleAcceptedAsset and.
-	 * dispatches EVT_ASSET_ACCEPTED if so.
-	 *
-	 * Returns true if the filter accepts the device and the exclude flag is false.
+	 * To be called when the (non exclude) filter with given index accepts the device.
+	 * Calls handleAcceptedAsset and dispatches EVT_ASSET_ACCEPTED.
 	 */
-	bool checkIfFilterAccepts(uint8_t filterIndex, const scanned_device_t& device);
+	void handleFilterAccepts(uint8_t filterIndex, const scanned_device_t& device);
 
 	/**
 	 * splits out into subhandlers based on filter output type.
@@ -95,12 +93,6 @@ private:
 	void handleAcceptedAssetOutputAssetId(uint8_t filterId, AssetFilter filter, const scanned_device_t& asset);
 	void handleAcceptedAssetOutputAssetIdNearest(uint8_t filterId, AssetFilter filter, const scanned_device_t& asset);
 
-	/**
-	 * Returns true if there is a filter that rejects this device.
-	 * (Does not check if the filterstore is ready.)
-	 */
-	bool isAssetRejected(const scanned_device_t& device);
-
 public:
 	/**
 	 * Internal usage.
@@ -11,7 +11,7 @@
 
 #include <localisation/cs_AssetRecord.h>
 #include <util/cs_Coroutine.h>
-#include <util/cs_Store.h>
+#include <util/cs_IndexedStore.h>
 
 class AssetStore : public EventListener, public Component {
 public:
@@ -74,7 +74,10 @@ private:
 
 	// =================== private variables ===================
 
-	Store<asset_record_t, MAX_RECORDS> _store;
+	/**
+	 * Records, the least recently received record is overwritten when full.
+	 */
+	IndexedStore<asset_record_t, MAX_RECORDS> _store;
 
 	Coroutine updateLastReceivedCounterRoutine;
 	Coroutine updateLastSentCounterRoutine;
@@ -84,7 +87,7 @@ private:
 	/**
 	 * returns a pointer of record if found,
 	 * else tries to create a new blank record and return a pointer to that,
-	 * else returns nullptr.
+	 * else overwrites the least recently received record.
 	 */
 	asset_record_t* getOrCreateRecord(const asset_id_t& id);
 
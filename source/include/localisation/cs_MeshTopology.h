@@ -10,6 +10,7 @@
 #include <cstdint>
 #include <events/cs_EventListener.h>
 #include <protocol/cs_MeshTopologyPackets.h>
+#include <util/cs_Coroutine.h>
 
 #if BUILD_MESH_TOPOLOGY_RESEARCH == 1
 #include <localisation/cs_MeshTopologyResearch.h>
@@ -103,6 +104,14 @@ private:
 	 */
 	uint16_t _sendCountdown;
 
+	/**
+	 * Calls onTickSecond() every second.
+	 */
+	Coroutine _tickSecondRoutine = Coroutine([this]() {
+		onTickSecond();
+		return Coroutine::delayS(1);
+	});
+
 	/**
 	 * Countdown in seconds until sending the next no hop ping mesh message.
 	 */
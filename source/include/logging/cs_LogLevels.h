@@ -0,0 +1,26 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+#pragma once
+
+/**
+ * The log levels follow more or less common conventions with a few exceptions. There are some modes in which we run
+ * where even fatal messages will not be written to console. In production we use SERIAL_NONE, SERIAL_READ_ONLY, or
+ * SERIAL_BYTE_PROTOCOL_ONLY.
+ *
+ * Kept separate from cs_Serial.h, so that it can be used without the serial driver.
+ * Note: this file is also used by C code.
+ */
+#define SERIAL_NONE                 0
+#define SERIAL_READ_ONLY            1
+#define SERIAL_BYTE_PROTOCOL_ONLY   2
+#define SERIAL_FATAL                3
+#define SERIAL_ERROR                4
+#define SERIAL_WARN                 5
+#define SERIAL_INFO                 6
+#define SERIAL_DEBUG                7
+#define SERIAL_VERBOSE              8
+#define SERIAL_VERY_VERBOSE         9
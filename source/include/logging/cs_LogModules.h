@@ -0,0 +1,147 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+#pragma once
+
+#include <logging/cs_LogLevels.h>
+
+#include <cstdint>
+
+/**
+ * Modules that can be logged with the module log macros (LOGMd etc. in cs_Logger.h).
+ *
+ * Each module has a compile time level: logs that are more verbose are not compiled in, including their arguments.
+ * The logs that are compiled in, are also filtered by a runtime level, which can be set via UART.
+ *
+ * Only append modules, the index is used in the UART protocol.
+ */
+enum LogModule : uint8_t {
+	LOG_MODULE_MESH            = 0,
+	LOG_MODULE_MESH_MODEL      = 1,
+	LOG_MODULE_ASSET_FILTERING = 2,
+	LOG_MODULE_STATE           = 3,
+	LOG_MODULE_SCANNER         = 4,
+	LOG_MODULE_COUNT
+};
+
+/**
+ * Set the runtime level of all modules at once.
+ */
+constexpr uint8_t LOG_MODULE_ALL = 0xFF;
+
+/**
+ * Compile time level per module: the most verbose level that is compiled in.
+ *
+ * Can be overridden with a compile definition, like: -DCS_LOG_LEVEL_MESH=SERIAL_DEBUG
+ */
+#ifndef CS_LOG_LEVEL_MESH
+#define CS_LOG_LEVEL_MESH SERIAL_WARN
+#endif
+
+#ifndef CS_LOG_LEVEL_MESH_MODEL
+#define CS_LOG_LEVEL_MESH_MODEL SERIAL_WARN
+#endif
+
+#ifndef CS_LOG_LEVEL_ASSET_FILTERING
+#define CS_LOG_LEVEL_ASSET_FILTERING SERIAL_INFO
+#endif
+
+#ifndef CS_LOG_LEVEL_STATE
+#define CS_LOG_LEVEL_STATE SERIAL_INFO
+#endif
+
+#ifndef CS_LOG_LEVEL_SCANNER
+#define CS_LOG_LEVEL_SCANNER SERIAL_INFO
+#endif
+
+constexpr uint8_t LOG_MODULE_COMPILED_LEVELS[LOG_MODULE_COUNT] = {
+		CS_LOG_LEVEL_MESH,
+		CS_LOG_LEVEL_MESH_MODEL,
+		CS_LOG_LEVEL_ASSET_FILTERING,
+		CS_LOG_LEVEL_STATE,
+		CS_LOG_LEVEL_SCANNER,
+};
+
+/**
+ * Runtime level per module, starts at the compile time level.
+ *
+ * Returns an array of LOG_MODULE_COUNT levels.
+ */
+inline uint8_t* getLogModuleLevels() {
+	static uint8_t levels[LOG_MODULE_COUNT] = {
+			CS_LOG_LEVEL_MESH,
+			CS_LOG_LEVEL_MESH_MODEL,
+			CS_LOG_LEVEL_ASSET_FILTERING,
+			CS_LOG_LEVEL_STATE,
+			CS_LOG_LEVEL_SCANNER,
+	};
+	return levels;
+}
+
+/**
+ * Whether a log of given module and level is compiled in.
+ */
+constexpr bool logModuleCompiled(LogModule module, uint8_t level) {
+	return level <= LOG_MODULE_COMPILED_LEVELS[module];
+}
+
+/**
+ * Whether a log of given module and level is enabled at runtime.
+ */
+inline bool logModuleEnabled(LogModule module, uint8_t level) {
+	return level <= getLogModuleLevels()[module];
+}
+
+/**
+ * Set the runtime level of a module.
+ *
+ * The level is capped at the compile time level.
+ *
+ * @param[in] module     The module, or LOG_MODULE_ALL.
+ * @param[in] level      The most verbose level to log.
+ * @return               False when the module is invalid.
+ */
+inline bool setLogModuleLevel(uint8_t module, uint8_t level) {
+	if (module == LOG_MODULE_ALL) {
+		for (uint8_t i = 0; i < LOG_MODULE_COUNT; ++i) {
+			setLogModuleLevel(i, level);
+		}
+		return true;
+	}
+	if (module >= LOG_MODULE_COUNT) {
+		return false;
+	}
+	getLogModuleLevels()[module] = (level < LOG_MODULE_COMPILED_LEVELS[module]) ? level : LOG_MODULE_COMPILED_LEVELS[module];
+	return true;
+}
+
+/**
+ * Log of a module: only compiled in when the level is within the module's compile time level,
+ * and only logged when the level is within the module's runtime level.
+ *
+ * Uses _log() and _logArray() of cs_Logger.h. Like those, the compile time check is a constant condition, so the
+ * compiler removes the log, including its arguments.
+ */
+#define _logModule(module, level, addNewLine, fmt, ...) \
+		if (level <= SERIAL_VERBOSITY && logModuleCompiled(module, level)) { \
+			if (logModuleEnabled(module, level)) { \
+				_log(level, addNewLine, fmt, ##__VA_ARGS__); \
+			} \
+		}
+
+#define _logArrayModule(module, level, addNewLine, pointer, size) \
+		if (level <= SERIAL_VERBOSITY && logModuleCompiled(module, level)) { \
+			if (logModuleEnabled(module, level)) { \
+				_logArray(level, addNewLine, pointer, size); \
+			} \
+		}
+
+#define LOGMvv(module, fmt, ...) _logModule(module, SERIAL_VERY_VERBOSE, true, fmt, ##__VA_ARGS__)
+#define LOGMv(module, fmt, ...)  _logModule(module, SERIAL_VERBOSE,      true, fmt, ##__VA_ARGS__)
+#define LOGMd(module, fmt, ...)  _logModule(module, SERIAL_DEBUG,        true, fmt, ##__VA_ARGS__)
+#define LOGMi(module, fmt, ...)  _logModule(module, SERIAL_INFO,         true, fmt, ##__VA_ARGS__)
+#define LOGMw(module, fmt, ...)  _logModule(module, SERIAL_WARN,         true, fmt, ##__VA_ARGS__)
+#define LOGMe(module, fmt, ...)  _logModule(module, SERIAL_ERROR,        true, fmt, ##__VA_ARGS__)
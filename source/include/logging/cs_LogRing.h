@@ -0,0 +1,320 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+/**
+ * Header of each record in the log ring.
+ */
+struct __attribute__((__packed__)) log_ring_record_header_t {
+	uint16_t size;    // Size of the payload, excluding this header and padding.
+	uint8_t type;     // Type of the payload, or LOG_RING_RECORD_TYPE_PADDING.
+	uint8_t checksum; // Additive checksum of the size, type, and payload.
+};
+
+/**
+ * Record type of the unused bytes at the end of the buffer, when a record didn't fit.
+ */
+constexpr uint8_t LOG_RING_RECORD_TYPE_PADDING = 0xFF;
+
+/**
+ * Value of the magic, when the log ring has been initialized.
+ */
+constexpr uint32_t LOG_RING_MAGIC = 0x4C4F4752;
+
+/**
+ * Ring buffer of log records, that keeps the most recent records.
+ *
+ * A record is written in parts, with start(), write(), and end(), and is only added to the ring at end().
+ * Records are contiguous in the buffer, so they can be sent at once. When a record doesn't fit at the end of
+ * the buffer, the remainder is filled with a padding record, and the record is written at the start.
+ * When there is no space, the oldest records are overwritten. Unsent records that are overwritten, are counted as lost.
+ *
+ * Sent records are kept, so that the last records before a reset can be recovered. For this, the log ring should
+ * be placed in RAM that is not initialized at boot, and recover() should be called before the first use.
+ *
+ * This class has no constructor, so that it's not cleared at boot. This also means it should be used from a
+ * single context: not from interrupts.
+ *
+ * The layout of the class is parsed by scripts/log-ring-decoder.py, keep it in sync.
+ *
+ * @param Size      Size of the buffer in bytes, should be a multiple of 4.
+ */
+template <uint16_t Size>
+class LogRing {
+	static constexpr uint16_t ALIGNMENT = 4;
+
+public:
+	static_assert(Size % ALIGNMENT == 0 && Size >= 2 * ALIGNMENT, "Size should be a multiple of 4.");
+
+	/**
+	 * Remove all records, and reset the lost records counter.
+	 */
+	void clear() {
+		_magic       = LOG_RING_MAGIC;
+		_bufferSize  = Size;
+		_head        = 0;
+		_tail        = 0;
+		_sent        = 0;
+		_used        = 0;
+		_unsent      = 0;
+		_lostRecords = 0;
+		_writing     = false;
+	}
+
+	/**
+	 * Check if the records from before a reset are valid, else clear the log ring.
+	 *
+	 * All valid records are marked as unsent, so that they will be sent again.
+	 *
+	 * @return     Number of recovered records.
+	 */
+	uint16_t recover() {
+		uint16_t numRecords = 0;
+		if (!isValid(numRecords)) {
+			clear();
+			return 0;
+		}
+		_sent    = _tail;
+		_unsent  = _used;
+		_writing = false;
+		return numRecords;
+	}
+
+	/**
+	 * Start a record.
+	 *
+	 * Makes space, by overwriting the oldest records.
+	 *
+	 * @param[in] type       Type of the record.
+	 * @param[in] size       Size of the payload, that will be written with write().
+	 * @return               False when the record is too large, the record is then dropped.
+	 */
+	bool start(uint8_t type, uint16_t size) {
+		uint32_t recordSize = getRecordSize(size);
+		if (recordSize > Size) {
+			_writing = false;
+			_lostRecords++;
+			return false;
+		}
+		if (static_cast<uint32_t>(Size - _head) < recordSize) {
+			// Doesn't fit at the end: pad the remainder, and start at the beginning.
+			uint16_t paddingSize = Size - _head;
+			makeSpace(paddingSize);
+			writeHeader(_head, paddingSize - sizeof(log_ring_record_header_t), LOG_RING_RECORD_TYPE_PADDING);
+			getHeader(_head)->checksum = calculateChecksum(_head);
+			commit(paddingSize);
+		}
+		makeSpace(recordSize);
+		writeHeader(_head, size, type);
+		_writeIndex = _head + sizeof(log_ring_record_header_t);
+		_writeEnd   = _writeIndex + size;
+		_writing    = true;
+		return true;
+	}
+
+	/**
+	 * Write a part of the payload of the started record.
+	 *
+	 * Bytes beyond the size given at start() are ignored.
+	 */
+	void write(const uint8_t* data, uint16_t size) {
+		if (!_writing) {
+			return;
+		}
+		if (size > _writeEnd - _writeIndex) {
+			size = _writeEnd - _writeIndex;
+		}
+		memcpy(_buffer + _writeIndex, data, size);
+		_writeIndex += size;
+	}
+
+	/**
+	 * End the started record: adds it to the ring.
+	 */
+	void end() {
+		if (!_writing) {
+			return;
+		}
+		_writing = false;
+		// Payload that was not written is zeroed.
+		memset(_buffer + _writeIndex, 0, _writeEnd - _writeIndex);
+		log_ring_record_header_t* header = getHeader(_head);
+		header->checksum                 = calculateChecksum(_head);
+		commit(getRecordSize(header->size));
+	}
+
+	/**
+	 * Get the oldest unsent record.
+	 *
+	 * @param[out] type      Type of the record.
+	 * @param[out] data      Set to the payload of the record.
+	 * @param[out] size      Size of the payload.
+	 * @return               False when there are no unsent records.
+	 */
+	bool peek(uint8_t& type, const uint8_t*& data, uint16_t& size) {
+		while (_unsent != 0) {
+			log_ring_record_header_t* header = getHeader(_sent);
+			if (header->type != LOG_RING_RECORD_TYPE_PADDING) {
+				type = header->type;
+				size = header->size;
+				data = _buffer + _sent + sizeof(log_ring_record_header_t);
+				return true;
+			}
+			markSent();
+		}
+		return false;
+	}
+
+	/**
+	 * Mark the oldest unsent record as sent.
+	 *
+	 * The record stays in the ring, until it's overwritten.
+	 */
+	void pop() {
+		if (_unsent != 0) {
+			markSent();
+		}
+	}
+
+	/**
+	 * Whether there are unsent records.
+	 */
+	bool hasUnsent() const { return _unsent != 0; }
+
+	/**
+	 * Number of unsent records that were overwritten, or too large.
+	 */
+	uint32_t getLostRecords() const { return _lostRecords; }
+
+private:
+	uint32_t _magic;
+	uint16_t _bufferSize;
+
+	//! Where the next record is written.
+	uint16_t _head;
+
+	//! Where the oldest record starts.
+	uint16_t _tail;
+
+	//! Where the oldest unsent record starts.
+	uint16_t _sent;
+
+	//! Number of bytes from tail to head.
+	uint16_t _used;
+
+	//! Number of bytes from sent to head.
+	uint16_t _unsent;
+
+	uint32_t _lostRecords;
+
+	//! Where the next payload byte of the started record is written.
+	uint16_t _writeIndex;
+
+	//! End of the payload of the started record.
+	uint16_t _writeEnd;
+
+	//! Whether a record has been started.
+	bool _writing;
+
+	alignas(ALIGNMENT) uint8_t _buffer[Size];
+
+	static uint32_t getRecordSize(uint16_t payloadSize) {
+		return (sizeof(log_ring_record_header_t) + payloadSize + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+	}
+
+	log_ring_record_header_t* getHeader(uint16_t index) {
+		return reinterpret_cast<log_ring_record_header_t*>(_buffer + index);
+	}
+
+	void writeHeader(uint16_t index, uint16_t size, uint8_t type) {
+		log_ring_record_header_t* header = getHeader(index);
+		header->size                     = size;
+		header->type                     = type;
+		header->checksum                 = 0;
+	}
+
+	uint8_t calculateChecksum(uint16_t index) {
+		log_ring_record_header_t* header = getHeader(index);
+		uint8_t sum                      = header->size + (header->size >> 8) + header->type;
+		if (header->type != LOG_RING_RECORD_TYPE_PADDING) {
+			const uint8_t* payload = _buffer + index + sizeof(log_ring_record_header_t);
+			for (uint16_t i = 0; i < header->size; ++i) {
+				sum += payload[i];
+			}
+		}
+		return ~sum;
+	}
+
+	void commit(uint16_t recordSize) {
+		_head = (_head + recordSize) % Size;
+		_used += recordSize;
+		_unsent += recordSize;
+	}
+
+	void makeSpace(uint16_t recordSize) {
+		while (Size - _used < recordSize) {
+			removeOldest();
+		}
+	}
+
+	void removeOldest() {
+		log_ring_record_header_t* header = getHeader(_tail);
+		uint16_t recordSize              = getRecordSize(header->size);
+		if (_unsent == _used) {
+			// The oldest record has not been sent yet.
+			if (header->type != LOG_RING_RECORD_TYPE_PADDING) {
+				_lostRecords++;
+			}
+			_sent = (_sent + recordSize) % Size;
+			_unsent -= recordSize;
+		}
+		_tail = (_tail + recordSize) % Size;
+		_used -= recordSize;
+	}
+
+	void markSent() {
+		uint16_t recordSize = getRecordSize(getHeader(_sent)->size);
+		_sent               = (_sent + recordSize) % Size;
+		_unsent -= recordSize;
+	}
+
+	/**
+	 * Check the state and all records.
+	 */
+	bool isValid(uint16_t& numRecords) {
+		if (_magic != LOG_RING_MAGIC || _bufferSize != Size) {
+			return false;
+		}
+		if (_head >= Size || _tail >= Size || _used > Size) {
+			return false;
+		}
+		if ((_head | _tail) % ALIGNMENT != 0 || (_tail + _used) % Size != _head) {
+			return false;
+		}
+		uint16_t index = _tail;
+		uint16_t left  = _used;
+		while (left != 0) {
+			log_ring_record_header_t* header = getHeader(index);
+			uint32_t recordSize              = getRecordSize(header->size);
+			if (recordSize > left || index + recordSize > Size) {
+				return false;
+			}
+			if (header->checksum != calculateChecksum(index)) {
+				return false;
+			}
+			if (header->type != LOG_RING_RECORD_TYPE_PADDING) {
+				numRecords++;
+			}
+			index = (index + recordSize) % Size;
+			left -= recordSize;
+		}
+		return true;
+	}
+};
@@ -13,6 +13,9 @@
  * Generally, you want to use: LOGnone, LOGv, LOGd, LOGi, LOGw, LOGe, or LOGf.
  * These can be used like printf(), except that they will always add a newline.
  *
+ * Logs of a module can use LOGMvv, LOGMv, LOGMd, LOGMi, LOGMw, or LOGMe, with a LogModule as first argument.
+ * These are filtered by the module level at compile time, and at runtime. See cs_LogModules.h.
+ *
  * With binary logging, the arguments are not first converted into plain text before sending them over the UART.
  * This is why templated and specialized functions are required for the implementation.
  * This saves a lot of bytes to be sent, and saves binary size, as the strings do not end up in the firmware.
@@ -29,6 +32,7 @@
 #include <cstdint>
 #include <protocol/cs_UartMsgTypes.h>
 #include <drivers/cs_Serial.h> // For SERIAL_VERBOSITY.
+#include <logging/cs_LogModules.h>
 #include <cfg/cs_Strings.h> // Should actually be included by the files that use these.
 
 
@@ -37,8 +41,28 @@
 
 
 
+#ifndef CS_SERIAL_LOG_RING_SIZE
+#define CS_SERIAL_LOG_RING_SIZE 0
+#endif
+
+/**
+ * Whether binary logs are written to a RAM buffer, and sent by LOG_FLUSH(), instead of immediately.
+ */
+#if !defined HOST_TARGET && (CS_SERIAL_NRF_LOG_ENABLED == 0) && (CS_UART_BINARY_PROTOCOL_ENABLED == 1) \
+		&& (SERIAL_VERBOSITY > SERIAL_BYTE_PROTOCOL_ONLY) && (CS_SERIAL_LOG_RING_SIZE > 0)
+	#define CS_SERIAL_LOG_RING_ENABLED 1
+#else
+	#define CS_SERIAL_LOG_RING_ENABLED 0
+#endif
+
 #if !defined HOST_TARGET && (CS_SERIAL_NRF_LOG_ENABLED > 0)
 	#define LOG_FLUSH NRF_LOG_FLUSH
+#elif CS_SERIAL_LOG_RING_ENABLED == 1
+	/**
+	 * Send the logs in the RAM buffer, as far as the UART TX buffer has space.
+	 */
+	void cs_log_flush();
+	#define LOG_FLUSH() cs_log_flush()
 #else
 	#define LOG_FLUSH()
 #endif
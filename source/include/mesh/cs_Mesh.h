@@ -142,4 +142,9 @@ private:
 	void configureModels(dsm_handle_t appkeyHandle);
 
 	void onTick(uint32_t tickCount);
+
+	/**
+	 * Write the queue statistics of a model to UART.
+	 */
+	void writeQueueStats(uint8_t modelId, const cs_mesh_queue_stats_t& stats);
 };
@@ -0,0 +1,118 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#pragma once
+
+#include <mesh/cs_MeshDefines.h>
+
+#include <cstdint>
+
+/**
+ * Statistics of the burst scheduler.
+ */
+struct __attribute__((__packed__)) cs_mesh_burst_stats_t {
+	uint16_t numSent            = 0; // Number of msgs accepted by the mesh stack.
+	uint16_t numBusy            = 0; // Number of msgs the mesh stack couldn't accept, because it was busy.
+	uint16_t numThrottled       = 0; // Number of times a msg was skipped, because its type was over budget.
+	uint16_t numIntervalsBacklog = 0; // Number of intervals that ended with msgs left in a queue.
+	uint8_t minRate             = MESH_MODEL_BURST_RATE_MAX; // Lowest rate used.
+	uint8_t maxRate             = 0; // Highest rate used.
+};
+
+/**
+ * Decides how many messages the mesh models can send, shared by all models.
+ *
+ * Uses a token bucket: each process interval, a number of tokens (the rate) is added, up to a max (the capacity).
+ * Each message that is sent costs a token. So after the queues have been idle, a larger burst can be sent at once.
+ *
+ * The rate adapts:
+ * - When the mesh stack can't accept a message, the rate is halved.
+ * - When an interval ended with messages left in a queue, while all tokens were used, the rate is increased by 1.
+ * - When an interval ended without messages left, the rate moves back to the initial rate.
+ *
+ * Message types can get a budget of their own, also a token bucket. This way, a type that is queued a lot, like
+ * asset reports, can't take up all tokens.
+ */
+class MeshBurstScheduler {
+public:
+	MeshBurstScheduler();
+
+	/**
+	 * Set the budget of a message type.
+	 *
+	 * @param[in] type       Mesh msg type.
+	 * @param[in] rate       Number of messages of this type that can be sent each interval, on average.
+	 * @param[in] capacity   Max number of messages of this type that can be sent at once.
+	 * @return               False when there are too many type budgets.
+	 */
+	bool setTypeBudget(uint8_t type, uint8_t rate, uint8_t capacity);
+
+	/**
+	 * Start a new process interval: adapt the rate, and add tokens.
+	 *
+	 * To be called before the models process their queue.
+	 */
+	void startInterval();
+
+	/**
+	 * Whether a message can be sent now.
+	 */
+	bool canSend();
+
+	/**
+	 * Whether a message of given type can be sent now, also checks the budget of the type.
+	 *
+	 * Counts as throttled when only the budget of the type is used up.
+	 */
+	bool canSend(uint8_t type);
+
+	/**
+	 * To be called after a message was handed to the mesh stack.
+	 *
+	 * @param[in] type       Mesh msg type.
+	 * @param[in] accepted   False when the mesh stack was busy, and the message should be sent again later.
+	 */
+	void onSent(uint8_t type, bool accepted);
+
+	/**
+	 * To be called after a model processed its queue.
+	 *
+	 * @param[in] queueSize  Number of messages left in the queue.
+	 */
+	void onQueueProcessed(uint8_t queueSize);
+
+	/**
+	 * Get the current rate: the number of tokens added each interval.
+	 */
+	uint8_t getRate();
+
+	const cs_mesh_burst_stats_t& getStats();
+
+private:
+	struct __attribute__((__packed__)) cs_mesh_type_budget_t {
+		uint8_t type;
+		uint8_t rate;
+		uint8_t capacity;
+		uint8_t tokens;
+	};
+
+	cs_mesh_type_budget_t _typeBudgets[MESH_MODEL_BURST_TYPE_BUDGETS_MAX];
+	uint8_t _numTypeBudgets = 0;
+
+	uint8_t _rate;
+	uint8_t _tokens;
+
+	/**
+	 * What happened in the current interval, used to adapt the rate.
+	 */
+	bool _busy    = false;
+	bool _backlog = false;
+
+	cs_mesh_burst_stats_t _stats;
+
+	cs_mesh_type_budget_t* getTypeBudget(uint8_t type);
+};
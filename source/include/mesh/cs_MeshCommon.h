@@ -53,6 +53,7 @@ struct cs_mesh_queue_item_t {
 	bool reliable = false;
 	bool broadcast = true;
 	bool noHop = false;
+	bool replace = false; // Whether to replace a queued item with the same type and id, instead of adding a new one.
 	uint8_t numIds = 0;
 	stone_id_t* stoneIdsPtr = nullptr;
 	cs_data_t msgPayload;
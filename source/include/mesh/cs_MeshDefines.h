@@ -7,17 +7,15 @@
 
 #pragma once
 
-// Debug logs
-#define LOGMeshWarning LOGw
-#define LOGMeshInfo LOGvv
-#define LOGMeshDebug LOGvv
-#define LOGMeshVerbose LOGvv
-
-// Debug logs
-#define LOGMeshModelInfo    LOGvv
-#define LOGMeshModelDebug   LOGvv
-#define LOGMeshModelVerbose LOGvv
-#define LogLevelMeshModelVerbose SERIAL_VERY_VERBOSE
+// Debug logs, set the levels with CS_LOG_LEVEL_MESH and CS_LOG_LEVEL_MESH_MODEL.
+#define LOGMeshWarning(fmt, ...) LOGMw(LOG_MODULE_MESH, fmt, ##__VA_ARGS__)
+#define LOGMeshInfo(fmt, ...)    LOGMi(LOG_MODULE_MESH, fmt, ##__VA_ARGS__)
+#define LOGMeshDebug(fmt, ...)   LOGMd(LOG_MODULE_MESH, fmt, ##__VA_ARGS__)
+#define LOGMeshVerbose(fmt, ...) LOGMv(LOG_MODULE_MESH, fmt, ##__VA_ARGS__)
+
+#define LOGMeshModelInfo(fmt, ...)    LOGMi(LOG_MODULE_MESH_MODEL, fmt, ##__VA_ARGS__)
+#define LOGMeshModelDebug(fmt, ...)   LOGMd(LOG_MODULE_MESH_MODEL, fmt, ##__VA_ARGS__)
+#define LOGMeshModelVerbose(fmt, ...) LOGMv(LOG_MODULE_MESH_MODEL, fmt, ##__VA_ARGS__)
 
 /*
  * 0 to disable test.
@@ -46,9 +44,22 @@
 #define MESH_MODEL_ACK_TRANSMISSIONS 1
 
 /**
- * Number of messages sent each time processQueue() gets called.
+ * Number of messages that can be sent each time processQueue() gets called, summed over all models.
+ * Starts at the initial rate, and adapts between the min and max rate (see MeshBurstScheduler).
+ */
+#define MESH_MODEL_BURST_RATE_MIN 1
+#define MESH_MODEL_BURST_RATE_INIT 3
+#define MESH_MODEL_BURST_RATE_MAX 6
+
+/**
+ * Max number of messages that can be sent at once, after the queues have been idle.
+ */
+#define MESH_MODEL_BURST_CAPACITY 8
+
+/**
+ * Max number of message types with a budget of their own.
  */
-#define MESH_MODEL_QUEUE_BURST_COUNT 3
+#define MESH_MODEL_BURST_TYPE_BUDGETS_MAX 4
 
 /**
  * Timeout in seconds for reliable msgs.
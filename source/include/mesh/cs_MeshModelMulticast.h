@@ -7,7 +7,9 @@
 
 #pragma once
 
+#include <mesh/cs_MeshBurstScheduler.h>
 #include <mesh/cs_MeshCommon.h>
+#include <mesh/cs_MeshQueue.h>
 #include <third/std/function.h>
 
 extern "C" {
@@ -43,10 +45,14 @@ public:
 	void configureSelf(dsm_handle_t appkeyHandle);
 
 	/**
-	 * Add a msg to an empty spot in the queue (transmissions == 0).
-	 * Start looking at SendIndex, then reverse iterate over the queue.
-	 * Then set the new SendIndex at the newly added item, so that it will be send first.
-	 * We do the reverse iterate, so that the old SendIndex should be handled early (for a large enough queue).
+	 * Set the scheduler that decides how many msgs can be sent.
+	 */
+	void setBurstScheduler(MeshBurstScheduler* burstScheduler);
+
+	/**
+	 * Add a msg to the back of the queue.
+	 *
+	 * When item.replace is set, a queued msg with the same type and id is replaced instead, keeping its place in the queue.
 	 */
 	cs_ret_code_t addToQueue(MeshUtil::cs_mesh_queue_item_t& item);
 
@@ -60,6 +66,11 @@ public:
 	 */
 	void tick(uint32_t tickCount);
 
+	/**
+	 * Get the queue statistics, times are in ticks.
+	 */
+	const cs_mesh_queue_stats_t& getQueueStats();
+
 	/** Internal usage */
 	void handleMsg(const access_message_rx_t * accessMsg);
 
@@ -78,25 +89,19 @@ private:
 
 	callback_msg_t _msgCallback = nullptr;
 
-	cs_multicast_queue_item_t _queue[_queueSize];
+	MeshBurstScheduler* _burstScheduler = nullptr;
 
-	/**
-	 * Next index in queue to send.
-	 */
-	uint8_t _queueIndexNext = 0;
+	MeshQueue<cs_multicast_queue_item_t, _queueSize> _queue;
 
 	/**
-	 * Send messages from queue.
+	 * Tick count of the last tick, used for the time in queue.
 	 */
-	void processQueue();
+	uint16_t _tickCount = 0;
 
 	/**
-	 * Check if there is a msg in queue with more than 0 transmissions.
-	 * If so, return that index.
-	 * Start looking at index SendIndex as that item should be sent first.
-	 * Returns -1 if none found.
+	 * Send messages from queue, as many as the burst scheduler allows.
 	 */
-	int getNextItemInQueue(bool priority);
+	void processQueue();
 
 	/**
 	 * Get a msg from the queue, and send it.
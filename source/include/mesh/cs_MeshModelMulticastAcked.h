@@ -7,7 +7,9 @@
 
 #pragma once
 
+#include <mesh/cs_MeshBurstScheduler.h>
 #include <mesh/cs_MeshCommon.h>
+#include <mesh/cs_MeshQueue.h>
 #include <third/std/function.h>
 #include <util/cs_BitmaskVarSize.h>
 
@@ -44,10 +46,9 @@ public:
 	void configureSelf(dsm_handle_t appkeyHandle);
 
 	/**
-	 * Add a msg to an empty spot in the queue (transmissions == 0).
-	 * Start looking at SendIndex, then reverse iterate over the queue.
-	 * Then set the new SendIndex at the newly added item, so that it will be send first.
-	 * We do the reverse iterate, so that the old SendIndex should be handled early (for a large enough queue).
+	 * Add a msg to the back of the queue.
+	 *
+	 * Msgs are sent one at a time, until all stones acked, or until timeout.
 	 */
 	cs_ret_code_t addToQueue(MeshUtil::cs_mesh_queue_item_t& item);
 
@@ -61,14 +62,22 @@ public:
 	 */
 	void tick(uint32_t tickCount);
 
+	/**
+	 * Set the scheduler that decides whether msgs can be sent.
+	 */
+	void setBurstScheduler(MeshBurstScheduler* burstScheduler);
+
+	/**
+	 * Get the queue statistics, times are in ticks.
+	 */
+	const cs_mesh_queue_stats_t& getQueueStats();
+
 	/** Internal usage */
 	void handleMsg(const access_message_rx_t * accessMsg);
 
 private:
 	const static uint8_t queue_size = 5;
 
-	const static uint8_t queue_index_none = 255;
-
 	struct __attribute__((__packed__)) cs_multicast_acked_queue_item_t {
 		MeshUtil::cs_mesh_queue_item_meta_data_t metaData;
 		uint8_t numIds;
@@ -84,17 +93,19 @@ private:
 
 	callback_msg_t _msgCallback = nullptr;
 
-	cs_multicast_acked_queue_item_t _queue[queue_size];
+	MeshBurstScheduler* _burstScheduler = nullptr;
+
+	MeshQueue<cs_multicast_acked_queue_item_t, queue_size> _queue;
 
 	/**
-	 * Queue index of message currently being sent.
+	 * Queued message currently being sent, or nullptr.
 	 */
-	uint8_t _queueIndexInProgress = queue_index_none;
+	cs_multicast_acked_queue_item_t* _itemInProgress = nullptr;
 
 	/**
-	 * Next index in queue to send.
+	 * Tick count of the last tick, used for the time in queue.
 	 */
-	uint8_t _queueIndexNext = 0;
+	uint16_t _tickCount = 0;
 
 	/**
 	 * Bitmask of acked stones.
@@ -118,28 +129,20 @@ private:
 	uint16_t _processCallsLeft;
 
 	/**
-	 * If item at index is in progress, cancel it.
+	 * If the item is in progress, cancel it.
 	 */
-	void cancelQueueItem(uint8_t index);
+	void cancelQueueItem(cs_multicast_acked_queue_item_t* item);
 
 	/**
-	 * Remove an item from the queue
+	 * Free the msg and stone ids of an item.
 	 */
-	void remQueueItem(uint8_t index);
+	void freeQueueItem(cs_multicast_acked_queue_item_t* item);
 
 	/**
 	 * Send messages from queue.
 	 */
 	void processQueue();
 
-	/**
-	 * Check if there is a msg in queue with more than 0 transmissions.
-	 * If so, return that index.
-	 * Start looking at index SendIndex as that item should be sent first.
-	 * Returns -1 if none found.
-	 */
-	int getNextItemInQueue(bool priority);
-
 	/**
 	 * Get a msg from the queue, and send it.
 	 * Returns true when message was sent, false when no more messages to be sent.
@@ -172,6 +175,11 @@ private:
 	 */
 	void checkDone();
 
+	/**
+	 * Remove the item in progress from the queue, because it's done.
+	 */
+	void removeItemInProgress();
+
 	/**
 	 * Retry sending (parts of) the message.
 	 */
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <mesh/cs_MeshBurstScheduler.h>
 #include <mesh/cs_MeshCommon.h>
 #include <mesh/cs_MeshModelMulticast.h>
 #include <mesh/cs_MeshModelMulticastAcked.h>
@@ -16,6 +17,8 @@
 
 /**
  * Class that selects which model to use to send a message.
+ *
+ * Also owns the burst scheduler, that decides how many messages all models together can send.
  */
 class MeshModelSelector {
 public:
@@ -36,10 +39,25 @@ public:
 
 	/**
 	 * Remove an item from the send queue.
+	 *
+	 * Unreliable broadcast items are removed from both the multicast and the multicast neighbours model.
+	 * When item.replace is set, the model the item will be added to is skipped, so the item can be replaced in place.
 	 */
 	cs_ret_code_t remFromQueue(MeshUtil::cs_mesh_queue_item_t & item);
 
+	/**
+	 * To be called at a regular interval: lets the models process their queue.
+	 */
+	void tick(uint32_t tickCount);
+
+	/**
+	 * Get the burst scheduler statistics.
+	 */
+	const cs_mesh_burst_stats_t& getBurstStats();
+
 private:
+	MeshBurstScheduler _burstScheduler;
+
 	MeshModelMulticast* _multicastModel                     = nullptr;
 	MeshModelMulticastAcked* _multicastAckedModel           = nullptr;
 	MeshModelMulticastNeighbours* _multicastNeighboursModel = nullptr;
@@ -7,7 +7,9 @@
 
 #pragma once
 
+#include <mesh/cs_MeshBurstScheduler.h>
 #include <mesh/cs_MeshCommon.h>
+#include <mesh/cs_MeshQueue.h>
 #include <protocol/mesh/cs_MeshModelPackets.h>
 #include <third/std/function.h>
 #include <cfg/cs_Config.h>
@@ -46,7 +48,9 @@ public:
 	void configureSelf(dsm_handle_t appkeyHandle);
 
 	/**
-	 * Add a msg the queue.
+	 * Add a msg to the back of the queue.
+	 *
+	 * Msgs are sent one at a time, until acked, or until timeout.
 	 */
 	cs_ret_code_t addToQueue(MeshUtil::cs_mesh_queue_item_t& item);
 
@@ -60,6 +64,16 @@ public:
 	 */
 	void tick(uint32_t tickCount);
 
+	/**
+	 * Set the scheduler that decides whether msgs can be sent.
+	 */
+	void setBurstScheduler(MeshBurstScheduler* burstScheduler);
+
+	/**
+	 * Get the queue statistics, times are in ticks.
+	 */
+	const cs_mesh_queue_stats_t& getQueueStats();
+
 	/** Internal usage */
 	void handleMsg(const access_message_rx_t * accessMsg);
 
@@ -69,8 +83,6 @@ public:
 private:
 	const static uint8_t queue_size = 5;
 
-	const static uint8_t queue_index_none = 255;
-
 	struct __attribute__((__packed__)) cs_unicast_queue_item_t {
 		MeshUtil::cs_mesh_queue_item_meta_data_t metaData;
 		stone_id_t targetId;
@@ -84,6 +96,8 @@ private:
 
 	callback_msg_t _msgCallback = nullptr;
 
+	MeshBurstScheduler* _burstScheduler = nullptr;
+
 	access_reliable_t _accessReliableMsg;
 
 #if MESH_MODEL_TEST_MSG == 2
@@ -92,17 +106,17 @@ private:
 	uint32_t _canceled = 0;
 #endif
 
-	cs_unicast_queue_item_t _queue[queue_size];
+	MeshQueue<cs_unicast_queue_item_t, queue_size> _queue;
 
 	/**
-	 * Queue index of message currently being sent.
+	 * Queued message currently being sent, or nullptr.
 	 */
-	uint8_t _queueIndexInProgress = queue_index_none;
+	cs_unicast_queue_item_t* _itemInProgress = nullptr;
 
 	/**
-	 * Next index in queue to send.
+	 * Tick count of the last tick, used for the time in queue.
 	 */
-	uint8_t _queueIndexNext = 0;
+	uint16_t _tickCount = 0;
 
 	/**
 	 * Status of the reliable msg.
@@ -118,28 +132,20 @@ private:
 	uint8_t _ttl = CS_MESH_DEFAULT_TTL;
 
 	/**
-	 * If item at index is in progress, cancel it.
+	 * If the item is in progress, cancel it.
 	 */
-	void cancelQueueItem(uint8_t index);
+	void cancelQueueItem(cs_unicast_queue_item_t* item);
 
 	/**
-	 * Remove an item from the queue
+	 * Free the msg of an item.
 	 */
-	void remQueueItem(uint8_t index);
+	void freeQueueItem(cs_unicast_queue_item_t* item);
 
 	/**
 	 * Send messages from queue.
 	 */
 	void processQueue();
 
-	/**
-	 * Check if there is a msg in queue with more than 0 transmissions.
-	 * If so, return that index.
-	 * Start looking at index SendIndex as that item should be sent first.
-	 * Returns -1 if none found.
-	 */
-	int getNextItemInQueue(bool priority);
-
 	/**
 	 * Get a msg from the queue, and send it.
 	 * Returns true when message was sent, false when no more messages to be sent.
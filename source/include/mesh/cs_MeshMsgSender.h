@@ -56,4 +56,9 @@ private:
 
 	cs_ret_code_t addToQueue(MeshUtil::cs_mesh_queue_item_t & item);
 	cs_ret_code_t remFromQueue(MeshUtil::cs_mesh_queue_item_t & item);
+
+	/**
+	 * Add an item to the queue, replacing queued items of the same type and id, as only the latest is of interest.
+	 */
+	cs_ret_code_t replaceInQueue(MeshUtil::cs_mesh_queue_item_t & item);
 };
@@ -0,0 +1,376 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Statistics of a mesh queue.
+ *
+ * Times are in the unit of the time passed to the queue, usually ticks.
+ */
+struct __attribute__((__packed__)) cs_mesh_queue_stats_t {
+	uint8_t highWatermark       = 0; // Max number of items that have been in the queue at once.
+	uint16_t numAdded           = 0; // Number of items added to an empty slot.
+	uint16_t numReplaced        = 0; // Number of items that replaced a queued item with the same type and id.
+	uint16_t numDropped         = 0; // Number of items that couldn't be added, because the queue was full.
+	uint16_t numRemoved         = 0; // Number of items removed before they were done.
+	uint16_t numDone            = 0; // Number of items that left the queue after they were done.
+	uint32_t totalTimeInQueue   = 0; // Sum of the time in queue of the items that were done.
+	uint16_t maxTimeInQueue     = 0; // Max time in queue of an item that was done.
+};
+
+/**
+ * Queue of outgoing mesh messages, with a fixed number of slots.
+ *
+ * - Items are in one of two FIFO lists: priority or normal. Priority items are always sent first.
+ * - Adding, getting the first item, and moving the first item to the back are O(1).
+ * - An item can replace a queued item with the same type and id. It then keeps its place in the queue, so that
+ *   repeated state updates don't pile up, nor lose their turn.
+ * - Items with the same type and id are found via a hash table, instead of iterating over the whole queue.
+ *
+ * The queue only keeps the order: the caller fills the returned item, and decides when it's done.
+ * Items that have to be sent multiple times can be moved to the back of their list after each transmission, so that
+ * items are sent interleaved.
+ *
+ * @tparam Item        The queued item, like a message with metadata.
+ * @tparam Size        Number of slots.
+ */
+template <class Item, uint8_t Size>
+class MeshQueue {
+public:
+	static_assert(Size > 0 && Size < 255, "Invalid queue size");
+
+	MeshQueue() {
+		clear();
+	}
+
+	/**
+	 * Add an item to the back of its list.
+	 *
+	 * @param[in] type       Type of the item.
+	 * @param[in] id         ID of the item, together with the type it identifies similar items.
+	 * @param[in] priority   Whether to add the item to the priority list.
+	 * @param[in] replace    Whether to replace a queued item with the same type and id, instead of adding a new one.
+	 *                       The replaced item keeps its place in the queue, unless the priority differs.
+	 * @param[in] now        Current time, used for the time in queue.
+	 * @return               The item to fill in, or nullptr when the queue is full.
+	 */
+	Item* add(uint8_t type, uint16_t id, bool priority, bool replace, uint16_t now) {
+		if (replace) {
+			uint8_t index = find(type, id);
+			if (index != INVALID_INDEX) {
+				cs_mesh_queue_slot_t& slot = _slots[index];
+				if (slot.priority != priority) {
+					unlink(index);
+					slot.priority = priority;
+					link(index);
+				}
+				_stats.numReplaced++;
+				return &(slot.item);
+			}
+		}
+		if (_freeIndex == INVALID_INDEX) {
+			_stats.numDropped++;
+			return nullptr;
+		}
+		uint8_t index  = _freeIndex;
+		_freeIndex     = _slots[index].next;
+
+		cs_mesh_queue_slot_t& slot = _slots[index];
+		slot.type      = type;
+		slot.id        = id;
+		slot.priority  = priority;
+		slot.addedTime = now;
+		link(index);
+
+		uint8_t bucket   = getBucket(type, id);
+		slot.bucketNext  = _buckets[bucket];
+		_buckets[bucket] = index;
+
+		_numItems++;
+		if (_numItems > _stats.highWatermark) {
+			_stats.highWatermark = _numItems;
+		}
+		_stats.numAdded++;
+		return &(slot.item);
+	}
+
+	/**
+	 * Get the item that is next in line: the first priority item, else the first normal item.
+	 *
+	 * @return               The item, or nullptr when the queue is empty.
+	 */
+	Item* front() {
+		uint8_t index = frontIndex();
+		if (index == INVALID_INDEX) {
+			return nullptr;
+		}
+		return &(_slots[index].item);
+	}
+
+	/**
+	 * Move the item that is next in line to the back of its list.
+	 *
+	 * Use this after sending an item that has to be sent again, so that items are sent interleaved.
+	 */
+	void rotate() {
+		uint8_t index = frontIndex();
+		if (index == INVALID_INDEX) {
+			return;
+		}
+		unlink(index);
+		link(index);
+	}
+
+	/**
+	 * Remove the item that is next in line, because it's done.
+	 *
+	 * @param[in] now        Current time, used for the time in queue.
+	 */
+	void popFront(uint16_t now) {
+		uint8_t index = frontIndex();
+		if (index == INVALID_INDEX) {
+			return;
+		}
+		done(index, now);
+	}
+
+	/**
+	 * Remove an item, because it's done.
+	 *
+	 * Use this when items are done in another order than they are sent, like items that wait for acks.
+	 *
+	 * @param[in] item       An item that is in the queue.
+	 * @param[in] now        Current time, used for the time in queue.
+	 */
+	void pop(Item& item, uint16_t now) {
+		done(getIndex(item), now);
+	}
+
+	/**
+	 * Get an item with given type and id.
+	 *
+	 * @return               The item, or nullptr when no such item is queued.
+	 */
+	Item* get(uint8_t type, uint16_t id) {
+		uint8_t index = find(type, id);
+		if (index == INVALID_INDEX) {
+			return nullptr;
+		}
+		return &(_slots[index].item);
+	}
+
+	/**
+	 * Remove all items with given type and id.
+	 *
+	 * @return               Number of removed items.
+	 */
+	uint8_t remove(uint8_t type, uint16_t id) {
+		uint8_t numRemoved = 0;
+		uint8_t index = find(type, id);
+		while (index != INVALID_INDEX) {
+			release(index);
+			numRemoved++;
+			index = find(type, id);
+		}
+		_stats.numRemoved += numRemoved;
+		return numRemoved;
+	}
+
+	/**
+	 * Remove an item before it's done.
+	 *
+	 * @param[in] item       An item that is in the queue.
+	 */
+	void remove(Item& item) {
+		release(getIndex(item));
+		_stats.numRemoved++;
+	}
+
+	/**
+	 * Remove all items, keeps the statistics.
+	 */
+	void clear() {
+		for (uint8_t i = 0; i < Size; ++i) {
+			_slots[i].next = (i + 1 < Size) ? i + 1 : INVALID_INDEX;
+		}
+		_freeIndex = 0;
+		for (uint8_t i = 0; i < NUM_LISTS; ++i) {
+			_head[i] = INVALID_INDEX;
+			_tail[i] = INVALID_INDEX;
+		}
+		for (uint8_t i = 0; i < NUM_BUCKETS; ++i) {
+			_buckets[i] = INVALID_INDEX;
+		}
+		_numItems = 0;
+	}
+
+	uint8_t size() const {
+		return _numItems;
+	}
+
+	bool empty() const {
+		return _numItems == 0;
+	}
+
+	const cs_mesh_queue_stats_t& getStats() const {
+		return _stats;
+	}
+
+	void resetStats() {
+		_stats               = cs_mesh_queue_stats_t();
+		_stats.highWatermark = _numItems;
+	}
+
+private:
+	static constexpr uint8_t INVALID_INDEX = 0xFF;
+	static constexpr uint8_t LIST_NORMAL   = 0;
+	static constexpr uint8_t LIST_PRIORITY = 1;
+	static constexpr uint8_t NUM_LISTS     = 2;
+
+	/**
+	 * Number of hash buckets: a power of 2, at least the number of slots, so that most buckets hold 1 item.
+	 */
+	static constexpr uint8_t getNumBuckets() {
+		uint16_t numBuckets = 1;
+		while (numBuckets < Size) {
+			numBuckets <<= 1;
+		}
+		return numBuckets > 128 ? 128 : numBuckets;
+	}
+	static constexpr uint8_t NUM_BUCKETS = getNumBuckets();
+
+	struct cs_mesh_queue_slot_t {
+		Item item;
+		uint16_t id;
+		uint8_t type;
+		bool priority;
+		// Previous and next item in the same list, or next free slot.
+		uint8_t prev;
+		uint8_t next;
+		// Next item in the same hash bucket.
+		uint8_t bucketNext;
+		uint16_t addedTime;
+	};
+
+	cs_mesh_queue_slot_t _slots[Size];
+
+	uint8_t _head[NUM_LISTS];
+	uint8_t _tail[NUM_LISTS];
+
+	/**
+	 * First free slot, the free slots are linked via next.
+	 */
+	uint8_t _freeIndex;
+
+	/**
+	 * First item of each hash bucket, the items in a bucket are linked via bucketNext.
+	 */
+	uint8_t _buckets[NUM_BUCKETS];
+
+	uint8_t _numItems;
+
+	cs_mesh_queue_stats_t _stats;
+
+	static uint8_t getBucket(uint8_t type, uint16_t id) {
+		return (id ^ (id >> 8) ^ (type * 31)) & (NUM_BUCKETS - 1);
+	}
+
+	/**
+	 * Get the slot of an item, the item is the first member of the slot.
+	 */
+	uint8_t getIndex(Item& item) const {
+		return static_cast<uint8_t>(reinterpret_cast<cs_mesh_queue_slot_t*>(&item) - _slots);
+	}
+
+	uint8_t frontIndex() const {
+		if (_head[LIST_PRIORITY] != INVALID_INDEX) {
+			return _head[LIST_PRIORITY];
+		}
+		return _head[LIST_NORMAL];
+	}
+
+	uint8_t find(uint8_t type, uint16_t id) const {
+		uint8_t index = _buckets[getBucket(type, id)];
+		while (index != INVALID_INDEX) {
+			if (_slots[index].type == type && _slots[index].id == id) {
+				return index;
+			}
+			index = _slots[index].bucketNext;
+		}
+		return INVALID_INDEX;
+	}
+
+	/**
+	 * Add a slot to the back of its list.
+	 */
+	void link(uint8_t index) {
+		uint8_t list = _slots[index].priority ? LIST_PRIORITY : LIST_NORMAL;
+		_slots[index].prev = _tail[list];
+		_slots[index].next = INVALID_INDEX;
+		if (_tail[list] == INVALID_INDEX) {
+			_head[list] = index;
+		}
+		else {
+			_slots[_tail[list]].next = index;
+		}
+		_tail[list] = index;
+	}
+
+	/**
+	 * Remove a slot from its list.
+	 */
+	void unlink(uint8_t index) {
+		uint8_t list = _slots[index].priority ? LIST_PRIORITY : LIST_NORMAL;
+		uint8_t prev = _slots[index].prev;
+		uint8_t next = _slots[index].next;
+		if (prev == INVALID_INDEX) {
+			_head[list] = next;
+		}
+		else {
+			_slots[prev].next = next;
+		}
+		if (next == INVALID_INDEX) {
+			_tail[list] = prev;
+		}
+		else {
+			_slots[next].prev = prev;
+		}
+	}
+
+	/**
+	 * Release a slot of which the item is done, and update the time in queue.
+	 */
+	void done(uint8_t index, uint16_t now) {
+		uint16_t timeInQueue = now - _slots[index].addedTime;
+		_stats.totalTimeInQueue += timeInQueue;
+		if (timeInQueue > _stats.maxTimeInQueue) {
+			_stats.maxTimeInQueue = timeInQueue;
+		}
+		_stats.numDone++;
+		release(index);
+	}
+
+	/**
+	 * Remove a slot from its list and hash bucket, and add it to the free slots.
+	 */
+	void release(uint8_t index) {
+		unlink(index);
+
+		uint8_t* bucketIndex = &(_buckets[getBucket(_slots[index].type, _slots[index].id)]);
+		while (*bucketIndex != index) {
+			bucketIndex = &(_slots[*bucketIndex].bucketNext);
+		}
+		*bucketIndex = _slots[index].bucketNext;
+
+		_slots[index].next = _freeIndex;
+		_freeIndex         = index;
+		_numItems--;
+	}
+};
@@ -7,26 +7,81 @@
 
 #pragma once
 
+#include <cfg/cs_Config.h>
+#include <structs/buffer/cs_ScannedDeviceRing.h>
+
 extern "C" {
 #include <nrf_mesh.h>
 }
 
+#ifndef CS_MESH_SCANNER_COALESCE_WINDOW_MS
+#define CS_MESH_SCANNER_COALESCE_WINDOW_MS 0
+#endif
+
+#ifndef CS_MESH_SCANNER_RING_SIZE
+#define CS_MESH_SCANNER_RING_SIZE 16
+#endif
+
 /**
  * Class that handles scans from the mesh.
  *
- * Copies the data into a bluenet struct and dispatches an event.
+ * Copies the scans into a ring, which is emptied in batches on the main loop: each scan is then dispatched as
+ * scanned device event. Scans of the same device can be combined, see CS_MESH_SCANNER_COALESCE_WINDOW_MS.
  */
 class MeshScanner {
 public:
 	/**
-	 * Don't dispatch scans when the CPU is busy.
-	 * This is measured by how full the scheduler queue is.
-	 * Only dispatch when there is at least N free space in the queue.
+	 * Max number of scans in the ring, scans that don't fit are dropped.
+	 *
+	 * Once the ring is half full, scans are dispatched without waiting for the coalesce window. So for coalescing to
+	 * work, the ring should be able to hold the scans of about 2 coalesce windows.
 	 */
-	const static uint16_t MIN_SCHEDULER_FREE = SCHED_QUEUE_SIZE / 2;
+	const static uint8_t RING_SIZE = CS_MESH_SCANNER_RING_SIZE;
 
 	/**
-	 * Handle a scan by the mesh, and dispatch scanned device event.
+	 * Max number of scans dispatched at once, before other events get a turn.
+	 */
+	const static uint8_t BATCH_SIZE = 8;
+
+	/**
+	 * Handle a scan by the mesh: add it to the ring.
 	 */
 	void onScan(const nrf_mesh_adv_packet_rx_data_t *scanData);
+
+	/**
+	 * To be called at a regular interval: dispatches the scans that waited long enough to be coalesced.
+	 */
+	void onTick(uint32_t tickCount);
+
+	/**
+	 * Dispatch a batch of scans from the ring.
+	 *
+	 * Internal usage.
+	 */
+	void dispatchScans();
+
+	/**
+	 * Get the number of scans, and the number of coalesced and dropped scans.
+	 */
+	const cs_scanned_device_ring_stats_t& getStats();
+
+private:
+	/**
+	 * Coalesce window, in ticks. Rounded up, so that a window of less than a tick is not disabled.
+	 */
+	const static uint32_t COALESCE_WINDOW_TICKS = (CS_MESH_SCANNER_COALESCE_WINDOW_MS + TICK_INTERVAL_MS - 1) / TICK_INTERVAL_MS;
+
+	ScannedDeviceRing<RING_SIZE> _ring;
+
+	uint32_t _tickCount = 0;
+
+	/**
+	 * Whether dispatchScans() is scheduled already.
+	 */
+	bool _dispatchScheduled = false;
+
+	/**
+	 * Schedule dispatchScans(), when not scheduled already.
+	 */
+	void scheduleDispatch();
 };
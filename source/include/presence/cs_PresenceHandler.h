@@ -10,7 +10,8 @@
 #include <optional>
 #include <presence/cs_PresenceDescription.h>
 #include <time/cs_SystemTime.h>
-#include <util/cs_Store.h>
+#include <util/cs_Coroutine.h>
+#include <util/cs_IndexedStore.h>
 #include <common/cs_Component.h>
 
 /**
@@ -106,9 +107,9 @@ private:
     };
 
     /**
-     * Stores presence records.
+     * Stores presence records, the least recently refreshed record is overwritten when full.
      */
-    Store<PresenceRecord, MAX_RECORDS> _store;
+    IndexedStore<PresenceRecord, MAX_RECORDS> _store;
 
 	/**
 	 * finds oldest record and default constructs its present record,
@@ -169,6 +170,11 @@ private:
      */
     void tickSecond();
 
+    /**
+     * Calls tickSecond() every second.
+     */
+    Coroutine _tickSecondRoutine;
+
 public:
     /**
      * receive background messages indicating where users are,
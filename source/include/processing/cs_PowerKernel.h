@@ -0,0 +1,102 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+/**
+ * Whether to use the DSP instructions of the Cortex-M4.
+ * Can be defined beforehand, to test the DSP path with emulated instructions.
+ */
+#ifndef CS_POWER_KERNEL_DSP
+#if !defined(HOST_TARGET) && defined(__ARM_FEATURE_DSP)
+#define CS_POWER_KERNEL_DSP 1
+#else
+#define CS_POWER_KERNEL_DSP 0
+#endif
+#endif
+
+#if CS_POWER_KERNEL_DSP == 1 && !defined(HOST_TARGET)
+#include <nrf.h>
+#endif
+
+/**
+ * Sums over one period of samples, with the zero values subtracted.
+ * In units of ADC value squared.
+ */
+struct power_kernel_sums_t {
+	int64_t voltageSquareSum = 0;
+	int64_t currentSquareSum = 0;
+	int64_t powerSum         = 0;
+};
+
+/**
+ * Calculates the sums of V², I², and V*I in one pass over interleaved samples.
+ *
+ * With v and i the samples, and zv and zi the zero values times 1024, the sums are:
+ *   sum((1024 * v - zv)²) / 1024²
+ *   sum((1024 * i - zi)²) / 1024²
+ *   sum((1024 * v - zv) * (1024 * i - zi)) / 1024²
+ *
+ * These are expanded, so that only sums of the raw 16 bit samples are needed in the loop:
+ *   sum((1024 * v - zv)²) = 1024² * sum(v²) - 2 * 1024 * zv * sum(v) + n * zv²
+ * The raw sums are exact, and normalized once at the end.
+ *
+ * On target with DSP instructions, 2 sample pairs are processed per iteration with dual 16 bit multiply accumulates.
+ *
+ * @param[in] samples         Interleaved samples: voltage at even indices, current at odd indices.
+ * @param[in] numSamples      Number of samples per channel.
+ * @param[in] zeroVoltage     Zero value of the voltage, times 1024.
+ * @param[in] zeroCurrent     Zero value of the current, times 1024.
+ */
+inline power_kernel_sums_t calculatePowerSums(
+		const int16_t* samples, uint16_t numSamples, int32_t zeroVoltage, int32_t zeroCurrent) {
+	int64_t vSquareSum = 0;
+	int64_t cSquareSum = 0;
+	int64_t vcSum      = 0;
+	int32_t vSum       = 0;
+	int32_t cSum       = 0;
+	uint16_t i         = 0;
+
+#if CS_POWER_KERNEL_DSP == 1
+	// Each word holds a voltage sample in the bottom half, and a current sample in the top half.
+	const uint32_t ones = 0x00010001;
+	for (; i + 1 < numSamples; i += 2) {
+		uint32_t word0;
+		uint32_t word1;
+		memcpy(&word0, samples + 2 * i, sizeof(word0));
+		memcpy(&word1, samples + 2 * i + 2, sizeof(word1));
+		uint32_t voltages = __PKHBT(word0, word1, 16);
+		uint32_t currents = __PKHTB(word1, word0, 16);
+		vSquareSum        = __SMLALD(voltages, voltages, vSquareSum);
+		cSquareSum        = __SMLALD(currents, currents, cSquareSum);
+		vcSum             = __SMLALD(voltages, currents, vcSum);
+		vSum              = __SMLAD(voltages, ones, vSum);
+		cSum              = __SMLAD(currents, ones, cSum);
+	}
+#endif
+
+	for (; i < numSamples; ++i) {
+		int32_t voltage = samples[2 * i];
+		int32_t current = samples[2 * i + 1];
+		vSquareSum += voltage * voltage;
+		cSquareSum += current * current;
+		vcSum += voltage * current;
+		vSum += voltage;
+		cSum += current;
+	}
+
+	const int64_t scale = 1024;
+	int64_t zv          = zeroVoltage;
+	int64_t zc          = zeroCurrent;
+	power_kernel_sums_t result;
+	result.voltageSquareSum = (scale * scale * vSquareSum - 2 * scale * zv * vSum + numSamples * zv * zv) / (scale * scale);
+	result.currentSquareSum = (scale * scale * cSquareSum - 2 * scale * zc * cSum + numSamples * zc * zc) / (scale * scale);
+	result.powerSum = (scale * scale * vcSum - scale * zc * vSum - scale * zv * cSum + numSamples * zv * zc) / (scale * scale);
+	return result;
+}
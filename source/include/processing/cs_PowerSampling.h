@@ -12,7 +12,8 @@
 #include <storage/cs_State.h>
 #include <structs/buffer/cs_CircularBuffer.h>
 #include <structs/buffer/cs_AdcBuffer.h>
-#include <third/Median.h>
+#include <structs/buffer/cs_RunningMedianBuffer.h>
+#include <processing/cs_SlidingMedianFilter.h>
 #include <cstdint>
 
 typedef void (*ps_zero_crossing_cb_t) ();
@@ -149,15 +150,11 @@ private:
 	int32_t _avgCurrentRmsMilliAmp; //! Used for storing the average rms current (in mA).
 	int32_t _avgVoltageRmsMilliVolt; //! Used for storing the average rms voltage (in mV).
 
-	PowerVector* _inputSamples;  //! Used for storing the samples to be filtered.
-	PowerVector* _outputSamples; //! Used for storing the filtered samples.
-	MedianFilter* _filterParams;  //! Stores the parameters for the moving median filter.
+	SlidingMedianFilter<adc_sample_value_t, POWER_SAMPLING_CURVE_HALF_WINDOW_SIZE> _medianFilter; //! Moving median filter of the samples.
 
-	CircularBuffer<int32_t>* _powerMilliWattHist;      //! Used to store a history of the power
-	CircularBuffer<int32_t>* _currentRmsMilliAmpHist;  //! Used to store a history of the current_rms
-	CircularBuffer<int32_t>* _filteredCurrentRmsHistMA; //! Used to store a history of the filtered current_rms
-	CircularBuffer<int32_t>* _voltageRmsMilliVoltHist; //! Used to store a history of the voltage_rms
-	int32_t _histCopy[POWER_SAMPLING_RMS_WINDOW_SIZE]; //! Used to copy a history to (so it can be used to calculate the median)
+	RunningMedianBuffer<int32_t, POWER_SAMPLING_RMS_WINDOW_SIZE> _currentRmsMilliAmpHist;   //! Used to store a history of the current_rms
+	RunningMedianBuffer<int32_t, POWER_SAMPLING_RMS_WINDOW_SIZE> _filteredCurrentRmsHistMA; //! Used to store a history of the filtered current_rms
+	RunningMedianBuffer<int32_t, POWER_SAMPLING_RMS_WINDOW_SIZE> _voltageRmsMilliVoltHist;  //! Used to store a history of the voltage_rms
 	uint16_t _consecutiveDimmerOvercurrent = 0;
 	uint16_t _consecutiveOvercurrent = 0;
 
@@ -9,6 +9,7 @@
 
 #include <structs/buffer/cs_CircularBuffer.h>
 #include <structs/buffer/cs_AdcBuffer.h>
+#include <processing/cs_SwitchcraftDetector.h>
 
 class RecognizeSwitch {
 private:
@@ -38,40 +39,14 @@ private:
 	int16_t _lastDetectionSamples[_numStoredBuffers * AdcBuffer::getChannelLength()] = {0};
 	int16_t _lastAlmostDetectionSamples[_numStoredBuffers * AdcBuffer::getChannelLength()] = {0};
 
-	enum FoundSwitch {
-		True,
-		Almost,
-		False
-	};
+	typedef SwitchcraftDetector<AdcBuffer::getChannelLength()> Detector;
 
-	/**
-	 * Check if a switch is detected in the given buffers.
-	 */
-	FoundSwitch detect(const CircularBuffer<adc_buffer_id_t>& bufQueue, adc_channel_id_t voltageChannelId, uint8_t iteration);
+	Detector _detector;
 
 	/**
-	 * Check if a switch is detected in the given buffers.
-	 *
-	 * Different way of calculating, using calcDiff().
-	 * Seems to go slower though.
-	 */
-	FoundSwitch detectSwitch(const CircularBuffer<adc_buffer_id_t>& bufQueue, adc_channel_id_t voltageChannelId);
-
-	/*
-	 * Calculate the difference between 2 buffers.
-	 *
-	 * Start at sample <shift> and iterates over <numSamples> samples.
+	 * Check if all the given buffers are valid, buffers become invalid when they are being overwritten.
 	 */
-	inline float calcDiff(
-			const CircularBuffer<adc_buffer_id_t>& bufQueue,
-			const adc_channel_id_t voltageChannelId,
-			const adc_buffer_id_t bufIndex1,
-			const adc_buffer_id_t bufIndex2,
-			const adc_sample_value_id_t startIndex,
-			const adc_sample_value_id_t numSamples);
-
-	bool ignoreSample(const adc_sample_value_t value1, const adc_sample_value_t value2);
-	bool ignoreSample(const adc_sample_value_t value0, const adc_sample_value_t value1, const adc_sample_value_t value2);
+	bool buffersValid(const adc_buffer_id_t bufIndices[_numBuffersRequired]);
 
 	void setLastDetection(bool aboveThreshold, const CircularBuffer<adc_buffer_id_t>& bufQueue, adc_channel_id_t voltageChannelId);
 
@@ -0,0 +1,57 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+#pragma once
+
+#include <util/cs_SlidingWindowMedian.h>
+
+#include <cstdint>
+
+/**
+ * Streaming median filter with a sliding window of 2 * HalfWindowSize + 1 values: O(log n) per sample.
+ *
+ * The filter keeps its own copy of the window, so it can filter in place.
+ */
+template <class T, uint16_t HalfWindowSize>
+class SlidingMedianFilter {
+public:
+	static constexpr uint16_t WINDOW_SIZE = SlidingWindowMedian<T, HalfWindowSize>::WINDOW_SIZE;
+
+	/**
+	 * Median filter a sequence of values.
+	 *
+	 * Output value N is the median of input values N - HalfWindowSize up to N + HalfWindowSize.
+	 * Before the start, the first input value is used, and after the end, the last input value.
+	 * These are the same results as sort_median() with a padded input.
+	 *
+	 * @param[in]  input          First input value.
+	 * @param[out] output         First output value, may be the same as input.
+	 * @param[in]  count          Number of values.
+	 * @param[in]  stride         Distance between consecutive values, for interleaved buffers.
+	 */
+	void run(const T* input, T* output, uint16_t count, uint16_t stride = 1) {
+		if (count == 0) {
+			return;
+		}
+		_window.reset(input[0]);
+		T last = input[(count - 1) * stride];
+
+		// Fill the window with the values after the first.
+		for (uint16_t i = 1; i <= HalfWindowSize; ++i) {
+			_window.push(i < count ? input[i * stride] : last);
+		}
+
+		// Each output value only depends on input values that were already pushed, so output may overwrite input.
+		for (uint16_t i = 0; i < count; ++i) {
+			output[i * stride] = _window.median();
+			uint32_t next      = i + HalfWindowSize + 1;
+			_window.push(next < count ? input[next * stride] : last);
+		}
+	}
+
+private:
+	SlidingWindowMedian<T, HalfWindowSize> _window;
+};
@@ -0,0 +1,224 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Detects a switch (switchcraft) in 4 consecutive buffers of voltage samples: first, 2 center buffers, and last.
+ *
+ * A switch is found when a center buffer differs from both the first and the last buffer, while the first and
+ * last buffer are similar. The difference between 2 buffers is the sum of squared differences of the samples,
+ * over half buffer windows: for a channel length of 100, samples 0-49, 25-74, and 50-99.
+ *
+ * The squared differences are calculated once per sample, in fixed point, and summed into prefix sums.
+ * The window sums are the difference of 2 prefix sums. The first vs last sums are shared by both center buffers.
+ *
+ * @param ChannelLength       Number of samples per buffer.
+ */
+template <uint16_t ChannelLength>
+class SwitchcraftDetector {
+public:
+	static constexpr uint16_t CHECK_LENGTH = ChannelLength / 2;
+	static constexpr uint16_t SHIFT        = CHECK_LENGTH / 2;
+	static constexpr uint8_t NUM_WINDOWS   = (ChannelLength - 1) / SHIFT;
+	static constexpr uint8_t NUM_BUFFERS   = 4;
+
+	static_assert(SHIFT > 0, "Channel too short.");
+	static_assert((NUM_WINDOWS - 1) * SHIFT + CHECK_LENGTH <= ChannelLength, "Windows don't fit in the channel.");
+	static_assert((uint64_t)ChannelLength * 4095 * 4095 <= UINT32_MAX, "Sums don't fit in 32 bit.");
+
+	/**
+	 * Observed: sometimes, or often, the builtin one 1B10 measures value 2047 around the top of the curve.
+	 * This triggers a false positive when the width of this block changes, so these samples are ignored.
+	 */
+	static constexpr int16_t CLIPPED_VALUE = 2047;
+
+	enum FoundSwitch { True, Almost, False };
+
+	struct thresholds_t {
+		//! Threshold above which buffers are considered to be different.
+		float different;
+		//! Threshold below which buffers are considered to be similar.
+		float similar;
+		//! Alternative to similar: ratio of the center difference to the first vs last difference.
+		float ratio;
+	};
+
+	/**
+	 * Summed squared differences of a window.
+	 */
+	struct window_sums_t {
+		uint32_t centerFirst;
+		uint32_t centerLast;
+		uint32_t firstLast;
+	};
+
+	SwitchcraftDetector() {
+		// Merge the sorted window starts and ends into sorted boundaries.
+		uint8_t numBoundaries = 0;
+		uint8_t start         = 0;
+		uint8_t end           = 0;
+		while (end < NUM_WINDOWS) {
+			uint16_t startIndex = start < NUM_WINDOWS ? start * SHIFT : ChannelLength + 1;
+			uint16_t endIndex   = end * SHIFT + CHECK_LENGTH;
+			uint16_t boundary   = startIndex < endIndex ? startIndex : endIndex;
+			if (numBoundaries == 0 || _boundaries[numBoundaries - 1] != boundary) {
+				_boundaries[numBoundaries++] = boundary;
+			}
+			if (startIndex == boundary) {
+				_startBoundary[start++] = numBoundaries - 1;
+			}
+			if (endIndex == boundary) {
+				_endBoundary[end++] = numBoundaries - 1;
+			}
+		}
+		_numBoundaries = numBoundaries;
+	}
+
+	/**
+	 * Check if a switch is detected in the given buffers.
+	 *
+	 * @param[in] buffers         First sample of the first, center, center, and last buffer.
+	 * @param[in] stride          Distance between consecutive samples, for interleaved buffers.
+	 * @param[in] thresholds      Thresholds to use.
+	 * @return                    True when a switch was detected for either center buffer,
+	 *                            else Almost when it was almost detected, else False.
+	 */
+	FoundSwitch detect(const int16_t* const buffers[NUM_BUFFERS], uint16_t stride, const thresholds_t& thresholds) {
+		const int16_t* first = buffers[0];
+		const int16_t* last  = buffers[NUM_BUFFERS - 1];
+		calculateFirstLastSums(first, last, stride);
+
+		FoundSwitch found = False;
+		for (uint8_t i = 1; i < NUM_BUFFERS - 1; ++i) {
+			calculateCenterSums(first, buffers[i], last, stride);
+			FoundSwitch centerFound = check(thresholds);
+			if (centerFound == True) {
+				return True;
+			}
+			if (centerFound == Almost) {
+				found = Almost;
+			}
+		}
+		return found;
+	}
+
+	/**
+	 * Sums of each window, of the last checked center buffer.
+	 */
+	window_sums_t getSums(uint8_t window) const {
+		window_sums_t sums;
+		sums.centerFirst = windowSum(_centerFirstPrefix, window);
+		sums.centerLast  = windowSum(_centerLastPrefix, window);
+		sums.firstLast   = windowSum(_firstLastPrefix, window) - windowSum(_firstLastCorrectionPrefix, window);
+		return sums;
+	}
+
+	static bool ignoreSample(int16_t value) { return value == CLIPPED_VALUE; }
+
+private:
+	static constexpr uint8_t MAX_BOUNDARIES = 2 * NUM_WINDOWS;
+
+	/**
+	 * Sample indices at which a window starts or ends, sorted.
+	 */
+	uint16_t _boundaries[MAX_BOUNDARIES];
+	uint8_t _numBoundaries;
+
+	/**
+	 * For each window: index in _boundaries of its start and end.
+	 */
+	uint8_t _startBoundary[NUM_WINDOWS];
+	uint8_t _endBoundary[NUM_WINDOWS];
+
+	/**
+	 * Prefix sums at each boundary.
+	 *
+	 * A sample is ignored when it is clipped in any of the 3 compared buffers. So the first vs last sums
+	 * ignore the samples clipped in first or last, and the correction holds the samples clipped in the center only.
+	 */
+	uint32_t _firstLastPrefix[MAX_BOUNDARIES];
+	uint32_t _firstLastCorrectionPrefix[MAX_BOUNDARIES];
+	uint32_t _centerFirstPrefix[MAX_BOUNDARIES];
+	uint32_t _centerLastPrefix[MAX_BOUNDARIES];
+
+	uint32_t windowSum(const uint32_t* prefix, uint8_t window) const {
+		return prefix[_endBoundary[window]] - prefix[_startBoundary[window]];
+	}
+
+	/**
+	 * Squared difference, or 0 when the sample should be ignored.
+	 */
+	static uint32_t squaredDiff(int32_t value1, int32_t value2, bool ignore) {
+		int32_t diff = value1 - value2;
+		return ignore ? 0 : diff * diff;
+	}
+
+	void calculateFirstLastSums(const int16_t* first, const int16_t* last, uint16_t stride) {
+		uint32_t sum        = 0;
+		_firstLastPrefix[0] = 0;
+		for (uint8_t b = 1; b < _numBoundaries; ++b) {
+			for (uint16_t i = _boundaries[b - 1]; i < _boundaries[b]; ++i) {
+				int16_t valueFirst = first[i * stride];
+				int16_t valueLast  = last[i * stride];
+				sum += squaredDiff(valueFirst, valueLast, ignoreSample(valueFirst) || ignoreSample(valueLast));
+			}
+			_firstLastPrefix[b] = sum;
+		}
+	}
+
+	void calculateCenterSums(const int16_t* first, const int16_t* center, const int16_t* last, uint16_t stride) {
+		uint32_t sumCenterFirst       = 0;
+		uint32_t sumCenterLast        = 0;
+		uint32_t correction           = 0;
+		_centerFirstPrefix[0]         = 0;
+		_centerLastPrefix[0]          = 0;
+		_firstLastCorrectionPrefix[0] = 0;
+		for (uint8_t b = 1; b < _numBoundaries; ++b) {
+			for (uint16_t i = _boundaries[b - 1]; i < _boundaries[b]; ++i) {
+				int16_t valueFirst  = first[i * stride];
+				int16_t valueCenter = center[i * stride];
+				int16_t valueLast   = last[i * stride];
+				bool ignoreOuter    = ignoreSample(valueFirst) || ignoreSample(valueLast);
+				bool ignore         = ignoreOuter || ignoreSample(valueCenter);
+				sumCenterFirst += squaredDiff(valueFirst, valueCenter, ignore);
+				sumCenterLast += squaredDiff(valueCenter, valueLast, ignore);
+				// Rare: only clipped in the center, so it should be removed from the first vs last sums.
+				if (ignore && !ignoreOuter) {
+					correction += squaredDiff(valueFirst, valueLast, false);
+				}
+			}
+			_centerFirstPrefix[b]         = sumCenterFirst;
+			_centerLastPrefix[b]          = sumCenterLast;
+			_firstLastCorrectionPrefix[b] = correction;
+		}
+	}
+
+	FoundSwitch check(const thresholds_t& thresholds) const {
+		float lowerThreshold = 0.1 * thresholds.different;
+		bool foundAlmost     = false;
+		for (uint8_t window = 0; window < NUM_WINDOWS; ++window) {
+			window_sums_t sums = getSums(window);
+			float centerFirst  = sums.centerFirst;
+			float centerLast   = sums.centerLast;
+			float firstLast    = sums.firstLast;
+			if (centerFirst > thresholds.different && centerLast > thresholds.different) {
+				float minDiff = centerFirst < centerLast ? centerFirst : centerLast;
+				if (firstLast < thresholds.similar || minDiff / firstLast > thresholds.ratio) {
+					return True;
+				}
+			}
+
+			// Check if it was almost recognized as switch.
+			if (centerFirst > lowerThreshold && centerLast > lowerThreshold && firstLast < thresholds.similar) {
+				foundAlmost = true;
+			}
+		}
+		return foundAlmost ? Almost : False;
+	}
+};
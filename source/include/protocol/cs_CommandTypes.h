@@ -65,6 +65,7 @@ enum CommandHandlerTypes {
 	CTRL_CMD_GET_GPREGRET                = 86,
 	CTRL_CMD_GET_ADC_CHANNEL_SWAPS       = 87,
 	CTRL_CMD_GET_RAM_STATS               = 88,
+	CTRL_CMD_GET_BOOT_TIMINGS            = 89,
 
 	CTRL_CMD_MICROAPP_GET_INFO           = 90,
 	CTRL_CMD_MICROAPP_UPLOAD             = 91,
@@ -31,6 +31,15 @@ struct __attribute__((__packed__)) cuckoo_compressed_fingerprint_t {
 	cuckoo_index_t bucket;  // the bucket this fingerprint should be put in
 };
 
+/**
+ * Hashes of a key, before they are reduced to the bucket count of a filter.
+ * Can be used to check the same key against multiple filters.
+ */
+struct __attribute__((__packed__)) cuckoo_key_hash_t {
+	cuckoo_fingerprint_t fingerprint;
+	cuckoo_fingerprint_t bucketHash;  // untruncated bucket index
+};
+
 
 
 /**
@@ -534,6 +534,20 @@ struct __attribute__((packed)) cs_ram_stats_t {
 	uint32_t numSbrkFails = 0;
 };
 
+/**
+ * Duration of the boot phases, in µs.
+ *
+ * Measured with the RTC, so they have a resolution of about 31 µs, and start when the SoftDevice is enabled.
+ */
+struct __attribute__((packed)) cs_boot_timings_t {
+	uint32_t storageInit = 0;  // Until storage is initialized.
+	uint32_t stateLoad = 0;    // Loading all stored state values.
+	uint32_t driversInit = 0;  // Initializing the drivers, after the state has been loaded.
+	uint32_t configure = 0;    // Configuring, setting the operation mode, and initializing the services.
+	uint32_t switchReady = 0;  // From the start of storage init, until the switch is powered.
+	uint16_t stateRecords = 0; // Number of stored state values that were loaded.
+};
+
 struct __attribute__((packed)) cs_twi_init_t {
 	uint8_t scl;
 	uint8_t sda;
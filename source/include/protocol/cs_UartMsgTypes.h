@@ -8,6 +8,7 @@
 #pragma once
 
 #include <cfg/cs_Config.h>
+#include <mesh/cs_MeshQueue.h>
 #include <protocol/cs_Packets.h>
 #include <structs/cs_PacketsInternal.h>
 
@@ -64,6 +65,23 @@ struct __attribute__((__packed__)) uart_msg_session_nonce_reply_t {
 	uint8_t sessionNonce[SESSION_NONCE_LENGTH];
 };
 
+struct __attribute__((__packed__)) uart_msg_stats_t {
+	uint32_t rxFrames;         // Number of frames that have been read.
+	uint32_t rxOverflows;      // Number of frames that were dropped, because all RX frame slots were in use.
+	uint32_t rxDiscarded;      // Number of frames that were discarded, because they were malformed or incomplete.
+	uint32_t txDroppedBytes;   // Number of bytes that were dropped, because the TX buffer was full.
+};
+
+struct __attribute__((__packed__)) uart_msg_log_level_t {
+	uint8_t module;            // LogModule, or LOG_MODULE_ALL.
+	uint8_t level;             // Most verbose log level to log, like SERIAL_DEBUG.
+};
+
+struct __attribute__((__packed__)) uart_msg_mesh_queue_stats_t {
+	uint8_t modelId;           // Mesh model: 0 multicast, 1 multicast acked, 2 unicast, 3 multicast neighbours.
+	cs_mesh_queue_stats_t stats;
+};
+
 struct __attribute__((__packed__)) uart_msg_hub_data_reply_header_t {
 	cs_ret_code_t retCode;
 	// Followed by data
@@ -102,6 +120,10 @@ enum ElementType {
 	ELEMENT_TYPE_FROM_FORMAT = 10,
 };
 
+struct __attribute__((__packed__)) uart_msg_log_recovered_t {
+	uint16_t numLogs; // Number of logs that follow, which were written before the reset.
+};
+
 struct __attribute__((__packed__)) uart_msg_log_array_header_t {
 	uart_msg_log_common_header_t header;
 	uint8_t elementType; // ElementType
@@ -18,6 +18,7 @@ enum UartOpcodeRx {
 	UART_OPCODE_RX_HEARTBEAT =                        2,
 	UART_OPCODE_RX_STATUS =                           3,
 	UART_OPCODE_RX_GET_MAC =                          4, // Get MAC address of this Crownstone
+	UART_OPCODE_RX_GET_STATS =                        5, // Get UART statistics
 	UART_OPCODE_RX_CONTROL =                          10,
 	UART_OPCODE_RX_HUB_DATA_REPLY =                   11, // Payload starts with uart_msg_hub_data_reply_header_t.
 
@@ -25,6 +26,8 @@ enum UartOpcodeRx {
 	UART_OPCODE_RX_ENABLE_ADVERTISEMENT =             50000, // Enable advertising (payload: bool enable)
 	UART_OPCODE_RX_ENABLE_MESH =                      50001, // Enable mesh (payload: bool enable)
 	UART_OPCODE_RX_GET_ID =                           50002, // Get ID of this Crownstone
+	UART_OPCODE_RX_SET_LOG_LEVEL =                    50003, // Set the runtime log level of a log module (payload: uart_msg_log_level_t)
+	UART_OPCODE_RX_GET_MESH_STATS =                   50004, // Get mesh statistics
 
 //	UART_OPCODE_RX_ADC_CONFIG_GET =                   50100, // Get the adc config
 //	UART_OPCODE_RX_ADC_CONFIG_SET =                   50101, // Set an adc channel config (payload: uart_msg_adc_channel_config_t)
@@ -57,6 +60,7 @@ enum UartOpcodeTx {
 	UART_OPCODE_TX_HEARTBEAT =                        2,
 	UART_OPCODE_TX_STATUS =                           3,
 	UART_OPCODE_TX_MAC =                              4,  // MAC address (payload: mac address (6B))
+	UART_OPCODE_TX_STATS =                            5,  // UART statistics (payload: uart_msg_stats_t)
 	UART_OPCODE_TX_CONTROL_RESULT =                   10, // The result of the control command, payload: result_packet_header_t + data.
 	UART_OPCODE_TX_HUB_DATA_REPLY_ACK =               11,
 
@@ -90,6 +94,7 @@ enum UartOpcodeTx {
 
 	UART_OPCODE_TX_LOG =                              10200, // Debug logs, payload is in the form: [uart_msg_log_header_t, [uart_msg_log_arg_header_t, data], [uart_msg_log_arg_header_t, data], ...]
 	UART_OPCODE_TX_LOG_ARRAY =                        10201, // Debug logs, payload is in the form: [uart_msg_log_header_t, [uart_msg_log_arg_header_t, data], [uart_msg_log_arg_header_t, data], ...]
+	UART_OPCODE_TX_LOG_RECOVERED =                    10202, // Sent before the debug logs from before the reset, payload: uart_msg_log_recovered_t
 
 
 	////////// Developer messages in release builds. //////////
@@ -109,6 +114,10 @@ enum UartOpcodeTx {
 	UART_OPCODE_TX_ADVERTISEMENT_ENABLED =            50000, // Whether advertising is enabled (payload: bool)
 	UART_OPCODE_TX_MESH_ENABLED =                     50001, // Whether mesh is enabled (payload: bool)
 	UART_OPCODE_TX_OWN_ID =                           50002, // Own id (payload: crownstone_id_t)
+	UART_OPCODE_TX_LOG_LEVELS =                       50003, // Runtime log level of each log module (payload: uint8_t[])
+	UART_OPCODE_TX_MESH_BURST_STATS =                 50004, // Statistics of the mesh burst scheduler (payload: cs_mesh_burst_stats_t)
+	UART_OPCODE_TX_MESH_QUEUE_STATS =                 50005, // Statistics of the queue of a mesh model (payload: uart_msg_mesh_queue_stats_t)
+	UART_OPCODE_TX_MESH_SCANNER_STATS =               50006, // Statistics of the ring of scanned devices of the mesh scanner (payload: cs_scanned_device_ring_stats_t)
 
 	UART_OPCODE_TX_ADC_CONFIG =                       50100, // Current adc config (payload: adc_config_t)
 	UART_OPCODE_TX_ADC_RESTART =                      50101,
@@ -147,6 +156,7 @@ constexpr bool mustBeEncryptedRx(UartOpcodeRx opCode) {
 		case UartOpcodeRx::UART_OPCODE_RX_HEARTBEAT: // optional
 		case UartOpcodeRx::UART_OPCODE_RX_STATUS: // optional
 		case UartOpcodeRx::UART_OPCODE_RX_GET_MAC:
+		case UartOpcodeRx::UART_OPCODE_RX_GET_STATS:
 		case UartOpcodeRx::UART_OPCODE_RX_HUB_DATA_REPLY: // optional
 			return false;
 		default:
@@ -168,6 +178,7 @@ constexpr bool mustBeEncryptedTx(UartOpcodeTx opCode) {
 		case UartOpcodeTx::UART_OPCODE_TX_SESSION_NONCE:
 		case UartOpcodeTx::UART_OPCODE_TX_STATUS:
 		case UartOpcodeTx::UART_OPCODE_TX_MAC:
+		case UartOpcodeTx::UART_OPCODE_TX_STATS:
 		case UartOpcodeTx::UART_OPCODE_TX_ERR_REPLY_PARSING_FAILED:
 		case UartOpcodeTx::UART_OPCODE_TX_ERR_REPLY_STATUS:
 		case UartOpcodeTx::UART_OPCODE_TX_ERR_REPLY_SESSION_NONCE_MISSING:
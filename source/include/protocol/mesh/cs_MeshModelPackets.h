@@ -214,7 +214,8 @@ struct __attribute__((__packed__)) cs_mesh_model_msg_asset_report_id_t {
 	asset_id_t id;
 	uint8_t filterBitmask;
 	int8_t rssi; // TODO: why not the full rssi here, and put the channel in the reserved bytes?
-	union {
+	uint8_t padding = 0; // The union below used to be aligned, this keeps the size the same on the mesh.
+	union __attribute__((__packed__)) {
 		struct {
 			uint16_t channel : 2;
 			uint16_t reserved : 14; // Must be 0 for now.
@@ -13,6 +13,8 @@
 #include <drivers/cs_Timer.h>
 #include <events/cs_EventListener.h>
 #include <protocol/cs_ErrorCodes.h>
+#include <storage/cs_StateRamIndex.h>
+#include <storage/cs_StateStoreQueue.h>
 #include <vector>
 
 constexpr const char* operationModeName(OperationMode const & mode) {
@@ -54,41 +56,10 @@ constexpr OperationMode getOperationMode(uint8_t mode) {
 	return OperationMode::OPERATION_MODE_UNINITIALIZED;
 }
 
-enum class StateQueueMode {
-	DELAY,
-	THROTTLE
-};
-
 #define FACTORY_RESET_STATE_NORMAL 0
 #define FACTORY_RESET_STATE_LOWTX  1
 #define FACTORY_RESET_STATE_RESET  2
 
-enum StateQueueOp {
-	CS_STATE_QUEUE_OP_WRITE,
-	CS_STATE_QUEUE_OP_REM_ONE_ID_OF_TYPE,
-	CS_STATE_QUEUE_OP_FACTORY_RESET,
-	CS_STATE_QUEUE_OP_GC,
-};
-
-/**
- * Struct for queuing operations.
- *
- * operation:      Type of operation to perform.
- * type:           State type
- * id:             State id
- * counter:        Number of ticks until item is executed and removed from queue.
- * init_counter:   When set, and execute is true, this item is added again with counter set to this value.
- * execute:        Whether or not to execute the operation when the counter reaches 0.
- */
-struct __attribute__((__packed__)) cs_state_store_queue_t {
-	StateQueueOp operation;
-	CS_TYPE type;
-	cs_state_id_t id;
-	uint32_t counter; // Uint32, so it can fit 24h.
-	uint32_t init_counter;
-	bool execute;
-};
-
 const uint32_t CS_STATE_QUEUE_DELAY_SECONDS_MAX = 0xFFFFFFFF / 1000;
 
 struct cs_id_list_t {
@@ -322,11 +293,23 @@ public:
 	 */
 	void startWritesToFlash();
 
+	/**
+	 * Number of stored values that were loaded from flash by init().
+	 */
+	uint16_t getNumLoadedValues() {
+		return _numLoadedValues;
+	}
+
 	/**
 	 * Internal usage
 	 */
 	void handleStorageError(cs_storage_operation_t operation, CS_TYPE type, cs_state_id_t id);
 
+	/**
+	 * Internal usage: called for each stored value, when loading all values from flash.
+	 */
+	void handleStoredValue(const cs_state_data_t & data);
+
 	/**
 	 * Handle (crownstone) events.
 	 */
@@ -349,6 +332,15 @@ protected:
 	 */
 	cs_ret_code_t findInRam(const CS_TYPE & type, cs_state_id_t id, size16_t & index_in_ram);
 
+	/**
+	 * Load all stored values from flash to ram, and all their ids to the ids cache, in a single pass over flash.
+	 *
+	 * After this, values and ids that are not in ram, are not in flash either.
+	 *
+	 * @return                    Return code.
+	 */
+	cs_ret_code_t loadAllFromFlash();
+
 	/**
 	 * Stores state variable in ram.
 	 *
@@ -455,17 +447,34 @@ protected:
 	std::vector<cs_state_data_t> _ram_data_register;
 
 	/**
-	 * Stores list of existing ids for certain types.
+	 * Maps type and id to the index in _ram_data_register.
+	 */
+	StateRamIndex _ramIndex;
+
+	/**
+	 * Stores list of existing ids for certain types, sorted by type.
 	 */
 	std::vector<cs_id_list_t> _idsCache;
 
 	/**
-	 * Stores the queue of flash operations.
+	 * Get the ids cache entry of given type, or the position where it should be inserted.
+	 */
+	std::vector<cs_id_list_t>::iterator findInIdsCache(const CS_TYPE & type);
+
+	/**
+	 * Stores the queue of flash operations, ordered by when they are due.
 	 */
-	std::vector<cs_state_store_queue_t> _store_queue;
+	StateStoreQueue _storeQueue;
 
 	bool _startedWritingToFlash = false;
 
+	/**
+	 * Whether all stored values and ids have been loaded by loadAllFromFlash().
+	 */
+	bool _loadedAllFromFlash = false;
+
+	uint16_t _numLoadedValues = 0;
+
 	bool _performingFactoryReset = false;
 
 private:
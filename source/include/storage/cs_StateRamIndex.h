@@ -0,0 +1,89 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <protocol/cs_Typedefs.h>
+
+/**
+ * Index of the RAM register of State: maps (type, id) to the index in the register.
+ *
+ * Open addressing hash table with linear probing, stored in a single array that grows when the load gets too high.
+ * Removal uses backward shift deletion, so there are no tombstones, and lookups stay short after many removals.
+ *
+ * The type is stored as its underlying integer, so that this class does not depend on CS_TYPE.
+ */
+class StateRamIndex {
+public:
+	static const uint16_t NOT_FOUND = 0xFFFF;
+
+	StateRamIndex() {}
+	~StateRamIndex();
+
+	StateRamIndex(StateRamIndex const&) = delete;
+	void operator=(StateRamIndex const&) = delete;
+
+	/**
+	 * Get the register index of given type and id.
+	 *
+	 * @return                    Index, or NOT_FOUND.
+	 */
+	uint16_t find(uint16_t type, cs_state_id_t id) const;
+
+	/**
+	 * Add or overwrite the register index of given type and id.
+	 *
+	 * @return                    False when memory could not be allocated.
+	 */
+	bool set(uint16_t type, cs_state_id_t id, uint16_t index);
+
+	/**
+	 * Remove given type and id from the index.
+	 */
+	void remove(uint16_t type, cs_state_id_t id);
+
+	/**
+	 * Remove all entries.
+	 */
+	void clear();
+
+	uint16_t size() const {
+		return _count;
+	}
+
+protected:
+	struct __attribute__((__packed__)) slot_t {
+		uint16_t type;
+		uint16_t index;
+		cs_state_id_t id;
+		bool used;
+	};
+
+	static const uint16_t INITIAL_CAPACITY = 32;
+
+	//! Array of slots, capacity is always a power of 2.
+	slot_t* _slots = nullptr;
+	uint16_t _capacity = 0;
+	uint16_t _count = 0;
+
+	uint16_t hash(uint16_t type, cs_state_id_t id) const {
+		uint32_t key = (static_cast<uint32_t>(type) << 8) | id;
+		// Fibonacci hashing: take the high bits of the product.
+		return static_cast<uint16_t>((key * 2654435769u) >> 16) & (_capacity - 1);
+	}
+
+	/**
+	 * Get slot of given type and id, or the empty slot where it should be placed.
+	 */
+	uint16_t probe(uint16_t type, cs_state_id_t id) const;
+
+	/**
+	 * Allocate a new array of slots, and move all entries.
+	 */
+	bool resize(uint16_t capacity);
+};
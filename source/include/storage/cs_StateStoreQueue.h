@@ -0,0 +1,184 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <protocol/cs_Typedefs.h>
+#include <storage/cs_StateRamIndex.h>
+#include <vector>
+
+enum class StateQueueMode {
+	DELAY,
+	THROTTLE
+};
+
+enum StateQueueOp {
+	CS_STATE_QUEUE_OP_WRITE,
+	CS_STATE_QUEUE_OP_REM_ONE_ID_OF_TYPE,
+	CS_STATE_QUEUE_OP_FACTORY_RESET,
+	CS_STATE_QUEUE_OP_GC,
+};
+
+/**
+ * Struct for queuing operations.
+ *
+ * operation:      Type of operation to perform.
+ * type:           State type, as underlying integer of CS_TYPE.
+ * id:             State id
+ * dueTickCount:   Tick count at which the item is executed.
+ * init_counter:   When set, and execute is true, this item is added again with counter set to this value.
+ * sequence:       Order in which items were added, items that are due at the same tick are executed in this order.
+ * heapIndex:      Position of this item in the heap.
+ * execute:        Whether or not to execute the operation when the item is due.
+ */
+struct __attribute__((__packed__)) cs_state_store_queue_t {
+	StateQueueOp operation;
+	uint16_t type;
+	cs_state_id_t id;
+	uint32_t dueTickCount;
+	uint32_t init_counter; // Uint32, so it can fit 24h.
+	uint32_t sequence;
+	uint16_t heapIndex;
+	bool execute;
+};
+
+/**
+ * Queue of flash operations of State, ordered by the tick count at which they are due.
+ *
+ * Items are kept in a min-heap of due tick count, so that a tick without due items only has to look at the first item.
+ * Write and remove items are also kept in an index by type and id, so that adding an item for the same type and id
+ * updates the queued item instead.
+ *
+ * Delays are given as counter: the number of ticks to wait, after which the item is due at the next tick. This
+ * matches a counter that is decremented every tick, and executed at the tick it is 0.
+ *
+ * Items are referred to by handle. Handles stay valid until that item, or another item, is removed.
+ */
+class StateStoreQueue {
+public:
+	static const uint16_t NONE = 0xFFFF;
+
+	/**
+	 * @param[in] retryCounter    Counter to use when an operation has to be retried.
+	 */
+	explicit StateStoreQueue(uint32_t retryCounter) : _retryCounter(retryCounter) {}
+
+	StateStoreQueue(StateStoreQueue const&) = delete;
+	void operator=(StateStoreQueue const&) = delete;
+
+	/**
+	 * Update the queued write or remove item of given type and id.
+	 *
+	 * DELAY mode sets the counter, THROTTLE mode sets the init counter. In both cases, the item will be executed.
+	 *
+	 * @return                    True when such an item was queued, false when it has to be added instead.
+	 */
+	bool update(uint16_t type, cs_state_id_t id, uint32_t counter, StateQueueMode mode);
+
+	/**
+	 * Add an item.
+	 *
+	 * Write and remove items should only be added when update() returned false.
+	 *
+	 * @param[in] counter         Number of ticks to wait.
+	 * @param[in] execute         Whether to execute the operation when due.
+	 * @return                    Handle of the item, or NONE when memory could not be allocated.
+	 */
+	uint16_t add(StateQueueOp operation, uint16_t type, cs_state_id_t id, uint32_t counter, bool execute);
+
+	/**
+	 * Advance the tick count by one tick.
+	 */
+	void tick();
+
+	/**
+	 * Get the first item that is due at the current tick count.
+	 *
+	 * Each due item should be passed to done(), after which it's no longer due at the current tick count.
+	 *
+	 * @return                    Handle of the item, or NONE when no item is due.
+	 */
+	uint16_t getDue() const;
+
+	/**
+	 * Finish a due item, after its operation has been executed (or not, when execute is false).
+	 *
+	 * When the init counter is set and the item was executed, it's kept for that many ticks, without executing it.
+	 * Else, when retry is set, it's kept for the retry counter, else it's removed.
+	 *
+	 * @param[in] handle          The due item.
+	 * @param[in] retry           Whether the operation should be retried, for example when storage was busy.
+	 */
+	void done(uint16_t handle, bool retry);
+
+	cs_state_store_queue_t& get(uint16_t handle) {
+		return _items[handle];
+	}
+
+	/**
+	 * Remove all items.
+	 */
+	void clear();
+
+	uint16_t size() const {
+		return _items.size();
+	}
+
+	bool empty() const {
+		return _items.empty();
+	}
+
+protected:
+	//! Items, in no particular order.
+	std::vector<cs_state_store_queue_t> _items;
+
+	//! Min-heap of handles, ordered by due tick count and sequence.
+	std::vector<uint16_t> _heap;
+
+	//! Maps type and id of write and remove items to their handle.
+	StateRamIndex _index;
+
+	uint32_t _retryCounter;
+
+	uint32_t _tickCount = 0;
+
+	uint32_t _sequence = 0;
+
+	static bool isIndexed(StateQueueOp operation) {
+		return operation == CS_STATE_QUEUE_OP_WRITE || operation == CS_STATE_QUEUE_OP_REM_ONE_ID_OF_TYPE;
+	}
+
+	/**
+	 * Whether item a should be executed before item b, taking roll over into account.
+	 */
+	bool isBefore(uint16_t a, uint16_t b) const {
+		int32_t diff = static_cast<int32_t>(_items[a].dueTickCount - _items[b].dueTickCount);
+		if (diff != 0) {
+			return diff < 0;
+		}
+		return static_cast<int32_t>(_items[a].sequence - _items[b].sequence) < 0;
+	}
+
+	/**
+	 * Set the due tick count of an item, and move it to its place in the heap.
+	 */
+	void reschedule(uint16_t handle, uint32_t counter);
+
+	/**
+	 * Remove an item: the last item takes its handle.
+	 */
+	void remove(uint16_t handle);
+
+	void setHeap(uint16_t heapIndex, uint16_t handle) {
+		_heap[heapIndex]         = handle;
+		_items[handle].heapIndex = heapIndex;
+	}
+
+	void siftUp(uint16_t heapIndex);
+	void siftDown(uint16_t heapIndex);
+};
@@ -0,0 +1,96 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+#pragma once
+
+#include <util/cs_SlidingWindowMedian.h>
+
+#include <cstdint>
+
+/**
+ * History of the last Size values, that keeps track of its median while values are pushed.
+ *
+ * Like a CircularBuffer, the oldest value is overwritten once the buffer is full.
+ * Each push costs O(log Size), instead of copying the history and running a median network over it.
+ * While the buffer is not full yet, a running sum is kept, so that the average can be used instead.
+ *
+ * @param T         Element type, should fit in an int64_t.
+ * @param Size      Number of values in the history, should be odd.
+ */
+template <class T, uint16_t Size>
+class RunningMedianBuffer {
+public:
+	static_assert(Size % 2 == 1, "Size should be odd, so that the median is a single value.");
+
+	RunningMedianBuffer() { clear(); }
+
+	/**
+	 * Remove all values.
+	 */
+	void clear() {
+		_window.reset(T());
+		_size = 0;
+		_sum  = 0;
+	}
+
+	/**
+	 * Add a value, overwrites the oldest value when full.
+	 */
+	void push(T value) {
+		// The window always holds Size values, the ones that were not pushed yet are simply pushed out first.
+		_window.push(value);
+		if (_size < Size) {
+			_sum += value;
+			++_size;
+		}
+	}
+
+	uint16_t size() const { return _size; }
+
+	uint16_t capacity() const { return Size; }
+
+	bool empty() const { return _size == 0; }
+
+	bool full() const { return _size == Size; }
+
+	/**
+	 * Get a value, index 0 is the oldest value.
+	 */
+	T operator[](uint16_t index) const { return _window[Size - _size + index]; }
+
+	/**
+	 * Median of all values, only valid when full.
+	 */
+	T median() const { return _window.median(); }
+
+	/**
+	 * Median when full, else the average of the values.
+	 *
+	 * The average is rounded toward zero. Returns 0 when empty.
+	 */
+	T medianOrAverage() const {
+		if (full()) {
+			return median();
+		}
+		if (empty()) {
+			return T();
+		}
+		return _sum / _size;
+	}
+
+private:
+	SlidingWindowMedian<T, Size / 2> _window;
+
+	/**
+	 * Number of pushed values, up to Size.
+	 */
+	uint16_t _size;
+
+	/**
+	 * Sum of the pushed values, only kept up to date until full.
+	 */
+	int64_t _sum;
+};
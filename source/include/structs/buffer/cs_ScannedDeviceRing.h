@@ -0,0 +1,198 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+#pragma once
+
+#include <structs/cs_PacketsInternal.h>
+
+#include <cstdint>
+#include <cstring>
+
+/**
+ * Statistics of the scanned device ring.
+ */
+struct __attribute__((packed)) cs_scanned_device_ring_stats_t {
+	uint32_t numScans     = 0; // Number of scans pushed, including the coalesced and dropped ones.
+	uint32_t numCoalesced = 0; // Number of scans combined with a scan that was already in the ring.
+	uint32_t numDropped   = 0; // Number of scans dropped, because the ring was full.
+	uint8_t highWatermark = 0; // Max number of entries that have been in the ring at once.
+};
+
+/**
+ * Ring of scanned devices, with a copy of their data.
+ *
+ * The scan handler pushes scanned devices, the main loop takes them out in batches, so that the scan handler
+ * doesn't have to evaluate each scan right away.
+ *
+ * Scans of the same device, with the same data, can be coalesced: when such a scan is still in the ring, the new
+ * scan is combined with it. The combined scan gets the max RSSI, and the channel of that RSSI, and keeps the average
+ * RSSI and the number of scans. A burst of scans of one beacon then costs only one evaluation.
+ *
+ * Not thread safe: push and pop from the same context.
+ *
+ * @tparam Capacity    Max number of scanned devices in the ring.
+ */
+template <uint8_t Capacity>
+class ScannedDeviceRing {
+public:
+	static_assert(Capacity > 0 && Capacity < 255, "Invalid capacity");
+
+	/**
+	 * Max size of the data of a scanned device: a legacy advertisement.
+	 */
+	static constexpr uint8_t MAX_DATA_SIZE = 31;
+
+	/**
+	 * Add a scanned device, copies the data.
+	 *
+	 * @param[in] device          The scanned device.
+	 * @param[in] now             Current time.
+	 * @param[in] coalesceWindow  Combine with a scan of the same device and data, that was first scanned at most
+	 *                            this long ago. 0 to disable.
+	 * @return                    False when the scan is dropped.
+	 */
+	bool push(const scanned_device_t& device, uint32_t now, uint32_t coalesceWindow) {
+		_stats.numScans++;
+		uint8_t tag = getTag(device.address);
+		if (coalesceWindow != 0) {
+			// Search from newest to oldest.
+			for (uint8_t i = _count; i > 0; --i) {
+				uint8_t index = (_tail + i - 1) % Capacity;
+				if (_tags[index] != tag) {
+					continue;
+				}
+				cs_scanned_device_entry_t& entry = _entries[index];
+				if (now - entry.firstScanTime > coalesceWindow) {
+					// Older entries are even further out of the window.
+					break;
+				}
+				if (entry.numScans == 0xFF
+						|| memcmp(entry.address, device.address, sizeof(entry.address)) != 0
+						|| entry.dataSize != device.dataSize
+						|| memcmp(entry.data, device.data, device.dataSize) != 0) {
+					continue;
+				}
+				if (device.rssi > entry.rssiMax) {
+					entry.rssiMax = device.rssi;
+					entry.channel = device.channel;
+				}
+				entry.rssiSum += device.rssi;
+				entry.numScans++;
+				_stats.numCoalesced++;
+				return true;
+			}
+		}
+
+		if (_count == Capacity || device.dataSize > MAX_DATA_SIZE) {
+			_stats.numDropped++;
+			return false;
+		}
+		uint8_t index = (_tail + _count) % Capacity;
+		cs_scanned_device_entry_t& entry = _entries[index];
+		memcpy(entry.address, device.address, sizeof(entry.address));
+		entry.resolvedPrivateAddress = device.resolvedPrivateAddress;
+		entry.addressType            = device.addressType;
+		entry.rssiMax                = device.rssi;
+		entry.channel                = device.channel;
+		entry.rssiSum                = device.rssi;
+		entry.numScans               = 1;
+		entry.firstScanTime          = now;
+		entry.dataSize               = device.dataSize;
+		memcpy(entry.data, device.data, device.dataSize);
+		_tags[index] = tag;
+
+		_count++;
+		if (_count > _stats.highWatermark) {
+			_stats.highWatermark = _count;
+		}
+		return true;
+	}
+
+	/**
+	 * Get the oldest scanned device, when it's ready.
+	 *
+	 * The data of the scanned device stays valid until pop() is called.
+	 *
+	 * @param[out] device         The scanned device.
+	 * @param[in] now             Current time.
+	 * @param[in] minAge          Only get a scanned device that was first scanned at least this long ago, so that it
+	 *                            had the chance to be coalesced. Ignored when the ring is at least half full.
+	 * @return                    False when there is no scanned device ready.
+	 */
+	bool front(scanned_device_t& device, uint32_t now, uint32_t minAge) {
+		if (_count == 0) {
+			return false;
+		}
+		cs_scanned_device_entry_t& entry = _entries[_tail];
+		if (now - entry.firstScanTime < minAge && _count < Capacity / 2) {
+			return false;
+		}
+		memcpy(device.address, entry.address, sizeof(device.address));
+		device.resolvedPrivateAddress = entry.resolvedPrivateAddress;
+		device.addressType            = entry.addressType;
+		device.rssi                   = entry.rssiMax;
+		device.channel                = entry.channel;
+		device.numScans               = entry.numScans;
+		device.rssiAverage            = entry.rssiSum / entry.numScans;
+		device.dataSize               = entry.dataSize;
+		device.data                   = entry.data;
+		device.adIndex                = ad_structure_index_t();
+		return true;
+	}
+
+	/**
+	 * Remove the oldest scanned device.
+	 */
+	void pop() {
+		if (_count == 0) {
+			return;
+		}
+		_tail = (_tail + 1) % Capacity;
+		_count--;
+	}
+
+	uint8_t size() const {
+		return _count;
+	}
+
+	const cs_scanned_device_ring_stats_t& getStats() const {
+		return _stats;
+	}
+
+private:
+	struct __attribute__((packed)) cs_scanned_device_entry_t {
+		uint8_t address[MAC_ADDRESS_LEN];
+		bool resolvedPrivateAddress;
+		uint8_t addressType;
+		int8_t rssiMax;
+		uint8_t channel;
+		int16_t rssiSum;
+		uint8_t numScans;
+		uint32_t firstScanTime;
+		uint8_t dataSize;
+		uint8_t data[MAX_DATA_SIZE];
+	};
+
+	cs_scanned_device_entry_t _entries[Capacity];
+
+	/**
+	 * Hash of the address of each entry, so that most entries can be skipped with a single compare.
+	 */
+	uint8_t _tags[Capacity];
+
+	uint8_t _tail  = 0;
+	uint8_t _count = 0;
+
+	cs_scanned_device_ring_stats_t _stats;
+
+	static uint8_t getTag(const uint8_t* address) {
+		uint8_t tag = 0;
+		for (uint8_t i = 0; i < MAC_ADDRESS_LEN; ++i) {
+			tag = (tag * 31) ^ address[i];
+		}
+		return tag;
+	}
+};
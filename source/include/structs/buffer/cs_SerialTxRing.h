@@ -0,0 +1,130 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * Lock free ring buffer of bytes, with a single producer and a single consumer.
+ *
+ * The producer writes the bytes to send, the consumer (the UART interrupt) reads them in contiguous chunks.
+ * Only the producer modifies the head, and only the consumer modifies the tail.
+ * Bytes that don't fit are dropped, and counted.
+ *
+ * @param Size      Capacity in bytes, should be a power of 2.
+ */
+template <uint16_t Size>
+class SerialTxRing {
+public:
+	static_assert(Size > 0 && (Size & (Size - 1)) == 0, "Size should be a power of 2.");
+
+	/**
+	 * Number of bytes that can be written.
+	 *
+	 * Producer side.
+	 */
+	uint16_t free() const {
+		return Size - static_cast<uint16_t>(_head.load(std::memory_order_relaxed) - _tail.load(std::memory_order_acquire));
+	}
+
+	/**
+	 * Write bytes, the bytes that don't fit are dropped.
+	 *
+	 * Producer side.
+	 *
+	 * @return     Number of bytes written.
+	 */
+	uint16_t write(const uint8_t* data, uint16_t size) {
+		uint16_t head     = _head.load(std::memory_order_relaxed);
+		uint16_t freeSize = free();
+		if (size > freeSize) {
+			_droppedBytes += size - freeSize;
+			size = freeSize;
+		}
+		uint16_t offset    = head & MASK;
+		uint16_t firstPart = Size - offset;
+		if (firstPart > size) {
+			firstPart = size;
+		}
+		memcpy(_buffer + offset, data, firstPart);
+		memcpy(_buffer, data + firstPart, size - firstPart);
+		_head.store(head + size, std::memory_order_release);
+		return size;
+	}
+
+	/**
+	 * Count bytes as dropped, for bytes that were not even written, like a message that didn't fit.
+	 *
+	 * Producer side.
+	 */
+	void drop(uint16_t size) { _droppedBytes += size; }
+
+	/**
+	 * Total number of dropped bytes.
+	 */
+	uint32_t getDroppedBytes() const { return _droppedBytes; }
+
+	/**
+	 * Number of bytes that can be read.
+	 */
+	uint16_t size() const {
+		return static_cast<uint16_t>(_head.load(std::memory_order_acquire) - _tail.load(std::memory_order_relaxed));
+	}
+
+	bool empty() const { return size() == 0; }
+
+	/**
+	 * Get the largest contiguous chunk of bytes that can be read.
+	 *
+	 * Consumer side.
+	 *
+	 * @param[out] data     Set to the first byte of the chunk.
+	 * @return              Size of the chunk.
+	 */
+	uint16_t peek(const uint8_t*& data) const {
+		uint16_t tail   = _tail.load(std::memory_order_relaxed);
+		uint16_t offset = tail & MASK;
+		uint16_t chunk  = size();
+		if (chunk > Size - offset) {
+			chunk = Size - offset;
+		}
+		data = _buffer + offset;
+		return chunk;
+	}
+
+	/**
+	 * Remove bytes that have been read.
+	 *
+	 * Consumer side.
+	 */
+	void pop(uint16_t size) {
+		_tail.store(_tail.load(std::memory_order_relaxed) + size, std::memory_order_release);
+	}
+
+	/**
+	 * Remove all bytes.
+	 *
+	 * Should only be called when neither the producer nor the consumer is active.
+	 */
+	void clear() { _tail.store(_head.load(std::memory_order_relaxed), std::memory_order_relaxed); }
+
+private:
+	static constexpr uint16_t MASK = Size - 1;
+
+	uint8_t _buffer[Size];
+
+	/**
+	 * Free running indices: the ring holds the bytes from tail up to head.
+	 * They wrap at 2^16, which is a multiple of Size, so size is always head - tail.
+	 */
+	std::atomic<uint16_t> _head = {0};
+	std::atomic<uint16_t> _tail = {0};
+
+	uint32_t _droppedBytes = 0;
+};
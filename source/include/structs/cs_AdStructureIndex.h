@@ -0,0 +1,111 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Index of the AD structures in advertisement data: AD type -> (offset, length) of the structure data.
+ *
+ * Built once per advertisement, after which each lookup is a scan over a few bytes, instead of a walk over the
+ * advertisement data. Lookups give the same result as CsUtils::findAdvType(): the first structure with the given
+ * type, and nothing after a malformed structure.
+ *
+ * A legacy advertisement (31 bytes) has at most 15 structures, so MAX_ENTRIES covers that. For longer data, lookups
+ * that miss the index continue parsing where the index stopped.
+ */
+struct __attribute__((packed)) ad_structure_index_t {
+	static constexpr uint8_t MAX_ENTRIES = 16;
+
+	//! Whether build() has been called.
+	bool built = false;
+
+	//! Number of valid entries.
+	uint8_t count = 0;
+
+	//! Offset in the data where the index stopped, or 0 when the whole data has been indexed.
+	uint8_t resumeOffset = 0;
+
+	//! Bit (type % 32) is set when a structure of that type is in the index, so that most misses are a single check.
+	uint32_t typeBits = 0;
+
+	uint8_t types[MAX_ENTRIES];
+	uint8_t offsets[MAX_ENTRIES];
+	uint8_t lengths[MAX_ENTRIES];
+
+	/**
+	 * Parse the AD structures of the advertisement data.
+	 */
+	void build(const uint8_t* advData, uint8_t advLen) {
+		built = true;
+		count = 0;
+		resumeOffset = 0;
+		typeBits = 0;
+		int index = 0;
+		while (index < advLen - 1) {
+			uint8_t fieldLen = advData[index];
+			// Check if length is not 0 or larger than remaining advertisement data.
+			if (fieldLen == 0 || index + 1 + fieldLen > advLen) {
+				return;
+			}
+			if (count == MAX_ENTRIES) {
+				resumeOffset = index;
+				return;
+			}
+			types[count]   = advData[index + 1];
+			typeBits      |= 1u << (advData[index + 1] % 32);
+			offsets[count] = index + 2;
+			lengths[count] = fieldLen - 1;
+			count++;
+			index += fieldLen + 1;
+		}
+	}
+
+	/**
+	 * Find the first AD structure of given type.
+	 *
+	 * @param[in] type            AD type to look for.
+	 * @param[in] advData         The advertisement data, the same as the index was built with.
+	 * @param[in] advLen          Length of the advertisement data.
+	 * @param[out] offset         Offset of the structure data (after the type byte).
+	 * @param[out] len            Length of the structure data.
+	 * @return                    True when found.
+	 */
+	bool find(uint8_t type, const uint8_t* advData, uint8_t advLen, uint8_t& offset, uint8_t& len) {
+		if (!built) {
+			build(advData, advLen);
+		}
+		if (typeBits & (1u << (type % 32))) {
+			for (uint8_t i = 0; i < count; ++i) {
+				if (types[i] == type) {
+					offset = offsets[i];
+					len = lengths[i];
+					return true;
+				}
+			}
+		}
+		if (resumeOffset == 0) {
+			return false;
+		}
+
+		// More structures than fit in the index: continue parsing.
+		int index = resumeOffset;
+		while (index < advLen - 1) {
+			uint8_t fieldLen = advData[index];
+			if (fieldLen == 0 || index + 1 + fieldLen > advLen) {
+				return false;
+			}
+			if (advData[index + 1] == type) {
+				offset = index + 2;
+				len = fieldLen - 1;
+				return true;
+			}
+			index += fieldLen + 1;
+		}
+		return false;
+	}
+};
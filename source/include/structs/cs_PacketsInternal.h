@@ -8,6 +8,7 @@
 
 #include <protocol/cs_ErrorCodes.h>
 #include <protocol/cs_Packets.h>
+#include <structs/cs_AdStructureIndex.h>
 
 /**
  * Packets (structs) that are used internally in the firmware, and can be changed freely.
@@ -105,7 +106,41 @@ struct __attribute__((packed)) scanned_device_t {
 	uint8_t channel;
 	uint8_t dataSize;
 	uint8_t* data;  // Advertisement or scan response data.
+
+	/**
+	 * Number of scans combined into this one, see ScannedDeviceRing.
+	 * When larger than 1, rssi is the max RSSI of these scans, and channel the channel of that RSSI.
+	 */
+	uint8_t numScans = 1;
+	int8_t rssiAverage = 0;  // Average RSSI of the combined scans.
 	// More possibilities: addressType, connectable, isScanResponse, directed, scannable, extended advertisements, etc.
+
+	/**
+	 * Index of the AD structures in data, built on first use.
+	 * Mutable, as it's only a cache: all handlers of the scanned device share it.
+	 */
+	mutable ad_structure_index_t adIndex;
+
+	/**
+	 * Find the first AD structure of given type in the data.
+	 *
+	 * Gives the same result as CsUtils::findAdvType(), but the data is parsed only once per scanned device.
+	 *
+	 * @retval ERR_SUCCESS        if the data type is found.
+	 * @retval ERR_NOT_FOUND      if the type could not be found.
+	 */
+	cs_ret_code_t findAdvType(uint8_t type, cs_data_t* foundData) const {
+		uint8_t offset;
+		uint8_t len;
+		if (!adIndex.find(type, data, dataSize, offset, len)) {
+			foundData->data = nullptr;
+			foundData->len = 0;
+			return ERR_NOT_FOUND;
+		}
+		foundData->data = data + offset;
+		foundData->len = len;
+		return ERR_SUCCESS;
+	}
 };
 
 /**
@@ -10,7 +10,8 @@
 
 #include <events/cs_EventListener.h>
 #include <tracking/cs_TrackedDevice.h>
-#include <util/cs_Store.h>
+#include <util/cs_Coroutine.h>
+#include <util/cs_IndexedStore.h>
 
 
 /**
@@ -44,33 +45,42 @@ public:
 	/**
 	 * Maximum number of registered tracked devices.
 	 */
-	static const uint8_t MAX_TRACKED_DEVICES = 20;
+	static constexpr uint8_t MAX_TRACKED_DEVICES = 20;
 
 	/**
 	 * After N minutes not hearing anything from the device, the location ID will be set to 0 (in sphere).
 	 * This prevents sending out old locations.
 	 */
-	static const uint8_t LOCATION_ID_TTL_MINUTES = 5;
+	static constexpr uint8_t LOCATION_ID_TTL_MINUTES = 5;
 
 	/**
 	 * Max heartbeat TTL in minutes.
 	 * Make sure that it's not larger than what fits in location id timeout.
 	 */
-	static const uint16_t HEARTBEAT_TTL_MINUTES_MAX = 60;
+	static constexpr uint16_t HEARTBEAT_TTL_MINUTES_MAX = 60;
 
 private:
-	static const uint16_t TICKS_PER_SECOND = (1000 / TICK_INTERVAL_MS);
-	static const uint16_t TICKS_PER_MINUTES = (60 * 1000 / TICK_INTERVAL_MS);
+	static constexpr uint16_t TICKS_PER_SECOND = (1000 / TICK_INTERVAL_MS);
+	static constexpr uint16_t TICKS_PER_MINUTES = (60 * 1000 / TICK_INTERVAL_MS);
 
-	uint16_t ticksLeftSecond = TICKS_PER_SECOND;
-	uint16_t ticksLeftMinute = TICKS_PER_MINUTES;
+	/**
+	 * Call tickSecond() every second, and tickMinute() every minute.
+	 */
+	Coroutine tickSecondRoutine = Coroutine([this]() {
+		tickSecond();
+		return TICKS_PER_SECOND;
+	});
+	Coroutine tickMinuteRoutine = Coroutine([this]() {
+		tickMinute();
+		return TICKS_PER_MINUTES;
+	});
 
 	/**
 	 * List of all tracked devices.
 	 *
 	 * Device ID should be unique.
 	 */
-	Store<TrackedDevice, MAX_TRACKED_DEVICES> _store;
+	IndexedStore<TrackedDevice, MAX_TRACKED_DEVICES> _store;
 
 	/**
 	 * Whether there has been a successful sync of tracked devices.
@@ -108,12 +118,12 @@ private:
 	TrackedDevice* findToken(uint8_t* deviceToken, uint8_t size);
 
 	/**
-	 * Add device to list.
+	 * Add device with given ID to list.
 	 *
 	 * Returns invalidated entry when added.
 	 * Returns null if couldn't be added.
 	 */
-	TrackedDevice* add();
+	TrackedDevice* add(device_id_t deviceId);
 
 	cs_ret_code_t handleRegister(internal_register_tracked_device_packet_t& packet);
 	cs_ret_code_t handleUpdate(internal_update_tracked_device_packet_t& packet);
@@ -55,5 +55,7 @@ private:
 	void handleCommandEnableMesh       (cs_data_t commandData);
 	void handleCommandGetId            (cs_data_t commandData);
 	void handleCommandGetMacAddress    (cs_data_t commandData);
+	void handleCommandGetStats         (cs_data_t commandData);
+	void handleCommandSetLogLevel      (cs_data_t commandData);
 	void handleCommandInjectEvent      (cs_data_t commandData);
 };
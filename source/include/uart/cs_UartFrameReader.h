@@ -0,0 +1,215 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+#pragma once
+
+#include <protocol/cs_UartProtocol.h>
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Reads UART frames byte by byte: unescapes them, and checks the size header, into a pool of frame slots.
+ *
+ * The reader (the UART interrupt) fills the next free slot, while earlier frames are still being handled.
+ * A frame is only dropped when all slots are in use, which is counted as overflow.
+ * Only the reader modifies the head, and only the handler modifies the tail.
+ *
+ * The CRC is not checked, that's up to the handler.
+ *
+ * @param FrameSize     Max size of a frame, excluding start byte and size header.
+ * @param NumFrames     Number of frame slots, should be a power of 2.
+ */
+template <uint16_t FrameSize, uint8_t NumFrames>
+class UartFrameReader {
+public:
+	static_assert(NumFrames > 0 && (NumFrames & (NumFrames - 1)) == 0, "NumFrames should be a power of 2.");
+
+	/**
+	 * Number of bytes the buffer should have.
+	 */
+	static constexpr uint16_t BUFFER_SIZE = FrameSize * NumFrames;
+
+	/**
+	 * Set the buffer to read the frames into, of BUFFER_SIZE bytes.
+	 *
+	 * Until the buffer is set, all read bytes are ignored.
+	 */
+	void setBuffer(uint8_t* buffer) { _buffer = buffer; }
+
+	/**
+	 * To be called when a byte was read. Can be called from interrupt.
+	 *
+	 * @param[in] val        Value that was read.
+	 * @return               True when a frame has been completed.
+	 */
+	bool onRead(uint8_t val) {
+		if (_buffer == nullptr) {
+			return false;
+		}
+
+		// An escape shouldn't be followed by a special byte.
+		switch (val) {
+			case UART_START_BYTE:
+			case UART_ESCAPE_BYTE:
+				if (_escapeNextByte) {
+					discard();
+					return false;
+				}
+		}
+
+		if (val == UART_START_BYTE) {
+			discard();
+			if (full()) {
+				// No slot to read into: skip this frame.
+				_overflowCount++;
+				return false;
+			}
+			_startedReading = true;
+			return false;
+		}
+
+		if (!_startedReading) {
+			return false;
+		}
+
+		if (val == UART_ESCAPE_BYTE) {
+			_escapeNextByte = true;
+			return false;
+		}
+
+		if (_escapeNextByte) {
+			UartProtocol::unEscape(val);
+			_escapeNextByte = false;
+		}
+
+		uint8_t head  = _head.load(std::memory_order_relaxed);
+		uint8_t* slot = getSlot(head);
+		slot[_readIndex++] = val;
+
+		if (_sizeToRead == 0) {
+			if (_readIndex == sizeof(uart_msg_size_header_t)) {
+				uart_msg_size_header_t* sizeHeader = reinterpret_cast<uart_msg_size_header_t*>(slot);
+				if (sizeHeader->size == 0 || sizeHeader->size > FrameSize) {
+					discard();
+					return false;
+				}
+				// The size header is not part of the frame.
+				_sizeToRead = sizeHeader->size;
+				_readIndex  = 0;
+			}
+			return false;
+		}
+
+		if (_readIndex < _sizeToRead) {
+			return false;
+		}
+
+		_sizes[head & MASK] = _readIndex;
+		_head.store(head + 1, std::memory_order_release);
+		_frameCount++;
+		resetRead();
+		return true;
+	}
+
+	/**
+	 * Get the oldest frame that has been read.
+	 *
+	 * Handler side.
+	 *
+	 * @param[out] size      Size of the frame: starts after the size header, and includes the tail (CRC).
+	 * @return               The frame, or nullptr when there is none.
+	 */
+	uint8_t* peek(uint16_t& size) {
+		uint8_t tail = _tail.load(std::memory_order_relaxed);
+		if (tail == _head.load(std::memory_order_acquire)) {
+			return nullptr;
+		}
+		size = _sizes[tail & MASK];
+		return getSlot(tail);
+	}
+
+	/**
+	 * Free the oldest frame, after it has been handled.
+	 *
+	 * Handler side.
+	 */
+	void pop() { _tail.store(_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+	/**
+	 * Number of frames that have been read, and are not freed yet.
+	 */
+	uint8_t size() const {
+		return static_cast<uint8_t>(_head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire));
+	}
+
+	/**
+	 * Number of frames that have been read.
+	 */
+	uint32_t getFrameCount() const { return _frameCount; }
+
+	/**
+	 * Number of frames that were dropped, because all slots were in use.
+	 */
+	uint32_t getOverflowCount() const { return _overflowCount; }
+
+	/**
+	 * Number of frames that were discarded, because they were malformed or incomplete.
+	 */
+	uint32_t getDiscardedCount() const { return _discardedCount; }
+
+private:
+	static constexpr uint8_t MASK = NumFrames - 1;
+
+	uint8_t* _buffer = nullptr;
+
+	//! Size of each frame in the slots.
+	uint16_t _sizes[NumFrames];
+
+	/**
+	 * Free running indices: the slots from tail up to head hold frames that have been read.
+	 * The head slot is the one being read into.
+	 */
+	std::atomic<uint8_t> _head = {0};
+	std::atomic<uint8_t> _tail = {0};
+
+	//! Where to read the next byte into the slot.
+	uint16_t _readIndex = 0;
+
+	/**
+	 * Size of the frame to read, including wrapper header and tail, excluding start byte and size header.
+	 * Once set, the read index is set to 0.
+	 */
+	uint16_t _sizeToRead = 0;
+
+	//! Keeps up whether we started reading a frame.
+	bool _startedReading = false;
+
+	//! Keeps up whether to escape the next read byte.
+	bool _escapeNextByte = false;
+
+	uint32_t _frameCount     = 0;
+	uint32_t _overflowCount  = 0;
+	uint32_t _discardedCount = 0;
+
+	bool full() const { return size() == NumFrames; }
+
+	uint8_t* getSlot(uint8_t index) { return _buffer + (index & MASK) * FrameSize; }
+
+	void resetRead() {
+		_readIndex      = 0;
+		_sizeToRead     = 0;
+		_startedReading = false;
+		_escapeNextByte = false;
+	}
+
+	void discard() {
+		if (_startedReading) {
+			_discardedCount++;
+		}
+		resetRead();
+	}
+};
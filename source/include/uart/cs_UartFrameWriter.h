@@ -0,0 +1,140 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+#pragma once
+
+#include <protocol/cs_UartProtocol.h>
+
+#include <cstdint>
+
+/**
+ * Writes UART frames: start byte, size header, wrapper header, payload, and CRC tail, with escaping.
+ *
+ * The escaped bytes are collected in a small chunk, which is written to the sink at once.
+ * A frame is only started when the sink can take the whole frame, else the whole frame is dropped,
+ * so that the other side never receives half a frame.
+ *
+ * @param Sink      Class with the functions:
+ *                  bool reserve(uint16_t size): whether a frame of at most size bytes can be written.
+ *                  void write(const uint8_t* data, uint16_t size): write bytes.
+ */
+template <class Sink>
+class UartFrameWriter {
+public:
+	UartFrameWriter(Sink& sink) : _sink(sink) {}
+
+	/**
+	 * Maximum number of bytes a frame takes, when every byte after the start byte is escaped.
+	 */
+	static constexpr uint16_t maxFrameSize(uint16_t payloadSize) {
+		return 1 + 2 * (sizeof(uart_msg_size_header_t) + getFrameSize(payloadSize));
+	}
+
+	/**
+	 * Start a frame: writes the start byte, size header, and wrapper header.
+	 *
+	 * @param[in] msgType         Type of the payload.
+	 * @param[in] payloadSize     Size of the payload, that will be written with write().
+	 * @return                    False when the frame is dropped.
+	 */
+	bool start(UartMsgType msgType, uint16_t payloadSize) {
+		_dropping = !_sink.reserve(maxFrameSize(payloadSize));
+		if (_dropping) {
+			return false;
+		}
+
+		uart_msg_size_header_t sizeHeader;
+		uart_msg_wrapper_header_t wrapperHeader;
+		sizeHeader.size    = getFrameSize(payloadSize);
+		wrapperHeader.type = static_cast<uint8_t>(msgType);
+
+		_crc = UartProtocol::crc16(nullptr, 0);
+
+		// The start byte is the only byte that is not escaped.
+		_chunk[_chunkSize++] = UART_START_BYTE;
+		write(reinterpret_cast<uint8_t*>(&sizeHeader), sizeof(sizeHeader), false);
+		write(reinterpret_cast<uint8_t*>(&wrapperHeader), sizeof(wrapperHeader), true);
+		return true;
+	}
+
+	/**
+	 * Write escaped bytes.
+	 *
+	 * Can also be used outside a frame, to write text.
+	 *
+	 * @param[in] data            Bytes to write.
+	 * @param[in] size            Number of bytes.
+	 * @param[in] updateCrc       Whether the bytes are part of the CRC.
+	 */
+	void write(const uint8_t* data, uint16_t size, bool updateCrc) {
+		if (_dropping) {
+			return;
+		}
+		if (updateCrc) {
+			UartProtocol::crc16(data, size, _crc);
+		}
+		for (uint16_t i = 0; i < size; ++i) {
+			uint8_t val = data[i];
+			if (_chunkSize > CHUNK_SIZE - 2) {
+				flush();
+			}
+			switch (val) {
+				case UART_START_BYTE:
+				case UART_ESCAPE_BYTE:
+					_chunk[_chunkSize++] = UART_ESCAPE_BYTE;
+					val ^= UART_ESCAPE_FLIP_MASK;
+					break;
+			}
+			_chunk[_chunkSize++] = val;
+		}
+		flush();
+	}
+
+	/**
+	 * End a frame: writes the CRC tail.
+	 */
+	void end() {
+		if (_dropping) {
+			_dropping = false;
+			return;
+		}
+		uart_msg_tail_t tail;
+		tail.crc = _crc;
+		write(reinterpret_cast<uint8_t*>(&tail), sizeof(tail), false);
+	}
+
+private:
+	static constexpr uint16_t CHUNK_SIZE = 32;
+
+	Sink& _sink;
+
+	/**
+	 * Escaped bytes that are not written to the sink yet.
+	 */
+	uint8_t _chunk[CHUNK_SIZE];
+	uint16_t _chunkSize = 0;
+
+	uint16_t _crc = 0;
+
+	/**
+	 * Whether the current frame is dropped.
+	 */
+	bool _dropping = false;
+
+	/**
+	 * Size of all bytes after the size header.
+	 */
+	static constexpr uint16_t getFrameSize(uint16_t payloadSize) {
+		return sizeof(uart_msg_wrapper_header_t) + payloadSize + sizeof(uart_msg_tail_t);
+	}
+
+	void flush() {
+		if (_chunkSize > 0) {
+			_sink.write(_chunk, _chunkSize);
+			_chunkSize = 0;
+		}
+	}
+};
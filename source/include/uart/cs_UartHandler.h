@@ -11,12 +11,30 @@
 #include <events/cs_EventListener.h>
 #include <protocol/cs_UartProtocol.h>
 #include <uart/cs_UartCommandHandler.h>
+#include <uart/cs_UartFrameReader.h>
+#include <uart/cs_UartFrameWriter.h>
 
 #define UART_RX_BUFFER_SIZE            192
 #define UART_TX_BUFFER_SIZE            300
 #define UART_TX_ENCRYPTION_BUFFER_SIZE AES_BLOCK_SIZE
 //#define UART_TX_MAX_PAYLOAD_SIZE       500
 
+/**
+ * Number of frames that can be read, while earlier frames are still being handled.
+ * Should be a power of 2.
+ */
+#ifndef CS_UART_RX_NUM_FRAMES
+#define CS_UART_RX_NUM_FRAMES 4
+#endif
+
+/**
+ * Writes UART frames to the serial TX buffer.
+ */
+class UartSerialSink {
+public:
+	bool reserve(uint16_t size);
+	void write(const uint8_t* data, uint16_t size);
+};
 
 
 /**
@@ -59,6 +77,15 @@ public:
 	 */
 	ret_code_t writeMsg(UartOpcodeTx opCode);
 
+	/**
+	 * Whether a msg can be written now, without being dropped.
+	 *
+	 * @param[in] opCode     OpCode of the msg.
+	 * @param[in] size       Size of the msg.
+	 * @param[in] encrypt    How to encrypt the msg.
+	 */
+	bool canWriteMsg(UartOpcodeTx opCode, uint16_t size, UartProtocol::Encrypt encrypt = UartProtocol::ENCRYPT_ACCORDING_TO_TYPE);
+
 	/**
 	 * Write a msg over UART in a streaming manner.
 	 * Must be followed by 1 or more writeMsgPart(), followed by 1 writeMsgEnd().
@@ -97,12 +124,16 @@ public:
 	void onRead(uint8_t val);
 
 	/**
-	 * Handles read msgs (private function)
+	 * Handles all frames that have been read (private function).
 	 *
-	 * Message data starts after START byte, and includes the tail (CRC).
-	 * Wrapper header size has been checked already.
+	 * Called from the app scheduler.
 	 */
-	void handleMsg(cs_data_t* msgData);
+	void handleReadFrames();
+
+	/**
+	 * Get the UART statistics: read frames, dropped frames, and dropped TX bytes.
+	 */
+	uart_msg_stats_t getStats();
 
 private:
 	//! Constructor
@@ -122,26 +153,14 @@ private:
 
 	//////// RX variables ////////
 
-	//! Pointer to the read buffer
+	//! Pointer to the read buffer, holds all frame slots.
 	uint8_t* _readBuffer = nullptr;
 
-	//! Where to read the next byte into the read buffer
-	uint16_t _readBufferIdx = 0;
-
-	//! Keeps up whether we started reading into the read buffer
-	bool _startedReading = false;
-
-	//! Keeps up whether to escape the next read byte
-	bool _escapeNextByte = false;
-
-	/**
-	 * Size of the msg to read, including header and tail, excluding start byte.
-	 * Once set, the read buffer index is set to 0.
-	 */
-	uint16_t _sizeToRead = 0;
+	//! Reads the frames into the read buffer, while earlier frames are being handled.
+	UartFrameReader<UART_RX_BUFFER_SIZE, CS_UART_RX_NUM_FRAMES> _frameReader;
 
-	//! Whether reading is busy (if true, can't read anything, until the read buffer was processed)
-	bool _readBusy = false;
+	//! Whether handling of the read frames has been put on the app scheduler.
+	volatile bool _handleScheduled = false;
 
 
 	//////// TX variables ////////
@@ -165,18 +184,15 @@ private:
 	//! Packet nonce to use for writing current msg.
 	encryption_nonce_t _writeNonce;
 
-	//! Keeps up the crc so far.
-	uint16_t _crc;
+	UartSerialSink _serialSink;
+
+	//! Writes the frames, keeps up the crc so far.
+	UartFrameWriter<UartSerialSink> _frameWriter = UartFrameWriter<UartSerialSink>(_serialSink);
 
 	//! Stone ID, part of the msg header.
 	TYPIFY(CONFIG_CROWNSTONE_ID) _stoneId = 0;
 
 
-	/**
-	 * Write the start byte.
-	 */
-	cs_ret_code_t writeStartByte();
-
 	/**
 	 * Write bytes to UART.
 	 *
@@ -190,6 +206,8 @@ private:
 
 	/**
 	 * Writes wrapper header (including start and size), and initializes CRC.
+	 *
+	 * When the msg doesn't fit in the serial TX buffer, the whole msg is dropped.
 	 */
 	cs_ret_code_t writeWrapperStart(UartMsgType msgType, uint16_t payloadSize);
 
@@ -269,9 +287,11 @@ private:
 	void handleUartMsg(uint8_t* data, uint16_t size, EncryptionAccessLevel accessLevel);
 
 	/**
-	 * Reset the read buffer and status.
+	 * Put handling of the read frames on the app scheduler, if not done already.
+	 *
+	 * Can be called from interrupt.
 	 */
-	void resetReadBuf();
+	void scheduleHandleReadFrames();
 
 	/**
 	 * Handle events as EventListener.
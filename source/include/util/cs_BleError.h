@@ -80,7 +80,7 @@ void mesh_assertion_handler(uint32_t pc);
 	class ble_exception : public std::exception {
 	public:
 		char* _message;
-		ble_exception(char* message, char* file = "<unknown>", int line = 0) : _message(message) {}
+		ble_exception(char* message, const char* file = "<unknown>", int line = 0) : _message(message) {}
 		~ble_exception() throw() {}
 
 		virtual char const *what() const throw() {
@@ -10,6 +10,7 @@
 
 #include <drivers/cs_Timer.h>
 #include <drivers/cs_RTC.h>
+#include <util/cs_TimerWheel.h>
 
 // coroutines
 // note: coroutine is currently built upon the event buss tickrate
@@ -36,11 +37,28 @@
  * a coroutine can dynamically determine if it needs to be called more
  * often or not.
  *
+ * Instead of calling onTick() or handleEvent() on every tick, a coroutine
+ * can be started on the timer wheel with start(): it's then only called
+ * when it's due. Use one way or the other, not both.
  */
 class Coroutine {
 private:
 	uint32_t nextCallTickcount = 0;
 
+	/**
+	 * Whether the action has been called via onTick().
+	 */
+	bool called = false;
+
+	/**
+	 * Timer used when started on the timer wheel.
+	 */
+	WheelTimer timer = WheelTimer([this]() {
+		auto ticksToWait = action ? action() : 0;
+		// Like onTick(): a delay of 0 means the next tick.
+		return ticksToWait == 0 ? 1 : ticksToWait;
+	});
+
 public:
 	typedef std::function<uint32_t(void)> Action;
 
@@ -54,13 +72,31 @@ public:
 	 * To be called on tick event.
 	 */
 	void onTick(uint32_t currentTickCount) {
-		// TODO: not doing roll-over checks here yet..
-		if (currentTickCount >= nextCallTickcount && action) {
+		// Compare the difference, so that it keeps working when the tick count rolls over.
+		bool due = !called || static_cast<int32_t>(currentTickCount - nextCallTickcount) >= 0;
+		if (due && action) {
 			auto ticksToWait = action();
 			nextCallTickcount = currentTickCount + ticksToWait;
+			called = true;
 		}
 	}
 
+	/**
+	 * Start calling the action via the timer wheel, instead of via onTick().
+	 *
+	 * @param[in] delayTicks     Number of ticks before the first call. 0 means the next tick.
+	 */
+	void start(uint32_t delayTicks = 0) {
+		TimerWheel::getInstance().start(timer, delayTicks);
+	}
+
+	/**
+	 * Stop calling the action via the timer wheel.
+	 */
+	void stop() {
+		TimerWheel::getInstance().stop(timer);
+	}
+
 	/**
 	 * Convenience function replacing onTick().
 	 *
@@ -75,7 +111,7 @@ public:
 	}
 
 	uint32_t getNextCallTickCount() const {
-		return nextCallTickcount;
+		return timer.isStarted() ? timer.getExpiryTickCount() : nextCallTickcount;
 	}
 
 	static uint32_t delayMs(uint32_t ms) {
@@ -0,0 +1,303 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(HOST_TARGET) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define CS_CRC_PCLMUL
+#endif
+
+/**
+ * Number of tables used by the table driven CRC implementations: 1, 4, or 8.
+ *
+ * Each table costs 256 entries: 512B for CRC16, and 1kB for CRC32.
+ * More tables process more bytes per iteration: with 4 tables a CRC32 is 4 bytes per iteration.
+ * Set to 0 to use the byte at a time implementations of the SDK, which don't use a table.
+ */
+#ifndef CRC_TABLE_SLICES
+#define CRC_TABLE_SLICES 4
+#endif
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "Slicing implementation assumes little endian.");
+
+/**
+ * Table driven CRC implementations, with the same results as crc16_compute() and crc32_compute() of the SDK.
+ *
+ * Tables are generated at compile time, so they end up in flash.
+ */
+namespace CsCrc {
+
+template <typename T, uint8_t Slices>
+struct crc_table_t {
+	T table[Slices][256];
+};
+
+/**
+ * CRC-16-CCITT: polynomial 0x1021, most significant bit first.
+ */
+template <uint8_t Slices>
+constexpr crc_table_t<uint16_t, Slices> makeCrc16Table() {
+	crc_table_t<uint16_t, Slices> result = {};
+	for (uint16_t i = 0; i < 256; ++i) {
+		uint16_t crc = i << 8;
+		for (int bit = 0; bit < 8; ++bit) {
+			crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021) : static_cast<uint16_t>(crc << 1);
+		}
+		result.table[0][i] = crc;
+	}
+	for (uint8_t slice = 1; slice < Slices; ++slice) {
+		for (uint16_t i = 0; i < 256; ++i) {
+			uint16_t prev          = result.table[slice - 1][i];
+			result.table[slice][i] = static_cast<uint16_t>((prev << 8) ^ result.table[0][prev >> 8]);
+		}
+	}
+	return result;
+}
+
+/**
+ * CRC-32: polynomial 0x04C11DB7, least significant bit first.
+ */
+template <uint8_t Slices>
+constexpr crc_table_t<uint32_t, Slices> makeCrc32Table() {
+	crc_table_t<uint32_t, Slices> result = {};
+	for (uint32_t i = 0; i < 256; ++i) {
+		uint32_t crc = i;
+		for (int bit = 0; bit < 8; ++bit) {
+			crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+		}
+		result.table[0][i] = crc;
+	}
+	for (uint8_t slice = 1; slice < Slices; ++slice) {
+		for (uint32_t i = 0; i < 256; ++i) {
+			uint32_t prev          = result.table[slice - 1][i];
+			result.table[slice][i] = (prev >> 8) ^ result.table[0][prev & 0xFF];
+		}
+	}
+	return result;
+}
+
+/**
+ * The tables, as static members of class templates, so that a table only ends up in flash when it's used.
+ */
+template <uint8_t Slices>
+struct Crc16Table {
+	static constexpr crc_table_t<uint16_t, Slices> value = makeCrc16Table<Slices>();
+};
+
+template <uint8_t Slices>
+constexpr crc_table_t<uint16_t, Slices> Crc16Table<Slices>::value;
+
+template <uint8_t Slices>
+struct Crc32Table {
+	static constexpr crc_table_t<uint32_t, Slices> value = makeCrc32Table<Slices>();
+};
+
+template <uint8_t Slices>
+constexpr crc_table_t<uint32_t, Slices> Crc32Table<Slices>::value;
+
+inline uint32_t load32(const uint8_t* data) {
+	uint32_t word;
+	memcpy(&word, data, sizeof(word));
+	return word;
+}
+
+/**
+ * Updates a CRC-16-CCITT.
+ *
+ * @param[in] data      Pointer to data.
+ * @param[in] size      Size of data.
+ * @param[in] crc       Previous CRC, or 0xFFFF for the first call.
+ * @return              Updated CRC.
+ */
+template <uint8_t Slices>
+uint16_t crc16(const uint8_t* data, size_t size, uint16_t crc) {
+	static_assert(Slices == 1 || Slices == 4 || Slices == 8, "Invalid number of slices.");
+	auto& t = Crc16Table<Slices>::value.table;
+
+	// Each iteration: the first 2 bytes are combined with the CRC, the others go through the tables as they are.
+	// The first 4 tables of slice by 8 are the tables of slice by 4, so the remainder can use slice by 4.
+	if (Slices == 8) {
+		while (size >= 8) {
+			uint32_t word1 = load32(data) ^ ((crc >> 8) | ((crc & 0xFF) << 8));
+			uint32_t word2 = load32(data + 4);
+			crc = t[7][word1 & 0xFF] ^ t[6][(word1 >> 8) & 0xFF] ^ t[5][(word1 >> 16) & 0xFF] ^ t[4][word1 >> 24]
+				  ^ t[3][word2 & 0xFF] ^ t[2][(word2 >> 8) & 0xFF] ^ t[1][(word2 >> 16) & 0xFF] ^ t[0][word2 >> 24];
+			data += 8;
+			size -= 8;
+		}
+	}
+	if (Slices >= 4) {
+		while (size >= 4) {
+			uint32_t word = load32(data) ^ ((crc >> 8) | ((crc & 0xFF) << 8));
+			crc = t[3][word & 0xFF] ^ t[2][(word >> 8) & 0xFF] ^ t[1][(word >> 16) & 0xFF] ^ t[0][word >> 24];
+			data += 4;
+			size -= 4;
+		}
+	}
+	while (size--) {
+		crc = static_cast<uint16_t>((crc << 8) ^ t[0][(crc >> 8) ^ *data++]);
+	}
+	return crc;
+}
+
+#ifdef CS_CRC_PCLMUL
+/**
+ * Folds the CRC-32 state over the data with carry-less multiplications.
+ *
+ * Size must be a multiple of 16, and at least 64.
+ * See "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction" by Intel.
+ */
+__attribute__((target("pclmul,sse4.1"))) inline uint32_t crc32Pclmul(const uint8_t* data, size_t size, uint32_t crc) {
+	// Constants for the reflected CRC-32 polynomial: x^(4*128+32), x^(4*128-32), x^(128+32), x^(128-32), x^64,
+	// all mod P, and for the Barrett reduction: P and floor(x^64 / P).
+	alignas(16) static const uint64_t k1k2[] = {0x0154442bd4, 0x01c6e41596};
+	alignas(16) static const uint64_t k3k4[] = {0x01751997d0, 0x00ccaa009e};
+	alignas(16) static const uint64_t k5k0[] = {0x0163cd6124, 0x0000000000};
+	alignas(16) static const uint64_t poly[] = {0x01db710641, 0x01f7011641};
+
+	__m128i x0, x1, x2, x3, x4, x5, x6, x7, x8;
+
+	x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x00));
+	x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x10));
+	x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x20));
+	x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x30));
+	x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(crc));
+	x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k1k2));
+	data += 64;
+	size -= 64;
+
+	// Fold 4 x 128 bits at a time.
+	while (size >= 64) {
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+		x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+		x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+		x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+		x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x00)));
+		x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x10)));
+		x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x20)));
+		x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x30)));
+		data += 64;
+		size -= 64;
+	}
+
+	// Fold into 128 bits.
+	x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k3k4));
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+	// Fold the remaining blocks of 128 bits.
+	while (size >= 16) {
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data))), x5);
+		data += 16;
+		size -= 16;
+	}
+
+	// Fold 128 bits to 64 bits.
+	x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+	x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+	x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+	x0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(k5k0));
+	x2 = _mm_srli_si128(x1, 4);
+	x1 = _mm_and_si128(x1, x3);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+
+	// Barrett reduction to 32 bits.
+	x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(poly));
+	x2 = _mm_and_si128(x1, x3);
+	x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+	x2 = _mm_and_si128(x2, x3);
+	x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+	return static_cast<uint32_t>(_mm_extract_epi32(x1, 1));
+}
+
+inline bool hasPclmul() {
+	static const bool supported = __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+	return supported;
+}
+#endif
+
+/**
+ * Updates a CRC-32, using only the tables.
+ *
+ * @param[in] data      Pointer to data.
+ * @param[in] size      Size of data.
+ * @param[in] crc       Previous CRC, or 0 for the first call.
+ * @return              Updated CRC.
+ */
+template <uint8_t Slices>
+uint32_t crc32Table(const uint8_t* data, size_t size, uint32_t crc) {
+	static_assert(Slices == 1 || Slices == 4 || Slices == 8, "Invalid number of slices.");
+	auto& t = Crc32Table<Slices>::value.table;
+	crc     = ~crc;
+	if (Slices == 8) {
+		while (size >= 8) {
+			uint32_t word1 = load32(data) ^ crc;
+			uint32_t word2 = load32(data + 4);
+			crc = t[7][word1 & 0xFF] ^ t[6][(word1 >> 8) & 0xFF] ^ t[5][(word1 >> 16) & 0xFF] ^ t[4][word1 >> 24]
+				  ^ t[3][word2 & 0xFF] ^ t[2][(word2 >> 8) & 0xFF] ^ t[1][(word2 >> 16) & 0xFF] ^ t[0][word2 >> 24];
+			data += 8;
+			size -= 8;
+		}
+	}
+	if (Slices >= 4) {
+		while (size >= 4) {
+			uint32_t word = load32(data) ^ crc;
+			crc = t[3][word & 0xFF] ^ t[2][(word >> 8) & 0xFF] ^ t[1][(word >> 16) & 0xFF] ^ t[0][word >> 24];
+			data += 4;
+			size -= 4;
+		}
+	}
+	while (size--) {
+		crc = (crc >> 8) ^ t[0][(crc ^ *data++) & 0xFF];
+	}
+	return ~crc;
+}
+
+/**
+ * Updates a CRC-32.
+ *
+ * On a host with PCLMUL, blocks of 16 bytes are folded with carry-less multiplications.
+ *
+ * @param[in] data      Pointer to data.
+ * @param[in] size      Size of data.
+ * @param[in] crc       Previous CRC, or 0 for the first call.
+ * @return              Updated CRC.
+ */
+template <uint8_t Slices>
+uint32_t crc32(const uint8_t* data, size_t size, uint32_t crc) {
+#ifdef CS_CRC_PCLMUL
+	if (size >= 64 && hasPclmul()) {
+		size_t foldSize = size & ~static_cast<size_t>(15);
+		crc             = ~crc32Pclmul(data, foldSize, ~crc);
+		data += foldSize;
+		size -= foldSize;
+	}
+#endif
+	return crc32Table<Slices>(data, size, crc);
+}
+
+}  // namespace CsCrc
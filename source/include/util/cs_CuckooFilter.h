@@ -110,6 +110,19 @@ public:
 	}
 
 
+	// -------------------------------------------------------------
+	// For checking the same key against multiple filters.
+	// -------------------------------------------------------------
+
+	/**
+	 * Hashes a key (element), independent of the size of the filter.
+	 *
+	 * The fingerprint is the crc16 of the key, the (untruncated) bucket index the Djb2 hash of the key.
+	 */
+	static cuckoo_key_hash_t hashKey(cuckoo_key_t key, size_t keyLengthInBytes);
+
+	bool contains(const cuckoo_key_hash_t& keyHash) { return contains(getExtendedFingerprint(keyHash)); }
+
 	/**
 	 * Reduces a key (element) to a compressed fingerprint, consisting of
 	 * the fingerprint of the key and its associated primary position in the fingerprint array.
@@ -214,26 +227,28 @@ private:
 	cuckoo_extended_fingerprint_t getExtendedFingerprint(cuckoo_fingerprint_t fingerprint, cuckoo_index_t bucketIndex);
 
 	/**
-	 * A crc16 hash of this filters current contents (_data).
+	 * Reduces the hashes of a key to an extended fingerprint for this filter.
 	 */
-	cuckoo_fingerprint_t filterHash();
+	cuckoo_extended_fingerprint_t getExtendedFingerprint(const cuckoo_key_hash_t& keyHash);
 
 	/**
-	 * Hashes the given key into a fingerprint.
+	 * A crc16 hash of this filters current contents (_data).
 	 */
-	cuckoo_fingerprint_t hashToFingerprint(cuckoo_key_t key, size_t keyLengthInBytes);
+	cuckoo_fingerprint_t filterHash();
 
 	/**
-	 * Hashes the given key to obtain an (untruncated) bucket index.
+	 * Returns the index in the bucket array of the fingerprint at the given coordinates.
+	 *
+	 * (The bucket array is packed, so no references to its elements.)
 	 */
-	cuckoo_fingerprint_t hashToBucket(cuckoo_key_t key, size_t keyLengthInBytes);
+	size_t fingerprintIndex(cuckoo_index_t bucketIndex, cuckoo_index_t fingerIndex) {
+		return (bucketIndex * _data->nestsPerBucket) + fingerIndex;
+	}
 
 	/**
-	 * Returns a reference to the fingerprint at the given coordinates.
+	 * Returns true if the fingerprint is in any of the nests of the bucket.
 	 */
-	cuckoo_fingerprint_t& lookupFingerprint(cuckoo_index_t bucketIndex, cuckoo_index_t fingerIndex) {
-		return _data->bucketArray[(bucketIndex * _data->nestsPerBucket) + fingerIndex];
-	}
+	bool bucketContains(cuckoo_fingerprint_t fingerprint, cuckoo_index_t bucketIndex);
 
 	/**
 	 * Returns true if there was an empty space in the bucket and placement
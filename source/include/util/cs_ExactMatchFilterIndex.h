@@ -0,0 +1,63 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+#pragma once
+
+#include <protocol/cs_ExactMatchFilterStructs.h>
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Lookup index of an exact match filter, built in RAM when the filters are committed.
+ *
+ * The sorted item array often has a common prefix (like the OUI of MAC addresses), so the index stores
+ * the length of the prefix that all items share. The byte after that prefix is used as radix: a directory
+ * holds, for each value of that byte, the range of items that have that value.
+ * Within such a range, a branchless binary search is done on the remaining bytes. When at most 8 bytes remain,
+ * they are compared as a single integer.
+ *
+ * The wire format of the filter (exact_match_filter_data_t) is not changed, the index only points to it.
+ * So the index has to be rebuilt when the filter data is modified or moved.
+ */
+class ExactMatchFilterIndex {
+public:
+	/**
+	 * Build the index for a filter with a sorted item array.
+	 */
+	void build(exact_match_filter_data_t* data);
+
+	/**
+	 * Remove the reference to the filter.
+	 */
+	void clear() { _data = nullptr; }
+
+	/**
+	 * Same as ExactMatchFilter::find().
+	 *
+	 * if contains(item,itemSize): returns the index of the item
+	 * else: return -1
+	 */
+	int find(const void* item, size_t itemSize) const;
+
+	bool contains(const void* item, size_t itemSize) const { return find(item, itemSize) >= 0; }
+
+private:
+	exact_match_filter_data_t* _data = nullptr;
+
+	/**
+	 * Number of bytes that all items have in common.
+	 */
+	uint8_t _prefixLength = 0;
+
+	/**
+	 * Index of the first item with radix byte value N, at index N.
+	 * The last entry is the item count, so that the range of value N ends at index N+1.
+	 */
+	uint8_t _radixStart[256 + 1] = {};
+
+	const uint8_t* getItem(size_t index) const { return _data->itemArray + index * _data->itemSize; }
+};
@@ -0,0 +1,368 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#pragma once
+
+#include <util/cs_Hash.h>
+
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+/**
+ * A storage utility for objects of type Rec, like Store, but with an index on the id of the records.
+ *
+ * Getting a record by id takes constant time on average, instead of a linear search. The index is a hash table with
+ * open addressing and linear probing, of at least twice the size of the store, so that probe sequences stay short.
+ *
+ * The records are also kept in a list, ordered by the last time they were added or touched. This gives the least
+ * recently used record in constant time, to evict. Removed records are moved to the old end of that list, so that
+ * they're reused first.
+ *
+ * Rec should implement the same as for Store, and:
+ *   - The id of a record should only be changed after getOrAdd() or replace(), with the same id.
+ *   - Records should be invalidated via remove(), so that they can be reused without a search.
+ *     A record that is invalidated otherwise, is only reused once it's the least recent record.
+ *
+ * The id is hashed by its bytes, so it can't have padding: it should be an integer, or a packed struct.
+ */
+template <class Rec, unsigned int Size>
+class IndexedStore {
+public:
+	/**
+	 * Identifies and simplifies the type returned by the id() method of Rec.
+	 */
+	typedef typename std::remove_reference<decltype(std::declval<Rec&>().id())>::type IdType;
+
+	static_assert(Size > 0 && Size <= 0x1000, "Invalid size");
+	static_assert(
+			std::is_trivially_copyable<IdType>::value
+					&& (std::is_integral<IdType>::value || alignof(IdType) == 1),
+			"Id should be an integer or a packed struct, so it has no padding");
+
+private:
+	/**
+	 * Index of a record, the largest values are reserved.
+	 */
+	typedef typename std::conditional<(Size < 0xFE), uint8_t, uint16_t>::type IndexType;
+
+	static constexpr IndexType NONE      = static_cast<IndexType>(~0);
+	static constexpr IndexType TOMBSTONE = NONE - 1;
+
+	static constexpr uint16_t getNumSlots() {
+		uint16_t numSlots = 1;
+		while (numSlots < 2 * Size) {
+			numSlots <<= 1;
+		}
+		return numSlots;
+	}
+
+	static constexpr uint16_t NUM_SLOTS = getNumSlots();
+
+	/**
+	 * The index is rebuilt when this many slots are in use, including tombstones.
+	 */
+	static constexpr uint16_t MAX_USED_SLOTS = NUM_SLOTS * 3 / 4;
+
+	/**
+	 * Current maximal number of valid records.
+	 * If _currentSize is less than Size, range based for loops
+	 * will loop over at most _currentSize items.
+	 */
+	uint16_t _currentSize = 0;
+
+	//! Number of slots that are not empty: indexed records and tombstones.
+	uint16_t _usedSlots   = 0;
+
+	//! Index of the record with the id that hashes to this slot, or NONE or TOMBSTONE.
+	IndexType _slots[NUM_SLOTS];
+
+	//! For each record: the next newer record in the list, or NONE.
+	IndexType _newer[Size];
+
+	//! For each record: the next older record in the list, or NONE.
+	IndexType _older[Size];
+
+	IndexType _newest     = NONE;
+	IndexType _oldest     = NONE;
+
+public:
+	Rec _records[Size]    = {};
+
+	IndexedStore() {
+		clearIndex();
+	}
+
+	Rec* begin() {
+		return _records;
+	}
+
+	Rec* end() {
+		return _records + _currentSize;
+	}
+
+	/**
+	 * Invalidate all records.
+	 */
+	void clear() {
+		for (auto& rec : *this) {
+			rec.invalidate();
+		}
+		_currentSize = 0;
+		_newest      = NONE;
+		_oldest      = NONE;
+		clearIndex();
+	}
+
+	/**
+	 * Returns the valid record with the given id, or nullptr if no such record exists.
+	 */
+	Rec* get(const IdType& id) {
+		for (uint16_t slot = getSlot(id); _slots[slot] != NONE; slot = (slot + 1) & (NUM_SLOTS - 1)) {
+			IndexType index = _slots[slot];
+			if (index != TOMBSTONE && _records[index].isValid() && _records[index].id() == id) {
+				return &_records[index];
+			}
+		}
+		return nullptr;
+	}
+
+	/**
+	 * Returns the first object `obj` in the store satisfying `p(obj) == true`, with a linear search.
+	 *
+	 * NOTE: this does _not_ check for isValid.
+	 */
+	template <class UnaryPredicate>
+	Rec* get(UnaryPredicate p) {
+		for (auto& obj : *this) {
+			if (p(obj)) {
+				return &obj;
+			}
+		}
+		return nullptr;
+	}
+
+	/**
+	 * Returns a pointer to the valid record which minimizes the value function `getValue`, with a linear search.
+	 */
+	template <class ValueFunction>
+	Rec* getMin(ValueFunction getValue) {
+		Rec* smallest = nullptr;
+		for (auto& obj : *this) {
+			if (obj.isValid() && (smallest == nullptr || getValue(obj) < getValue(*smallest))) {
+				smallest = &obj;
+			}
+		}
+		return smallest;
+	}
+
+	/**
+	 * Same as get, but if no valid record has the given id, returns an invalidated record that is indexed by the
+	 * given id. The caller should set the id, and make it valid.
+	 *
+	 * Returns nullptr if the store is full, and the least recent record is valid, see getLeastRecent() and replace().
+	 */
+	Rec* getOrAdd(const IdType& id) {
+		Rec* rec = get(id);
+		if (rec != nullptr) {
+			return rec;
+		}
+		rec = getFree();
+		if (rec == nullptr) {
+			return nullptr;
+		}
+		return replace(*rec, id);
+	}
+
+	/**
+	 * Invalidate a record, and index it by the given id, so it can be reused for that id.
+	 * The record will be the most recent one.
+	 *
+	 * No valid record should have the given id.
+	 */
+	Rec* replace(Rec& rec, const IdType& id) {
+		IndexType index = getIndex(rec);
+		unindex(index);
+		rec.invalidate();
+		insert(index, id);
+		touch(rec);
+		return &rec;
+	}
+
+	/**
+	 * Invalidate a record, so that it is reused first.
+	 */
+	void remove(Rec& rec) {
+		IndexType index = getIndex(rec);
+		unindex(index);
+		rec.invalidate();
+		unlink(index);
+		linkOldest(index);
+	}
+
+	/**
+	 * Make a record the most recent one.
+	 */
+	void touch(Rec& rec) {
+		IndexType index = getIndex(rec);
+		unlink(index);
+		linkNewest(index);
+	}
+
+	/**
+	 * Returns the record that was least recently added or touched, or nullptr if the store is empty.
+	 */
+	Rec* getLeastRecent() {
+		return (_oldest == NONE) ? nullptr : &_records[_oldest];
+	}
+
+	uint16_t size() {
+		return _currentSize;
+	}
+
+	/**
+	 * Returns number of elements that satisfy the predicate.
+	 */
+	template <class UnaryPredicate>
+	uint16_t countIf(UnaryPredicate p) {
+		uint16_t s = 0;
+		for (auto& rec : *this) {
+			s += p(rec) ? 1 : 0;
+		}
+		return s;
+	}
+
+	/**
+	 * Returns number of valid elements.
+	 */
+	uint16_t count() {
+		return countIf([](auto& rec) { return rec.isValid(); });
+	}
+
+	/**
+	 * Returns true if all elements are occupied and valid.
+	 */
+	bool full() {
+		return count() == Size;
+	}
+
+private:
+	IndexType getIndex(Rec& rec) {
+		return static_cast<IndexType>(&rec - _records);
+	}
+
+	uint16_t getSlot(const IdType& id) {
+		return Djb2(reinterpret_cast<const uint8_t*>(&id), sizeof(IdType)) & (NUM_SLOTS - 1);
+	}
+
+	/**
+	 * Returns an invalid record: a removed one, or a new one at the end. Returns nullptr otherwise, without a search,
+	 * as invalid records are at the old end of the list.
+	 */
+	Rec* getFree() {
+		if (_oldest != NONE && !_records[_oldest].isValid()) {
+			return &_records[_oldest];
+		}
+		if (_currentSize < Size) {
+			IndexType index = _currentSize++;
+			_newer[index]   = NONE;
+			_older[index]   = NONE;
+			linkOldest(index);
+			return &_records[index];
+		}
+		return nullptr;
+	}
+
+	void clearIndex() {
+		for (auto& slot : _slots) {
+			slot = NONE;
+		}
+		_usedSlots = 0;
+	}
+
+	/**
+	 * Rebuild the index from the valid records, to get rid of tombstones.
+	 */
+	void rebuild() {
+		clearIndex();
+		for (IndexType index = 0; index < _currentSize; ++index) {
+			if (_records[index].isValid()) {
+				insert(index, _records[index].id());
+			}
+		}
+	}
+
+	void insert(IndexType index, const IdType& id) {
+		if (_usedSlots >= MAX_USED_SLOTS) {
+			rebuild();
+		}
+		uint16_t slot = getSlot(id);
+		while (_slots[slot] != NONE && _slots[slot] != TOMBSTONE) {
+			slot = (slot + 1) & (NUM_SLOTS - 1);
+		}
+		if (_slots[slot] == NONE) {
+			_usedSlots++;
+		}
+		_slots[slot] = index;
+	}
+
+	/**
+	 * Remove a record from the index, found by its current id.
+	 *
+	 * When the id was changed after indexing, the stale entry stays until the next rebuild. That's harmless, as get()
+	 * checks the id.
+	 */
+	void unindex(IndexType index) {
+		for (uint16_t slot = getSlot(_records[index].id()); _slots[slot] != NONE; slot = (slot + 1) & (NUM_SLOTS - 1)) {
+			if (_slots[slot] == index) {
+				_slots[slot] = TOMBSTONE;
+				return;
+			}
+		}
+	}
+
+	void unlink(IndexType index) {
+		IndexType newer = _newer[index];
+		IndexType older = _older[index];
+		if (newer != NONE) {
+			_older[newer] = older;
+		}
+		else if (_newest == index) {
+			_newest = older;
+		}
+		if (older != NONE) {
+			_newer[older] = newer;
+		}
+		else if (_oldest == index) {
+			_oldest = newer;
+		}
+		_newer[index] = NONE;
+		_older[index] = NONE;
+	}
+
+	void linkNewest(IndexType index) {
+		_older[index] = _newest;
+		if (_newest != NONE) {
+			_newer[_newest] = index;
+		}
+		else {
+			_oldest = index;
+		}
+		_newest = index;
+	}
+
+	void linkOldest(IndexType index) {
+		_newer[index] = _oldest;
+		if (_oldest != NONE) {
+			_older[_oldest] = index;
+		}
+		else {
+			_newest = index;
+		}
+		_oldest = index;
+	}
+};
@@ -0,0 +1,178 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Median of a full window of 2 * HalfWindowSize + 1 values, updated one value at a time.
+ *
+ * The window is a ring of values, and a heap of ring indices with the median in the center:
+ * a max heap of the smaller values on the left, and a min heap of the larger values on the right.
+ * Each push replaces the oldest value of the ring by a new value, and restores the heap order
+ * by moving that value up or down: O(log n) per push.
+ */
+template <class T, uint16_t HalfWindowSize>
+class SlidingWindowMedian {
+public:
+	static_assert(HalfWindowSize > 0, "Window should have more than 1 value.");
+
+	static constexpr uint16_t WINDOW_SIZE = 2 * HalfWindowSize + 1;
+
+	/**
+	 * Fill the window with a single value.
+	 */
+	void reset(T value) {
+		for (uint16_t i = 0; i < WINDOW_SIZE; ++i) {
+			_values[i] = value;
+			// Alternate between min and max heap: 0, 1, -1, 2, -2, ..
+			int16_t position           = (i + 1) / 2;
+			_position[i]               = (i & 1) ? position : -position;
+			_heap[HALF + _position[i]] = i;
+		}
+		_oldest = 0;
+	}
+
+	/**
+	 * Replace the oldest value with a new value.
+	 */
+	void push(T value) {
+		uint16_t index   = _oldest;
+		T oldValue       = _values[index];
+		int16_t position = _position[index];
+		_values[index]   = value;
+		_oldest          = (_oldest + 1 == WINDOW_SIZE) ? 0 : _oldest + 1;
+
+		if (position > 0) {
+			// In the min heap.
+			if (oldValue < value) {
+				minHeapSortDown(position * 2);
+			}
+			else if (minHeapSortUp(position)) {
+				maxHeapSortDown(-1);
+			}
+		}
+		else if (position < 0) {
+			// In the max heap.
+			if (value < oldValue) {
+				maxHeapSortDown(position * 2);
+			}
+			else if (maxHeapSortUp(position)) {
+				minHeapSortDown(1);
+			}
+		}
+		else {
+			// At the median.
+			maxHeapSortDown(-1);
+			minHeapSortDown(1);
+		}
+	}
+
+	T median() const { return _values[_heap[HALF]]; }
+
+	/**
+	 * Get a value of the window, index 0 is the oldest value.
+	 */
+	T operator[](uint16_t index) const {
+		index += _oldest;
+		return _values[index < WINDOW_SIZE ? index : index - WINDOW_SIZE];
+	}
+
+private:
+	static constexpr int16_t HALF = HalfWindowSize;
+
+	/**
+	 * The window values, in order of arrival.
+	 */
+	T _values[WINDOW_SIZE];
+
+	/**
+	 * Index of the oldest value in _values.
+	 */
+	uint16_t _oldest = 0;
+
+	/**
+	 * Heap of indices into _values, with the median at index HALF.
+	 * Max heap at HALF - 1, HALF - 2, ..: children of HALF - n are at HALF - 2n and HALF - 2n - 1.
+	 * Min heap at HALF + 1, HALF + 2, ..: children of HALF + n are at HALF + 2n and HALF + 2n + 1.
+	 */
+	uint16_t _heap[WINDOW_SIZE];
+
+	/**
+	 * Position in the heap, relative to the median, of each index in _values.
+	 */
+	int16_t _position[WINDOW_SIZE];
+
+	bool less(int16_t position1, int16_t position2) const {
+		return _values[_heap[HALF + position1]] < _values[_heap[HALF + position2]];
+	}
+
+	void swap(int16_t position1, int16_t position2) {
+		uint16_t index1         = _heap[HALF + position1];
+		uint16_t index2         = _heap[HALF + position2];
+		_heap[HALF + position1] = index2;
+		_heap[HALF + position2] = index1;
+		_position[index1]       = position2;
+		_position[index2]       = position1;
+	}
+
+	/**
+	 * Swap when the value at position1 is smaller than the value at position2.
+	 */
+	bool swapIfLess(int16_t position1, int16_t position2) {
+		if (less(position1, position2)) {
+			swap(position1, position2);
+			return true;
+		}
+		return false;
+	}
+
+	/**
+	 * Move the value at the given child position down the min heap, starting with comparing it to its parent.
+	 * Parent of the top of the min heap is the median.
+	 */
+	void minHeapSortDown(int16_t position) {
+		for (; position <= HALF; position *= 2) {
+			if (position > 1 && position < HALF && less(position + 1, position)) {
+				++position;
+			}
+			if (!swapIfLess(position, position / 2)) {
+				break;
+			}
+		}
+	}
+
+	void maxHeapSortDown(int16_t position) {
+		for (; position >= -HALF; position *= 2) {
+			if (position < -1 && position > -HALF && less(position, position - 1)) {
+				--position;
+			}
+			if (!swapIfLess(position / 2, position)) {
+				break;
+			}
+		}
+	}
+
+	/**
+	 * Move the value at the given position up the min heap.
+	 *
+	 * @return true when it ended up at the median.
+	 */
+	bool minHeapSortUp(int16_t position) {
+		while (position > 0 && swapIfLess(position, position / 2)) {
+			position /= 2;
+		}
+		return position == 0;
+	}
+
+	bool maxHeapSortUp(int16_t position) {
+		while (position < 0 && swapIfLess(position / 2, position)) {
+			position /= 2;
+		}
+		return position == 0;
+	}
+};
@@ -7,9 +7,9 @@
 
 #pragma once
 
+#include <cstdint>
 #include <type_traits>
-
-#include <logging/cs_Logger.h>
+#include <utility>
 
 
 /**
@@ -22,6 +22,7 @@
  *
  * furthermore it must be default constructible.
  *
+ * See IndexedStore for a variant with an index on the id.
  */
 template <class Rec, unsigned int Size>
 class Store {
@@ -51,7 +52,7 @@ public:
 	 *  - remove_reference to avoid complications
 	 *  - decltype doesn't dereference the nullptr
 	 */
-	typedef typename std::remove_reference<decltype(((Rec*)nullptr)->id())>::type IdType;
+	typedef typename std::remove_reference<decltype(std::declval<Rec&>().id())>::type IdType;
 
 
 	/**
@@ -108,7 +109,7 @@ public:
 	 */
 	template<class ValueFunction>
 	constexpr Rec* getMin(ValueFunction getValue) {
-		Rec* smallest = get([] (auto rec) { return rec.isValid();});
+		Rec* smallest = get([] (auto& rec) { return rec.isValid();});
 
 		if(smallest == nullptr){
 			return nullptr;
@@ -200,7 +201,7 @@ public:
 	 * returns number of valid elements.
 	 */
 	constexpr uint16_t count() {
-		return countIf([](auto& rec) { rec.isValid(); });
+		return countIf([](auto& rec) { return rec.isValid(); });
 	}
 
 
@@ -0,0 +1,207 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+/**
+ * Statistics of the timer wheel.
+ */
+struct __attribute__((packed)) cs_timer_wheel_stats_t {
+	uint32_t numTicks     = 0; // Number of ticks processed.
+	uint32_t numIdleTicks = 0; // Number of ticks at which no timer expired.
+	uint32_t numCalls     = 0; // Number of timer actions called.
+	uint32_t numCascades  = 0; // Number of timers moved to a lower level.
+};
+
+/**
+ * Node of a doubly linked, circular list.
+ *
+ * Each slot of the wheel has an empty node as list head, so that a timer can be removed without knowing its slot.
+ */
+struct timer_wheel_link_t {
+	timer_wheel_link_t* next = this;
+	timer_wheel_link_t* prev = this;
+
+	timer_wheel_link_t() = default;
+	timer_wheel_link_t(const timer_wheel_link_t&) = delete;
+	timer_wheel_link_t& operator=(const timer_wheel_link_t&) = delete;
+
+	bool isLinked() const {
+		return next != this;
+	}
+
+	void unlink() {
+		prev->next = next;
+		next->prev = prev;
+		next = this;
+		prev = this;
+	}
+
+	void linkBefore(timer_wheel_link_t* node) {
+		next       = node;
+		prev       = node->prev;
+		prev->next = this;
+		node->prev = this;
+	}
+};
+
+/**
+ * A timer that can be started on the timer wheel.
+ *
+ * Should not be copied or moved, as it's linked into the wheel.
+ */
+class WheelTimer: private timer_wheel_link_t {
+public:
+	/**
+	 * Function that returns the number of ticks until it should be called again, or 0 to stop the timer.
+	 */
+	typedef std::function<uint32_t(void)> Action;
+
+	Action action;
+
+	WheelTimer() = default;
+	WheelTimer(Action a) : action(a) {}
+
+	~WheelTimer() {
+		unlink();
+	}
+
+	/**
+	 * Whether the timer is started.
+	 */
+	bool isStarted() const {
+		return isLinked();
+	}
+
+	/**
+	 * Tick count at which the action will be called, only valid when started.
+	 */
+	uint32_t getExpiryTickCount() const {
+		return _expiryTickCount;
+	}
+
+private:
+	friend class TimerWheel;
+
+	uint32_t _expiryTickCount = 0;
+};
+
+/**
+ * Hierarchical timer wheel, driven by the tick of the main loop.
+ *
+ * Components start timers with a delay in ticks, instead of each listening to every tick event. Each tick, only the
+ * timers that expire are called.
+ *
+ * The wheel has LEVELS levels of SLOTS slots. A slot of level 0 is 1 tick, a slot of each next level covers a whole
+ * rotation of the level below. Timers are placed at the lowest level that reaches their expiry tick count, and are
+ * moved a level down when the level below arrives at their slot. Timers that expire further away than the top level
+ * reaches, are placed at the last slot of the top level, and placed again when that slot is reached.
+ *
+ * Handles the tick count rolling over.
+ *
+ * Not thread safe: start, stop and advance from the main thread.
+ */
+class TimerWheel {
+public:
+	static TimerWheel& getInstance();
+
+	/**
+	 * Number of bits of the slot index: each level has 2^SLOT_BITS slots.
+	 */
+	static constexpr uint8_t SLOT_BITS = 5;
+	static constexpr uint8_t SLOTS     = 1 << SLOT_BITS;
+
+	/**
+	 * Number of levels. With 3 levels of 32 slots, timers up to 32768 ticks (54 minutes) are placed directly.
+	 */
+	static constexpr uint8_t LEVELS = 3;
+
+	/**
+	 * Start a timer, or restart it when it was started already.
+	 *
+	 * @param[in] timer          The timer.
+	 * @param[in] delayTicks     Number of ticks after which the action is called. 0 is treated as 1: the next tick.
+	 */
+	void start(WheelTimer& timer, uint32_t delayTicks);
+
+	/**
+	 * Stop a timer. Does nothing when it was not started.
+	 */
+	void stop(WheelTimer& timer);
+
+	/**
+	 * Process all ticks up to and including the given tick count: call the actions of the expired timers.
+	 *
+	 * @param[in] tickCount      Current tick count.
+	 */
+	void advance(uint32_t tickCount);
+
+	/**
+	 * Get the tick count up to which ticks have been processed.
+	 */
+	uint32_t getTickCount() const;
+
+	/**
+	 * Get the number of ticks until the first timer expires.
+	 *
+	 * Only exact for the lowest level: for timers at higher levels, the start of their slot is returned. So the result
+	 * can be earlier, but never later than the actual expiry.
+	 *
+	 * @return                   Number of ticks, or 0xFFFFFFFF when no timer is started.
+	 */
+	uint32_t getTicksUntilNextExpiry() const;
+
+	const cs_timer_wheel_stats_t& getStats() const;
+
+	/**
+	 * @param[in] tickCount      Tick count to start at: the first tick processed will be this + 1.
+	 */
+	explicit TimerWheel(uint32_t tickCount = 0) : _tickCount(tickCount) {}
+	TimerWheel(const TimerWheel&) = delete;
+	TimerWheel& operator=(const TimerWheel&) = delete;
+
+private:
+	timer_wheel_link_t _slots[LEVELS][SLOTS];
+
+	/**
+	 * Last processed tick count.
+	 */
+	uint32_t _tickCount = 0;
+
+	cs_timer_wheel_stats_t _stats;
+
+	/**
+	 * Put a started timer in its slot, relative to the current tick count.
+	 */
+	void place(WheelTimer& timer);
+
+	/**
+	 * Place all timers of a slot again.
+	 */
+	void cascade(uint8_t level, uint8_t slot);
+
+	/**
+	 * Process a single tick.
+	 */
+	void processTick();
+
+	static uint8_t getSlot(uint32_t tickCount, uint8_t level) {
+		return (tickCount >> (level * SLOT_BITS)) & (SLOTS - 1);
+	}
+
+	/**
+	 * Number of slots of given level between the two tick counts, taking roll over into account.
+	 */
+	static uint32_t getSlotDistance(uint32_t fromTickCount, uint32_t toTickCount, uint8_t level) {
+		uint8_t shift = level * SLOT_BITS;
+		uint32_t mask = 0xFFFFFFFF >> shift;
+		return ((toTickCount >> shift) - (fromTickCount >> shift)) & mask;
+	}
+};
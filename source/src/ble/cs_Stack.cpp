@@ -525,6 +525,7 @@ void csStackOnScan(const ble_gap_evt_adv_report_t* advReport) {
 	scan.resolvedPrivateAddress = advReport->peer_addr.addr_id_peer;
 	scan.addressType = advReport->peer_addr.addr_type;
 	scan.rssi = advReport->rssi;
+	scan.rssiAverage = advReport->rssi;
 	scan.channel = advReport->ch_index;
 	scan.dataSize = advReport->data.len;
 	scan.data = advReport->data.p_data;
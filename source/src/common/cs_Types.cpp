@@ -177,6 +177,7 @@ CS_TYPE toCsType(uint16_t type) {
 	case CS_TYPE::CMD_RESET_DELAYED:
 	case CS_TYPE::CMD_ENABLE_ADVERTISEMENT:
 	case CS_TYPE::CMD_ENABLE_MESH:
+	case CS_TYPE::CMD_GET_MESH_STATS:
 	case CS_TYPE::CMD_TOGGLE_ADC_VOLTAGE_VDD_REFERENCE_PIN:
 	case CS_TYPE::CMD_ENABLE_ADC_DIFFERENTIAL_CURRENT:
 	case CS_TYPE::CMD_ENABLE_ADC_DIFFERENTIAL_VOLTAGE:
@@ -232,6 +233,7 @@ CS_TYPE toCsType(uint16_t type) {
 	case CS_TYPE::CMD_GET_GPREGRET:
 	case CS_TYPE::CMD_GET_ADC_CHANNEL_SWAPS:
 	case CS_TYPE::CMD_GET_RAM_STATS:
+	case CS_TYPE::CMD_GET_BOOT_TIMINGS:
 	case CS_TYPE::EVT_GENERIC_TEST:
 	case CS_TYPE::CMD_TEST_SET_TIME:
 	case CS_TYPE::CMD_MICROAPP_GET_INFO:
@@ -590,6 +592,8 @@ size16_t TypeSize(CS_TYPE const & type) {
 		return sizeof(TYPIFY(CMD_ENABLE_ADVERTISEMENT));
 	case CS_TYPE::CMD_ENABLE_MESH:
 		return sizeof(TYPIFY(CMD_ENABLE_MESH));
+	case CS_TYPE::CMD_GET_MESH_STATS:
+		return 0;
 	case CS_TYPE::CMD_TOGGLE_ADC_VOLTAGE_VDD_REFERENCE_PIN:
 		return 0;
 	case CS_TYPE::CMD_ENABLE_ADC_DIFFERENTIAL_CURRENT:
@@ -712,6 +716,8 @@ size16_t TypeSize(CS_TYPE const & type) {
 		return 0;
 	case CS_TYPE::CMD_GET_RAM_STATS:
 		return 0;
+	case CS_TYPE::CMD_GET_BOOT_TIMINGS:
+		return 0;
 	case CS_TYPE::EVT_GENERIC_TEST:
 		return 0;
 	case CS_TYPE::CMD_TEST_SET_TIME:
@@ -911,6 +917,7 @@ bool hasMultipleIds(CS_TYPE const & type) {
 	case CS_TYPE::CMD_RESET_DELAYED:
 	case CS_TYPE::CMD_ENABLE_ADVERTISEMENT:
 	case CS_TYPE::CMD_ENABLE_MESH:
+	case CS_TYPE::CMD_GET_MESH_STATS:
 	case CS_TYPE::CMD_TOGGLE_ADC_VOLTAGE_VDD_REFERENCE_PIN:
 	case CS_TYPE::CMD_ENABLE_ADC_DIFFERENTIAL_CURRENT:
 	case CS_TYPE::CMD_ENABLE_ADC_DIFFERENTIAL_VOLTAGE:
@@ -972,6 +979,7 @@ bool hasMultipleIds(CS_TYPE const & type) {
 	case CS_TYPE::CMD_GET_GPREGRET:
 	case CS_TYPE::CMD_GET_ADC_CHANNEL_SWAPS:
 	case CS_TYPE::CMD_GET_RAM_STATS:
+	case CS_TYPE::CMD_GET_BOOT_TIMINGS:
 	case CS_TYPE::EVT_GENERIC_TEST:
 	case CS_TYPE::CMD_TEST_SET_TIME:
 	case CS_TYPE::CMD_MICROAPP_GET_INFO:
@@ -1180,6 +1188,7 @@ bool removeOnFactoryReset(CS_TYPE const & type, cs_state_id_t id) {
 	case CS_TYPE::CMD_RESET_DELAYED:
 	case CS_TYPE::CMD_ENABLE_ADVERTISEMENT:
 	case CS_TYPE::CMD_ENABLE_MESH:
+	case CS_TYPE::CMD_GET_MESH_STATS:
 	case CS_TYPE::CMD_TOGGLE_ADC_VOLTAGE_VDD_REFERENCE_PIN:
 	case CS_TYPE::CMD_ENABLE_ADC_DIFFERENTIAL_CURRENT:
 	case CS_TYPE::CMD_ENABLE_ADC_DIFFERENTIAL_VOLTAGE:
@@ -1241,6 +1250,7 @@ bool removeOnFactoryReset(CS_TYPE const & type, cs_state_id_t id) {
 	case CS_TYPE::CMD_GET_GPREGRET:
 	case CS_TYPE::CMD_GET_ADC_CHANNEL_SWAPS:
 	case CS_TYPE::CMD_GET_RAM_STATS:
+	case CS_TYPE::CMD_GET_BOOT_TIMINGS:
 	case CS_TYPE::EVT_GENERIC_TEST:
 	case CS_TYPE::CMD_TEST_SET_TIME:
 	case CS_TYPE::CMD_MICROAPP_GET_INFO:
@@ -1362,6 +1372,7 @@ EncryptionAccessLevel getUserAccessLevelSet(CS_TYPE const & type)  {
 	case CS_TYPE::CMD_ENABLE_LOG_POWER:
 	case CS_TYPE::CMD_ENABLE_LOG_VOLTAGE:
 	case CS_TYPE::CMD_ENABLE_MESH:
+	case CS_TYPE::CMD_GET_MESH_STATS:
 	case CS_TYPE::CMD_FACTORY_RESET:
 	case CS_TYPE::CMD_INC_CURRENT_RANGE:
 	case CS_TYPE::CMD_INC_VOLTAGE_RANGE:
@@ -1494,6 +1505,7 @@ EncryptionAccessLevel getUserAccessLevelSet(CS_TYPE const & type)  {
 	case CS_TYPE::CMD_GET_GPREGRET:
 	case CS_TYPE::CMD_GET_ADC_CHANNEL_SWAPS:
 	case CS_TYPE::CMD_GET_RAM_STATS:
+	case CS_TYPE::CMD_GET_BOOT_TIMINGS:
 	case CS_TYPE::EVT_GENERIC_TEST:
 	case CS_TYPE::CMD_TEST_SET_TIME:
 	case CS_TYPE::CMD_MICROAPP_GET_INFO:
@@ -1615,6 +1627,7 @@ EncryptionAccessLevel getUserAccessLevelGet(CS_TYPE const & type) {
 	case CS_TYPE::CMD_ENABLE_LOG_POWER:
 	case CS_TYPE::CMD_ENABLE_LOG_VOLTAGE:
 	case CS_TYPE::CMD_ENABLE_MESH:
+	case CS_TYPE::CMD_GET_MESH_STATS:
 	case CS_TYPE::CMD_FACTORY_RESET:
 	case CS_TYPE::CMD_INC_CURRENT_RANGE:
 	case CS_TYPE::CMD_INC_VOLTAGE_RANGE:
@@ -1747,6 +1760,7 @@ EncryptionAccessLevel getUserAccessLevelGet(CS_TYPE const & type) {
 	case CS_TYPE::CMD_GET_GPREGRET:
 	case CS_TYPE::CMD_GET_ADC_CHANNEL_SWAPS:
 	case CS_TYPE::CMD_GET_RAM_STATS:
+	case CS_TYPE::CMD_GET_BOOT_TIMINGS:
 	case CS_TYPE::EVT_GENERIC_TEST:
 	case CS_TYPE::CMD_TEST_SET_TIME:
 	case CS_TYPE::CMD_MICROAPP_GET_INFO:
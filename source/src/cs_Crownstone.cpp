@@ -42,6 +42,7 @@
 #include <drivers/cs_PWM.h>
 #include <drivers/cs_RNG.h>
 #include <drivers/cs_RTC.h>
+#include <drivers/cs_Serial.h>
 #include <drivers/cs_Temperature.h>
 #include <drivers/cs_Timer.h>
 #include <drivers/cs_Watchdog.h>
@@ -56,6 +57,7 @@
 #include <structs/buffer/cs_EncryptionBuffer.h>
 #include <time/cs_SystemTime.h>
 #include <uart/cs_UartHandler.h>
+#include <util/cs_TimerWheel.h>
 #include <util/cs_Utils.h>
 
 extern "C" {
@@ -294,6 +296,8 @@ void Crownstone::init1() {
 	LOGi(FMT_HEADER, "init microapp");
 	_microapp->init();
 #endif
+
+	_bootTimings.configure = nextBootPhase();
 }
 
 void Crownstone::initDrivers(uint16_t step) {
@@ -316,6 +320,10 @@ void Crownstone::initDrivers0() {
 	_timer->init();
 	_stack->initSoftdevice();
 
+	// The RTC only runs once the SoftDevice is enabled.
+	_bootStartCount = RTC::getCount();
+	_bootPhaseStartCount = _bootStartCount;
+
 #if BUILD_MESHING == 1 && MESH_PERSISTENT_STORAGE == 1
 	// Check if flash pages of mesh are valid, else erase them.
 	// This has to be done before Storage is initialized.
@@ -340,7 +348,10 @@ void Crownstone::initDrivers0() {
 }
 
 void Crownstone::initDrivers1() {
+	_bootTimings.storageInit = nextBootPhase();
 	_state->init(&_boardsConfig);
+	_bootTimings.stateLoad = nextBootPhase();
+	_bootTimings.stateRecords = _state->getNumLoadedValues();
 
 	// If not done already, init UART
 	// TODO: make into a class with proper init() function
@@ -432,6 +443,15 @@ void Crownstone::initDrivers1() {
 #if BUILD_GPIOTE == 1
 	_gpio->init(_boardsConfig);
 #endif
+
+	_bootTimings.driversInit = nextBootPhase();
+}
+
+uint32_t Crownstone::nextBootPhase() {
+	uint32_t count = RTC::getCount();
+	uint32_t durationUs = RTC::ticksToUs(RTC::difference(count, _bootPhaseStartCount));
+	_bootPhaseStartCount = count;
+	return durationUs;
 }
 
 void Crownstone::configure() {
@@ -663,6 +683,14 @@ void Crownstone::startUp() {
 
 	if (IS_CROWNSTONE(_boardsConfig.deviceType)) {
 		_switchAggregator.switchPowered();
+		_bootTimings.switchReady = RTC::ticksToUs(RTC::difference(RTC::getCount(), _bootStartCount));
+		LOGi("Boot timings [us]: storage=%u state=%u (%u values) drivers=%u configure=%u switchReady=%u",
+				_bootTimings.storageInit,
+				_bootTimings.stateLoad,
+				_bootTimings.stateRecords,
+				_bootTimings.driversInit,
+				_bootTimings.configure,
+				_bootTimings.switchReady);
 
 		//! Start temperature guard regardless of operation mode
 		LOGi(FMT_START, "temp guard");
@@ -771,6 +799,9 @@ void Crownstone::tick() {
 
 	Watchdog::kick();
 
+	// Call the timers that are due, before the components that still handle every tick.
+	TimerWheel::getInstance().advance(_tickCount);
+
 	event_t event(CS_TYPE::EVT_TICK, &_tickCount, sizeof(_tickCount));
 	event.dispatch();
 	++_tickCount;
@@ -827,11 +858,15 @@ void Crownstone::handleEvent(event_t & event) {
 //			_setStateValuesAfterStorageRecover = true;
 //			// Wait for storage initialized event.
 			GpRegRet::setFlag(GpRegRet::FLAG_STORAGE_RECOVERED);
+			LOG_FLUSH();
+			serial_flush();
 			sd_nvic_SystemReset();
 			break;
 		}
 		case CS_TYPE::EVT_MESH_PAGES_ERASED: {
 			LOGi("Mesh pages erased, reboot");
+			LOG_FLUSH();
+			serial_flush();
 			sd_nvic_SystemReset();
 			break;
 		}
@@ -889,6 +924,17 @@ void Crownstone::handleEvent(event_t & event) {
 			event.result.returnCode = ERR_SUCCESS;
 			break;
 		}
+		case CS_TYPE::CMD_GET_BOOT_TIMINGS: {
+			LOGi("Get boot timings");
+			if (event.result.buf.len < sizeof(_bootTimings)) {
+				event.result.returnCode = ERR_BUFFER_TOO_SMALL;
+				break;
+			}
+			memcpy(event.result.buf.data, &_bootTimings, sizeof(_bootTimings));
+			event.result.dataSize = sizeof(_bootTimings);
+			event.result.returnCode = ERR_SUCCESS;
+			break;
+		}
 		default:
 			LOGnone("Event: $typeName(%u)", to_underlying_type(event.type));
 	}
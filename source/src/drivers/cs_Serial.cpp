@@ -7,6 +7,7 @@
 
 #include <drivers/cs_Serial.h>
 #include <ble/cs_Nordic.h>
+#include <structs/buffer/cs_SerialTxRing.h>
 
 
 static uint8_t _pinRx = 0;
@@ -18,6 +19,14 @@ static bool _initializedTx = false;
 static serial_enable_t _state = SERIAL_ENABLE_NONE;
 static serial_read_callback _readCallback = NULL;
 
+#if SERIAL_VERBOSITY > SERIAL_READ_ONLY
+// Bytes to be sent, written by serial_write(), and sent by the UART interrupt.
+static SerialTxRing<CS_SERIAL_TX_BUFFER_SIZE> _txRing;
+
+// Whether a byte is being sent, so that the next byte will be sent on the TXDRDY event.
+static volatile bool _txBusy = false;
+#endif
+
 void serial_config(uint8_t pinRx, uint8_t pinTx) {
 	_pinRx = pinRx;
 	_pinTx = pinTx;
@@ -120,6 +129,9 @@ void init_tx() {
 	// Start TX
 	NRF_UART0->TASKS_STARTTX = 1;
 	NRF_UART0->EVENTS_TXDRDY = 0;
+
+	// Enable TX ready interrupts: the next byte is sent from the interrupt.
+	NRF_UART0->INTENSET = UART_INTENSET_TXDRDY_Msk;
 }
 
 void deinit_tx() {
@@ -128,9 +140,18 @@ void deinit_tx() {
 	}
 	_initializedTx = false;
 
+	// Disable interrupt
+	NRF_UART0->INTENCLR = UART_INTENSET_TXDRDY_Msk;
+
 	// Stop TX
 	NRF_UART0->TASKS_STOPTX = 1;
 	NRF_UART0->EVENTS_TXDRDY = 0;
+
+#if SERIAL_VERBOSITY > SERIAL_READ_ONLY
+	// Discard what wasn't sent.
+	_txRing.clear();
+	_txBusy = false;
+#endif
 }
 
 void serial_init(serial_enable_t enabled) {
@@ -178,38 +199,165 @@ bool serial_tx_ready() {
 	return _initializedTx;
 }
 
-inline void _serial_write(uint8_t val) {
 #if SERIAL_VERBOSITY > SERIAL_READ_ONLY
-//	if (_initializedTx) { // Check this in functions that call this function.
-		NRF_UART0->EVENTS_TXDRDY = 0;
-		NRF_UART0->TXD = val;
-		while (NRF_UART0->EVENTS_TXDRDY != 1) {}
-//	}
-#endif
+/**
+ * Send the next byte of the TX buffer, if any.
+ *
+ * Called from the UART interrupt, or with the UART interrupt blocked.
+ */
+static void tx_next() {
+	const uint8_t* data;
+	if (_txRing.peek(data) == 0) {
+		_txBusy = false;
+		return;
+	}
+	_txBusy = true;
+	NRF_UART0->TXD = *data;
+	_txRing.pop(1);
+}
+
+/**
+ * Handle the TX ready event, if it's there.
+ *
+ * Called from the UART interrupt, or with the UART interrupt blocked.
+ */
+static void tx_handle_event() {
+	if (nrf_uart_event_check(NRF_UART0, NRF_UART_EVENT_TXDRDY)) {
+		nrf_uart_event_clear(NRF_UART0, NRF_UART_EVENT_TXDRDY);
+		tx_next();
+	}
 }
 
+/**
+ * Wait for the current byte to be sent, and send the next one.
+ *
+ * Does the work of the interrupt, so that this also works when called from an interrupt with the same or higher priority.
+ */
+static void tx_wait() {
+	CRITICAL_REGION_ENTER();
+	if (_txBusy) {
+		while (!nrf_uart_event_check(NRF_UART0, NRF_UART_EVENT_TXDRDY)) {}
+		tx_handle_event();
+	}
+	CRITICAL_REGION_EXIT();
+}
 
+/**
+ * Write bytes to the TX buffer, and start sending when not busy.
+ *
+ * @param[in] drop      Whether to drop the bytes that don't fit.
+ * @return              Number of bytes written.
+ */
+static uint16_t tx_write(const uint8_t* data, uint16_t size, bool drop) {
+	uint16_t written;
+	CRITICAL_REGION_ENTER();
+	uint16_t freeSize = _txRing.free();
+	written = _txRing.write(data, (drop || size < freeSize) ? size : freeSize);
+	if (!_txBusy) {
+		tx_next();
+	}
+	CRITICAL_REGION_EXIT();
+	return written;
+}
+#endif
 
+void serial_write(uint8_t val) {
+	serial_write_buffer(&val, 1);
+}
 
+void serial_write_buffer(const uint8_t* data, uint16_t size) {
+#if SERIAL_VERBOSITY > SERIAL_READ_ONLY
+	if (!_initializedTx) {
+		return;
+	}
+#if CS_SERIAL_TX_BLOCK_WHEN_FULL == 1
+	while (true) {
+		uint16_t written = tx_write(data, size, false);
+		data += written;
+		size -= written;
+		if (size == 0) {
+			return;
+		}
+		tx_wait();
+	}
+#else
+	tx_write(data, size, true);
+#endif
+#endif
+}
 
+bool serial_tx_reserve(uint16_t size) {
+#if SERIAL_VERBOSITY > SERIAL_READ_ONLY
+	if (!_initializedTx) {
+		return false;
+	}
+#if CS_SERIAL_TX_BLOCK_WHEN_FULL == 1
+	// Larger writes will block halfway anyway.
+	if (size > CS_SERIAL_TX_BUFFER_SIZE) {
+		size = CS_SERIAL_TX_BUFFER_SIZE;
+	}
+	while (_txRing.free() < size) {
+		tx_wait();
+	}
+	return true;
+#else
+	bool fits;
+	CRITICAL_REGION_ENTER();
+	fits = _txRing.free() >= size;
+	if (!fits) {
+		_txRing.drop(size);
+	}
+	CRITICAL_REGION_EXIT();
+	return fits;
+#endif
+#else
+	return false;
+#endif
+}
 
-void serial_write(uint8_t val) {
+void serial_flush() {
 #if SERIAL_VERBOSITY > SERIAL_READ_ONLY
-	// TODO: that's an if for every byte we write.
 	if (!_initializedTx) {
 		return;
 	}
-	_serial_write(val);
+	CRITICAL_REGION_ENTER();
+	while (_txBusy) {
+		tx_wait();
+	}
+	CRITICAL_REGION_EXIT();
 #endif
 }
 
+uint16_t serial_tx_free() {
+#if SERIAL_VERBOSITY > SERIAL_READ_ONLY
+	if (!_initializedTx) {
+		return 0;
+	}
+	return _txRing.free();
+#else
+	return 0;
+#endif
+}
 
+uint32_t serial_get_tx_dropped_bytes() {
+#if SERIAL_VERBOSITY > SERIAL_READ_ONLY
+	return _txRing.getDroppedBytes();
+#else
+	return 0;
+#endif
+}
 
 #if CS_SERIAL_NRF_LOG_ENABLED != 2
 static uint8_t readByte;
 
 // UART interrupt handler
 extern "C" void UART0_IRQHandler(void) {
+#if SERIAL_VERBOSITY > SERIAL_READ_ONLY
+	if (nrf_uart_int_enable_check(NRF_UART0, NRF_UART_INT_MASK_TXDRDY)) {
+		tx_handle_event();
+	}
+#endif
+
 	if (NRF_UART0->EVENTS_ERROR && nrf_uart_int_enable_check(NRF_UART0, NRF_UART_INT_MASK_ERROR)) {
 //		nrf_uart_event_clear(NRF_UART0, NRF_UART_EVENT_ERROR);
 		// TODO: disable rx and error interrupts, stop UART, call nrf_uart_errorsrc_get_and_clear().
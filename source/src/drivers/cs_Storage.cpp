@@ -149,6 +149,7 @@ cs_ret_code_t Storage::read(cs_state_data_t & stateData) {
 		csRetCode = readRecord(recordDesc, stateData.value, stateData.size, fileId);
 		if (csRetCode == ERR_SUCCESS) {
 			done = true;
+			_recordCache.set(fileId, recordKey, recordDesc);
 		}
 //		if (done) {
 //			break;
@@ -260,6 +261,52 @@ cs_ret_code_t Storage::readNextInternal(uint16_t recordKey, uint16_t & fileId, u
 	return csRetCode;
 }
 
+/**
+ * Iterates over all records, instead of searching for each type.
+ */
+cs_ret_code_t Storage::readAll(cs_storage_read_callback_t callback) {
+	if (!_initialized) {
+		LOGe(STR_ERR_NOT_INITIALIZED);
+		return ERR_NOT_INITIALIZED;
+	}
+	if (callback == nullptr) {
+		return ERR_WRONG_PARAMETER;
+	}
+	if (isBusy()) {
+		return ERR_BUSY;
+	}
+	fds_record_desc_t recordDesc;
+	fds_flash_record_t flashRecord;
+	initSearch();
+	while (fds_record_iterate(&recordDesc, &_findToken) == NRF_SUCCESS) {
+		ret_code_t fdsRetCode = fds_record_open(&recordDesc, &flashRecord);
+		if (fdsRetCode != NRF_SUCCESS) {
+			LOGw("Failed to open record addr=%p err=%u", recordDesc.p_record, fdsRetCode);
+			continue;
+		}
+		uint16_t recordKey = flashRecord.p_header->record_key;
+		uint16_t fileId = flashRecord.p_header->file_id;
+		// Values are stored in files starting at FILE_CONFIGURATION, other files are not from State.
+		bool isValue = isValidRecordKey(recordKey) && isValidFileId(fileId) && fileId >= FILE_CONFIGURATION;
+		if (isValue) {
+			cs_state_data_t stateData(
+					CS_TYPE(recordKey),
+					getStateId(fileId),
+					(uint8_t*)flashRecord.p_data,
+					flashRecord.p_header->length_words << 2);
+			callback(stateData);
+		}
+		if (fds_record_close(&recordDesc) != NRF_SUCCESS) {
+			LOGe("Error on closing record");
+		}
+		if (isValue) {
+			// Later duplicates overwrite earlier ones, so the latest record ends up in the cache.
+			_recordCache.set(fileId, recordKey, recordDesc);
+		}
+	}
+	return ERR_SUCCESS;
+}
+
 cs_ret_code_t Storage::readRecord(fds_record_desc_t recordDesc, uint8_t* buf, uint16_t size, uint16_t & fileId) {
 	fds_flash_record_t flashRecord;
 	ret_code_t fdsRetCode = fds_record_open(&recordDesc, &flashRecord);
@@ -299,6 +346,110 @@ cs_ret_code_t Storage::write(const cs_state_data_t & stateData) {
 	return getErrorCode(writeInternal(stateData));
 }
 
+void Storage::beginCommitGroup() {
+	_collectingGroup = true;
+}
+
+cs_ret_code_t Storage::commitGroup() {
+	_collectingGroup = false;
+	if (_group.empty()) {
+		return ERR_SUCCESS;
+	}
+	_stats.getTotals().groups++;
+	LOGStorageDebug("Commit group of %u writes", _group.size());
+
+	for (auto& item : _group) {
+		uint16_t recordKey = to_underlying_type(item.data.type);
+		uint16_t fileId    = getFileId(item.data.id);
+		item.found         = _recordCache.get(fileId, recordKey, item.recordDesc);
+		item.recordExists  = item.found;
+		if (item.found) {
+			_stats.getTotals().cacheHits++;
+		}
+		else {
+			_stats.getTotals().cacheMisses++;
+		}
+	}
+	findGroupRecords();
+
+	cs_ret_code_t result = ERR_SUCCESS;
+	for (auto& item : _group) {
+		uint16_t recordKey    = to_underlying_type(item.data.type);
+		// Garbage collection may have been started by a previous write in this group.
+		ret_code_t fdsRetCode = FDS_ERR_BUSY;
+		if (!isBusy(recordKey)) {
+			fdsRetCode = writeRecord(item.data, item.recordDesc, item.recordExists);
+		}
+		else {
+			_stats.addBusy(recordKey);
+		}
+		if (fdsRetCode != NRF_SUCCESS) {
+			result = ERR_BUSY;
+			if (_errorCallback) {
+				_errorCallback(CS_STORAGE_OP_WRITE, item.data.type, item.data.id);
+			}
+		}
+	}
+	_group.clear();
+	return result;
+}
+
+void Storage::findGroupRecords() {
+	cs_storage_group_item_t* missed = nullptr;
+	uint16_t numMissed              = 0;
+	for (auto& item : _group) {
+		if (!item.found) {
+			missed = &item;
+			numMissed++;
+		}
+	}
+	if (numMissed == 0) {
+		return;
+	}
+	if (numMissed == 1) {
+		exists(getFileId(missed->data.id), to_underlying_type(missed->data.type), missed->recordDesc, missed->recordExists);
+		return;
+	}
+
+	// Look at the header of each record: it's in flash, so it can be read without opening the record.
+	_stats.getTotals().searches++;
+	fds_record_desc_t recordDesc;
+	initSearch();
+	while (fds_record_iterate(&recordDesc, &_findToken) == NRF_SUCCESS) {
+		const fds_header_t* header = reinterpret_cast<const fds_header_t*>(recordDesc.p_record);
+		for (auto& item : _group) {
+			if (item.found || header->record_key != to_underlying_type(item.data.type)
+				|| header->file_id != getFileId(item.data.id)) {
+				continue;
+			}
+			if (item.recordExists) {
+				LOGe("Duplicate record key=%u file=%u addr=%p", header->record_key, header->file_id, _findToken.p_addr);
+			}
+			// Like exists(): keep the last found record.
+			item.recordDesc   = recordDesc;
+			item.recordExists = true;
+		}
+	}
+	for (auto& item : _group) {
+		if (!item.found && item.recordExists) {
+			_recordCache.set(getFileId(item.data.id), to_underlying_type(item.data.type), item.recordDesc);
+		}
+		item.found = true;
+	}
+}
+
+void Storage::removeFromGroup(const uint16_t* recordKey, const uint16_t* fileId) {
+	for (auto it = _group.begin(); it != _group.end();) {
+		if ((recordKey == nullptr || *recordKey == to_underlying_type(it->data.type))
+			&& (fileId == nullptr || *fileId == getFileId(it->data.id))) {
+			it = _group.erase(it);
+		}
+		else {
+			++it;
+		}
+	}
+}
+
 /**
  * When the space is exhausted, write requests return the error FDS_ERR_NO_SPACE_IN_FLASH, and you must
  * run garbage collection and wait for completion before repeating the call to the write function.
@@ -314,10 +465,40 @@ ret_code_t Storage::writeInternal(const cs_state_data_t & stateData) {
 		return ERR_WRONG_PARAMETER;
 	}
 	if (isBusy(recordKey)) {
+		_stats.addBusy(recordKey);
 		return FDS_ERR_BUSY;
 	}
-	fds_record_t record;
+
+	if (_collectingGroup) {
+		for (auto& item : _group) {
+			if (item.data.type == stateData.type && item.data.id == stateData.id) {
+				item.data = stateData;
+				return NRF_SUCCESS;
+			}
+		}
+		cs_storage_group_item_t item;
+		item.data  = stateData;
+		item.found = false;
+		_group.push_back(item);
+		return NRF_SUCCESS;
+	}
+
 	fds_record_desc_t recordDesc;
+	bool recordExists = _recordCache.get(fileId, recordKey, recordDesc);
+	if (recordExists) {
+		_stats.getTotals().cacheHits++;
+	}
+	else {
+		_stats.getTotals().cacheMisses++;
+		exists(fileId, recordKey, recordDesc, recordExists);
+	}
+	return writeRecord(stateData, recordDesc, recordExists);
+}
+
+ret_code_t Storage::writeRecord(const cs_state_data_t & stateData, fds_record_desc_t & recordDesc, bool recordExists) {
+	uint16_t recordKey = to_underlying_type(stateData.type);
+	uint16_t fileId = getFileId(stateData.id);
+	fds_record_t record;
 	ret_code_t fdsRetCode;
 
 	record.file_id           = fileId;
@@ -329,8 +510,6 @@ ret_code_t Storage::writeInternal(const cs_state_data_t & stateData) {
 	LOGStorageWrite("Write key=%u file=%u", recordKey, fileId);
 	LOGStorageVerbose("Data=%p word size=%u", record.data.p_data, record.data.length_words);
 
-	bool recordExists = false;
-	fdsRetCode = exists(fileId, recordKey, recordDesc, recordExists);
 	if (recordExists) {
 		LOGStorageVerbose("Update key=%u file=%u ptr=%p", record.key, record.file_id, record.data.p_data);
 		fdsRetCode = fds_record_update(&recordDesc, &record);
@@ -342,10 +521,14 @@ ret_code_t Storage::writeInternal(const cs_state_data_t & stateData) {
 	switch (fdsRetCode) {
 		case NRF_SUCCESS:
 			setBusy(recordKey);
+			// The descriptor now refers to the new record.
+			_recordCache.set(fileId, recordKey, recordDesc);
+			_stats.addWrite(recordKey, (FDS_HEADER_SIZE + record.data.length_words) << 2);
 			LOGStorageVerbose("Started writing");
 			break;
 		case FDS_ERR_NO_SPACE_IN_FLASH: {
 			LOGStorageInfo("Flash is full, start garbage collection");
+			_stats.addBusy(recordKey);
 			ret_code_t gcRetCode = garbageCollect();
 			if (gcRetCode == NRF_SUCCESS) {
 				fdsRetCode = FDS_ERR_BUSY;
@@ -358,6 +541,7 @@ ret_code_t Storage::writeInternal(const cs_state_data_t & stateData) {
 		}
 		case FDS_ERR_NO_SPACE_IN_QUEUES:
 		case FDS_ERR_BUSY:
+			_stats.addBusy(recordKey);
 			break;
 		default:
 			LOGw("Unhandled write error: %u", fdsRetCode);
@@ -379,6 +563,8 @@ cs_ret_code_t Storage::remove(CS_TYPE type, cs_state_id_t id) {
 		return ERR_BUSY;
 	}
 	LOGStorageDebug("Remove key=%u file=%u", recordKey, fileId);
+	_recordCache.remove(fileId, recordKey);
+	removeFromGroup(&recordKey, &fileId);
 	fds_record_desc_t recordDesc;
 	ret_code_t fdsRetCode = FDS_ERR_NOT_FOUND;
 
@@ -411,6 +597,8 @@ cs_ret_code_t Storage::remove(CS_TYPE type) {
 		return ERR_BUSY;
 	}
 	LOGStorageDebug("Remove key=%u", recordKey);
+	_recordCache.removeRecordKey(recordKey);
+	removeFromGroup(&recordKey, nullptr);
 	fds_record_desc_t recordDesc;
 	ret_code_t fdsRetCode = FDS_ERR_NOT_FOUND;
 
@@ -442,6 +630,8 @@ cs_ret_code_t Storage::remove(cs_state_id_t id) {
 	if (isBusy()) {
 		return ERR_BUSY;
 	}
+	_recordCache.removeFileId(fileId);
+	removeFromGroup(nullptr, &fileId);
 	ret_code_t fdsRetCode = fds_file_delete(fileId);
 	if (fdsRetCode == NRF_SUCCESS) {
 		_removingFile = true;
@@ -458,6 +648,8 @@ cs_ret_code_t Storage::factoryReset() {
 	if (isBusy()) {
 		return ERR_BUSY;
 	}
+	_recordCache.clear();
+	_group.clear();
 	initSearch();
 	cs_ret_code_t retCode = continueFactoryReset();
 	if (retCode == ERR_SUCCESS) {
@@ -568,7 +760,11 @@ cs_ret_code_t Storage::eraseAllPages() {
 	uint32_t startAddr = endAddr - flashSizeBytes;
 
 	// Check if pages are already erased.
+#ifdef HOST_TARGET
+	const uint32_t* startAddrPointer = (const uint32_t*)HostFlash::getInstance().getPointer(startAddr, flashSizeBytes);
+#else
 	unsigned int* startAddrPointer = (unsigned int*)startAddr;
+#endif
 	bool isErased = true;
 	for (uint32_t i = 0; i < flashSizeWords; ++i) {
 		if (startAddrPointer[i] != 0xFFFFFFFF) {
@@ -582,15 +778,15 @@ cs_ret_code_t Storage::eraseAllPages() {
 		return ERR_NOT_AVAILABLE;
 	}
 
-	return erasePages(CS_TYPE::EVT_STORAGE_PAGES_ERASED, (void *)startAddr, (void *)endAddr);
+	return erasePages(CS_TYPE::EVT_STORAGE_PAGES_ERASED, (void *)(uintptr_t)startAddr, (void *)(uintptr_t)endAddr);
 }
 
 cs_ret_code_t Storage::erasePages(const CS_TYPE doneEvent, void * startAddressPtr, void * endAddressPtr) {
 	if (_initialized || isErasingPages()) {
 		return ERR_NOT_AVAILABLE;
 	}
-	unsigned int startAddr = (unsigned int)startAddressPtr;
-	unsigned int endAddr = (unsigned int)endAddressPtr;
+	unsigned int startAddr = (uintptr_t)startAddressPtr;
+	unsigned int endAddr = (uintptr_t)endAddressPtr;
 	unsigned int const pageSize = NRF_FICR->CODEPAGESIZE;
 	unsigned int startPage = startAddr / pageSize;
 	unsigned int endPage = endAddr / pageSize;
@@ -697,6 +893,7 @@ void Storage::initSearch() {
  * Returns the last found record.
  */
 ret_code_t Storage::exists(cs_file_id_t fileId, uint16_t recordKey, fds_record_desc_t & record_desc, bool & result) {
+	_stats.getTotals().searches++;
 	initSearch();
 	result = false;
 	while (fds_record_find(fileId, recordKey, &record_desc, &_findToken) == NRF_SUCCESS) {
@@ -708,6 +905,9 @@ ret_code_t Storage::exists(cs_file_id_t fileId, uint16_t recordKey, fds_record_d
 			result = true;
 		}
 	}
+	if (result) {
+		_recordCache.set(fileId, recordKey, record_desc);
+	}
 	return ERR_SUCCESS;
 }
 
@@ -787,6 +987,8 @@ void Storage::handleWriteEvent(fds_evt_t const * p_fds_evt) {
 	}
 	default:
 		LOGw("Write FDSerror=%u key=%u file=%u", p_fds_evt->result, p_fds_evt->write.record_key, p_fds_evt->write.file_id);
+		// The cached descriptor is of the record that failed to be written.
+		_recordCache.remove(p_fds_evt->write.file_id, p_fds_evt->write.record_key);
 		if (_errorCallback) {
 			_errorCallback(CS_STORAGE_OP_WRITE, eventData.type, eventData.id);
 		}
@@ -851,6 +1053,7 @@ void Storage::handleGarbageCollectionEvent(fds_evt_t const * p_fds_evt) {
 	switch (p_fds_evt->result) {
 	case NRF_SUCCESS: {
 		LOGStorageInfo("Garbage collection successful");
+		_stats.getTotals().gcRuns++;
 		if (_performingFactoryReset) {
 			_performingFactoryReset = false;
 			event_t resetEvent(CS_TYPE::EVT_STORAGE_FACTORY_RESET_DONE);
@@ -0,0 +1,74 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#include <drivers/cs_StorageRecordCache.h>
+
+#if CS_STORAGE_RECORD_CACHE_SIZE > 0
+
+bool StorageRecordCache::get(uint16_t fileId, uint16_t recordKey, fds_record_desc_t& desc) const {
+	const entry_t& entry = _entries[getIndex(fileId, recordKey)];
+	if (entry.recordKey == FDS_RECORD_KEY_DIRTY || entry.recordKey != recordKey || entry.fileId != fileId) {
+		return false;
+	}
+	desc = entry.desc;
+	return true;
+}
+
+void StorageRecordCache::set(uint16_t fileId, uint16_t recordKey, const fds_record_desc_t& desc) {
+	entry_t& entry            = _entries[getIndex(fileId, recordKey)];
+	entry.fileId              = fileId;
+	entry.recordKey           = recordKey;
+	entry.desc                = desc;
+	entry.desc.record_is_open = false;
+}
+
+void StorageRecordCache::remove(uint16_t fileId, uint16_t recordKey) {
+	entry_t& entry = _entries[getIndex(fileId, recordKey)];
+	if (entry.recordKey == recordKey && entry.fileId == fileId) {
+		entry.recordKey = FDS_RECORD_KEY_DIRTY;
+	}
+}
+
+void StorageRecordCache::removeRecordKey(uint16_t recordKey) {
+	for (auto& entry : _entries) {
+		if (entry.recordKey == recordKey) {
+			entry.recordKey = FDS_RECORD_KEY_DIRTY;
+		}
+	}
+}
+
+void StorageRecordCache::removeFileId(uint16_t fileId) {
+	for (auto& entry : _entries) {
+		if (entry.fileId == fileId) {
+			entry.recordKey = FDS_RECORD_KEY_DIRTY;
+		}
+	}
+}
+
+void StorageRecordCache::clear() {
+	for (auto& entry : _entries) {
+		entry.recordKey = FDS_RECORD_KEY_DIRTY;
+	}
+}
+
+#else
+
+bool StorageRecordCache::get(uint16_t, uint16_t, fds_record_desc_t&) const {
+	return false;
+}
+
+void StorageRecordCache::set(uint16_t, uint16_t, const fds_record_desc_t&) {}
+
+void StorageRecordCache::remove(uint16_t, uint16_t) {}
+
+void StorageRecordCache::removeRecordKey(uint16_t) {}
+
+void StorageRecordCache::removeFileId(uint16_t) {}
+
+void StorageRecordCache::clear() {}
+
+#endif
@@ -0,0 +1,51 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#include <drivers/cs_StorageStats.h>
+
+#include <algorithm>
+
+namespace {
+
+bool isBeforeKey(const cs_storage_type_stats_t& stats, uint16_t recordKey) {
+	return stats.recordKey < recordKey;
+}
+
+}  // namespace
+
+void StorageStats::addWrite(uint16_t recordKey, uint32_t numBytes) {
+	cs_storage_type_stats_t& stats = getOrAdd(recordKey);
+	stats.bytesWritten += numBytes;
+	stats.writes++;
+}
+
+void StorageStats::addBusy(uint16_t recordKey) {
+	getOrAdd(recordKey).busy++;
+}
+
+const cs_storage_type_stats_t* StorageStats::get(uint16_t recordKey) const {
+	auto it = std::lower_bound(_types.begin(), _types.end(), recordKey, isBeforeKey);
+	if (it == _types.end() || it->recordKey != recordKey) {
+		return nullptr;
+	}
+	return &(*it);
+}
+
+void StorageStats::clear() {
+	_types.clear();
+	_types.shrink_to_fit();
+	_totals = cs_storage_stats_t();
+}
+
+cs_storage_type_stats_t& StorageStats::getOrAdd(uint16_t recordKey) {
+	auto it = std::lower_bound(_types.begin(), _types.end(), recordKey, isBeforeKey);
+	if (it == _types.end() || it->recordKey != recordKey) {
+		cs_storage_type_stats_t stats = {recordKey, 0, 0, 0};
+		it                            = _types.insert(it, stats);
+	}
+	return *it;
+}
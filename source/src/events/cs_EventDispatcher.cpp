@@ -13,6 +13,8 @@
 #define LOGEventdispatcherInfo LOGi
 #define LOGEventdispatcherWarning LOGw
 
+static_assert(MAX_EVENT_LISTENERS <= EventRoutingTable::MAX_LISTENERS, "Listener mask too small");
+
 EventDispatcher::EventDispatcher() : _listenerCount(0) {}
 
 void EventDispatcher::dispatch(event_t& event) {
@@ -37,28 +39,57 @@ void EventDispatcher::dispatch(event_t& event) {
 			}
 	}
 
-	for (int i = 0; i < _listenerCount; i++) {
-		_listeners[i]->handleEvent(event);
+	// Listeners are called in order of registration: lowest bit first.
+	event_listener_mask_t listeners = _routes.getListeners(to_underlying_type(event.type));
+	while (listeners != 0) {
+		uint8_t listenerIndex = __builtin_ctzll(listeners);
+		listeners &= listeners - 1;
+		_listeners[listenerIndex]->handleEvent(event);
 	}
 }
 
-bool EventDispatcher::addListener(EventListener* listener) {
-	if (_listenerCount >= MAX_EVENT_LISTENERS - 1) {
-		APP_ERROR_HANDLER(NRF_ERROR_NO_MEM);
-		return false;
-	}
+int16_t EventDispatcher::getOrAddListenerIndex(EventListener* listener) {
 	if (listener == nullptr) {
 		APP_ERROR_HANDLER(NRF_ERROR_NULL);
-		return false;
+		return -1;
 	}
 
 	// check for duplicate registration
 	for (uint8_t listenerIndex = 0; listenerIndex < _listenerCount; listenerIndex++) {
 		if(_listeners[listenerIndex] == listener) {
-			return true;
+			return listenerIndex;
 		}
 	}
 
-	_listeners[_listenerCount++] = listener;
+	if (_listenerCount >= MAX_EVENT_LISTENERS - 1) {
+		APP_ERROR_HANDLER(NRF_ERROR_NO_MEM);
+		return -1;
+	}
+
+	_listeners[_listenerCount] = listener;
+	return _listenerCount++;
+}
+
+bool EventDispatcher::addListener(EventListener* listener) {
+	int16_t listenerIndex = getOrAddListenerIndex(listener);
+	if (listenerIndex < 0) {
+		return false;
+	}
+	_routes.subscribeAll(listenerIndex);
+	return true;
+}
+
+bool EventDispatcher::addListener(EventListener* listener, const CS_TYPE* types, uint8_t typeCount) {
+	int16_t listenerIndex = getOrAddListenerIndex(listener);
+	if (listenerIndex < 0) {
+		return false;
+	}
+	for (uint8_t i = 0; i < typeCount; ++i) {
+		if (!_routes.subscribe(to_underlying_type(types[i]), listenerIndex)) {
+			LOGEventdispatcherWarning("No space to route type %u, listener %u will get all events", types[i], listenerIndex);
+			_routes.subscribeAll(listenerIndex);
+			break;
+		}
+	}
 	return true;
 }
@@ -11,3 +11,7 @@
 void EventListener::listen() {
 	EventDispatcher::getInstance().addListener(this);
 }
+
+void EventListener::listen(std::initializer_list<CS_TYPE> types) {
+	EventDispatcher::getInstance().addListener(this, types.begin(), types.size());
+}
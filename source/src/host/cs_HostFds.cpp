@@ -0,0 +1,734 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#include <host/cs_HostFds.h>
+#include <util/cs_Crc16.h>
+
+#include <cstring>
+
+namespace {
+
+const uint32_t PAGE_TAG_MAGIC = 0xDEADC0DE;
+const uint32_t PAGE_TAG_SWAP  = 0xF11E01FF;
+// Swap and data only differ in bits that can be cleared, so that the swap page can become a data page.
+const uint32_t PAGE_TAG_DATA  = 0xF11E01FE;
+const uint32_t ERASED_WORD    = 0xFFFFFFFF;
+
+const uint32_t VIRTUAL_PAGE_BYTES = FDS_VIRTUAL_PAGE_SIZE * sizeof(uint32_t);
+
+inline const fds_header_t* toHeader(const uint32_t* addr) {
+	return reinterpret_cast<const fds_header_t*>(addr);
+}
+
+inline bool isErased(const uint32_t* addr) {
+	return *addr == ERASED_WORD;
+}
+
+}  // namespace
+
+HostFds& HostFds::getInstance() {
+	static HostFds instance;
+	return instance;
+}
+
+bool HostFds::open(const char* path) {
+	cs_host_flash_config_t config;
+	config.pageSize = VIRTUAL_PAGE_BYTES;
+	config.numPages = FDS_VIRTUAL_PAGES;
+	if (!HostFlash::getInstance().open(path, config)) {
+		return false;
+	}
+	reboot();
+	return true;
+}
+
+void HostFds::reboot() {
+	_flash        = nullptr;
+	_initialized  = false;
+	_initQueued   = false;
+	_queue.clear();
+	_nextRecordId = 1;
+	_gcRuns       = 0;
+	_openRecords  = 0;
+	for (auto& page : _pages) {
+		page = host_fds_page_t();
+	}
+}
+
+void HostFds::close() {
+	reboot();
+	HostFlash::getInstance().close();
+}
+
+bool HostFds::processOne() {
+	HostFlash& flash = HostFlash::getInstance();
+	if (_queue.empty() || flash.isPowerLost()) {
+		_queue.clear();
+		return false;
+	}
+	host_fds_op_t op = _queue.front();
+	_queue.erase(_queue.begin());
+	fds_evt_t event;
+	memset(&event, 0, sizeof(event));
+	uint64_t busyTimeUs = flash.getStats().busyTimeUs;
+	execute(op, event);
+	if (flash.isPowerLost()) {
+		_queue.clear();
+		return false;
+	}
+	uint64_t opTimeUs = flash.getStats().busyTimeUs - busyTimeUs;
+	_stats.busyTimeUs += opTimeUs;
+	if (op.type == HOST_FDS_OP_GC) {
+		_stats.gcTimeUs += opTimeUs;
+	}
+	if (opTimeUs > _stats.maxOpTimeUs) {
+		_stats.maxOpTimeUs = opTimeUs;
+	}
+	_stats.opsExecuted++;
+	dispatch(event);
+	return true;
+}
+
+uint32_t HostFds::process() {
+	uint32_t count = 0;
+	while (processOne()) {
+		count++;
+	}
+	return count;
+}
+
+uint16_t HostFds::getQueueSize() const {
+	return _queue.size();
+}
+
+const cs_host_fds_stats_t& HostFds::getStats() const {
+	return _stats;
+}
+
+void HostFds::resetStats() {
+	_stats = cs_host_fds_stats_t();
+}
+
+ret_code_t HostFds::registerHandler(fds_cb_t cb) {
+	if (cb == nullptr) {
+		return FDS_ERR_NULL_ARG;
+	}
+	if (_numHandlers >= FDS_MAX_USERS) {
+		return FDS_ERR_USER_LIMIT_REACHED;
+	}
+	_handlers[_numHandlers++] = cb;
+	return NRF_SUCCESS;
+}
+
+ret_code_t HostFds::init() {
+	if (!HostFlash::getInstance().isOpen()) {
+		open();
+	}
+	if (_initialized || _initQueued) {
+		return NRF_SUCCESS;
+	}
+	_initQueued = true;
+	host_fds_op_t op;
+	memset(&op, 0, sizeof(op));
+	op.type = HOST_FDS_OP_INIT;
+	_queue.push_back(op);
+	return NRF_SUCCESS;
+}
+
+ret_code_t HostFds::write(fds_record_desc_t* p_desc, fds_record_t const* p_record, bool update) {
+	if (!_initialized) {
+		return FDS_ERR_NOT_INITIALIZED;
+	}
+	if (p_record == nullptr || (update && p_desc == nullptr)) {
+		return FDS_ERR_NULL_ARG;
+	}
+	if (p_record->file_id == FDS_FILE_ID_INVALID || p_record->key == FDS_RECORD_KEY_DIRTY) {
+		return FDS_ERR_INVALID_ARG;
+	}
+	if (reinterpret_cast<uintptr_t>(p_record->data.p_data) % sizeof(uint32_t) != 0) {
+		return FDS_ERR_UNALIGNED_ADDR;
+	}
+	uint32_t numWords = FDS_HEADER_SIZE + p_record->data.length_words;
+	if (numWords > FDS_VIRTUAL_PAGE_SIZE - FDS_PAGE_TAG_SIZE) {
+		return FDS_ERR_RECORD_TOO_LARGE;
+	}
+	if (_queue.size() >= FDS_OP_QUEUE_SIZE) {
+		return FDS_ERR_NO_SPACE_IN_QUEUES;
+	}
+
+	// Reserve space on the first page that has enough.
+	int page = -1;
+	for (uint16_t i = 0; i < FDS_VIRTUAL_PAGES; ++i) {
+		if (_pages[i].type == HOST_FDS_PAGE_DATA
+			&& FDS_VIRTUAL_PAGE_SIZE - _pages[i].writeOffset - _pages[i].wordsReserved >= static_cast<int32_t>(numWords)) {
+			page = i;
+			break;
+		}
+	}
+	if (page < 0) {
+		return FDS_ERR_NO_SPACE_IN_FLASH;
+	}
+	_pages[page].wordsReserved += numWords;
+
+	host_fds_op_t op;
+	memset(&op, 0, sizeof(op));
+	op.type                = update ? HOST_FDS_OP_UPDATE : HOST_FDS_OP_WRITE;
+	op.header.record_key   = p_record->key;
+	op.header.length_words = p_record->data.length_words;
+	op.header.file_id      = p_record->file_id;
+	op.header.record_id    = _nextRecordId++;
+	op.data                = p_record->data.p_data;
+	op.page                = page;
+	op.oldRecordId         = update ? p_desc->record_id : 0;
+	_queue.push_back(op);
+
+	// Like FDS, the location is only known after the record has been written.
+	if (p_desc != nullptr) {
+		p_desc->record_id      = op.header.record_id;
+		p_desc->p_record       = nullptr;
+		p_desc->gc_run_count   = _gcRuns;
+		p_desc->record_is_open = false;
+	}
+	return NRF_SUCCESS;
+}
+
+ret_code_t HostFds::remove(fds_record_desc_t* p_desc) {
+	if (!_initialized) {
+		return FDS_ERR_NOT_INITIALIZED;
+	}
+	if (p_desc == nullptr) {
+		return FDS_ERR_NULL_ARG;
+	}
+	if (_queue.size() >= FDS_OP_QUEUE_SIZE) {
+		return FDS_ERR_NO_SPACE_IN_QUEUES;
+	}
+	host_fds_op_t op;
+	memset(&op, 0, sizeof(op));
+	op.type        = HOST_FDS_OP_DEL_RECORD;
+	op.oldRecordId = p_desc->record_id;
+	_queue.push_back(op);
+	return NRF_SUCCESS;
+}
+
+ret_code_t HostFds::removeFile(uint16_t fileId) {
+	if (!_initialized) {
+		return FDS_ERR_NOT_INITIALIZED;
+	}
+	if (fileId == FDS_FILE_ID_INVALID) {
+		return FDS_ERR_INVALID_ARG;
+	}
+	if (_queue.size() >= FDS_OP_QUEUE_SIZE) {
+		return FDS_ERR_NO_SPACE_IN_QUEUES;
+	}
+	host_fds_op_t op;
+	memset(&op, 0, sizeof(op));
+	op.type           = HOST_FDS_OP_DEL_FILE;
+	op.header.file_id = fileId;
+	_queue.push_back(op);
+	return NRF_SUCCESS;
+}
+
+ret_code_t HostFds::gc() {
+	if (!_initialized) {
+		return FDS_ERR_NOT_INITIALIZED;
+	}
+	if (_queue.size() >= FDS_OP_QUEUE_SIZE) {
+		return FDS_ERR_NO_SPACE_IN_QUEUES;
+	}
+	host_fds_op_t op;
+	memset(&op, 0, sizeof(op));
+	op.type = HOST_FDS_OP_GC;
+	_queue.push_back(op);
+	return NRF_SUCCESS;
+}
+
+ret_code_t HostFds::find(
+		uint16_t const* fileId, uint16_t const* recordKey, fds_record_desc_t* p_desc, fds_find_token_t* p_token) {
+	if (!_initialized) {
+		return FDS_ERR_NOT_INITIALIZED;
+	}
+	if (p_desc == nullptr || p_token == nullptr) {
+		return FDS_ERR_NULL_ARG;
+	}
+	const uint32_t* addr = p_token->p_addr;
+	for (uint16_t page = p_token->page; page < FDS_VIRTUAL_PAGES; ++page, addr = nullptr) {
+		if (_pages[page].type != HOST_FDS_PAGE_DATA) {
+			continue;
+		}
+		const uint32_t* pageAddr = getPage(page);
+		uint32_t offset          = FDS_PAGE_TAG_SIZE;
+		if (addr != nullptr) {
+			// Continue after the previously found record.
+			offset = (addr - pageAddr) + FDS_HEADER_SIZE + toHeader(addr)->length_words;
+		}
+		while (offset + FDS_HEADER_SIZE <= _pages[page].writeOffset) {
+			const fds_header_t* header = toHeader(pageAddr + offset);
+			_stats.headersRead++;
+			if (isValid(header) && (fileId == nullptr || header->file_id == *fileId)
+				&& (recordKey == nullptr || header->record_key == *recordKey)) {
+				p_desc->record_id      = header->record_id;
+				p_desc->p_record       = pageAddr + offset;
+				p_desc->gc_run_count   = _gcRuns;
+				p_desc->record_is_open = false;
+				p_token->page          = page;
+				p_token->p_addr        = pageAddr + offset;
+				return NRF_SUCCESS;
+			}
+			offset += FDS_HEADER_SIZE + header->length_words;
+		}
+	}
+	return FDS_ERR_NOT_FOUND;
+}
+
+ret_code_t HostFds::openRecord(fds_record_desc_t* p_desc, fds_flash_record_t* p_flash_record) {
+	if (p_desc == nullptr || p_flash_record == nullptr) {
+		return FDS_ERR_NULL_ARG;
+	}
+	const uint32_t* addr = locate(p_desc);
+	if (addr == nullptr) {
+		return FDS_ERR_NOT_FOUND;
+	}
+	const fds_header_t* header = toHeader(addr);
+#if FDS_CRC_CHECK_ON_READ == 1
+	if (crc(addr, addr + FDS_HEADER_SIZE, header->length_words) != header->crc16) {
+		return FDS_ERR_CRC_CHECK_FAILED;
+	}
+#endif
+	p_flash_record->p_header = header;
+	p_flash_record->p_data   = addr + FDS_HEADER_SIZE;
+	if (!p_desc->record_is_open) {
+		p_desc->record_is_open = true;
+		_openRecords++;
+	}
+	return NRF_SUCCESS;
+}
+
+ret_code_t HostFds::closeRecord(fds_record_desc_t* p_desc) {
+	if (p_desc == nullptr) {
+		return FDS_ERR_NULL_ARG;
+	}
+	if (p_desc->record_is_open) {
+		p_desc->record_is_open = false;
+		_openRecords--;
+	}
+	return NRF_SUCCESS;
+}
+
+ret_code_t HostFds::stat(fds_stat_t* p_stat) {
+	if (!_initialized) {
+		return FDS_ERR_NOT_INITIALIZED;
+	}
+	if (p_stat == nullptr) {
+		return FDS_ERR_NULL_ARG;
+	}
+	memset(p_stat, 0, sizeof(*p_stat));
+	p_stat->open_records = _openRecords;
+	for (uint16_t page = 0; page < FDS_VIRTUAL_PAGES; ++page) {
+		if (_pages[page].type != HOST_FDS_PAGE_DATA) {
+			continue;
+		}
+		p_stat->pages_available++;
+		p_stat->words_reserved += _pages[page].wordsReserved;
+		p_stat->words_used += _pages[page].writeOffset;
+		uint16_t free = FDS_VIRTUAL_PAGE_SIZE - _pages[page].writeOffset - _pages[page].wordsReserved;
+		if (free > p_stat->largest_contig) {
+			p_stat->largest_contig = free;
+		}
+		const uint32_t* pageAddr = getPage(page);
+		for (uint32_t offset = FDS_PAGE_TAG_SIZE; offset + FDS_HEADER_SIZE <= _pages[page].writeOffset;) {
+			const fds_header_t* header = toHeader(pageAddr + offset);
+			uint16_t numWords          = FDS_HEADER_SIZE + header->length_words;
+			// Records that were interrupted by power loss are just as useless as deleted records.
+			if (!isValid(header)) {
+				p_stat->dirty_records++;
+				p_stat->freeable_words += numWords;
+			}
+			else {
+				p_stat->valid_records++;
+			}
+			offset += numWords;
+		}
+	}
+	return NRF_SUCCESS;
+}
+
+bool HostFds::attach() {
+	const HostFlash& flash = HostFlash::getInstance();
+	uint32_t numBytes      = FDS_VIRTUAL_PAGES * VIRTUAL_PAGE_BYTES;
+	uint32_t endAddress    = fds_flash_end_addr();
+	if (!flash.isOpen() || endAddress < numBytes || VIRTUAL_PAGE_BYTES % flash.getConfig().pageSize != 0) {
+		return false;
+	}
+	_flash = reinterpret_cast<const uint32_t*>(flash.getPointer(endAddress - numBytes, numBytes));
+	return _flash != nullptr;
+}
+
+void HostFds::writeWords(const uint32_t* dest, const uint32_t* src, uint16_t numWords) {
+	HostFlash& flash = HostFlash::getInstance();
+	flash.write(flash.getAddress(dest), src, numWords);
+	_stats.wordsWritten += numWords;
+}
+
+void HostFds::erasePage(uint16_t page) {
+	HostFlash& flash  = HostFlash::getInstance();
+	uint32_t pageSize = flash.getConfig().pageSize;
+	uint32_t address  = flash.getAddress(getPage(page));
+	for (uint32_t offset = 0; offset < VIRTUAL_PAGE_BYTES; offset += pageSize) {
+		flash.erasePage((address + offset) / pageSize);
+	}
+	_stats.pageErases++;
+}
+
+bool HostFds::isValid(const fds_header_t* header) const {
+	return header->record_key != FDS_RECORD_KEY_DIRTY && header->record_id != ERASED_WORD;
+}
+
+void HostFds::scanPages() {
+	int swapPage   = -1;
+	bool hasErased  = false;
+	for (uint16_t page = 0; page < FDS_VIRTUAL_PAGES; ++page) {
+		const uint32_t* pageAddr = getPage(page);
+		if (pageAddr[0] == PAGE_TAG_MAGIC && pageAddr[1] == PAGE_TAG_DATA) {
+			_pages[page].type = HOST_FDS_PAGE_DATA;
+		}
+		else if (pageAddr[0] == PAGE_TAG_MAGIC && pageAddr[1] == PAGE_TAG_SWAP && swapPage < 0) {
+			_pages[page].type = HOST_FDS_PAGE_SWAP;
+			swapPage          = page;
+		}
+		else {
+			_pages[page].type = HOST_FDS_PAGE_ERASED;
+			hasErased         = true;
+		}
+	}
+
+	// A swap page with records means garbage collection was interrupted.
+	if (swapPage >= 0 && !isErased(getPage(swapPage) + FDS_PAGE_TAG_SIZE)) {
+		if (hasErased) {
+			// The old page was already erased, so the swap page has all its valid records.
+			uint32_t dataTag = PAGE_TAG_DATA;
+			writeWords(getPage(swapPage) + 1, &dataTag, 1);
+			_pages[swapPage].type = HOST_FDS_PAGE_DATA;
+			swapPage              = -1;
+		}
+		else {
+			// The old page is still intact: start over.
+			erasePage(swapPage);
+			uint32_t swapTag[FDS_PAGE_TAG_SIZE] = {PAGE_TAG_MAGIC, PAGE_TAG_SWAP};
+			writeWords(getPage(swapPage), swapTag, FDS_PAGE_TAG_SIZE);
+		}
+	}
+
+	// Format the pages that are not in use: the last one as swap page, when there is none yet.
+	for (int page = FDS_VIRTUAL_PAGES - 1; page >= 0; --page) {
+		if (_pages[page].type != HOST_FDS_PAGE_ERASED) {
+			continue;
+		}
+		const uint32_t* pageAddr = getPage(page);
+		bool erased              = true;
+		for (uint32_t i = 0; i < FDS_VIRTUAL_PAGE_SIZE && erased; ++i) {
+			erased = isErased(pageAddr + i);
+		}
+		if (!erased) {
+			erasePage(page);
+		}
+		uint32_t tag[FDS_PAGE_TAG_SIZE] = {PAGE_TAG_MAGIC, PAGE_TAG_DATA};
+		if (swapPage < 0) {
+			tag[1]   = PAGE_TAG_SWAP;
+			swapPage = page;
+		}
+		writeWords(pageAddr, tag, FDS_PAGE_TAG_SIZE);
+		_pages[page].type = (swapPage == page) ? HOST_FDS_PAGE_SWAP : HOST_FDS_PAGE_DATA;
+	}
+
+	// Find the end of the written records, and the highest record id.
+	for (uint16_t page = 0; page < FDS_VIRTUAL_PAGES; ++page) {
+		_pages[page].writeOffset   = FDS_PAGE_TAG_SIZE;
+		_pages[page].wordsReserved = 0;
+		if (_pages[page].type != HOST_FDS_PAGE_DATA) {
+			continue;
+		}
+		const uint32_t* pageAddr = getPage(page);
+		uint32_t offset          = FDS_PAGE_TAG_SIZE;
+		while (offset + FDS_HEADER_SIZE <= FDS_VIRTUAL_PAGE_SIZE && !isErased(pageAddr + offset)) {
+			const fds_header_t* header = toHeader(pageAddr + offset);
+			if (header->record_id != ERASED_WORD && header->record_id >= _nextRecordId) {
+				_nextRecordId = header->record_id + 1;
+			}
+			offset += FDS_HEADER_SIZE + header->length_words;
+		}
+		_pages[page].writeOffset = (offset > FDS_VIRTUAL_PAGE_SIZE) ? FDS_VIRTUAL_PAGE_SIZE : offset;
+	}
+}
+
+const uint32_t* HostFds::findRecord(uint32_t recordId) {
+	for (uint16_t page = 0; page < FDS_VIRTUAL_PAGES; ++page) {
+		if (_pages[page].type != HOST_FDS_PAGE_DATA) {
+			continue;
+		}
+		const uint32_t* pageAddr = getPage(page);
+		for (uint32_t offset = FDS_PAGE_TAG_SIZE; offset + FDS_HEADER_SIZE <= _pages[page].writeOffset;) {
+			const fds_header_t* header = toHeader(pageAddr + offset);
+			_stats.headersLocated++;
+			if (header->record_id == recordId && isValid(header)) {
+				return pageAddr + offset;
+			}
+			offset += FDS_HEADER_SIZE + header->length_words;
+		}
+	}
+	return nullptr;
+}
+
+const uint32_t* HostFds::locate(fds_record_desc_t* p_desc) {
+	// Like FDS: only search when the record may have moved, or its location is unknown.
+	if (p_desc->p_record != nullptr && p_desc->gc_run_count == _gcRuns) {
+		const fds_header_t* header = toHeader(p_desc->p_record);
+		if (header->record_id == p_desc->record_id && isValid(header)) {
+			return p_desc->p_record;
+		}
+	}
+	const uint32_t* addr = findRecord(p_desc->record_id);
+	if (addr != nullptr) {
+		p_desc->p_record     = addr;
+		p_desc->gc_run_count = _gcRuns;
+	}
+	return addr;
+}
+
+uint16_t HostFds::crc(const uint32_t* header, const void* data, uint16_t lengthWords) {
+	// Same fields as FDS: everything except the CRC itself.
+	uint16_t result = crc16(reinterpret_cast<const uint8_t*>(&header[0]), sizeof(uint32_t));
+	result          = crc16(reinterpret_cast<const uint8_t*>(&header[1]), sizeof(uint16_t), &result);
+	result          = crc16(reinterpret_cast<const uint8_t*>(&header[2]), sizeof(uint32_t), &result);
+	return crc16(static_cast<const uint8_t*>(data), lengthWords * sizeof(uint32_t), &result);
+}
+
+void HostFds::execute(host_fds_op_t& op, fds_evt_t& event) {
+	event.result = NRF_SUCCESS;
+	switch (op.type) {
+		case HOST_FDS_OP_INIT: {
+			event.id    = FDS_EVT_INIT;
+			_initQueued = false;
+			if (!attach()) {
+				event.result = FDS_ERR_NO_PAGES;
+				break;
+			}
+			scanPages();
+			_initialized = true;
+			break;
+		}
+		case HOST_FDS_OP_WRITE:
+		case HOST_FDS_OP_UPDATE: {
+			host_fds_page_t& page = _pages[op.page];
+			uint16_t numWords     = FDS_HEADER_SIZE + op.header.length_words;
+			const uint32_t* addr  = getPage(op.page) + page.writeOffset;
+			uint32_t header[FDS_HEADER_SIZE];
+			memcpy(header, &op.header, sizeof(header));
+			op.header.crc16 = crc(header, op.data, op.header.length_words);
+			memcpy(header, &op.header, sizeof(header));
+			// Like FDS: the record id is written last, so that a record is only valid once it's complete, while the
+			// length is written first, so that the next record can be found after an interrupted write.
+			writeWords(addr, header, FDS_HEADER_SIZE - 1);
+			writeWords(addr + FDS_HEADER_SIZE, static_cast<const uint32_t*>(op.data), op.header.length_words);
+			writeWords(addr + FDS_HEADER_SIZE - 1, &header[FDS_HEADER_SIZE - 1], 1);
+			page.writeOffset += numWords;
+			page.wordsReserved -= numWords;
+			_stats.recordsWritten++;
+
+			bool update = (op.type == HOST_FDS_OP_UPDATE);
+			if (update) {
+				const uint32_t* oldAddr = findRecord(op.oldRecordId);
+				if (oldAddr != nullptr) {
+					uint32_t dirty = oldAddr[0] & 0xFFFF0000;
+					writeWords(oldAddr, &dirty, 1);
+				}
+			}
+			event.id                      = update ? FDS_EVT_UPDATE : FDS_EVT_WRITE;
+			event.write.record_id         = op.header.record_id;
+			event.write.file_id           = op.header.file_id;
+			event.write.record_key        = op.header.record_key;
+			event.write.is_record_updated = update;
+			break;
+		}
+		case HOST_FDS_OP_DEL_RECORD: {
+			event.id             = FDS_EVT_DEL_RECORD;
+			event.del.record_id  = op.oldRecordId;
+			const uint32_t* addr = findRecord(op.oldRecordId);
+			if (addr == nullptr) {
+				event.result = FDS_ERR_NOT_FOUND;
+				break;
+			}
+			event.del.file_id    = toHeader(addr)->file_id;
+			event.del.record_key = toHeader(addr)->record_key;
+			uint32_t dirty       = addr[0] & 0xFFFF0000;
+			writeWords(addr, &dirty, 1);
+			break;
+		}
+		case HOST_FDS_OP_DEL_FILE: {
+			event.id             = FDS_EVT_DEL_FILE;
+			event.del.file_id    = op.header.file_id;
+			event.del.record_key = FDS_RECORD_KEY_DIRTY;
+			fds_find_token_t token;
+			memset(&token, 0, sizeof(token));
+			fds_record_desc_t desc;
+			while (find(&op.header.file_id, nullptr, &desc, &token) == NRF_SUCCESS) {
+				uint32_t dirty = desc.p_record[0] & 0xFFFF0000;
+				writeWords(desc.p_record, &dirty, 1);
+			}
+			break;
+		}
+		case HOST_FDS_OP_GC: {
+			executeGc();
+			event.id = FDS_EVT_GC;
+			break;
+		}
+	}
+}
+
+void HostFds::executeGc() {
+	for (uint16_t page = 0; page < FDS_VIRTUAL_PAGES; ++page) {
+		if (_pages[page].type != HOST_FDS_PAGE_DATA) {
+			continue;
+		}
+		const uint32_t* pageAddr = getPage(page);
+		bool hasDirty            = false;
+		for (uint32_t offset = FDS_PAGE_TAG_SIZE; offset + FDS_HEADER_SIZE <= _pages[page].writeOffset;) {
+			const fds_header_t* header = toHeader(pageAddr + offset);
+			if (!isValid(header)) {
+				hasDirty = true;
+				break;
+			}
+			offset += FDS_HEADER_SIZE + header->length_words;
+		}
+		if (!hasDirty) {
+			continue;
+		}
+
+		uint16_t swap = 0;
+		while (_pages[swap].type != HOST_FDS_PAGE_SWAP) {
+			swap++;
+		}
+
+		// Copy the valid records to the swap page.
+		const uint32_t* swapAddr = getPage(swap);
+		uint32_t swapOffset      = FDS_PAGE_TAG_SIZE;
+		for (uint32_t offset = FDS_PAGE_TAG_SIZE; offset + FDS_HEADER_SIZE <= _pages[page].writeOffset;) {
+			const fds_header_t* header = toHeader(pageAddr + offset);
+			uint16_t numWords          = FDS_HEADER_SIZE + header->length_words;
+			if (isValid(header)) {
+				writeWords(swapAddr + swapOffset, pageAddr + offset, numWords);
+				swapOffset += numWords;
+				_stats.recordsMoved++;
+			}
+			offset += numWords;
+		}
+
+		// The old page is erased to become the new swap page, and the swap page becomes a data page.
+		// In this order, scanPages() can always tell which of the two pages holds the records.
+		erasePage(page);
+		uint32_t dataTag = PAGE_TAG_DATA;
+		writeWords(swapAddr + 1, &dataTag, 1);
+		uint32_t swapTag[FDS_PAGE_TAG_SIZE] = {PAGE_TAG_MAGIC, PAGE_TAG_SWAP};
+		writeWords(pageAddr, swapTag, FDS_PAGE_TAG_SIZE);
+
+		_pages[swap].type          = HOST_FDS_PAGE_DATA;
+		_pages[swap].writeOffset   = swapOffset;
+		_pages[swap].wordsReserved = _pages[page].wordsReserved;
+		_pages[page].type          = HOST_FDS_PAGE_SWAP;
+		_pages[page].writeOffset   = FDS_PAGE_TAG_SIZE;
+		_pages[page].wordsReserved = 0;
+		for (auto& op : _queue) {
+			if ((op.type == HOST_FDS_OP_WRITE || op.type == HOST_FDS_OP_UPDATE) && op.page == page) {
+				op.page = swap;
+			}
+		}
+	}
+	_gcRuns++;
+	_stats.gcRuns++;
+}
+
+void HostFds::dispatch(const fds_evt_t& event) {
+	for (uint8_t i = 0; i < _numHandlers; ++i) {
+		_handlers[i](&event);
+	}
+}
+
+ret_code_t fds_register(fds_cb_t cb) {
+	return HostFds::getInstance().registerHandler(cb);
+}
+
+ret_code_t fds_init() {
+	return HostFds::getInstance().init();
+}
+
+ret_code_t fds_record_write(fds_record_desc_t* p_desc, fds_record_t const* p_record) {
+	return HostFds::getInstance().write(p_desc, p_record, false);
+}
+
+ret_code_t fds_record_update(fds_record_desc_t* p_desc, fds_record_t const* p_record) {
+	return HostFds::getInstance().write(p_desc, p_record, true);
+}
+
+ret_code_t fds_record_delete(fds_record_desc_t* p_desc) {
+	return HostFds::getInstance().remove(p_desc);
+}
+
+ret_code_t fds_file_delete(uint16_t file_id) {
+	return HostFds::getInstance().removeFile(file_id);
+}
+
+ret_code_t fds_gc() {
+	return HostFds::getInstance().gc();
+}
+
+ret_code_t fds_record_iterate(fds_record_desc_t* p_desc, fds_find_token_t* p_token) {
+	return HostFds::getInstance().find(nullptr, nullptr, p_desc, p_token);
+}
+
+ret_code_t fds_record_find(uint16_t file_id, uint16_t record_key, fds_record_desc_t* p_desc, fds_find_token_t* p_token) {
+	return HostFds::getInstance().find(&file_id, &record_key, p_desc, p_token);
+}
+
+ret_code_t fds_record_find_by_key(uint16_t record_key, fds_record_desc_t* p_desc, fds_find_token_t* p_token) {
+	return HostFds::getInstance().find(nullptr, &record_key, p_desc, p_token);
+}
+
+ret_code_t fds_record_find_in_file(uint16_t file_id, fds_record_desc_t* p_desc, fds_find_token_t* p_token) {
+	return HostFds::getInstance().find(&file_id, nullptr, p_desc, p_token);
+}
+
+ret_code_t fds_record_open(fds_record_desc_t* p_desc, fds_flash_record_t* p_flash_record) {
+	return HostFds::getInstance().openRecord(p_desc, p_flash_record);
+}
+
+ret_code_t fds_record_close(fds_record_desc_t* p_desc) {
+	return HostFds::getInstance().closeRecord(p_desc);
+}
+
+ret_code_t fds_record_id_from_desc(fds_record_desc_t const* p_desc, uint32_t* p_record_id) {
+	if (p_desc == nullptr || p_record_id == nullptr) {
+		return FDS_ERR_NULL_ARG;
+	}
+	*p_record_id = p_desc->record_id;
+	return NRF_SUCCESS;
+}
+
+ret_code_t fds_descriptor_from_rec_id(fds_record_desc_t* p_desc, uint32_t record_id) {
+	if (p_desc == nullptr) {
+		return FDS_ERR_NULL_ARG;
+	}
+	memset(p_desc, 0, sizeof(*p_desc));
+	p_desc->record_id = record_id;
+	return NRF_SUCCESS;
+}
+
+ret_code_t fds_stat(fds_stat_t* p_stat) {
+	return HostFds::getInstance().stat(p_stat);
+}
+
+uint32_t fds_flash_end_addr() {
+	return HostFlash::getInstance().getSize();
+}
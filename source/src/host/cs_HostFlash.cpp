@@ -0,0 +1,166 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#include <fcntl.h>
+#include <host/cs_HostFlash.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+
+HostFlash& HostFlash::getInstance() {
+	static HostFlash instance;
+	return instance;
+}
+
+bool HostFlash::open(const char* path, const cs_host_flash_config_t& config) {
+	close();
+	if (config.pageSize == 0 || config.pageSize % sizeof(uint32_t) != 0 || config.numPages == 0) {
+		return false;
+	}
+	_config         = config;
+	size_t numBytes = getSize();
+	if (path == nullptr) {
+		_memory.assign(numBytes, 0xFF);
+		_flash = _memory.data();
+	}
+	else {
+		_fd = ::open(path, O_RDWR | O_CREAT, 0644);
+		if (_fd < 0) {
+			return false;
+		}
+		struct stat fileStat;
+		bool isNew = fstat(_fd, &fileStat) != 0 || static_cast<size_t>(fileStat.st_size) != numBytes;
+		if (isNew && ftruncate(_fd, numBytes) != 0) {
+			::close(_fd);
+			_fd = -1;
+			return false;
+		}
+		void* ptr = mmap(nullptr, numBytes, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+		if (ptr == MAP_FAILED) {
+			::close(_fd);
+			_fd = -1;
+			return false;
+		}
+		_flash = static_cast<uint8_t*>(ptr);
+		if (isNew) {
+			memset(_flash, 0xFF, numBytes);
+		}
+	}
+	_eraseCounts.assign(_config.numPages, 0);
+	powerOn();
+	return true;
+}
+
+void HostFlash::close() {
+	if (_fd >= 0) {
+		msync(_flash, getSize(), MS_SYNC);
+		munmap(_flash, getSize());
+		::close(_fd);
+		_fd = -1;
+	}
+	_memory.clear();
+	_memory.shrink_to_fit();
+	_flash = nullptr;
+}
+
+const uint8_t* HostFlash::getPointer(uint32_t address, uint32_t size) const {
+	if (_flash == nullptr || address >= getSize() || size > getSize() - address) {
+		return nullptr;
+	}
+	return _flash + address;
+}
+
+uint32_t HostFlash::getAddress(const void* ptr) const {
+	return static_cast<const uint8_t*>(ptr) - _flash;
+}
+
+bool HostFlash::write(uint32_t address, const uint32_t* data, uint32_t numWords) {
+	if (address % sizeof(uint32_t) != 0 || getPointer(address, numWords * sizeof(uint32_t)) == nullptr) {
+		return false;
+	}
+	uint32_t* dest = reinterpret_cast<uint32_t*>(_flash + address);
+	for (uint32_t i = 0; i < numWords; ++i) {
+		if (!powerOperation()) {
+			return false;
+		}
+		dest[i] &= data[i];
+		_stats.wordsWritten++;
+		_stats.busyTimeUs += _config.writeWordUs;
+	}
+	return true;
+}
+
+bool HostFlash::erasePage(uint32_t pageNumber) {
+	if (_flash == nullptr || pageNumber >= _config.numPages || !powerOperation()) {
+		return false;
+	}
+	memset(_flash + pageNumber * _config.pageSize, 0xFF, _config.pageSize);
+	_eraseCounts[pageNumber]++;
+	_stats.pageErases++;
+	_stats.busyTimeUs += _config.erasePageUs;
+	return true;
+}
+
+void HostFlash::setPowerLossAfter(uint32_t numOperations) {
+	_powerLossEnabled         = true;
+	_operationsUntilPowerLoss = numOperations;
+}
+
+void HostFlash::powerOn() {
+	_powerLossEnabled = false;
+	_powerLost        = false;
+}
+
+void HostFlash::resetStats() {
+	_stats = cs_host_flash_stats_t();
+}
+
+void HostFlash::sendSocEvent(uint32_t evt) {
+	if (_socEventHandler != nullptr && !_powerLost) {
+		_socEventHandler(evt);
+	}
+}
+
+bool HostFlash::powerOperation() {
+	if (_powerLost) {
+		return false;
+	}
+	if (_powerLossEnabled) {
+		if (_operationsUntilPowerLoss == 0) {
+			_powerLost = true;
+			return false;
+		}
+		_operationsUntilPowerLoss--;
+	}
+	return true;
+}
+
+uint32_t sd_flash_write(uint32_t* p_dst, uint32_t const* p_src, uint32_t size) {
+	HostFlash& flash = HostFlash::getInstance();
+	if (p_dst == nullptr || p_src == nullptr) {
+		return NRF_ERROR_NULL;
+	}
+	uint32_t address = flash.getAddress(p_dst);
+	if (flash.getPointer(address, size * sizeof(uint32_t)) == nullptr) {
+		return NRF_ERROR_INVALID_ADDR;
+	}
+	bool success = flash.write(address, p_src, size);
+	flash.sendSocEvent(success ? NRF_EVT_FLASH_OPERATION_SUCCESS : NRF_EVT_FLASH_OPERATION_ERROR);
+	return NRF_SUCCESS;
+}
+
+uint32_t sd_flash_page_erase(uint32_t page_number) {
+	HostFlash& flash = HostFlash::getInstance();
+	if (page_number >= flash.getConfig().numPages) {
+		return NRF_ERROR_INVALID_ADDR;
+	}
+	bool success = flash.erasePage(page_number);
+	flash.sendSocEvent(success ? NRF_EVT_FLASH_OPERATION_SUCCESS : NRF_EVT_FLASH_OPERATION_ERROR);
+	return NRF_SUCCESS;
+}
@@ -0,0 +1,196 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#include <host/cs_HostFstorage.h>
+
+#include <cstring>
+
+nrf_fstorage_api_t nrf_fstorage_sd = {nullptr};
+
+HostFstorage& HostFstorage::getInstance() {
+	static HostFstorage instance;
+	return instance;
+}
+
+bool HostFstorage::processOne() {
+	HostFlash& flash = HostFlash::getInstance();
+	if (_queue.empty() || flash.isPowerLost()) {
+		_queue.clear();
+		return false;
+	}
+	host_fstorage_op_t op = _queue.front();
+	_queue.erase(_queue.begin());
+	op.event.result = execute(op);
+	if (flash.isPowerLost()) {
+		_queue.clear();
+		return false;
+	}
+	if (op.fs->evt_handler != nullptr) {
+		op.fs->evt_handler(&op.event);
+	}
+	return true;
+}
+
+uint32_t HostFstorage::process() {
+	uint32_t count = 0;
+	while (processOne()) {
+		count++;
+	}
+	return count;
+}
+
+void HostFstorage::reboot() {
+	_queue.clear();
+}
+
+uint32_t HostFstorage::init(nrf_fstorage_t* p_fs, nrf_fstorage_api_t* p_api) {
+	if (p_fs == nullptr || p_api == nullptr) {
+		return NRF_ERROR_NULL;
+	}
+	const HostFlash& flash = HostFlash::getInstance();
+	if (!flash.isOpen()) {
+		return NRF_ERROR_INVALID_STATE;
+	}
+	_flashInfo.erase_unit = flash.getConfig().pageSize;
+	p_api->p_flash_info   = &_flashInfo;
+	p_fs->p_api           = p_api;
+	p_fs->p_flash_info    = &_flashInfo;
+	return NRF_SUCCESS;
+}
+
+uint32_t HostFstorage::read(nrf_fstorage_t const* p_fs, uint32_t src, void* p_dest, uint32_t len) {
+	if (p_fs == nullptr || p_dest == nullptr) {
+		return NRF_ERROR_NULL;
+	}
+	if (p_fs->p_api == nullptr) {
+		return NRF_ERROR_INVALID_STATE;
+	}
+	if (len == 0) {
+		return NRF_ERROR_INVALID_LENGTH;
+	}
+	if (!isInArea(p_fs, src, len)) {
+		return NRF_ERROR_INVALID_ADDR;
+	}
+	memcpy(p_dest, HostFlash::getInstance().getPointer(src, len), len);
+	return NRF_SUCCESS;
+}
+
+uint32_t HostFstorage::write(
+		nrf_fstorage_t const* p_fs, uint32_t dest, void const* p_src, uint32_t len, void* p_param) {
+	if (p_fs == nullptr || p_src == nullptr) {
+		return NRF_ERROR_NULL;
+	}
+	if (p_fs->p_api == nullptr) {
+		return NRF_ERROR_INVALID_STATE;
+	}
+	if (len == 0 || len % sizeof(uint32_t) != 0) {
+		return NRF_ERROR_INVALID_LENGTH;
+	}
+	if (dest % sizeof(uint32_t) != 0 || reinterpret_cast<uintptr_t>(p_src) % sizeof(uint32_t) != 0
+		|| !isInArea(p_fs, dest, len)) {
+		return NRF_ERROR_INVALID_ADDR;
+	}
+	if (_queue.size() >= NRF_FSTORAGE_SD_QUEUE_SIZE) {
+		return NRF_ERROR_NO_MEM;
+	}
+	host_fstorage_op_t op;
+	op.fs            = p_fs;
+	op.event.id      = NRF_FSTORAGE_EVT_WRITE_RESULT;
+	op.event.result  = NRF_SUCCESS;
+	op.event.addr    = dest;
+	op.event.p_src   = p_src;
+	op.event.len     = len;
+	op.event.p_param = p_param;
+	_queue.push_back(op);
+	return NRF_SUCCESS;
+}
+
+uint32_t HostFstorage::erase(nrf_fstorage_t const* p_fs, uint32_t pageAddress, uint32_t numPages, void* p_param) {
+	if (p_fs == nullptr) {
+		return NRF_ERROR_NULL;
+	}
+	if (p_fs->p_api == nullptr) {
+		return NRF_ERROR_INVALID_STATE;
+	}
+	if (numPages == 0) {
+		return NRF_ERROR_INVALID_LENGTH;
+	}
+	uint32_t pageSize = HostFlash::getInstance().getConfig().pageSize;
+	if (pageAddress % pageSize != 0 || !isInArea(p_fs, pageAddress, numPages * pageSize)) {
+		return NRF_ERROR_INVALID_ADDR;
+	}
+	if (_queue.size() >= NRF_FSTORAGE_SD_QUEUE_SIZE) {
+		return NRF_ERROR_NO_MEM;
+	}
+	host_fstorage_op_t op;
+	op.fs            = p_fs;
+	op.event.id      = NRF_FSTORAGE_EVT_ERASE_RESULT;
+	op.event.result  = NRF_SUCCESS;
+	op.event.addr    = pageAddress;
+	op.event.p_src   = nullptr;
+	op.event.len     = numPages;
+	op.event.p_param = p_param;
+	_queue.push_back(op);
+	return NRF_SUCCESS;
+}
+
+bool HostFstorage::isBusy(nrf_fstorage_t const*) const {
+	// Like the SoftDevice backend: busy when any instance has queued operations.
+	return !_queue.empty();
+}
+
+bool HostFstorage::isInArea(nrf_fstorage_t const* p_fs, uint32_t address, uint32_t size) const {
+	// The end address is the last address of the area.
+	return address >= p_fs->start_addr && address <= p_fs->end_addr && size - 1 <= p_fs->end_addr - address
+		   && HostFlash::getInstance().getPointer(address, size) != nullptr;
+}
+
+uint32_t HostFstorage::execute(host_fstorage_op_t& op) {
+	HostFlash& flash = HostFlash::getInstance();
+	switch (op.event.id) {
+		case NRF_FSTORAGE_EVT_WRITE_RESULT: {
+			const uint32_t* data = static_cast<const uint32_t*>(op.event.p_src);
+			if (!flash.write(op.event.addr, data, op.event.len / sizeof(uint32_t))) {
+				return NRF_ERROR_INVALID_ADDR;
+			}
+			break;
+		}
+		case NRF_FSTORAGE_EVT_ERASE_RESULT: {
+			uint32_t firstPage = op.event.addr / flash.getConfig().pageSize;
+			for (uint32_t page = firstPage; page < firstPage + op.event.len; ++page) {
+				if (!flash.erasePage(page)) {
+					return NRF_ERROR_INVALID_ADDR;
+				}
+			}
+			break;
+		}
+		case NRF_FSTORAGE_EVT_READ_RESULT: {
+			break;
+		}
+	}
+	return NRF_SUCCESS;
+}
+
+uint32_t nrf_fstorage_init(nrf_fstorage_t* p_fs, nrf_fstorage_api_t* p_api, void*) {
+	return HostFstorage::getInstance().init(p_fs, p_api);
+}
+
+uint32_t nrf_fstorage_read(nrf_fstorage_t const* p_fs, uint32_t src, void* p_dest, uint32_t len) {
+	return HostFstorage::getInstance().read(p_fs, src, p_dest, len);
+}
+
+uint32_t nrf_fstorage_write(nrf_fstorage_t const* p_fs, uint32_t dest, void const* p_src, uint32_t len, void* p_param) {
+	return HostFstorage::getInstance().write(p_fs, dest, p_src, len, p_param);
+}
+
+uint32_t nrf_fstorage_erase(nrf_fstorage_t const* p_fs, uint32_t page_addr, uint32_t len, void* p_param) {
+	return HostFstorage::getInstance().erase(p_fs, page_addr, len, p_param);
+}
+
+bool nrf_fstorage_is_busy(nrf_fstorage_t const* p_fs) {
+	return HostFstorage::getInstance().isBusy(p_fs);
+}
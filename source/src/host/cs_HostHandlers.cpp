@@ -0,0 +1,28 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+/**
+ * The handlers of cs_Handlers.cpp that are needed by the modules that can be compiled on the host.
+ */
+
+#include <common/cs_Handlers.h>
+#include <drivers/cs_Storage.h>
+
+extern "C" {
+
+void fds_evt_handler_decoupled(void* p_event_data, uint16_t) {
+	Storage::getInstance().handleFileStorageEvent(reinterpret_cast<const fds_evt_t*>(p_event_data));
+}
+
+/**
+ * Same as on the firmware: FDS events are put on the app scheduler, so they're handled in app_sched_execute().
+ */
+void fds_evt_handler(const fds_evt_t* p_fds_evt) {
+	uint32_t retVal = app_sched_event_put(p_fds_evt, sizeof(*p_fds_evt), fds_evt_handler_decoupled);
+	APP_ERROR_CHECK(retVal);
+}
+}
@@ -0,0 +1,58 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#include <host/cs_HostSdk.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <vector>
+
+bool nrf_sdh_is_enabled() {
+	return true;
+}
+
+void app_error_handler(uint32_t error_code, uint32_t line_num, const uint8_t* p_file_name) {
+	printf("Error %u at %s:%u\n", error_code, reinterpret_cast<const char*>(p_file_name), line_num);
+	abort();
+}
+
+uint32_t __get_IPSR() {
+	return 0;
+}
+
+host_ficr_t* hostFicr() {
+	static host_ficr_t ficr;
+	ficr.CODEPAGESIZE = HostFlash::getInstance().getConfig().pageSize;
+	return &ficr;
+}
+
+host_rtc_t* hostRtc() {
+	static host_rtc_t rtc = {0, 0};
+	return &rtc;
+}
+
+struct host_sched_event_t {
+	std::vector<uint8_t> data;
+	app_sched_event_handler_t handler;
+};
+
+static std::deque<host_sched_event_t> schedQueue;
+
+uint32_t app_sched_event_put(void const* p_event_data, uint16_t event_size, app_sched_event_handler_t handler) {
+	const uint8_t* data = static_cast<const uint8_t*>(p_event_data);
+	schedQueue.push_back({std::vector<uint8_t>(data, data + event_size), handler});
+	return NRF_SUCCESS;
+}
+
+void app_sched_execute() {
+	while (!schedQueue.empty()) {
+		host_sched_event_t event = schedQueue.front();
+		schedQueue.pop_front();
+		event.handler(event.data.data(), event.data.size());
+	}
+}
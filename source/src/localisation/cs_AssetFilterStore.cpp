@@ -15,9 +15,9 @@
 #include <structs/cs_PacketsInternal.h>
 #include <util/cs_Crc32.h>
 
-#define LOGAssetFilterWarn LOGw
-#define LOGAssetFilterInfo LOGi
-#define LOGAssetFilterDebug LOGvv
+#define LOGAssetFilterWarn(fmt, ...)  LOGMw(LOG_MODULE_ASSET_FILTERING, fmt, ##__VA_ARGS__)
+#define LOGAssetFilterInfo(fmt, ...)  LOGMi(LOG_MODULE_ASSET_FILTERING, fmt, ##__VA_ARGS__)
+#define LOGAssetFilterDebug(fmt, ...) LOGMd(LOG_MODULE_ASSET_FILTERING, fmt, ##__VA_ARGS__)
 
 cs_ret_code_t AssetFilterStore::init() {
 	LOGAssetFilterInfo("init");
@@ -37,6 +37,32 @@ AssetFilter AssetFilterStore::getFilter(uint8_t index) {
 	return AssetFilter(_filters[index]);
 }
 
+/**
+ * Filter operations for the evaluation plan.
+ */
+struct AssetFilterOps {
+	static cuckoo_key_hash_t hashKey(const uint8_t* key, size_t keyLength) {
+		return CuckooFilter::hashKey(key, keyLength);
+	}
+
+	static bool cuckooFilterContains(void* filterData, const cuckoo_key_hash_t& keyHash) {
+		return CuckooFilter(static_cast<cuckoo_filter_data_t*>(filterData)).contains(keyHash);
+	}
+
+	static bool exactMatchFilterContains(void* filterData, const uint8_t* key, size_t keyLength) {
+#if EXACT_MATCH_FILTER_INDEX == 1
+		return static_cast<ExactMatchFilterIndex*>(filterData)->contains(key, keyLength);
+#else
+		return ExactMatchFilter(static_cast<exact_match_filter_data_t*>(filterData)).contains(key, keyLength);
+#endif
+	}
+};
+
+asset_filter_plan_result_t AssetFilterStore::evaluateFilters(const scanned_device_t& device) {
+	return _plan.evaluate<AssetFilterOps>(
+			device.address, sizeof(device.address), device.data, device.dataSize, device.adIndex);
+}
+
 uint16_t AssetFilterStore::getMasterVersion() {
 	return _masterVersion;
 }
@@ -406,6 +432,7 @@ void AssetFilterStore::startInProgress() {
 	LOGAssetFilterDebug("startInProgress");
 	_modificationInProgressCountdown = 1000 * MODIFICATION_IN_PROGRESS_TIMEOUT_SECONDS / TICK_INTERVAL_MS;
 	_masterVersion                   = 0;
+	_plan.clear();
 	sendInProgressStatus();
 }
 
@@ -479,6 +506,8 @@ cs_ret_code_t AssetFilterStore::commit(uint16_t masterVersion, uint32_t masterCr
 
 	markFiltersCommitted();
 
+	compilePlan();
+
 	endInProgress(masterVersion, masterCrc);
 	return ERR_SUCCESS;
 }
@@ -691,3 +720,64 @@ void AssetFilterStore::markFiltersCommitted() {
 		filter.runtimedata()->flags.flags.committed = true;
 	}
 }
+
+void AssetFilterStore::compilePlan() {
+	static_assert(MAX_FILTER_IDS <= AssetFilterPlan::MAX_FILTERS, "Plan can't hold all filters.");
+	_plan.clear();
+	for (uint8_t index = 0; index < _filtersCount; ++index) {
+		auto filter = AssetFilter(_filters[index]);
+
+		if (filter._data == nullptr) {
+			break;
+		}
+
+		auto filterData     = filter.filterdata();
+		auto metadata       = filterData.metadata();
+		auto input          = metadata.inputType();
+		uint8_t adDataType  = 0;
+		uint32_t adDataMask = 0;
+		switch (*input.type()) {
+			case AssetFilterInputType::MacAddress: {
+				break;
+			}
+			case AssetFilterInputType::AdDataType: {
+				adDataType = input.AdTypeField()->adDataType;
+				break;
+			}
+			case AssetFilterInputType::MaskedAdDataType: {
+				adDataType = input.AdTypeMasked()->adDataType;
+				adDataMask = input.AdTypeMasked()->adDataMask;
+				break;
+			}
+			default: {
+				LOGAssetFilterWarn("Filter %u has unknown input type %u", index, *input.type());
+				continue;
+			}
+		}
+
+		AssetFilterType filterType = *metadata.filterType();
+		void* data                 = nullptr;
+		switch (filterType) {
+			case AssetFilterType::CuckooFilter: {
+				data = filterData._data + metadata.length();
+				break;
+			}
+			case AssetFilterType::ExactMatchFilter: {
+				data = filterData._data + metadata.length();
+#if EXACT_MATCH_FILTER_INDEX == 1
+				_exactMatchFilterIndices[index].build(static_cast<exact_match_filter_data_t*>(data));
+				data = &_exactMatchFilterIndices[index];
+#endif
+				break;
+			}
+			default: {
+				LOGAssetFilterWarn("Filter %u has unknown filter type %u", index, filterType);
+				continue;
+			}
+		}
+
+		_plan.addFilter(
+				index, *input.type(), adDataType, adDataMask, filterType, data, metadata.flags()->flags.exclude);
+	}
+	LOGAssetFilterDebug("Compiled plan: filters=%u inputs=%u", _filtersCount, _plan.getInputCount());
+}
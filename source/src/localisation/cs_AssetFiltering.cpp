@@ -8,12 +8,10 @@
 #include <localisation/cs_AssetFiltering.h>
 #include <util/cs_Utils.h>
 
-#define LOGAssetFilteringWarn LOGw
-#define LOGAssetFilteringInfo LOGd
-#define LOGAssetFilteringDebug LOGvv
-#define LOGAssetFilteringVerbose LOGvv
-#define LogLevelAssetFilteringDebug   SERIAL_VERY_VERBOSE
-#define LogLevelAssetFilteringVerbose SERIAL_VERY_VERBOSE
+#define LOGAssetFilteringWarn(fmt, ...)    LOGMw(LOG_MODULE_ASSET_FILTERING, fmt, ##__VA_ARGS__)
+#define LOGAssetFilteringInfo(fmt, ...)    LOGMi(LOG_MODULE_ASSET_FILTERING, fmt, ##__VA_ARGS__)
+#define LOGAssetFilteringDebug(fmt, ...)   LOGMd(LOG_MODULE_ASSET_FILTERING, fmt, ##__VA_ARGS__)
+#define LOGAssetFilteringVerbose(fmt, ...) LOGMv(LOG_MODULE_ASSET_FILTERING, fmt, ##__VA_ARGS__)
 
 
 void LogAcceptedDevice(AssetFilter filter, const scanned_device_t& device, bool excluded) {
@@ -100,7 +98,7 @@ cs_ret_code_t AssetFiltering::initInternal() {
 			_assetStore->throttlingBumpMsToTicks(
 					_assetForwarder->MIN_THROTTLED_ADVERTISEMENT_PERIOD_MS));
 
-	listen();
+	listen({CS_TYPE::EVT_DEVICE_SCANNED});
 	return ERR_SUCCESS;
 }
 
@@ -152,38 +150,32 @@ void AssetFiltering::handleScannedDevice(const scanned_device_t& asset) {
 			asset.address[1],
 			asset.address[0]
 	);
-	_logArray(LogLevelAssetFilteringVerbose, true, asset.data, asset.dataSize);
+	_logArrayModule(LOG_MODULE_ASSET_FILTERING, SERIAL_VERBOSE, true, asset.data, asset.dataSize);
 
-	if (isAssetRejected(asset)) {
+	asset_filter_plan_result_t result = _filterStore->evaluateFilters(asset);
+	if (result.rejected) {
+		// Reject by early return.
+		LogAcceptedDevice(_filterStore->getFilter(__builtin_ctz(result.filterMask)), asset, true);
 		return;
 	}
 
 	for (uint8_t filterIndex = 0; filterIndex < _filterStore->getFilterCount(); ++filterIndex) {
-		checkIfFilterAccepts(filterIndex, asset);
+		if (CsUtils::isBitSet(result.filterMask, filterIndex)) {
+			handleFilterAccepts(filterIndex, asset);
+		}
 	}
 
 	_assetForwarder->flush();
 }
 
-bool AssetFiltering::checkIfFilterAccepts(uint8_t filterIndex, const scanned_device_t& device) {
+void AssetFiltering::handleFilterAccepts(uint8_t filterIndex, const scanned_device_t& device) {
 	auto filter = AssetFilter(_filterStore->getFilter(filterIndex));
 
-	if (filter.filterdata().metadata().flags()->flags.exclude) {
-		return false;
-	}
-
-	if (filter.filterAcceptsScannedDevice(device)) {
-		handleAcceptedAsset(filterIndex, filter, device);
-
-		AssetAcceptedEvent evtData(filter, device);
-		event_t assetEvent(CS_TYPE::EVT_ASSET_ACCEPTED, &evtData, sizeof(evtData));
-		assetEvent.dispatch();
+	handleAcceptedAsset(filterIndex, filter, device);
 
-		return true;
-
-	}
-
-	return false;
+	AssetAcceptedEvent evtData(filter, device);
+	event_t assetEvent(CS_TYPE::EVT_ASSET_ACCEPTED, &evtData, sizeof(evtData));
+	assetEvent.dispatch();
 }
 
 void AssetFiltering::handleAcceptedAsset(uint8_t filterIndex, AssetFilter filter, const scanned_device_t& asset) {
@@ -290,23 +282,3 @@ void AssetFiltering::handleAcceptedAssetOutputAssetIdNearest(
 	}
 #endif
 }
-
-// ---------------------------- utils ----------------------------
-
-
-bool AssetFiltering::isAssetRejected(const scanned_device_t& device) {
-	// Rejection check: looping over exclusion filters.
-	for (uint8_t i = 0; i < _filterStore->getFilterCount(); ++i) {
-		auto filter = AssetFilter(_filterStore->getFilter(i));
-
-		if (filter.filterdata().metadata().flags()->flags.exclude == true) {
-			if (filter.filterAcceptsScannedDevice(device)) {
-				// Reject by early return.
-				LogAcceptedDevice(filter, device, true);
-				return true;
-			}
-		}
-	}
-
-	return false;
-}
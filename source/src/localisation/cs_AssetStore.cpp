@@ -30,15 +30,14 @@ AssetStore::AssetStore()
 cs_ret_code_t AssetStore::init() {
 	LOGAssetStoreInfo("Init: using buffer of %u B", sizeof(_store));
 	_store.clear();
-	listen();
+	updateLastReceivedCounterRoutine.start();
+	updateLastSentCounterRoutine.start();
+	listen({CS_TYPE::EVT_FILTERS_UPDATED});
 
 	return ERR_SUCCESS;
 }
 
 void AssetStore::handleEvent(event_t& event) {
-	updateLastReceivedCounterRoutine.handleEvent(event);
-	updateLastSentCounterRoutine.handleEvent(event);
-
 	switch (event.type) {
 		case CS_TYPE::EVT_FILTERS_UPDATED: {
 			LOGAssetStoreDebug("resetRecords");
@@ -71,30 +70,25 @@ asset_record_t* AssetStore::getRecord(const asset_id_t& id) {
 asset_record_t* AssetStore::getOrCreateRecord(const asset_id_t& id) {
 	LOGAssetStoreVerbose("getOrCreateRecord id=%02X:%02X:%02X", id.data[0], id.data[1], id.data[2]);
 
-	if(asset_record_t* rec = _store.getOrAdd(id)) {
-		// record found, or empty space was newly occupied.
-		rec->empty();
-		rec->assetId = id;
-		return rec;
-	}
+	asset_record_t* rec = _store.getOrAdd(id);
+	if (rec == nullptr) {
+		// Last option, overwrite oldest record: the one that was least recently received.
+		rec = _store.getLeastRecent();
 
-	// Last option, overwrite oldest record.
-	asset_record_t* oldestRecord = _store.begin();
-	for (asset_record_t* record = _store.begin(); record != _store.end(); record++) {
-		if (record->lastReceivedCounter > oldestRecord->lastReceivedCounter) {
-			oldestRecord = record;
-		}
-	}
+		LOGAssetStoreVerbose(
+				"Overwriting oldest record asset id=%02X:%02X:%02X",
+				rec->assetId.data[0],
+				rec->assetId.data[1],
+				rec->assetId.data[2]);
 
-	LOGAssetStoreVerbose(
-			"Overwriting oldest record asset id=%02X:%02X:%02X",
-			oldestRecord->assetId.data[0],
-			oldestRecord->assetId.data[1],
-			oldestRecord->assetId.data[2]);
+		_store.replace(*rec, id);
+	}
 
-	oldestRecord->empty();
-	oldestRecord->assetId = id;
-	return oldestRecord;
+	// record found, or empty space was newly occupied.
+	rec->empty();
+	rec->assetId = id;
+	_store.touch(*rec);
+	return rec;
 }
 
 void AssetStore::addThrottlingBump(asset_record_t& record, uint16_t timeToNextThrottleOpenMs) {
@@ -127,7 +121,7 @@ void AssetStore::incrementLastReceivedCounters() {
 		if (record.lastReceivedCounter >= LAST_RECEIVED_TIMEOUT_THRESHOLD_S) {
 			LOGAssetStoreDebug("Asset timed out. %02X:%02X:%02X",
 					record.assetId.data[0], record.assetId.data[1], record.assetId.data[2]);
-			record.invalidate();
+			_store.remove(record);
 		}
 	}
 }
@@ -25,7 +25,13 @@ cs_ret_code_t MeshTopology::init() {
 		return ERR_NO_SPACE;
 	}
 	reset();
-	listen();
+	_tickSecondRoutine.start(Coroutine::delayS(1));
+	listen({
+		CS_TYPE::EVT_RECV_MESH_MSG,
+		CS_TYPE::CMD_MESH_TOPO_GET_MAC,
+		CS_TYPE::CMD_MESH_TOPO_RESET,
+		CS_TYPE::CMD_MESH_TOPO_GET_RSSI
+	});
 
 #if BUILD_MESH_TOPOLOGY_RESEARCH == 1
 	_research.init();
@@ -375,13 +381,6 @@ void MeshTopology::handleEvent(event_t &evt) {
 			onMeshMsg(*packet, evt.result);
 			break;
 		}
-		case CS_TYPE::EVT_TICK: {
-			auto packet = CS_TYPE_CAST(EVT_TICK, evt.data);
-			if (*packet % (1000 / TICK_INTERVAL_MS) == 0) {
-				onTickSecond();
-			}
-			break;
-		}
 		case CS_TYPE::CMD_MESH_TOPO_GET_MAC: {
 			auto packet = CS_TYPE_CAST(CMD_MESH_TOPO_GET_MAC, evt.data);
 			evt.result.returnCode = getMacAddress(*packet);
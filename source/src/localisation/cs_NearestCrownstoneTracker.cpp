@@ -35,7 +35,7 @@ cs_ret_code_t NearestCrownstoneTracker::init() {
 		return ERR_NOT_FOUND;
 	}
 
-	listen();
+	listen({CS_TYPE::EVT_RECV_MESH_MSG});
 
 	return ERR_SUCCESS;
 }
@@ -27,9 +27,10 @@
 		if (len < 0) {
 			return;
 		}
-		for (int i = 0; i < len; ++i) {
-			serial_write(_logBuffer[i]);
+		if (len > (int)sizeof(_logBuffer) - 1) {
+			len = sizeof(_logBuffer) - 1;
 		}
+		serial_write_buffer(reinterpret_cast<uint8_t*>(_logBuffer), len);
 		return;
 	#endif
 		return;
@@ -38,6 +39,108 @@
 #endif // CS_UART_BINARY_PROTOCOL_ENABLED == 0
 
 
+#if CS_SERIAL_LOG_RING_ENABLED == 1
+#include <ble/cs_Nordic.h>
+#include <logging/cs_LogRing.h>
+
+/**
+ * Type of the records in the log ring.
+ */
+enum LogRingRecordType : uint8_t {
+	LOG_RING_RECORD_TYPE_LOG       = 0,
+	LOG_RING_RECORD_TYPE_LOG_ARRAY = 1,
+};
+
+/**
+ * Placed in RAM that is not initialized at boot, so that the logs from before a reset can be recovered.
+ */
+static LogRing<CS_SERIAL_LOG_RING_SIZE> _logRing __attribute__((section(".bluenet_log_ram")));
+static bool _logRingInitialized = false;
+static uint16_t _logRingNumRecovered = 0;
+
+/**
+ * Logs are also written from interrupts, while the log ring can only be used from a single context.
+ * So interrupts are blocked from the start of a record until its end. This stores whether they were blocked already.
+ */
+static uint8_t _logRingNestedCriticalRegion = 0;
+
+static LogRing<CS_SERIAL_LOG_RING_SIZE>& getLogRing() {
+	if (!_logRingInitialized) {
+		_logRingInitialized = true;
+		_logRingNumRecovered = _logRing.recover();
+	}
+	return _logRing;
+}
+
+static void log_write_start(UartOpcodeTx opCode, size_t msgSize) {
+	uint8_t nested;
+	app_util_critical_region_enter(&nested);
+	_logRingNestedCriticalRegion = nested;
+	uint8_t type = (opCode == UART_OPCODE_TX_LOG_ARRAY) ? LOG_RING_RECORD_TYPE_LOG_ARRAY : LOG_RING_RECORD_TYPE_LOG;
+	getLogRing().start(type, msgSize);
+}
+
+static void log_write_part(UartOpcodeTx, const uint8_t* const data, size_t size) {
+	_logRing.write(data, size);
+}
+
+static void log_write_end(UartOpcodeTx) {
+	_logRing.end();
+	app_util_critical_region_exit(_logRingNestedCriticalRegion);
+}
+
+void cs_log_flush() {
+	LogRing<CS_SERIAL_LOG_RING_SIZE>& logRing = getLogRing();
+	UartHandler& uartHandler = UartHandler::getInstance();
+
+	if (_logRingNumRecovered != 0) {
+		uart_msg_log_recovered_t recovered;
+		recovered.numLogs = _logRingNumRecovered;
+		if (!uartHandler.canWriteMsg(UART_OPCODE_TX_LOG_RECOVERED, sizeof(recovered))) {
+			return;
+		}
+		uartHandler.writeMsg(UART_OPCODE_TX_LOG_RECOVERED, reinterpret_cast<uint8_t*>(&recovered), sizeof(recovered));
+		_logRingNumRecovered = 0;
+	}
+
+	uint8_t type;
+	const uint8_t* data;
+	uint16_t size;
+	bool sent = true;
+	while (sent) {
+		// Block interrupts, so that the record isn't overwritten by a log from an interrupt while it's being sent.
+		CRITICAL_REGION_ENTER();
+		sent = logRing.peek(type, data, size);
+		if (sent) {
+			UartOpcodeTx opCode = (type == LOG_RING_RECORD_TYPE_LOG_ARRAY) ? UART_OPCODE_TX_LOG_ARRAY : UART_OPCODE_TX_LOG;
+			// Else continue at the next flush, when there is space again.
+			sent = uartHandler.canWriteMsg(opCode, size);
+			if (sent) {
+				uartHandler.writeMsg(opCode, const_cast<uint8_t*>(data), size);
+				logRing.pop();
+			}
+		}
+		CRITICAL_REGION_EXIT();
+	}
+}
+
+#else
+
+static void log_write_start(UartOpcodeTx opCode, size_t msgSize) {
+	UartHandler::getInstance().writeMsgStart(opCode, msgSize);
+}
+
+static void log_write_part(UartOpcodeTx opCode, const uint8_t* const data, size_t size) {
+	UartHandler::getInstance().writeMsgPart(opCode, data, size);
+}
+
+static void log_write_end(UartOpcodeTx opCode) {
+	UartHandler::getInstance().writeMsgEnd(opCode);
+}
+
+#endif // CS_SERIAL_LOG_RING_ENABLED == 1
+
+
 template<>
 void cs_log_add_arg_size(size_t& size, uint8_t& numArgs, char* str) {
 	size += sizeof(uart_msg_log_arg_header_t) + strlen(str);
@@ -63,19 +166,19 @@ void cs_log_arg(const char* str) {
 }
 
 void cs_log_start(size_t msgSize, uart_msg_log_header_t &header) {
-	UartHandler::getInstance().writeMsgStart(UART_OPCODE_TX_LOG, msgSize);
-	UartHandler::getInstance().writeMsgPart(UART_OPCODE_TX_LOG, reinterpret_cast<uint8_t*>(&header), sizeof(header));
+	log_write_start(UART_OPCODE_TX_LOG, msgSize);
+	log_write_part(UART_OPCODE_TX_LOG, reinterpret_cast<uint8_t*>(&header), sizeof(header));
 }
 
 void cs_log_arg(const uint8_t* const valPtr, size_t valSize) {
 	uart_msg_log_arg_header_t argHeader;
 	argHeader.argSize = valSize;
-	UartHandler::getInstance().writeMsgPart(UART_OPCODE_TX_LOG, reinterpret_cast<uint8_t*>(&argHeader), sizeof(argHeader));
-	UartHandler::getInstance().writeMsgPart(UART_OPCODE_TX_LOG, valPtr, valSize);
+	log_write_part(UART_OPCODE_TX_LOG, reinterpret_cast<uint8_t*>(&argHeader), sizeof(argHeader));
+	log_write_part(UART_OPCODE_TX_LOG, valPtr, valSize);
 }
 
 void cs_log_end() {
-	UartHandler::getInstance().writeMsgEnd(UART_OPCODE_TX_LOG);
+	log_write_end(UART_OPCODE_TX_LOG);
 }
 
 void cs_log_array(uint32_t fileNameHash, uint32_t lineNumber, uint8_t logLevel, bool addNewLine, const uint8_t* const ptr, size_t size, ElementType elementType, size_t elementSize) {
@@ -87,10 +190,10 @@ void cs_log_array(uint32_t fileNameHash, uint32_t lineNumber, uint8_t logLevel,
 	header.elementType = elementType;
 	header.elementSize = elementSize;
 	uint16_t msgSize = sizeof(header) + size;
-	UartHandler::getInstance().writeMsgStart(UART_OPCODE_TX_LOG_ARRAY, msgSize);
-	UartHandler::getInstance().writeMsgPart(UART_OPCODE_TX_LOG_ARRAY, reinterpret_cast<uint8_t*>(&header), sizeof(header));
-	UartHandler::getInstance().writeMsgPart(UART_OPCODE_TX_LOG_ARRAY, ptr, size);
-	UartHandler::getInstance().writeMsgEnd(UART_OPCODE_TX_LOG_ARRAY);
+	log_write_start(UART_OPCODE_TX_LOG_ARRAY, msgSize);
+	log_write_part(UART_OPCODE_TX_LOG_ARRAY, reinterpret_cast<uint8_t*>(&header), sizeof(header));
+	log_write_part(UART_OPCODE_TX_LOG_ARRAY, ptr, size);
+	log_write_end(UART_OPCODE_TX_LOG_ARRAY);
 }
 
 #endif // CS_SERIAL_NRF_LOG_ENABLED == 0
@@ -11,6 +11,7 @@
 #include <drivers/cs_RNG.h>
 #include <mesh/cs_Mesh.h>
 #include <mesh/cs_MeshCommon.h>
+#include <protocol/cs_UartMsgTypes.h>
 #include <uart/cs_UartHandler.h>
 #include <storage/cs_State.h>
 #include <third/std/function.h>
@@ -153,6 +154,19 @@ void Mesh::handleEvent(event_t & event) {
 				stop();
 			}
 			UartHandler::getInstance().writeMsg(UART_OPCODE_TX_MESH_ENABLED, &_enabled, 1);
+#endif
+			break;
+		}
+		case CS_TYPE::CMD_GET_MESH_STATS: {
+#if BUILD_MESHING == 1
+			cs_mesh_burst_stats_t burstStats = _modelSelector.getBurstStats();
+			UartHandler::getInstance().writeMsg(UART_OPCODE_TX_MESH_BURST_STATS, reinterpret_cast<uint8_t*>(&burstStats), sizeof(burstStats));
+			writeQueueStats(0, _modelMulticast.getQueueStats());
+			writeQueueStats(1, _modelMulticastAcked.getQueueStats());
+			writeQueueStats(2, _modelUnicast.getQueueStats());
+			writeQueueStats(3, _modelMulticastNeighbours.getQueueStats());
+			cs_scanned_device_ring_stats_t scannerStats = _scanner.getStats();
+			UartHandler::getInstance().writeMsg(UART_OPCODE_TX_MESH_SCANNER_STATS, reinterpret_cast<uint8_t*>(&scannerStats), sizeof(scannerStats));
 #endif
 			break;
 		}
@@ -176,6 +190,13 @@ void Mesh::handleEvent(event_t & event) {
 	}
 }
 
+void Mesh::writeQueueStats(uint8_t modelId, const cs_mesh_queue_stats_t& stats) {
+	uart_msg_mesh_queue_stats_t queueStats;
+	queueStats.modelId = modelId;
+	queueStats.stats   = stats;
+	UartHandler::getInstance().writeMsg(UART_OPCODE_TX_MESH_QUEUE_STATS, reinterpret_cast<uint8_t*>(&queueStats), sizeof(queueStats));
+}
+
 void Mesh::onTick(uint32_t tickCount) {
 	if (tickCount % (500/TICK_INTERVAL_MS) == 0) {
 		if (Stack::getInstance().isScanning()) {
@@ -221,10 +242,8 @@ void Mesh::onTick(uint32_t tickCount) {
 		_msgSender.sendTestMsg();
 	}
 #endif
-	_modelMulticast.tick(tickCount);
-	_modelMulticastAcked.tick(tickCount);
-	_modelMulticastNeighbours.tick(tickCount);
-	_modelUnicast.tick(tickCount);
+	_modelSelector.tick(tickCount);
+	_scanner.onTick(tickCount);
 }
 
 void Mesh::startSync() {
@@ -0,0 +1,131 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#include <mesh/cs_MeshBurstScheduler.h>
+
+static_assert(MESH_MODEL_BURST_RATE_MIN > 0, "Min rate must be larger than 0");
+static_assert(MESH_MODEL_BURST_RATE_MIN <= MESH_MODEL_BURST_RATE_INIT, "Invalid burst rates");
+static_assert(MESH_MODEL_BURST_RATE_INIT <= MESH_MODEL_BURST_RATE_MAX, "Invalid burst rates");
+static_assert(MESH_MODEL_BURST_RATE_MAX <= MESH_MODEL_BURST_CAPACITY, "Capacity must be at least the max rate");
+
+MeshBurstScheduler::MeshBurstScheduler():
+		_rate(MESH_MODEL_BURST_RATE_INIT),
+		_tokens(MESH_MODEL_BURST_RATE_INIT)
+{}
+
+bool MeshBurstScheduler::setTypeBudget(uint8_t type, uint8_t rate, uint8_t capacity) {
+	cs_mesh_type_budget_t* budget = getTypeBudget(type);
+	if (budget == nullptr) {
+		if (_numTypeBudgets == MESH_MODEL_BURST_TYPE_BUDGETS_MAX) {
+			return false;
+		}
+		budget = &(_typeBudgets[_numTypeBudgets++]);
+		budget->type = type;
+	}
+	budget->rate     = rate;
+	budget->capacity = (capacity < rate) ? rate : capacity;
+	budget->tokens   = budget->capacity;
+	return true;
+}
+
+void MeshBurstScheduler::startInterval() {
+	if (_busy) {
+		// The mesh stack couldn't keep up.
+		_rate /= 2;
+		if (_rate < MESH_MODEL_BURST_RATE_MIN) {
+			_rate = MESH_MODEL_BURST_RATE_MIN;
+		}
+	}
+	else if (_backlog) {
+		if (_tokens == 0 && _rate < MESH_MODEL_BURST_RATE_MAX) {
+			_rate++;
+		}
+	}
+	else if (_rate < MESH_MODEL_BURST_RATE_INIT) {
+		_rate++;
+	}
+	else if (_rate > MESH_MODEL_BURST_RATE_INIT) {
+		_rate--;
+	}
+
+	if (_rate < _stats.minRate) {
+		_stats.minRate = _rate;
+	}
+	if (_rate > _stats.maxRate) {
+		_stats.maxRate = _rate;
+	}
+	if (_backlog) {
+		_stats.numIntervalsBacklog++;
+	}
+	_busy    = false;
+	_backlog = false;
+
+	uint16_t tokens = _tokens + _rate;
+	_tokens = (tokens > MESH_MODEL_BURST_CAPACITY) ? MESH_MODEL_BURST_CAPACITY : tokens;
+
+	for (uint8_t i = 0; i < _numTypeBudgets; ++i) {
+		cs_mesh_type_budget_t& budget = _typeBudgets[i];
+		tokens = budget.tokens + budget.rate;
+		budget.tokens = (tokens > budget.capacity) ? budget.capacity : tokens;
+	}
+}
+
+bool MeshBurstScheduler::canSend() {
+	// Once the mesh stack is busy, stop sending for this interval.
+	return _tokens > 0 && !_busy;
+}
+
+bool MeshBurstScheduler::canSend(uint8_t type) {
+	if (!canSend()) {
+		return false;
+	}
+	cs_mesh_type_budget_t* budget = getTypeBudget(type);
+	if (budget != nullptr && budget->tokens == 0) {
+		_stats.numThrottled++;
+		return false;
+	}
+	return true;
+}
+
+void MeshBurstScheduler::onSent(uint8_t type, bool accepted) {
+	if (!accepted) {
+		_busy = true;
+		_stats.numBusy++;
+		return;
+	}
+	_stats.numSent++;
+	if (_tokens > 0) {
+		_tokens--;
+	}
+	cs_mesh_type_budget_t* budget = getTypeBudget(type);
+	if (budget != nullptr && budget->tokens > 0) {
+		budget->tokens--;
+	}
+}
+
+void MeshBurstScheduler::onQueueProcessed(uint8_t queueSize) {
+	if (queueSize > 0) {
+		_backlog = true;
+	}
+}
+
+uint8_t MeshBurstScheduler::getRate() {
+	return _rate;
+}
+
+const cs_mesh_burst_stats_t& MeshBurstScheduler::getStats() {
+	return _stats;
+}
+
+MeshBurstScheduler::cs_mesh_type_budget_t* MeshBurstScheduler::getTypeBudget(uint8_t type) {
+	for (uint8_t i = 0; i < _numTypeBudgets; ++i) {
+		if (_typeBudgets[i].type == type) {
+			return &(_typeBudgets[i]);
+		}
+	}
+	return nullptr;
+}
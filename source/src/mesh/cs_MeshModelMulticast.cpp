@@ -65,6 +65,10 @@ void MeshModelMulticast::configureSelf(dsm_handle_t appkeyHandle) {
 	APP_ERROR_CHECK(retCode);
 }
 
+void MeshModelMulticast::setBurstScheduler(MeshBurstScheduler* burstScheduler) {
+	_burstScheduler = burstScheduler;
+}
+
 void MeshModelMulticast::handleMsg(const access_message_rx_t * accessMsg) {
 	if (accessMsg->meta_data.p_core_metadata->source != NRF_MESH_RX_SOURCE_LOOPBACK) {
 		LOGMeshModelVerbose("Handle mesh msg. opcode=%u appkey=%u subnet=%u ttl=%u rssi=%i",
@@ -120,6 +124,10 @@ cs_ret_code_t MeshModelMulticast::sendMsg(const uint8_t* data, uint16_t len) {
 			LOGMeshModelInfo("sendMsg failed: no seq nr yet");
 			return ERR_BUSY;
 		}
+		case NRF_ERROR_NO_MEM: {
+			LOGMeshModelInfo("sendMsg failed: mesh TX queue is full");
+			return ERR_BUSY;
+		}
 		default: {
 			LOGw("sendMsg failed: %u", nrfCode);
 			return ERR_UNSPECIFIED;
@@ -146,65 +154,44 @@ cs_ret_code_t MeshModelMulticast::addToQueue(MeshUtil::cs_mesh_queue_item_t& ite
 	assert(item.broadcast == true, "Multicast only");
 	assert(item.reliable == false, "Unreliable only");
 
-	// Find an empty spot in the queue (transmissions == 0).
-	// Start looking at _queueIndexNext, then reverse iterate over the queue.
-	// Then set the new _queueIndexNext at the newly added item, so that it will be sent next.
-	// We do the reverse iterate, so that the chance is higher that
-	// the old _queueIndexNext will be sent quickly after this newly added item.
-	uint8_t index;
-	for (int i = _queueIndexNext + _queueSize; i > _queueIndexNext; --i) {
-		index = i % _queueSize;
-		cs_multicast_queue_item_t* it = &(_queue[index]);
-		if (it->metaData.transmissionsOrTimeout == 0) {
-			if (!MeshUtil::setMeshMessage((cs_mesh_model_msg_type_t)item.metaData.type, item.msgPayload.data, item.msgPayload.len, it->msg, sizeof(it->msg))) {
-				return ERR_WRONG_PAYLOAD_LENGTH;
-			}
-			memcpy(&(it->metaData), &(item.metaData), sizeof(item.metaData));
-			it->msgSize = msgSize;
-			LOGMeshModelVerbose("added to ind=%u", index);
-			_queueIndexNext = index;
-
-			// TODO: immediately start sending from queue.
-			// sendMsgFromQueue can keep up how many msgs have been sent this tick, so it knows how many can still be sent.
-			return ERR_SUCCESS;
-		}
+	if (item.metaData.transmissionsOrTimeout == 0) {
+		// Nothing to send.
+		return ERR_SUCCESS;
 	}
-	LOGw("queue is full");
-	return ERR_BUSY;
-}
 
-cs_ret_code_t MeshModelMulticast::remFromQueue(cs_mesh_model_msg_type_t type, uint16_t id) {
-	cs_ret_code_t retCode = ERR_NOT_FOUND;
-	for (int i = 0; i < _queueSize; ++i) {
-		if (_queue[i].metaData.id == id && _queue[i].metaData.type == type && _queue[i].metaData.transmissionsOrTimeout != 0) {
-			_queue[i].metaData.transmissionsOrTimeout = 0;
-			LOGMeshModelVerbose("removed from queue: ind=%u", i);
-			retCode = ERR_SUCCESS;
-		}
+	cs_multicast_queue_item_t* it = _queue.add(item.metaData.type, item.metaData.id, item.metaData.priority, item.replace, _tickCount);
+	if (it == nullptr) {
+		LOGw("queue is full");
+		return ERR_BUSY;
+	}
+	if (!MeshUtil::setMeshMessage((cs_mesh_model_msg_type_t)item.metaData.type, item.msgPayload.data, item.msgPayload.len, it->msg, sizeof(it->msg))) {
+		// The slot no longer holds a valid msg, so remove it.
+		_queue.remove(item.metaData.type, item.metaData.id);
+		return ERR_WRONG_PAYLOAD_LENGTH;
 	}
-	return retCode;
+	memcpy(&(it->metaData), &(item.metaData), sizeof(item.metaData));
+	it->msgSize = msgSize;
+	LOGMeshModelVerbose("added to queue: size=%u", _queue.size());
+
+	// TODO: immediately start sending from queue.
+	// sendMsgFromQueue can keep up how many msgs have been sent this tick, so it knows how many can still be sent.
+	return ERR_SUCCESS;
 }
 
-int MeshModelMulticast::getNextItemInQueue(bool priority) {
-	int index;
-	for (int i = _queueIndexNext; i < _queueIndexNext + _queueSize; i++) {
-		index = i % _queueSize;
-		if ((!priority || _queue[index].metaData.priority) && _queue[index].metaData.transmissionsOrTimeout > 0) {
-			return index;
-		}
+cs_ret_code_t MeshModelMulticast::remFromQueue(cs_mesh_model_msg_type_t type, uint16_t id) {
+	uint8_t numRemoved = _queue.remove(type, id);
+	if (numRemoved == 0) {
+		return ERR_NOT_FOUND;
 	}
-	return -1;
+	LOGMeshModelVerbose("removed from queue: num=%u", numRemoved);
+	return ERR_SUCCESS;
 }
 
 bool MeshModelMulticast::sendMsgFromQueue() {
-	int index = getNextItemInQueue(true);
-	if (index == -1) {
-		index = getNextItemInQueue(false);
-	}
-	if (index == -1) {
+	cs_multicast_queue_item_t* item = _queue.front();
+	if (item == nullptr) {
 		return false;
 	}
-	cs_multicast_queue_item_t* item = &(_queue[index]);
 //	if (item->type == CS_MESH_MODEL_TYPE_CMD_TIME) {
 //		Time time = SystemTime::now();
 //		if (time.isValid()) {
@@ -219,29 +206,49 @@ bool MeshModelMulticast::sendMsgFromQueue() {
 //		}
 //	}
 	cs_ret_code_t retCode = sendMsg(item->msg, item->msgSize);
+	_burstScheduler->onSent(item->metaData.type, retCode != ERR_BUSY);
 	if (retCode == ERR_BUSY) {
 		// Try again later.
 		return false;
 	}
 
 	--(item->metaData.transmissionsOrTimeout);
-	LOGMeshModelInfo("sent ind=%u transmissions_left=%u type=%u id=%u", index, item->metaData.transmissionsOrTimeout, item->metaData.type, item->metaData.id);
+	LOGMeshModelInfo("sent transmissions_left=%u type=%u id=%u", item->metaData.transmissionsOrTimeout, item->metaData.type, item->metaData.id);
 
-	// Next item will be sent next, so that items are sent interleaved.
-	_queueIndexNext = (index + 1) % _queueSize;
+	if (item->metaData.transmissionsOrTimeout == 0) {
+		_queue.popFront(_tickCount);
+	}
+	else {
+		// Send the other items first, so that items are sent interleaved.
+		_queue.rotate();
+	}
 	return true;
 }
 
 void MeshModelMulticast::processQueue() {
-	for (int i=0; i<MESH_MODEL_QUEUE_BURST_COUNT; ++i) {
+	// Skip items of which the type is over budget, until all items have been skipped.
+	uint8_t numSkipped = 0;
+	while (numSkipped < _queue.size() && _burstScheduler->canSend()) {
+		if (!_burstScheduler->canSend(_queue.front()->metaData.type)) {
+			_queue.rotate();
+			numSkipped++;
+			continue;
+		}
 		if (!sendMsgFromQueue()) {
 			break;
 		}
+		numSkipped = 0;
 	}
+	_burstScheduler->onQueueProcessed(_queue.size());
 }
 
 void MeshModelMulticast::tick(uint32_t tickCount) {
+	_tickCount = tickCount;
 	if (tickCount % (MESH_MODEL_QUEUE_PROCESS_INTERVAL_MS / TICK_INTERVAL_MS) == 0) {
 		processQueue();
 	}
 }
+
+const cs_mesh_queue_stats_t& MeshModelMulticast::getQueueStats() {
+	return _queue.getStats();
+}
@@ -180,17 +180,17 @@ void MeshModelMulticastAcked::sendReply(const access_message_rx_t* accessMsg, co
 }
 
 void MeshModelMulticastAcked::handleReply(MeshUtil::cs_mesh_received_msg_t & msg) {
-	if (_queueIndexInProgress == queue_index_none) {
+	if (_itemInProgress == nullptr) {
 		return;
 	}
 
 	stone_id_t srcId = msg.srcAddress;
 
 	// Find stone ID in list of stone IDs.
-	auto item = _queue[_queueIndexInProgress];
+	cs_multicast_acked_queue_item_t* item = _itemInProgress;
 	uint16_t stoneIndex = 0xFFFF;
-	for (uint8_t i = 0; i < item.numIds; ++i) {
-		if (item.stoneIdsPtr[i] == srcId) {
+	for (uint8_t i = 0; i < item->numIds; ++i) {
+		if (item->stoneIdsPtr[i] == srcId) {
 			stoneIndex = i;
 			break;
 		}
@@ -234,122 +234,103 @@ cs_ret_code_t MeshModelMulticastAcked::addToQueue(MeshUtil::cs_mesh_queue_item_t
 	assert(item.broadcast == true, "Multicast only");
 	assert(item.reliable == true, "Reliable only");
 
-	// Find an empty spot in the queue (transmissions == 0).
-	// Start looking at _queueIndexNext, then reverse iterate over the queue.
-	// Then set the new _queueIndexNext at the newly added item, so that it will be sent next.
-	// We do the reverse iterate, so that the chance is higher that
-	// the old _queueIndexNext will be sent quickly after this newly added item.
-	uint8_t index;
-	for (int i = _queueIndexNext; i < _queueIndexNext + queue_size; ++i) {
-		index = i % queue_size;
-		cs_multicast_acked_queue_item_t* it = &(_queue[index]);
-		if (it->metaData.transmissionsOrTimeout == 0) {
-
-			// Allocate and copy msg.
-			it->msgPtr = (uint8_t*)malloc(msgSize);
-			LOGMeshModelVerbose("msg alloc %p size=%u", it->msgPtr, msgSize);
-			if (it->msgPtr == NULL) {
-				return ERR_NO_SPACE;
-			}
-			if (!MeshUtil::setMeshMessage((cs_mesh_model_msg_type_t)item.metaData.type, item.msgPayload.data, item.msgPayload.len, it->msgPtr, msgSize)) {
-				LOGMeshModelVerbose("msg free %p", it->msgPtr);
-				free(it->msgPtr);
-				return ERR_WRONG_PAYLOAD_LENGTH;
-			}
+	cs_multicast_acked_queue_item_t* it = _queue.add(item.metaData.type, item.metaData.id, item.metaData.priority, false, _tickCount);
+	if (it == nullptr) {
+		LOGw("queue is full");
+		return ERR_BUSY;
+	}
 
-			// Allocate and copy stone ids.
-			it->stoneIdsPtr = (stone_id_t*)malloc(item.numIds * sizeof(stone_id_t));
-			LOGMeshModelVerbose("ids alloc %p size=%u", it->stoneIdsPtr, item.numIds * sizeof(stone_id_t));
-			if (it->stoneIdsPtr == NULL) {
-				LOGMeshModelVerbose("msg free %p", it->msgPtr);
-				free(it->msgPtr);
-				return ERR_NO_SPACE;
-			}
-			memcpy(it->stoneIdsPtr, item.stoneIdsPtr, item.numIds * sizeof(stone_id_t));
+	// Allocate and copy msg.
+	it->msgPtr = (uint8_t*)malloc(msgSize);
+	LOGMeshModelVerbose("msg alloc %p size=%u", it->msgPtr, msgSize);
+	if (it->msgPtr == NULL) {
+		_queue.remove(*it);
+		return ERR_NO_SPACE;
+	}
+	if (!MeshUtil::setMeshMessage((cs_mesh_model_msg_type_t)item.metaData.type, item.msgPayload.data, item.msgPayload.len, it->msgPtr, msgSize)) {
+		LOGMeshModelVerbose("msg free %p", it->msgPtr);
+		free(it->msgPtr);
+		_queue.remove(*it);
+		return ERR_WRONG_PAYLOAD_LENGTH;
+	}
 
-			// Copy meta data.
-			memcpy(&(it->metaData), &(item.metaData), sizeof(item.metaData));
-			it->numIds = item.numIds;
-			it->msgSize = msgSize;
+	// Allocate and copy stone ids.
+	it->stoneIdsPtr = (stone_id_t*)malloc(item.numIds * sizeof(stone_id_t));
+	LOGMeshModelVerbose("ids alloc %p size=%u", it->stoneIdsPtr, item.numIds * sizeof(stone_id_t));
+	if (it->stoneIdsPtr == NULL) {
+		LOGMeshModelVerbose("msg free %p", it->msgPtr);
+		free(it->msgPtr);
+		_queue.remove(*it);
+		return ERR_NO_SPACE;
+	}
+	memcpy(it->stoneIdsPtr, item.stoneIdsPtr, item.numIds * sizeof(stone_id_t));
 
-			LOGMeshModelVerbose("added to ind=%u", index);
-			_logArray(LogLevelMeshModelVerbose, true, it->msgPtr, it->msgSize);
+	// Copy meta data.
+	memcpy(&(it->metaData), &(item.metaData), sizeof(item.metaData));
+	it->numIds = item.numIds;
+	it->msgSize = msgSize;
 
-			// If queue was empty, we can start sending this item.
-			sendMsgFromQueue();
-			return ERR_SUCCESS;
-		}
-	}
-	LOGw("queue is full");
-	return ERR_BUSY;
+	LOGMeshModelVerbose("added to queue: size=%u", _queue.size());
+	_logArrayModule(LOG_MODULE_MESH_MODEL, SERIAL_VERBOSE, true, it->msgPtr, it->msgSize);
+
+	// If queue was empty, we can start sending this item.
+	sendMsgFromQueue();
+	return ERR_SUCCESS;
 }
 
 cs_ret_code_t MeshModelMulticastAcked::remFromQueue(cs_mesh_model_msg_type_t type, uint16_t id) {
 	cs_ret_code_t retCode = ERR_NOT_FOUND;
-	for (int i = 0; i < queue_size; ++i) {
-		if (_queue[i].metaData.id == id && _queue[i].metaData.type == type && _queue[i].metaData.transmissionsOrTimeout != 0) {
-			cancelQueueItem(i);
-			remQueueItem(i);
-			retCode = ERR_SUCCESS;
-		}
+	cs_multicast_acked_queue_item_t* item = _queue.get(type, id);
+	while (item != nullptr) {
+		cancelQueueItem(item);
+		freeQueueItem(item);
+		_queue.remove(*item);
+		retCode = ERR_SUCCESS;
+		item = _queue.get(type, id);
 	}
 	return retCode;
 }
 
-void MeshModelMulticastAcked::cancelQueueItem(uint8_t index) {
-	if (_queueIndexInProgress == index) {
+void MeshModelMulticastAcked::cancelQueueItem(cs_multicast_acked_queue_item_t* item) {
+	if (_itemInProgress == item) {
 		LOGe("TODO: Cancel progress");
-		_queueIndexInProgress = queue_index_none;
+		_itemInProgress = nullptr;
+		_ackedStonesBitmask.setNumBits(0);
 	}
 }
 
-void MeshModelMulticastAcked::remQueueItem(uint8_t index) {
-	_queue[index].metaData.transmissionsOrTimeout = 0;
-	LOGMeshModelVerbose("msg free %p", _queue[index].msgPtr);
-	free(_queue[index].msgPtr);
-	LOGMeshModelVerbose("ids free %p", _queue[index].stoneIdsPtr);
-	free(_queue[index].stoneIdsPtr);
-	_ackedStonesBitmask.setNumBits(0);
-	LOGMeshModelVerbose("removed from queue: ind=%u", index);
-}
-
-int MeshModelMulticastAcked::getNextItemInQueue(bool priority) {
-	int index;
-	for (int i = _queueIndexNext; i < _queueIndexNext + queue_size; i++) {
-		index = i % queue_size;
-		if ((!priority || _queue[index].metaData.priority) && _queue[index].metaData.transmissionsOrTimeout > 0) {
-			return index;
-		}
-	}
-	return -1;
+void MeshModelMulticastAcked::freeQueueItem(cs_multicast_acked_queue_item_t* item) {
+	LOGMeshModelVerbose("msg free %p", item->msgPtr);
+	free(item->msgPtr);
+	LOGMeshModelVerbose("ids free %p", item->stoneIdsPtr);
+	free(item->stoneIdsPtr);
+	LOGMeshModelVerbose("removed from queue: type=%u id=%u", item->metaData.type, item->metaData.id);
 }
 
 bool MeshModelMulticastAcked::sendMsgFromQueue() {
-	if (_queueIndexInProgress != queue_index_none) {
+	if (_itemInProgress != nullptr) {
 		return false;
 	}
-	int index = getNextItemInQueue(true);
-	if (index == -1) {
-		index = getNextItemInQueue(false);
-	}
-	if (index == -1) {
+	// Priority items are first in line.
+	cs_multicast_acked_queue_item_t* item = _queue.front();
+	if (item == nullptr) {
 		return false;
 	}
 
-	cs_multicast_acked_queue_item_t* item = &(_queue[index]);
+	if (!_burstScheduler->canSend(item->metaData.type)) {
+		return false;
+	}
 	if (!prepareForMsg(item)) {
 		return false;
 	}
 
 	cs_ret_code_t retCode = sendMsg(item->msgPtr, item->msgSize);
+	_burstScheduler->onSent(item->metaData.type, retCode == ERR_SUCCESS);
 	if (retCode != ERR_SUCCESS) {
 		return false;
 	}
-	_queueIndexInProgress = index;
-	LOGMeshModelInfo("sent ind=%u timeout=%u type=%u id=%u", index, item->metaData.transmissionsOrTimeout, item->metaData.type, item->metaData.id);
-
-	// Next item will be sent next, so that items are sent interleaved.
-	_queueIndexNext = (index + 1) % queue_size;
+	_itemInProgress = item;
+	LOGMeshModelInfo("sent timeout=%u type=%u id=%u", item->metaData.transmissionsOrTimeout, item->metaData.type, item->metaData.id);
 	return true;
 }
 
@@ -371,10 +352,10 @@ bool MeshModelMulticastAcked::prepareForMsg(cs_multicast_acked_queue_item_t* ite
 }
 
 void MeshModelMulticastAcked::checkDone() {
-	if (_queueIndexInProgress == queue_index_none) {
+	if (_itemInProgress == nullptr) {
 		return;
 	}
-	auto item = _queue[_queueIndexInProgress];
+	cs_multicast_acked_queue_item_t& item = *_itemInProgress;
 
 	// Check acks.
 	if (_ackedStonesBitmask.isAllBitsSet()) {
@@ -388,8 +369,8 @@ void MeshModelMulticastAcked::checkDone() {
 		UartHandler::getInstance().writeMsg(UART_OPCODE_TX_MESH_ACK_ALL_RESULT, (uint8_t*)&ackResult, sizeof(ackResult));
 		LOGMeshModelDebug("all success");
 
-		remQueueItem(_queueIndexInProgress);
-		_queueIndexInProgress = queue_index_none;
+		removeItemInProgress();
+		return;
 	}
 
 	// Check for timeout.
@@ -416,20 +397,26 @@ void MeshModelMulticastAcked::checkDone() {
 		UartHandler::getInstance().writeMsg(UART_OPCODE_TX_MESH_ACK_ALL_RESULT, (uint8_t*)&ackResult, sizeof(ackResult));
 		LOGMeshModelDebug("all timeout");
 
-		remQueueItem(_queueIndexInProgress);
-		_queueIndexInProgress = queue_index_none;
+		removeItemInProgress();
 	}
 	else {
 		--_processCallsLeft;
 	}
 }
 
+void MeshModelMulticastAcked::removeItemInProgress() {
+	freeQueueItem(_itemInProgress);
+	_queue.pop(*_itemInProgress, _tickCount);
+	_itemInProgress = nullptr;
+	_ackedStonesBitmask.setNumBits(0);
+}
+
 void MeshModelMulticastAcked::retryMsg() {
-	if (_queueIndexInProgress == queue_index_none) {
+	if (_itemInProgress == nullptr) {
 		return;
 	}
-	auto item = _queue[_queueIndexInProgress];
-	sendMsg(item.msgPtr, item.msgSize);
+	cs_ret_code_t retCode = sendMsg(_itemInProgress->msgPtr, _itemInProgress->msgSize);
+	_burstScheduler->onSent(_itemInProgress->metaData.type, retCode == ERR_SUCCESS);
 }
 
 void MeshModelMulticastAcked::processQueue() {
@@ -439,8 +426,17 @@ void MeshModelMulticastAcked::processQueue() {
 }
 
 void MeshModelMulticastAcked::tick(uint32_t tickCount) {
+	_tickCount = tickCount;
 	// Process only at retry interval.
 	if (tickCount % (MESH_MODEL_ACKED_RETRY_INTERVAL_MS / TICK_INTERVAL_MS) == 0) {
 		processQueue();
 	}
 }
+
+void MeshModelMulticastAcked::setBurstScheduler(MeshBurstScheduler* burstScheduler) {
+	_burstScheduler = burstScheduler;
+}
+
+const cs_mesh_queue_stats_t& MeshModelMulticastAcked::getQueueStats() {
+	return _queue.getStats();
+}
@@ -18,6 +18,18 @@ void MeshModelSelector::init(
 	_multicastAckedModel      = &multicastAckedModel;
 	_multicastNeighboursModel = &multicastNeighboursModel;
 	_unicastModel             = &unicastModel;
+
+	// Asset reports and state broadcasts can be queued in bursts, so they get a budget of their own,
+	// which leaves room for other messages.
+	_burstScheduler.setTypeBudget(CS_MESH_MODEL_TYPE_ASSET_INFO_MAC, 3, 6);
+	_burstScheduler.setTypeBudget(CS_MESH_MODEL_TYPE_ASSET_INFO_ID, 3, 6);
+	_burstScheduler.setTypeBudget(CS_MESH_MODEL_TYPE_STATE_0, 1, 3);
+	_burstScheduler.setTypeBudget(CS_MESH_MODEL_TYPE_STATE_1, 1, 3);
+
+	_multicastModel->setBurstScheduler(&_burstScheduler);
+	_multicastAckedModel->setBurstScheduler(&_burstScheduler);
+	_multicastNeighboursModel->setBurstScheduler(&_burstScheduler);
+	_unicastModel->setBurstScheduler(&_burstScheduler);
 }
 
 cs_ret_code_t MeshModelSelector::addToQueue(MeshUtil::cs_mesh_queue_item_t& item) {
@@ -63,7 +75,16 @@ cs_ret_code_t MeshModelSelector::remFromQueue(MeshUtil::cs_mesh_queue_item_t & i
 			return _multicastAckedModel->remFromQueue((cs_mesh_model_msg_type_t)item.metaData.type, item.metaData.id);
 		}
 		else {
-			return _multicastModel->remFromQueue((cs_mesh_model_msg_type_t)item.metaData.type, item.metaData.id);
+			// Remove from both unreliable models, except from the model that will replace the item in place.
+			cs_mesh_model_msg_type_t type = (cs_mesh_model_msg_type_t)item.metaData.type;
+			cs_ret_code_t retCode         = ERR_NOT_FOUND;
+			if (!(item.replace && !item.noHop) && _multicastModel->remFromQueue(type, item.metaData.id) == ERR_SUCCESS) {
+				retCode = ERR_SUCCESS;
+			}
+			if (!(item.replace && item.noHop) && _multicastNeighboursModel->remFromQueue(type, item.metaData.id) == ERR_SUCCESS) {
+				retCode = ERR_SUCCESS;
+			}
+			return retCode;
 		}
 	}
 	else {
@@ -75,3 +96,19 @@ cs_ret_code_t MeshModelSelector::remFromQueue(MeshUtil::cs_mesh_queue_item_t & i
 		}
 	}
 }
+
+void MeshModelSelector::tick(uint32_t tickCount) {
+	assert(_multicastModel != nullptr && _unicastModel != nullptr, "Model not set");
+	if (tickCount % (MESH_MODEL_QUEUE_PROCESS_INTERVAL_MS / TICK_INTERVAL_MS) == 0) {
+		_burstScheduler.startInterval();
+	}
+	// The reliable models send at most 1 msg each time, let them go first.
+	_multicastAckedModel->tick(tickCount);
+	_unicastModel->tick(tickCount);
+	_multicastModel->tick(tickCount);
+	_multicastNeighboursModel->tick(tickCount);
+}
+
+const cs_mesh_burst_stats_t& MeshModelSelector::getBurstStats() {
+	return _burstScheduler.getStats();
+}
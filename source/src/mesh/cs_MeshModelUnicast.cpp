@@ -235,15 +235,15 @@ cs_ret_code_t MeshModelUnicast::sendMsg(const uint8_t* msg, uint16_t msgSize, ui
 }
 
 void MeshModelUnicast::handleReliableStatus(access_reliable_status_t status) {
-	if (_queueIndexInProgress == queue_index_none) {
-		LOGe("No index in progress. status=%u", status);
+	if (_itemInProgress == nullptr) {
+		LOGe("No item in progress. status=%u", status);
 		return;
 	}
 
 	switch (status) {
 		case ACCESS_RELIABLE_TRANSFER_SUCCESS: {
 			LOGi("reliable msg success");
-			MeshUtil::printQueueItem("", _queue[_queueIndexInProgress].metaData);
+			MeshUtil::printQueueItem("", _itemInProgress->metaData);
 #if MESH_MODEL_TEST_MSG == 2
 			_acked++;
 			LOGi("acked=%u timedout=%u canceled=%u (acked=%u%%)", _acked, _timedout, _canceled, (_acked * 100) / (_acked + _timedout + _canceled));
@@ -252,7 +252,7 @@ void MeshModelUnicast::handleReliableStatus(access_reliable_status_t status) {
 		}
 		case ACCESS_RELIABLE_TRANSFER_TIMEOUT: {
 			LOGw("reliable msg timeout");
-			MeshUtil::printQueueItem("", _queue[_queueIndexInProgress].metaData);
+			MeshUtil::printQueueItem("", _itemInProgress->metaData);
 #if MESH_MODEL_TEST_MSG == 2
 			_timedout++;
 			LOGi("acked=%u timedout=%u canceled=%u (acked=%u%%)", _acked, _timedout, _canceled, (_acked * 100) / (_acked + _timedout + _canceled));
@@ -277,16 +277,16 @@ void MeshModelUnicast::checkDone() {
 	switch (_reliableStatus) {
 		case ACCESS_RELIABLE_TRANSFER_TIMEOUT:
 			sendFailedResultToUart(
-					_queue[_queueIndexInProgress].targetId,
-					(cs_mesh_model_msg_type_t)_queue[_queueIndexInProgress].metaData.type,
+					_itemInProgress->targetId,
+					(cs_mesh_model_msg_type_t)_itemInProgress->metaData.type,
 					ERR_TIMEOUT
 			);
 			done = true;
 			break;
 		case ACCESS_RELIABLE_TRANSFER_CANCELLED: {
 			sendFailedResultToUart(
-					_queue[_queueIndexInProgress].targetId,
-					(cs_mesh_model_msg_type_t)_queue[_queueIndexInProgress].metaData.type,
+					_itemInProgress->targetId,
+					(cs_mesh_model_msg_type_t)_itemInProgress->metaData.type,
 					ERR_CANCELED
 			);
 			done = true;
@@ -295,7 +295,7 @@ void MeshModelUnicast::checkDone() {
 		case ACCESS_RELIABLE_TRANSFER_SUCCESS:
 			if (_replyReceived) {
 				// TODO: get cmd type from payload in case of CS_MESH_MODEL_TYPE_CTRL_CMD
-				CommandHandlerTypes cmdType = MeshUtil::getCtrlCmdType((cs_mesh_model_msg_type_t)_queue[_queueIndexInProgress].metaData.type);
+				CommandHandlerTypes cmdType = MeshUtil::getCtrlCmdType((cs_mesh_model_msg_type_t)_itemInProgress->metaData.type);
 				result_packet_header_t ackResult(cmdType, ERR_SUCCESS);
 				UartHandler::getInstance().writeMsg(UART_OPCODE_TX_MESH_ACK_ALL_RESULT, (uint8_t*)&ackResult, sizeof(ackResult));
 				LOGMeshModelDebug("all success");
@@ -308,8 +308,9 @@ void MeshModelUnicast::checkDone() {
 
 	if (done) {
 		LOGMeshModelDebug("rem item");
-		remQueueItem(_queueIndexInProgress);
-		_queueIndexInProgress = queue_index_none;
+		freeQueueItem(_itemInProgress);
+		_queue.pop(*_itemInProgress, _tickCount);
+		_itemInProgress = nullptr;
 	}
 }
 
@@ -348,92 +349,77 @@ cs_ret_code_t MeshModelUnicast::addToQueue(MeshUtil::cs_mesh_queue_item_t& item)
 	assert(item.broadcast == false, "Unicast only");
 	assert(item.reliable == true, "Reliable only");
 
-	// Find an empty spot in the queue (transmissions == 0).
-	// Start looking at _queueIndexNext, then iterate over the queue.
-	uint8_t index;
-	for (int i = _queueIndexNext; i < _queueIndexNext + queue_size; ++i) {
-		index = i % queue_size;
-		cs_unicast_queue_item_t* it = &(_queue[index]);
-		if (it->metaData.transmissionsOrTimeout == 0) {
-			it->msgPtr = (uint8_t*)malloc(msgSize);
-			LOGMeshModelVerbose("alloc %p size=%u", it->msgPtr, msgSize);
-			if (it->msgPtr == NULL) {
-				return ERR_NO_SPACE;
-			}
-			if (!MeshUtil::setMeshMessage((cs_mesh_model_msg_type_t)item.metaData.type, item.msgPayload.data, item.msgPayload.len, it->msgPtr, msgSize)) {
-				LOGMeshModelVerbose("free %p", it->msgPtr);
-				free(it->msgPtr);
-				return ERR_WRONG_PAYLOAD_LENGTH;
-			}
-			memcpy(&(it->metaData), &(item.metaData), sizeof(item.metaData));
-			it->targetId = item.stoneIdsPtr[0];
-			it->msgSize = msgSize;
-			it->metaData.noHop = item.noHop;
-			LOGMeshModelVerbose("added to ind=%u", index);
-			_logArray(LogLevelMeshModelVerbose, true, it->msgPtr, it->msgSize);
-
-			// If queue was empty, we can start sending this item.
-			sendMsgFromQueue();
-			return ERR_SUCCESS;
-		}
+	cs_unicast_queue_item_t* it = _queue.add(item.metaData.type, item.metaData.id, item.metaData.priority, false, _tickCount);
+	if (it == nullptr) {
+		LOGw("queue is full");
+		return ERR_BUSY;
+	}
+	it->msgPtr = (uint8_t*)malloc(msgSize);
+	LOGMeshModelVerbose("alloc %p size=%u", it->msgPtr, msgSize);
+	if (it->msgPtr == NULL) {
+		_queue.remove(*it);
+		return ERR_NO_SPACE;
+	}
+	if (!MeshUtil::setMeshMessage((cs_mesh_model_msg_type_t)item.metaData.type, item.msgPayload.data, item.msgPayload.len, it->msgPtr, msgSize)) {
+		LOGMeshModelVerbose("free %p", it->msgPtr);
+		free(it->msgPtr);
+		_queue.remove(*it);
+		return ERR_WRONG_PAYLOAD_LENGTH;
 	}
-	LOGw("queue is full");
-	return ERR_BUSY;
+	memcpy(&(it->metaData), &(item.metaData), sizeof(item.metaData));
+	it->targetId = item.stoneIdsPtr[0];
+	it->msgSize = msgSize;
+	it->metaData.noHop = item.noHop;
+	LOGMeshModelVerbose("added to queue: size=%u", _queue.size());
+	_logArrayModule(LOG_MODULE_MESH_MODEL, SERIAL_VERBOSE, true, it->msgPtr, it->msgSize);
+
+	// If queue was empty, we can start sending this item.
+	sendMsgFromQueue();
+	return ERR_SUCCESS;
 }
 
 cs_ret_code_t MeshModelUnicast::remFromQueue(cs_mesh_model_msg_type_t type, uint16_t id) {
 	cs_ret_code_t retCode = ERR_NOT_FOUND;
-	for (int i = 0; i < queue_size; ++i) {
-		if (_queue[i].metaData.id == id && _queue[i].metaData.type == type && _queue[i].metaData.transmissionsOrTimeout != 0) {
-			cancelQueueItem(i);
-			remQueueItem(i);
-			retCode = ERR_SUCCESS;
-		}
+	cs_unicast_queue_item_t* item = _queue.get(type, id);
+	while (item != nullptr) {
+		cancelQueueItem(item);
+		freeQueueItem(item);
+		_queue.remove(*item);
+		retCode = ERR_SUCCESS;
+		item = _queue.get(type, id);
 	}
 	return retCode;
 }
 
-void MeshModelUnicast::cancelQueueItem(uint8_t index) {
-	if (_queueIndexInProgress == index) {
+void MeshModelUnicast::cancelQueueItem(cs_unicast_queue_item_t* item) {
+	if (_itemInProgress == item) {
 		LOGe("TODO: Cancel progress");
-		_queueIndexInProgress = queue_index_none;
+		_itemInProgress = nullptr;
 	}
 }
 
-void MeshModelUnicast::remQueueItem(uint8_t index) {
-	_queue[index].metaData.transmissionsOrTimeout = 0;
-	LOGMeshModelVerbose("free %p", _queue[index].msgPtr);
-	free(_queue[index].msgPtr);
-	LOGMeshModelVerbose("removed from queue: ind=%u", index);
-}
-
-int MeshModelUnicast::getNextItemInQueue(bool priority) {
-	int index;
-	for (int i = _queueIndexNext; i < _queueIndexNext + queue_size; ++i) {
-		index = i % queue_size;
-		if ((!priority || _queue[index].metaData.priority) && _queue[index].metaData.transmissionsOrTimeout > 0) {
-			return index;
-		}
-	}
-	return -1;
+void MeshModelUnicast::freeQueueItem(cs_unicast_queue_item_t* item) {
+	LOGMeshModelVerbose("free %p", item->msgPtr);
+	free(item->msgPtr);
+	LOGMeshModelVerbose("removed from queue: type=%u id=%u", item->metaData.type, item->metaData.id);
 }
 
 bool MeshModelUnicast::sendMsgFromQueue() {
-	if (_queueIndexInProgress != queue_index_none) {
+	if (_itemInProgress != nullptr) {
 		return false;
 	}
-	int index = getNextItemInQueue(true);
-	if (index == -1) {
-		index = getNextItemInQueue(false);
-	}
-	if (index == -1) {
+	// Priority items are first in line.
+	cs_unicast_queue_item_t* item = _queue.front();
+	if (item == nullptr) {
 		return false;
 	}
 
 	_replyReceived = false;
 	_reliableStatus = 255;
 
-	cs_unicast_queue_item_t* item = &(_queue[index]);
+	if (!_burstScheduler->canSend(item->metaData.type)) {
+		return false;
+	}
 	cs_ret_code_t retCode = setPublishAddress(item->targetId);
 	if (retCode != ERR_SUCCESS) {
 		return false;
@@ -445,15 +431,12 @@ bool MeshModelUnicast::sendMsgFromQueue() {
 	}
 
 	retCode = sendMsg(item->msgPtr, item->msgSize, item->metaData.transmissionsOrTimeout * 1000 * 1000);
+	_burstScheduler->onSent(item->metaData.type, retCode == ERR_SUCCESS);
 	if (retCode != ERR_SUCCESS) {
 		return false;
 	}
-	_queueIndexInProgress = index;
-	LOGMeshModelInfo("sent ind=%u timeout=%u type=%u id=%u targetId=%u", index, item->metaData.transmissionsOrTimeout, item->metaData.type, item->metaData.id, item->targetId);
-
-	// Next item will be sent next.
-	// Order might be messed up when some items are prioritized.
-	_queueIndexNext = (index + 1) % queue_size;
+	_itemInProgress = item;
+	LOGMeshModelInfo("sent timeout=%u type=%u id=%u targetId=%u", item->metaData.transmissionsOrTimeout, item->metaData.type, item->metaData.id, item->targetId);
 	return true;
 }
 
@@ -462,7 +445,16 @@ void MeshModelUnicast::processQueue() {
 }
 
 void MeshModelUnicast::tick(uint32_t tickCount) {
+	_tickCount = tickCount;
 	if (tickCount % (MESH_MODEL_QUEUE_PROCESS_INTERVAL_MS / TICK_INTERVAL_MS) == 0) {
 		processQueue();
 	}
 }
+
+void MeshModelUnicast::setBurstScheduler(MeshBurstScheduler* burstScheduler) {
+	_burstScheduler = burstScheduler;
+}
+
+const cs_mesh_queue_stats_t& MeshModelUnicast::getQueueStats() {
+	return _queue.getStats();
+}
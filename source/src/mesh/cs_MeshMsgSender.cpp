@@ -39,8 +39,7 @@ cs_ret_code_t MeshMsgSender::sendMsg(cs_mesh_msg_t *meshMsg) {
 	item.msgPayload.len = meshMsg->size;
 	item.msgPayload.data = meshMsg->payload;
 
-	remFromQueue(item);
-	return addToQueue(item);
+	return replaceInQueue(item);
 }
 
 cs_ret_code_t MeshMsgSender::sendTestMsg() {
@@ -95,9 +94,8 @@ cs_ret_code_t MeshMsgSender::sendSetTime(const cs_mesh_model_msg_time_t* packet,
 	item.msgPayload.len = sizeof(*packet);
 	item.msgPayload.data = (uint8_t*)packet;
 
-	// Remove old messages of same type, as only the latest is of interest.
-	remFromQueue(item);
-	return addToQueue(item);
+	// Replace old messages of same type, as only the latest is of interest.
+	return replaceInQueue(item);
 }
 
 cs_ret_code_t MeshMsgSender::sendNoop(uint8_t transmissions) {
@@ -111,9 +109,8 @@ cs_ret_code_t MeshMsgSender::sendNoop(uint8_t transmissions) {
 	item.reliable = false;
 	item.broadcast = true;
 
-	// Remove old messages of same type, as only the latest is of interest.
-	remFromQueue(item);
-	return addToQueue(item);
+	// Replace old messages of same type, as only the latest is of interest.
+	return replaceInQueue(item);
 }
 
 cs_ret_code_t MeshMsgSender::sendMultiSwitchItem(const internal_multi_switch_item_t* switchItem, const cmd_source_with_counter_t& source, uint8_t transmissions) {
@@ -162,9 +159,8 @@ cs_ret_code_t MeshMsgSender::sendMultiSwitchItem(const internal_multi_switch_ite
 			break;
 	}
 
-	// Remove old messages of same type and with same target id.
-	remFromQueue(item);
-	return addToQueue(item);
+	// Replace old messages of same type and with same target id.
+	return replaceInQueue(item);
 }
 
 cs_ret_code_t MeshMsgSender::sendBehaviourSettings(const behaviour_settings_t* packet, uint8_t transmissions) {
@@ -180,9 +176,8 @@ cs_ret_code_t MeshMsgSender::sendBehaviourSettings(const behaviour_settings_t* p
 	item.msgPayload.len = sizeof(*packet);
 	item.msgPayload.data = (uint8_t*)packet;
 
-	// Remove old messages of same type, as only the latest is of interest.
-	remFromQueue(item);
-	return addToQueue(item);
+	// Replace old messages of same type, as only the latest is of interest.
+	return replaceInQueue(item);
 }
 
 cs_ret_code_t MeshMsgSender::sendProfileLocation(const cs_mesh_model_msg_profile_location_t* packet, uint8_t transmissions) {
@@ -200,9 +195,8 @@ cs_ret_code_t MeshMsgSender::sendProfileLocation(const cs_mesh_model_msg_profile
 	item.msgPayload.len = sizeof(*packet);
 	item.msgPayload.data = (uint8_t*)packet;
 
-	// Remove old messages of same type, location, and profile.
-	remFromQueue(item);
-	return addToQueue(item);
+	// Replace old messages of same type, location, and profile.
+	return replaceInQueue(item);
 }
 
 cs_ret_code_t MeshMsgSender::sendTrackedDeviceRegister(const cs_mesh_model_msg_device_register_t* packet, uint8_t transmissions) {
@@ -218,9 +212,8 @@ cs_ret_code_t MeshMsgSender::sendTrackedDeviceRegister(const cs_mesh_model_msg_d
 	item.msgPayload.len = sizeof(*packet);
 	item.msgPayload.data = (uint8_t*)packet;
 
-	// Remove old messages of same type, and device id, as only the latest register is of interest.
-	remFromQueue(item);
-	return addToQueue(item);
+	// Replace old messages of same type, and device id, as only the latest register is of interest.
+	return replaceInQueue(item);
 }
 
 cs_ret_code_t MeshMsgSender::sendTrackedDeviceToken(const cs_mesh_model_msg_device_token_t* packet, uint8_t transmissions) {
@@ -236,9 +229,8 @@ cs_ret_code_t MeshMsgSender::sendTrackedDeviceToken(const cs_mesh_model_msg_devi
 	item.msgPayload.len = sizeof(*packet);
 	item.msgPayload.data = (uint8_t*)packet;
 
-	// Remove old messages of same type, and device id, as only the latest token is of interest.
-	remFromQueue(item);
-	return addToQueue(item);
+	// Replace old messages of same type, and device id, as only the latest token is of interest.
+	return replaceInQueue(item);
 }
 
 cs_ret_code_t MeshMsgSender::sendTrackedDeviceHeartbeat(const cs_mesh_model_msg_device_heartbeat_t* packet, uint8_t transmissions) {
@@ -254,9 +246,8 @@ cs_ret_code_t MeshMsgSender::sendTrackedDeviceHeartbeat(const cs_mesh_model_msg_
 	item.msgPayload.len = sizeof(*packet);
 	item.msgPayload.data = (uint8_t*)packet;
 
-	// Remove old messages of same type, and device id, as only the latest token is of interest.
-	remFromQueue(item);
-	return addToQueue(item);
+	// Replace old messages of same type, and device id, as only the latest token is of interest.
+	return replaceInQueue(item);
 }
 
 cs_ret_code_t MeshMsgSender::sendTrackedDeviceListSize(const cs_mesh_model_msg_device_list_size_t* packet, uint8_t transmissions) {
@@ -272,9 +263,8 @@ cs_ret_code_t MeshMsgSender::sendTrackedDeviceListSize(const cs_mesh_model_msg_d
 	item.msgPayload.len = sizeof(*packet);
 	item.msgPayload.data = (uint8_t*)packet;
 
-	// Remove old messages of same type, as only the latest is of interest.
-	remFromQueue(item);
-	return addToQueue(item);
+	// Replace old messages of same type, as only the latest is of interest.
+	return replaceInQueue(item);
 }
 
 cs_ret_code_t MeshMsgSender::addToQueue(MeshUtil::cs_mesh_queue_item_t & item) {
@@ -307,6 +297,16 @@ cs_ret_code_t MeshMsgSender::remFromQueue(MeshUtil::cs_mesh_queue_item_t & item)
 	return _selector->remFromQueue(item);
 }
 
+cs_ret_code_t MeshMsgSender::replaceInQueue(MeshUtil::cs_mesh_queue_item_t & item) {
+	if (!item.reliable) {
+		// The unreliable models replace the queued item in place, so that it keeps its place in the queue.
+		// Only items in the queues of other models are removed.
+		item.replace = true;
+	}
+	remFromQueue(item);
+	return addToQueue(item);
+}
+
 
 
 cs_ret_code_t MeshMsgSender::handleSendMeshCommand(mesh_control_command_packet_t* command, const cmd_source_with_counter_t& source) {
@@ -7,38 +7,41 @@
 
 #include <common/cs_Types.h>
 #include <events/cs_Event.h>
+#include <logging/cs_Logger.h>
 #include <mesh/cs_MeshScanner.h>
 #include <structs/cs_PacketsInternal.h>
 
 #include <cstring>
 
+static void staticDispatchScans(void* p_event_data, uint16_t event_size) {
+	MeshScanner* scanner = *reinterpret_cast<MeshScanner**>(p_event_data);
+	scanner->dispatchScans();
+}
+
 void MeshScanner::onScan(const nrf_mesh_adv_packet_rx_data_t *scanData) {
 	switch (scanData->p_metadata->source) {
 		case NRF_MESH_RX_SOURCE_SCANNER: {
+			scanned_device_t scannedDevice;
 
-			// Ignore when the CPU is busy.
-			uint16_t schedulerSpace = app_sched_queue_space_get();
-			if (schedulerSpace < MIN_SCHEDULER_FREE) {
-				LOGMeshWarning("Dropping scanned device: scheduler is quite full.");
-				return;
-			}
-
-			scanned_device_t _scannedDevice = {0};
-
-			memcpy(_scannedDevice.address,
+			memcpy(scannedDevice.address,
 					scanData->p_metadata->params.scanner.adv_addr.addr,
-					sizeof(_scannedDevice.address));
+					sizeof(scannedDevice.address));
 
-			_scannedDevice.resolvedPrivateAddress = scanData->p_metadata->params.scanner.adv_addr.addr_id_peer;
-			_scannedDevice.addressType = scanData->p_metadata->params.scanner.adv_addr.addr_type;
+			scannedDevice.resolvedPrivateAddress = scanData->p_metadata->params.scanner.adv_addr.addr_id_peer;
+			scannedDevice.addressType = scanData->p_metadata->params.scanner.adv_addr.addr_type;
 
-			_scannedDevice.rssi = scanData->p_metadata->params.scanner.rssi;
-			_scannedDevice.channel = scanData->p_metadata->params.scanner.channel;
-			_scannedDevice.dataSize = scanData->length;
-			_scannedDevice.data = const_cast<uint8_t*>(scanData->p_payload);
+			scannedDevice.rssi = scanData->p_metadata->params.scanner.rssi;
+			scannedDevice.channel = scanData->p_metadata->params.scanner.channel;
+			scannedDevice.dataSize = scanData->length;
+			scannedDevice.data = const_cast<uint8_t*>(scanData->p_payload);
 
-			event_t event(CS_TYPE::EVT_DEVICE_SCANNED, static_cast<void*>(&_scannedDevice), sizeof(_scannedDevice));
-			event.dispatch();
+			if (!_ring.push(scannedDevice, _tickCount, COALESCE_WINDOW_TICKS)) {
+				LOGMeshVerbose("Dropping scanned device: ring is full.");
+				return;
+			}
+			if (COALESCE_WINDOW_TICKS == 0 || _ring.size() >= RING_SIZE / 2) {
+				scheduleDispatch();
+			}
 			break;
 		}
 		case NRF_MESH_RX_SOURCE_GATT:
@@ -49,3 +52,41 @@ void MeshScanner::onScan(const nrf_mesh_adv_packet_rx_data_t *scanData) {
 			break;
 	}
 }
+
+void MeshScanner::onTick(uint32_t tickCount) {
+	_tickCount = tickCount;
+	dispatchScans();
+}
+
+void MeshScanner::scheduleDispatch() {
+	if (_dispatchScheduled) {
+		return;
+	}
+	// Leave space in the scheduler queue for other events, the next tick will dispatch the scans otherwise.
+	if (app_sched_queue_space_get() < SCHED_QUEUE_SIZE / 2) {
+		return;
+	}
+	MeshScanner* scanner = this;
+	if (app_sched_event_put(&scanner, sizeof(scanner), staticDispatchScans) == NRF_SUCCESS) {
+		_dispatchScheduled = true;
+	}
+}
+
+void MeshScanner::dispatchScans() {
+	_dispatchScheduled = false;
+	scanned_device_t scannedDevice;
+	for (uint8_t i = 0; i < BATCH_SIZE; ++i) {
+		if (!_ring.front(scannedDevice, _tickCount, COALESCE_WINDOW_TICKS)) {
+			return;
+		}
+		event_t event(CS_TYPE::EVT_DEVICE_SCANNED, static_cast<void*>(&scannedDevice), sizeof(scannedDevice));
+		event.dispatch();
+		_ring.pop();
+	}
+	// More scans left: let other events go first.
+	scheduleDispatch();
+}
+
+const cs_scanned_device_ring_stats_t& MeshScanner::getStats() {
+	return _ring.getStats();
+}
@@ -8,7 +8,9 @@
  */
 
 
+#ifndef HOST_TARGET
 #include <nrf_fstorage_sd.h>
+#endif
 
 #include <algorithm>
 #include <ble/cs_UUID.h>
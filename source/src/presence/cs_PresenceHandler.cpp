@@ -17,14 +17,25 @@
 
 //#define PRESENCE_HANDLER_TESTING_CODE
 
-PresenceHandler::PresenceHandler() {
+PresenceHandler::PresenceHandler()
+	: _tickSecondRoutine([this]() {
+		tickSecond();
+		return Coroutine::delayS(1);
+	})
+{
 	_store.clear();
 }
 
 cs_ret_code_t PresenceHandler::init() {
 	LOGi("init");
 
-	listen();
+	_tickSecondRoutine.start(Coroutine::delayS(1));
+	listen({
+		CS_TYPE::EVT_ADV_BACKGROUND_PARSED,
+		CS_TYPE::EVT_RECEIVED_PROFILE_LOCATION,
+		CS_TYPE::EVT_ASSET_ACCEPTED,
+		CS_TYPE::CMD_GET_PRESENCE
+	});
 	return ERR_SUCCESS;
 }
 
@@ -95,13 +106,6 @@ void PresenceHandler::handleEvent(event_t& event) {
 			event.result.returnCode   = ERR_SUCCESS;
 			return;
 		}
-		case CS_TYPE::EVT_TICK: {
-			TYPIFY(EVT_TICK)* tickCount = reinterpret_cast<TYPIFY(EVT_TICK)*>(event.data);
-			if (*tickCount % (1000 / TICK_INTERVAL_MS) == 0) {
-				tickSecond();
-			}
-			return;
-		}
 		default: return;
 	}
 }
@@ -177,6 +181,7 @@ PresenceMutation PresenceHandler::handleProfileLocation(profile_location_t profi
 
 		// Reset the timeout countdown.
 		record->timeoutCountdownSeconds = PRESENCE_TIMEOUT_SECONDS;
+		_store.touch(*record);
 		meshCountdown = record->meshSendCountdownSeconds;
 	}
 
@@ -286,6 +291,7 @@ void PresenceHandler::tickSecond() {
 				dispatchPresenceChangeEvent(
 						PresenceChange::PROFILE_LOCATION_EXIT,
 						presenceRecord.profileLocation);
+				_store.remove(presenceRecord);
 			}
 			else {
 				CsMath::Decrease(presenceRecord.meshSendCountdownSeconds);
@@ -311,13 +317,8 @@ void PresenceHandler::tickSecond() {
 
 
 PresenceHandler::PresenceRecord* PresenceHandler::clearOldestRecord(profile_location_t profileLocation) {
-	// Last option, overwrite oldest record.
-	auto oldestRecord = _store.begin();
-	for (auto record = _store.begin(); record != _store.end(); record++) {
-		if (record->timeoutCountdownSeconds < oldestRecord->timeoutCountdownSeconds) {
-			oldestRecord = record;
-		}
-	}
+	// Last option, overwrite oldest record: the one that was least recently refreshed.
+	auto oldestRecord = _store.replace(*_store.getLeastRecent(), profileLocation);
 
 	LOGPresenceHandlerDebug("Overwriting oldest presence record");
 	*oldestRecord = PresenceRecord(profileLocation);
@@ -12,7 +12,6 @@
 #include <logging/cs_Logger.h>
 #include <encryption/cs_RC5.h>
 #include <events/cs_EventDispatcher.h>
-#include <processing/cs_CommandHandler.h>
 #include <storage/cs_State.h>
 #include <time/cs_SystemTime.h>
 #include <util/cs_Utils.h>
@@ -35,13 +34,13 @@
 
 BackgroundAdvertisementHandler::BackgroundAdvertisementHandler() {
 	State::getInstance().get(CS_TYPE::CONFIG_SPHERE_ID, &_sphereId, sizeof(_sphereId));
-	EventDispatcher::getInstance().addListener(this);
+	listen({CS_TYPE::EVT_DEVICE_SCANNED, CS_TYPE::EVT_ADV_BACKGROUND});
 }
 
 void BackgroundAdvertisementHandler::parseServicesAdvertisement(scanned_device_t* scannedDevice) {
 	uint32_t errCode;
 	cs_data_t serviceUuids;
-	errCode = CsUtils::findAdvType(BLE_GAP_AD_TYPE_16BIT_SERVICE_UUID_MORE_AVAILABLE, scannedDevice->data, scannedDevice->dataSize, &serviceUuids);
+	errCode = scannedDevice->findAdvType(BLE_GAP_AD_TYPE_16BIT_SERVICE_UUID_MORE_AVAILABLE, &serviceUuids);
 	if (errCode != ERR_SUCCESS) {
 		return;
 	}
@@ -72,7 +71,7 @@ void BackgroundAdvertisementHandler::parseServicesAdvertisement(scanned_device_t
 void BackgroundAdvertisementHandler::parseAdvertisement(scanned_device_t* scannedDevice) {
 	uint32_t errCode;
 	cs_data_t manufacturerData;
-	errCode = CsUtils::findAdvType(BLE_GAP_AD_TYPE_MANUFACTURER_SPECIFIC_DATA, scannedDevice->data, scannedDevice->dataSize, &manufacturerData);
+	errCode = scannedDevice->findAdvType(BLE_GAP_AD_TYPE_MANUFACTURER_SPECIFIC_DATA, &manufacturerData);
 	if (errCode != ERR_SUCCESS) {
 		return;
 	}
@@ -11,6 +11,7 @@
 #include <cfg/cs_DeviceTypes.h>
 #include <cfg/cs_Strings.h>
 #include <drivers/cs_GpRegRet.h>
+#include <drivers/cs_Serial.h>
 #include <logging/cs_Logger.h>
 #include <encryption/cs_KeysAndAccess.h>
 #include <ipc/cs_IpcRamData.h>
@@ -46,6 +47,8 @@ void reset(void* p_context) {
 			LOGw("Unknown reset code: %u", cmd);
 			return;
 	}
+	LOG_FLUSH();
+	serial_flush();
 	sd_nvic_SystemReset();
 }
 
@@ -196,6 +199,8 @@ void CommandHandler::handleCommand(
 			return dispatchEventForCommand(CS_TYPE::CMD_GET_ADC_CHANNEL_SWAPS, commandData, source, result);
 		case CTRL_CMD_GET_RAM_STATS:
 			return dispatchEventForCommand(CS_TYPE::CMD_GET_RAM_STATS, commandData, source, result);
+		case CTRL_CMD_GET_BOOT_TIMINGS:
+			return dispatchEventForCommand(CS_TYPE::CMD_GET_BOOT_TIMINGS, commandData, source, result);
 		case CTRL_CMD_MICROAPP_GET_INFO:
 			return dispatchEventForCommand(CS_TYPE::CMD_MICROAPP_GET_INFO, commandData, source, result);
 		case CTRL_CMD_MICROAPP_VALIDATE:
@@ -1026,6 +1031,7 @@ EncryptionAccessLevel CommandHandler::getRequiredAccessLevel(const CommandHandle
 		case CTRL_CMD_GET_GPREGRET:
 		case CTRL_CMD_GET_ADC_CHANNEL_SWAPS:
 		case CTRL_CMD_GET_RAM_STATS:
+		case CTRL_CMD_GET_BOOT_TIMINGS:
 		case CTRL_CMD_MICROAPP_GET_INFO:
 		case CTRL_CMD_MICROAPP_UPLOAD:
 		case CTRL_CMD_MICROAPP_VALIDATE:
@@ -6,6 +6,7 @@
  */
 
 #include "processing/cs_PowerSampling.h"
+#include "processing/cs_PowerKernel.h"
 
 #include "common/cs_Types.h"
 #include "drivers/cs_RTC.h"
@@ -17,8 +18,6 @@
 #include "protocol/cs_Packets.h"
 #include "storage/cs_State.h"
 #include "structs/buffer/cs_AdcBuffer.h"
-#include "third/SortMedian.h"
-#include "third/optmed.h"
 #include "time/cs_SystemTime.h"
 
 #include <cmath>
@@ -55,21 +54,9 @@ PowerSampling::PowerSampling() :
 		_switchHist(switchHistSize)
 {
 	_adc = &(ADC::getInstance());
-	_powerMilliWattHist = new CircularBuffer<int32_t>(POWER_SAMPLING_RMS_WINDOW_SIZE);
-	_currentRmsMilliAmpHist = new CircularBuffer<int32_t>(POWER_SAMPLING_RMS_WINDOW_SIZE);
-	_voltageRmsMilliVoltHist = new CircularBuffer<int32_t>(POWER_SAMPLING_RMS_WINDOW_SIZE);
-	_filteredCurrentRmsHistMA = new CircularBuffer<int32_t>(POWER_SAMPLING_RMS_WINDOW_SIZE);
 	_logsEnabled.asInt = 0;
 }
 
-#if POWER_SAMPLING_RMS_WINDOW_SIZE == 7
-#define opt_med(arr) opt_med7(arr)
-#elif POWER_SAMPLING_RMS_WINDOW_SIZE == 9
-#define opt_med(arr) opt_med9(arr)
-#elif POWER_SAMPLING_RMS_WINDOW_SIZE == 25
-#define opt_med(arr) opt_med25(arr)
-#endif
-
 #ifdef PRINT_POWER_SAMPLES
 static int printPower = 0;
 #endif
@@ -140,23 +127,8 @@ void PowerSampling::init(const boards_config_t& boardConfig) {
 	_boardPowerZero = boardConfig.powerZero;
 
 	LOGi(FMT_INIT, "buffers");
-	_powerMilliWattHist->init(); // Allocates buffer
-	_currentRmsMilliAmpHist->init(); // Allocates buffer
-	_voltageRmsMilliVoltHist->init(); // Allocates buffer
-	_filteredCurrentRmsHistMA->init(); // Allocates buffer
 	_switchHist.init(); // Allocates buffer
 
-	// Init moving median filter
-	unsigned halfWindowSize = POWER_SAMPLING_CURVE_HALF_WINDOW_SIZE;
-//	unsigned halfWindowSize = 5;  // Takes 0.74ms
-//	unsigned halfWindowSize = 16; // Takes 0.93ms
-	unsigned windowSize = halfWindowSize * 2 + 1;
-	uint16_t bufSize = AdcBuffer::getInstance().getChannelLength();
-	unsigned blockCount = (bufSize + halfWindowSize*2) / windowSize; // Shouldn't have a remainder!
-	_filterParams = new MedianFilter(halfWindowSize, blockCount);
-	_inputSamples = new PowerVector(bufSize + halfWindowSize*2);
-	_outputSamples = new PowerVector(bufSize);
-
 	LOGd(FMT_INIT, "ADC");
 	adc_config_t adcConfig;
 	adcConfig.channelCount = 2;
@@ -624,67 +596,19 @@ void PowerSampling::calculateCurrentZero(adc_buffer_id_t bufIndex) {
 	}
 }
 
-/*
- * The median filter uses its own data structure to optimally filter the data. A median filter does filter outliers by
- * a particular smoothing operation. It sorts a sequence of values and picks the one in the center: the median. To
- * optimize this operation it makes sense that if we slide the sliding window with sorted values we do not sort these
- * values again and again. When moving the window we insert the new value from the right into the sorted array. For
- * that it is logical to use a linked list. This means that the MedianFilter object we use requires us copying the
- * data into it. An expensive operation.
- *
- * TODO: Do not work with "half window sizes". Just work with a window size and enforce its size to be odd. That
- * to pick the median you only need to sort half of the values (plus one) is an implementation detail.
- *
- * TODO: Create an in-place version of a median filter. It is possible to have a linked list (of half the window size
- * plus one) that contains a list of indices into the array with values. For example, let us assume a full window size
- * of 5 and ignore the border starting at index 2. Now let's sort the first 5 values [4 2 0 1 3]. Hence, the value at
- * index 4 is the smallest. We replace value at index 2 with the middle one (which is at index 0). Now we shift to the
- * right, hence index 0 falls out [4 2 1 3], and index 5 shifts in. Let's assume 5 is a value between 4 and 2, then we
- * have [4 5 2 1 3] and replace the value at index 3 with the value at index 2. Note that the value at index 0 is
- * copied into 2 and then into 3. If we do not want this, we need to have a separate array the size of the sliding
- * window and only copy the value when it is shifted out. We will have a copy assignment operation for each value,
- * however still our RAM use is much less because we only need place for values at the window. Note that we can
- * actually sort up to the half so the examples should be [4 2 0 ? ?], then [4 2 ? ?], then [4 5 2 ? ?]. In the
- * particular case where 5 > 2 we need an additional value [4 2 1 ?] or we do not know if it should be [4 2 5 ? ?] or
- * [4 2 1 ? ?]. So in this case we would need a min(.) operation on half (minus one) of the remaining array.
- *
- * TODO: Keep the newest buffer at t=0 "raw" and only filter the t=-1. If the operation is done in-place we have also
- * filtered buffers for t=-2 and t=-3 (assuming four buffers). We can use the buffer at t=0 and t=-2 for padding the
- * buffer at t=-1. This means we do not pad with copies of values but with real values. All operations that require
- * smoothed values will have a delay of one sine wave (20ms on 50Hz).
- */
-
 /**
  * This function performs a median filter with respect to the given channel.
+ *
+ * The filter walks the interleaved samples directly, and pads with the first and last sample of the buffer.
+ *
+ * TODO: Keep the newest buffer at t=0 "raw" and only filter the t=-1. We can use the buffer at t=0 and t=-2 for
+ * padding the buffer at t=-1. This means we do not pad with copies of values but with real values. All operations that
+ * require smoothed values will have a delay of one sine wave (20ms on 50Hz).
  */
 void PowerSampling::filter(adc_buffer_id_t bufIndexIn, adc_buffer_id_t bufIndexOut, adc_channel_id_t channel_id) {
-
-	// Pad the start of the input vector with the first sample in the buffer
-	uint16_t j = 0;
-	adc_sample_value_t padded_value = AdcBuffer::getInstance().getValue(bufIndexIn, channel_id, 0);
-	for (uint16_t i = 0; i < _filterParams->half; ++i, ++j) {
-		_inputSamples->at(j) = padded_value;
-	}
-
-	// Copy samples from buffer to input vector
-	uint8_t channel_length = AdcBuffer::getInstance().getChannelLength();
-	for (int i = 0; i < channel_length; ++i, ++j) {
-		_inputSamples->at(j) = AdcBuffer::getInstance().getValue(bufIndexIn, channel_id, i);
-	}
-
-	// Pad the end of the buffer with the last sample in the buffer
-	padded_value = AdcBuffer::getInstance().getValue(bufIndexIn, channel_id, channel_length - 1);
-	for (uint16_t i = 0; i < _filterParams->half; ++i, ++j) {
-		_inputSamples->at(j) = padded_value;
-	}
-
-	// Filter the data
-	sort_median(*_filterParams, *_inputSamples, *_outputSamples);
-
-	// Copy the result back into the buffer
-	for (int i = 0; i < AdcBuffer::getInstance().getChannelLength(); ++i) {
-		AdcBuffer::getInstance().setValue(bufIndexOut, channel_id, i, _outputSamples->at(i));
-	}
+	adc_sample_value_t* input  = AdcBuffer::getInstance().getBuffer(bufIndexIn)->samples + channel_id;
+	adc_sample_value_t* output = AdcBuffer::getInstance().getBuffer(bufIndexOut)->samples + channel_id;
+	_medianFilter.run(input, output, AdcBuffer::getChannelLength(), AdcBuffer::getChannelCount());
 }
 
 bool PowerSampling::calculatePower(adc_buffer_id_t bufIndex) {
@@ -696,19 +620,14 @@ bool PowerSampling::calculatePower(adc_buffer_id_t bufIndex) {
 	// Calculatate power, Irms, and Vrms
 	//////////////////////////////////////////////////
 
-	// The int64_t sum is large enough: 2^63 / (2^12 * 1000 * 2^12 * 1000) = 5*10^5. Many more samples than the 100 we use.
-	int64_t pSum = 0;
-	int64_t cSquareSum = 0;
-	int64_t vSquareSum = 0;
-	int64_t current;
-	int64_t voltage;
-	for (adc_sample_value_id_t i = 0; i < numSamples; ++i) {
-		voltage = (int64_t)AdcBuffer::getInstance().getValue(bufIndex, VOLTAGE_CHANNEL_IDX, i) * 1024 - _avgZeroVoltage;
-		current = (int64_t)AdcBuffer::getInstance().getValue(bufIndex, CURRENT_CHANNEL_IDX, i) * 1024 - _avgZeroCurrent;
-		vSquareSum += (voltage * voltage) / (1024*1024);
-		cSquareSum += (current * current) / (1024*1024);
-		pSum +=       (current * voltage) / (1024*1024);
-	}
+	// The kernel walks the interleaved samples directly.
+	static_assert(VOLTAGE_CHANNEL_IDX == 0 && CURRENT_CHANNEL_IDX == 1 && AdcBuffer::getChannelCount() == 2,
+			"Power kernel expects interleaved voltage and current samples.");
+	power_kernel_sums_t sums = calculatePowerSums(
+			AdcBuffer::getInstance().getBuffer(bufIndex)->samples, numSamples, _avgZeroVoltage, _avgZeroCurrent);
+	int64_t pSum       = sums.powerSum;
+	int64_t cSquareSum = sums.currentSquareSum;
+	int64_t vSquareSum = sums.voltageSquareSum;
 	if (!isValidBuf(bufIndex)) {
 		LOGPowerSamplingWarn("buf %u invalid", bufIndex);
 		return false;
@@ -743,19 +662,8 @@ bool PowerSampling::calculatePower(adc_buffer_id_t bufIndex) {
 //	}
 
 	// Calculate median when there are enough values in history, else calculate the average.
-	_filteredCurrentRmsHistMA->push(filteredCurrentRmsMA);
-	int32_t filteredCurrentRmsMedianMA;
-	if (_filteredCurrentRmsHistMA->full()) {
-		memcpy(_histCopy, _filteredCurrentRmsHistMA->getBuffer(), _filteredCurrentRmsHistMA->getMaxByteSize());
-		filteredCurrentRmsMedianMA = opt_med(_histCopy);
-	}
-	else {
-		int64_t currentRmsSumMA = 0;
-		for (uint16_t i=0; i<_filteredCurrentRmsHistMA->size(); ++i) {
-			currentRmsSumMA += _filteredCurrentRmsHistMA->operator[](i);
-		}
-		filteredCurrentRmsMedianMA = currentRmsSumMA / _filteredCurrentRmsHistMA->size();
-	}
+	_filteredCurrentRmsHistMA.push(filteredCurrentRmsMA);
+	int32_t filteredCurrentRmsMedianMA = _filteredCurrentRmsHistMA.medianOrAverage();
 
 	// Now that Irms is known: first check the soft fuse.
 	// Wait some time, for the measurement to converge.. why does this have to take so long?
@@ -771,19 +679,8 @@ bool PowerSampling::calculatePower(adc_buffer_id_t bufIndex) {
 	/////////////////////////////////////////////////////////
 
 	// Calculate median when there are enough values in history, else calculate the average.
-	_currentRmsMilliAmpHist->push(currentRmsMA);
-	int32_t currentRmsMedianMA;
-	if (_currentRmsMilliAmpHist->full()) {
-		memcpy(_histCopy, _currentRmsMilliAmpHist->getBuffer(), _currentRmsMilliAmpHist->getMaxByteSize());
-		currentRmsMedianMA = opt_med(_histCopy);
-	}
-	else {
-		int64_t currentRmsMilliAmpSum = 0;
-		for (uint16_t i=0; i<_currentRmsMilliAmpHist->size(); ++i) {
-			currentRmsMilliAmpSum += _currentRmsMilliAmpHist->operator[](i);
-		}
-		currentRmsMedianMA = currentRmsMilliAmpSum / _currentRmsMilliAmpHist->size();
-	}
+	_currentRmsMilliAmpHist.push(currentRmsMA);
+	int32_t currentRmsMedianMA = _currentRmsMilliAmpHist.medianOrAverage();
 
 //	// Exponential moving average of the median
 //	int64_t discountCurrent = 200;
@@ -792,18 +689,8 @@ bool PowerSampling::calculatePower(adc_buffer_id_t bufIndex) {
 	_avgCurrentRmsMilliAmp = currentRmsMedianMA;
 
 	// Calculate median when there are enough values in history, else calculate the average.
-	_voltageRmsMilliVoltHist->push(voltageRmsMilliVolt);
-	if (_voltageRmsMilliVoltHist->full()) {
-		memcpy(_histCopy, _voltageRmsMilliVoltHist->getBuffer(), _voltageRmsMilliVoltHist->getMaxByteSize());
-		_avgVoltageRmsMilliVolt = opt_med(_histCopy);
-	}
-	else {
-		int64_t voltageRmsMilliVoltSum = 0;
-		for (uint16_t i=0; i<_voltageRmsMilliVoltHist->size(); ++i) {
-			voltageRmsMilliVoltSum += _voltageRmsMilliVoltHist->operator[](i);
-		}
-		_avgVoltageRmsMilliVolt = voltageRmsMilliVoltSum / _voltageRmsMilliVoltHist->size();
-	}
+	_voltageRmsMilliVoltHist.push(voltageRmsMilliVolt);
+	_avgVoltageRmsMilliVolt = _voltageRmsMilliVoltHist.medianOrAverage();
 
 	// Calculate apparent power: current_rms * voltage_rms
 	__attribute__((unused)) uint32_t powerMilliWattApparent = (int64_t)_avgCurrentRmsMilliAmp * _avgVoltageRmsMilliVolt / 1000;
@@ -11,8 +11,8 @@
 #include <processing/cs_Scanner.h>
 #include <storage/cs_State.h>
 
-#define LOGScannerDebug LOGvv
-#define LOGScannerVerbose LOGvv
+#define LOGScannerDebug(fmt, ...)   LOGMd(LOG_MODULE_SCANNER, fmt, ##__VA_ARGS__)
+#define LOGScannerVerbose(fmt, ...) LOGMv(LOG_MODULE_SCANNER, fmt, ##__VA_ARGS__)
 
 Scanner::Scanner() :
 	_opCode(SCAN_START),
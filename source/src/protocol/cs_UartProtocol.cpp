@@ -5,8 +5,8 @@
  * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
  */
 
-#include <ble/cs_Nordic.h>
 #include <protocol/cs_UartProtocol.h>
+#include <util/cs_Crc16.h>
 
 void UartProtocol::escape(uint8_t& val) {
 	val ^= UART_ESCAPE_FLIP_MASK;
@@ -18,9 +18,9 @@ void UartProtocol::unEscape(uint8_t& val) {
 }
 
 uint16_t UartProtocol::crc16(const uint8_t * data, uint16_t size) {
-	return crc16_compute(data, size, NULL);
+	return ::crc16(data, size);
 }
 
 void UartProtocol::crc16(const uint8_t * data, const uint16_t size, uint16_t& crc) {
-	crc = crc16_compute(data, size, &crc);
+	crc = ::crc16(data, size, &crc);
 }
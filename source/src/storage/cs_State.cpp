@@ -24,20 +24,22 @@
 #error "TICK_INTERVAL_MS must not be larger than STATE_RETRY_STORE_DELAY_MS"
 #endif
 
-// Define to get debug logs.
-//#define CS_STATE_DEBUG_LOGS
-
-#ifdef CS_STATE_DEBUG_LOGS
-#define LOGStateDebug LOGd
-#else
-#define LOGStateDebug LOGnone
-#endif
+// Set CS_LOG_LEVEL_STATE to SERIAL_DEBUG to get debug logs.
+#define LOGStateDebug(fmt, ...) LOGMd(LOG_MODULE_STATE, fmt, ##__VA_ARGS__)
 
 void storageErrorCallback(cs_storage_operation_t operation, CS_TYPE type, cs_state_id_t id) {
 	State::getInstance().handleStorageError(operation, type, id);
 }
 
-State::State() : _storage(NULL), _boardsConfig(NULL) {
+void storageReadCallback(const cs_state_data_t & data) {
+	State::getInstance().handleStoredValue(data);
+}
+
+State::State() :
+		_storage(NULL),
+		_boardsConfig(NULL),
+		_storeQueue(STATE_RETRY_STORE_DELAY_MS / TICK_INTERVAL_MS)
+{
 }
 
 State::~State() {
@@ -64,10 +66,64 @@ void State::init(boards_config_t* boardsConfig) {
 		return;
 	}
 	_storage->setErrorCallback(storageErrorCallback);
+	loadAllFromFlash();
 	EventDispatcher::getInstance().addListener(this);
 	setInitialized();
 }
 
+/**
+ * Instead of searching flash for each type once it's used, which walks over all records every time.
+ */
+cs_ret_code_t State::loadAllFromFlash() {
+	_numLoadedValues = 0;
+	cs_ret_code_t retCode = _storage->readAll(storageReadCallback);
+	if (retCode != ERR_SUCCESS) {
+		// Values will be read from flash once they're used.
+		LOGw("Failed to load values from flash: err=%u", retCode);
+		return retCode;
+	}
+	_loadedAllFromFlash = true;
+	LOGi("Loaded %u values from flash", _numLoadedValues);
+	return ERR_SUCCESS;
+}
+
+void State::handleStoredValue(const cs_state_data_t & data) {
+	size16_t typeSize = TypeSize(data.type);
+	if (typeSize == 0 || DefaultLocation(data.type) != PersistenceMode::FLASH) {
+		LOGStateDebug("Skip stored type=%u id=%u", to_underlying_type(data.type), data.id);
+		return;
+	}
+	if (data.id != 0 && !hasMultipleIds(data.type)) {
+		LOGStateDebug("Skip stored type=%u id=%u", to_underlying_type(data.type), data.id);
+		return;
+	}
+	if (data.size != CS_ROUND_UP_TO_MULTIPLE_OF_POWER_OF_2(typeSize, 4)) {
+		// Like a read of this value, which would fail: the default will be used.
+		LOGw("stored size = %u ram size = %u type=%u", data.size, typeSize, to_underlying_type(data.type));
+		return;
+	}
+	if (hasMultipleIds(data.type)) {
+		// Create the ids list, so that addToRam() adds the id to it.
+		auto typeIter = findInIdsCache(data.type);
+		if (typeIter == _idsCache.end() || typeIter->type != data.type) {
+			std::vector<cs_state_id_t>* ids = new std::vector<cs_state_id_t>();
+			if (ids == nullptr) {
+				return;
+			}
+			_idsCache.insert(typeIter, cs_id_list_t(data.type, ids));
+		}
+	}
+	size16_t index;
+	if (findInRam(data.type, data.id, index) == ERR_SUCCESS) {
+		// A duplicate: the latest value comes last.
+		memcpy(_ram_data_register[index].value, data.value, typeSize);
+		return;
+	}
+	cs_state_data_t & ramData = addToRam(data.type, data.id, typeSize);
+	memcpy(ramData.value, data.value, typeSize);
+	_numLoadedValues++;
+}
+
 cs_ret_code_t State::get(const CS_TYPE type, void *value, const size16_t size) {
 	cs_state_data_t data(type, (uint8_t*)value, size);
 	return get(data);
@@ -170,7 +226,8 @@ cs_ret_code_t State::get(cs_state_data_t & data, const PersistenceMode mode) {
 				}
 			}
 			else {
-				ret_code = _storage->read(ram_data);
+				// After all values were loaded, a value that is not in ram, is not in flash either.
+				ret_code = _loadedAllFromFlash ? ERR_NOT_FOUND : _storage->read(ram_data);
 
 				// Temp code, to retain old reset counter.
 				if (ram_data.type == CS_TYPE::STATE_RESET_COUNTER && ret_code == ERR_NOT_FOUND) {
@@ -366,6 +423,16 @@ cs_ret_code_t State::getDefaultValue(cs_state_data_t & data) {
 }
 
 cs_ret_code_t State::findInRam(const CS_TYPE & type, cs_state_id_t id, size16_t & index_in_ram) {
+	if (_ramIndex.size() == _ram_data_register.size()) {
+		uint16_t index = _ramIndex.find(to_underlying_type(type), id);
+		if (index == StateRamIndex::NOT_FOUND) {
+			return ERR_NOT_FOUND;
+		}
+		index_in_ram = index;
+		return ERR_SUCCESS;
+	}
+
+	// The index could not be allocated, fall back to linear search.
 	for (size16_t i = 0; i < _ram_data_register.size(); ++i) {
 		if (_ram_data_register[i].type == type && _ram_data_register[i].id == id) {
 			index_in_ram = i;
@@ -417,6 +484,9 @@ cs_state_data_t & State::addToRam(const CS_TYPE & type, cs_state_id_t id, size16
 	cs_state_data_t data(type, id, nullptr, size);
 	allocate(data);
 	_ram_data_register.push_back(data);
+	if (!_ramIndex.set(to_underlying_type(type), id, _ram_data_register.size() - 1)) {
+		LOGe("Failed to index type=%u id=%u", to_underlying_type(type), id);
+	}
 	LOGStateDebug("Added type=%u id=%u size=%u val=%p", data.type, data.id, data.size, data.value);
 	LOGStateDebug("RAM index now of size %i", _ram_data_register.size());
 	addId(type, id);
@@ -430,7 +500,16 @@ cs_ret_code_t State::removeFromRam(const CS_TYPE & type, cs_state_id_t id) {
 	if (ret_code == ERR_SUCCESS) {
 		cs_state_data_t* ram_data = &(_ram_data_register[index_in_ram]);
 		free(ram_data->value);
-		_ram_data_register.erase(_ram_data_register.begin() + index_in_ram);
+		_ramIndex.remove(to_underlying_type(type), id);
+
+		// Order of the register doesn't matter: move the last item to the removed spot, instead of shifting all items.
+		size16_t lastIndex = _ram_data_register.size() - 1;
+		if (index_in_ram != lastIndex) {
+			_ram_data_register[index_in_ram] = _ram_data_register[lastIndex];
+			cs_state_data_t & moved = _ram_data_register[index_in_ram];
+			_ramIndex.set(to_underlying_type(moved.type), moved.id, index_in_ram);
+		}
+		_ram_data_register.pop_back();
 	}
 	remId(type, id);
 	return ERR_SUCCESS;
@@ -598,12 +677,11 @@ cs_ret_code_t State::getIdsFromFlash(const CS_TYPE & type, std::vector<cs_state_
 		LOGw("Type %u can't have multiple IDs", to_underlying_type(type));
 		return ERR_WRONG_PARAMETER;
 	}
-	for (auto typeIter = _idsCache.begin(); typeIter < _idsCache.end(); typeIter++) {
-		if (typeIter->type == type) {
-			LOGi("Already retrieved ids");
-			retIds = typeIter->ids;
-			return ERR_SUCCESS;
-		}
+	auto typeIter = findInIdsCache(type);
+	if (typeIter != _idsCache.end() && typeIter->type == type) {
+		LOGi("Already retrieved ids");
+		retIds = typeIter->ids;
+		return ERR_SUCCESS;
 	}
 	std::vector<cs_state_id_t>* ids = new std::vector<cs_state_id_t>();
 	if (ids == nullptr) {
@@ -611,7 +689,11 @@ cs_ret_code_t State::getIdsFromFlash(const CS_TYPE & type, std::vector<cs_state_
 	}
 
 	cs_state_id_t id;
-	cs_ret_code_t retCode = _storage->findFirst(type, id);
+	cs_ret_code_t retCode = ERR_NOT_FOUND;
+	// After all values were loaded, types that are not in the cache have no ids.
+	if (!_loadedAllFromFlash) {
+		retCode = _storage->findFirst(type, id);
+	}
 	while (retCode == ERR_SUCCESS) {
 		// TODO: Bart 2019-12-12 Maybe use an unordered set instead of vector?
 		bool found = false;
@@ -632,14 +714,14 @@ cs_ret_code_t State::getIdsFromFlash(const CS_TYPE & type, std::vector<cs_state_
 		return retCode;
 	}
 	cs_id_list_t idList(type, ids);
-	_idsCache.push_back(idList);
+	_idsCache.insert(typeIter, idList);
 	retIds = ids;
 	LOGStateDebug("Got ids from flash type=%u", to_underlying_type(type));
-#ifdef CS_STATE_DEBUG_LOGS
-	for (auto idIter = ids->begin(); idIter < ids->end(); idIter++) {
-		LOGStateDebug("id=%u", *idIter);
+	if constexpr (logModuleCompiled(LOG_MODULE_STATE, SERIAL_DEBUG)) {
+		for (auto idIter = ids->begin(); idIter < ids->end(); idIter++) {
+			LOGStateDebug("id=%u", *idIter);
+		}
 	}
-#endif
 	return ERR_SUCCESS;
 }
 
@@ -649,39 +731,44 @@ cs_ret_code_t State::getIdsFromFlash(const CS_TYPE & type, std::vector<cs_state_
  *     - If not, add the ID to the list.
  */
 cs_ret_code_t State::addId(const CS_TYPE & type, cs_state_id_t id) {
-	for (auto typeIter = _idsCache.begin(); typeIter < _idsCache.end(); typeIter++) {
-		if (typeIter->type == type) {
-			// TODO: Bart 2019-12-12 Maybe use an unordered set instead of vector?
-			for (auto idIter = typeIter->ids->begin(); idIter < typeIter->ids->end(); idIter++) {
-				if (*idIter == id) {
-					return ERR_SUCCESS;
-				}
-			}
-			LOGd("Added id=%u to type=%u", id, to_underlying_type(type));
-			typeIter->ids->push_back(id);
-			break;
+	auto typeIter = findInIdsCache(type);
+	if (typeIter == _idsCache.end() || typeIter->type != type) {
+		return ERR_SUCCESS;
+	}
+	// TODO: Bart 2019-12-12 Maybe use an unordered set instead of vector?
+	for (auto idIter = typeIter->ids->begin(); idIter < typeIter->ids->end(); idIter++) {
+		if (*idIter == id) {
+			return ERR_SUCCESS;
 		}
 	}
+	LOGd("Added id=%u to type=%u", id, to_underlying_type(type));
+	typeIter->ids->push_back(id);
 	return ERR_SUCCESS;
 }
 
 cs_ret_code_t State::remId(const CS_TYPE & type, cs_state_id_t id) {
-	for (auto typeIter = _idsCache.begin(); typeIter < _idsCache.end(); typeIter++) {
-		if (typeIter->type == type) {
-			auto ids = typeIter->ids;
-			for (auto idIter = ids->begin(); idIter < ids->end(); idIter++) {
-				if (*idIter == id) {
-					LOGd("Removed id=%u to type=%u", id, to_underlying_type(type));
-					ids->erase(idIter);
-					return ERR_SUCCESS;
-				}
-			}
-			break;
+	auto typeIter = findInIdsCache(type);
+	if (typeIter == _idsCache.end() || typeIter->type != type) {
+		return ERR_SUCCESS;
+	}
+	auto ids = typeIter->ids;
+	for (auto idIter = ids->begin(); idIter < ids->end(); idIter++) {
+		if (*idIter == id) {
+			LOGd("Removed id=%u to type=%u", id, to_underlying_type(type));
+			ids->erase(idIter);
+			return ERR_SUCCESS;
 		}
 	}
 	return ERR_SUCCESS;
 }
 
+std::vector<cs_id_list_t>::iterator State::findInIdsCache(const CS_TYPE & type) {
+	return std::lower_bound(_idsCache.begin(), _idsCache.end(), type,
+			[](const cs_id_list_t & idList, const CS_TYPE & type) {
+				return to_underlying_type(idList.type) < to_underlying_type(type);
+			});
+}
+
 /*
  * Implementation as details on https://github.com/crownstone/bluenet/issues/86.
  */
@@ -725,26 +812,8 @@ cs_ret_code_t State::addToQueue(StateQueueOp operation, const CS_TYPE & type, cs
 	switch (operation) {
 		case CS_STATE_QUEUE_OP_WRITE:
 		case CS_STATE_QUEUE_OP_REM_ONE_ID_OF_TYPE: {
-			for (size_t i=0; i<_store_queue.size(); ++i) {
-				// A write operation replaces a remove operation, and vice versa.
-				if ((_store_queue[i].type == type && _store_queue[i].id == id) &&
-						(
-								(_store_queue[i].operation == CS_STATE_QUEUE_OP_WRITE) ||
-								(_store_queue[i].operation == CS_STATE_QUEUE_OP_REM_ONE_ID_OF_TYPE)
-						)
-				) {
-					// n-th time, now execute becomes true and for throttle init_counter will be set as well
-					if (mode == StateQueueMode::THROTTLE) {
-						_store_queue[i].init_counter = delayTicks;
-					}
-					else {
-						_store_queue[i].counter = delayTicks;
-					}
-					_store_queue[i].execute = true;
-					found = true;
-					break;
-				}
-			}
+			// A write operation replaces a remove operation, and vice versa.
+			found = _storeQueue.update(to_underlying_type(type), id, delayTicks, mode);
 			break;
 		}
 		case CS_STATE_QUEUE_OP_FACTORY_RESET: {
@@ -769,97 +838,78 @@ cs_ret_code_t State::addToQueue(StateQueueOp operation, const CS_TYPE & type, cs
 				// also add to the queue (drop through)
 			}
 		}
-	
+
 		// add new item to the queue
-		cs_state_store_queue_t item;
-		item.operation = operation;
-		item.type = type;
-		item.id = id;
-		item.counter = delayTicks;
-		item.init_counter = 0;
-		item.execute = (mode == StateQueueMode::DELAY);
-		_store_queue.push_back(item);
-	}
-	LOGStateDebug("queue is now of size %u", _store_queue.size());
+		bool execute = (mode == StateQueueMode::DELAY);
+		if (_storeQueue.add(operation, to_underlying_type(type), id, delayTicks, execute) == StateStoreQueue::NONE) {
+			LOGe("Could not add to queue");
+			return ERR_NO_SPACE;
+		}
+	}
+	LOGStateDebug("queue is now of size %u", _storeQueue.size());
 	return ERR_SUCCESS;
 }
 
 /**
- * Each tick, decrease the counter of all items.
- * If a counter is 0, store that item, and remove it from the list.
- * But if storage is busy, retry later by not removing item from queue, and setting counter again.
+ * Each tick, execute the items that are due.
+ * If storage is busy, retry later by keeping the item in the queue, with the retry delay.
+ * Items with an init counter are kept for that many ticks, during which they can be updated.
+ *
+ * The writes of a tick are committed to storage as a group, writes that can't be started then come back via the
+ * storage error callback.
  */
 void State::delayedStoreTick() {
-	if (!_store_queue.empty()) {
-		LOGStateDebug("delayedStoreTick");
+	_storeQueue.tick();
+	if (_storeQueue.getDue() == StateStoreQueue::NONE) {
+		return;
 	}
 	cs_ret_code_t ret_code;
 	size16_t index_in_ram;
-	for (auto it = _store_queue.begin(); it != _store_queue.end(); /*it++*/) {
-		if (it->counter == 0) {
-			bool keepItem = false;
-			if (it->execute) {
-				switch (it->operation) {
+	uint16_t handle;
+	_storage->beginCommitGroup();
+	while ((handle = _storeQueue.getDue()) != StateStoreQueue::NONE) {
+		LOGStateDebug("delayedStoreTick");
+		cs_state_store_queue_t& item = _storeQueue.get(handle);
+		CS_TYPE type = static_cast<CS_TYPE>(item.type);
+		bool retry = false;
+		if (item.execute) {
+			switch (item.operation) {
 				case CS_STATE_QUEUE_OP_WRITE: {
-					if (it->execute == false) {
-						// fall through with removeItem is true, don't execute
-						break;
-					}
-					ret_code = findInRam(it->type, it->id, index_in_ram);
+					ret_code = findInRam(type, item.id, index_in_ram);
 					if (ret_code == ERR_SUCCESS) {
 						ret_code = storeInFlash(index_in_ram);
 						if (ret_code == ERR_BUSY) {
-							keepItem = true;
+							retry = true;
 						}
 					}
 					break;
 				}
 				case CS_STATE_QUEUE_OP_REM_ONE_ID_OF_TYPE: {
-					ret_code = removeFromFlash(it->type, it->id);
+					ret_code = removeFromFlash(type, item.id);
 					if (ret_code == ERR_BUSY) {
-						keepItem = true;
+						retry = true;
 					}
 					break;
 				}
 				case CS_STATE_QUEUE_OP_FACTORY_RESET: {
 					ret_code = _storage->factoryReset();
 					if (!handleFactoryResetResult(ret_code)) {
-						keepItem = true;
+						retry = true;
 					}
 					break;
 				}
 				case CS_STATE_QUEUE_OP_GC: {
 					ret_code = _storage->garbageCollect();
 					if (ret_code == ERR_BUSY) {
-						keepItem = true;
+						retry = true;
 					}
 					break;
 				}
-				}
 			}
-			if (it->execute && it->init_counter != 0) {
-				// When init_counter is set, add the item again, but don't execute.
-				keepItem = true;
-				it->execute = false;
-				it->counter = it->init_counter;
-			}
-			else {
-				// Add to queue again with fixed retry delay.
-				it->counter = STATE_RETRY_STORE_DELAY_MS / TICK_INTERVAL_MS;
-			}
-
-			if (!keepItem) {
-				it = _store_queue.erase(it);
-			}
-			else {
-				it++;
-			}
-		}
-		else {
-			it->counter--;
-			it++;
 		}
+		_storeQueue.done(handle, retry);
 	}
+	_storage->commitGroup();
 }
 
 void State::startWritesToFlash() {
@@ -872,7 +922,7 @@ void State::factoryReset() {
 	_performingFactoryReset = true;
 
 	// Clear queue, to remove any pending writes.
-	_store_queue.clear();
+	_storeQueue.clear();
 
 	cs_ret_code_t retCode = ERR_BUSY;
 	if (_startedWritingToFlash) {
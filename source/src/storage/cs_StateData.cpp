@@ -256,6 +256,7 @@ cs_ret_code_t getDefault(cs_state_data_t & data, const boards_config_t& boardsCo
 	case CS_TYPE::CMD_ENABLE_LOG_POWER:
 	case CS_TYPE::CMD_ENABLE_LOG_VOLTAGE:
 	case CS_TYPE::CMD_ENABLE_MESH:
+	case CS_TYPE::CMD_GET_MESH_STATS:
 	case CS_TYPE::CMD_FACTORY_RESET:
 	case CS_TYPE::CMD_INC_CURRENT_RANGE:
 	case CS_TYPE::CMD_INC_VOLTAGE_RANGE:
@@ -388,6 +389,7 @@ cs_ret_code_t getDefault(cs_state_data_t & data, const boards_config_t& boardsCo
 	case CS_TYPE::CMD_GET_GPREGRET:
 	case CS_TYPE::CMD_GET_ADC_CHANNEL_SWAPS:
 	case CS_TYPE::CMD_GET_RAM_STATS:
+	case CS_TYPE::CMD_GET_BOOT_TIMINGS:
 	case CS_TYPE::EVT_GENERIC_TEST:
 	case CS_TYPE::CMD_TEST_SET_TIME:
 	case CS_TYPE::CMD_MICROAPP_GET_INFO:
@@ -579,6 +581,7 @@ PersistenceMode DefaultLocation(CS_TYPE const & type) {
 	case CS_TYPE::CMD_RESET_DELAYED:
 	case CS_TYPE::CMD_ENABLE_ADVERTISEMENT:
 	case CS_TYPE::CMD_ENABLE_MESH:
+	case CS_TYPE::CMD_GET_MESH_STATS:
 	case CS_TYPE::CMD_TOGGLE_ADC_VOLTAGE_VDD_REFERENCE_PIN:
 	case CS_TYPE::CMD_ENABLE_ADC_DIFFERENTIAL_CURRENT:
 	case CS_TYPE::CMD_ENABLE_ADC_DIFFERENTIAL_VOLTAGE:
@@ -640,6 +643,7 @@ PersistenceMode DefaultLocation(CS_TYPE const & type) {
 	case CS_TYPE::CMD_GET_GPREGRET:
 	case CS_TYPE::CMD_GET_ADC_CHANNEL_SWAPS:
 	case CS_TYPE::CMD_GET_RAM_STATS:
+	case CS_TYPE::CMD_GET_BOOT_TIMINGS:
 	case CS_TYPE::EVT_GENERIC_TEST:
 	case CS_TYPE::CMD_TEST_SET_TIME:
 	case CS_TYPE::CMD_MICROAPP_GET_INFO:
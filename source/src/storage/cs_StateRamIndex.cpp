@@ -0,0 +1,111 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#include <storage/cs_StateRamIndex.h>
+#include <cstdlib>
+
+StateRamIndex::~StateRamIndex() {
+	free(_slots);
+}
+
+uint16_t StateRamIndex::probe(uint16_t type, cs_state_id_t id) const {
+	uint16_t slot = hash(type, id);
+	while (_slots[slot].used && !(_slots[slot].type == type && _slots[slot].id == id)) {
+		slot = (slot + 1) & (_capacity - 1);
+	}
+	return slot;
+}
+
+uint16_t StateRamIndex::find(uint16_t type, cs_state_id_t id) const {
+	if (_count == 0) {
+		return NOT_FOUND;
+	}
+	uint16_t slot = probe(type, id);
+	if (!_slots[slot].used) {
+		return NOT_FOUND;
+	}
+	return _slots[slot].index;
+}
+
+bool StateRamIndex::set(uint16_t type, cs_state_id_t id, uint16_t index) {
+	// Keep load factor at most 1/2, so that probe sequences stay short, and there is always an empty slot.
+	if ((_count + 1) * 2 > _capacity) {
+		uint16_t newCapacity = (_capacity == 0) ? INITIAL_CAPACITY : _capacity * 2;
+		if (newCapacity <= _capacity || !resize(newCapacity)) {
+			return false;
+		}
+	}
+	uint16_t slot = probe(type, id);
+	if (!_slots[slot].used) {
+		_slots[slot].used = true;
+		_slots[slot].type = type;
+		_slots[slot].id = id;
+		_count++;
+	}
+	_slots[slot].index = index;
+	return true;
+}
+
+void StateRamIndex::remove(uint16_t type, cs_state_id_t id) {
+	if (_count == 0) {
+		return;
+	}
+	uint16_t hole = probe(type, id);
+	if (!_slots[hole].used) {
+		return;
+	}
+	_slots[hole].used = false;
+	_count--;
+
+	// Backward shift: move entries of the same cluster into the hole, when the hole lies between their home slot
+	// and their current slot.
+	uint16_t mask = _capacity - 1;
+	uint16_t slot = hole;
+	while (true) {
+		slot = (slot + 1) & mask;
+		if (!_slots[slot].used) {
+			return;
+		}
+		uint16_t home = hash(_slots[slot].type, _slots[slot].id);
+		uint16_t distToHole = (hole - home) & mask;
+		uint16_t distToSlot = (slot - home) & mask;
+		if (distToHole < distToSlot) {
+			_slots[hole] = _slots[slot];
+			_slots[slot].used = false;
+			hole = slot;
+		}
+	}
+}
+
+void StateRamIndex::clear() {
+	for (uint16_t i = 0; i < _capacity; ++i) {
+		_slots[i].used = false;
+	}
+	_count = 0;
+}
+
+bool StateRamIndex::resize(uint16_t capacity) {
+	slot_t* oldSlots = _slots;
+	uint16_t oldCapacity = _capacity;
+
+	slot_t* newSlots = static_cast<slot_t*>(calloc(capacity, sizeof(slot_t)));
+	if (newSlots == nullptr) {
+		return false;
+	}
+	_slots = newSlots;
+	_capacity = capacity;
+	_count = 0;
+	for (uint16_t i = 0; i < oldCapacity; ++i) {
+		if (oldSlots[i].used) {
+			uint16_t slot = probe(oldSlots[i].type, oldSlots[i].id);
+			_slots[slot] = oldSlots[i];
+			_count++;
+		}
+	}
+	free(oldSlots);
+	return true;
+}
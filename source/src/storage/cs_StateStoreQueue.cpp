@@ -0,0 +1,152 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#include <storage/cs_StateStoreQueue.h>
+
+bool StateStoreQueue::update(uint16_t type, cs_state_id_t id, uint32_t counter, StateQueueMode mode) {
+	uint16_t handle = _index.find(type, id);
+	if (handle == StateRamIndex::NOT_FOUND) {
+		return false;
+	}
+	// n-th time, now execute becomes true and for throttle init_counter will be set as well
+	if (mode == StateQueueMode::THROTTLE) {
+		_items[handle].init_counter = counter;
+	}
+	else {
+		reschedule(handle, counter);
+	}
+	_items[handle].execute = true;
+	return true;
+}
+
+uint16_t StateStoreQueue::add(StateQueueOp operation, uint16_t type, cs_state_id_t id, uint32_t counter, bool execute) {
+	if (_items.size() >= NONE) {
+		return NONE;
+	}
+	uint16_t handle = _items.size();
+	if (isIndexed(operation) && !_index.set(type, id, handle)) {
+		return NONE;
+	}
+	cs_state_store_queue_t item;
+	item.operation    = operation;
+	item.type         = type;
+	item.id           = id;
+	item.dueTickCount = _tickCount + counter + 1;
+	item.init_counter = 0;
+	item.sequence     = _sequence++;
+	item.heapIndex    = _heap.size();
+	item.execute      = execute;
+	_items.push_back(item);
+	_heap.push_back(handle);
+	siftUp(item.heapIndex);
+	return handle;
+}
+
+void StateStoreQueue::tick() {
+	_tickCount++;
+}
+
+uint16_t StateStoreQueue::getDue() const {
+	if (_heap.empty()) {
+		return NONE;
+	}
+	uint16_t handle = _heap[0];
+	if (static_cast<int32_t>(_items[handle].dueTickCount - _tickCount) > 0) {
+		return NONE;
+	}
+	return handle;
+}
+
+void StateStoreQueue::done(uint16_t handle, bool retry) {
+	cs_state_store_queue_t& item = _items[handle];
+	if (item.execute && item.init_counter != 0) {
+		// When init_counter is set, add the item again, but don't execute.
+		item.execute = false;
+		reschedule(handle, item.init_counter);
+	}
+	else if (retry) {
+		// Add to queue again with fixed retry delay.
+		reschedule(handle, _retryCounter);
+	}
+	else {
+		remove(handle);
+	}
+}
+
+void StateStoreQueue::clear() {
+	_items.clear();
+	_heap.clear();
+	_index.clear();
+}
+
+void StateStoreQueue::reschedule(uint16_t handle, uint32_t counter) {
+	uint16_t heapIndex = _items[handle].heapIndex;
+	_items[handle].dueTickCount = _tickCount + counter + 1;
+	siftUp(heapIndex);
+	siftDown(_items[handle].heapIndex);
+}
+
+void StateStoreQueue::remove(uint16_t handle) {
+	cs_state_store_queue_t& item = _items[handle];
+	if (isIndexed(item.operation)) {
+		_index.remove(item.type, item.id);
+	}
+
+	// Take the last handle of the heap out, and put it at the place of the removed item.
+	uint16_t heapIndex = item.heapIndex;
+	uint16_t lastHeapHandle = _heap.back();
+	_heap.pop_back();
+	if (heapIndex < _heap.size()) {
+		setHeap(heapIndex, lastHeapHandle);
+		siftUp(heapIndex);
+		siftDown(_items[lastHeapHandle].heapIndex);
+	}
+
+	// Move the last item to the handle of the removed item.
+	uint16_t lastHandle = _items.size() - 1;
+	if (handle != lastHandle) {
+		_items[handle] = _items[lastHandle];
+		_heap[_items[handle].heapIndex] = handle;
+		if (isIndexed(_items[handle].operation)) {
+			_index.set(_items[handle].type, _items[handle].id, handle);
+		}
+	}
+	_items.pop_back();
+}
+
+void StateStoreQueue::siftUp(uint16_t heapIndex) {
+	uint16_t handle = _heap[heapIndex];
+	while (heapIndex > 0) {
+		uint16_t parent = (heapIndex - 1) / 2;
+		if (!isBefore(handle, _heap[parent])) {
+			break;
+		}
+		setHeap(heapIndex, _heap[parent]);
+		heapIndex = parent;
+	}
+	setHeap(heapIndex, handle);
+}
+
+void StateStoreQueue::siftDown(uint16_t heapIndex) {
+	uint16_t handle = _heap[heapIndex];
+	uint16_t size = _heap.size();
+	while (true) {
+		uint32_t child = 2 * static_cast<uint32_t>(heapIndex) + 1;
+		if (child >= size) {
+			break;
+		}
+		if (child + 1 < size && isBefore(_heap[child + 1], _heap[child])) {
+			child++;
+		}
+		if (!isBefore(_heap[child], handle)) {
+			break;
+		}
+		setHeap(heapIndex, _heap[child]);
+		heapIndex = child;
+	}
+	setHeap(heapIndex, handle);
+}
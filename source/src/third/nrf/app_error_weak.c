@@ -43,6 +43,7 @@
 #include "nrf_log_ctrl.h"
 #include "app_util_platform.h"
 #include "nrf_strerror.h"
+#include "drivers/cs_Serial.h"
 
 #if defined(SOFTDEVICE_PRESENT) && SOFTDEVICE_PRESENT
 #include "nrf_sdm.h"
@@ -57,6 +58,7 @@ __WEAK void app_error_fault_handler(uint32_t id, uint32_t pc, uint32_t info)
 {
     __disable_irq();
     NRF_LOG_FINAL_FLUSH();
+    serial_flush();
 
 #ifndef DEBUG
     NRF_LOG_ERROR("Fatal error");
@@ -114,6 +114,7 @@ void SystemTime::init() {
 	initDebug();
 
 	syncTimeCoroutine.action = [](){ return syncTimeCoroutineAction(); };
+	syncTimeCoroutine.start();
 
 	State::getInstance().get(CS_TYPE::CONFIG_CROWNSTONE_ID, &myId, sizeof(myId));
 
@@ -265,9 +266,6 @@ cs_ret_code_t SystemTime::setSunTimes(const sun_time_t& sunTimes, bool throttled
 // ======================== Events ========================
 
 void SystemTime::handleEvent(event_t & event) {
-	syncTimeCoroutine.handleEvent(event);
-	debugSyncTimeCoroutine.handleEvent(event);
-
 	switch (event.type) {
 		case CS_TYPE::CMD_SET_TIME: {
 			LOGSystemTimeInfo("set time from command source: type=%u id=%u", event.source.source.type, event.source.source.id);
@@ -513,6 +511,7 @@ void SystemTime::initDebug() {
 		publishSyncMessageForTesting();
 		return Coroutine::delayMs(debugSyncTimeMessagePeriodMs());
 	};
+	debugSyncTimeCoroutine.start();
 #endif  // DEBUG_SYSTEM_TIME
 }
 
@@ -8,6 +8,7 @@
 #include <drivers/cs_RNG.h>
 #include <encryption/cs_KeysAndAccess.h>
 #include <events/cs_EventDispatcher.h>
+#include <logging/cs_Logger.h>
 #include <tracking/cs_TrackedDevices.h>
 #include <util/cs_BleError.h>
 #include <util/cs_Utils.h>
@@ -42,7 +43,21 @@ TrackedDevices::TrackedDevices() {
 
 void TrackedDevices::init() {
 	LOGi("Init. Using %u bytes of RAM.", sizeof(_store));
-	EventDispatcher::getInstance().addListener(this);
+	tickSecondRoutine.start(TICKS_PER_SECOND);
+	tickMinuteRoutine.start(TICKS_PER_MINUTES);
+	listen({
+		CS_TYPE::CMD_REGISTER_TRACKED_DEVICE,
+		CS_TYPE::CMD_UPDATE_TRACKED_DEVICE,
+		CS_TYPE::CMD_TRACKED_DEVICE_HEARTBEAT,
+		CS_TYPE::EVT_MESH_TRACKED_DEVICE_REGISTER,
+		CS_TYPE::EVT_MESH_TRACKED_DEVICE_TOKEN,
+		CS_TYPE::EVT_MESH_TRACKED_DEVICE_HEARTBEAT,
+		CS_TYPE::EVT_MESH_TRACKED_DEVICE_LIST_SIZE,
+		CS_TYPE::EVT_ADV_BACKGROUND_PARSED_V1,
+		CS_TYPE::EVT_MESH_SYNC_REQUEST_OUTGOING,
+		CS_TYPE::EVT_MESH_SYNC_REQUEST_INCOMING,
+		CS_TYPE::EVT_MESH_SYNC_FAILED
+	});
 }
 
 cs_ret_code_t TrackedDevices::handleRegister(internal_register_tracked_device_packet_t& packet) {
@@ -187,7 +202,7 @@ cs_ret_code_t TrackedDevices::handleHeartbeat(TrackedDevice& device, uint8_t loc
 TrackedDevice* TrackedDevices::findOrAdd(device_id_t deviceId) {
 	TrackedDevice* device = find(deviceId);
 	if (device == nullptr) {
-		device = add();
+		device = add(deviceId);
 		if (device != nullptr) {
 			device->data.data.deviceId = deviceId;
 		}
@@ -212,31 +227,23 @@ TrackedDevice* TrackedDevices::findToken(uint8_t* deviceToken, uint8_t size) {
 	return nullptr;
 }
 
-TrackedDevice* TrackedDevices::add() {
+TrackedDevice* TrackedDevices::add(device_id_t deviceId) {
 	LOGTrackedDevicesDebug("add");
 
-	// use invalid spot in current range if possible
-	if(auto emptyspot = _store.get([](auto device) { return !device.isValid();})) {
+	// Use empty spot, or increase store size if possible.
+	if(auto emptySpot = _store.getOrAdd(deviceId)) {
 		LOGTrackedDevicesDebug("Use empty spot");
-		return emptyspot;
+		return emptySpot;
 	}
 
-	// Increase store size if possible.
-	if(auto newSpot = _store.addAtEnd()) {
-		LOGTrackedDevicesDebug("Create new spot");
-		return newSpot;
-	}
-
-	if(auto incomplete = _store.get([](auto device) { return !device.allFieldsSet();})) {
+	if(auto incomplete = _store.get([](auto& device) { return !device.allFieldsSet();})) {
 		LOGTrackedDevicesDebug("Use spot of incomplete tracked device record");
-		incomplete->invalidate();
-		return incomplete;
+		return _store.replace(*incomplete, deviceId);
 	}
 
-	if(auto lowestTtlRecord = _store.getMin([](auto device) { return device.data.data.timeToLiveMinutes; })){
+	if(auto lowestTtlRecord = _store.getMin([](auto& device) { return device.data.data.timeToLiveMinutes; })){
 		LOGTrackedDevicesDebug("Use spot of lowest ttl record");
-		lowestTtlRecord->invalidate();
-		return lowestTtlRecord;
+		return _store.replace(*lowestTtlRecord, deviceId);
 	}
 
 	// Shouldn't happen.
@@ -277,7 +284,7 @@ void TrackedDevices::checkSynced() {
 		return;
 	}
 
-	if(_store.get([](auto device){ return !device.allFieldsSet(); })) {
+	if(_store.get([](auto& device){ return !device.allFieldsSet(); })) {
 		LOGTrackedDevicesDebug("Found device for which not all fields are set");
 		return;
 	}
@@ -298,10 +305,11 @@ void TrackedDevices::tickMinute() {
 			device.data.data.locationId = 0;
 		}
 
-		if (*CsMath::DecreaseByPointer(&device.data.data.timeToLiveMinutes) == 0) {
+		device.data.data.timeToLiveMinutes = CsMath::SafeAdd(device.data.data.timeToLiveMinutes, -1);
+		if (device.data.data.timeToLiveMinutes == 0) {
 			// Always check if device is timed out, as it might be that the TTL was never set.
 			LOGTrackedDevicesDebug("Timed out id=%u", device.data.data.deviceId);
-			device.invalidate();
+			_store.remove(device);
 		}
 
 		CsMath::Decrease(device.heartbeatTTLMinutes);
@@ -447,17 +455,6 @@ void TrackedDevices::handleEvent(event_t& event) {
 			handleScannedDevice(*data);
 			break;
 		}
-		case CS_TYPE::EVT_TICK: {
-			if (--ticksLeftMinute == 0) {
-				ticksLeftMinute = TICKS_PER_MINUTES;
-				tickMinute();
-			}
-			if (--ticksLeftSecond == 0) {
-				ticksLeftSecond = TICKS_PER_SECOND;
-				tickSecond();
-			}
-			break;
-		}
 		case CS_TYPE::EVT_MESH_SYNC_REQUEST_OUTGOING: {
 			if (!_deviceListIsSynced) {
 				auto req = reinterpret_cast<TYPIFY(EVT_MESH_SYNC_REQUEST_OUTGOING)*>(event.data);
@@ -49,6 +49,9 @@ void UartCommandHandler::handleCommand(UartOpcodeRx opCode,
 		case UART_OPCODE_RX_GET_MAC:
 			handleCommandGetMacAddress(commandData);
 			break;
+		case UART_OPCODE_RX_GET_STATS:
+			handleCommandGetStats(commandData);
+			break;
 		case UART_OPCODE_RX_CONTROL:
 			handleCommandControl(commandData, source, accessLevel, resultBuffer);
 			break;
@@ -66,6 +69,12 @@ void UartCommandHandler::handleCommand(UartOpcodeRx opCode,
 		case UART_OPCODE_RX_GET_ID:
 			handleCommandGetId(commandData);
 			break;
+		case UART_OPCODE_RX_SET_LOG_LEVEL:
+			handleCommandSetLogLevel(commandData);
+			break;
+		case UART_OPCODE_RX_GET_MESH_STATS:
+			dispatchEventForCommand(CS_TYPE::CMD_GET_MESH_STATS, commandData);
+			break;
 
 		case UART_OPCODE_RX_ADC_CONFIG_INC_RANGE_CURRENT:
 			dispatchEventForCommand(CS_TYPE::CMD_INC_CURRENT_RANGE, commandData);
@@ -261,6 +270,28 @@ void UartCommandHandler::handleCommandGetMacAddress(cs_data_t commandData) {
 	}
 }
 
+void UartCommandHandler::handleCommandGetStats(cs_data_t commandData) {
+	LOGUartCommandHandlerDebug(STR_HANDLE_COMMAND, "get stats");
+	uart_msg_stats_t stats = UartHandler::getInstance().getStats();
+	UartHandler::getInstance().writeMsg(UART_OPCODE_TX_STATS, reinterpret_cast<uint8_t*>(&stats), sizeof(stats));
+}
+
+void UartCommandHandler::handleCommandSetLogLevel(cs_data_t commandData) {
+	LOGd(STR_HANDLE_COMMAND, "set log level");
+	if (commandData.len < sizeof(uart_msg_log_level_t)) {
+		LOGw(STR_ERR_BUFFER_NOT_LARGE_ENOUGH);
+		UartHandler::getInstance().writeMsg(UART_OPCODE_TX_ERR_REPLY_PARSING_FAILED);
+		return;
+	}
+	uart_msg_log_level_t* logLevel = reinterpret_cast<uart_msg_log_level_t*>(commandData.data);
+	if (!setLogModuleLevel(logLevel->module, logLevel->level)) {
+		LOGw("Invalid log module: %u", logLevel->module);
+		UartHandler::getInstance().writeMsg(UART_OPCODE_TX_ERR_REPLY_PARSING_FAILED);
+		return;
+	}
+	UartHandler::getInstance().writeMsg(UART_OPCODE_TX_LOG_LEVELS, getLogModuleLevels(), LOG_MODULE_COUNT);
+}
+
 void UartCommandHandler::handleCommandInjectEvent(cs_data_t commandData) {
 	LOGd(STR_HANDLE_COMMAND, "inject event");
 
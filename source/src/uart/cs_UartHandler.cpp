@@ -30,8 +30,8 @@ extern "C" {
 #define LOGUartHandlerRtt(fmt, ...)
 #endif
 
-void handle_msg(void * data, uint16_t size) {
-	UartHandler::getInstance().handleMsg((cs_data_t*)data);
+void handle_read_frames(void * data, uint16_t size) {
+	UartHandler::getInstance().handleReadFrames();
 }
 
 void on_serial_read(uint8_t val) {
@@ -53,7 +53,8 @@ void UartHandler::init(serial_enable_t serialEnabled) {
 			return;
 	}
 	_initialized = true;
-	_readBuffer = new uint8_t[UART_RX_BUFFER_SIZE];
+	_readBuffer = new uint8_t[_frameReader.BUFFER_SIZE];
+	_frameReader.setBuffer(_readBuffer);
 	_writeBuffer = new uint8_t[UART_TX_BUFFER_SIZE];
 	_encryptionBuffer = new uint8_t[UART_TX_ENCRYPTION_BUFFER_SIZE];
 
@@ -117,6 +118,14 @@ ret_code_t UartHandler::writeMsg(UartOpcodeTx opCode) {
 	return writeMsg(opCode, nullptr, 0);
 }
 
+bool UartHandler::canWriteMsg(UartOpcodeTx opCode, uint16_t size, UartProtocol::Encrypt encrypt) {
+	uint16_t payloadSize = sizeof(uart_msg_header_t) + size;
+	if (mustEncrypt(encrypt, opCode)) {
+		payloadSize = getEncryptedBufferSize(payloadSize);
+	}
+	return serial_tx_free() >= _frameWriter.maxFrameSize(payloadSize);
+}
+
 ret_code_t UartHandler::writeMsgStart(UartOpcodeTx opCode, uint16_t size, UartProtocol::Encrypt encrypt) {
 //	if (size > UART_TX_MAX_PAYLOAD_SIZE) {
 //		return;
@@ -200,67 +209,39 @@ ret_code_t UartHandler::writeMsgEnd(UartOpcodeTx opCode, UartProtocol::Encrypt e
 		writeEncryptedEnd();
 	}
 
-	uart_msg_tail_t tail;
-	tail.crc = _crc;
-	writeBytes(cs_data_t(reinterpret_cast<uint8_t*>(&tail), sizeof(uart_msg_tail_t)), false);
-	return ERR_SUCCESS;
-}
-
-cs_ret_code_t UartHandler::writeStartByte() {
 	if (!serial_tx_ready()) {
 		return ERR_NOT_INITIALIZED;
 	}
-	serial_write(UART_START_BYTE);
+	_frameWriter.end();
 	return ERR_SUCCESS;
 }
 
 cs_ret_code_t UartHandler::writeBytes(cs_data_t data, bool updateCrc) {
-
 	if (!serial_tx_ready()) {
 		return ERR_NOT_INITIALIZED;
 	}
-
-	if (updateCrc) {
-		UartProtocol::crc16(data.data, data.len, _crc);
-	}
-
-	uint8_t val;
-	for (cs_buffer_size_t i = 0; i < data.len; ++i) {
-		val = data.data[i];
-		// Escape when necessary
-		switch (val) {
-			case UART_START_BYTE:
-			case UART_ESCAPE_BYTE:
-				serial_write(UART_ESCAPE_BYTE);
-				val ^= UART_ESCAPE_FLIP_MASK;
-				break;
-		}
-		serial_write(val);
-	}
+	_frameWriter.write(data.data, data.len, updateCrc);
 	return ERR_SUCCESS;
 }
 
 cs_ret_code_t UartHandler::writeWrapperStart(UartMsgType msgType, uint16_t payloadSize) {
-	// Set headers.
-	uart_msg_size_header_t sizeHeader;
-	uart_msg_wrapper_header_t wrapperHeader;
-	sizeHeader.size = sizeof(wrapperHeader) + payloadSize + sizeof(uart_msg_tail_t);
-	wrapperHeader.type = static_cast<uint8_t>(msgType);
-
-	LOGUartHandlerRtt("writeWrapperStart sizeHeader=%u \n", sizeHeader.size);
-
-	// Start CRC.
-	_crc = UartProtocol::crc16(nullptr, 0);
-
-	// Write to uart.
-	writeStartByte();
-	writeBytes(cs_data_t(reinterpret_cast<uint8_t*>(&sizeHeader), sizeof(sizeHeader)), false);
-	writeBytes(cs_data_t(reinterpret_cast<uint8_t*>(&wrapperHeader), sizeof(wrapperHeader)), true);
-
+	if (!serial_tx_ready()) {
+		return ERR_NOT_INITIALIZED;
+	}
+	LOGUartHandlerRtt("writeWrapperStart payloadSize=%u \n", payloadSize);
+	if (!_frameWriter.start(msgType, payloadSize)) {
+		return ERR_BUSY;
+	}
 	return ERR_SUCCESS;
 }
 
+bool UartSerialSink::reserve(uint16_t size) {
+	return serial_tx_reserve(size);
+}
 
+void UartSerialSink::write(const uint8_t* data, uint16_t size) {
+	serial_write_buffer(data, size);
+}
 
 cs_buffer_size_t UartHandler::getEncryptedBufferSize(cs_buffer_size_t uartMsgSize) {
 	cs_buffer_size_t encryptedSize = sizeof(uart_encrypted_data_header_t) + uartMsgSize;
@@ -405,111 +386,49 @@ void UartHandler::writeErrorReplyStatus() {
 
 
 
-void UartHandler::resetReadBuf() {
-	// There are no logs written from this function. It can be called from an interrupt service routine.
-	_readBufferIdx = 0;
-	_startedReading = false;
-	_escapeNextByte = false;
-	_sizeToRead = 0;
-}
-
 void UartHandler::onRead(uint8_t val) {
-	// No logs, this function can be called from interrupt
-	// CRC error? Reset.
-	// Start char? Reset.
-	// Bad escaped value? Reset.
-	// Bad length? Reset. Over-run length of buffer? Reset.
-	// Haven't seen a start char in too long? Reset anyway.
-
-	// Can't read anything while still processing the previous message.
-	if (_readBusy) {
-		return;
-	}
-
-	if (_readBuffer == nullptr) {
-		return;
-	}
-
-//	LOGUartHandlerRtt("%u\n", val);
-
-	// An escape shouldn't be followed by a special byte.
-	switch (val) {
-		case UART_START_BYTE:
-		case UART_ESCAPE_BYTE:
-			if (_escapeNextByte) {
-				resetReadBuf();
-				return;
-			}
-	}
-
-	if (val == UART_START_BYTE) {
-		if (_startedReading) {
-			LOGUartHandlerRtt("onRead: discard %uB read of %uB\n", _readBufferIdx, _sizeToRead);
-		}
-		resetReadBuf();
-		_startedReading = true;
-		return;
-	}
-
-	if (!_startedReading) {
-		return;
+	// No logs, this function can be called from interrupt.
+	// The frame reader resets on a start byte, bad escaped value, or bad length.
+	if (_frameReader.onRead(val)) {
+		scheduleHandleReadFrames();
 	}
+}
 
-	if (val == UART_ESCAPE_BYTE) {
-		_escapeNextByte = true;
+void UartHandler::scheduleHandleReadFrames() {
+	// No logs, this function can be called from interrupt.
+	if (_handleScheduled) {
 		return;
 	}
-
-	if (_escapeNextByte) {
-		UartProtocol::unEscape(val);
-		_escapeNextByte = false;
+	// Decouple handling from the interrupt handler, and put it on app scheduler instead.
+	// When the scheduler is almost full, the frames stay in the frame slots, and will be handled later.
+	uint16_t schedulerSpace = app_sched_queue_space_get();
+	if (schedulerSpace > SCHED_QUEUE_SIZE - SCHEDULER_QUEUE_ALMOST_FULL) {
+		_handleScheduled = true;
+		uint32_t errorCode = app_sched_event_put(nullptr, 0, handle_read_frames);
+		APP_ERROR_CHECK(errorCode);
 	}
+}
 
-	_readBuffer[_readBufferIdx++] = val;
-
-	if (_sizeToRead == 0) {
-		if (_readBufferIdx == sizeof(uart_msg_size_header_t)) {
-			// Check received size
-			uart_msg_size_header_t* sizeHeader = reinterpret_cast<uart_msg_size_header_t*>(_readBuffer);
-			if (sizeHeader->size == 0 || sizeHeader->size > UART_RX_BUFFER_SIZE) {
-				LOGUartHandlerRtt("onRead: sizeToRead > UART_RX_BUFFER_SIZE\n");
-				resetReadBuf();
-				return;
-			}
-			// Set size to read and reset read buffer index.
-			_sizeToRead = sizeHeader->size;
-			_readBufferIdx = 0;
-			LOGUartHandlerRtt("onRead: sizeToRead=%u\n", _sizeToRead);
-		}
-	}
-	else if (_readBufferIdx >= _sizeToRead) {
-		// Block reading until the buffer has been handled.
-		_readBusy = true;
-		// Decouple callback from interrupt handler, and put it on app scheduler instead
-		cs_data_t msgData;
-		msgData.data = _readBuffer;
-		msgData.len = _readBufferIdx;
-		LOGUartHandlerRtt("onRead: dispatch msg of size %u\n", msgData.len);
-
+void UartHandler::handleReadFrames() {
+	// Clear first, so that a frame that is read while handling, schedules again.
+	_handleScheduled = false;
 
-		uint16_t schedulerSpace = app_sched_queue_space_get();
-		if (schedulerSpace > SCHED_QUEUE_SIZE - SCHEDULER_QUEUE_ALMOST_FULL) {
-			uint32_t errorCode = app_sched_event_put(&msgData, sizeof(msgData), handle_msg);
-			APP_ERROR_CHECK(errorCode);
-		}
+	uint16_t size;
+	uint8_t* frame;
+	while ((frame = _frameReader.peek(size)) != nullptr) {
+		handleMsg(frame, size);
+		// When done, ALWAYS free the frame slot!
+		_frameReader.pop();
 	}
 }
 
-
-void UartHandler::handleMsg(cs_data_t* msgData) {
-	uint8_t* data = msgData->data;
-	uint16_t size = msgData->len;
-
-	handleMsg(data, size);
-
-	// When done, ALWAYS reset and set readBusy to false!
-	resetReadBuf();
-	_readBusy = false;
+uart_msg_stats_t UartHandler::getStats() {
+	uart_msg_stats_t stats;
+	stats.rxFrames       = _frameReader.getFrameCount();
+	stats.rxOverflows    = _frameReader.getOverflowCount();
+	stats.rxDiscarded    = _frameReader.getDiscardedCount();
+	stats.txDroppedBytes = serial_get_tx_dropped_bytes();
+	return stats;
 }
 
 void UartHandler::handleMsg(uint8_t* data, uint16_t size) {
@@ -648,6 +567,13 @@ void UartHandler::handleUartMsg(uint8_t* data, uint16_t size, EncryptionAccessLe
 
 void UartHandler::handleEvent(event_t & event) {
 	switch (event.type) {
+		case CS_TYPE::EVT_TICK: {
+			// Handle frames that could not be scheduled, because the scheduler was full.
+			if (_frameReader.size() != 0) {
+				scheduleHandleReadFrames();
+			}
+			break;
+		}
 		case CS_TYPE::CONFIG_UART_ENABLED: {
 			TYPIFY(CONFIG_UART_ENABLED)* enabled = (TYPIFY(CONFIG_UART_ENABLED)*)event.data;
 			serial_enable(*reinterpret_cast<serial_enable_t*>(enabled));
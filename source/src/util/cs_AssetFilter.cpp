@@ -12,7 +12,6 @@
 #include <util/cs_Utils.h>
 
 #define LOGAssetFilterWarn LOGvv
-#define LogLevelAssetFilteringVerbose SERIAL_VERY_VERBOSE
 
 
 asset_filter_runtime_data_t* AssetFilter::runtimedata() {
@@ -114,7 +113,7 @@ ReturnType AssetFilter::prepareFilterInputAndCallDelegate(
 				return defaultValue;
 			}
 
-			if (CsUtils::findAdvType(selector->adDataType, device.data, device.dataSize, &result) == ERR_SUCCESS) {
+			if (device.findAdvType(selector->adDataType, &result) == ERR_SUCCESS) {
 				return delegateExpression(filter, result.data, result.len);
 			}
 
@@ -131,7 +130,7 @@ ReturnType AssetFilter::prepareFilterInputAndCallDelegate(
 				return defaultValue;
 			}
 
-			if (CsUtils::findAdvType(selector->adDataType, device.data, device.dataSize, &result) == ERR_SUCCESS) {
+			if (device.findAdvType(selector->adDataType, &result) == ERR_SUCCESS) {
 				// A normal advertisement payload size is 31B at most.
 				// We are also limited by the 32b bitmask.
 				if (result.len > 31) {
@@ -148,7 +147,7 @@ ReturnType AssetFilter::prepareFilterInputAndCallDelegate(
 						buffIndex++;
 					}
 				}
-				_logArray(LogLevelAssetFilteringVerbose, true, buff, buffIndex);
+				_logArrayModule(LOG_MODULE_ASSET_FILTERING, SERIAL_VERBOSE, true, buff, buffIndex);
 				return delegateExpression(filter, buff, buffIndex);
 			}
 
@@ -5,6 +5,7 @@
  */
 
 #include <util/cs_BleError.h>
+#include <drivers/cs_Serial.h>
 #include <logging/cs_Logger.h>
 
 //! Called by BluetoothLE.h classes when exceptions are disabled.
@@ -14,6 +15,8 @@ void ble_error_handler (const char * msg, uint32_t line_num, const char * p_file
 	volatile const char* file __attribute__((unused)) = p_file_name;
 
 	LOGf("FATAL ERROR %s, at %s:%d", message, file, line);
+	LOG_FLUSH();
+	serial_flush();
 
 	NRF_BREAKPOINT_COND;
 	NVIC_SystemReset();
@@ -5,10 +5,18 @@
  * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
  */
 
-#include <ble/cs_Nordic.h> // For the crc16.h include
 #include <util/cs_Crc16.h>
+#include <util/cs_CrcTable.h>
+
+#if CRC_TABLE_SLICES == 0
+#include <ble/cs_Nordic.h> // For the crc16.h include
+#endif
 
-// We use the nrf implementation, as that seems a faster implementation..
 uint16_t crc16(const uint8_t* data, uint16_t size, uint16_t* prevCrc) {
+#if CRC_TABLE_SLICES == 0
+	// The nrf implementation doesn't need a table, but handles a byte at a time.
 	return crc16_compute(data, size, prevCrc);
+#else
+	return CsCrc::crc16<CRC_TABLE_SLICES>(data, size, (prevCrc == nullptr) ? 0xFFFF : *prevCrc);
+#endif
 }
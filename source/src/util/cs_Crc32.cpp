@@ -5,10 +5,18 @@
  * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
  */
 
-#include <ble/cs_Nordic.h> // For the crc32.h include
 #include <util/cs_Crc32.h>
+#include <util/cs_CrcTable.h>
+
+#if CRC_TABLE_SLICES == 0
+#include <ble/cs_Nordic.h> // For the crc32.h include
+#endif
 
-// We use the nrf implementation, as that seems a faster implementation..
 uint32_t crc32(const uint8_t* data, uint16_t size, uint32_t* prevCrc) {
+#if CRC_TABLE_SLICES == 0
+	// The nrf implementation doesn't need a table, but handles a byte at a time.
 	return crc32_compute(data, size, prevCrc);
+#else
+	return CsCrc::crc32<CRC_TABLE_SLICES>(data, size, (prevCrc == nullptr) ? 0 : *prevCrc);
+#endif
 }
@@ -41,10 +41,10 @@
  */
 
 #include <util/cs_Crc16.h>
+#include <util/cs_CrcTable.h>
 #include <util/cs_CuckooFilter.h>
 #include <util/cs_Hash.h>
 #include <util/cs_RandomGenerator.h>
-#include <util/cs_Error.h>
 
 #include <cstring>
 
@@ -57,17 +57,39 @@ cuckoo_fingerprint_t CuckooFilter::filterHash() {
 				crc16(reinterpret_cast<const uint8_t*>(&_data), size(), nullptr));
 }
 
-cuckoo_fingerprint_t CuckooFilter::hashToFingerprint(cuckoo_key_t key, size_t keyLengthInBytes) {
-	return static_cast<cuckoo_fingerprint_t>(
-			crc16(static_cast<const uint8_t*>(key), keyLengthInBytes, nullptr));
-}
-
-cuckoo_fingerprint_t CuckooFilter::hashToBucket(cuckoo_key_t key, size_t keyLengthInBytes) {
-	return static_cast<cuckoo_fingerprint_t>(
-				Djb2(static_cast<const uint8_t*>(key), keyLengthInBytes));
+cuckoo_key_hash_t CuckooFilter::hashKey(cuckoo_key_t key, size_t keyLengthInBytes) {
+	const uint8_t* data = static_cast<const uint8_t*>(key);
+#if CRC_TABLE_SLICES > 0
+	// Single pass over the key, with the same results as crc16() and Djb2().
+	auto& crcTable      = CsCrc::Crc16Table<CRC_TABLE_SLICES>::value.table;
+	uint16_t fingerHash = 0xFFFF;
+	uint16_t bucketHash = 5381;
+#if CRC_TABLE_SLICES >= 4
+	// 4 bytes at a time: crc16 slice by 4, and Djb2 unrolled (multiply by 33 per byte).
+	while (keyLengthInBytes >= 4) {
+		uint32_t word = CsCrc::load32(data) ^ ((fingerHash >> 8) | ((fingerHash & 0xFF) << 8));
+		fingerHash    = crcTable[3][word & 0xFF] ^ crcTable[2][(word >> 8) & 0xFF] ^ crcTable[1][(word >> 16) & 0xFF]
+					 ^ crcTable[0][word >> 24];
+		bucketHash = static_cast<uint16_t>(
+				bucketHash * (33u * 33 * 33 * 33) + data[0] * (33u * 33 * 33) + data[1] * (33u * 33) + data[2] * 33u
+				+ data[3]);
+		data += 4;
+		keyLengthInBytes -= 4;
+	}
+#endif
+	while (keyLengthInBytes--) {
+		fingerHash = static_cast<uint16_t>((fingerHash << 8) ^ crcTable[0][(fingerHash >> 8) ^ *data]);
+		bucketHash = static_cast<uint16_t>(((bucketHash << 5) + bucketHash) + *data);
+		data++;
+	}
+	return cuckoo_key_hash_t{.fingerprint = fingerHash, .bucketHash = bucketHash};
+#else
+	return cuckoo_key_hash_t{
+			.fingerprint = static_cast<cuckoo_fingerprint_t>(crc16(data, keyLengthInBytes, nullptr)),
+			.bucketHash  = static_cast<cuckoo_fingerprint_t>(Djb2(data, keyLengthInBytes))};
+#endif
 }
 
-
 /* ------------------------------------------------------------------------- */
 
 cuckoo_extended_fingerprint_t CuckooFilter::getExtendedFingerprint(
@@ -79,26 +101,26 @@ cuckoo_extended_fingerprint_t CuckooFilter::getExtendedFingerprint(
 			.bucketB     = static_cast<cuckoo_index_t>((bucketIndex ^ finger) % bucketCount())};
 }
 
-cuckoo_extended_fingerprint_t CuckooFilter::getExtendedFingerprint(
-		cuckoo_key_t key, size_t keyLengthInBytes) {
-
-	cuckoo_fingerprint_t fingerHash = hashToFingerprint(key, keyLengthInBytes);
-	cuckoo_fingerprint_t bucketHash = hashToBucket(key, keyLengthInBytes);
+cuckoo_extended_fingerprint_t CuckooFilter::getExtendedFingerprint(const cuckoo_key_hash_t& keyHash) {
 
 	return cuckoo_extended_fingerprint_t{
-			.fingerprint = fingerHash,
-			.bucketA     = static_cast<cuckoo_index_t>(bucketHash % bucketCount()),
-			.bucketB     = static_cast<cuckoo_index_t>((bucketHash ^ fingerHash) % bucketCount())};
+			.fingerprint = keyHash.fingerprint,
+			.bucketA     = static_cast<cuckoo_index_t>(keyHash.bucketHash % bucketCount()),
+			.bucketB     = static_cast<cuckoo_index_t>((keyHash.bucketHash ^ keyHash.fingerprint) % bucketCount())};
+}
+
+cuckoo_extended_fingerprint_t CuckooFilter::getExtendedFingerprint(
+		cuckoo_key_t key, size_t keyLengthInBytes) {
+	return getExtendedFingerprint(hashKey(key, keyLengthInBytes));
 }
 
 cuckoo_compressed_fingerprint_t CuckooFilter::getCompressedFingerprint(cuckoo_key_t key, size_t keyLengthInBytes) {
 
-	cuckoo_fingerprint_t fingerHash = hashToFingerprint(key, keyLengthInBytes);
-	cuckoo_fingerprint_t bucketHash = hashToBucket(key, keyLengthInBytes);
+	cuckoo_key_hash_t keyHash = hashKey(key, keyLengthInBytes);
 
 	return cuckoo_compressed_fingerprint_t{
-			.fingerprint = fingerHash,
-			.bucket     = static_cast<cuckoo_index_t>(bucketHash % bucketCount()),
+			.fingerprint = keyHash.fingerprint,
+			.bucket     = static_cast<cuckoo_index_t>(keyHash.bucketHash % bucketCount()),
 	};
 }
 
@@ -110,9 +132,9 @@ cuckoo_compressed_fingerprint_t CuckooFilter::getCompressedFingerprint(cuckoo_ke
 bool CuckooFilter::addFingerprintToBucket(
 		cuckoo_fingerprint_t fingerprint, cuckoo_index_t bucketIndex) {
 	for (size_t ii = 0; ii < _data->nestsPerBucket; ++ii) {
-		cuckoo_fingerprint_t& fingerprintInArray = lookupFingerprint(bucketIndex, ii);
-		if (0 == fingerprintInArray) {
-			fingerprintInArray = fingerprint;
+		size_t fingerprintInArray = fingerprintIndex(bucketIndex, ii);
+		if (0 == _data->bucketArray[fingerprintInArray]) {
+			_data->bucketArray[fingerprintInArray] = fingerprint;
 			return true;
 		}
 	}
@@ -125,20 +147,20 @@ bool CuckooFilter::addFingerprintToBucket(
 bool CuckooFilter::removeFingerprintFromBucket(
 		cuckoo_fingerprint_t fingerprint, cuckoo_index_t bucketIndex) {
 	for (cuckoo_index_t ii = 0; ii < _data->nestsPerBucket; ++ii) {
-		cuckoo_fingerprint_t& candidateFingerprintForRemovalInArray =
-				lookupFingerprint(bucketIndex, ii);
+		size_t candidateFingerprintForRemovalInArray = fingerprintIndex(bucketIndex, ii);
 
-		if (candidateFingerprintForRemovalInArray == fingerprint) {
-			candidateFingerprintForRemovalInArray = 0;
+		if (_data->bucketArray[candidateFingerprintForRemovalInArray] == fingerprint) {
+			_data->bucketArray[candidateFingerprintForRemovalInArray] = 0;
 
 			// to keep the bucket front loaded, move the last non-zero
 			// fingerprint behind ii into the slot.
 			for (cuckoo_index_t jj = _data->nestsPerBucket - 1; jj > ii; --jj) {
-				cuckoo_fingerprint_t& lastFingerprintOfBucket = lookupFingerprint(bucketIndex, jj);
+				size_t lastFingerprintOfBucket = fingerprintIndex(bucketIndex, jj);
 
-				if (lastFingerprintOfBucket != 0) {
-					candidateFingerprintForRemovalInArray = lastFingerprintOfBucket;
-					lastFingerprintOfBucket = 0;
+				if (_data->bucketArray[lastFingerprintOfBucket] != 0) {
+					_data->bucketArray[candidateFingerprintForRemovalInArray] =
+							_data->bucketArray[lastFingerprintOfBucket];
+					_data->bucketArray[lastFingerprintOfBucket] = 0;
 					break;
 				}
 			}
@@ -179,10 +201,9 @@ bool CuckooFilter::move(cuckoo_extended_fingerprint_t entryToInsert) {
 		cuckoo_index_t kickedItemIndex = rand() % _data->nestsPerBucket;
 
 		// swap entry to insert and the randomly chosen (kicked) item
-		cuckoo_fingerprint_t& kicked_item_fingerprint_ref =
-				lookupFingerprint(kickedItemBucket, kickedItemIndex);
-		cuckoo_fingerprint_t kickedItemFingerprintValue = kicked_item_fingerprint_ref;
-		kicked_item_fingerprint_ref                     = entryToInsert.fingerprint;
+		size_t kickedItemInArray                        = fingerprintIndex(kickedItemBucket, kickedItemIndex);
+		cuckoo_fingerprint_t kickedItemFingerprintValue = _data->bucketArray[kickedItemInArray];
+		_data->bucketArray[kickedItemInArray]           = entryToInsert.fingerprint;
 		entryToInsert = getExtendedFingerprint(kickedItemFingerprintValue, kickedItemBucket);
 
 		// next iteration will try to re-insert the footprint previously at (h,i).
@@ -224,21 +245,42 @@ bool CuckooFilter::isValid() {
 
 /* ------------------------------------------------------------------------- */
 
-bool CuckooFilter::contains(cuckoo_extended_fingerprint_t efp) {
-	// loops are split to improve cache hit rate.
-
-	// search bucketA
-	for (size_t ii = 0; ii < _data->nestsPerBucket; ++ii) {
-		if (efp.fingerprint == lookupFingerprint(efp.bucketA, ii)) {
+bool CuckooFilter::bucketContains(cuckoo_fingerprint_t fingerprint, cuckoo_index_t bucketIndex) {
+	// Compare multiple nests at once: a word with a copy of the fingerprint in each lane, XOR-ed with the nests,
+	// has a zero lane where a nest equals the fingerprint.
+#ifdef HOST_TARGET
+	typedef uint64_t nests_word_t;
+#else
+	typedef uint32_t nests_word_t;
+#endif
+	constexpr size_t NESTS_PER_WORD       = sizeof(nests_word_t) / sizeof(cuckoo_fingerprint_t);
+	constexpr nests_word_t LOW_BITS       = static_cast<nests_word_t>(-1) / 0xFFFF;
+	constexpr nests_word_t HIGH_BITS      = LOW_BITS << 15;
+	const nests_word_t pattern            = LOW_BITS * fingerprint;
+
+	const uint8_t* nests = reinterpret_cast<const uint8_t*>(_data) + sizeof(cuckoo_filter_data_t)
+						   + fingerprintIndex(bucketIndex, 0) * sizeof(cuckoo_fingerprint_t);
+	size_t nestsLeft = _data->nestsPerBucket;
+
+	while (nestsLeft >= NESTS_PER_WORD) {
+		nests_word_t word;
+		memcpy(&word, nests, sizeof(word));
+		word ^= pattern;
+		if ((word - LOW_BITS) & ~word & HIGH_BITS) {
 			return true;
 		}
+		nests += sizeof(word);
+		nestsLeft -= NESTS_PER_WORD;
 	}
 
-	// search bucketB
-	for (size_t ii = 0; ii < _data->nestsPerBucket; ++ii) {
-		if (efp.fingerprint == lookupFingerprint(efp.bucketB, ii)) {
+	while (nestsLeft > 0) {
+		cuckoo_fingerprint_t nest;
+		memcpy(&nest, nests, sizeof(nest));
+		if (nest == fingerprint) {
 			return true;
 		}
+		nests += sizeof(nest);
+		nestsLeft--;
 	}
 
 	return false;
@@ -246,6 +288,12 @@ bool CuckooFilter::contains(cuckoo_extended_fingerprint_t efp) {
 
 /* ------------------------------------------------------------------------- */
 
+bool CuckooFilter::contains(cuckoo_extended_fingerprint_t efp) {
+	return bucketContains(efp.fingerprint, efp.bucketA) || bucketContains(efp.fingerprint, efp.bucketB);
+}
+
+/* ------------------------------------------------------------------------- */
+
 bool CuckooFilter::add(cuckoo_extended_fingerprint_t efp) {
 	if (contains(efp)) {
 		return true;
@@ -0,0 +1,102 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#include <util/cs_ExactMatchFilterIndex.h>
+
+#include <cstring>
+
+namespace {
+
+/**
+ * Interprets the bytes as big endian integer, so that integer order equals memcmp order.
+ */
+inline uint64_t loadBigEndian(const uint8_t* data, size_t size) {
+	uint64_t result = 0;
+	for (size_t i = 0; i < size; ++i) {
+		result = (result << 8) | data[i];
+	}
+	return result;
+}
+
+}  // namespace
+
+void ExactMatchFilterIndex::build(exact_match_filter_data_t* data) {
+	_data         = data;
+	_prefixLength = 0;
+	if (data->itemCount == 0 || data->itemSize == 0) {
+		return;
+	}
+
+	// Items are sorted, so the prefix that the first and last item share, is shared by all items.
+	const uint8_t* first = getItem(0);
+	const uint8_t* last  = getItem(data->itemCount - 1);
+	while (_prefixLength < data->itemSize && first[_prefixLength] == last[_prefixLength]) {
+		_prefixLength++;
+	}
+	if (_prefixLength == data->itemSize) {
+		return;
+	}
+
+	// Items are sorted, so the radix bytes are sorted too.
+	uint16_t itemIndex = 0;
+	for (uint16_t radix = 0; radix < 256; ++radix) {
+		while (itemIndex < data->itemCount && getItem(itemIndex)[_prefixLength] < radix) {
+			itemIndex++;
+		}
+		_radixStart[radix] = itemIndex;
+	}
+	_radixStart[256] = data->itemCount;
+}
+
+int ExactMatchFilterIndex::find(const void* item, size_t itemSize) const {
+	if (_data == nullptr || itemSize != _data->itemSize || _data->itemCount == 0) {
+		return -1;
+	}
+	const uint8_t* key = static_cast<const uint8_t*>(item);
+
+	if (memcmp(key, getItem(0), _prefixLength) != 0) {
+		return -1;
+	}
+	if (_prefixLength == itemSize) {
+		return 0;
+	}
+
+	uint8_t radix = key[_prefixLength];
+	size_t index  = _radixStart[radix];
+	size_t count  = _radixStart[radix + 1] - index;
+	if (count == 0) {
+		return -1;
+	}
+
+	// Find the last item <= key, the loop has a fixed number of iterations and no data dependent branches.
+	size_t suffixOffset = _prefixLength + 1;
+	size_t suffixSize   = itemSize - suffixOffset;
+	if (suffixSize <= sizeof(uint64_t)) {
+		uint64_t keySuffix = loadBigEndian(key + suffixOffset, suffixSize);
+		while (count > 1) {
+			size_t half        = count / 2;
+			uint64_t midSuffix = loadBigEndian(getItem(index + half) + suffixOffset, suffixSize);
+			index              = (midSuffix <= keySuffix) ? index + half : index;
+			count -= half;
+		}
+		if (loadBigEndian(getItem(index) + suffixOffset, suffixSize) == keySuffix) {
+			return index;
+		}
+		return -1;
+	}
+
+	while (count > 1) {
+		size_t half = count / 2;
+		int cmp     = memcmp(getItem(index + half) + suffixOffset, key + suffixOffset, suffixSize);
+		index       = (cmp <= 0) ? index + half : index;
+		count -= half;
+	}
+	if (memcmp(getItem(index) + suffixOffset, key + suffixOffset, suffixSize) == 0) {
+		return index;
+	}
+	return -1;
+}
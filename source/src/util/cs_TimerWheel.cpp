@@ -0,0 +1,141 @@
+/*
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 17, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#include <util/cs_TimerWheel.h>
+
+static_assert(TimerWheel::LEVELS * TimerWheel::SLOT_BITS <= 32, "Levels reach beyond the tick count");
+
+namespace {
+
+/**
+ * Move all nodes of a list to another, empty, list.
+ */
+void moveList(timer_wheel_link_t& from, timer_wheel_link_t& to) {
+	if (!from.isLinked()) {
+		return;
+	}
+	to.next       = from.next;
+	to.prev       = from.prev;
+	to.next->prev = &to;
+	to.prev->next = &to;
+	from.next     = &from;
+	from.prev     = &from;
+}
+
+}  // namespace
+
+TimerWheel& TimerWheel::getInstance() {
+	static TimerWheel instance;
+	return instance;
+}
+
+void TimerWheel::start(WheelTimer& timer, uint32_t delayTicks) {
+	if (delayTicks == 0) {
+		delayTicks = 1;
+	}
+	timer.unlink();
+	timer._expiryTickCount = _tickCount + delayTicks;
+	place(timer);
+}
+
+void TimerWheel::stop(WheelTimer& timer) {
+	timer.unlink();
+}
+
+void TimerWheel::advance(uint32_t tickCount) {
+	while (_tickCount != tickCount) {
+		processTick();
+	}
+}
+
+uint32_t TimerWheel::getTickCount() const {
+	return _tickCount;
+}
+
+uint32_t TimerWheel::getTicksUntilNextExpiry() const {
+	uint32_t result = 0xFFFFFFFF;
+	for (uint8_t level = 0; level < LEVELS; ++level) {
+		uint8_t shift = level * SLOT_BITS;
+		uint8_t currentSlot = getSlot(_tickCount, level);
+		for (uint8_t i = 1; i < SLOTS; ++i) {
+			if (!_slots[level][(currentSlot + i) & (SLOTS - 1)].isLinked()) {
+				continue;
+			}
+			uint32_t slotStart = ((_tickCount >> shift) + i) << shift;
+			uint32_t ticks     = slotStart - _tickCount;
+			if (ticks < result) {
+				result = ticks;
+			}
+			// Later slots of this level are further away.
+			break;
+		}
+	}
+	return result;
+}
+
+const cs_timer_wheel_stats_t& TimerWheel::getStats() const {
+	return _stats;
+}
+
+void TimerWheel::place(WheelTimer& timer) {
+	uint32_t expiry = timer._expiryTickCount;
+	for (uint8_t level = 0; level < LEVELS; ++level) {
+		if (getSlotDistance(_tickCount, expiry, level) < SLOTS) {
+			timer.linkBefore(&_slots[level][getSlot(expiry, level)]);
+			return;
+		}
+	}
+	// Too far away: place it at the slot of the top level that will be reached last.
+	uint8_t slot = (getSlot(_tickCount, LEVELS - 1) + SLOTS - 1) & (SLOTS - 1);
+	timer.linkBefore(&_slots[LEVELS - 1][slot]);
+}
+
+void TimerWheel::cascade(uint8_t level, uint8_t slot) {
+	timer_wheel_link_t list;
+	moveList(_slots[level][slot], list);
+	while (list.isLinked()) {
+		WheelTimer& timer = static_cast<WheelTimer&>(*list.next);
+		timer.unlink();
+		_stats.numCascades++;
+		place(timer);
+	}
+}
+
+void TimerWheel::processTick() {
+	_tickCount++;
+	_stats.numTicks++;
+
+	// When a level completed a rotation, move the timers of the next slot of the level above down.
+	// Start at the top, as those timers may end up in a slot of a lower level that is cascaded this tick as well.
+	for (uint8_t level = LEVELS - 1; level > 0; --level) {
+		uint32_t lowerMask = (1 << (level * SLOT_BITS)) - 1;
+		if ((_tickCount & lowerMask) == 0) {
+			cascade(level, getSlot(_tickCount, level));
+		}
+	}
+
+	// All timers in the current slot of level 0 expire now.
+	timer_wheel_link_t list;
+	moveList(_slots[0][getSlot(_tickCount, 0)], list);
+	if (!list.isLinked()) {
+		_stats.numIdleTicks++;
+		return;
+	}
+	while (list.isLinked()) {
+		WheelTimer& timer = static_cast<WheelTimer&>(*list.next);
+		timer.unlink();
+		if (!timer.action) {
+			continue;
+		}
+		_stats.numCalls++;
+		uint32_t delayTicks = timer.action();
+		// The action may have started the timer itself.
+		if (delayTicks != 0 && !timer.isStarted()) {
+			start(timer, delayTicks);
+		}
+	}
+}
@@ -0,0 +1,155 @@
+#define SERIAL_VERBOSITY SERIAL_DEBUG
+
+#include <structs/cs_AdStructureIndex.h>
+
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAS_CYCLE_COUNTER
+#endif
+
+using namespace std;
+
+/**
+ * Copy of CsUtils::findAdvType(), which every consumer used to call on the raw data.
+ */
+bool findAdvTypeReference(uint8_t type, const uint8_t* advData, uint8_t advLen, uint8_t& offset, uint8_t& len) {
+	int index = 0;
+	while (index < advLen-1) {
+		uint8_t fieldLen = advData[index];
+		uint8_t fieldType = advData[index + 1];
+		if (fieldLen == 0 || index + 1 + fieldLen > advLen) {
+			return false;
+		}
+		if (fieldType == type) {
+			offset = index + 2;
+			len = fieldLen - 1;
+			return true;
+		}
+		index += fieldLen+1;
+	}
+	return false;
+}
+
+/**
+ * Advertisements as captured in an office with phones, beacons, and crownstones.
+ */
+vector<vector<uint8_t>> corpus = {
+	// iBeacon
+	{0x02, 0x01, 0x06, 0x1A, 0xFF, 0x4C, 0x00, 0x02, 0x15, 0xA6, 0x43, 0x80, 0x44, 0x6B, 0x24, 0x41, 0x0E, 0xA4, 0x7C,
+			0x6E, 0x4A, 0x06, 0x6D, 0xE5, 0x6F, 0x00, 0x01, 0x00, 0x02, 0xC4},
+	// Crownstone service data
+	{0x02, 0x01, 0x06, 0x03, 0x03, 0x01, 0xC0, 0x15, 0x16, 0x01, 0xC0, 0x05, 0x3D, 0x1A, 0x8B, 0x22, 0x01, 0x77, 0x31,
+			0x5C, 0x9E, 0x11, 0xA0, 0x42, 0x0F, 0x66, 0x10, 0x72, 0x4E},
+	// Apple background advertisement
+	{0x02, 0x01, 0x1A, 0x14, 0xFF, 0x4C, 0x00, 0x01, 0x00, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00},
+	// Android background broadcast: 16 bit service UUIDs
+	{0x02, 0x01, 0x1A, 0x09, 0x02, 0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC, 0xDE, 0xF0},
+	// Command advertisement: 16 and 128 bit service UUIDs
+	{0x02, 0x01, 0x1A, 0x09, 0x03, 0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC, 0xDE, 0xF0, 0x11, 0x07, 0x01, 0x02, 0x03, 0x04,
+			0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10},
+	// Eddystone UID
+	{0x02, 0x01, 0x06, 0x03, 0x03, 0xAA, 0xFE, 0x17, 0x16, 0xAA, 0xFE, 0x00, 0xE7, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06,
+			0x07, 0x08, 0x09, 0x0A, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x00, 0x00},
+	// Named device with tx power
+	{0x02, 0x01, 0x06, 0x02, 0x0A, 0x04, 0x09, 0x09, 0x53, 0x65, 0x6E, 0x73, 0x6F, 0x72, 0x20, 0x31},
+	// Scan response with only a name
+	{0x0B, 0x09, 0x43, 0x72, 0x6F, 0x77, 0x6E, 0x73, 0x74, 0x6F, 0x6E, 0x65},
+	// Malformed: length runs past the end
+	{0x02, 0x01, 0x06, 0x1F, 0xFF, 0x4C, 0x00},
+	// Malformed: zero length in the middle
+	{0x02, 0x01, 0x06, 0x00, 0x03, 0xFF, 0x4C, 0x00},
+	// Many small structures
+	{0x01, 0x01, 0x01, 0x02, 0x01, 0x03, 0x01, 0x04, 0x01, 0x05, 0x01, 0x06, 0x01, 0x07, 0x01, 0x08, 0x01, 0x09, 0x01, 0x0A,
+			0x01, 0x0B, 0x01, 0x0C, 0x01, 0x0D, 0x01, 0x0E, 0x01, 0x0F},
+};
+
+/**
+ * AD types that are looked up for each scanned device: background adv handler, command adv handler,
+ * and a few asset filters.
+ */
+const uint8_t lookups[] = {0x02, 0xFF, 0x03, 0x07, 0xFF, 0x16, 0xFF, 0x09};
+
+void testSameResults(const vector<uint8_t>& adv) {
+	ad_structure_index_t index;
+	for (int type = 0; type < 256; ++type) {
+		uint8_t refOffset = 0, refLen = 0, offset = 0, len = 0;
+		bool refFound = findAdvTypeReference(type, adv.data(), adv.size(), refOffset, refLen);
+		bool found = index.find(type, adv.data(), adv.size(), offset, len);
+		assert(found == refFound);
+		if (found) {
+			assert(offset == refOffset);
+			assert(len == refLen);
+		}
+	}
+}
+
+uint64_t now() {
+#ifdef HAS_CYCLE_COUNTER
+	return __rdtsc();
+#else
+	return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+int main() {
+	cout << "Test ad_structure_index_t" << endl;
+
+	cout << "Check that all lookups give the same result as findAdvType." << endl;
+	for (auto& adv : corpus) {
+		testSameResults(adv);
+	}
+
+	cout << "Check long data, with more structures than fit in the index." << endl;
+	vector<uint8_t> longAdv;
+	for (int i = 0; i < 60; ++i) {
+		longAdv.push_back(2);
+		longAdv.push_back(i);
+		longAdv.push_back(i);
+	}
+	testSameResults(longAdv);
+
+	const int rounds = 200000;
+	uint32_t foundRef = 0;
+	uint32_t foundIndex = 0;
+	uint8_t offset, len;
+
+	uint64_t start = now();
+	for (int r = 0; r < rounds; ++r) {
+		for (auto& adv : corpus) {
+			for (auto type : lookups) {
+				foundRef += findAdvTypeReference(type, adv.data(), adv.size(), offset, len) ? len : 0;
+			}
+		}
+	}
+	uint64_t mid = now();
+	for (int r = 0; r < rounds; ++r) {
+		for (auto& adv : corpus) {
+			// Every scanned device gets a fresh index.
+			ad_structure_index_t index;
+			for (auto type : lookups) {
+				foundIndex += index.find(type, adv.data(), adv.size(), offset, len) ? len : 0;
+			}
+		}
+	}
+	uint64_t end = now();
+	assert(foundRef == foundIndex);
+
+	double numAdvs = static_cast<double>(rounds) * corpus.size();
+#ifdef HAS_CYCLE_COUNTER
+	const char* unit = " cycles/advertisement";
+#else
+	const char* unit = " ns/advertisement";
+#endif
+	cout << "Each consumer walks the data:  " << (mid - start) / numAdvs << unit << endl;
+	cout << "Shared index:                  " << (end - mid) / numAdvs << unit << endl;
+
+	cout << "Done" << endl;
+	return 0;
+}
@@ -0,0 +1,393 @@
+#define SERIAL_VERBOSITY SERIAL_DEBUG
+
+#include <localisation/cs_AssetFilterPlan.h>
+#include <protocol/cs_ExactMatchFilterStructs.h>
+#include <util/cs_Hash.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Same as crc16_compute() of the nRF SDK, which is used by crc16() on the target.
+ */
+uint16_t crc16(const uint8_t* data, size_t size) {
+	uint16_t crc = 0xFFFF;
+	for (size_t i = 0; i < size; i++) {
+		crc = (uint8_t)(crc >> 8) | (crc << 8);
+		crc ^= data[i];
+		crc ^= (uint8_t)(crc & 0xFF) >> 4;
+		crc ^= (crc << 8) << 4;
+		crc ^= ((crc & 0xFF) << 4) << 1;
+	}
+	return crc;
+}
+
+/**
+ * Minimal cuckoo filter with the same layout and hashing as CuckooFilter.
+ */
+struct TestCuckooFilter {
+	vector<uint8_t> buffer;
+
+	TestCuckooFilter(uint8_t bucketCountLog2, uint8_t nestsPerBucket) {
+		buffer.resize(sizeof(cuckoo_filter_data_t) + (nestsPerBucket << bucketCountLog2) * sizeof(cuckoo_fingerprint_t));
+		data()->bucketCountLog2 = bucketCountLog2;
+		data()->nestsPerBucket  = nestsPerBucket;
+	}
+
+	cuckoo_filter_data_t* data() { return reinterpret_cast<cuckoo_filter_data_t*>(buffer.data()); }
+
+	static bool contains(cuckoo_filter_data_t* data, const cuckoo_key_hash_t& keyHash) {
+		size_t bucketCount = 1 << data->bucketCountLog2;
+		uint8_t buckets[2] = {
+				static_cast<uint8_t>(keyHash.bucketHash % bucketCount),
+				static_cast<uint8_t>((keyHash.bucketHash ^ keyHash.fingerprint) % bucketCount)};
+		for (auto bucket : buckets) {
+			for (size_t i = 0; i < data->nestsPerBucket; ++i) {
+				if (data->bucketArray[bucket * data->nestsPerBucket + i] == keyHash.fingerprint) {
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	void add(const uint8_t* key, size_t len) {
+		cuckoo_key_hash_t keyHash = hashKey(key, len);
+		size_t bucketCount        = 1 << data()->bucketCountLog2;
+		uint8_t buckets[2]        = {
+				static_cast<uint8_t>(keyHash.bucketHash % bucketCount),
+				static_cast<uint8_t>((keyHash.bucketHash ^ keyHash.fingerprint) % bucketCount)};
+		for (auto bucket : buckets) {
+			for (size_t i = 0; i < data()->nestsPerBucket; ++i) {
+				size_t nest = bucket * data()->nestsPerBucket + i;
+				if (data()->bucketArray[nest] == 0) {
+					data()->bucketArray[nest] = keyHash.fingerprint;
+					return;
+				}
+			}
+		}
+		// The filters in this test have a low load, so kicking out fingerprints is not needed.
+		assert(false);
+	}
+
+	static cuckoo_key_hash_t hashKey(const uint8_t* key, size_t len) {
+		return cuckoo_key_hash_t{.fingerprint = crc16(key, len), .bucketHash = Djb2(key, len)};
+	}
+};
+
+/**
+ * Minimal exact match filter with the same layout and lookup as ExactMatchFilter.
+ */
+struct TestExactMatchFilter {
+	vector<uint8_t> buffer;
+
+	TestExactMatchFilter(uint8_t itemSize, vector<vector<uint8_t>> items) {
+		sort(items.begin(), items.end());
+		items.erase(unique(items.begin(), items.end()), items.end());
+		buffer.resize(sizeof(exact_match_filter_data_t) + items.size() * itemSize);
+		data()->itemCount = items.size();
+		data()->itemSize  = itemSize;
+		for (size_t i = 0; i < items.size(); ++i) {
+			assert(items[i].size() == itemSize);
+			memcpy(data()->itemArray + i * itemSize, items[i].data(), itemSize);
+		}
+	}
+
+	exact_match_filter_data_t* data() { return reinterpret_cast<exact_match_filter_data_t*>(buffer.data()); }
+
+	static bool contains(exact_match_filter_data_t* data, const uint8_t* key, size_t len) {
+		if (len != data->itemSize || data->itemCount == 0) {
+			return false;
+		}
+		int lowerIndex = 0;
+		int upperIndex = data->itemCount - 1;
+		while (lowerIndex <= upperIndex) {
+			int midpointIndex = (lowerIndex + upperIndex) / 2;
+			int cmp           = memcmp(key, data->itemArray + midpointIndex * len, len);
+			if (cmp == 0) {
+				return true;
+			}
+			if (cmp > 0) {
+				lowerIndex = midpointIndex + 1;
+			}
+			else {
+				upperIndex = midpointIndex - 1;
+			}
+		}
+		return false;
+	}
+};
+
+struct TestOps {
+	static cuckoo_key_hash_t hashKey(const uint8_t* key, size_t keyLength) {
+		return TestCuckooFilter::hashKey(key, keyLength);
+	}
+
+	static bool cuckooFilterContains(void* filterData, const cuckoo_key_hash_t& keyHash) {
+		return TestCuckooFilter::contains(static_cast<cuckoo_filter_data_t*>(filterData), keyHash);
+	}
+
+	static bool exactMatchFilterContains(void* filterData, const uint8_t* key, size_t keyLength) {
+		return TestExactMatchFilter::contains(static_cast<exact_match_filter_data_t*>(filterData), key, keyLength);
+	}
+};
+
+struct test_filter_t {
+	AssetFilterInputType inputType;
+	uint8_t adDataType;
+	uint32_t adDataMask;
+	AssetFilterType filterType;
+	bool exclude;
+	void* data;
+};
+
+struct test_device_t {
+	array<uint8_t, 6> address;
+	vector<uint8_t> adv;
+};
+
+/**
+ * Extracts the input of a filter, like AssetFilter::prepareFilterInputAndCallDelegate().
+ */
+bool getInput(
+		const test_filter_t& filter,
+		const test_device_t& device,
+		ad_structure_index_t& adIndex,
+		uint8_t* buf,
+		size_t& len) {
+	switch (filter.inputType) {
+		case AssetFilterInputType::MacAddress: {
+			memcpy(buf, device.address.data(), device.address.size());
+			len = device.address.size();
+			return true;
+		}
+		case AssetFilterInputType::AdDataType:
+		case AssetFilterInputType::MaskedAdDataType: {
+			uint8_t offset, fieldLen;
+			if (!adIndex.find(filter.adDataType, device.adv.data(), device.adv.size(), offset, fieldLen)) {
+				return false;
+			}
+			if (filter.inputType == AssetFilterInputType::AdDataType) {
+				memcpy(buf, device.adv.data() + offset, fieldLen);
+				len = fieldLen;
+				return true;
+			}
+			if (fieldLen > 31) {
+				return false;
+			}
+			len = 0;
+			for (uint8_t bitIndex = 0; bitIndex < fieldLen; bitIndex++) {
+				if (filter.adDataMask & (1u << bitIndex)) {
+					buf[len++] = device.adv[offset + bitIndex];
+				}
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+bool filterAccepts(const test_filter_t& filter, const test_device_t& device, ad_structure_index_t& adIndex) {
+	uint8_t buf[32];
+	size_t len;
+	if (!getInput(filter, device, adIndex, buf, len)) {
+		return false;
+	}
+	if (filter.filterType == AssetFilterType::CuckooFilter) {
+		return TestOps::cuckooFilterContains(filter.data, TestOps::hashKey(buf, len));
+	}
+	return TestOps::exactMatchFilterContains(filter.data, buf, len);
+}
+
+/**
+ * Evaluation like AssetFiltering used to do: first loop over the exclude filters, then over the other filters.
+ * Each filter extracts and hashes its own input, using the AD structure index of the scanned device.
+ */
+asset_filter_plan_result_t evaluatePerFilter(const vector<test_filter_t>& filters, const test_device_t& device) {
+	asset_filter_plan_result_t result;
+	ad_structure_index_t adIndex;
+	for (uint8_t i = 0; i < filters.size(); ++i) {
+		if (filters[i].exclude && filterAccepts(filters[i], device, adIndex)) {
+			result.rejected   = true;
+			result.filterMask = 1 << i;
+			return result;
+		}
+	}
+	for (uint8_t i = 0; i < filters.size(); ++i) {
+		if (!filters[i].exclude && filterAccepts(filters[i], device, adIndex)) {
+			result.filterMask |= 1 << i;
+		}
+	}
+	return result;
+}
+
+/**
+ * Generates an advertisement with manufacturer data, service data, and a name.
+ */
+vector<uint8_t> makeAdvertisement(uint32_t seed) {
+	vector<uint8_t> adv = {0x02, 0x01, 0x06};
+	adv.insert(adv.end(), {0x09, 0xFF, 0x4C, 0x00});
+	for (int i = 0; i < 6; ++i) {
+		adv.push_back(static_cast<uint8_t>(seed >> (i % 4 * 8)) ^ i);
+	}
+	if (seed & 1) {
+		adv.insert(adv.end(), {0x07, 0x16, 0xAA, 0xFE});
+		adv.push_back(seed % 7);
+		adv.push_back(seed % 11);
+		adv.push_back(seed % 13);
+		adv.push_back(seed % 17);
+	}
+	if (seed & 2) {
+		adv.insert(adv.end(), {0x05, 0x09, 'T', 'a', 'g'});
+		adv.push_back('0' + seed % 10);
+	}
+	return adv;
+}
+
+test_device_t makeDevice(uint32_t seed) {
+	test_device_t device;
+	for (int i = 0; i < 6; ++i) {
+		device.address[i] = static_cast<uint8_t>((seed * 2654435761u) >> (i * 5));
+	}
+	device.adv = makeAdvertisement(seed);
+	return device;
+}
+
+int main() {
+	cout << "Test AssetFilterPlan" << endl;
+
+	// Devices that are put in the filters, and devices that are scanned.
+	const int numKnownDevices   = 64;
+	const int numScannedDevices = 4096;
+	vector<test_device_t> devices;
+	for (int i = 0; i < numScannedDevices; ++i) {
+		devices.push_back(makeDevice(i));
+	}
+
+	// Eight mixed filters, several of which share an input.
+	vector<test_filter_t> filters = {
+			{AssetFilterInputType::MacAddress, 0, 0, AssetFilterType::CuckooFilter, true, nullptr},
+			{AssetFilterInputType::MacAddress, 0, 0, AssetFilterType::CuckooFilter, false, nullptr},
+			{AssetFilterInputType::MacAddress, 0, 0, AssetFilterType::ExactMatchFilter, false, nullptr},
+			{AssetFilterInputType::AdDataType, 0xFF, 0, AssetFilterType::CuckooFilter, false, nullptr},
+			{AssetFilterInputType::AdDataType, 0xFF, 0, AssetFilterType::ExactMatchFilter, false, nullptr},
+			{AssetFilterInputType::MaskedAdDataType, 0xFF, 0x3C, AssetFilterType::CuckooFilter, false, nullptr},
+			{AssetFilterInputType::AdDataType, 0x16, 0, AssetFilterType::ExactMatchFilter, false, nullptr},
+			{AssetFilterInputType::AdDataType, 0x09, 0, AssetFilterType::CuckooFilter, true, nullptr},
+	};
+
+	vector<TestCuckooFilter> cuckooFilters;
+	vector<TestExactMatchFilter> exactMatchFilters;
+	cuckooFilters.reserve(filters.size());
+	exactMatchFilters.reserve(filters.size());
+	srand(1);
+	for (auto& filter : filters) {
+		// Every filter gets a different subset of the known devices.
+		vector<vector<uint8_t>> inputs;
+		for (int i = 0; i < numKnownDevices; ++i) {
+			if (rand() % 2 == 0) {
+				continue;
+			}
+			uint8_t buf[32];
+			size_t len;
+			ad_structure_index_t adIndex;
+			if (getInput(filter, devices[i * (numScannedDevices / numKnownDevices)], adIndex, buf, len)) {
+				inputs.emplace_back(buf, buf + len);
+			}
+		}
+		// Exclude only a few devices.
+		if (filter.exclude) {
+			inputs.resize(min<size_t>(inputs.size(), 4));
+		}
+		if (filter.filterType == AssetFilterType::CuckooFilter) {
+			cuckooFilters.emplace_back(5, 4);
+			for (auto& input : inputs) {
+				cuckooFilters.back().add(input.data(), input.size());
+			}
+			filter.data = cuckooFilters.back().data();
+		}
+		else {
+			uint8_t itemSize = inputs.empty() ? 6 : inputs[0].size();
+			exactMatchFilters.emplace_back(itemSize, inputs);
+			filter.data = exactMatchFilters.back().data();
+		}
+	}
+
+	AssetFilterPlan plan;
+	for (uint8_t i = 0; i < filters.size(); ++i) {
+		auto& filter = filters[i];
+		bool added = plan.addFilter(
+				i, filter.inputType, filter.adDataType, filter.adDataMask, filter.filterType, filter.data, filter.exclude);
+		assert(added);
+	}
+	assert(plan.getInputCount() == 5);
+
+	cout << "Check that the plan gives the same result as evaluating each filter." << endl;
+	int numRejected = 0;
+	int numAccepted = 0;
+	for (auto& device : devices) {
+		ad_structure_index_t adIndex;
+		auto expected = evaluatePerFilter(filters, device);
+		auto result   = plan.evaluate<TestOps>(
+				device.address.data(), device.address.size(), device.adv.data(), device.adv.size(), adIndex);
+		assert(result.rejected == expected.rejected);
+		assert(result.filterMask == expected.filterMask);
+		numRejected += result.rejected;
+		numAccepted += (!result.rejected && result.filterMask != 0);
+	}
+	cout << "  rejected=" << numRejected << " accepted=" << numAccepted << " of " << devices.size() << endl;
+	assert(numRejected > 0);
+	assert(numAccepted > 0);
+
+	cout << "Check that a cleared plan accepts nothing." << endl;
+	plan.clear();
+	for (auto& device : devices) {
+		ad_structure_index_t adIndex;
+		auto result = plan.evaluate<TestOps>(
+				device.address.data(), device.address.size(), device.adv.data(), device.adv.size(), adIndex);
+		assert(!result.rejected && result.filterMask == 0);
+	}
+	for (uint8_t i = 0; i < filters.size(); ++i) {
+		auto& filter = filters[i];
+		plan.addFilter(
+				i, filter.inputType, filter.adDataType, filter.adDataMask, filter.filterType, filter.data, filter.exclude);
+	}
+
+	const int rounds = 200;
+	uint32_t checkPerFilter = 0;
+	uint32_t checkPlan      = 0;
+	auto t0                 = chrono::steady_clock::now();
+	for (int r = 0; r < rounds; ++r) {
+		for (auto& device : devices) {
+			checkPerFilter += evaluatePerFilter(filters, device).filterMask;
+		}
+	}
+	auto t1 = chrono::steady_clock::now();
+	for (int r = 0; r < rounds; ++r) {
+		for (auto& device : devices) {
+			// Every scanned device gets a fresh AD structure index.
+			ad_structure_index_t adIndex;
+			auto result = plan.evaluate<TestOps>(
+					device.address.data(), device.address.size(), device.adv.data(), device.adv.size(), adIndex);
+			checkPlan += result.filterMask;
+		}
+	}
+	auto t2 = chrono::steady_clock::now();
+	assert(checkPerFilter == checkPlan);
+
+	double numAdvs = static_cast<double>(rounds) * devices.size();
+	cout << "8 filters, 5 distinct inputs:" << endl;
+	cout << "  per filter: " << numAdvs / chrono::duration<double>(t1 - t0).count() << " advertisements/s" << endl;
+	cout << "  plan:       " << numAdvs / chrono::duration<double>(t2 - t1).count() << " advertisements/s" << endl;
+
+	cout << "Done" << endl;
+	return 0;
+}
@@ -0,0 +1,161 @@
+#define SERIAL_VERBOSITY SERIAL_DEBUG
+
+#include <util/cs_CrcTable.h>
+
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Copy of crc16_compute() of the nRF SDK.
+ */
+uint16_t crc16Reference(const uint8_t* data, uint32_t size, const uint16_t* prevCrc) {
+	uint16_t crc = (prevCrc == nullptr) ? 0xFFFF : *prevCrc;
+	for (uint32_t i = 0; i < size; i++) {
+		crc = (uint8_t)(crc >> 8) | (crc << 8);
+		crc ^= data[i];
+		crc ^= (uint8_t)(crc & 0xFF) >> 4;
+		crc ^= (crc << 8) << 4;
+		crc ^= ((crc & 0xFF) << 4) << 1;
+	}
+	return crc;
+}
+
+/**
+ * Copy of crc32_compute() of the nRF SDK.
+ */
+uint32_t crc32Reference(const uint8_t* data, uint32_t size, const uint32_t* prevCrc) {
+	uint32_t crc = (prevCrc == nullptr) ? 0xFFFFFFFF : ~(*prevCrc);
+	for (uint32_t i = 0; i < size; i++) {
+		crc = crc ^ data[i];
+		for (uint32_t j = 8; j > 0; j--) {
+			crc = (crc >> 1) ^ (0xEDB88320U & ((crc & 1) ? 0xFFFFFFFF : 0));
+		}
+	}
+	return ~crc;
+}
+
+vector<uint8_t> randomData(size_t size) {
+	vector<uint8_t> data(size);
+	for (auto& byte : data) {
+		byte = rand();
+	}
+	return data;
+}
+
+void testSameResults() {
+	cout << "Check that all implementations give the same results as the SDK." << endl;
+
+	// Known values: CRC-16/CCITT-FALSE and CRC-32 of "123456789".
+	const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+	assert(crc16Reference(check, sizeof(check), nullptr) == 0x29B1);
+	assert(crc32Reference(check, sizeof(check), nullptr) == 0xCBF43926);
+
+	srand(1);
+	for (size_t size = 0; size < 600; size += (size < 80) ? 1 : 37) {
+		for (size_t offset = 0; offset < 8; offset += 3) {
+			auto buffer         = randomData(size + offset);
+			const uint8_t* data = buffer.data() + offset;
+
+			uint16_t crc16 = crc16Reference(data, size, nullptr);
+			assert(CsCrc::crc16<1>(data, size, 0xFFFF) == crc16);
+			assert(CsCrc::crc16<4>(data, size, 0xFFFF) == crc16);
+			assert(CsCrc::crc16<8>(data, size, 0xFFFF) == crc16);
+
+			uint32_t crc32 = crc32Reference(data, size, nullptr);
+			assert(CsCrc::crc32Table<1>(data, size, 0) == crc32);
+			assert(CsCrc::crc32Table<4>(data, size, 0) == crc32);
+			assert(CsCrc::crc32Table<8>(data, size, 0) == crc32);
+			assert(CsCrc::crc32<8>(data, size, 0) == crc32);
+
+			// Continue from a previous CRC, like chunked validation does.
+			uint16_t prevCrc16 = rand();
+			uint32_t prevCrc32 = rand();
+			assert(CsCrc::crc16<8>(data, size, prevCrc16) == crc16Reference(data, size, &prevCrc16));
+			assert(CsCrc::crc32<8>(data, size, prevCrc32) == crc32Reference(data, size, &prevCrc32));
+		}
+	}
+}
+
+template <class Function>
+double measure(size_t size, Function function) {
+	auto data         = randomData(size);
+	size_t iterations = 1 + (32 * 1024 * 1024) / (size + 16);
+	uint32_t check    = 0;
+	auto start        = chrono::steady_clock::now();
+	for (size_t i = 0; i < iterations; ++i) {
+		check += function(data.data(), size, check);
+	}
+	auto end = chrono::steady_clock::now();
+	// Keep the result alive.
+	volatile uint32_t sink = check;
+	(void)sink;
+	double seconds = chrono::duration<double>(end - start).count();
+	return iterations * size / seconds / 1e6;
+}
+
+void benchmark() {
+	const size_t sizes[] = {6, 16, 64, 256, 1024, 4096, 65536};
+
+	cout << endl << "CRC16 MB/s" << endl;
+	cout << setw(8) << "size" << setw(10) << "sdk" << setw(10) << "table" << setw(10) << "slice4" << setw(10)
+		 << "slice8" << endl;
+	for (size_t size : sizes) {
+		cout << setw(8) << size << fixed << setprecision(0);
+		cout << setw(10) << measure(size, [](const uint8_t* d, size_t s, uint32_t c) {
+			uint16_t prev = c;
+			return crc16Reference(d, s, &prev);
+		});
+		cout << setw(10) << measure(size, [](const uint8_t* d, size_t s, uint32_t c) {
+			return CsCrc::crc16<1>(d, s, c);
+		});
+		cout << setw(10) << measure(size, [](const uint8_t* d, size_t s, uint32_t c) {
+			return CsCrc::crc16<4>(d, s, c);
+		});
+		cout << setw(10) << measure(size, [](const uint8_t* d, size_t s, uint32_t c) {
+			return CsCrc::crc16<8>(d, s, c);
+		});
+		cout << endl;
+	}
+
+	cout << endl << "CRC32 MB/s" << endl;
+	cout << setw(8) << "size" << setw(10) << "sdk" << setw(10) << "table" << setw(10) << "slice4" << setw(10)
+		 << "slice8" << setw(10) << "pclmul" << endl;
+	for (size_t size : sizes) {
+		cout << setw(8) << size << fixed << setprecision(0);
+		cout << setw(10) << measure(size, [](const uint8_t* d, size_t s, uint32_t c) {
+			return crc32Reference(d, s, &c);
+		});
+		cout << setw(10) << measure(size, [](const uint8_t* d, size_t s, uint32_t c) {
+			return CsCrc::crc32Table<1>(d, s, c);
+		});
+		cout << setw(10) << measure(size, [](const uint8_t* d, size_t s, uint32_t c) {
+			return CsCrc::crc32Table<4>(d, s, c);
+		});
+		cout << setw(10) << measure(size, [](const uint8_t* d, size_t s, uint32_t c) {
+			return CsCrc::crc32Table<8>(d, s, c);
+		});
+		cout << setw(10) << measure(size, [](const uint8_t* d, size_t s, uint32_t c) {
+			return CsCrc::crc32<8>(d, s, c);
+		});
+		cout << endl;
+	}
+}
+
+int main() {
+	cout << "Test CRC" << endl;
+#ifdef CS_CRC_PCLMUL
+	cout << "PCLMUL: " << (CsCrc::hasPclmul() ? "yes" : "no") << endl;
+#endif
+
+	testSameResults();
+	benchmark();
+
+	cout << "Done" << endl;
+	return 0;
+}
@@ -0,0 +1,211 @@
+#define SERIAL_VERBOSITY SERIAL_DEBUG
+
+#include <util/cs_Crc16.h>
+#include <util/cs_CuckooFilter.h>
+#include <util/cs_Hash.h>
+
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+typedef vector<uint8_t> test_key_t;
+
+/**
+ * Contains check as it was before the single pass hash and the word wise bucket compare:
+ * separate crc16 and Djb2 passes over the key, and one nest at a time.
+ */
+bool containsReference(cuckoo_filter_data_t* data, const uint8_t* key, size_t keyLen) {
+	cuckoo_fingerprint_t fingerprint = crc16(key, keyLen, nullptr);
+	cuckoo_fingerprint_t bucketHash  = Djb2(key, keyLen);
+	size_t bucketCount               = 1 << data->bucketCountLog2;
+	cuckoo_index_t buckets[]         = {
+            static_cast<cuckoo_index_t>(bucketHash % bucketCount),
+            static_cast<cuckoo_index_t>((bucketHash ^ fingerprint) % bucketCount)};
+	for (cuckoo_index_t bucket : buckets) {
+		for (size_t nest = 0; nest < data->nestsPerBucket; ++nest) {
+			cuckoo_fingerprint_t value;
+			memcpy(&value, &data->bucketArray[bucket * data->nestsPerBucket + nest], sizeof(value));
+			if (value == fingerprint) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+vector<uint8_t> parseBytes(stringstream& stream) {
+	vector<uint8_t> bytes;
+	string word;
+	while (getline(stream, word, ',')) {
+		bytes.push_back(strtoul(word.c_str(), nullptr, 16));
+	}
+	return bytes;
+}
+
+/**
+ * Reads the operations file: the filter dimensions and the keys that are added.
+ */
+bool readTestFile(const string& fileName, uint32_t& bucketCount, uint32_t& nestsPerBucket, vector<test_key_t>& keys) {
+	ifstream file(fileName);
+	if (!file) {
+		return false;
+	}
+	string line;
+	while (getline(file, line)) {
+		if (line.empty() || line[0] == '#') {
+			continue;
+		}
+		stringstream lineStream(line);
+		string operation;
+		getline(lineStream, operation, ',');
+		vector<uint8_t> bytes = parseBytes(lineStream);
+		if (operation == "cuckoofilter") {
+			bucketCount    = bytes[0];
+			nestsPerBucket = bytes[1];
+		}
+		else if (operation == "add") {
+			keys.push_back(bytes);
+		}
+	}
+	return true;
+}
+
+vector<test_key_t> randomKeys(size_t count, size_t minLen, size_t maxLen) {
+	vector<test_key_t> keys(count);
+	for (auto& key : keys) {
+		key.resize(minLen + rand() % (maxLen - minLen + 1));
+		for (auto& byte : key) {
+			byte = rand();
+		}
+	}
+	return keys;
+}
+
+void testHashKey() {
+	cout << "Check that the single pass hash gives the same results as crc16 and Djb2." << endl;
+	srand(1);
+	for (auto& key : randomKeys(1000, 0, 40)) {
+		cuckoo_key_hash_t keyHash = CuckooFilter::hashKey(key.data(), key.size());
+		assert(keyHash.fingerprint == crc16(key.data(), key.size(), nullptr));
+		assert(keyHash.bucketHash == Djb2(key.data(), key.size()));
+	}
+}
+
+/**
+ * Builds the filter from the test file, and checks:
+ * - all added keys are found.
+ * - contains() gives the same result as the reference for other keys.
+ * - the false positive rate stays below the bound.
+ */
+void testFilter(const string& fileName, uint8_t* buffer, CuckooFilter& filter, vector<test_key_t>& addedKeys) {
+	cout << "Check filter built from " << fileName << endl;
+	uint32_t bucketCount    = 0;
+	uint32_t nestsPerBucket = 0;
+	bool fileRead           = readTestFile(fileName, bucketCount, nestsPerBucket, addedKeys);
+	assert(fileRead);
+	assert(bucketCount != 0 && nestsPerBucket != 0);
+	assert(CuckooFilter::size(bucketCount, nestsPerBucket) <= 2048);
+
+	filter = CuckooFilter(reinterpret_cast<cuckoo_filter_data_t*>(buffer));
+	filter.init(bucketCount, nestsPerBucket);
+	for (auto& key : addedKeys) {
+		bool added = filter.add(key.data(), key.size());
+		assert(added);
+	}
+
+	auto* data = reinterpret_cast<cuckoo_filter_data_t*>(buffer);
+	for (auto& key : addedKeys) {
+		assert(filter.contains(key.data(), key.size()));
+		assert(filter.contains(CuckooFilter::hashKey(key.data(), key.size())));
+		assert(containsReference(data, key.data(), key.size()));
+	}
+
+	// Keys of the same lengths that were not added.
+	srand(2);
+	auto otherKeys        = randomKeys(200000, 6, 20);
+	size_t falsePositives = 0;
+	for (auto& key : otherKeys) {
+		bool found = filter.contains(key.data(), key.size());
+		assert(found == containsReference(data, key.data(), key.size()));
+		falsePositives += found;
+	}
+
+	// Each lookup compares 2 buckets of fingerprints, a 16 bit fingerprint matches by chance with
+	// probability 1/2^16. Empty nests hold fingerprint 0, so they only match keys with fingerprint 0.
+	double rate  = double(falsePositives) / otherKeys.size();
+	double bound = 2.0 * 2 * nestsPerBucket / 65536;
+	cout << "  false positive rate: " << rate << " (bound " << bound << ")" << endl;
+	assert(rate < bound);
+}
+
+template <class Function>
+double measure(const vector<test_key_t>& keys, Function function) {
+	size_t iterations = 0;
+	size_t found      = 0;
+	auto start        = chrono::steady_clock::now();
+	auto end          = start;
+	do {
+		for (auto& key : keys) {
+			found += function(key.data(), key.size());
+		}
+		iterations += keys.size();
+		end = chrono::steady_clock::now();
+	} while (chrono::duration<double>(end - start).count() < 0.2);
+	// Keep the result alive.
+	volatile size_t sink = found;
+	(void)sink;
+	return iterations / chrono::duration<double>(end - start).count() / 1e6;
+}
+
+void benchmark(CuckooFilter& filter, cuckoo_filter_data_t* data, const vector<test_key_t>& addedKeys) {
+	// Half members, half non members.
+	srand(3);
+	vector<test_key_t> keys = randomKeys(addedKeys.size(), 6, 20);
+	keys.insert(keys.end(), addedKeys.begin(), addedKeys.end());
+
+	cout << endl << "Lookups per second (M)" << endl;
+	cout << setw(12) << "reference" << setw(12) << "contains" << setw(12) << "key hash" << endl;
+	cout << fixed << setprecision(1);
+	cout << setw(12) << measure(keys, [data](const uint8_t* key, size_t len) {
+		return containsReference(data, key, len);
+	});
+	cout << setw(12) << measure(keys, [&filter](const uint8_t* key, size_t len) {
+		return filter.contains(key, len);
+	});
+
+	// As done by the asset filters: hash once, check multiple filters.
+	vector<cuckoo_key_hash_t> keyHashes;
+	for (auto& key : keys) {
+		keyHashes.push_back(CuckooFilter::hashKey(key.data(), key.size()));
+	}
+	size_t index = 0;
+	cout << setw(12) << measure(keys, [&](const uint8_t*, size_t) {
+		return filter.contains(keyHashes[index++ % keyHashes.size()]);
+	});
+	cout << endl;
+}
+
+int main(int argc, char** argv) {
+	cout << "Test cuckoo filter" << endl;
+	string testDir = (argc > 1) ? argv[1] : "test/host/cuckoo";
+
+	testHashKey();
+
+	alignas(4) static uint8_t buffer[2048] = {};
+	CuckooFilter filter;
+	vector<test_key_t> addedKeys;
+	testFilter(testDir + "/cuckoo_size_128_4_len_6_20.csv.cuck", buffer, filter, addedKeys);
+	benchmark(filter, reinterpret_cast<cuckoo_filter_data_t*>(buffer), addedKeys);
+
+	cout << "Done" << endl;
+	return 0;
+}
@@ -0,0 +1,193 @@
+#define SERIAL_VERBOSITY SERIAL_DEBUG
+
+#include <events/cs_EventRoutingTable.h>
+
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Benchmark of event dispatching: calling every listener (like the dispatcher used to do) versus only calling
+ * the listeners that are subscribed to the type via the EventRoutingTable.
+ *
+ * Type values are in the same ranges as in cs_Types.h, the exact values don't matter.
+ */
+const uint16_t EVT_TICK                = 0x100 + 210 + 2;
+const uint16_t EVT_DEVICE_SCANNED      = 0x100 + 0 + 1;
+const uint16_t EVT_ADV_BACKGROUND      = 0x100 + 0 + 2;
+const uint16_t EVT_RECV_MESH_MSG       = 0x100 + 140 + 1;
+const uint16_t EVT_STATE_SET           = 0x100 + 80 + 1;
+const uint16_t CMD_SWITCH              = 0x100 + 20 + 4;
+
+const int NUM_LISTENERS = 48;
+
+/**
+ * Listener that, like most real listeners, switches on a few types and ignores the rest.
+ */
+class TestListener {
+public:
+	vector<uint16_t> types;
+	uint32_t handled = 0;
+
+	virtual ~TestListener() {}
+
+	virtual void handleEvent(uint16_t type) {
+		for (auto t : types) {
+			if (t == type) {
+				handled++;
+				return;
+			}
+		}
+	}
+};
+
+TestListener listeners[NUM_LISTENERS];
+EventRoutingTable routes;
+
+/**
+ * Sequence of event types, in the ratio observed in a scanning burst: mostly scans, with ticks and mesh messages
+ * in between.
+ */
+vector<uint16_t> recordEventMix(size_t count) {
+	vector<uint16_t> mix;
+	srand(42);
+	for (size_t i = 0; i < count; ++i) {
+		int r = rand() % 100;
+		if (r < 80) {
+			mix.push_back(EVT_DEVICE_SCANNED);
+		}
+		else if (r < 85) {
+			mix.push_back(EVT_ADV_BACKGROUND);
+		}
+		else if (r < 90) {
+			mix.push_back(EVT_TICK);
+		}
+		else if (r < 98) {
+			mix.push_back(EVT_RECV_MESH_MSG);
+		}
+		else {
+			mix.push_back(EVT_STATE_SET);
+		}
+	}
+	return mix;
+}
+
+void dispatchAll(uint16_t type) {
+	for (int i = 0; i < NUM_LISTENERS; ++i) {
+		listeners[i].handleEvent(type);
+	}
+}
+
+void dispatchRouted(uint16_t type) {
+	event_listener_mask_t mask = routes.getListeners(type);
+	while (mask != 0) {
+		uint8_t index = __builtin_ctzll(mask);
+		mask &= mask - 1;
+		listeners[index].handleEvent(type);
+	}
+}
+
+uint32_t totalHandled() {
+	uint32_t total = 0;
+	for (auto& listener : listeners) {
+		total += listener.handled;
+		listener.handled = 0;
+	}
+	return total;
+}
+
+template<class Dispatch>
+double benchmark(const vector<uint16_t>& mix, Dispatch dispatch) {
+	auto start = chrono::steady_clock::now();
+	for (auto type : mix) {
+		dispatch(type);
+	}
+	auto end = chrono::steady_clock::now();
+	return chrono::duration<double, nano>(end - start).count() / mix.size();
+}
+
+int main() {
+	cout << "Test EventRoutingTable" << endl;
+
+	cout << "Set up listeners: 4 scan handlers, 6 tick handlers, 8 mesh handlers, 4 legacy listeners." << endl;
+	const uint16_t otherTypes[] = {CMD_SWITCH, EVT_STATE_SET, 0x200, 0x201, 0x202, 0x203};
+	for (int i = 0; i < NUM_LISTENERS; ++i) {
+		auto& types = listeners[i].types;
+		if (i < 4) {
+			types.push_back(EVT_DEVICE_SCANNED);
+		}
+		if (i >= 2 && i < 8) {
+			types.push_back(EVT_TICK);
+		}
+		if (i >= 8 && i < 16) {
+			types.push_back(EVT_RECV_MESH_MSG);
+		}
+		if (i == 1) {
+			types.push_back(EVT_ADV_BACKGROUND);
+		}
+		types.push_back(otherTypes[i % 6] + i);
+
+		if (i % 12 == 11) {
+			bool subscribed = routes.subscribeAll(i);
+			assert(subscribed);
+		}
+		else {
+			for (auto type : types) {
+				bool subscribed = routes.subscribe(type, i);
+				assert(subscribed);
+			}
+		}
+	}
+
+	cout << "Check that all types are routed to the subscribed listeners, in order." << endl;
+	assert(routes.getNumRoutes() <= MAX_EVENT_ROUTES);
+	for (auto type : {EVT_DEVICE_SCANNED, EVT_TICK, EVT_RECV_MESH_MSG, EVT_ADV_BACKGROUND, CMD_SWITCH}) {
+		event_listener_mask_t mask = routes.getListeners(type);
+		for (int i = 0; i < NUM_LISTENERS; ++i) {
+			bool wants = (i % 12 == 11);
+			for (auto t : listeners[i].types) {
+				wants |= (t == type);
+			}
+			assert(((mask >> i) & 1) == wants);
+		}
+	}
+
+	cout << "Check that unknown types only go to the catch all listeners." << endl;
+	event_listener_mask_t catchAll = routes.getListeners(0xEEEE);
+	for (int i = 0; i < NUM_LISTENERS; ++i) {
+		assert(((catchAll >> i) & 1) == (i % 12 == 11));
+	}
+
+	cout << "Check that a full table refuses new types." << endl;
+	EventRoutingTable full;
+	for (uint16_t type = 1; type <= MAX_EVENT_ROUTES; ++type) {
+		bool subscribed = full.subscribe(type, 0);
+		assert(subscribed);
+	}
+	bool subscribed = full.subscribe(MAX_EVENT_ROUTES + 1, 0);
+	assert(!subscribed);
+	subscribed = full.subscribe(1, 1);
+	assert(subscribed);
+
+	vector<uint16_t> mix = recordEventMix(1000000);
+
+	dispatchAll(EVT_TICK);
+	totalHandled();
+	double nsAll = benchmark(mix, dispatchAll);
+	uint32_t handledAll = totalHandled();
+	double nsRouted = benchmark(mix, dispatchRouted);
+	uint32_t handledRouted = totalHandled();
+
+	cout << "Check that both dispatch methods handle the same events." << endl;
+	assert(handledAll == handledRouted);
+
+	cout << "Dispatch to all listeners:     " << nsAll << " ns/event" << endl;
+	cout << "Dispatch to routed listeners:  " << nsRouted << " ns/event" << endl;
+
+	cout << "Done" << endl;
+	return 0;
+}
@@ -0,0 +1,196 @@
+#define SERIAL_VERBOSITY SERIAL_DEBUG
+
+#include <util/cs_ExactMatchFilterIndex.h>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Copy of the binary search of ExactMatchFilter::find().
+ */
+int findReference(exact_match_filter_data_t* data, const void* item, size_t itemSize) {
+	if (itemSize != data->itemSize || data->itemCount == 0) {
+		return -1;
+	}
+	int lowerIndex = 0;
+	int upperIndex = data->itemCount - 1;
+	while (lowerIndex <= upperIndex) {
+		int midpointIndex = (lowerIndex + upperIndex) / 2;
+		auto cmp          = memcmp(item, data->itemArray + midpointIndex * itemSize, itemSize);
+		if (cmp == 0) {
+			return midpointIndex;
+		}
+		if (cmp > 0) {
+			lowerIndex = midpointIndex + 1;
+		}
+		else {
+			upperIndex = midpointIndex - 1;
+		}
+	}
+	return -1;
+}
+
+vector<uint8_t> randomItem(size_t itemSize, const vector<uint8_t>& prefix) {
+	vector<uint8_t> item(prefix);
+	item.resize(itemSize);
+	for (size_t i = prefix.size(); i < itemSize; ++i) {
+		item[i] = rand();
+	}
+	return item;
+}
+
+/**
+ * Creates the filter data: sorted, unique items, that all start with the given prefix.
+ */
+vector<uint8_t> createFilter(size_t itemCount, size_t itemSize, const vector<uint8_t>& prefix) {
+	vector<vector<uint8_t>> items;
+	while (items.size() < itemCount) {
+		items.push_back(randomItem(itemSize, prefix));
+		sort(items.begin(), items.end());
+		items.erase(unique(items.begin(), items.end()), items.end());
+	}
+	vector<uint8_t> buffer = {static_cast<uint8_t>(itemCount), static_cast<uint8_t>(itemSize)};
+	for (auto& item : items) {
+		buffer.insert(buffer.end(), item.begin(), item.end());
+	}
+	return buffer;
+}
+
+vector<uint8_t> randomPrefix(size_t size) {
+	vector<uint8_t> prefix(size);
+	for (auto& byte : prefix) {
+		byte = rand();
+	}
+	return prefix;
+}
+
+void testSameResults() {
+	cout << "Check that the index gives the same results as the binary search." << endl;
+	srand(1);
+	const size_t itemCounts[] = {1, 2, 3, 10, 100, 255};
+	for (size_t itemSize = 1; itemSize <= 12; ++itemSize) {
+		for (size_t itemCount : itemCounts) {
+			if (itemSize == 1 && itemCount > 200) {
+				continue;
+			}
+			for (size_t prefixSize = 0; prefixSize < min<size_t>(itemSize, 4); ++prefixSize) {
+				auto prefix = randomPrefix(prefixSize);
+				// Unique items need enough bytes after the prefix.
+				if (itemSize - prefixSize == 1 && itemCount > 200) {
+					continue;
+				}
+				auto buffer = createFilter(itemCount, itemSize, prefix);
+				auto data   = reinterpret_cast<exact_match_filter_data_t*>(buffer.data());
+				ExactMatchFilterIndex index;
+				index.build(data);
+
+				for (size_t i = 0; i < itemCount; ++i) {
+					assert(index.find(data->itemArray + i * itemSize, itemSize) == static_cast<int>(i));
+				}
+
+				for (int i = 0; i < 1000; ++i) {
+					// Mostly keys with the same prefix, so that the search is done.
+					auto key = randomItem(itemSize, (i % 4) ? prefix : vector<uint8_t>());
+					assert(index.find(key.data(), itemSize) == findReference(data, key.data(), itemSize));
+				}
+
+				// Wrong size.
+				assert(index.find(data->itemArray, itemSize + 1) == -1);
+			}
+		}
+	}
+
+	// Filter with identical items.
+	vector<uint8_t> buffer = {3, 2, 5, 6, 5, 6, 5, 6};
+	auto data              = reinterpret_cast<exact_match_filter_data_t*>(buffer.data());
+	ExactMatchFilterIndex index;
+	index.build(data);
+	uint8_t member[]    = {5, 6};
+	uint8_t nonMember[] = {5, 7};
+	assert(index.contains(member, sizeof(member)));
+	assert(!index.contains(nonMember, sizeof(nonMember)));
+
+	// Not built.
+	ExactMatchFilterIndex emptyIndex;
+	assert(!emptyIndex.contains(member, sizeof(member)));
+}
+
+template <class Function>
+double measure(const vector<vector<uint8_t>>& keys, Function function) {
+	size_t iterations = 0;
+	size_t found      = 0;
+	auto start        = chrono::steady_clock::now();
+	auto end          = start;
+	do {
+		for (auto& key : keys) {
+			found += function(key.data(), key.size()) >= 0;
+		}
+		iterations += keys.size();
+		end = chrono::steady_clock::now();
+	} while (chrono::duration<double>(end - start).count() < 0.1);
+	// Keep the result alive.
+	volatile size_t sink = found;
+	(void)sink;
+	return iterations / chrono::duration<double>(end - start).count() / 1e6;
+}
+
+void benchmark() {
+	cout << endl << "Lookups per second (M), half of the keys are in the filter" << endl;
+	cout << setw(8) << "size" << setw(8) << "prefix" << setw(8) << "count" << setw(12) << "reference" << setw(12)
+		 << "index" << endl;
+	srand(2);
+	struct {
+		size_t itemSize;
+		size_t prefixSize;
+	} configs[] = {{3, 0}, {6, 0}, {6, 3}};
+	// The item count is an uint8_t in the filter data.
+	const size_t itemCounts[] = {16, 32, 64, 128, 255};
+	for (auto& config : configs) {
+		for (size_t itemCount : itemCounts) {
+			auto prefix = randomPrefix(config.prefixSize);
+			auto buffer = createFilter(itemCount, config.itemSize, prefix);
+			auto data   = reinterpret_cast<exact_match_filter_data_t*>(buffer.data());
+			ExactMatchFilterIndex index;
+			index.build(data);
+
+			vector<vector<uint8_t>> keys;
+			for (size_t i = 0; i < 1024; ++i) {
+				if (i % 2) {
+					const uint8_t* item = data->itemArray + (rand() % itemCount) * config.itemSize;
+					keys.emplace_back(item, item + config.itemSize);
+				}
+				else {
+					keys.push_back(randomItem(config.itemSize, prefix));
+				}
+			}
+
+			cout << setw(8) << config.itemSize << setw(8) << config.prefixSize << setw(8) << itemCount << fixed
+				 << setprecision(1);
+			cout << setw(12) << measure(keys, [data](const uint8_t* key, size_t len) {
+				return findReference(data, key, len);
+			});
+			cout << setw(12) << measure(keys, [&index](const uint8_t* key, size_t len) {
+				return index.find(key, len);
+			});
+			cout << endl;
+		}
+	}
+}
+
+int main() {
+	cout << "Test exact match filter index" << endl;
+
+	testSameResults();
+	benchmark();
+
+	cout << "Done" << endl;
+	return 0;
+}
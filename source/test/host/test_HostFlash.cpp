@@ -0,0 +1,429 @@
+#define SERIAL_VERBOSITY SERIAL_NONE
+
+/**
+ * Tests the host implementation of the flash layer: the flash itself, FDS and fstorage on top of it.
+ *
+ * FDS is tested against power loss: a workload of updates and garbage collection is interrupted after every possible
+ * number of flash operations, after which FDS should recover all records.
+ *
+ * Then measures the flash time of FDS operations under a State like write workload, to show the pauses caused by
+ * garbage collection, and the wear of the pages.
+ */
+
+#include <host/cs_HostFds.h>
+#include <host/cs_HostFlash.h>
+#include <host/cs_HostFstorage.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+const uint16_t FILE_ID = 3;
+
+vector<uint32_t> socEvents;
+
+void recordSocEvent(uint32_t evt) {
+	socEvents.push_back(evt);
+}
+
+void testHostFlash(const char* path) {
+	cout << "testHostFlash" << endl;
+	HostFlash& flash = HostFlash::getInstance();
+	cs_host_flash_config_t config;
+	config.pageSize = 1024;
+	config.numPages = 8;
+	unlink(path);
+	bool opened = flash.open(path, config);
+	assert(opened);
+	assert(flash.getSize() == 8 * 1024);
+	assert(flash.getPointer(8 * 1024) == nullptr);
+	assert(flash.getPointer(8 * 1024 - 4, 8) == nullptr);
+
+	// Writing can only clear bits.
+	const uint32_t* word = reinterpret_cast<const uint32_t*>(flash.getPointer(2048));
+	assert(*word == 0xFFFFFFFF);
+	uint32_t value = 0xF0F0FFFF;
+	bool written = flash.write(2048, &value, 1);
+	assert(written);
+	value = 0xFFFF0F0F;
+	written = flash.write(2048, &value, 1);
+	assert(written);
+	assert(*word == 0xF0F00F0F);
+	written = flash.write(2050, &value, 1);
+	assert(!written);
+	written = flash.write(8 * 1024, &value, 1);
+	assert(!written);
+	assert(flash.getStats().wordsWritten == 2);
+	assert(flash.getStats().busyTimeUs == 2 * config.writeWordUs);
+
+	// Only erasing sets bits again.
+	bool erased = flash.erasePage(2);
+	assert(erased);
+	assert(*word == 0xFFFFFFFF);
+	erased = flash.erasePage(8);
+	assert(!erased);
+	assert(flash.getEraseCounts()[2] == 1);
+
+	// Flash persists in the file.
+	value = 1234;
+	written = flash.write(4096, &value, 1);
+	assert(written);
+	flash.close();
+	assert(!flash.isOpen());
+	opened = flash.open(path, config);
+	assert(opened);
+	assert(*reinterpret_cast<const uint32_t*>(flash.getPointer(4096)) == 1234);
+
+	// Power loss: the interrupted operation and everything after it is lost.
+	uint32_t values[4] = {1, 2, 3, 4};
+	flash.setPowerLossAfter(2);
+	written = flash.write(0, values, 4);
+	assert(!written);
+	assert(flash.isPowerLost());
+	erased = flash.erasePage(1);
+	assert(!erased);
+	const uint32_t* words = reinterpret_cast<const uint32_t*>(flash.getPointer(0, 16));
+	assert(words[0] == 1 && words[1] == 2 && words[2] == 0xFFFFFFFF && words[3] == 0xFFFFFFFF);
+	flash.powerOn();
+	written = flash.write(8, &values[2], 2);
+	assert(written);
+	assert(words[2] == 3 && words[3] == 4);
+
+	// SoftDevice functions send a SoC event.
+	flash.setSocEventHandler(recordSocEvent);
+	ret_code_t nrfCode = sd_flash_page_erase(0);
+	assert(nrfCode == NRF_SUCCESS);
+	assert(words[0] == 0xFFFFFFFF);
+	uint32_t* dest = const_cast<uint32_t*>(words);
+	nrfCode = sd_flash_write(dest, values, 4);
+	assert(nrfCode == NRF_SUCCESS);
+	assert(words[3] == 4);
+	nrfCode = sd_flash_page_erase(8);
+	assert(nrfCode == NRF_ERROR_INVALID_ADDR);
+	nrfCode = sd_flash_write(dest, nullptr, 1);
+	assert(nrfCode == NRF_ERROR_NULL);
+	assert(socEvents.size() == 2);
+	assert(socEvents[0] == NRF_EVT_FLASH_OPERATION_SUCCESS && socEvents[1] == NRF_EVT_FLASH_OPERATION_SUCCESS);
+	flash.setSocEventHandler(nullptr);
+
+	flash.close();
+	unlink(path);
+}
+
+vector<fds_evt_t> fdsEvents;
+
+void recordFdsEvent(fds_evt_t const* p_evt) {
+	fdsEvents.push_back(*p_evt);
+}
+
+bool initFds() {
+	fdsEvents.clear();
+	ret_code_t nrfCode = fds_init();
+	assert(nrfCode == NRF_SUCCESS);
+	HostFds::getInstance().process();
+	return fdsEvents.size() == 1 && fdsEvents[0].id == FDS_EVT_INIT && fdsEvents[0].result == NRF_SUCCESS;
+}
+
+/**
+ * Get the values of all valid records with given key.
+ */
+vector<uint32_t> readValues(uint16_t key) {
+	vector<uint32_t> values;
+	fds_find_token_t token;
+	memset(&token, 0, sizeof(token));
+	fds_record_desc_t desc;
+	while (fds_record_find(FILE_ID, key, &desc, &token) == NRF_SUCCESS) {
+		fds_flash_record_t flashRecord;
+		ret_code_t nrfCode = fds_record_open(&desc, &flashRecord);
+		assert(nrfCode == NRF_SUCCESS);
+		const uint32_t* data = static_cast<const uint32_t*>(flashRecord.p_data);
+		for (uint16_t i = 1; i < flashRecord.p_header->length_words; ++i) {
+			assert(data[i] == data[0]);
+		}
+		values.push_back(data[0]);
+		fds_record_close(&desc);
+	}
+	return values;
+}
+
+/**
+ * Write a record with all words set to value.
+ */
+ret_code_t writeValue(fds_record_desc_t* desc, uint16_t key, uint32_t value, bool update) {
+	static uint32_t data[8];
+	for (auto& word : data) {
+		word = value;
+	}
+	fds_record_t record;
+	record.file_id           = FILE_ID;
+	record.key               = key;
+	record.data.p_data       = data;
+	record.data.length_words = 8;
+	ret_code_t retCode       = update ? fds_record_update(desc, &record) : fds_record_write(desc, &record);
+	HostFds::getInstance().process();
+	return retCode;
+}
+
+const uint16_t NUM_KEYS = 6;
+
+/**
+ * Start from a fresh flash, with a record for each key, and a first page full of dirty records.
+ */
+void prepare(fds_record_desc_t* descs) {
+	HostFds& fds = HostFds::getInstance();
+	bool opened = fds.open();
+	assert(opened);
+	bool initialized = initFds();
+	assert(initialized);
+	for (uint16_t key = 1; key <= NUM_KEYS; ++key) {
+		ret_code_t nrfCode = writeValue(&descs[key], key, key * 100, false);
+		assert(nrfCode == NRF_SUCCESS);
+	}
+	for (uint32_t i = 1; i <= 60; ++i) {
+		ret_code_t nrfCode = writeValue(&descs[1], 1, 100 + i, true);
+		assert(nrfCode == NRF_SUCCESS);
+	}
+}
+
+/**
+ * Update key 2, collect garbage, and update key 3.
+ */
+void runWorkload(fds_record_desc_t* descs) {
+	writeValue(&descs[2], 2, 201, true);
+	fds_gc();
+	HostFds::getInstance().process();
+	writeValue(&descs[3], 3, 301, true);
+}
+
+void testPowerLoss() {
+	cout << "testPowerLoss" << endl;
+	HostFds& fds     = HostFds::getInstance();
+	HostFlash& flash = HostFlash::getInstance();
+	fds_record_desc_t descs[NUM_KEYS + 1];
+
+	// Count the flash operations of the workload.
+	prepare(descs);
+	cs_host_flash_stats_t before = flash.getStats();
+	runWorkload(descs);
+	uint32_t numOperations = flash.getStats().wordsWritten - before.wordsWritten + flash.getStats().pageErases
+							 - before.pageErases;
+	assert(fds.getStats().gcRuns == 1);
+	assert(readValues(1) == vector<uint32_t>{160});
+	assert(readValues(2) == vector<uint32_t>{201});
+	assert(readValues(3) == vector<uint32_t>{301});
+
+	uint32_t recovered = 0;
+	for (uint32_t powerLossAt = 0; powerLossAt <= numOperations; ++powerLossAt) {
+		prepare(descs);
+		flash.setPowerLossAfter(powerLossAt);
+		runWorkload(descs);
+		assert(flash.isPowerLost() == (powerLossAt < numOperations));
+
+		// Reboot.
+		flash.powerOn();
+		fds.reboot();
+		bool initialized = initFds();
+		assert(initialized);
+		fds_stat_t stat;
+		ret_code_t nrfCode = fds_stat(&stat);
+		assert(nrfCode == NRF_SUCCESS);
+		assert(stat.pages_available == FDS_VIRTUAL_PAGES - 1);
+
+		// Every record holds either the old or the new value, and there is always one.
+		for (uint16_t key = 1; key <= NUM_KEYS; ++key) {
+			vector<uint32_t> values = readValues(key);
+			assert(!values.empty());
+			for (auto value : values) {
+				switch (key) {
+					case 1: assert(value == 160); break;
+					case 2: assert(value == 200 || value == 201); break;
+					case 3: assert(value == 300 || value == 301); break;
+					default: assert(value == key * 100u); break;
+				}
+			}
+		}
+
+		// Flash is still usable.
+		fds_record_desc_t desc;
+		nrfCode = writeValue(&desc, NUM_KEYS + 1, 7, false);
+		assert(nrfCode == NRF_SUCCESS);
+		nrfCode = fds_gc();
+		assert(nrfCode == NRF_SUCCESS);
+		fds.process();
+		assert(readValues(NUM_KEYS + 1) == vector<uint32_t>{7});
+		assert(readValues(1) == vector<uint32_t>{160});
+		recovered++;
+	}
+	cout << "  recovered from power loss at each of " << recovered << " flash operations" << endl;
+	fds.close();
+}
+
+vector<nrf_fstorage_evt_t> fstorageEvents;
+
+void recordFstorageEvent(nrf_fstorage_evt_t* p_evt) {
+	fstorageEvents.push_back(*p_evt);
+}
+
+const uint32_t FSTORAGE_START = 100 * 4096;
+
+NRF_FSTORAGE_DEF(nrf_fstorage_t testStorage) =
+{
+	.evt_handler    = recordFstorageEvent,
+	.start_addr     = FSTORAGE_START,
+	.end_addr       = FSTORAGE_START + 4 * 4096 - 1,
+};
+
+void testFstorage() {
+	cout << "testFstorage" << endl;
+	HostFlash& flash = HostFlash::getInstance();
+	HostFstorage& fstorage = HostFstorage::getInstance();
+	ret_code_t nrfCode = nrf_fstorage_init(&testStorage, &nrf_fstorage_sd, nullptr);
+	assert(nrfCode == NRF_ERROR_INVALID_STATE);
+	bool opened = flash.open();
+	assert(opened);
+	nrfCode = nrf_fstorage_init(&testStorage, &nrf_fstorage_sd, nullptr);
+	assert(nrfCode == NRF_SUCCESS);
+	assert(testStorage.p_flash_info->erase_unit == 4096);
+
+	uint32_t data[4] = {1, 2, 3, 4};
+	nrfCode = nrf_fstorage_write(&testStorage, FSTORAGE_START, data, sizeof(data), nullptr);
+	assert(nrfCode == NRF_SUCCESS);
+	assert(nrf_fstorage_is_busy(&testStorage));
+	uint32_t numProcessed = fstorage.process();
+	assert(numProcessed == 1);
+	assert(!nrf_fstorage_is_busy(&testStorage));
+	assert(fstorageEvents.size() == 1);
+	assert(fstorageEvents[0].id == NRF_FSTORAGE_EVT_WRITE_RESULT && fstorageEvents[0].result == NRF_SUCCESS);
+	assert(fstorageEvents[0].addr == FSTORAGE_START && fstorageEvents[0].len == sizeof(data));
+
+	uint32_t readData[4];
+	nrfCode = nrf_fstorage_read(&testStorage, FSTORAGE_START, readData, sizeof(readData));
+	assert(nrfCode == NRF_SUCCESS);
+	assert(memcmp(data, readData, sizeof(data)) == 0);
+
+	// Outside of the area, unaligned, or too many at once.
+	nrfCode = nrf_fstorage_write(&testStorage, FSTORAGE_START - 4, data, 4, nullptr);
+	assert(nrfCode == NRF_ERROR_INVALID_ADDR);
+	nrfCode = nrf_fstorage_write(&testStorage, FSTORAGE_START + 4 * 4096 - 4, data, 8, nullptr);
+	assert(nrfCode == NRF_ERROR_INVALID_ADDR);
+	nrfCode = nrf_fstorage_write(&testStorage, FSTORAGE_START + 2, data, 4, nullptr);
+	assert(nrfCode == NRF_ERROR_INVALID_ADDR);
+	nrfCode = nrf_fstorage_write(&testStorage, FSTORAGE_START, data, 3, nullptr);
+	assert(nrfCode == NRF_ERROR_INVALID_LENGTH);
+	nrfCode = nrf_fstorage_erase(&testStorage, FSTORAGE_START + 4, 1, nullptr);
+	assert(nrfCode == NRF_ERROR_INVALID_ADDR);
+	nrfCode = nrf_fstorage_erase(&testStorage, FSTORAGE_START, 5, nullptr);
+	assert(nrfCode == NRF_ERROR_INVALID_ADDR);
+	for (uint16_t i = 0; i < NRF_FSTORAGE_SD_QUEUE_SIZE; ++i) {
+		nrfCode = nrf_fstorage_write(&testStorage, FSTORAGE_START + 16 + i * 4, data, 4, nullptr);
+		assert(nrfCode == NRF_SUCCESS);
+	}
+	nrfCode = nrf_fstorage_write(&testStorage, FSTORAGE_START, data, 4, nullptr);
+	assert(nrfCode == NRF_ERROR_NO_MEM);
+	fstorage.process();
+
+	// Erase.
+	fstorageEvents.clear();
+	nrfCode = nrf_fstorage_erase(&testStorage, FSTORAGE_START, 2, nullptr);
+	assert(nrfCode == NRF_SUCCESS);
+	fstorage.process();
+	assert(fstorageEvents.size() == 1 && fstorageEvents[0].id == NRF_FSTORAGE_EVT_ERASE_RESULT);
+	nrfCode = nrf_fstorage_read(&testStorage, FSTORAGE_START, readData, sizeof(readData));
+	assert(nrfCode == NRF_SUCCESS);
+	assert(readData[0] == 0xFFFFFFFF && readData[3] == 0xFFFFFFFF);
+	assert(flash.getEraseCounts()[100] == 1 && flash.getEraseCounts()[101] == 1 && flash.getEraseCounts()[102] == 0);
+
+	// No event when power is lost during the operation.
+	fstorageEvents.clear();
+	flash.setPowerLossAfter(2);
+	nrfCode = nrf_fstorage_write(&testStorage, FSTORAGE_START, data, sizeof(data), nullptr);
+	assert(nrfCode == NRF_SUCCESS);
+	nrfCode = nrf_fstorage_write(&testStorage, FSTORAGE_START + 16, data, sizeof(data), nullptr);
+	assert(nrfCode == NRF_SUCCESS);
+	numProcessed = fstorage.process();
+	assert(numProcessed == 0);
+	assert(fstorageEvents.empty());
+	assert(!nrf_fstorage_is_busy(&testStorage));
+	flash.powerOn();
+	nrfCode = nrf_fstorage_read(&testStorage, FSTORAGE_START, readData, sizeof(readData));
+	assert(nrfCode == NRF_SUCCESS);
+	assert(readData[1] == 2 && readData[2] == 0xFFFFFFFF);
+	flash.close();
+}
+
+/**
+ * Measures the flash time of FDS operations, while writing records like State does: a few records often, most
+ * records rarely. Garbage collection is started when flash is full, like Storage does.
+ */
+void measureGcPauses() {
+	cout << "measureGcPauses" << endl;
+	HostFds& fds     = HostFds::getInstance();
+	HostFlash& flash = HostFlash::getInstance();
+	bool opened = fds.open();
+	assert(opened);
+	bool initialized = initFds();
+	assert(initialized);
+
+	const uint16_t numKeys   = 40;
+	const uint32_t numWrites = 20000;
+	mt19937 rng(1234);
+	vector<fds_record_desc_t> descs(numKeys + 1);
+	for (uint16_t key = 1; key <= numKeys; ++key) {
+		ret_code_t nrfCode = writeValue(&descs[key], key, 0, false);
+		assert(nrfCode == NRF_SUCCESS);
+	}
+	fds.resetStats();
+	flash.resetStats();
+
+	uint32_t gcStarted = 0;
+	for (uint32_t i = 0; i < numWrites; ++i) {
+		uint16_t key = (rng() % 10 < 8) ? 1 + rng() % 4 : 1 + rng() % numKeys;
+		ret_code_t retCode = writeValue(&descs[key], key, i, true);
+		if (retCode == FDS_ERR_NO_SPACE_IN_FLASH) {
+			retCode = fds_gc();
+			assert(retCode == NRF_SUCCESS);
+			fds.process();
+			gcStarted++;
+			retCode = writeValue(&descs[key], key, i, true);
+		}
+		assert(retCode == NRF_SUCCESS);
+	}
+	const cs_host_fds_stats_t& stats = fds.getStats();
+	assert(stats.gcRuns == gcStarted && gcStarted > 0);
+	assert(stats.maxOpTimeUs >= flash.getConfig().erasePageUs);
+	assert(stats.busyTimeUs == flash.getStats().busyTimeUs);
+
+	const vector<uint32_t>& eraseCounts = flash.getEraseCounts();
+	cout << "  writes=" << numWrites << " gcRuns=" << stats.gcRuns << " pageErases=" << stats.pageErases
+		 << " recordsMoved=" << stats.recordsMoved << endl;
+	cout << fixed << setprecision(1);
+	cout << "  flash time: total=" << stats.busyTimeUs / 1000.0 << "ms gc=" << stats.gcTimeUs / 1000.0
+		 << "ms avgWrite=" << (stats.busyTimeUs - stats.gcTimeUs) / 1000.0 / (numWrites + gcStarted) << "ms"
+		 << " avgGc=" << stats.gcTimeUs / 1000.0 / stats.gcRuns << "ms maxOp=" << stats.maxOpTimeUs / 1000.0 << "ms"
+		 << endl;
+	cout << "  page erases: min=" << *min_element(eraseCounts.begin(), eraseCounts.end())
+		 << " max=" << *max_element(eraseCounts.begin(), eraseCounts.end()) << endl;
+	fds.close();
+}
+
+int main() {
+	fds_register(recordFdsEvent);
+	char path[] = "/tmp/test_HostFlash_XXXXXX";
+	int fd      = mkstemp(path);
+	assert(fd >= 0);
+	close(fd);
+	testHostFlash(path);
+	testPowerLoss();
+	testFstorage();
+	measureGcPauses();
+	cout << "Done" << endl;
+	return 0;
+}
@@ -0,0 +1,166 @@
+#define SERIAL_VERBOSITY SERIAL_NONE
+
+/**
+ * Runs the firmware State, Storage, and MicroappStorage on the host flash.
+ *
+ * Like on the chip, the flash events of FDS and fstorage are put on the app scheduler by the handlers of the firmware,
+ * and handled in app_sched_execute().
+ */
+
+#include <cfg/cs_AutoConfig.h>
+#include <drivers/cs_Storage.h>
+#include <events/cs_EventDispatcher.h>
+#include <microapp/cs_MicroappStorage.h>
+#include <storage/cs_State.h>
+
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Records the events that are dispatched by the firmware.
+ */
+class TestListener : public EventListener {
+public:
+	vector<CS_TYPE> types;
+	vector<cs_ret_code_t> results;
+
+	void handleEvent(event_t& event) override {
+		types.push_back(event.type);
+		if (event.size == sizeof(cs_ret_code_t)) {
+			results.push_back(*reinterpret_cast<cs_ret_code_t*>(event.data));
+		}
+		else {
+			results.push_back(ERR_SUCCESS);
+		}
+	}
+
+	/**
+	 * Returns the result of the last event of the given type, or ERR_NOT_FOUND.
+	 */
+	cs_ret_code_t getResult(CS_TYPE type) {
+		for (size_t i = types.size(); i > 0; --i) {
+			if (types[i - 1] == type) {
+				return results[i - 1];
+			}
+		}
+		return ERR_NOT_FOUND;
+	}
+};
+
+TestListener listener;
+
+/**
+ * Handle the scheduled events, and execute the flash operations, until there is nothing left to do.
+ */
+void process() {
+	do {
+		app_sched_execute();
+	} while (HostFds::getInstance().process() + HostFstorage::getInstance().process() > 0);
+}
+
+void testStorage() {
+	cout << "testStorage" << endl;
+	Storage& storage = Storage::getInstance();
+	cs_ret_code_t retCode = storage.init();
+	assert(retCode == ERR_SUCCESS);
+	assert(!storage.isInitialized());
+	process();
+	assert(storage.isInitialized());
+	assert(listener.getResult(CS_TYPE::EVT_STORAGE_INITIALIZED) == ERR_SUCCESS);
+}
+
+void testState() {
+	cout << "testState" << endl;
+	State& state      = State::getInstance();
+	boards_config_t board;
+	memset(&board, 0, sizeof(board));
+	state.init(&board);
+	assert(state.isInitialized());
+
+	// Not written to flash before startWritesToFlash(), but queued.
+	TYPIFY(CONFIG_BOOT_DELAY) bootDelay = 1234;
+	cs_ret_code_t retCode = state.set(CS_TYPE::CONFIG_BOOT_DELAY, &bootDelay, sizeof(bootDelay));
+	assert(retCode == ERR_SUCCESS);
+	process();
+	assert(listener.getResult(CS_TYPE::EVT_STORAGE_WRITE_DONE) == ERR_NOT_FOUND);
+
+	state.startWritesToFlash();
+	bootDelay = 4321;
+	retCode = state.set(CS_TYPE::CONFIG_BOOT_DELAY, &bootDelay, sizeof(bootDelay));
+	assert(retCode == ERR_SUCCESS);
+	process();
+	assert(listener.getResult(CS_TYPE::EVT_STORAGE_WRITE_DONE) == ERR_SUCCESS);
+
+	// Read from flash by Storage, and from RAM by State.
+	TYPIFY(CONFIG_BOOT_DELAY) readBootDelay = 0;
+	cs_state_data_t data(CS_TYPE::CONFIG_BOOT_DELAY, reinterpret_cast<uint8_t*>(&readBootDelay), sizeof(readBootDelay));
+	retCode = Storage::getInstance().read(data);
+	assert(retCode == ERR_SUCCESS);
+	assert(readBootDelay == 4321);
+	readBootDelay = 0;
+	retCode = state.get(CS_TYPE::CONFIG_BOOT_DELAY, &readBootDelay, sizeof(readBootDelay));
+	assert(retCode == ERR_SUCCESS);
+	assert(readBootDelay == 4321);
+}
+
+void testMicroappStorage() {
+	cout << "testMicroappStorage" << endl;
+	MicroappStorage& microappStorage = MicroappStorage::getInstance();
+	cs_ret_code_t retCode = microappStorage.init();
+	assert(retCode == ERR_SUCCESS);
+	const uint8_t* flash = HostFlash::getInstance().getPointer(g_FLASH_MICROAPP_BASE, MICROAPP_MAX_SIZE);
+	assert(flash != nullptr);
+
+	// Dirty the flash, so that it has to be erased first.
+	uint32_t word = 0;
+	bool written = HostFlash::getInstance().write(g_FLASH_MICROAPP_BASE, &word, 1);
+	assert(written);
+	assert(!microappStorage.isErased(0));
+	uint8_t chunk[100];
+	for (uint16_t i = 0; i < sizeof(chunk); ++i) {
+		chunk[i] = i;
+	}
+	retCode = microappStorage.writeChunk(0, 0, chunk, sizeof(chunk));
+	assert(retCode == ERR_WRITE_DISABLED);
+
+	retCode = microappStorage.erase(0);
+	assert(retCode == ERR_WAIT_FOR_SUCCESS);
+	process();
+	assert(listener.getResult(CS_TYPE::EVT_MICROAPP_ERASE_RESULT) == ERR_SUCCESS);
+	assert(microappStorage.isErased(0));
+
+	// Written in parts of MICROAPP_STORAGE_BUF_SIZE, each after the event of the previous part.
+	retCode = microappStorage.writeChunk(0, 0, chunk, sizeof(chunk));
+	assert(retCode == ERR_WAIT_FOR_SUCCESS);
+	uint32_t numProcessed = HostFstorage::getInstance().process();
+	assert(numProcessed == 1);
+	assert(memcmp(flash, chunk, MICROAPP_STORAGE_BUF_SIZE) == 0);
+	assert(flash[MICROAPP_STORAGE_BUF_SIZE] == 0xFF);
+	process();
+	assert(listener.getResult(CS_TYPE::EVT_MICROAPP_UPLOAD_RESULT) == ERR_SUCCESS);
+	assert(memcmp(flash, chunk, sizeof(chunk)) == 0);
+	assert(flash[sizeof(chunk)] == 0xFF);
+
+	microapp_binary_header_t header;
+	microappStorage.getAppHeader(0, header);
+	assert(memcmp(&header, chunk, sizeof(header)) == 0);
+}
+
+int main() {
+	// The whole flash, with the FDS pages at the end, like on the chip.
+	bool opened = HostFlash::getInstance().open();
+	assert(opened);
+	EventDispatcher::getInstance().addListener(&listener);
+
+	testStorage();
+	testState();
+	testMicroappStorage();
+
+	HostFlash::getInstance().close();
+	cout << "Done" << endl;
+	return 0;
+}
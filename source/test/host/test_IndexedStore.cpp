@@ -0,0 +1,229 @@
+#define SERIAL_VERBOSITY SERIAL_NONE
+
+/**
+ * Tests the indexed store against a linear search, with random operations.
+ *
+ * Then compares the time of lookups and evictions with the Store, at the sizes of TrackedDevices and PresenceHandler
+ * (20), AssetStore (50), and a larger store (256).
+ */
+
+#include <util/cs_IndexedStore.h>
+#include <util/cs_Store.h>
+
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Like asset_id_t.
+ */
+struct __attribute__((__packed__)) test_id_t {
+	uint8_t data[3];
+
+	bool operator==(const test_id_t& other) const {
+		return memcmp(data, other.data, sizeof(data)) == 0;
+	}
+};
+
+test_id_t makeId(uint32_t value) {
+	test_id_t id;
+	id.data[0] = value;
+	id.data[1] = value >> 8;
+	id.data[2] = value >> 16;
+	return id;
+}
+
+/**
+ * Like asset_record_t.
+ */
+struct __attribute__((__packed__)) test_record_t {
+	test_id_t recordId;
+	uint8_t lastReceivedCounter = 0xFF;
+	uint32_t payload            = 0;
+
+	bool isValid() {
+		return lastReceivedCounter != 0xFF;
+	}
+
+	void invalidate() {
+		lastReceivedCounter = 0xFF;
+	}
+
+	test_id_t id() {
+		return recordId;
+	}
+};
+
+template <class StoreType>
+test_record_t* linearGet(StoreType& store, const test_id_t& id) {
+	return store.get([&](auto& rec) { return rec.isValid() && rec.id() == id; });
+}
+
+/**
+ * Random operations on an indexed store, checking each lookup against a linear search.
+ *
+ * Each record gets the time it was last touched as payload, so the least recent record can be checked.
+ */
+template <unsigned int Size>
+void testRandomOperations(uint32_t numIds) {
+	cout << "Random operations, size=" << Size << " numIds=" << numIds << endl;
+	IndexedStore<test_record_t, Size> store;
+	mt19937 rng(Size + numIds);
+	uint32_t time = 0;
+	for (uint32_t i = 0; i < 200000; ++i) {
+		test_id_t id     = makeId(rng() % numIds);
+		test_record_t* found = store.get(id);
+		assert(found == linearGet(store, id));
+
+		switch (rng() % 16) {
+			case 0: {
+				if (found != nullptr) {
+					store.remove(*found);
+					assert(store.get(id) == nullptr);
+				}
+				break;
+			}
+			case 1: {
+				// Invalidated without the store knowing: should only be found by the linear search.
+				if (found != nullptr) {
+					found->invalidate();
+				}
+				break;
+			}
+			case 2: {
+				if (rng() % 1000 == 0) {
+					store.clear();
+					assert(store.size() == 0);
+				}
+				break;
+			}
+			default: {
+				test_record_t* rec = store.getOrAdd(id);
+				if (rec == nullptr) {
+					// Records that were invalidated without the store knowing, are only reused when least recent.
+					assert(store.size() == Size);
+					rec = store.getLeastRecent();
+					assert(rec->isValid());
+					// Only records that were touched or added since are more recent.
+					for (auto& other : store) {
+						assert(other.payload >= rec->payload);
+					}
+					store.replace(*rec, id);
+				}
+				assert(found == nullptr || found == rec);
+				if (!rec->isValid()) {
+					rec->recordId            = id;
+					rec->lastReceivedCounter = 0;
+				}
+				rec->payload = ++time;
+				store.touch(*rec);
+				assert(store.get(id) == rec);
+			}
+		}
+		assert(store.count() <= Size);
+	}
+
+	// Every id should be found at most once.
+	for (uint32_t value = 0; value < numIds; ++value) {
+		test_id_t id = makeId(value);
+		assert(store.countIf([&](auto& rec) { return rec.isValid() && rec.id() == id; }) <= 1);
+	}
+}
+
+/**
+ * Fill both stores with the same records.
+ */
+template <unsigned int Size>
+void fill(Store<test_record_t, Size>& store, IndexedStore<test_record_t, Size>& indexedStore) {
+	for (uint32_t i = 0; i < Size; ++i) {
+		test_id_t id = makeId(i * 7919);
+		for (test_record_t* rec : {store.getOrAdd(id), indexedStore.getOrAdd(id)}) {
+			rec->recordId            = id;
+			rec->lastReceivedCounter = i % 200;
+		}
+	}
+}
+
+template <class F>
+double measureNs(uint32_t numOperations, F operation) {
+	auto start = chrono::steady_clock::now();
+	for (uint32_t i = 0; i < numOperations; ++i) {
+		operation(i);
+	}
+	return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / numOperations;
+}
+
+/**
+ * Lookups of existing and missing ids, and evictions when adding new ids to a full store.
+ */
+template <unsigned int Size>
+void benchmark() {
+	const uint32_t numOperations = 1000000;
+	auto store                   = new Store<test_record_t, Size>();
+	auto indexedStore            = new IndexedStore<test_record_t, Size>();
+	fill(*store, *indexedStore);
+
+	uint32_t numFound = 0;
+	auto getHit       = [&](auto& s) { return [&](uint32_t i) { numFound += s.get(makeId((i % Size) * 7919)) != nullptr; }; };
+	auto getMiss      = [&](auto& s) { return [&](uint32_t i) { numFound += s.get(makeId(i * 7919 + 1)) != nullptr; }; };
+	double storeHitNs        = measureNs(numOperations, getHit(*store));
+	double indexedHitNs      = measureNs(numOperations, getHit(*indexedStore));
+	double storeMissNs       = measureNs(numOperations, getMiss(*store));
+	double indexedMissNs     = measureNs(numOperations, getMiss(*indexedStore));
+	assert(numFound == 2 * numOperations);
+
+	// Evict the record with the highest counter, like AssetStore did.
+	double storeEvictNs = measureNs(numOperations / 10, [&](uint32_t i) {
+		test_id_t id       = makeId(Size * 7919 + i);
+		test_record_t* rec = store->getOrAdd(id);
+		if (rec == nullptr) {
+			rec = store->begin();
+			for (auto& other : *store) {
+				if (other.lastReceivedCounter > rec->lastReceivedCounter) {
+					rec = &other;
+				}
+			}
+		}
+		rec->recordId            = id;
+		rec->lastReceivedCounter = 0;
+	});
+	double indexedEvictNs = measureNs(numOperations / 10, [&](uint32_t i) {
+		test_id_t id       = makeId(Size * 7919 + i);
+		test_record_t* rec = indexedStore->getOrAdd(id);
+		if (rec == nullptr) {
+			rec = indexedStore->replace(*indexedStore->getLeastRecent(), id);
+		}
+		rec->recordId            = id;
+		rec->lastReceivedCounter = 0;
+	});
+
+	cout << setw(5) << Size << fixed << setprecision(1) << setw(10) << storeHitNs << setw(10) << indexedHitNs << setw(10)
+		 << storeMissNs << setw(10) << indexedMissNs << setw(10) << storeEvictNs << setw(10) << indexedEvictNs << setw(12)
+		 << sizeof(*store) << setw(12) << sizeof(*indexedStore) << endl;
+	delete store;
+	delete indexedStore;
+}
+
+int main() {
+	testRandomOperations<20>(15);
+	testRandomOperations<20>(60);
+	testRandomOperations<50>(200);
+	testRandomOperations<256>(300);
+	testRandomOperations<256>(2000);
+
+	cout << "Time per operation in ns, store (S) vs indexed store (I):" << endl;
+	cout << setw(5) << "size" << setw(10) << "S hit" << setw(10) << "I hit" << setw(10) << "S miss" << setw(10)
+		 << "I miss" << setw(10) << "S evict" << setw(10) << "I evict" << setw(12) << "S bytes" << setw(12) << "I bytes"
+		 << endl;
+	benchmark<20>();
+	benchmark<50>();
+	benchmark<256>();
+	cout << "Done" << endl;
+	return 0;
+}
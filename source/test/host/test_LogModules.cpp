@@ -0,0 +1,236 @@
+#define SERIAL_VERBOSITY SERIAL_VERY_VERBOSE
+
+/**
+ * Tests the module logs: logs above the compile time level of a module are removed, including the evaluation of
+ * their arguments, and logs above the runtime level are skipped.
+ *
+ * Also compares the cost of the logs in a scan hot path, like AssetFiltering::handleScannedDevice(), when the logs are
+ * sent, disabled at runtime, or not compiled in.
+ */
+
+// Compile in all logs of the scanner module, and keep the default for asset filtering.
+#define CS_LOG_LEVEL_SCANNER SERIAL_VERY_VERBOSE
+
+#include <logging/cs_LogModules.h>
+#include <logging/cs_LogRing.h>
+#include <protocol/cs_UartMsgTypes.h>
+
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+
+/**
+ * Writes the logs to a log ring, like cs_Logger does with binary logging.
+ */
+LogRing<4096> logRing;
+uint32_t numLogs = 0;
+
+template <typename T>
+void logArg(const T& val) {
+	uart_msg_log_arg_header_t argHeader;
+	argHeader.argSize = sizeof(T);
+	logRing.write(reinterpret_cast<uint8_t*>(&argHeader), sizeof(argHeader));
+	logRing.write(reinterpret_cast<const uint8_t*>(&val), sizeof(T));
+}
+
+inline size_t argsSize() {
+	return 0;
+}
+
+template <typename T, class... Args>
+size_t argsSize(const T& val, const Args&... args) {
+	return sizeof(uart_msg_log_arg_header_t) + sizeof(val) + argsSize(args...);
+}
+
+inline void logArgList() {}
+
+template <typename T, class... Args>
+void logArgList(const T& val, const Args&... args) {
+	logArg(val);
+	logArgList(args...);
+}
+
+template <class... Args>
+void logArgs(uint32_t lineNumber, uint8_t logLevel, const Args&... args) {
+	uart_msg_log_header_t header;
+	header.header.fileNameHash  = 0;
+	header.header.lineNumber    = lineNumber;
+	header.header.logLevel      = logLevel;
+	header.header.flags.newLine = true;
+	header.numArgs              = sizeof...(args);
+	size_t totalSize            = sizeof(header) + argsSize(args...);
+	logRing.start(0, totalSize);
+	logRing.write(reinterpret_cast<uint8_t*>(&header), sizeof(header));
+	logArgList(args...);
+	logRing.end();
+	numLogs++;
+}
+
+void logArray(uint32_t lineNumber, uint8_t logLevel, const uint8_t* data, uint16_t size) {
+	uart_msg_log_array_header_t header;
+	header.header.fileNameHash  = 0;
+	header.header.lineNumber    = lineNumber;
+	header.header.logLevel      = logLevel;
+	header.header.flags.newLine = true;
+	header.elementType          = ELEMENT_TYPE_UNSIGNED_INTEGER;
+	header.elementSize          = 1;
+	logRing.start(1, sizeof(header) + size);
+	logRing.write(reinterpret_cast<uint8_t*>(&header), sizeof(header));
+	logRing.write(data, size);
+	logRing.end();
+	numLogs++;
+}
+
+#define _log(level, addNewLine, fmt, ...) logArgs(__LINE__, level, ##__VA_ARGS__)
+#define _logArray(level, addNewLine, pointer, size) logArray(__LINE__, level, pointer, size)
+
+uint32_t numEvaluated = 0;
+
+uint32_t evaluate(uint32_t val) {
+	numEvaluated++;
+	return val;
+}
+
+void testCompiled() {
+	cout << "Check that logs above the compile time level are removed, including their arguments." << endl;
+	static_assert(logModuleCompiled(LOG_MODULE_MESH, SERIAL_WARN));
+	static_assert(!logModuleCompiled(LOG_MODULE_MESH, SERIAL_INFO));
+	static_assert(logModuleCompiled(LOG_MODULE_SCANNER, SERIAL_VERY_VERBOSE));
+
+	numLogs      = 0;
+	numEvaluated = 0;
+	LOGMw(LOG_MODULE_MESH, "warn %u", evaluate(1));
+	LOGMi(LOG_MODULE_MESH, "info %u", evaluate(2));
+	LOGMv(LOG_MODULE_MESH, "verbose %u", evaluate(3));
+	uint8_t data[4] = {1, 2, 3, 4};
+	_logArrayModule(LOG_MODULE_MESH_MODEL, SERIAL_VERBOSE, true, data, evaluate(sizeof(data)));
+	assert(numLogs == 1);
+	assert(numEvaluated == 1);
+}
+
+void testRuntime() {
+	cout << "Check that logs above the runtime level are skipped." << endl;
+	numLogs      = 0;
+	numEvaluated = 0;
+	LOGMi(LOG_MODULE_ASSET_FILTERING, "info %u", evaluate(1));
+	assert(numLogs == 1);
+
+	bool levelSet = setLogModuleLevel(LOG_MODULE_ASSET_FILTERING, SERIAL_WARN);
+	assert(levelSet);
+	LOGMi(LOG_MODULE_ASSET_FILTERING, "info %u", evaluate(2));
+	LOGMw(LOG_MODULE_ASSET_FILTERING, "warn %u", evaluate(3));
+	assert(numLogs == 2);
+	assert(numEvaluated == 2);
+
+	// The runtime level is capped at the compile time level.
+	levelSet = setLogModuleLevel(LOG_MODULE_ALL, SERIAL_VERY_VERBOSE);
+	assert(levelSet);
+	for (uint8_t i = 0; i < LOG_MODULE_COUNT; ++i) {
+		assert(getLogModuleLevels()[i] == LOG_MODULE_COMPILED_LEVELS[i]);
+	}
+	levelSet = setLogModuleLevel(LOG_MODULE_COUNT, SERIAL_DEBUG);
+	assert(!levelSet);
+}
+
+/**
+ * Stands in for the filter evaluation that follows the logs.
+ */
+__attribute__((noinline)) uint32_t evaluateFilters(const scanned_device_t& device) {
+	uint32_t hash = 5381;
+	for (uint8_t i = 0; i < device.dataSize; ++i) {
+		hash = hash * 33 + device.data[i];
+	}
+	return hash;
+}
+
+/**
+ * Same logs as AssetFiltering::handleScannedDevice(), with a module of which the verbose logs are compiled in.
+ */
+__attribute__((noinline)) uint32_t scanHotPathCompiledIn(const scanned_device_t& asset) {
+	LOGMv(LOG_MODULE_SCANNER, "Scanned device mac=%02X:%02X:%02X:%02X:%02X:%02X",
+			asset.address[5],
+			asset.address[4],
+			asset.address[3],
+			asset.address[2],
+			asset.address[1],
+			asset.address[0]);
+	_logArrayModule(LOG_MODULE_SCANNER, SERIAL_VERBOSE, true, asset.data, asset.dataSize);
+	return evaluateFilters(asset);
+}
+
+/**
+ * Same logs as AssetFiltering::handleScannedDevice(), with a module of which the verbose logs are not compiled in.
+ */
+__attribute__((noinline)) uint32_t scanHotPathCompiledOut(const scanned_device_t& asset) {
+	LOGMv(LOG_MODULE_ASSET_FILTERING, "Scanned device mac=%02X:%02X:%02X:%02X:%02X:%02X",
+			asset.address[5],
+			asset.address[4],
+			asset.address[3],
+			asset.address[2],
+			asset.address[1],
+			asset.address[0]);
+	_logArrayModule(LOG_MODULE_ASSET_FILTERING, SERIAL_VERBOSE, true, asset.data, asset.dataSize);
+	return evaluateFilters(asset);
+}
+
+template <class Function>
+double benchmarkScans(Function scanHotPath, uint32_t numScans) {
+	uint8_t data[31];
+	scanned_device_t device = {};
+	device.data     = data;
+	device.dataSize = sizeof(data);
+	uint32_t result = 0;
+	auto start      = chrono::steady_clock::now();
+	for (uint32_t i = 0; i < numScans; ++i) {
+		for (auto& val : data) {
+			val = i;
+		}
+		device.address[0] = i;
+		result += scanHotPath(device);
+		// Sent by the UART in the background.
+		while (logRing.hasUnsent()) {
+			logRing.pop();
+		}
+	}
+	auto end = chrono::steady_clock::now();
+	assert(result != 1);
+	return chrono::duration<double>(end - start).count() / numScans * 1e9;
+}
+
+void benchmark() {
+	cout << endl << "Cost per scanned device" << endl;
+	const uint32_t numScans = 2000000;
+	logRing.clear();
+
+	setLogModuleLevel(LOG_MODULE_SCANNER, SERIAL_VERBOSE);
+	numLogs          = 0;
+	double logged    = benchmarkScans(scanHotPathCompiledIn, numScans);
+	assert(numLogs == 2 * numScans);
+
+	setLogModuleLevel(LOG_MODULE_SCANNER, SERIAL_INFO);
+	numLogs          = 0;
+	double skipped   = benchmarkScans(scanHotPathCompiledIn, numScans);
+	assert(numLogs == 0);
+
+	double removed   = benchmarkScans(scanHotPathCompiledOut, numScans);
+	assert(numLogs == 0);
+
+	cout << "  logged:                 " << fixed << setprecision(1) << logged << " ns" << endl;
+	cout << "  disabled at runtime:    " << skipped << " ns" << endl;
+	cout << "  not compiled in:        " << removed << " ns" << endl;
+}
+
+int main() {
+	cout << "Test log modules" << endl;
+
+	testCompiled();
+	testRuntime();
+	benchmark();
+
+	cout << "Done" << endl;
+	return 0;
+}
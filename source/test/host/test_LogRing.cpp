@@ -0,0 +1,362 @@
+#define SERIAL_VERBOSITY SERIAL_DEBUG
+
+/**
+ * Tests the log ring: records, overwriting, and recovery after a reset.
+ * Also compares the cost of a log call with the log ring, to writing the log as UART frame immediately.
+ *
+ * Optionally writes a dump of a log ring with some logs to the given file, to test scripts/log-ring-decoder.py.
+ */
+
+#include <logging/cs_LogRing.h>
+#include <protocol/cs_UartProtocol.h>
+#include <structs/buffer/cs_SerialTxRing.h>
+#include <uart/cs_UartFrameWriter.h>
+
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+const uint16_t RING_SIZE = 2048;
+
+typedef LogRing<RING_SIZE> Ring;
+
+/**
+ * Same as the types in cs_Logger.cpp.
+ */
+const uint8_t LOG_RING_RECORD_TYPE_LOG       = 0;
+const uint8_t LOG_RING_RECORD_TYPE_LOG_ARRAY = 1;
+
+/**
+ * Same as the log levels in cs_Serial.h, which can't be included on host.
+ */
+const uint8_t LOG_LEVEL_INFO  = 6;
+const uint8_t LOG_LEVEL_DEBUG = 7;
+
+vector<uint8_t> createRecord(uint32_t index, uint16_t size) {
+	vector<uint8_t> record(size);
+	for (uint16_t i = 0; i < size; ++i) {
+		record[i] = index + i;
+	}
+	return record;
+}
+
+void writeRecord(Ring& ring, uint8_t type, const vector<uint8_t>& record) {
+	// Write in parts, like the logger does.
+	ring.start(type, record.size());
+	uint16_t half = record.size() / 2;
+	ring.write(record.data(), half);
+	ring.write(record.data() + half, record.size() - half);
+	ring.end();
+}
+
+vector<vector<uint8_t>> readAll(Ring& ring) {
+	vector<vector<uint8_t>> records;
+	uint8_t type;
+	const uint8_t* data;
+	uint16_t size;
+	while (ring.peek(type, data, size)) {
+		records.emplace_back(data, data + size);
+		ring.pop();
+	}
+	return records;
+}
+
+/**
+ * Simulates a reset: the memory is kept, but the object is new.
+ */
+Ring* reset(const Ring& ring) {
+	Ring* newRing = reinterpret_cast<Ring*>(new uint8_t[sizeof(Ring)]);
+	memcpy(reinterpret_cast<void*>(newRing), &ring, sizeof(Ring));
+	return newRing;
+}
+
+void testRecords() {
+	cout << "Check that records are read in order, and the newest are kept when full." << endl;
+	srand(1);
+	Ring ring;
+	ring.clear();
+	assert(!ring.hasUnsent());
+
+	// Write and read in turns, with wrap around.
+	vector<vector<uint8_t>> written;
+	for (uint32_t i = 0; i < 10000; ++i) {
+		auto record = createRecord(i, rand() % 100);
+		writeRecord(ring, LOG_RING_RECORD_TYPE_LOG, record);
+		written.push_back(record);
+		if (i % 7 == 0) {
+			auto read = readAll(ring);
+			assert(read == written);
+			written.clear();
+		}
+	}
+	assert(ring.getLostRecords() == 0);
+
+	// Records that are not sent in time, are overwritten.
+	readAll(ring);
+	written.clear();
+	for (uint32_t i = 0; i < 1000; ++i) {
+		auto record = createRecord(i, rand() % 100);
+		writeRecord(ring, LOG_RING_RECORD_TYPE_LOG, record);
+		written.push_back(record);
+	}
+	auto read = readAll(ring);
+	assert(read.size() + ring.getLostRecords() == written.size());
+	assert(read == vector<vector<uint8_t>>(written.end() - read.size(), written.end()));
+
+	// Records that are too large are dropped.
+	uint32_t lost = ring.getLostRecords();
+	bool started = ring.start(LOG_RING_RECORD_TYPE_LOG, RING_SIZE);
+	assert(!started);
+	ring.end();
+	assert(ring.getLostRecords() == lost + 1);
+	assert(!ring.hasUnsent());
+
+	// A record can take the whole buffer.
+	auto record = createRecord(0, RING_SIZE - sizeof(log_ring_record_header_t));
+	writeRecord(ring, LOG_RING_RECORD_TYPE_LOG_ARRAY, record);
+	uint8_t type;
+	const uint8_t* data;
+	uint16_t size;
+	bool peeked = ring.peek(type, data, size);
+	assert(peeked);
+	assert(type == LOG_RING_RECORD_TYPE_LOG_ARRAY);
+	assert(vector<uint8_t>(data, data + size) == record);
+}
+
+void testRecover() {
+	cout << "Check that records are recovered after a reset, and corruption is detected." << endl;
+	srand(2);
+	Ring ring;
+
+	// Random memory at first boot.
+	uint8_t* memory = reinterpret_cast<uint8_t*>(&ring);
+	for (size_t i = 0; i < sizeof(ring); ++i) {
+		memory[i] = rand();
+	}
+	uint16_t numRecoveredAtBoot = ring.recover();
+	assert(numRecoveredAtBoot == 0);
+	assert(!ring.hasUnsent());
+
+	vector<vector<uint8_t>> written;
+	for (uint32_t i = 0; i < 500; ++i) {
+		auto record = createRecord(i, rand() % 100);
+		writeRecord(ring, LOG_RING_RECORD_TYPE_LOG, record);
+		written.push_back(record);
+		// Most are sent, they should be recovered as well.
+		if (i < 450) {
+			readAll(ring);
+		}
+	}
+
+	// A record that was started, but not ended, is not recovered.
+	ring.start(LOG_RING_RECORD_TYPE_LOG, 10);
+
+	Ring* recovered = reset(ring);
+	uint16_t numRecovered = recovered->recover();
+	auto read = readAll(*recovered);
+	assert(numRecovered == read.size());
+	assert(read.size() > 20);
+	assert(read == vector<vector<uint8_t>>(written.end() - read.size(), written.end()));
+
+	// Logs after the reset are appended.
+	auto record = createRecord(1000, 10);
+	writeRecord(*recovered, LOG_RING_RECORD_TYPE_LOG, record);
+	auto readAfterReset = readAll(*recovered);
+	assert(readAfterReset == vector<vector<uint8_t>>{record});
+
+	// Any corrupted byte of a record is detected.
+	int detected = 0;
+	for (int i = 0; i < 100; ++i) {
+		Ring* corrupted = reset(ring);
+		uint8_t* bytes  = reinterpret_cast<uint8_t*>(corrupted);
+		// Corrupt a byte at the end of the buffer: either a record is then invalid, or the byte is not in use.
+		bytes[sizeof(Ring) - 1 - rand() % 200] ^= 1 << (rand() % 8);
+		uint16_t numCorrupted = corrupted->recover();
+		assert(numCorrupted == 0 || numCorrupted == numRecovered);
+		if (numCorrupted == 0) {
+			detected++;
+		}
+		delete[] reinterpret_cast<uint8_t*>(corrupted);
+	}
+	assert(detected > 0);
+	delete[] reinterpret_cast<uint8_t*>(recovered);
+}
+
+/**
+ * Same as the log header and args that cs_log_args() writes.
+ */
+template <class Writer>
+void logArgs(Writer& writer, uint32_t lineNumber, int32_t arg0, uint32_t arg1, float arg2) {
+	uart_msg_log_header_t header;
+	header.header.fileNameHash  = 0x12345678;
+	header.header.lineNumber    = lineNumber;
+	header.header.logLevel      = LOG_LEVEL_DEBUG;
+	header.header.flags.newLine = true;
+	header.numArgs              = 3;
+	size_t totalSize = sizeof(header) + 3 * sizeof(uart_msg_log_arg_header_t) + sizeof(arg0) + sizeof(arg1) + sizeof(arg2);
+	writer.start(totalSize);
+	writer.write(reinterpret_cast<uint8_t*>(&header), sizeof(header));
+	writer.writeArg(reinterpret_cast<uint8_t*>(&arg0), sizeof(arg0));
+	writer.writeArg(reinterpret_cast<uint8_t*>(&arg1), sizeof(arg1));
+	writer.writeArg(reinterpret_cast<uint8_t*>(&arg2), sizeof(arg2));
+	writer.end();
+}
+
+template <class Writer>
+void writeArgWithHeader(Writer& writer, const uint8_t* data, uint8_t size) {
+	uart_msg_log_arg_header_t argHeader;
+	argHeader.argSize = size;
+	writer.write(reinterpret_cast<uint8_t*>(&argHeader), sizeof(argHeader));
+	writer.write(data, size);
+}
+
+/**
+ * Writes logs to the log ring.
+ */
+class RingLogWriter {
+public:
+	Ring& ring;
+	RingLogWriter(Ring& ring) : ring(ring) {}
+	void start(uint16_t size) { ring.start(LOG_RING_RECORD_TYPE_LOG, size); }
+	void write(const uint8_t* data, uint16_t size) { ring.write(data, size); }
+	void writeArg(const uint8_t* data, uint8_t size) { writeArgWithHeader(*this, data, size); }
+	void end() { ring.end(); }
+};
+
+/**
+ * Writes logs as UART frames to the serial TX buffer, like the logger does without log ring.
+ */
+typedef SerialTxRing<1024> TxRing;
+
+class TxSink {
+public:
+	TxRing& ring;
+	TxSink(TxRing& ring) : ring(ring) {}
+	bool reserve(uint16_t) { return true; }
+	void write(const uint8_t* data, uint16_t size) { ring.write(data, size); }
+};
+
+class UartLogWriter {
+public:
+	TxSink sink;
+	UartFrameWriter<TxSink> writer;
+	UartLogWriter(TxRing& ring) : sink(ring), writer(sink) {}
+	void start(uint16_t size) {
+		uart_msg_header_t uartMsgHeader;
+		uartMsgHeader.type = UART_OPCODE_TX_LOG;
+		writer.start(UartMsgType::UART_MSG, sizeof(uartMsgHeader) + size);
+		writer.write(reinterpret_cast<uint8_t*>(&uartMsgHeader), sizeof(uartMsgHeader), true);
+	}
+	void write(const uint8_t* data, uint16_t size) { writer.write(data, size, true); }
+	void writeArg(const uint8_t* data, uint8_t size) { writeArgWithHeader(*this, data, size); }
+	void end() { writer.end(); }
+};
+
+void emptyTxRing(TxRing& ring) {
+	const uint8_t* data;
+	uint16_t size;
+	while ((size = ring.peek(data)) != 0) {
+		ring.pop(size);
+	}
+}
+
+void benchmark() {
+	cout << endl << "Cost per log call" << endl;
+	const uint32_t numLogs = 2000000;
+	Ring* ring             = new Ring();
+	ring->clear();
+	RingLogWriter ringWriter(*ring);
+	auto start = chrono::steady_clock::now();
+	for (uint32_t i = 0; i < numLogs; ++i) {
+		logArgs(ringWriter, i, -i, i, i * 0.5f);
+	}
+	auto end           = chrono::steady_clock::now();
+	double ringSeconds = chrono::duration<double>(end - start).count();
+
+	TxRing* txRing = new TxRing();
+	UartLogWriter uartWriter(*txRing);
+	start = chrono::steady_clock::now();
+	for (uint32_t i = 0; i < numLogs; ++i) {
+		logArgs(uartWriter, i, -i, i, i * 0.5f);
+		// The UART sends it in the background.
+		emptyTxRing(*txRing);
+	}
+	end                = chrono::steady_clock::now();
+	double uartSeconds = chrono::duration<double>(end - start).count();
+	assert(txRing->getDroppedBytes() == 0);
+
+	cout << "  log ring:   " << fixed << setprecision(1) << ringSeconds / numLogs * 1e9 << " ns" << endl;
+	cout << "  UART frame: " << uartSeconds / numLogs * 1e9 << " ns" << endl;
+	delete ring;
+	delete txRing;
+}
+
+/**
+ * Writes a dump with some logs of this file, with the arguments given in the comment.
+ */
+void writeDump(const char* fileName) {
+	cout << "Write dump to " << fileName << endl;
+	Ring* ring = new Ring();
+	ring->clear();
+	RingLogWriter ringWriter(*ring);
+
+	uart_msg_log_header_t header;
+	// The hash is calculated like fileNameHash() in cs_Logger.h.
+	const char file[] = "test_LogRing.cpp";
+	uint32_t hash     = 5381;
+	for (int i = sizeof(file) - 1; i >= 0; --i) {
+		hash = hash * 33 + file[i];
+	}
+	header.header.fileNameHash  = hash;
+	// The line number is of the log in the comment.
+	header.header.lineNumber    = __LINE__; // LOGi("Test %s value=%i ratio=%f", str, value, ratio);
+	header.header.logLevel      = LOG_LEVEL_INFO;
+	header.header.flags.newLine = true;
+	header.numArgs              = 3;
+	const char str[]            = "dump";
+	int16_t value               = -5;
+	float ratio                 = 0.25;
+	ringWriter.start(sizeof(header) + 3 * sizeof(uart_msg_log_arg_header_t) + 4 + 2 + 4);
+	ringWriter.write(reinterpret_cast<uint8_t*>(&header), sizeof(header));
+	ringWriter.writeArg(reinterpret_cast<const uint8_t*>(str), 4);
+	ringWriter.writeArg(reinterpret_cast<uint8_t*>(&value), sizeof(value));
+	ringWriter.writeArg(reinterpret_cast<uint8_t*>(&ratio), sizeof(ratio));
+	ringWriter.end();
+
+	uart_msg_log_array_header_t arrayHeader;
+	arrayHeader.header             = header.header;
+	arrayHeader.header.lineNumber  = __LINE__; // _logArray(SERIAL_INFO, true, array, 3);
+	arrayHeader.elementType        = ELEMENT_TYPE_UNSIGNED_INTEGER;
+	arrayHeader.elementSize        = sizeof(uint16_t);
+	uint16_t array[]               = {1, 2, 300};
+	ring->start(LOG_RING_RECORD_TYPE_LOG_ARRAY, sizeof(arrayHeader) + sizeof(array));
+	ring->write(reinterpret_cast<uint8_t*>(&arrayHeader), sizeof(arrayHeader));
+	ring->write(reinterpret_cast<uint8_t*>(array), sizeof(array));
+	ring->end();
+
+	ofstream out(fileName, ios::binary);
+	out.write(reinterpret_cast<const char*>(ring), sizeof(Ring));
+	delete ring;
+}
+
+int main(int argc, char** argv) {
+	cout << "Test log ring" << endl;
+
+	testRecords();
+	testRecover();
+	benchmark();
+
+	if (argc > 1) {
+		writeDump(argv[1]);
+	}
+
+	cout << "Done" << endl;
+	return 0;
+}
@@ -0,0 +1,358 @@
+#define SERIAL_VERBOSITY SERIAL_NONE
+
+/**
+ * Tests the mesh burst scheduler: adapting the rate, and the budgets per msg type.
+ *
+ * Then simulates a number of Crownstones broadcasting in the same mesh, each with a queue like MeshModelMulticast,
+ * to compare the queue latency and drop rates of the fixed burst count with the burst scheduler.
+ */
+
+#include <mesh/cs_MeshBurstScheduler.h>
+#include <mesh/cs_MeshQueue.h>
+
+#include <cassert>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Types as in cs_MeshModelPackets.h.
+ */
+const uint8_t TYPE_MULTI_SWITCH   = 5;
+const uint8_t TYPE_STATE_0        = 8;
+const uint8_t TYPE_ASSET_INFO_MAC = 27;
+
+void testRate() {
+	cout << "Check that the rate adapts." << endl;
+	MeshBurstScheduler scheduler;
+	assert(scheduler.getRate() == MESH_MODEL_BURST_RATE_INIT);
+
+	// A backlog, while all tokens are used, increases the rate up to the max.
+	for (int i = 0; i < 20; ++i) {
+		scheduler.startInterval();
+		while (scheduler.canSend()) {
+			scheduler.onSent(TYPE_STATE_0, true);
+		}
+		scheduler.onQueueProcessed(10);
+	}
+	scheduler.startInterval();
+	assert(scheduler.getRate() == MESH_MODEL_BURST_RATE_MAX);
+
+	// A busy mesh stack halves the rate, and stops sending for the rest of the interval.
+	bool canSend = scheduler.canSend();
+	assert(canSend);
+	scheduler.onSent(TYPE_STATE_0, false);
+	canSend = scheduler.canSend();
+	assert(!canSend);
+	scheduler.startInterval();
+	assert(scheduler.getRate() == MESH_MODEL_BURST_RATE_MAX / 2);
+
+	for (int i = 0; i < 10; ++i) {
+		scheduler.onSent(TYPE_STATE_0, false);
+		scheduler.startInterval();
+	}
+	assert(scheduler.getRate() == MESH_MODEL_BURST_RATE_MIN);
+
+	// Without backlog, the rate moves back to the initial rate.
+	for (int i = 0; i < 10; ++i) {
+		scheduler.startInterval();
+	}
+	assert(scheduler.getRate() == MESH_MODEL_BURST_RATE_INIT);
+	assert(scheduler.getStats().minRate == MESH_MODEL_BURST_RATE_MIN);
+	assert(scheduler.getStats().maxRate == MESH_MODEL_BURST_RATE_MAX);
+
+	// After idle intervals, the capacity can be sent at once.
+	uint8_t numSent = 0;
+	while (scheduler.canSend()) {
+		scheduler.onSent(TYPE_STATE_0, true);
+		numSent++;
+	}
+	assert(numSent == MESH_MODEL_BURST_CAPACITY);
+}
+
+void testTypeBudget() {
+	cout << "Check the budget of a msg type." << endl;
+	MeshBurstScheduler scheduler;
+	bool budgetSet = scheduler.setTypeBudget(TYPE_ASSET_INFO_MAC, 1, 2);
+	assert(budgetSet);
+	for (int i = 0; i < 5; ++i) {
+		scheduler.startInterval();
+	}
+
+	// The type budget allows 2 at once, then 1 each interval.
+	bool canSend = scheduler.canSend(TYPE_ASSET_INFO_MAC);
+	assert(canSend);
+	scheduler.onSent(TYPE_ASSET_INFO_MAC, true);
+	canSend = scheduler.canSend(TYPE_ASSET_INFO_MAC);
+	assert(canSend);
+	scheduler.onSent(TYPE_ASSET_INFO_MAC, true);
+	canSend = scheduler.canSend(TYPE_ASSET_INFO_MAC);
+	assert(!canSend);
+	assert(scheduler.getStats().numThrottled == 1);
+
+	// Other types can still be sent.
+	canSend = scheduler.canSend(TYPE_STATE_0);
+	assert(canSend);
+	scheduler.startInterval();
+	canSend = scheduler.canSend(TYPE_ASSET_INFO_MAC);
+	assert(canSend);
+	scheduler.onSent(TYPE_ASSET_INFO_MAC, true);
+	canSend = scheduler.canSend(TYPE_ASSET_INFO_MAC);
+	assert(!canSend);
+
+	for (uint8_t i = 0; i < MESH_MODEL_BURST_TYPE_BUDGETS_MAX - 1; ++i) {
+		budgetSet = scheduler.setTypeBudget(100 + i, 1, 1);
+		assert(budgetSet);
+	}
+	budgetSet = scheduler.setTypeBudget(200, 1, 1);
+	assert(!budgetSet);
+	budgetSet = scheduler.setTypeBudget(TYPE_ASSET_INFO_MAC, 2, 2);
+	assert(budgetSet);
+}
+
+/**
+ * Sends a fixed number of msgs each interval, like MeshModelMulticast did before the burst scheduler.
+ */
+class FixedBurst {
+public:
+	void startInterval() {
+		_numSent = 0;
+		_busy    = false;
+	}
+	bool canSend() {
+		return _numSent < MESH_MODEL_BURST_RATE_INIT && !_busy;
+	}
+	bool canSend(uint8_t) {
+		return canSend();
+	}
+	void onSent(uint8_t, bool accepted) {
+		if (accepted) {
+			_numSent++;
+		}
+		else {
+			_busy = true;
+		}
+	}
+	void onQueueProcessed(uint8_t) {}
+
+private:
+	uint8_t _numSent = 0;
+	bool _busy       = false;
+};
+
+struct sim_item_t {
+	uint8_t type;
+	uint8_t transmissions;
+	uint32_t addedInterval;
+};
+
+struct sim_settings_t {
+	const char* name;
+	uint16_t numStones;
+	// Number of intervals between state broadcasts of a stone.
+	uint16_t stateInterval;
+	// Chance per interval that a stone sees a group of assets, and the number of assets in a group.
+	double assetChance;
+	uint8_t assetsPerGroup;
+	// Chance per interval that a switch command for all stones is sent.
+	double switchChance;
+};
+
+struct sim_result_t {
+	uint64_t numQueued        = 0;
+	uint64_t numDropped       = 0;
+	uint64_t numDone          = 0;
+	uint64_t totalLatency     = 0;
+	uint32_t maxLatency       = 0;
+	uint64_t numBusy          = 0;
+	uint64_t numTransmitted   = 0;
+	uint64_t numLost          = 0;
+	uint32_t maxSwitchLatency = 0;
+};
+
+/**
+ * Number of packets the mesh stack of a stone can hold, and can advertise each interval.
+ */
+const uint8_t MESH_TX_BUFFER_SIZE = 6;
+const uint8_t MESH_TX_PER_INTERVAL = 4;
+
+/**
+ * Number of packets that can be advertised each interval, by all stones together, before they collide.
+ */
+const uint16_t AIR_CAPACITY = 40;
+
+template <class Scheduler>
+struct sim_stone_t {
+	MeshQueue<sim_item_t, 20> queue;
+	Scheduler scheduler;
+	uint8_t txBuffer = 0;
+	uint16_t nextAssetId = 0;
+};
+
+template <class Scheduler>
+bool simSendFromQueue(sim_stone_t<Scheduler>& stone, uint32_t interval, sim_result_t& result) {
+	sim_item_t* item = stone.queue.front();
+	bool accepted = stone.txBuffer < MESH_TX_BUFFER_SIZE;
+	stone.scheduler.onSent(item->type, accepted);
+	if (!accepted) {
+		result.numBusy++;
+		return false;
+	}
+	stone.txBuffer++;
+	if (--(item->transmissions) == 0) {
+		uint32_t latency = interval - item->addedInterval;
+		result.numDone++;
+		result.totalLatency += latency;
+		if (latency > result.maxLatency) {
+			result.maxLatency = latency;
+		}
+		if (item->type == TYPE_MULTI_SWITCH && latency > result.maxSwitchLatency) {
+			result.maxSwitchLatency = latency;
+		}
+		stone.queue.popFront(interval);
+	}
+	else {
+		stone.queue.rotate();
+	}
+	return true;
+}
+
+/**
+ * Same as MeshModelMulticast::processQueue().
+ */
+template <class Scheduler>
+void simProcessQueue(sim_stone_t<Scheduler>& stone, uint32_t interval, sim_result_t& result) {
+	uint8_t numSkipped = 0;
+	while (numSkipped < stone.queue.size() && stone.scheduler.canSend()) {
+		if (!stone.scheduler.canSend(stone.queue.front()->type)) {
+			stone.queue.rotate();
+			numSkipped++;
+			continue;
+		}
+		if (!simSendFromQueue(stone, interval, result)) {
+			break;
+		}
+		numSkipped = 0;
+	}
+	stone.scheduler.onQueueProcessed(stone.queue.size());
+}
+
+template <class Scheduler>
+void simAdd(sim_stone_t<Scheduler>& stone, uint8_t type, uint16_t id, bool priority, uint8_t transmissions, uint32_t interval, sim_result_t& result) {
+	result.numQueued++;
+	sim_item_t* item = stone.queue.add(type, id, priority, true, interval);
+	if (item == nullptr) {
+		result.numDropped++;
+		return;
+	}
+	item->type          = type;
+	item->transmissions = transmissions;
+	item->addedInterval = interval;
+}
+
+/**
+ * Same budgets as MeshModelSelector.
+ */
+void setTypeBudgets(MeshBurstScheduler& scheduler) {
+	scheduler.setTypeBudget(TYPE_ASSET_INFO_MAC, 3, 6);
+	scheduler.setTypeBudget(TYPE_STATE_0, 1, 3);
+}
+
+void setTypeBudgets(FixedBurst&) {}
+
+template <class Scheduler>
+sim_result_t simulate(const sim_settings_t& settings, bool typeBudgets, uint32_t numIntervals) {
+	sim_result_t result;
+	vector<sim_stone_t<Scheduler>> stones(settings.numStones);
+	if (typeBudgets) {
+		for (auto& stone : stones) {
+			setTypeBudgets(stone.scheduler);
+		}
+	}
+	// Same seed for each run, so that each scheduler gets the same traffic.
+	mt19937 random(1234);
+	uniform_real_distribution<double> chance(0.0, 1.0);
+
+	for (uint32_t interval = 0; interval < numIntervals; ++interval) {
+		bool switchCommand = chance(random) < settings.switchChance;
+		for (uint16_t i = 0; i < settings.numStones; ++i) {
+			auto& stone = stones[i];
+			if ((interval + i) % settings.stateInterval == 0) {
+				simAdd(stone, TYPE_STATE_0, 0, false, 3, interval, result);
+			}
+			if (chance(random) < settings.assetChance) {
+				for (uint8_t a = 0; a < settings.assetsPerGroup; ++a) {
+					simAdd(stone, TYPE_ASSET_INFO_MAC, stone.nextAssetId++ % 64, false, 1, interval, result);
+				}
+			}
+			if (switchCommand && i == 0) {
+				simAdd(stone, TYPE_MULTI_SWITCH, 0, true, 5, interval, result);
+			}
+		}
+
+		uint32_t numOnAir = 0;
+		for (auto& stone : stones) {
+			stone.scheduler.startInterval();
+			simProcessQueue(stone, interval, result);
+			uint8_t numAdvertised = (stone.txBuffer < MESH_TX_PER_INTERVAL) ? stone.txBuffer : MESH_TX_PER_INTERVAL;
+			stone.txBuffer -= numAdvertised;
+			numOnAir += numAdvertised;
+		}
+		result.numTransmitted += numOnAir;
+		if (numOnAir > AIR_CAPACITY) {
+			result.numLost += numOnAir - AIR_CAPACITY;
+		}
+	}
+	return result;
+}
+
+void printResult(const char* name, const sim_result_t& result) {
+	cout << "  " << left << setw(24) << name << right << fixed
+			<< " dropped=" << setprecision(2) << setw(5) << 100.0 * result.numDropped / result.numQueued << "%"
+			<< " avgLatency=" << setw(5) << (double)result.totalLatency / result.numDone
+			<< " maxLatency=" << setw(3) << result.maxLatency
+			<< " maxSwitchLatency=" << setw(3) << result.maxSwitchLatency
+			<< " busy=" << setw(6) << result.numBusy
+			<< " airLoss=" << setw(5) << 100.0 * result.numLost / result.numTransmitted << "%"
+			<< endl;
+}
+
+void testSimulation() {
+	const uint32_t numIntervals = 20000;
+	sim_settings_t settingsList[] = {
+			{"quiet sphere, 10 stones",   10, 600, 0.01, 4, 0.001},
+			{"asset tracking, 10 stones", 10, 600, 0.10, 8, 0.002},
+			{"asset tracking, 30 stones", 30, 600, 0.05, 8, 0.002},
+			{"asset bursts, 20 stones",   20, 300, 0.05, 20, 0.005},
+	};
+	for (auto& settings : settingsList) {
+		cout << endl << "Simulation: " << settings.name << " (latency in intervals of "
+				<< MESH_MODEL_QUEUE_PROCESS_INTERVAL_MS << " ms)" << endl;
+		sim_result_t fixed    = simulate<FixedBurst>(settings, false, numIntervals);
+		sim_result_t adaptive = simulate<MeshBurstScheduler>(settings, false, numIntervals);
+		sim_result_t budgets  = simulate<MeshBurstScheduler>(settings, true, numIntervals);
+		printResult("fixed burst count", fixed);
+		printResult("burst scheduler", adaptive);
+		printResult("with type budgets", budgets);
+
+		// Adapting the burst size never drops more msgs than the fixed burst count.
+		assert(adaptive.numDropped <= fixed.numDropped);
+		// Budgets keep asset reports from delaying switch commands.
+		assert(budgets.maxSwitchLatency <= adaptive.maxSwitchLatency + 1);
+	}
+}
+
+int main() {
+	cout << "Test mesh burst scheduler" << endl;
+
+	testRate();
+	testTypeBudget();
+	testSimulation();
+
+	cout << "Done" << endl;
+	return 0;
+}
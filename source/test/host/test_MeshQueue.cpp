@@ -0,0 +1,532 @@
+#define SERIAL_VERBOSITY SERIAL_NONE
+
+/**
+ * Tests the mesh queue: priority and normal FIFO lists, interleaving, replacing items in place, and the statistics.
+ *
+ * Then replays traffic mixes like the ones seen on a Crownstone, through the mesh queue, and through the queue that
+ * the multicast model used before: a linear scan over the slots for every add, remove, and send.
+ */
+
+#include <mesh/cs_MeshQueue.h>
+
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+// Same as MESH_MODEL_BURST_RATE_INIT in cs_MeshDefines.h, the fixed burst count of the old queue.
+const uint8_t BURST_COUNT = 3;
+
+struct test_item_t {
+	uint8_t type;
+	uint16_t id;
+	uint8_t transmissions;
+	uint32_t payload;
+	uint32_t addedTick;
+};
+
+typedef MeshQueue<test_item_t, 20> TestQueue;
+
+test_item_t* addItem(TestQueue& queue, uint8_t type, uint16_t id, bool priority, bool replace, uint8_t transmissions, uint32_t payload, uint16_t now = 0) {
+	test_item_t* item = queue.add(type, id, priority, replace, now);
+	if (item != nullptr) {
+		item->type          = type;
+		item->id            = id;
+		item->transmissions = transmissions;
+		item->payload       = payload;
+	}
+	return item;
+}
+
+/**
+ * Sends the first item, like MeshModelMulticast::sendMsgFromQueue().
+ */
+test_item_t sendItem(TestQueue& queue, uint16_t now = 0) {
+	test_item_t* item = queue.front();
+	assert(item != nullptr);
+	test_item_t sent = *item;
+	if (--(item->transmissions) == 0) {
+		queue.popFront(now);
+	}
+	else {
+		queue.rotate();
+	}
+	return sent;
+}
+
+void testOrder() {
+	cout << "Check the order: priority first, then FIFO, interleaved." << endl;
+	TestQueue queue;
+	assert(queue.front() == nullptr);
+	addItem(queue, 1, 0, false, false, 1, 10);
+	addItem(queue, 1, 1, false, false, 2, 11);
+	addItem(queue, 2, 0, true, false, 1, 20);
+	addItem(queue, 2, 1, true, false, 2, 21);
+	assert(queue.size() == 4);
+
+	uint32_t expected[] = {20, 21, 21, 10, 11, 11};
+	for (auto payload : expected) {
+		test_item_t sent = sendItem(queue);
+		assert(sent.payload == payload);
+	}
+	assert(queue.empty());
+	assert(queue.getStats().numDone == 4);
+	assert(queue.getStats().highWatermark == 4);
+}
+
+void testReplace() {
+	cout << "Check that items are replaced in place." << endl;
+	TestQueue queue;
+	addItem(queue, 1, 5, false, true, 3, 100);
+	addItem(queue, 2, 5, false, true, 3, 200);
+	addItem(queue, 1, 6, false, true, 3, 300);
+	addItem(queue, 1, 5, false, true, 3, 101);
+	assert(queue.size() == 3);
+	assert(queue.getStats().numReplaced == 1);
+	assert(queue.front()->payload == 101);
+
+	// Without replace, a new item is added.
+	addItem(queue, 1, 5, false, false, 3, 102);
+	assert(queue.size() == 4);
+
+	// A replace with another priority moves the item to the other list.
+	addItem(queue, 1, 6, true, true, 1, 301);
+	assert(queue.size() == 4);
+	test_item_t sent = sendItem(queue);
+	assert(sent.payload == 301);
+
+	uint8_t numRemoved = queue.remove(1, 5);
+	assert(numRemoved == 2);
+	numRemoved = queue.remove(1, 5);
+	assert(numRemoved == 0);
+	assert(queue.size() == 1);
+	assert(queue.front()->payload == 200);
+	assert(queue.getStats().numRemoved == 2);
+}
+
+void testFull() {
+	cout << "Check that items are dropped when the queue is full, and that slots are reused." << endl;
+	TestQueue queue;
+	for (uint16_t i = 0; i < 20; ++i) {
+		test_item_t* item = addItem(queue, 1, i, i % 2, false, 1, i);
+		assert(item != nullptr);
+	}
+	test_item_t* item = addItem(queue, 1, 20, false, false, 1, 20);
+	assert(item == nullptr);
+	assert(queue.getStats().numDropped == 1);
+
+	// Replacing still works when the queue is full.
+	item = addItem(queue, 1, 3, true, true, 1, 3);
+	assert(item != nullptr);
+
+	for (uint16_t i = 0; i < 10; ++i) {
+		sendItem(queue, 5);
+	}
+	for (uint16_t i = 0; i < 10; ++i) {
+		item = addItem(queue, 2, i, false, false, 1, i, 5);
+		assert(item != nullptr);
+	}
+	assert(queue.size() == 20);
+	assert(queue.getStats().maxTimeInQueue == 5);
+	assert(queue.getStats().totalTimeInQueue == 50);
+}
+
+void testOutOfOrder() {
+	cout << "Check that items can be found, and be done or removed out of order, like items that wait for acks." << endl;
+	TestQueue queue;
+	addItem(queue, 1, 0, false, false, 1, 10, 0);
+	addItem(queue, 1, 1, false, false, 1, 11, 2);
+	addItem(queue, 1, 2, false, false, 1, 12, 4);
+	assert(queue.get(1, 3) == nullptr);
+
+	test_item_t* item = queue.get(1, 1);
+	assert(item != nullptr && item->payload == 11);
+	queue.pop(*item, 9);
+	assert(queue.get(1, 1) == nullptr);
+	assert(queue.getStats().numDone == 1);
+	assert(queue.getStats().maxTimeInQueue == 7);
+
+	queue.remove(*queue.get(1, 2));
+	assert(queue.getStats().numRemoved == 1);
+	assert(queue.size() == 1);
+	test_item_t sent = sendItem(queue);
+	assert(sent.payload == 10);
+	assert(queue.empty());
+
+	// Freed slots are reused.
+	for (uint16_t i = 0; i < 20; ++i) {
+		item = addItem(queue, 2, i, false, false, 1, i);
+		assert(item != nullptr);
+	}
+	assert(queue.get(2, 19)->payload == 19);
+}
+
+/**
+ * Compares with a straightforward model of the queue, with random operations.
+ */
+void testRandom() {
+	cout << "Check random operations against a model of the queue." << endl;
+	TestQueue queue;
+	deque<test_item_t> model[2];
+	srand(1);
+	for (uint32_t i = 0; i < 200000; ++i) {
+		uint8_t type     = rand() % 3;
+		uint16_t id      = rand() % 8;
+		bool priority    = rand() % 4 == 0;
+		// Only replace items that are always added with replace, else it's undefined which of the duplicates is replaced.
+		bool replace     = id < 4;
+		switch (rand() % 4) {
+			case 0:
+			case 1: {
+				bool replaced = false;
+				if (replace) {
+					for (auto list : {0, 1}) {
+						for (auto it = model[list].begin(); it != model[list].end(); ++it) {
+							if (it->type == type && it->id == id) {
+								test_item_t item = *it;
+								item.transmissions = 2;
+								item.payload       = i;
+								if (list == priority) {
+									*it = item;
+								}
+								else {
+									model[list].erase(it);
+									model[priority].push_back(item);
+								}
+								replaced = true;
+								break;
+							}
+						}
+						if (replaced) {
+							break;
+						}
+					}
+				}
+				test_item_t* item = addItem(queue, type, id, priority, replace, 2, i);
+				if (!replaced) {
+					if (model[0].size() + model[1].size() == 20) {
+						assert(item == nullptr);
+					}
+					else {
+						model[priority].push_back({type, id, 2, i, 0});
+					}
+				}
+				break;
+			}
+			case 2: {
+				uint8_t numRemoved = 0;
+				for (auto& list : model) {
+					for (auto it = list.begin(); it != list.end();) {
+						if (it->type == type && it->id == id) {
+							it = list.erase(it);
+							numRemoved++;
+						}
+						else {
+							++it;
+						}
+					}
+				}
+				uint8_t numRemovedFromQueue = queue.remove(type, id);
+				assert(numRemovedFromQueue == numRemoved);
+				break;
+			}
+			case 3: {
+				deque<test_item_t>& list = model[1].empty() ? model[0] : model[1];
+				if (list.empty()) {
+					assert(queue.front() == nullptr);
+					break;
+				}
+				test_item_t expected = list.front();
+				list.pop_front();
+				if (--expected.transmissions > 0) {
+					list.push_back(expected);
+				}
+				test_item_t sent = sendItem(queue);
+				assert(sent.payload == expected.payload);
+				break;
+			}
+		}
+		assert(queue.size() == model[0].size() + model[1].size());
+	}
+}
+
+/**
+ * The queue of the multicast model before the mesh queue, see git history of cs_MeshModelMulticast.cpp.
+ */
+class LinearScanQueue {
+public:
+	struct slot_t {
+		test_item_t item;
+		bool priority;
+	};
+	slot_t _queue[20] = {};
+	uint8_t _queueIndexNext = 0;
+
+	test_item_t* add(uint8_t type, uint16_t id, bool priority) {
+		for (int i = _queueIndexNext + 20; i > _queueIndexNext; --i) {
+			uint8_t index = i % 20;
+			if (_queue[index].item.transmissions == 0) {
+				_queue[index].item.type = type;
+				_queue[index].item.id   = id;
+				_queue[index].priority  = priority;
+				_queueIndexNext         = index;
+				return &(_queue[index].item);
+			}
+		}
+		return nullptr;
+	}
+
+	void remove(uint8_t type, uint16_t id) {
+		for (auto& slot : _queue) {
+			if (slot.item.id == id && slot.item.type == type && slot.item.transmissions != 0) {
+				slot.item.transmissions = 0;
+			}
+		}
+	}
+
+	int getNextItemInQueue(bool priority) {
+		for (int i = _queueIndexNext; i < _queueIndexNext + 20; i++) {
+			uint8_t index = i % 20;
+			if ((!priority || _queue[index].priority) && _queue[index].item.transmissions > 0) {
+				return index;
+			}
+		}
+		return -1;
+	}
+
+	test_item_t* send() {
+		int index = getNextItemInQueue(true);
+		if (index == -1) {
+			index = getNextItemInQueue(false);
+		}
+		if (index == -1) {
+			return nullptr;
+		}
+		--(_queue[index].item.transmissions);
+		_queueIndexNext = (index + 1) % 20;
+		return &(_queue[index].item);
+	}
+
+	uint8_t size() {
+		uint8_t size = 0;
+		for (auto& slot : _queue) {
+			size += slot.item.transmissions > 0;
+		}
+		return size;
+	}
+};
+
+/**
+ * A message that is queued at a tick, like MeshMsgSender does.
+ */
+struct traffic_msg_t {
+	uint32_t tick;
+	uint8_t type;
+	uint16_t id;
+	bool priority;
+	uint8_t transmissions;
+};
+
+struct traffic_result_t {
+	uint32_t numSent       = 0;
+	uint32_t numDropped    = 0;
+	uint32_t numDone       = 0;
+	uint32_t maxDepth      = 0;
+	uint64_t totalTimeInQueue = 0;
+	double nsPerMsg        = 0;
+};
+
+/**
+ * Types as in cs_MeshModelPackets.h.
+ */
+const uint8_t TYPE_CMD_TIME           = 3;
+const uint8_t TYPE_MULTI_SWITCH       = 5;
+const uint8_t TYPE_STATE_0            = 8;
+const uint8_t TYPE_PROFILE_LOCATION   = 10;
+const uint8_t TYPE_RSSI_PING          = 21;
+
+/**
+ * Traffic of a Crownstone in a busy sphere: every 10 ticks a state update, a profile location of each user every
+ * 20 ticks, RSSI pings, a time sync every 600 ticks, and switch commands for a group of Crownstones every 100 ticks.
+ */
+vector<traffic_msg_t> busySphere(uint32_t numTicks) {
+	vector<traffic_msg_t> msgs;
+	for (uint32_t tick = 0; tick < numTicks; ++tick) {
+		if (tick % 10 == 0) {
+			msgs.push_back({tick, TYPE_STATE_0, 0, false, 3});
+		}
+		for (uint16_t user = 0; user < 4; ++user) {
+			if ((tick + 5 * user) % 20 == 0) {
+				msgs.push_back({tick, TYPE_PROFILE_LOCATION, user, false, 3});
+			}
+		}
+		if (tick % 3 == 0) {
+			msgs.push_back({tick, TYPE_RSSI_PING, 0, false, 1});
+		}
+		if (tick % 600 == 0) {
+			msgs.push_back({tick, TYPE_CMD_TIME, 0, true, 5});
+		}
+		if (tick % 100 == 50) {
+			for (uint16_t stone = 0; stone < 8; ++stone) {
+				msgs.push_back({tick, TYPE_MULTI_SWITCH, stone, true, 3});
+			}
+		}
+	}
+	return msgs;
+}
+
+/**
+ * The profile location of users that walk around changes every tick, with bursts of switch commands.
+ * More is queued than can be sent, so only replacing keeps the queue from overflowing.
+ */
+vector<traffic_msg_t> walkingUsers(uint32_t numTicks) {
+	vector<traffic_msg_t> msgs;
+	for (uint32_t tick = 0; tick < numTicks; ++tick) {
+		for (uint16_t user = 0; user < 8; ++user) {
+			msgs.push_back({tick, TYPE_PROFILE_LOCATION, user, false, 5});
+		}
+		if (tick % 20 == 0) {
+			for (uint16_t stone = 0; stone < 4; ++stone) {
+				msgs.push_back({tick, TYPE_MULTI_SWITCH, stone, true, 3});
+			}
+		}
+	}
+	return msgs;
+}
+
+template <class Queue, class Add, class Send>
+traffic_result_t replay(const vector<traffic_msg_t>& msgs, uint32_t numTicks, Queue& queue, Add add, Send send) {
+	traffic_result_t result;
+	auto start = chrono::steady_clock::now();
+	size_t msgIndex = 0;
+	for (uint32_t tick = 0; tick < numTicks; ++tick) {
+		for (; msgIndex < msgs.size() && msgs[msgIndex].tick == tick; ++msgIndex) {
+			if (!add(msgs[msgIndex], tick)) {
+				result.numDropped++;
+			}
+		}
+		if (queue.size() > result.maxDepth) {
+			result.maxDepth = queue.size();
+		}
+		for (uint8_t i = 0; i < BURST_COUNT; ++i) {
+			test_item_t* item = send(tick);
+			if (item == nullptr) {
+				break;
+			}
+			result.numSent++;
+			if (item->transmissions == 0) {
+				result.numDone++;
+				result.totalTimeInQueue += tick - item->addedTick;
+			}
+		}
+	}
+	auto end = chrono::steady_clock::now();
+	result.nsPerMsg = chrono::duration<double>(end - start).count() / (msgs.size() + result.numSent) * 1e9;
+	return result;
+}
+
+traffic_result_t replayMeshQueue(const vector<traffic_msg_t>& msgs, uint32_t numTicks) {
+	TestQueue queue;
+	test_item_t lastSent;
+	auto add = [&](const traffic_msg_t& msg, uint32_t tick) {
+		test_item_t* item = queue.add(msg.type, msg.id, msg.priority, true, tick);
+		if (item == nullptr) {
+			return false;
+		}
+		// Time in queue of the latest msg, like the linear scan queue, which removes the old msg.
+		item->addedTick     = tick;
+		item->type          = msg.type;
+		item->id            = msg.id;
+		item->transmissions = msg.transmissions;
+		return true;
+	};
+	auto send = [&](uint32_t tick) -> test_item_t* {
+		test_item_t* item = queue.front();
+		if (item == nullptr) {
+			return nullptr;
+		}
+		lastSent = *item;
+		lastSent.transmissions--;
+		item->transmissions--;
+		if (item->transmissions == 0) {
+			queue.popFront(tick);
+		}
+		else {
+			queue.rotate();
+		}
+		return &lastSent;
+	};
+	traffic_result_t result = replay(msgs, numTicks, queue, add, send);
+	assert(result.maxDepth == queue.getStats().highWatermark);
+	// The counters wrap around.
+	assert((uint16_t)result.numDropped == queue.getStats().numDropped);
+	assert((uint16_t)result.numDone == queue.getStats().numDone);
+	return result;
+}
+
+traffic_result_t replayLinearScanQueue(const vector<traffic_msg_t>& msgs, uint32_t numTicks) {
+	LinearScanQueue queue;
+	auto add = [&](const traffic_msg_t& msg, uint32_t tick) {
+		// Like MeshMsgSender: remove old messages of same type and id, as only the latest is of interest.
+		queue.remove(msg.type, msg.id);
+		test_item_t* item = queue.add(msg.type, msg.id, msg.priority);
+		if (item == nullptr) {
+			return false;
+		}
+		item->transmissions = msg.transmissions;
+		item->addedTick     = tick;
+		return true;
+	};
+	auto send = [&](uint32_t) { return queue.send(); };
+	return replay(msgs, numTicks, queue, add, send);
+}
+
+void printResult(const char* name, const traffic_result_t& result) {
+	cout << "  " << left << setw(14) << name << right
+			<< " sent=" << setw(6) << result.numSent
+			<< " done=" << setw(6) << result.numDone
+			<< " dropped=" << setw(5) << result.numDropped
+			<< " maxDepth=" << setw(2) << result.maxDepth
+			<< " avgTimeInQueue=" << fixed << setprecision(2) << setw(5)
+			<< (result.numDone ? (double)result.totalTimeInQueue / result.numDone : 0.0) << " ticks"
+			<< " cost=" << setprecision(1) << result.nsPerMsg << " ns/op" << endl;
+}
+
+void testTraffic() {
+	const uint32_t numTicks = 200000;
+	struct {
+		const char* name;
+		vector<traffic_msg_t> msgs;
+	} mixes[] = {
+			{"busy sphere", busySphere(numTicks)},
+			{"walking users", walkingUsers(numTicks)},
+	};
+	for (auto& mix : mixes) {
+		cout << endl << "Traffic mix: " << mix.name << " (" << mix.msgs.size() << " msgs)" << endl;
+		traffic_result_t meshQueue  = replayMeshQueue(mix.msgs, numTicks);
+		traffic_result_t linearScan = replayLinearScanQueue(mix.msgs, numTicks);
+		printResult("mesh queue", meshQueue);
+		printResult("linear scan", linearScan);
+		// Replacing in place never drops a state update.
+		assert(meshQueue.numDropped <= linearScan.numDropped);
+	}
+}
+
+int main() {
+	cout << "Test mesh queue" << endl;
+
+	testOrder();
+	testReplace();
+	testFull();
+	testOutOfOrder();
+	testRandom();
+	testTraffic();
+
+	cout << "Done" << endl;
+	return 0;
+}
@@ -0,0 +1,226 @@
+#define SERIAL_VERBOSITY SERIAL_DEBUG
+
+/**
+ * Build with -DEMULATE_DSP to test the DSP path of the kernel, with emulated Cortex-M4 instructions.
+ */
+#ifdef EMULATE_DSP
+#include <cstdint>
+inline uint32_t __PKHBT(uint32_t a, uint32_t b, uint32_t shift) {
+	return (a & 0xFFFF) | ((b << shift) & 0xFFFF0000);
+}
+inline uint32_t __PKHTB(uint32_t a, uint32_t b, uint32_t shift) {
+	return (a & 0xFFFF0000) | ((b >> shift) & 0xFFFF);
+}
+inline uint64_t __SMLALD(uint32_t a, uint32_t b, uint64_t acc) {
+	return acc + (int64_t)((int16_t)a * (int16_t)b) + (int64_t)((int16_t)(a >> 16) * (int16_t)(b >> 16));
+}
+inline uint32_t __SMLAD(uint32_t a, uint32_t b, uint32_t acc) {
+	return acc + (int16_t)a * (int16_t)b + (int16_t)(a >> 16) * (int16_t)(b >> 16);
+}
+#define CS_POWER_KERNEL_DSP 1
+#endif
+
+#include <processing/cs_PowerKernel.h>
+
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAS_CYCLE_COUNTER 1
+#endif
+
+using namespace std;
+
+const uint16_t NUM_SAMPLES = 100;
+
+/**
+ * Copy of the loop that was in PowerSampling::calculatePower().
+ */
+power_kernel_sums_t calculatePowerSumsReference(
+		const int16_t* samples, uint16_t numSamples, int32_t zeroVoltage, int32_t zeroCurrent) {
+	int64_t pSum       = 0;
+	int64_t cSquareSum = 0;
+	int64_t vSquareSum = 0;
+	int64_t current;
+	int64_t voltage;
+	for (uint16_t i = 0; i < numSamples; ++i) {
+		voltage = (int64_t)samples[2 * i] * 1024 - zeroVoltage;
+		current = (int64_t)samples[2 * i + 1] * 1024 - zeroCurrent;
+		vSquareSum += (voltage * voltage) / (1024 * 1024);
+		cSquareSum += (current * current) / (1024 * 1024);
+		pSum += (current * voltage) / (1024 * 1024);
+	}
+	power_kernel_sums_t result;
+	result.voltageSquareSum = vSquareSum;
+	result.currentSquareSum = cSquareSum;
+	result.powerSum         = pSum;
+	return result;
+}
+
+struct board_t {
+	const char* name;
+	float voltageMultiplier;
+	float currentMultiplier;
+	int32_t voltageZero;
+	int32_t currentZero;
+	int16_t minValue;
+	int16_t maxValue;
+};
+
+/**
+ * Values from cs_Boards.c: a board with single ended, and one with differential measurements.
+ */
+const board_t boards[] = {
+		{"single ended", 0.2f, 0.0044f, 1993, 1980, 0, 4095},
+		{"differential", -0.2547f, 0.01486f, 500, -125, -2048, 2047},
+};
+
+struct waveform_t {
+	const char* name;
+	double voltageAmplitude;
+	double currentAmplitude;
+	double phase;
+	// Amplitude of the 3rd harmonic of the current, relative to the current amplitude.
+	double currentHarmonic;
+	// Fraction of each half period that the current is cut off, like a phase cut dimmer.
+	double cutOff;
+	double noise;
+};
+
+const waveform_t waveforms[] = {
+		{"no load", 1400, 0, 0, 0, 0, 2},
+		{"resistive", 1400, 900, 0, 0, 0, 2},
+		{"inductive", 1400, 600, 0.6, 0, 0, 2},
+		{"switch mode", 1400, 1500, 0, 0.6, 0, 3},
+		{"dimmed", 1400, 1200, 0, 0, 0.4, 3},
+		{"clipped", 2500, 2500, 0.2, 0, 0, 1},
+};
+
+/**
+ * Creates one period of interleaved samples.
+ */
+vector<int16_t> createSamples(const board_t& board, const waveform_t& waveform, double startPhase) {
+	vector<int16_t> samples(2 * NUM_SAMPLES);
+	double zeroVoltage = board.voltageZero;
+	double zeroCurrent = board.currentZero;
+	for (uint16_t i = 0; i < NUM_SAMPLES; ++i) {
+		double angle   = startPhase + 2 * M_PI * i / NUM_SAMPLES;
+		double voltage = zeroVoltage + waveform.voltageAmplitude * sin(angle);
+		double current = waveform.currentAmplitude
+						 * (sin(angle - waveform.phase) + waveform.currentHarmonic * sin(3 * (angle - waveform.phase)));
+		if (fmod(angle, M_PI) < waveform.cutOff * M_PI) {
+			current = 0;
+		}
+		current += zeroCurrent;
+		voltage += waveform.noise * ((rand() % 2001) - 1000) / 1000.0;
+		current += waveform.noise * ((rand() % 2001) - 1000) / 1000.0;
+		samples[2 * i]     = max<double>(board.minValue, min<double>(board.maxValue, round(voltage)));
+		samples[2 * i + 1] = max<double>(board.minValue, min<double>(board.maxValue, round(current)));
+	}
+	return samples;
+}
+
+/**
+ * Same calculation as in PowerSampling::calculatePower().
+ */
+void toUnits(const power_kernel_sums_t& sums, const board_t& board, int32_t& powerMilliWatt, int32_t& currentRmsMA,
+			 int32_t& voltageRmsMilliVolt) {
+	powerMilliWatt = sums.powerSum * board.currentMultiplier * board.voltageMultiplier * 1000 / NUM_SAMPLES;
+	currentRmsMA =
+			sqrt((double)sums.currentSquareSum * board.currentMultiplier * board.currentMultiplier / NUM_SAMPLES) * 1000;
+	voltageRmsMilliVolt =
+			sqrt((double)sums.voltageSquareSum * board.voltageMultiplier * board.voltageMultiplier / NUM_SAMPLES) * 1000;
+}
+
+void testSameResults() {
+	cout << "Check that the kernel gives the same results as the previous loop, within tolerance." << endl;
+	srand(1);
+	for (auto& board : boards) {
+		for (auto& waveform : waveforms) {
+			for (int run = 0; run < 20; ++run) {
+				auto samples = createSamples(board, waveform, run * 0.37);
+				// The zero values are averages times 1024, so they have a fractional part.
+				int32_t zeroVoltage = board.voltageZero * 1024 + (rand() % 2048) - 1024;
+				int32_t zeroCurrent = board.currentZero * 1024 + (rand() % 2048) - 1024;
+
+				for (uint16_t numSamples : {NUM_SAMPLES, static_cast<uint16_t>(NUM_SAMPLES - 1)}) {
+					auto expected = calculatePowerSumsReference(samples.data(), numSamples, zeroVoltage, zeroCurrent);
+					auto result   = calculatePowerSums(samples.data(), numSamples, zeroVoltage, zeroCurrent);
+
+					// The previous loop truncated each term, the kernel only truncates the sum.
+					assert(llabs(result.voltageSquareSum - expected.voltageSquareSum) <= numSamples);
+					assert(llabs(result.currentSquareSum - expected.currentSquareSum) <= numSamples);
+					assert(llabs(result.powerSum - expected.powerSum) <= numSamples);
+				}
+
+				int32_t expectedPower, expectedCurrent, expectedVoltage;
+				int32_t power, current, voltage;
+				toUnits(calculatePowerSumsReference(samples.data(), NUM_SAMPLES, zeroVoltage, zeroCurrent), board,
+						expectedPower, expectedCurrent, expectedVoltage);
+				toUnits(calculatePowerSums(samples.data(), NUM_SAMPLES, zeroVoltage, zeroCurrent), board, power,
+						current, voltage);
+				assert(abs(power - expectedPower) <= 20);
+				assert(abs(current - expectedCurrent) <= 5);
+				assert(abs(voltage - expectedVoltage) <= 5);
+				if (run == 0) {
+					cout << "  " << setw(14) << board.name << setw(12) << waveform.name << ": P=" << setw(7) << power
+						 << "mW (" << setw(7) << expectedPower << ")  I=" << setw(6) << current << "mA (" << setw(6)
+						 << expectedCurrent << ")  V=" << setw(7) << voltage << "mV (" << setw(7) << expectedVoltage
+						 << ")" << endl;
+				}
+			}
+		}
+	}
+}
+
+template <class Function>
+void measure(const char* name, const vector<int16_t>& samples, Function function) {
+	const int iterations = 200000;
+	int64_t check        = 0;
+#ifdef HAS_CYCLE_COUNTER
+	uint64_t startCycles = __rdtsc();
+#endif
+	auto start = chrono::steady_clock::now();
+	for (int i = 0; i < iterations; ++i) {
+		auto sums = function(samples.data(), NUM_SAMPLES, 1993 * 1024 + i % 7, 1980 * 1024);
+		check += sums.powerSum + sums.voltageSquareSum + sums.currentSquareSum;
+	}
+	auto end = chrono::steady_clock::now();
+#ifdef HAS_CYCLE_COUNTER
+	uint64_t cycles = __rdtsc() - startCycles;
+#endif
+	// Keep the result alive.
+	volatile int64_t sink = check;
+	(void)sink;
+	double seconds = chrono::duration<double>(end - start).count();
+	cout << setw(12) << name << setw(12) << fixed << setprecision(1) << seconds / iterations * 1e9;
+#ifdef HAS_CYCLE_COUNTER
+	cout << setw(12) << (double)cycles / iterations;
+#endif
+	cout << endl;
+}
+
+void benchmark() {
+	cout << endl << "Per period of " << NUM_SAMPLES << " sample pairs" << endl;
+	cout << setw(12) << "" << setw(12) << "ns" << setw(12) << "tsc cycles" << endl;
+	srand(2);
+	auto samples = createSamples(boards[0], waveforms[2], 0);
+	measure("reference", samples, calculatePowerSumsReference);
+	measure("kernel", samples, calculatePowerSums);
+}
+
+int main() {
+	cout << "Test power kernel, DSP path: " << (CS_POWER_KERNEL_DSP ? "emulated" : "no") << endl;
+
+	testSameResults();
+	benchmark();
+
+	cout << "Done" << endl;
+	return 0;
+}
@@ -0,0 +1,215 @@
+#define SERIAL_VERBOSITY SERIAL_DEBUG
+
+#include <structs/buffer/cs_RunningMedianBuffer.h>
+#include <third/optmed.h>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAS_CYCLE_COUNTER 1
+#endif
+
+using namespace std;
+
+const uint16_t WINDOW_SIZE = 9;
+
+/**
+ * Same as PowerSampling::calculatePower() did: median of a full history, else the average.
+ */
+int32_t medianOrAverageReference(const deque<int32_t>& history) {
+	if (history.size() == WINDOW_SIZE) {
+		int32_t copy[WINDOW_SIZE];
+		copy_n(history.begin(), WINDOW_SIZE, copy);
+		return opt_med9(copy);
+	}
+	int64_t sum = 0;
+	for (auto value : history) {
+		sum += value;
+	}
+	return sum / (int64_t)history.size();
+}
+
+/**
+ * Sorts the history, for any size.
+ */
+int32_t sortMedian(const deque<int32_t>& history) {
+	vector<int32_t> sorted(history.begin(), history.end());
+	sort(sorted.begin(), sorted.end());
+	return sorted[sorted.size() / 2];
+}
+
+/**
+ * Rms values of a load that switches on and off, with noise, spikes, and negative values.
+ */
+int32_t createValue(int i) {
+	int32_t value = ((i / 30) % 2) ? 2000 : 100;
+	value += (rand() % 41) - 20;
+	if (rand() % 10 == 0) {
+		value += (rand() % 8001) - 4000;
+	}
+	if (rand() % 10 == 0) {
+		// Many equal values.
+		value = 100;
+	}
+	return value;
+}
+
+template <uint16_t Size>
+void testSize() {
+	RunningMedianBuffer<int32_t, Size> buffer;
+	deque<int32_t> history;
+	assert(buffer.empty());
+	assert(buffer.medianOrAverage() == 0);
+	for (int i = 0; i < 2000; ++i) {
+		if (i == 1000) {
+			buffer.clear();
+			history.clear();
+			assert(buffer.size() == 0);
+		}
+		int32_t value = createValue(i);
+		buffer.push(value);
+		history.push_back(value);
+		if (history.size() > Size) {
+			history.pop_front();
+		}
+
+		assert(buffer.size() == history.size());
+		assert(buffer.full() == (history.size() == Size));
+		for (uint16_t j = 0; j < buffer.size(); ++j) {
+			assert(buffer[j] == history[j]);
+		}
+		if (buffer.full()) {
+			assert(buffer.median() == sortMedian(history));
+		}
+		else {
+			int64_t sum = 0;
+			for (auto v : history) {
+				sum += v;
+			}
+			assert(buffer.medianOrAverage() == sum / (int64_t)history.size());
+		}
+	}
+}
+
+void testSameResults() {
+	cout << "Check that the buffer gives the same results as opt_med9 and the average." << endl;
+	srand(1);
+	RunningMedianBuffer<int32_t, WINDOW_SIZE> buffer;
+	deque<int32_t> history;
+	for (int i = 0; i < 10000; ++i) {
+		int32_t value = createValue(i);
+		buffer.push(value);
+		history.push_back(value);
+		if (history.size() > WINDOW_SIZE) {
+			history.pop_front();
+		}
+		assert(buffer.medianOrAverage() == medianOrAverageReference(history));
+	}
+
+	cout << "Check other sizes against sorting the history." << endl;
+	testSize<3>();
+	testSize<7>();
+	testSize<25>();
+}
+
+/**
+ * Copy of what PowerSampling::calculatePower() did per history, with a plain ring instead of a CircularBuffer.
+ */
+struct ReferenceHistory {
+	int32_t values[WINDOW_SIZE];
+	int32_t copy[WINDOW_SIZE];
+	uint16_t head = 0;
+	uint16_t size = 0;
+
+	int32_t push(int32_t value) {
+		values[head] = value;
+		head         = (head + 1) % WINDOW_SIZE;
+		if (size < WINDOW_SIZE) {
+			++size;
+		}
+		if (size == WINDOW_SIZE) {
+			memcpy(copy, values, sizeof(values));
+			return opt_med9(copy);
+		}
+		int64_t sum = 0;
+		for (uint16_t i = 0; i < size; ++i) {
+			sum += values[i];
+		}
+		return sum / size;
+	}
+};
+
+template <class Function>
+void measure(const char* name, const vector<int32_t>& values, Function function) {
+	const int iterations = 200;
+	int64_t check        = 0;
+#ifdef HAS_CYCLE_COUNTER
+	uint64_t startCycles = __rdtsc();
+#endif
+	auto start = chrono::steady_clock::now();
+	for (int i = 0; i < iterations; ++i) {
+		check += function(values);
+	}
+	auto end = chrono::steady_clock::now();
+#ifdef HAS_CYCLE_COUNTER
+	uint64_t cycles = __rdtsc() - startCycles;
+#endif
+	volatile int64_t sink = check;
+	(void)sink;
+	// Each period pushes to the 3 histories.
+	double periods = (double)iterations * values.size() / 3;
+	double seconds = chrono::duration<double>(end - start).count();
+	cout << setw(12) << name << setw(12) << fixed << setprecision(1) << seconds / periods * 1e9;
+#ifdef HAS_CYCLE_COUNTER
+	cout << setw(12) << (double)cycles / periods;
+#endif
+	cout << endl;
+}
+
+void benchmark() {
+	cout << endl << "Per period, for 3 histories of " << WINDOW_SIZE << " values" << endl;
+	cout << setw(12) << "" << setw(12) << "ns" << setw(12) << "tsc cycles" << endl;
+	srand(2);
+	vector<int32_t> values(3 * 10000);
+	for (size_t i = 0; i < values.size(); ++i) {
+		values[i] = createValue(i / 3);
+	}
+	measure("opt_med9", values, [](const vector<int32_t>& values) {
+		ReferenceHistory histories[3];
+		int64_t check = 0;
+		for (size_t i = 0; i < values.size(); i += 3) {
+			check += histories[0].push(values[i]) + histories[1].push(values[i + 1]) + histories[2].push(values[i + 2]);
+		}
+		return check;
+	});
+	measure("running", values, [](const vector<int32_t>& values) {
+		RunningMedianBuffer<int32_t, WINDOW_SIZE> histories[3];
+		int64_t check = 0;
+		for (size_t i = 0; i < values.size(); i += 3) {
+			for (int h = 0; h < 3; ++h) {
+				histories[h].push(values[i + h]);
+				check += histories[h].medianOrAverage();
+			}
+		}
+		return check;
+	});
+}
+
+int main() {
+	cout << "Test running median buffer" << endl;
+
+	testSameResults();
+	benchmark();
+
+	cout << "Done" << endl;
+	return 0;
+}
@@ -0,0 +1,752 @@
+#define SERIAL_VERBOSITY SERIAL_NONE
+
+/**
+ * Benchmark of the scan path.
+ *
+ * Replays an advertisement capture through the scan path of a number of simulated Crownstones at once. Each simulated
+ * Crownstone runs in its own process, so that it has its own State, event dispatcher, and components. Reports the
+ * advertisements per second, the time per component, and the heap high watermark per simulated Crownstone.
+ *
+ * The components are the ones of the firmware: the scanned device ring of MeshScanner, BackgroundAdvertisementHandler,
+ * TrackedDevices, CommandAdvHandler, and AssetFiltering with its AssetFilterStore, AssetStore, AssetForwarder, and
+ * NearestCrownstoneTracker. State is stored on the host FDS. The filters are uploaded and committed with the same
+ * commands as the ones that come from the mesh or a phone.
+ *
+ * The modules that these components use, but that need the SoftDevice or peripherals, are replaced by minimal
+ * stand-ins: SystemTime, AES, RNG, and UartHandler.
+ *
+ * Usage: test_ScanPipeline [capture file] [max number of stones] [number of replays]
+ *
+ * The capture file has a line per advertisement: time_ms,address,rssi,channel,data
+ * With address as AA:BB:CC:DD:EE:FF and data as hex string. Lines starting with # are ignored.
+ */
+
+#include <drivers/cs_RNG.h>
+#include <drivers/cs_Storage.h>
+#include <encryption/cs_AES.h>
+#include <encryption/cs_KeysAndAccess.h>
+#include <encryption/cs_RC5.h>
+#include <events/cs_EventDispatcher.h>
+#include <host/cs_HostFds.h>
+#include <localisation/cs_AssetFilterPacketAccessors.h>
+#include <localisation/cs_AssetFiltering.h>
+#include <processing/cs_BackgroundAdvHandler.h>
+#include <processing/cs_CommandAdvHandler.h>
+#include <storage/cs_State.h>
+#include <structs/buffer/cs_ScannedDeviceRing.h>
+#include <time/cs_SystemTime.h>
+#include <tracking/cs_TrackedDevices.h>
+#include <uart/cs_UartHandler.h>
+#include <util/cs_Crc32.h>
+#include <util/cs_ExactMatchFilterIndex.h>
+
+#include <malloc.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Heap usage of this process, kept by the replaced operator new and delete.
+ *
+ * Each simulated Crownstone runs in its own process, so these are the counters of a single Crownstone. A forked process
+ * starts with the counters of its parent, which include the blocks it inherits, so freeing those keeps them right.
+ */
+size_t heapUsed          = 0;
+size_t heapHighWatermark = 0;
+
+/**
+ * Allocate and free with malloc, and keep up the usable size of the blocks.
+ *
+ * Not inlined: else the compiler sees a block of operator new being passed to free, and warns about a mismatch.
+ */
+__attribute__((noinline)) void* heapAllocate(size_t size) noexcept {
+	void* ptr = malloc(size == 0 ? 1 : size);
+	if (ptr != nullptr) {
+		heapUsed += malloc_usable_size(ptr);
+		heapHighWatermark = max(heapHighWatermark, heapUsed);
+	}
+	return ptr;
+}
+
+__attribute__((noinline)) void heapFree(void* ptr) noexcept {
+	if (ptr == nullptr) {
+		return;
+	}
+	heapUsed -= malloc_usable_size(ptr);
+	free(ptr);
+}
+
+void* operator new(size_t size) {
+	void* ptr = heapAllocate(size);
+	if (ptr == nullptr) {
+		throw bad_alloc();
+	}
+	return ptr;
+}
+
+void* operator new[](size_t size) {
+	return operator new(size);
+}
+
+void* operator new(size_t size, const nothrow_t&) noexcept {
+	return heapAllocate(size);
+}
+
+void* operator new[](size_t size, const nothrow_t&) noexcept {
+	return heapAllocate(size);
+}
+
+void operator delete(void* ptr) noexcept {
+	heapFree(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+	heapFree(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+	heapFree(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+	heapFree(ptr);
+}
+
+void operator delete(void* ptr, const nothrow_t&) noexcept {
+	heapFree(ptr);
+}
+
+void operator delete[](void* ptr, const nothrow_t&) noexcept {
+	heapFree(ptr);
+}
+
+/**
+ * Stand-ins for the modules that need the SoftDevice or peripherals.
+ */
+
+//! Time isn't set, like on a Crownstone that didn't get the time yet.
+uint32_t SystemTime::posix() {
+	return 0;
+}
+
+//! Count of AES decryptions, that fail as if the key doesn't match.
+uint64_t numDecryptions = 0;
+
+AES::AES() {}
+
+cs_ret_code_t AES::decryptCtr(cs_data_t, cs_data_t, cs_data_t, cs_data_t, cs_data_t, cs_buffer_size_t& writtenSize, uint8_t) {
+	numDecryptions++;
+	writtenSize = 0;
+	return ERR_NO_ACCESS;
+}
+
+RNG::RNG() {}
+
+void RNG::fillBuffer(uint8_t* buffer, uint8_t length) {
+	for (uint8_t i = 0; i < length; ++i) {
+		buffer[i] = rand();
+	}
+}
+
+uint32_t RNG::getRandom32() {
+	return rand();
+}
+
+uint16_t RNG::getRandom16() {
+	return rand();
+}
+
+uint8_t RNG::getRandom8() {
+	return rand();
+}
+
+//! Count of messages that are written to UART.
+uint64_t numUartMsgs = 0;
+
+ret_code_t UartHandler::writeMsg(UartOpcodeTx, uint8_t*, uint16_t, UartProtocol::Encrypt) {
+	numUartMsgs++;
+	return ERR_SUCCESS;
+}
+
+void UartHandler::handleEvent(event_t&) {}
+
+/**
+ * An advertisement of the capture.
+ */
+struct capture_adv_t {
+	uint32_t timeMs;
+	uint8_t address[MAC_ADDRESS_LEN];
+	int8_t rssi;
+	uint8_t channel;
+	uint8_t dataSize;
+	uint8_t data[31];
+};
+
+bool parseHex(const string& str, uint8_t* out, size_t maxSize, size_t& size) {
+	if (str.size() % 2 != 0 || str.size() / 2 > maxSize) {
+		return false;
+	}
+	size = str.size() / 2;
+	for (size_t i = 0; i < size; ++i) {
+		out[i] = strtoul(str.substr(2 * i, 2).c_str(), nullptr, 16);
+	}
+	return true;
+}
+
+bool readCapture(const string& fileName, vector<capture_adv_t>& capture) {
+	ifstream file(fileName);
+	if (!file) {
+		return false;
+	}
+	string line;
+	while (getline(file, line)) {
+		if (line.empty() || line[0] == '#') {
+			continue;
+		}
+		vector<string> fields;
+		stringstream stream(line);
+		string field;
+		while (getline(stream, field, ',')) {
+			fields.push_back(field);
+		}
+		if (fields.size() != 5) {
+			return false;
+		}
+		capture_adv_t adv = {};
+		adv.timeMs        = stoul(fields[0]);
+		string address    = fields[1];
+		address.erase(remove(address.begin(), address.end(), ':'), address.end());
+		size_t size;
+		if (!parseHex(address, adv.address, sizeof(adv.address), size) || size != sizeof(adv.address)) {
+			return false;
+		}
+		adv.rssi    = stoi(fields[2]);
+		adv.channel = stoul(fields[3]);
+		if (!parseHex(fields[4], adv.data, sizeof(adv.data), size)) {
+			return false;
+		}
+		adv.dataSize = size;
+		capture.push_back(adv);
+	}
+	return !capture.empty();
+}
+
+/**
+ * Components of the scan path, in order.
+ */
+enum ScanStage : uint8_t {
+	STAGE_MESH_SCANNER = 0,
+	STAGE_AD_INDEX,
+	STAGE_BACKGROUND_ADV,
+	STAGE_COMMAND_ADV,
+	STAGE_ASSET_FILTERING,
+	STAGE_COUNT
+};
+
+const char* STAGE_NAMES[STAGE_COUNT] = {
+		"MeshScanner ring",
+		"AD structure index",
+		"BackgroundAdvHandler",
+		"CommandAdvHandler",
+		"AssetFiltering",
+};
+
+/**
+ * Result of a simulated Crownstone, written by its process to shared memory.
+ */
+struct stone_result_t {
+	uint64_t numAdvertisements = 0;
+	uint64_t numDispatched     = 0;
+	uint64_t numBackgroundAdvs = 0;
+	uint64_t numDecryptions    = 0;
+	uint64_t numAccepted       = 0;
+	uint64_t numMeshMsgs       = 0;
+	uint64_t numUartMsgs       = 0;
+	uint64_t stageNs[STAGE_COUNT] = {};
+	double seconds                = 0;
+	size_t heapHighWatermark      = 0;
+};
+
+/**
+ * Handle the scheduled events, and execute the flash operations, until there is nothing left to do.
+ */
+void process() {
+	do {
+		app_sched_execute();
+	} while (HostFds::getInstance().process() > 0);
+}
+
+/**
+ * Counts the events that come out of the scan path.
+ */
+class ResultCounter : public EventListener {
+public:
+	ResultCounter(stone_result_t& result) : _result(result) {}
+
+	void init() {
+		listen({CS_TYPE::EVT_ADV_BACKGROUND_PARSED_V1,
+				CS_TYPE::EVT_ADV_BACKGROUND_PARSED,
+				CS_TYPE::EVT_ASSET_ACCEPTED,
+				CS_TYPE::CMD_SEND_MESH_MSG});
+	}
+
+	void handleEvent(event_t& event) override {
+		switch (event.type) {
+			case CS_TYPE::EVT_ADV_BACKGROUND_PARSED_V1:
+			case CS_TYPE::EVT_ADV_BACKGROUND_PARSED: {
+				_result.numBackgroundAdvs++;
+				break;
+			}
+			case CS_TYPE::EVT_ASSET_ACCEPTED: {
+				_result.numAccepted++;
+				break;
+			}
+			case CS_TYPE::CMD_SEND_MESH_MSG: {
+				_result.numMeshMsgs++;
+				break;
+			}
+			default: break;
+		}
+	}
+
+private:
+	stone_result_t& _result;
+};
+
+/**
+ * The scan path of a single Crownstone.
+ */
+class SimulatedStone {
+public:
+	static constexpr uint8_t RING_SIZE  = 64;
+	static constexpr uint8_t BATCH_SIZE = 8;
+
+	SimulatedStone(uint32_t coalesceWindowMs, stone_result_t& result)
+			: _coalesceWindowMs(coalesceWindowMs), _result(result), _resultCounter(result) {}
+
+	/**
+	 * Init the components, like the firmware does at boot.
+	 */
+	void init(uint8_t stoneId) {
+		TYPIFY(CONFIG_CROWNSTONE_ID) crownstoneId = stoneId;
+		State::getInstance().set(CS_TYPE::CONFIG_CROWNSTONE_ID, &crownstoneId, sizeof(crownstoneId));
+		process();
+
+		KeysAndAccess::getInstance().init();
+		RC5::getInstance().init();
+		BackgroundAdvertisementHandler::getInstance();
+		CommandAdvHandler::getInstance().init();
+		_trackedDevices.init();
+		cs_ret_code_t retCode = _assetFiltering.init();
+		assert(retCode == ERR_SUCCESS);
+		_resultCounter.init();
+		process();
+	}
+
+	/**
+	 * Upload and commit filters like a sphere with asset tracking: a cuckoo filter on the MAC address of the iBeacon
+	 * tags, an exact match filter on the manufacturer data of the fast tags, and an exclude filter on the Crownstone
+	 * service data.
+	 */
+	void uploadFilters(const vector<capture_adv_t>& capture) {
+		vector<vector<uint8_t>> tagAddresses;
+		vector<vector<uint8_t>> fastTagData;
+		for (auto& adv : capture) {
+			scanned_device_t device;
+			device.data     = const_cast<uint8_t*>(adv.data);
+			device.dataSize = adv.dataSize;
+			cs_data_t manufacturerData;
+			if (device.findAdvType(BLE_GAP_AD_TYPE_MANUFACTURER_SPECIFIC_DATA, &manufacturerData) != ERR_SUCCESS) {
+				continue;
+			}
+			if (manufacturerData.len == 25 && manufacturerData.data[0] == 0x4C && manufacturerData.data[2] == 0x02) {
+				tagAddresses.push_back(vector<uint8_t>(adv.address, adv.address + MAC_ADDRESS_LEN));
+			}
+			if (manufacturerData.data[0] == 0x59) {
+				fastTagData.push_back(vector<uint8_t>(manufacturerData.data, manufacturerData.data + manufacturerData.len));
+			}
+		}
+		sort(tagAddresses.begin(), tagAddresses.end());
+		tagAddresses.erase(unique(tagAddresses.begin(), tagAddresses.end()), tagAddresses.end());
+
+		vector<uint8_t> tagFilter = {
+				to_underlying_type(AssetFilterType::CuckooFilter),
+				0,  // Flags.
+				0,  // Profile id.
+				to_underlying_type(AssetFilterInputType::MacAddress),
+				to_underlying_type(AssetFilterOutputFormat::AssetIdNearest),
+				to_underlying_type(AssetFilterInputType::MacAddress),
+		};
+		size_t metadataSize = tagFilter.size();
+		tagFilter.resize(metadataSize + CuckooFilter::size(16, 4));
+		CuckooFilter cuckooFilter(reinterpret_cast<cuckoo_filter_data_t*>(tagFilter.data() + metadataSize));
+		cuckooFilter.init(16, 4);
+		for (auto& address : tagAddresses) {
+			bool added = cuckooFilter.add(address.data(), address.size());
+			assert(added);
+		}
+
+		vector<uint8_t> fastTagFilter = {
+				to_underlying_type(AssetFilterType::ExactMatchFilter),
+				0,
+				0,
+				to_underlying_type(AssetFilterInputType::AdDataType),
+				BLE_GAP_AD_TYPE_MANUFACTURER_SPECIFIC_DATA,
+				to_underlying_type(AssetFilterOutputFormat::Mac),
+		};
+		appendExactMatchFilter(fastTagData, fastTagFilter);
+
+		asset_filter_flags_t excludeFlags;
+		excludeFlags.flags.exclude = true;
+		vector<uint8_t> excludeFilter  = {
+				to_underlying_type(AssetFilterType::ExactMatchFilter),
+				excludeFlags.asInt,
+				0,
+				to_underlying_type(AssetFilterInputType::MaskedAdDataType),
+				0x16,  // Service data.
+				0x03,  // Mask of the first 2 bytes: the service UUID.
+				0,
+				0,
+				0,
+				to_underlying_type(AssetFilterOutputFormat::None),
+		};
+		appendExactMatchFilter({{0x01, 0xC0}}, excludeFilter);
+
+		vector<vector<uint8_t>> filters = {tagFilter, fastTagFilter, excludeFilter};
+		uint32_t masterCrc              = crc32(nullptr, 0);
+		for (uint8_t filterId = 0; filterId < filters.size(); ++filterId) {
+			auto& filter = filters[filterId];
+			assert(AssetFilterData(filter.data()).length() == filter.size());
+			vector<uint8_t> command(sizeof(asset_filter_cmd_upload_filter_t) + filter.size());
+			auto* upload            = reinterpret_cast<asset_filter_cmd_upload_filter_t*>(command.data());
+			upload->protocolVersion = ASSET_FILTER_CMD_PROTOCOL_VERSION;
+			upload->filterId        = filterId;
+			upload->chunkStartIndex = 0;
+			upload->totalSize       = filter.size();
+			upload->chunkSize       = filter.size();
+			memcpy(upload->chunk, filter.data(), filter.size());
+			event_t uploadEvent(CS_TYPE::CMD_UPLOAD_FILTER, command.data(), command.size());
+			uploadEvent.dispatch();
+			assert(uploadEvent.result.returnCode == ERR_SUCCESS);
+
+			uint32_t filterCrc = crc32(filter.data(), filter.size());
+			masterCrc          = crc32(&filterId, sizeof(filterId), &masterCrc);
+			masterCrc          = crc32(reinterpret_cast<uint8_t*>(&filterCrc), sizeof(filterCrc), &masterCrc);
+		}
+
+		TYPIFY(CMD_COMMIT_FILTER_CHANGES) commit;
+		commit.protocolVersion = ASSET_FILTER_CMD_PROTOCOL_VERSION;
+		commit.masterVersion   = 1;
+		commit.masterCrc       = masterCrc;
+		event_t commitEvent(CS_TYPE::CMD_COMMIT_FILTER_CHANGES, &commit, sizeof(commit));
+		commitEvent.dispatch();
+		assert(commitEvent.result.returnCode == ERR_SUCCESS);
+		process();
+	}
+
+	/**
+	 * Push an advertisement, like MeshScanner::onScan(), and dispatch when due.
+	 */
+	void onScan(const capture_adv_t& adv, uint32_t timeMs, int8_t rssiOffset) {
+		while (timeMs >= _nextTickMs) {
+			dispatch(_nextTickMs);
+			tick();
+		}
+		auto start = chrono::steady_clock::now();
+		scanned_device_t device;
+		memcpy(device.address, adv.address, sizeof(device.address));
+		device.resolvedPrivateAddress = false;
+		device.addressType            = CS_ADDRESS_TYPE_RANDOM_STATIC;
+		device.rssi                   = adv.rssi + rssiOffset;
+		device.channel                = adv.channel;
+		device.data                   = const_cast<uint8_t*>(adv.data);
+		device.dataSize               = adv.dataSize;
+		_ring.push(device, timeMs, _coalesceWindowMs);
+		_result.numAdvertisements++;
+		addTime(STAGE_MESH_SCANNER, start);
+
+		// Dispatch in batches, so that the time per component is not dominated by the time to read the clock.
+		// When coalescing, wait until the ring is half full, like MeshScanner does.
+		if (_ring.size() >= (_coalesceWindowMs == 0 ? BATCH_SIZE : RING_SIZE / 2)) {
+			dispatch(timeMs);
+		}
+	}
+
+	/**
+	 * Dispatch everything that's left.
+	 */
+	void flush() {
+		dispatch(_nextTickMs + _coalesceWindowMs);
+	}
+
+private:
+	uint32_t _coalesceWindowMs;
+	uint32_t _nextTickMs = TICK_INTERVAL_MS;
+	TYPIFY(EVT_TICK) _tickCount = 0;
+
+	stone_result_t& _result;
+
+	ScannedDeviceRing<RING_SIZE> _ring;
+
+	/**
+	 * Copies of the scanned devices of a batch, so that they can be popped from the ring.
+	 */
+	scanned_device_t _batch[BATCH_SIZE];
+	uint8_t _batchData[BATCH_SIZE][31];
+
+	TrackedDevices _trackedDevices;
+	AssetFiltering _assetFiltering;
+	ResultCounter _resultCounter;
+
+	void addTime(ScanStage stage, chrono::steady_clock::time_point& start) {
+		auto now = chrono::steady_clock::now();
+		_result.stageNs[stage] += chrono::duration_cast<chrono::nanoseconds>(now - start).count();
+		start = now;
+	}
+
+	static void appendExactMatchFilter(vector<vector<uint8_t>> items, vector<uint8_t>& filter) {
+		sort(items.begin(), items.end());
+		items.erase(unique(items.begin(), items.end()), items.end());
+		assert(!items.empty());
+		size_t itemSize = items[0].size();
+		filter.push_back(items.size());
+		filter.push_back(itemSize);
+		for (auto& item : items) {
+			assert(item.size() == itemSize);
+			filter.insert(filter.end(), item.begin(), item.end());
+		}
+	}
+
+	void tick() {
+		_tickCount++;
+		_nextTickMs += TICK_INTERVAL_MS;
+		event_t event(CS_TYPE::EVT_TICK, &_tickCount, sizeof(_tickCount));
+		event.dispatch();
+		process();
+	}
+
+	/**
+	 * Dispatch an event to a single listener.
+	 *
+	 * Same as EventDispatcher::dispatch() for a type with these listeners only, so that the time per component can
+	 * be measured.
+	 */
+	template <ScanStage stage>
+	void dispatchToListener(EventListener& listener, uint8_t batchSize, chrono::steady_clock::time_point& start) {
+		for (uint8_t i = 0; i < batchSize; ++i) {
+			event_t event(CS_TYPE::EVT_DEVICE_SCANNED, &_batch[i], sizeof(_batch[i]));
+			listener.handleEvent(event);
+		}
+		addTime(stage, start);
+	}
+
+	/**
+	 * Take batches out of the ring, like MeshScanner::dispatchScans(), and pass them through the components.
+	 */
+	void dispatch(uint32_t timeMs) {
+		while (true) {
+			auto start        = chrono::steady_clock::now();
+			uint8_t batchSize = 0;
+			while (batchSize < BATCH_SIZE && _ring.front(_batch[batchSize], timeMs, _coalesceWindowMs)) {
+				scanned_device_t& device = _batch[batchSize];
+				memcpy(_batchData[batchSize], device.data, device.dataSize);
+				device.data = _batchData[batchSize];
+				_ring.pop();
+				batchSize++;
+			}
+			addTime(STAGE_MESH_SCANNER, start);
+			if (batchSize == 0) {
+				return;
+			}
+			_result.numDispatched += batchSize;
+
+			// The first lookup builds the index, later lookups of all components use it.
+			cs_data_t found;
+			for (uint8_t i = 0; i < batchSize; ++i) {
+				_batch[i].findAdvType(BLE_GAP_AD_TYPE_FLAGS, &found);
+			}
+			addTime(STAGE_AD_INDEX, start);
+
+			// In the same order as the firmware registers the listeners.
+			dispatchToListener<STAGE_BACKGROUND_ADV>(BackgroundAdvertisementHandler::getInstance(), batchSize, start);
+			dispatchToListener<STAGE_COMMAND_ADV>(CommandAdvHandler::getInstance(), batchSize, start);
+			dispatchToListener<STAGE_ASSET_FILTERING>(_assetFiltering, batchSize, start);
+		}
+	}
+};
+
+/**
+ * Boot a simulated stone on a new flash image, and replay the capture through it.
+ *
+ * To be called in the process of the stone: the components are singletons.
+ */
+void runStone(
+		const vector<capture_adv_t>& capture,
+		uint32_t captureDurationMs,
+		uint32_t numReplays,
+		uint32_t coalesceWindowMs,
+		uint8_t stoneId,
+		stone_result_t& result) {
+	size_t heapBefore = heapUsed;
+	heapHighWatermark = heapUsed;
+
+	string flashPath = "/tmp/test_ScanPipeline_" + to_string(getpid()) + ".bin";
+	HostFds& fds     = HostFds::getInstance();
+	unlink(flashPath.c_str());
+	bool opened = fds.open(flashPath.c_str());
+	assert(opened);
+	cs_ret_code_t retCode = Storage::getInstance().init();
+	assert(retCode == ERR_SUCCESS);
+	process();
+	boards_config_t board;
+	memset(&board, 0, sizeof(board));
+	State::getInstance().init(&board);
+	assert(State::getInstance().isInitialized());
+
+	auto* stone = new SimulatedStone(coalesceWindowMs, result);
+	stone->init(stoneId);
+	stone->uploadFilters(capture);
+
+	numDecryptions = 0;
+	numUartMsgs    = 0;
+	auto start     = chrono::steady_clock::now();
+	for (uint32_t replay = 0; replay < numReplays; ++replay) {
+		uint32_t offsetMs = replay * captureDurationMs;
+		for (auto& adv : capture) {
+			stone->onScan(adv, offsetMs + adv.timeMs, stoneId % 7);
+		}
+	}
+	stone->flush();
+	result.seconds           = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	result.numDecryptions    = numDecryptions;
+	result.numUartMsgs       = numUartMsgs;
+	result.heapHighWatermark = heapHighWatermark - heapBefore;
+
+	fds.close();
+	unlink(flashPath.c_str());
+}
+
+/**
+ * Run a number of stones at once, each in its own process.
+ */
+vector<stone_result_t> runStones(
+		const vector<capture_adv_t>& capture,
+		uint32_t captureDurationMs,
+		uint32_t numReplays,
+		uint32_t coalesceWindowMs,
+		uint32_t numStones,
+		double& seconds) {
+	size_t resultsSize = numStones * sizeof(stone_result_t);
+	void* shared       = mmap(nullptr, resultsSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	assert(shared != MAP_FAILED);
+	auto* sharedResults = static_cast<stone_result_t*>(shared);
+
+	// Nothing should be left in the buffers, else each process would write it again.
+	cout.flush();
+	vector<pid_t> pids;
+	auto start = chrono::steady_clock::now();
+	for (uint32_t i = 0; i < numStones; ++i) {
+		pid_t pid = fork();
+		assert(pid >= 0);
+		if (pid == 0) {
+			stone_result_t result;
+			runStone(capture, captureDurationMs, numReplays, coalesceWindowMs, i + 1, result);
+			sharedResults[i] = result;
+			_exit(0);
+		}
+		pids.push_back(pid);
+	}
+	for (auto pid : pids) {
+		int status;
+		pid_t exited = waitpid(pid, &status, 0);
+		assert(exited == pid);
+		assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+	}
+	seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	vector<stone_result_t> results(sharedResults, sharedResults + numStones);
+	munmap(shared, resultsSize);
+	return results;
+}
+
+void printStages(const stone_result_t& result) {
+	uint64_t totalNs = 0;
+	for (auto ns : result.stageNs) {
+		totalNs += ns;
+	}
+	for (uint8_t stage = 0; stage < STAGE_COUNT; ++stage) {
+		cout << "  " << left << setw(22) << STAGE_NAMES[stage] << right << fixed << setprecision(1) << setw(8)
+				<< (double)result.stageNs[stage] / result.numAdvertisements << " ns/adv" << setw(7)
+				<< 100.0 * result.stageNs[stage] / totalNs << "%" << endl;
+	}
+}
+
+int main(int argc, char** argv) {
+	cout << "Test scan pipeline" << endl;
+	string fileName     = (argc > 1) ? argv[1] : "test/host/scans/office_1s.csv";
+	uint32_t maxStones  = (argc > 2) ? stoul(argv[2]) : max(1u, thread::hardware_concurrency());
+	uint32_t numReplays = (argc > 3) ? stoul(argv[3]) : 200;
+
+	vector<capture_adv_t> capture;
+	bool captureRead = readCapture(fileName, capture);
+	assert(captureRead);
+	uint32_t captureDurationMs = capture.back().timeMs + 1;
+	cout << "Replay " << numReplays << " times " << capture.size() << " advertisements (" << captureDurationMs
+			<< " ms) of " << fileName << endl;
+
+	// Each stone should come to the same results, no matter how many run at once.
+	double seconds;
+	stone_result_t single = runStones(capture, captureDurationMs, numReplays, 0, 1, seconds)[0];
+	assert(single.numAdvertisements == capture.size() * numReplays);
+	assert(single.numDispatched == single.numAdvertisements);
+	assert(single.numBackgroundAdvs > 0);
+	assert(single.numAccepted > 0 && single.numMeshMsgs > 0);
+	assert(single.heapHighWatermark > 0);
+
+	cout << endl << setw(8) << "stones" << setw(16) << "adv/s total" << setw(16) << "adv/s per stone" << setw(12)
+			<< "heap B" << endl;
+	// At least 2 stones, so that running multiple stones at once is always checked.
+	for (uint32_t numStones = 1; numStones <= max(maxStones, 2u); numStones *= 2) {
+		vector<stone_result_t> results = runStones(capture, captureDurationMs, numReplays, 0, numStones, seconds);
+		size_t heap = 0;
+		for (auto& result : results) {
+			assert(result.numDispatched == single.numDispatched);
+			assert(result.numBackgroundAdvs == single.numBackgroundAdvs);
+			assert(result.numDecryptions == single.numDecryptions);
+			assert(result.numAccepted == single.numAccepted);
+			heap = max(heap, result.heapHighWatermark);
+		}
+		double total = (double)numStones * single.numAdvertisements / seconds;
+		cout << setw(8) << numStones << setw(16) << (uint64_t)total << setw(16) << (uint64_t)(total / numStones)
+				<< setw(12) << heap << endl;
+	}
+
+	cout << endl << "Per component, no coalescing: " << single.numAccepted << " accepted, " << single.numMeshMsgs
+			<< " mesh messages" << endl;
+	printStages(single);
+
+	stone_result_t coalesced = runStones(capture, captureDurationMs, numReplays, 100, 1, seconds)[0];
+	cout << endl << "Per component, coalescing within 100 ms: " << coalesced.numDispatched << " of "
+			<< coalesced.numAdvertisements << " dispatched" << endl;
+	printStages(coalesced);
+	assert(coalesced.numDispatched <= coalesced.numAdvertisements);
+
+	cout << "Done" << endl;
+	return 0;
+}
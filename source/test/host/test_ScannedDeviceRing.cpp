@@ -0,0 +1,363 @@
+#define SERIAL_VERBOSITY SERIAL_NONE
+
+/**
+ * Tests the scanned device ring: order, coalescing, and dropping.
+ *
+ * Then replays a dense advertisement capture through the scan handling: dispatching each scan right away, like the
+ * mesh scanner did before, and through the ring, with and without coalescing.
+ */
+
+#include <structs/buffer/cs_ScannedDeviceRing.h>
+
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+typedef ScannedDeviceRing<16> TestRing;
+
+scanned_device_t makeScan(uint8_t addressByte, int8_t rssi, uint8_t channel, uint8_t* data, uint8_t dataSize) {
+	scanned_device_t device;
+	memset(device.address, addressByte, sizeof(device.address));
+	device.resolvedPrivateAddress = false;
+	device.addressType            = 1;
+	device.rssi                   = rssi;
+	device.channel                = channel;
+	device.data                   = data;
+	device.dataSize               = dataSize;
+	return device;
+}
+
+void testOrder() {
+	cout << "Check that scans come out in order, with a copy of their data." << endl;
+	TestRing ring;
+	uint8_t data[3] = {2, 1, 6};
+	for (uint8_t i = 0; i < 3; ++i) {
+		data[2] = i;
+		bool pushed = ring.push(makeScan(i, -50 - i, 37, data, sizeof(data)), 0, 0);
+		assert(pushed);
+	}
+	data[2] = 99;
+
+	scanned_device_t device;
+	for (uint8_t i = 0; i < 3; ++i) {
+		bool ready = ring.front(device, 0, 0);
+		assert(ready);
+		assert(device.address[0] == i);
+		assert(device.rssi == -50 - i);
+		assert(device.numScans == 1);
+		assert(device.rssiAverage == -50 - i);
+		assert(device.dataSize == 3 && device.data[2] == i);
+		ring.pop();
+	}
+	bool ready = ring.front(device, 0, 0);
+	assert(!ready);
+	assert(ring.getStats().numScans == 3);
+}
+
+void testCoalesce() {
+	cout << "Check that scans of the same device and data are coalesced within the window." << endl;
+	TestRing ring;
+	uint8_t data[4] = {3, 0xFF, 0x01, 0x02};
+	uint8_t otherData[4] = {3, 0xFF, 0x01, 0x03};
+	ring.push(makeScan(1, -70, 37, data, sizeof(data)), 100, 50);
+	ring.push(makeScan(2, -60, 37, data, sizeof(data)), 110, 50);
+	ring.push(makeScan(1, -60, 38, data, sizeof(data)), 120, 50);
+	ring.push(makeScan(1, -80, 39, data, sizeof(data)), 130, 50);
+	// Other data is not coalesced.
+	ring.push(makeScan(1, -40, 39, otherData, sizeof(otherData)), 140, 50);
+	// Outside the window of the first scan.
+	ring.push(makeScan(1, -75, 37, data, sizeof(data)), 151, 50);
+	assert(ring.size() == 4);
+	assert(ring.getStats().numCoalesced == 2);
+
+	// Not ready before it's as old as the window.
+	scanned_device_t device;
+	bool ready = ring.front(device, 149, 50);
+	assert(!ready);
+	ready = ring.front(device, 150, 50);
+	assert(ready);
+	assert(device.address[0] == 1);
+	assert(device.numScans == 3);
+	assert(device.rssi == -60);
+	assert(device.channel == 38);
+	assert(device.rssiAverage == -70);
+	ring.pop();
+
+	ready = ring.front(device, 1000, 50);
+	assert(ready);
+	assert(device.address[0] == 2 && device.numScans == 1);
+	ring.pop();
+	ready = ring.front(device, 1000, 50);
+	assert(ready);
+	assert(device.data[3] == 0x03);
+	ring.pop();
+	ready = ring.front(device, 1000, 50);
+	assert(ready);
+	assert(device.rssi == -75 && device.numScans == 1);
+	ring.pop();
+	assert(ring.size() == 0);
+}
+
+void testFull() {
+	cout << "Check that scans are dropped when the ring is full, and that a half full ring is ready." << endl;
+	TestRing ring;
+	uint8_t data[31] = {};
+	for (uint8_t i = 0; i < 16; ++i) {
+		bool pushed = ring.push(makeScan(i, -50, 37, data, sizeof(data)), 0, 100);
+		assert(pushed);
+	}
+	bool pushed = ring.push(makeScan(16, -50, 37, data, sizeof(data)), 0, 100);
+	assert(!pushed);
+	// Coalescing still works when full.
+	pushed = ring.push(makeScan(3, -50, 37, data, sizeof(data)), 0, 100);
+	assert(pushed);
+	assert(ring.getStats().numDropped == 1);
+	assert(ring.getStats().highWatermark == 16);
+
+	uint8_t tooLarge[32] = {};
+	scanned_device_t device;
+	bool ready = ring.front(device, 0, 100);
+	assert(ready);
+	ring.pop();
+	pushed = ring.push(makeScan(20, -50, 37, tooLarge, sizeof(tooLarge)), 0, 100);
+	assert(!pushed);
+
+	for (uint8_t i = 0; i < 8; ++i) {
+		ready = ring.front(device, 0, 100);
+		assert(ready);
+		ring.pop();
+	}
+	// Less than half full, so the window applies again.
+	ready = ring.front(device, 0, 100);
+	assert(!ready);
+}
+
+/**
+ * An advertiser in the capture.
+ */
+struct advertiser_t {
+	uint8_t address[MAC_ADDRESS_LEN];
+	// Advertising interval in ms.
+	uint32_t interval;
+	// Interval in ms at which the data changes, 0 for never.
+	uint32_t dataChangeInterval;
+	int8_t rssi;
+	vector<uint8_t> data;
+};
+
+struct capture_scan_t {
+	uint32_t timeMs;
+	uint16_t advertiser;
+	uint8_t channel;
+	int8_t rssi;
+	uint8_t dataCounter;
+};
+
+/**
+ * A capture of a busy office: beacons of assets advertising fast, phones, and crownstones.
+ *
+ * The scanner scans one channel at a time, so it sees most advertisements on 1 of the 3 channels.
+ */
+vector<advertiser_t> advertisers;
+
+vector<capture_scan_t> makeCapture(uint32_t durationMs) {
+	mt19937 random(42);
+	advertisers.clear();
+	auto addAdvertisers = [&](uint16_t count, uint32_t interval, uint32_t dataChangeInterval, vector<uint8_t> data) {
+		for (uint16_t i = 0; i < count; ++i) {
+			advertiser_t advertiser;
+			for (auto& byte : advertiser.address) {
+				byte = random();
+			}
+			advertiser.interval           = interval + random() % 10;
+			advertiser.dataChangeInterval = dataChangeInterval;
+			advertiser.rssi               = -40 - random() % 50;
+			advertiser.data               = data;
+			advertisers.push_back(advertiser);
+		}
+	};
+	// Asset tags: iBeacon at 100 ms.
+	addAdvertisers(40, 100, 0, {0x02, 0x01, 0x06, 0x1A, 0xFF, 0x4C, 0x00, 0x02, 0x15, 0xA6, 0x43, 0x80, 0x44, 0x6B, 0x24,
+			0x41, 0x0E, 0xA4, 0x7C, 0x6E, 0x4A, 0x06, 0x6D, 0xE5, 0x6F, 0x00, 0x01, 0x00, 0x02, 0xC4});
+	// Fast asset tags: 20 ms.
+	addAdvertisers(10, 20, 0, {0x02, 0x01, 0x06, 0x0B, 0xFF, 0x59, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08});
+	// Phones: data changes every second.
+	addAdvertisers(20, 200, 1000, {0x02, 0x01, 0x1A, 0x0A, 0xFF, 0x4C, 0x00, 0x10, 0x05, 0x0B, 0x1C, 0x6B, 0x3E, 0x91});
+	// Crownstones: service data changes every 500 ms.
+	addAdvertisers(30, 100, 500, {0x02, 0x01, 0x06, 0x03, 0x03, 0x01, 0xC0, 0x15, 0x16, 0x01, 0xC0, 0x05, 0x3D, 0x1A,
+			0x8B, 0x22, 0x01, 0x77, 0x31, 0x5C, 0x9E, 0x11, 0xA0, 0x42, 0x0F, 0x66, 0x10, 0x72, 0x4E});
+
+	vector<capture_scan_t> capture;
+	uniform_real_distribution<double> chance(0.0, 1.0);
+	normal_distribution<double> noise(0.0, 4.0);
+	for (uint32_t timeMs = 0; timeMs < durationMs; ++timeMs) {
+		// Scan window of 100 ms per channel.
+		uint8_t channel = 37 + (timeMs / 100) % 3;
+		for (uint16_t i = 0; i < advertisers.size(); ++i) {
+			const advertiser_t& advertiser = advertisers[i];
+			if ((timeMs + i * 7) % advertiser.interval != 0 || chance(random) > 0.8) {
+				continue;
+			}
+			uint8_t dataCounter = advertiser.dataChangeInterval ? timeMs / advertiser.dataChangeInterval : 0;
+			capture.push_back({timeMs, i, channel, (int8_t)(advertiser.rssi + noise(random)), dataCounter});
+		}
+	}
+	return capture;
+}
+
+/**
+ * Stands in for the handlers of the scanned device event: looks up a few AD types, and hashes the data.
+ */
+uint32_t numEvaluations = 0;
+
+__attribute__((noinline)) uint32_t evaluateScan(const scanned_device_t& device) {
+	numEvaluations++;
+	uint32_t hash = 5381;
+	cs_data_t found;
+	for (uint8_t type : {0xFF, 0x16, 0x09}) {
+		if (device.findAdvType(type, &found) == ERR_SUCCESS) {
+			for (uint8_t i = 0; i < found.len; ++i) {
+				hash = hash * 33 + found.data[i];
+			}
+		}
+	}
+	for (uint8_t i = 0; i < MAC_ADDRESS_LEN; ++i) {
+		hash = hash * 33 + device.address[i];
+	}
+	return hash + device.rssi;
+}
+
+struct replay_result_t {
+	uint32_t numEvaluations = 0;
+	uint32_t numDropped     = 0;
+	double nsPerScan        = 0;
+};
+
+/**
+ * Fills the scanned device like MeshScanner::onScan().
+ */
+void fillScan(const capture_scan_t& scan, uint8_t* data, scanned_device_t& device) {
+	const advertiser_t& advertiser = advertisers[scan.advertiser];
+	memcpy(device.address, advertiser.address, sizeof(device.address));
+	device.resolvedPrivateAddress = false;
+	device.addressType            = 1;
+	device.rssi                   = scan.rssi;
+	device.channel                = scan.channel;
+	device.dataSize               = advertiser.data.size();
+	memcpy(data, advertiser.data.data(), advertiser.data.size());
+	data[device.dataSize - 1] ^= scan.dataCounter;
+	device.data                   = data;
+}
+
+replay_result_t replayDirect(const vector<capture_scan_t>& capture) {
+	replay_result_t result;
+	numEvaluations = 0;
+	uint32_t checksum = 0;
+	uint8_t data[31];
+	auto start = chrono::steady_clock::now();
+	for (auto& scan : capture) {
+		scanned_device_t device;
+		fillScan(scan, data, device);
+		checksum += evaluateScan(device);
+	}
+	auto end = chrono::steady_clock::now();
+	assert(checksum != 1);
+	result.numEvaluations = numEvaluations;
+	result.nsPerScan      = chrono::duration<double>(end - start).count() / capture.size() * 1e9;
+	return result;
+}
+
+/**
+ * Same as MeshScanner: scans are pushed, and dispatched every tick of 100 ms, and when the ring is half full.
+ */
+template <uint8_t Capacity>
+replay_result_t replayRing(const vector<capture_scan_t>& capture, uint32_t coalesceWindowMs) {
+	const uint32_t tickMs = 100;
+	replay_result_t result;
+	numEvaluations = 0;
+	uint32_t checksum = 0;
+	ScannedDeviceRing<Capacity> ring;
+	uint8_t data[31];
+	scanned_device_t device;
+	auto dispatch = [&](uint32_t timeMs) {
+		while (ring.front(device, timeMs, coalesceWindowMs)) {
+			checksum += evaluateScan(device);
+			ring.pop();
+		}
+	};
+
+	auto start = chrono::steady_clock::now();
+	uint32_t nextTickMs = tickMs;
+	for (auto& scan : capture) {
+		while (scan.timeMs >= nextTickMs) {
+			dispatch(nextTickMs);
+			nextTickMs += tickMs;
+		}
+		scanned_device_t scanned;
+		fillScan(scan, data, scanned);
+		ring.push(scanned, scan.timeMs, coalesceWindowMs);
+		if (coalesceWindowMs == 0 || ring.size() >= Capacity / 2) {
+			// Dispatched soon after, by the app scheduler.
+			dispatch(scan.timeMs);
+		}
+	}
+	dispatch(nextTickMs + coalesceWindowMs);
+	auto end = chrono::steady_clock::now();
+	assert(checksum != 1);
+	assert(ring.size() == 0);
+	result.numEvaluations = numEvaluations;
+	result.numDropped     = ring.getStats().numDropped;
+	result.nsPerScan      = chrono::duration<double>(end - start).count() / capture.size() * 1e9;
+	return result;
+}
+
+void printResult(const char* name, const replay_result_t& result, uint32_t numScans) {
+	cout << "  " << left << setw(26) << name << right << fixed
+			<< " evaluations=" << setw(7) << result.numEvaluations
+			<< " (" << setprecision(1) << setw(5) << 100.0 * result.numEvaluations / numScans << "%)"
+			<< " dropped=" << setw(5) << result.numDropped
+			<< " cost=" << setw(6) << result.nsPerScan << " ns/scan" << endl;
+}
+
+void benchmark() {
+	const uint32_t durationMs = 60000;
+	vector<capture_scan_t> capture = makeCapture(durationMs);
+	cout << endl << "Replay of " << capture.size() << " scans of " << advertisers.size() << " advertisers in "
+			<< durationMs / 1000 << " s" << endl;
+
+	replay_result_t direct  = replayDirect(capture);
+	replay_result_t ring    = replayRing<16>(capture, 0);
+	replay_result_t ring16  = replayRing<16>(capture, 100);
+	replay_result_t ring64  = replayRing<64>(capture, 100);
+	replay_result_t ring128 = replayRing<128>(capture, 100);
+	replay_result_t ring200 = replayRing<200>(capture, 200);
+	printResult("dispatch each scan", direct, capture.size());
+	printResult("16, no coalescing", ring, capture.size());
+	printResult("16, coalesce 100 ms", ring16, capture.size());
+	printResult("64, coalesce 100 ms", ring64, capture.size());
+	printResult("128, coalesce 100 ms", ring128, capture.size());
+	printResult("200, coalesce 200 ms", ring200, capture.size());
+
+	assert(direct.numEvaluations == capture.size());
+	assert(ring.numEvaluations + ring.numDropped == capture.size());
+	assert(ring128.numEvaluations < ring.numEvaluations);
+	assert(ring200.numEvaluations < ring128.numEvaluations);
+}
+
+int main() {
+	cout << "Test scanned device ring" << endl;
+
+	testOrder();
+	testCoalesce();
+	testFull();
+	benchmark();
+
+	cout << "Done" << endl;
+	return 0;
+}
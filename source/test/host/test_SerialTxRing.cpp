@@ -0,0 +1,292 @@
+#define SERIAL_VERBOSITY SERIAL_DEBUG
+
+/**
+ * Tests the serial TX ring, and the UART frame writer, with a simulated UART as consumer.
+ */
+
+#include <structs/buffer/cs_SerialTxRing.h>
+#include <uart/cs_UartFrameWriter.h>
+
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+const uint16_t RING_SIZE = 1024;
+
+typedef SerialTxRing<RING_SIZE> Ring;
+
+/**
+ * Sink that writes to the ring, like cs_Serial does with the drop policy.
+ */
+class RingSink {
+public:
+	Ring& ring;
+	RingSink(Ring& ring) : ring(ring) {}
+
+	bool reserve(uint16_t size) {
+		if (ring.free() < size) {
+			ring.drop(size);
+			return false;
+		}
+		return true;
+	}
+
+	void write(const uint8_t* data, uint16_t size) { ring.write(data, size); }
+};
+
+/**
+ * Simulated UART: sends a number of bytes per tick, in chunks, like a DMA transfer would.
+ */
+class SimulatedUart {
+public:
+	vector<uint8_t> received;
+
+	void tick(Ring& ring, uint16_t numBytes) {
+		while (numBytes > 0) {
+			const uint8_t* data;
+			uint16_t chunk = ring.peek(data);
+			if (chunk == 0) {
+				return;
+			}
+			if (chunk > numBytes) {
+				chunk = numBytes;
+			}
+			received.insert(received.end(), data, data + chunk);
+			ring.pop(chunk);
+			numBytes -= chunk;
+		}
+	}
+};
+
+/**
+ * Decodes frames from the received bytes, like the UART library does.
+ */
+struct decoded_t {
+	vector<vector<uint8_t>> payloads;
+	int crcErrors = 0;
+};
+
+decoded_t decode(const vector<uint8_t>& bytes) {
+	decoded_t result;
+	size_t i = 0;
+	while (i < bytes.size()) {
+		if (bytes[i++] != UART_START_BYTE) {
+			continue;
+		}
+		vector<uint8_t> frame;
+		while (i < bytes.size() && bytes[i] != UART_START_BYTE) {
+			uint8_t val = bytes[i++];
+			if (val == UART_ESCAPE_BYTE) {
+				assert(i < bytes.size());
+				val = bytes[i++];
+				UartProtocol::unEscape(val);
+			}
+			frame.push_back(val);
+		}
+		uint16_t size = frame[0] | (frame[1] << 8);
+		assert(frame.size() == sizeof(uart_msg_size_header_t) + size);
+		uint16_t crc = UartProtocol::crc16(frame.data() + 2, frame.size() - 2 - sizeof(uart_msg_tail_t));
+		uint16_t tailCrc = frame[frame.size() - 2] | (frame[frame.size() - 1] << 8);
+		if (crc != tailCrc) {
+			result.crcErrors++;
+			continue;
+		}
+		size_t payloadStart = sizeof(uart_msg_size_header_t) + sizeof(uart_msg_wrapper_header_t);
+		result.payloads.emplace_back(frame.begin() + payloadStart, frame.end() - sizeof(uart_msg_tail_t));
+	}
+	return result;
+}
+
+/**
+ * Payloads with many bytes that need escaping.
+ */
+vector<uint8_t> createPayload(uint32_t index) {
+	vector<uint8_t> payload(rand() % 120);
+	for (auto& val : payload) {
+		switch (rand() % 4) {
+			case 0: val = UART_START_BYTE; break;
+			case 1: val = UART_ESCAPE_BYTE; break;
+			default: val = rand();
+		}
+	}
+	// Put the index in front, so dropped frames can be identified.
+	payload.insert(payload.begin(), reinterpret_cast<uint8_t*>(&index), reinterpret_cast<uint8_t*>(&index) + 4);
+	return payload;
+}
+
+void writeFrame(UartFrameWriter<RingSink>& writer, const vector<uint8_t>& payload) {
+	// Write in parts, like UartHandler does.
+	writer.start(UartMsgType::UART_MSG, payload.size());
+	uint16_t half = payload.size() / 2;
+	writer.write(payload.data(), half, true);
+	writer.write(payload.data() + half, payload.size() - half, true);
+	writer.end();
+}
+
+void testRing() {
+	cout << "Check the ring with wrap around and drops." << endl;
+	Ring ring;
+	assert(ring.empty());
+	assert(ring.free() == RING_SIZE);
+	vector<uint8_t> data(RING_SIZE + 100);
+	for (size_t i = 0; i < data.size(); ++i) {
+		data[i] = i;
+	}
+	uint16_t numWritten = ring.write(data.data(), RING_SIZE + 100);
+	assert(numWritten == RING_SIZE);
+	assert(ring.getDroppedBytes() == 100);
+	assert(ring.free() == 0);
+
+	// Read a part, and write again, so that the ring wraps.
+	const uint8_t* chunk;
+	uint16_t numPeeked = ring.peek(chunk);
+	assert(numPeeked == RING_SIZE);
+	assert(chunk[0] == 0);
+	ring.pop(300);
+	numWritten = ring.write(data.data(), 200);
+	assert(numWritten == 200);
+	assert(ring.size() == RING_SIZE - 100);
+	numPeeked = ring.peek(chunk);
+	assert(numPeeked == RING_SIZE - 300);
+	assert(chunk[0] == (uint8_t)300);
+	ring.pop(RING_SIZE - 300);
+	numPeeked = ring.peek(chunk);
+	assert(numPeeked == 200);
+	assert(chunk[199] == 199);
+	ring.pop(200);
+	assert(ring.empty());
+
+	// Free running indices wrap at 2^16.
+	for (int i = 0; i < 200; ++i) {
+		numWritten = ring.write(data.data(), 700);
+		assert(numWritten == 700);
+		vector<uint8_t> read;
+		while (!ring.empty()) {
+			uint16_t size = ring.peek(chunk);
+			read.insert(read.end(), chunk, chunk + size);
+			ring.pop(size);
+		}
+		assert(read == vector<uint8_t>(data.begin(), data.begin() + 700));
+	}
+	assert(ring.getDroppedBytes() == 100);
+}
+
+void testFrames() {
+	cout << "Check that frames are received intact, or dropped as a whole." << endl;
+	srand(1);
+	Ring ring;
+	RingSink sink(ring);
+	UartFrameWriter<RingSink> writer(sink);
+	SimulatedUart uart;
+	vector<vector<uint8_t>> sent;
+	int dropped = 0;
+	for (uint32_t i = 0; i < 20000; ++i) {
+		auto payload      = createPayload(i);
+		uint32_t before   = ring.getDroppedBytes();
+		writeFrame(writer, payload);
+		if (ring.getDroppedBytes() == before) {
+			sent.push_back(payload);
+		}
+		else {
+			dropped++;
+		}
+		// Sometimes the UART can't keep up.
+		uart.tick(ring, (i / 1000) % 2 ? 60 : 400);
+	}
+	uart.tick(ring, UINT16_MAX);
+
+	auto decoded = decode(uart.received);
+	assert(decoded.crcErrors == 0);
+	assert(decoded.payloads == sent);
+	assert(dropped > 0);
+	cout << "  " << sent.size() << " frames received, " << dropped << " dropped, " << ring.getDroppedBytes()
+		 << " bytes dropped" << endl;
+}
+
+void testThreads() {
+	cout << "Check the ring with a producer and consumer on different threads." << endl;
+	Ring ring;
+	const uint32_t numBytes = 1000000;
+	vector<uint8_t> received;
+	received.reserve(numBytes);
+	thread consumer([&]() {
+		while (received.size() < numBytes) {
+			const uint8_t* data;
+			uint16_t size = ring.peek(data);
+			if (size == 0) {
+				this_thread::yield();
+				continue;
+			}
+			received.insert(received.end(), data, data + size);
+			ring.pop(size);
+		}
+	});
+	uint8_t buffer[64];
+	uint32_t written = 0;
+	while (written < numBytes) {
+		uint16_t size = min<uint32_t>(1 + written % 64, numBytes - written);
+		for (uint16_t i = 0; i < size; ++i) {
+			buffer[i] = (written + i) * 7;
+		}
+		// Wait for space, so nothing is dropped.
+		while (ring.free() < size) {
+			this_thread::yield();
+		}
+		ring.write(buffer, size);
+		written += size;
+	}
+	consumer.join();
+	for (uint32_t i = 0; i < numBytes; ++i) {
+		assert(received[i] == (uint8_t)(i * 7));
+	}
+	assert(ring.getDroppedBytes() == 0);
+}
+
+void benchmark() {
+	cout << endl << "Frame writing throughput" << endl;
+	srand(2);
+	vector<vector<uint8_t>> payloads;
+	size_t totalSize = 0;
+	for (uint32_t i = 0; i < 1000; ++i) {
+		payloads.push_back(createPayload(i));
+		totalSize += payloads.back().size();
+	}
+	Ring ring;
+	RingSink sink(ring);
+	UartFrameWriter<RingSink> writer(sink);
+	const int iterations = 100;
+	auto start           = chrono::steady_clock::now();
+	for (int i = 0; i < iterations; ++i) {
+		for (auto& payload : payloads) {
+			writeFrame(writer, payload);
+			const uint8_t* data;
+			uint16_t size;
+			while ((size = ring.peek(data)) != 0) {
+				ring.pop(size);
+			}
+		}
+	}
+	auto end       = chrono::steady_clock::now();
+	double seconds = chrono::duration<double>(end - start).count();
+	cout << "  " << fixed << setprecision(1) << (double)totalSize * iterations / seconds / 1e6
+		 << " MB/s of payload, " << seconds / iterations / payloads.size() * 1e9 << " ns per frame" << endl;
+	assert(ring.getDroppedBytes() == 0);
+}
+
+int main() {
+	cout << "Test serial TX ring" << endl;
+
+	testRing();
+	testFrames();
+	testThreads();
+	benchmark();
+
+	cout << "Done" << endl;
+	return 0;
+}
@@ -0,0 +1,182 @@
+#define SERIAL_VERBOSITY SERIAL_DEBUG
+
+#include <processing/cs_SlidingMedianFilter.h>
+#include <third/SortMedian.h>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+const uint16_t NUM_SAMPLES = 100;
+
+/**
+ * Same as PowerSampling::filter() did: pad the input, and run sort_median.
+ */
+vector<int16_t> sortMedianReference(const vector<int16_t>& input, unsigned half) {
+	unsigned windowSize = 2 * half + 1;
+	unsigned blockCount = (input.size() + half * 2) / windowSize;
+	assert((input.size() + half * 2) % windowSize == 0);
+	MedianFilter filterParams(half, blockCount);
+	PowerVector inputSamples;
+	inputSamples.insert(inputSamples.end(), half, input.front());
+	inputSamples.insert(inputSamples.end(), input.begin(), input.end());
+	inputSamples.insert(inputSamples.end(), half, input.back());
+	PowerVector outputSamples(input.size());
+	sort_median(filterParams, inputSamples, outputSamples);
+	return vector<int16_t>(outputSamples.begin(), outputSamples.end());
+}
+
+/**
+ * Sorts every window, for any window size.
+ */
+vector<int16_t> naiveReference(const vector<int16_t>& input, int half) {
+	int count = input.size();
+	vector<int16_t> output(count);
+	for (int i = 0; i < count; ++i) {
+		vector<int16_t> window;
+		for (int j = i - half; j <= i + half; ++j) {
+			window.push_back(input[max(0, min(count - 1, j))]);
+		}
+		sort(window.begin(), window.end());
+		output[i] = window[half];
+	}
+	return output;
+}
+
+/**
+ * A period of a sine with noise, spikes, and a flat (clipped) part, so there are many equal values.
+ */
+vector<int16_t> createSamples(size_t count) {
+	vector<int16_t> samples(count);
+	double phase = (rand() % 1000) / 1000.0 * 2 * M_PI;
+	for (size_t i = 0; i < count; ++i) {
+		double value = 2000 + 1500 * sin(phase + 2 * M_PI * i / NUM_SAMPLES) + (rand() % 21) - 10;
+		if (rand() % 20 == 0) {
+			value += (rand() % 4001) - 2000;
+		}
+		samples[i] = max(0.0, min(3000.0, round(value)));
+	}
+	return samples;
+}
+
+/**
+ * Filters interleaved samples, with the given channel, in place.
+ */
+template <uint16_t Half>
+vector<int16_t> filterInterleaved(const vector<int16_t>& input, uint8_t channel) {
+	vector<int16_t> interleaved(2 * input.size());
+	for (size_t i = 0; i < input.size(); ++i) {
+		interleaved[2 * i + channel]     = input[i];
+		interleaved[2 * i + 1 - channel] = -1;
+	}
+	SlidingMedianFilter<int16_t, Half> filter;
+	filter.run(interleaved.data() + channel, interleaved.data() + channel, input.size(), 2);
+	vector<int16_t> output(input.size());
+	for (size_t i = 0; i < input.size(); ++i) {
+		assert(interleaved[2 * i + 1 - channel] == -1);
+		output[i] = interleaved[2 * i + channel];
+	}
+	return output;
+}
+
+template <uint16_t Half>
+void testWindow(bool compareSortMedian) {
+	for (int run = 0; run < 50; ++run) {
+		auto input = createSamples(NUM_SAMPLES);
+
+		vector<int16_t> output(NUM_SAMPLES);
+		SlidingMedianFilter<int16_t, Half> filter;
+		filter.run(input.data(), output.data(), NUM_SAMPLES);
+
+		assert(output == naiveReference(input, Half));
+		if (compareSortMedian) {
+			assert(output == sortMedianReference(input, Half));
+		}
+		assert(filterInterleaved<Half>(input, 0) == output);
+		assert(filterInterleaved<Half>(input, 1) == output);
+	}
+
+	// Short inputs.
+	for (uint16_t count = 1; count < 3 * Half; ++count) {
+		auto input = createSamples(count);
+		vector<int16_t> output(count);
+		SlidingMedianFilter<int16_t, Half> filter;
+		filter.run(input.data(), output.data(), count);
+		assert(output == naiveReference(input, Half));
+	}
+}
+
+void testSameResults() {
+	cout << "Check that the filter gives the same results as sort_median." << endl;
+	srand(1);
+	// Window sizes where the padded input is a multiple of the window size, as sort_median requires.
+	testWindow<1>(true);
+	testWindow<5>(true);
+	testWindow<16>(true);
+	testWindow<49>(true);
+
+	cout << "Check other window sizes against sorting each window." << endl;
+	testWindow<2>(false);
+	testWindow<3>(false);
+	testWindow<7>(false);
+	testWindow<10>(false);
+}
+
+template <class Function>
+double measure(Function function) {
+	const int iterations = 20000;
+	auto start           = chrono::steady_clock::now();
+	for (int i = 0; i < iterations; ++i) {
+		function();
+	}
+	auto end = chrono::steady_clock::now();
+	return chrono::duration<double>(end - start).count() / iterations * 1e6;
+}
+
+template <uint16_t Half>
+void benchmarkWindow() {
+	auto input = createSamples(NUM_SAMPLES);
+	vector<int16_t> interleaved(2 * NUM_SAMPLES);
+	for (size_t i = 0; i < NUM_SAMPLES; ++i) {
+		interleaved[2 * i] = input[i];
+	}
+	volatile int16_t sink = 0;
+
+	cout << setw(8) << Half << fixed << setprecision(2);
+	cout << setw(14) << measure([&]() {
+		// Includes the copies that PowerSampling::filter() did.
+		auto output = sortMedianReference(input, Half);
+		sink        = output[0];
+	});
+	SlidingMedianFilter<int16_t, Half> filter;
+	cout << setw(14) << measure([&]() {
+		filter.run(interleaved.data(), interleaved.data() + 1, NUM_SAMPLES, 2);
+		sink = interleaved[1];
+	});
+	cout << endl;
+}
+
+void benchmark() {
+	cout << endl << "Microseconds per channel of " << NUM_SAMPLES << " samples" << endl;
+	cout << setw(8) << "half" << setw(14) << "sort_median" << setw(14) << "sliding" << endl;
+	// Half window sizes of POWER_SAMPLING_CURVE_HALF_WINDOW_SIZE, current and previously used.
+	benchmarkWindow<5>();
+	benchmarkWindow<16>();
+}
+
+int main() {
+	cout << "Test sliding median filter" << endl;
+
+	testSameResults();
+	benchmark();
+
+	cout << "Done" << endl;
+	return 0;
+}
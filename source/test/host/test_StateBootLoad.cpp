@@ -0,0 +1,335 @@
+#define SERIAL_VERBOSITY SERIAL_NONE
+
+/**
+ * Loads the stored values of State at boot, on a populated flash image of the host FDS.
+ *
+ * First compares the flash work of two ways to load the values with Storage:
+ * - Per type: Storage::read() for each type with a single id, and Storage::findFirst() and findNext() followed by
+ *   Storage::read() for each id of types with multiple ids. Each of these walks over all records.
+ * - Single pass: Storage::readAll(), which walks over all records once.
+ *
+ * Then checks that State::init() loads all values in a single pass: the latest of duplicate records, without values of
+ * the wrong size, and with the ids of each type cached, so that nothing is read from flash afterwards.
+ */
+
+#include <drivers/cs_Storage.h>
+#include <host/cs_HostFds.h>
+#include <storage/cs_State.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+char flashPath[] = "/tmp/test_StateBootLoad_XXXXXX";
+
+typedef map<pair<CS_TYPE, cs_state_id_t>, vector<uint8_t>> values_t;
+
+struct load_stats_t {
+	uint32_t headersRead;
+	double us;
+};
+
+//! Types that are written by hand, to test how they are loaded.
+const CS_TYPE DUPLICATE_TYPE      = CS_TYPE::CONFIG_MAX_CHIP_TEMP;
+const CS_TYPE WRONG_SIZE_TYPE     = CS_TYPE::CONFIG_BOOT_DELAY;
+const CS_TYPE WRONG_ID_TYPE       = CS_TYPE::CONFIG_CROWNSTONE_ID;
+const CS_TYPE DUPLICATE_ID_TYPE   = CS_TYPE::STATE_IBEACON_CONFIG_ID;
+const CS_TYPE NOT_STORED_IDS_TYPE = CS_TYPE::STATE_TWILIGHT_RULE;
+
+/**
+ * Handle the scheduled events, and execute the flash operations, until there is nothing left to do.
+ */
+void process() {
+	do {
+		app_sched_execute();
+	} while (HostFds::getInstance().process() > 0);
+}
+
+uint16_t getNumWords(CS_TYPE type) {
+	return (TypeSize(type) + 3) / 4;
+}
+
+/**
+ * All types that State stores in flash.
+ */
+vector<CS_TYPE> getStoredTypes() {
+	vector<CS_TYPE> types;
+	for (uint16_t recordKey = 1; recordKey < InternalBase; ++recordKey) {
+		CS_TYPE type = CS_TYPE(recordKey);
+		if (TypeSize(type) != 0 && DefaultLocation(type) == PersistenceMode::FLASH) {
+			types.push_back(type);
+		}
+	}
+	return types;
+}
+
+/**
+ * Write a record directly with FDS: an update of the last record of this type and id, or a new record.
+ */
+void writeRecord(uint16_t fileId, CS_TYPE type, const vector<uint32_t>& data, bool update) {
+	fds_record_t record;
+	record.file_id           = fileId;
+	record.key               = to_underlying_type(type);
+	record.data.p_data       = data.data();
+	record.data.length_words = data.size();
+	fds_record_desc_t desc;
+	fds_find_token_t token;
+	memset(&token, 0, sizeof(token));
+	bool found = false;
+	while (update && fds_record_find(record.file_id, record.key, &desc, &token) == NRF_SUCCESS) {
+		found = true;
+	}
+	ret_code_t nrfCode = found ? fds_record_update(&desc, &record) : fds_record_write(&desc, &record);
+	assert(nrfCode == NRF_SUCCESS);
+	process();
+}
+
+/**
+ * Write a value of a type, and return the value as it should be loaded.
+ */
+vector<uint8_t> writeValue(CS_TYPE type, cs_state_id_t id, mt19937& rng, bool update = true) {
+	vector<uint32_t> data(getNumWords(type));
+	for (auto& word : data) {
+		word = rng();
+	}
+	writeRecord(FILE_CONFIGURATION + id, type, data, update);
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data.data());
+	return vector<uint8_t>(bytes, bytes + TypeSize(type));
+}
+
+/**
+ * Write the values of most types, some of them a few times, like a crownstone that has been in use.
+ * Then write the records that should be handled with care.
+ */
+values_t populate(const vector<CS_TYPE>& types) {
+	HostFds& fds = HostFds::getInstance();
+	unlink(flashPath);
+	bool opened = fds.open(flashPath);
+	assert(opened);
+	ret_code_t nrfCode = fds_init();
+	assert(nrfCode == NRF_SUCCESS);
+	process();
+
+	mt19937 rng(5678);
+	values_t values;
+	map<CS_TYPE, vector<cs_state_id_t>> ids;
+	for (auto type : types) {
+		if (type == DUPLICATE_TYPE || type == WRONG_SIZE_TYPE || type == WRONG_ID_TYPE || type == DUPLICATE_ID_TYPE
+			|| type == NOT_STORED_IDS_TYPE) {
+			continue;
+		}
+		if (!hasMultipleIds(type)) {
+			if (rng() % 3 == 0) {
+				ids[type].push_back(0);
+			}
+			continue;
+		}
+		for (uint16_t i = 1 + rng() % 6; i > 0; --i) {
+			cs_state_id_t id = rng() % 20;
+			if (find(ids[type].begin(), ids[type].end(), id) == ids[type].end()) {
+				ids[type].push_back(id);
+			}
+		}
+	}
+	for (uint32_t round = 0; round < 3; ++round) {
+		for (auto& typeIds : ids) {
+			for (auto id : typeIds.second) {
+				if (round == 0 || rng() % 4 == 0) {
+					values[make_pair(typeIds.first, id)] = writeValue(typeIds.first, id, rng);
+				}
+			}
+		}
+	}
+
+	// Two valid records of the same type and id, like after a reset during an update: the last one is used.
+	writeValue(DUPLICATE_TYPE, 0, rng, false);
+	values[make_pair(DUPLICATE_TYPE, 0)] = writeValue(DUPLICATE_TYPE, 0, rng, false);
+	writeValue(DUPLICATE_ID_TYPE, 1, rng, false);
+	values[make_pair(DUPLICATE_ID_TYPE, 1)] = writeValue(DUPLICATE_ID_TYPE, 1, rng, false);
+
+	// A value of an older firmware with a different size, and an id for a type without ids: both are not used.
+	writeRecord(FILE_CONFIGURATION, WRONG_SIZE_TYPE, vector<uint32_t>(getNumWords(WRONG_SIZE_TYPE) + 1, 1), false);
+	writeValue(WRONG_ID_TYPE, 5, rng);
+
+	// The old reset counter, in a file that is not of State.
+	writeRecord(FILE_KEEP_FOREVER, CS_TYPE::STATE_RESET_COUNTER, vector<uint32_t>(1, 3), false);
+
+	fds_stat_t stat;
+	nrfCode = fds_stat(&stat);
+	assert(nrfCode == NRF_SUCCESS);
+	cout << "Flash image: " << stat.valid_records << " records, " << stat.dirty_records << " dirty records, "
+		 << stat.words_used << " words used, " << values.size() << " values" << endl;
+	fds.close();
+	return values;
+}
+
+/**
+ * Like State::get() for a value that is not in RAM: the latest record, if it has the right size.
+ */
+bool read(CS_TYPE type, cs_state_id_t id, vector<uint8_t>& value) {
+	vector<uint32_t> buf(getNumWords(type));
+	cs_state_data_t data(type, id, reinterpret_cast<uint8_t*>(buf.data()), TypeSize(type));
+	if (Storage::getInstance().read(data) != ERR_SUCCESS) {
+		return false;
+	}
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(buf.data());
+	value.assign(bytes, bytes + TypeSize(type));
+	return true;
+}
+
+values_t loadPerType(const vector<CS_TYPE>& types) {
+	Storage& storage = Storage::getInstance();
+	values_t values;
+	vector<uint8_t> value;
+	for (auto type : types) {
+		vector<cs_state_id_t> ids(1, 0);
+		if (hasMultipleIds(type)) {
+			// Like State::getIdsFromFlash() without loading all values first.
+			ids.clear();
+			cs_state_id_t id;
+			cs_ret_code_t retCode = storage.findFirst(type, id);
+			while (retCode == ERR_SUCCESS) {
+				if (find(ids.begin(), ids.end(), id) == ids.end()) {
+					ids.push_back(id);
+				}
+				retCode = storage.findNext(type, id);
+			}
+			assert(retCode == ERR_NOT_FOUND);
+		}
+		for (auto id : ids) {
+			if (read(type, id, value)) {
+				values[make_pair(type, id)] = value;
+			}
+		}
+	}
+	return values;
+}
+
+uint32_t numReadAllValues = 0;
+
+void countValue(const cs_state_data_t&) {
+	numReadAllValues++;
+}
+
+template <class Loader>
+load_stats_t measure(const char* name, Loader loader) {
+	const uint32_t numRuns = 200;
+	load_stats_t stats     = {0, 0};
+	HostFds::getInstance().resetStats();
+	loader();
+	stats.headersRead = HostFds::getInstance().getStats().headersRead;
+
+	auto start = chrono::steady_clock::now();
+	for (uint32_t i = 0; i < numRuns; ++i) {
+		loader();
+	}
+	stats.us = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / numRuns;
+	cout << setw(12) << name << setw(14) << stats.headersRead << setw(12) << fixed << setprecision(1) << stats.us << endl;
+	return stats;
+}
+
+/**
+ * Get a value of State, which should be in RAM.
+ */
+vector<uint8_t> get(CS_TYPE type, cs_state_id_t id, PersistenceMode mode = PersistenceMode::STRATEGY1) {
+	vector<uint32_t> buf(getNumWords(type));
+	cs_state_data_t data(type, id, reinterpret_cast<uint8_t*>(buf.data()), TypeSize(type));
+	cs_ret_code_t retCode = State::getInstance().get(data, mode);
+	assert(retCode == ERR_SUCCESS);
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(buf.data());
+	return vector<uint8_t>(bytes, bytes + TypeSize(type));
+}
+
+void testState(const vector<CS_TYPE>& types, const values_t& expected, const load_stats_t& singlePass) {
+	cout << "testState" << endl;
+	HostFds& fds = HostFds::getInstance();
+	State& state = State::getInstance();
+	boards_config_t board;
+	memset(&board, 0, sizeof(board));
+	fds.resetStats();
+	state.init(&board);
+	assert(state.isInitialized());
+	assert(state.getNumLoadedValues() == expected.size());
+	assert(fds.getStats().headersRead == singlePass.headersRead);
+
+	// All values and ids come from RAM now.
+	fds.resetStats();
+	for (auto& value : expected) {
+		assert(get(value.first.first, value.first.second) == value.second);
+	}
+	for (auto type : types) {
+		if (!hasMultipleIds(type)) {
+			continue;
+		}
+		vector<cs_state_id_t> expectedIds;
+		for (auto& value : expected) {
+			if (value.first.first == type) {
+				expectedIds.push_back(value.first.second);
+			}
+		}
+		vector<cs_state_id_t>* ids = nullptr;
+		cs_ret_code_t retCode = state.getIds(type, ids);
+		assert(retCode == ERR_SUCCESS);
+		vector<cs_state_id_t> sortedIds = *ids;
+		sort(sortedIds.begin(), sortedIds.end());
+		assert(sortedIds == expectedIds);
+	}
+	assert(find(types.begin(), types.end(), NOT_STORED_IDS_TYPE) != types.end());
+
+	// Values that were not loaded get the default, without searching flash.
+	assert(expected.count(make_pair(WRONG_SIZE_TYPE, 0)) == 0);
+	assert(get(WRONG_SIZE_TYPE, 0) == get(WRONG_SIZE_TYPE, 0, PersistenceMode::FIRMWARE_DEFAULT));
+	assert(get(WRONG_ID_TYPE, 0) == get(WRONG_ID_TYPE, 0, PersistenceMode::FIRMWARE_DEFAULT));
+	assert(fds.getStats().headersRead == 0);
+}
+
+int main() {
+	int fd = mkstemp(flashPath);
+	assert(fd >= 0);
+	close(fd);
+
+	vector<CS_TYPE> types = getStoredTypes();
+	values_t expected     = populate(types);
+
+	// Boot.
+	HostFds& fds = HostFds::getInstance();
+	bool opened = fds.open(flashPath);
+	assert(opened);
+	Storage& storage = Storage::getInstance();
+	cs_ret_code_t retCode = storage.init();
+	assert(retCode == ERR_SUCCESS);
+	process();
+	assert(storage.isInitialized());
+
+	assert(loadPerType(types) == expected);
+	fds_stat_t stat;
+	ret_code_t nrfCode = fds_stat(&stat);
+	assert(nrfCode == NRF_SUCCESS);
+	numReadAllValues = 0;
+	retCode = storage.readAll(countValue);
+	assert(retCode == ERR_SUCCESS);
+	// All records, except the one that is not of State.
+	assert(numReadAllValues == stat.valid_records - 1u);
+
+	cout << setw(12) << "loader" << setw(14) << "headers read" << setw(12) << "host us" << endl;
+	load_stats_t perType    = measure("per type", [&]() { loadPerType(types); });
+	load_stats_t singlePass = measure("single pass", [&]() { storage.readAll(countValue); });
+	assert(singlePass.headersRead * 20 < perType.headersRead);
+
+	testState(types, expected, singlePass);
+
+	fds.close();
+	unlink(flashPath);
+	cout << "Done" << endl;
+	return 0;
+}
@@ -0,0 +1,165 @@
+#define SERIAL_VERBOSITY SERIAL_DEBUG
+
+#include <storage/cs_StateRamIndex.h>
+
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Same fields as used for lookup in cs_state_data_t.
+ */
+struct ram_data_t {
+	uint16_t type;
+	cs_state_id_t id;
+	uint32_t value;
+};
+
+/**
+ * Register like in State: a vector of data, plus the index. Removal moves the last item into the hole.
+ */
+class Register {
+public:
+	vector<ram_data_t> data;
+	StateRamIndex index;
+
+	uint16_t findLinear(uint16_t type, cs_state_id_t id) {
+		for (uint16_t i = 0; i < data.size(); ++i) {
+			if (data[i].type == type && data[i].id == id) {
+				return i;
+			}
+		}
+		return StateRamIndex::NOT_FOUND;
+	}
+
+	void add(uint16_t type, cs_state_id_t id, uint32_t value) {
+		data.push_back({type, id, value});
+		bool added = index.set(type, id, data.size() - 1);
+		assert(added);
+	}
+
+	void remove(uint16_t type, cs_state_id_t id) {
+		uint16_t i = index.find(type, id);
+		if (i == StateRamIndex::NOT_FOUND) {
+			return;
+		}
+		index.remove(type, id);
+		uint16_t last = data.size() - 1;
+		if (i != last) {
+			data[i] = data[last];
+			index.set(data[i].type, data[i].id, i);
+		}
+		data.pop_back();
+	}
+
+	void check() {
+		assert(index.size() == data.size());
+		for (uint16_t i = 0; i < data.size(); ++i) {
+			assert(index.find(data[i].type, data[i].id) == i);
+		}
+	}
+};
+
+/**
+ * Keys like in the real state: a range of types, some of which have multiple ids.
+ */
+void getKey(int n, uint16_t& type, cs_state_id_t& id) {
+	type = 1 + (n % 97) * 3;
+	id = n / 97;
+}
+
+void testRandomOperations() {
+	cout << "Randomly add and remove items, and check the index after every operation." << endl;
+	Register reg;
+	srand(1);
+	for (int i = 0; i < 20000; ++i) {
+		uint16_t type;
+		cs_state_id_t id;
+		getKey(rand() % 600, type, id);
+		if (rand() % 3 == 0) {
+			reg.remove(type, id);
+			assert(reg.index.find(type, id) == StateRamIndex::NOT_FOUND);
+		}
+		else if (reg.index.find(type, id) == StateRamIndex::NOT_FOUND) {
+			reg.add(type, id, i);
+		}
+		if (i % 100 == 0) {
+			reg.check();
+		}
+	}
+	reg.check();
+
+	cout << "Remove all items." << endl;
+	while (!reg.data.empty()) {
+		reg.remove(reg.data[0].type, reg.data[0].id);
+	}
+	reg.check();
+	assert(reg.index.size() == 0);
+}
+
+void benchmark(int numEntries) {
+	Register reg;
+	for (int i = 0; i < numEntries; ++i) {
+		uint16_t type;
+		cs_state_id_t id;
+		getKey(i, type, id);
+		reg.add(type, id, i);
+	}
+	reg.check();
+
+	const int numLookups = 1000000;
+	vector<int> keys;
+	srand(2);
+	for (int i = 0; i < numLookups; ++i) {
+		keys.push_back(rand() % numEntries);
+	}
+
+	uint32_t sumLinear = 0;
+	uint32_t sumIndexed = 0;
+	auto t0 = chrono::steady_clock::now();
+	for (int n : keys) {
+		uint16_t type;
+		cs_state_id_t id;
+		getKey(n, type, id);
+		sumLinear += reg.data[reg.findLinear(type, id)].value;
+	}
+	auto t1 = chrono::steady_clock::now();
+	for (int n : keys) {
+		uint16_t type;
+		cs_state_id_t id;
+		getKey(n, type, id);
+		sumIndexed += reg.data[reg.index.find(type, id)].value;
+	}
+	auto t2 = chrono::steady_clock::now();
+	for (int n : keys) {
+		uint16_t type;
+		cs_state_id_t id;
+		getKey(n, type, id);
+		// A set is a lookup followed by a write.
+		reg.data[reg.index.find(type, id)].value = n;
+	}
+	auto t3 = chrono::steady_clock::now();
+	assert(sumLinear == sumIndexed);
+
+	cout << numEntries << " entries:" << endl;
+	cout << "  linear get:  " << chrono::duration<double, nano>(t1 - t0).count() / numLookups << " ns" << endl;
+	cout << "  indexed get: " << chrono::duration<double, nano>(t2 - t1).count() / numLookups << " ns" << endl;
+	cout << "  indexed set: " << chrono::duration<double, nano>(t3 - t2).count() / numLookups << " ns" << endl;
+}
+
+int main() {
+	cout << "Test StateRamIndex" << endl;
+
+	testRandomOperations();
+
+	benchmark(50);
+	benchmark(200);
+	benchmark(1000);
+
+	cout << "Done" << endl;
+	return 0;
+}
@@ -0,0 +1,513 @@
+#define SERIAL_VERBOSITY SERIAL_NONE
+
+/**
+ * Tests the store queue of State, with a simulated storage that is sometimes busy.
+ *
+ * The queue is compared with the previous implementation: a vector of which every item is visited each tick. Both
+ * should perform the same flash operations at the same ticks.
+ *
+ * Then measures the flash writes saved by delayed and throttled writes, and the time spent per tick.
+ */
+
+#include <cfg/cs_Config.h>
+#include <protocol/cs_ErrorCodes.h>
+#include <storage/cs_StateStoreQueue.h>
+
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace std;
+
+const uint32_t RETRY_COUNTER = STATE_RETRY_STORE_DELAY_MS / TICK_INTERVAL_MS;
+const uint16_t TYPE_NONE     = 0;
+
+/**
+ * A flash operation, as performed on the simulated storage.
+ */
+struct flash_op_t {
+	uint32_t tickCount;
+	char operation;
+	uint16_t type;
+	cs_state_id_t id;
+	cs_ret_code_t result;
+
+	bool operator==(const flash_op_t& other) const {
+		return tickCount == other.tickCount && operation == other.operation && type == other.type && id == other.id
+			   && result == other.result;
+	}
+};
+
+/**
+ * Storage that is busy at some ticks, for some types.
+ *
+ * Whether it's busy only depends on tick count, operation, type and id, so that the order in which items are executed
+ * during a tick does not matter.
+ */
+class SimulatedStorage {
+public:
+	uint32_t busyPercentage = 0;
+	uint32_t tickCount      = 0;
+	vector<flash_op_t> log;
+	uint32_t numWrites = 0;
+
+	cs_ret_code_t perform(char operation, uint16_t type, cs_state_id_t id) {
+		uint32_t hash = (tickCount * 2654435761u) ^ (type * 40503u) ^ (id * 97u) ^ operation;
+		hash ^= hash >> 13;
+		hash *= 0x5bd1e995;
+		hash ^= hash >> 15;
+		cs_ret_code_t result = (hash % 100 < busyPercentage) ? ERR_BUSY : ERR_SUCCESS;
+		log.push_back({tickCount, operation, type, id, result});
+		if (operation == 'w' && result == ERR_SUCCESS) {
+			numWrites++;
+		}
+		return result;
+	}
+};
+
+/**
+ * The parts of State that use the queue, with RAM and flash simulated.
+ */
+class SimulatedState {
+public:
+	SimulatedStorage storage;
+	std::set<std::pair<uint16_t, cs_state_id_t>> ram;
+	uint32_t numSets = 0;
+
+	virtual ~SimulatedState() {}
+
+	cs_ret_code_t set(uint16_t type, cs_state_id_t id) {
+		numSets++;
+		ram.insert({type, id});
+		if (storage.perform('w', type, id) == ERR_BUSY) {
+			return addToQueue(CS_STATE_QUEUE_OP_WRITE, type, id, STATE_RETRY_STORE_DELAY_MS, StateQueueMode::DELAY);
+		}
+		return ERR_SUCCESS;
+	}
+
+	cs_ret_code_t setDelayed(uint16_t type, cs_state_id_t id, uint32_t delaySeconds) {
+		numSets++;
+		ram.insert({type, id});
+		return addToQueue(CS_STATE_QUEUE_OP_WRITE, type, id, 1000 * delaySeconds, StateQueueMode::DELAY);
+	}
+
+	cs_ret_code_t setThrottled(uint16_t type, cs_state_id_t id, uint32_t periodSeconds) {
+		numSets++;
+		ram.insert({type, id});
+		return addToQueue(CS_STATE_QUEUE_OP_WRITE, type, id, 1000 * periodSeconds, StateQueueMode::THROTTLE);
+	}
+
+	cs_ret_code_t remove(uint16_t type, cs_state_id_t id) {
+		ram.erase({type, id});
+		if (storage.perform('r', type, id) == ERR_BUSY) {
+			return addToQueue(
+					CS_STATE_QUEUE_OP_REM_ONE_ID_OF_TYPE, type, id, STATE_RETRY_STORE_DELAY_MS, StateQueueMode::DELAY);
+		}
+		return ERR_SUCCESS;
+	}
+
+	void cleanUp() {
+		if (storage.perform('g', TYPE_NONE, 0) == ERR_BUSY) {
+			addToQueue(CS_STATE_QUEUE_OP_GC, TYPE_NONE, 0, STATE_RETRY_STORE_DELAY_MS, StateQueueMode::DELAY);
+		}
+	}
+
+	void factoryReset() {
+		clearQueue();
+		if (storage.perform('f', TYPE_NONE, 0) == ERR_BUSY) {
+			addToQueue(CS_STATE_QUEUE_OP_FACTORY_RESET, TYPE_NONE, 0, STATE_RETRY_STORE_DELAY_MS, StateQueueMode::DELAY);
+		}
+	}
+
+	void tick() {
+		storage.tickCount++;
+		delayedStoreTick();
+	}
+
+	virtual size_t queueSize() = 0;
+
+protected:
+	cs_ret_code_t storeInFlash(uint16_t type, cs_state_id_t id) {
+		if (ram.count({type, id}) == 0) {
+			return ERR_NOT_FOUND;
+		}
+		return storage.perform('w', type, id);
+	}
+
+	/**
+	 * Perform the operation of a due item.
+	 *
+	 * @return True when it should be retried.
+	 */
+	bool execute(StateQueueOp operation, uint16_t type, cs_state_id_t id) {
+		switch (operation) {
+			case CS_STATE_QUEUE_OP_WRITE: return storeInFlash(type, id) == ERR_BUSY;
+			case CS_STATE_QUEUE_OP_REM_ONE_ID_OF_TYPE: return storage.perform('r', type, id) == ERR_BUSY;
+			case CS_STATE_QUEUE_OP_FACTORY_RESET: return storage.perform('f', type, id) == ERR_BUSY;
+			case CS_STATE_QUEUE_OP_GC: return storage.perform('g', type, id) == ERR_BUSY;
+		}
+		return false;
+	}
+
+	virtual cs_ret_code_t addToQueue(
+			StateQueueOp operation, uint16_t type, cs_state_id_t id, uint32_t delayMs, StateQueueMode mode) = 0;
+	virtual void delayedStoreTick()                                                                   = 0;
+	virtual void clearQueue()                                                                         = 0;
+};
+
+/**
+ * The previous implementation: a vector of items with a counter that is decremented every tick.
+ */
+class VectorQueueState : public SimulatedState {
+public:
+	struct item_t {
+		StateQueueOp operation;
+		uint16_t type;
+		cs_state_id_t id;
+		uint32_t counter;
+		uint32_t init_counter;
+		bool execute;
+	};
+	vector<item_t> queue;
+
+	size_t queueSize() override { return queue.size(); }
+
+protected:
+	cs_ret_code_t addToQueue(
+			StateQueueOp operation, uint16_t type, cs_state_id_t id, uint32_t delayMs, StateQueueMode mode) override {
+		uint32_t delayTicks = delayMs / TICK_INTERVAL_MS;
+		bool found          = false;
+		if (operation == CS_STATE_QUEUE_OP_WRITE || operation == CS_STATE_QUEUE_OP_REM_ONE_ID_OF_TYPE) {
+			for (auto& item : queue) {
+				if (item.type == type && item.id == id
+					&& (item.operation == CS_STATE_QUEUE_OP_WRITE
+						|| item.operation == CS_STATE_QUEUE_OP_REM_ONE_ID_OF_TYPE)) {
+					if (mode == StateQueueMode::THROTTLE) {
+						item.init_counter = delayTicks;
+					}
+					else {
+						item.counter = delayTicks;
+					}
+					item.execute = true;
+					found        = true;
+					break;
+				}
+			}
+		}
+		if (!found) {
+			if (mode == StateQueueMode::THROTTLE) {
+				cs_ret_code_t retCode = storeInFlash(type, id);
+				if (retCode != ERR_SUCCESS) {
+					return retCode;
+				}
+			}
+			queue.push_back({operation, type, id, delayTicks, 0, mode == StateQueueMode::DELAY});
+		}
+		return ERR_SUCCESS;
+	}
+
+	void delayedStoreTick() override {
+		for (auto it = queue.begin(); it != queue.end();) {
+			if (it->counter == 0) {
+				bool keepItem = false;
+				if (it->execute) {
+					keepItem = execute(it->operation, it->type, it->id);
+				}
+				if (it->execute && it->init_counter != 0) {
+					keepItem    = true;
+					it->execute = false;
+					it->counter = it->init_counter;
+				}
+				else {
+					it->counter = RETRY_COUNTER;
+				}
+				if (!keepItem) {
+					it = queue.erase(it);
+				}
+				else {
+					it++;
+				}
+			}
+			else {
+				it->counter--;
+				it++;
+			}
+		}
+	}
+
+	void clearQueue() override { queue.clear(); }
+};
+
+/**
+ * The current implementation, using StateStoreQueue.
+ */
+class HeapQueueState : public SimulatedState {
+public:
+	StateStoreQueue queue{RETRY_COUNTER};
+
+	size_t queueSize() override { return queue.size(); }
+
+protected:
+	cs_ret_code_t addToQueue(
+			StateQueueOp operation, uint16_t type, cs_state_id_t id, uint32_t delayMs, StateQueueMode mode) override {
+		uint32_t delayTicks = delayMs / TICK_INTERVAL_MS;
+		bool found          = false;
+		if (operation == CS_STATE_QUEUE_OP_WRITE || operation == CS_STATE_QUEUE_OP_REM_ONE_ID_OF_TYPE) {
+			found = queue.update(type, id, delayTicks, mode);
+		}
+		if (!found) {
+			if (mode == StateQueueMode::THROTTLE) {
+				cs_ret_code_t retCode = storeInFlash(type, id);
+				if (retCode != ERR_SUCCESS) {
+					return retCode;
+				}
+			}
+			if (queue.add(operation, type, id, delayTicks, mode == StateQueueMode::DELAY) == StateStoreQueue::NONE) {
+				return ERR_NO_SPACE;
+			}
+		}
+		return ERR_SUCCESS;
+	}
+
+	void delayedStoreTick() override {
+		queue.tick();
+		uint16_t handle;
+		while ((handle = queue.getDue()) != StateStoreQueue::NONE) {
+			cs_state_store_queue_t& item = queue.get(handle);
+			bool retry                   = false;
+			if (item.execute) {
+				retry = execute(item.operation, item.type, item.id);
+			}
+			queue.done(handle, retry);
+		}
+	}
+
+	void clearQueue() override { queue.clear(); }
+};
+
+void testDelayed() {
+	cout << "Check that delayed writes of the same type are combined into one write." << endl;
+	HeapQueueState state;
+	for (int i = 0; i < 50; ++i) {
+		state.setDelayed(1, 0, 2);
+		state.tick();
+	}
+	assert(state.storage.numWrites == 0);
+	// Delay of 2s is 20 ticks of waiting: written at the 21st tick after the last set.
+	for (int i = 0; i < 19; ++i) {
+		state.tick();
+	}
+	assert(state.storage.numWrites == 0);
+	state.tick();
+	assert(state.storage.numWrites == 1);
+	assert(state.queue.empty());
+}
+
+void testThrottled() {
+	cout << "Check that throttled writes are written at once, then at most once per period." << endl;
+	HeapQueueState state;
+	state.setThrottled(1, 0, 1);
+	assert(state.storage.numWrites == 1);
+	for (int i = 0; i < 100; ++i) {
+		state.tick();
+		state.setThrottled(1, 0, 1);
+	}
+	// Written at once, then every 11 ticks.
+	assert(state.storage.numWrites == 1 + 100 / 11);
+
+	// Without sets, the item is kept for one more period, and then removed.
+	uint32_t numWrites = state.storage.numWrites;
+	for (int i = 0; i < 30; ++i) {
+		state.tick();
+	}
+	assert(state.storage.numWrites == numWrites + 1);
+	assert(state.queue.empty());
+}
+
+void testRetry() {
+	cout << "Check that operations are retried while storage is busy." << endl;
+	HeapQueueState state;
+	state.storage.busyPercentage = 100;
+	state.set(1, 0);
+	state.remove(2, 0);
+	state.cleanUp();
+	assert(state.queue.size() == 3);
+	for (int i = 0; i < 100; ++i) {
+		state.tick();
+	}
+	assert(state.queue.size() == 3);
+	state.storage.busyPercentage = 0;
+	for (uint32_t i = 0; i < RETRY_COUNTER + 1; ++i) {
+		state.tick();
+	}
+	assert(state.queue.empty());
+	assert(state.storage.numWrites == 1);
+
+	cout << "Check that a remove replaces a queued write." << endl;
+	state.storage.busyPercentage = 100;
+	state.set(1, 0);
+	state.remove(1, 0);
+	assert(state.queue.size() == 1);
+}
+
+/**
+ * Random operations on both implementations.
+ */
+void compare(uint32_t seed, uint32_t busyPercentage) {
+	cout << "Compare with previous implementation, seed=" << seed << " busy=" << busyPercentage << "%." << endl;
+	VectorQueueState before;
+	HeapQueueState after;
+	before.storage.busyPercentage = busyPercentage;
+	after.storage.busyPercentage  = busyPercentage;
+	mt19937 random(seed);
+	size_t maxQueueSize = 0;
+	for (int step = 0; step < 100000; ++step) {
+		uint16_t type    = 1 + random() % 20;
+		cs_state_id_t id = random() % 3;
+		uint32_t r       = random() % 1000;
+		cs_ret_code_t retCodeBefore = ERR_SUCCESS;
+		cs_ret_code_t retCodeAfter  = ERR_SUCCESS;
+		if (r < 100) {
+			retCodeBefore = before.set(type, id);
+			retCodeAfter  = after.set(type, id);
+		}
+		else if (r < 250) {
+			uint32_t delay = 1 + random() % 5;
+			retCodeBefore  = before.setDelayed(type, id, delay);
+			retCodeAfter   = after.setDelayed(type, id, delay);
+		}
+		else if (r < 400) {
+			uint32_t period = 1 + random() % 5;
+			retCodeBefore   = before.setThrottled(type, id, period);
+			retCodeAfter    = after.setThrottled(type, id, period);
+		}
+		else if (r < 450) {
+			retCodeBefore = before.remove(type, id);
+			retCodeAfter  = after.remove(type, id);
+		}
+		else if (r < 455) {
+			before.cleanUp();
+			after.cleanUp();
+		}
+		else if (r < 456) {
+			before.factoryReset();
+			after.factoryReset();
+		}
+		else {
+			uint32_t ticks = 1 + random() % 10;
+			for (uint32_t t = 0; t < ticks; ++t) {
+				before.tick();
+				after.tick();
+			}
+		}
+		assert(retCodeBefore == retCodeAfter);
+		assert(before.queueSize() == after.queueSize());
+		maxQueueSize = max(maxQueueSize, after.queueSize());
+	}
+	for (int t = 0; t < 1000; ++t) {
+		before.tick();
+		after.tick();
+	}
+	assert(before.storage.log.size() == after.storage.log.size());
+	for (size_t i = 0; i < before.storage.log.size(); ++i) {
+		assert(before.storage.log[i] == after.storage.log[i]);
+	}
+	assert(after.queue.empty());
+	cout << "  " << after.storage.log.size() << " flash operations, max queue size " << maxQueueSize << endl;
+}
+
+/**
+ * Simulate an hour of state writes, similar to what the firmware does.
+ */
+template <class T>
+double simulateHour(T& state, uint32_t numThrottledTypes) {
+	const uint32_t ticksPerHour = 3600 * 1000 / TICK_INTERVAL_MS;
+	mt19937 random(3);
+	auto start = chrono::steady_clock::now();
+	for (uint32_t t = 0; t < ticksPerHour; ++t) {
+		// Values that are set often, throttled to once per minute.
+		for (uint32_t i = 0; i < numThrottledTypes; ++i) {
+			if (t % 10 == i % 10) {
+				state.setThrottled(100 + i, 0, 60);
+			}
+		}
+		// Switch state, stored with a delay, changed in bursts.
+		if (t % 3000 < 50 && random() % 5 == 0) {
+			state.setDelayed(1, 0, SWITCH_DELAYED_STORE_MS / 1000);
+		}
+		// Sun time, throttled to once per hour.
+		if (t % 36000 == 5) {
+			state.setThrottled(2, 0, 3600);
+		}
+		// Occasionally a config change.
+		if (t % 6000 == 100) {
+			state.set(3, random() % 4);
+		}
+		state.tick();
+	}
+	auto end = chrono::steady_clock::now();
+	return chrono::duration<double, nano>(end - start).count() / ticksPerHour;
+}
+
+void measure() {
+	const uint32_t numThrottledTypes = 10;
+	VectorQueueState before;
+	HeapQueueState after;
+	before.storage.busyPercentage = 5;
+	after.storage.busyPercentage  = 5;
+	double nsBefore = simulateHour(before, numThrottledTypes);
+	double nsAfter  = simulateHour(after, numThrottledTypes);
+	assert(before.storage.log.size() == after.storage.log.size());
+	assert(before.storage.numWrites == after.storage.numWrites);
+
+	cout << endl << "Simulated hour, " << numThrottledTypes << " throttled types:" << endl;
+	cout << "  values set:       " << setw(7) << after.numSets << endl;
+	cout << "  flash writes:     " << setw(7) << after.storage.numWrites << " ("
+		 << fixed << setprecision(1) << 100.0 * (after.numSets - after.storage.numWrites) / after.numSets
+		 << "% saved)" << endl;
+	cout << "  per tick, vector: " << setw(7) << setprecision(0) << nsBefore << " ns" << endl;
+	cout << "  per tick, heap:   " << setw(7) << setprecision(0) << nsAfter << " ns" << endl;
+	assert(after.storage.numWrites < after.numSets / 10);
+
+	// Idle ticks with a full queue: only the first item is looked at.
+	VectorQueueState idleBefore;
+	HeapQueueState idleAfter;
+	for (uint16_t type = 1; type <= 100; ++type) {
+		idleBefore.setThrottled(type, 0, 3600);
+		idleAfter.setThrottled(type, 0, 3600);
+	}
+	const uint32_t numIdleTicks = 10000;
+	auto t0 = chrono::steady_clock::now();
+	for (uint32_t t = 0; t < numIdleTicks; ++t) {
+		idleBefore.tick();
+	}
+	auto t1 = chrono::steady_clock::now();
+	for (uint32_t t = 0; t < numIdleTicks; ++t) {
+		idleAfter.tick();
+	}
+	auto t2 = chrono::steady_clock::now();
+	cout << "  100 queued items, idle tick: vector "
+		 << chrono::duration<double, nano>(t1 - t0).count() / numIdleTicks << " ns, heap "
+		 << chrono::duration<double, nano>(t2 - t1).count() / numIdleTicks << " ns" << endl;
+	assert(idleBefore.storage.log == idleAfter.storage.log);
+}
+
+int main() {
+	cout << "Test state store queue" << endl;
+
+	testDelayed();
+	testThrottled();
+	testRetry();
+	compare(1, 0);
+	compare(2, 10);
+	compare(3, 50);
+	measure();
+
+	cout << "Done" << endl;
+	return 0;
+}
@@ -0,0 +1,784 @@
+#define SERIAL_VERBOSITY SERIAL_NONE
+
+/**
+ * Tests the host implementation of FDS, the record cache and flash statistics of Storage.
+ *
+ * Then tests Storage itself on the host FDS: committing a group of writes, finding the records of a group, dropping
+ * removed values from a group, and invalidating the record cache.
+ *
+ * Then simulates the writes of State to Storage, to compare the flash work of single writes with committing the writes
+ * of each tick as group.
+ */
+
+#include <drivers/cs_Storage.h>
+#include <drivers/cs_StorageRecordCache.h>
+#include <drivers/cs_StorageStats.h>
+#include <host/cs_HostFds.h>
+#include <protocol/cs_ErrorCodes.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+vector<fds_evt_t> events;
+
+void recordEvent(fds_evt_t const* p_evt) {
+	events.push_back(*p_evt);
+}
+
+void (*eventHandler)(fds_evt_t const* p_evt) = recordEvent;
+
+void handleEvent(fds_evt_t const* p_evt) {
+	eventHandler(p_evt);
+}
+
+void init(HostFds& fds) {
+	events.clear();
+	ret_code_t nrfCode = fds_init();
+	assert(nrfCode == NRF_SUCCESS);
+	fds.process();
+	assert(events.size() == 1);
+	assert(events[0].id == FDS_EVT_INIT);
+	assert(events[0].result == NRF_SUCCESS);
+	events.clear();
+}
+
+fds_record_t makeRecord(uint16_t fileId, uint16_t key, const uint32_t* data, uint32_t numWords) {
+	fds_record_t record;
+	record.file_id           = fileId;
+	record.key               = key;
+	record.data.p_data       = data;
+	record.data.length_words = numWords;
+	return record;
+}
+
+/**
+ * Find the last record with given file id and key.
+ */
+bool findLast(uint16_t fileId, uint16_t key, fds_record_desc_t& desc) {
+	fds_find_token_t token;
+	memset(&token, 0, sizeof(token));
+	bool found = false;
+	fds_record_desc_t foundDesc;
+	while (fds_record_find(fileId, key, &foundDesc, &token) == NRF_SUCCESS) {
+		desc  = foundDesc;
+		found = true;
+	}
+	return found;
+}
+
+uint32_t readWord(fds_record_desc_t& desc) {
+	fds_flash_record_t flashRecord;
+	ret_code_t nrfCode = fds_record_open(&desc, &flashRecord);
+	assert(nrfCode == NRF_SUCCESS);
+	uint32_t value = static_cast<const uint32_t*>(flashRecord.p_data)[0];
+	nrfCode = fds_record_close(&desc);
+	assert(nrfCode == NRF_SUCCESS);
+	return value;
+}
+
+void testHostFds(const char* path) {
+	cout << "testHostFds" << endl;
+	HostFds& fds = HostFds::getInstance();
+	bool opened = fds.open(path);
+	assert(opened);
+	eventHandler = recordEvent;
+
+	fds_record_desc_t desc;
+	uint32_t data[4] = {1, 2, 3, 4};
+	fds_record_t record = makeRecord(3, 10, data, 4);
+	ret_code_t nrfCode = fds_record_write(&desc, &record);
+	assert(nrfCode == FDS_ERR_NOT_INITIALIZED);
+	init(fds);
+
+	// Write: the data is only read when the operation is executed.
+	nrfCode = fds_record_write(&desc, &record);
+	assert(nrfCode == NRF_SUCCESS);
+	data[0] = 11;
+	fds.process();
+	assert(events.size() == 1 && events[0].id == FDS_EVT_WRITE && events[0].result == NRF_SUCCESS);
+	assert(events[0].write.file_id == 3 && events[0].write.record_key == 10);
+	assert(events[0].write.record_id == desc.record_id);
+	assert(readWord(desc) == 11);
+
+	// Update: the old record is marked dirty.
+	data[0] = 12;
+	nrfCode = fds_record_update(&desc, &record);
+	assert(nrfCode == NRF_SUCCESS);
+	fds.process();
+	assert(events.back().id == FDS_EVT_UPDATE && events.back().write.is_record_updated);
+	fds_record_desc_t foundDesc;
+	bool found = findLast(3, 10, foundDesc);
+	assert(found);
+	assert(foundDesc.record_id == desc.record_id);
+	assert(readWord(foundDesc) == 12);
+	fds_stat_t stat;
+	nrfCode = fds_stat(&stat);
+	assert(nrfCode == NRF_SUCCESS);
+	assert(stat.valid_records == 1 && stat.dirty_records == 1);
+	assert(stat.pages_available == FDS_VIRTUAL_PAGES - 1);
+
+	// Corrupt data fails the CRC check.
+	fds_flash_record_t flashRecord;
+	nrfCode = fds_record_open(&foundDesc, &flashRecord);
+	assert(nrfCode == NRF_SUCCESS);
+	uint32_t* flashData = const_cast<uint32_t*>(static_cast<const uint32_t*>(flashRecord.p_data));
+	fds_record_close(&foundDesc);
+	flashData[3] = 0;
+	nrfCode = fds_record_open(&foundDesc, &flashRecord);
+	assert(nrfCode == FDS_ERR_CRC_CHECK_FAILED);
+
+	// Delete record, and delete file.
+	nrfCode = fds_record_delete(&foundDesc);
+	assert(nrfCode == NRF_SUCCESS);
+	fds.process();
+	assert(events.back().id == FDS_EVT_DEL_RECORD && events.back().result == NRF_SUCCESS);
+	assert(events.back().del.record_key == 10);
+	found = findLast(3, 10, foundDesc);
+	assert(!found);
+	uint32_t value = 5;
+	for (uint16_t key = 1; key <= 3; ++key) {
+		record = makeRecord(4, key, &value, 1);
+		nrfCode = fds_record_write(nullptr, &record);
+		assert(nrfCode == NRF_SUCCESS);
+	}
+	fds.process();
+	nrfCode = fds_file_delete(4);
+	assert(nrfCode == NRF_SUCCESS);
+	fds.process();
+	assert(events.back().id == FDS_EVT_DEL_FILE && events.back().del.file_id == 4);
+	fds_find_token_t token;
+	memset(&token, 0, sizeof(token));
+	nrfCode = fds_record_find_in_file(4, &foundDesc, &token);
+	assert(nrfCode == FDS_ERR_NOT_FOUND);
+
+	// Queue limit.
+	for (uint16_t i = 0; i < FDS_OP_QUEUE_SIZE; ++i) {
+		nrfCode = fds_record_write(nullptr, &record);
+		assert(nrfCode == NRF_SUCCESS);
+	}
+	nrfCode = fds_record_write(nullptr, &record);
+	assert(nrfCode == FDS_ERR_NO_SPACE_IN_QUEUES);
+	fds.process();
+
+	// Fill the flash, then garbage collection makes space again.
+	uint32_t large[256] = {};
+	record = makeRecord(5, 20, large, 256);
+	uint32_t numWritten = 0;
+	while ((nrfCode = fds_record_write(&desc, &record)) == NRF_SUCCESS) {
+		fds.process();
+		// Delete every other record, so that garbage collection has something to free.
+		if (++numWritten % 2 == 0) {
+			nrfCode = fds_record_delete(&desc);
+			assert(nrfCode == NRF_SUCCESS);
+			fds.process();
+		}
+	}
+	assert(nrfCode == FDS_ERR_NO_SPACE_IN_FLASH);
+	fds.resetStats();
+	nrfCode = fds_gc();
+	assert(nrfCode == NRF_SUCCESS);
+	fds.process();
+	assert(events.back().id == FDS_EVT_GC);
+	assert(fds.getStats().gcRuns == 1);
+	assert(fds.getStats().pageErases > 0);
+	nrfCode = fds_record_write(&desc, &record);
+	assert(nrfCode == NRF_SUCCESS);
+	fds.process();
+
+	// The last written record survives garbage collection, and a reboot.
+	value = 99;
+	record = makeRecord(3, 30, &value, 1);
+	nrfCode = fds_record_write(&desc, &record);
+	assert(nrfCode == NRF_SUCCESS);
+	fds.process();
+	uint32_t recordId = desc.record_id;
+	nrfCode = fds_gc();
+	assert(nrfCode == NRF_SUCCESS);
+	fds.process();
+	found = findLast(3, 30, foundDesc);
+	assert(found);
+	assert(readWord(foundDesc) == 99);
+	if (path != nullptr) {
+		fds.close();
+		opened = fds.open(path);
+		assert(opened);
+		init(fds);
+		found = findLast(3, 30, foundDesc);
+		assert(found);
+		assert(foundDesc.record_id == recordId);
+		assert(readWord(foundDesc) == 99);
+		nrfCode = fds_record_write(&desc, &record);
+		assert(nrfCode == NRF_SUCCESS);
+		assert(desc.record_id > recordId);
+		fds.process();
+	}
+	fds.close();
+}
+
+void testRecordCache() {
+	cout << "testRecordCache" << endl;
+	StorageRecordCache cache;
+	cache.clear();
+	fds_record_desc_t desc;
+	memset(&desc, 0, sizeof(desc));
+	for (uint16_t key = 1; key < StorageRecordCache::SIZE; ++key) {
+		bool found = cache.get(3, key, desc);
+		assert(!found);
+		desc.record_id = key;
+		cache.set(3, key, desc);
+	}
+	for (uint16_t key = 1; key < StorageRecordCache::SIZE; ++key) {
+		bool found = cache.get(3, key, desc);
+		assert(found);
+		assert(desc.record_id == key);
+	}
+
+	// Entries that map to the same place replace each other, but never return the wrong descriptor.
+	for (uint16_t key = 1; key < 1000; ++key) {
+		desc.record_id = 1000 + key;
+		cache.set(4, key, desc);
+	}
+	uint32_t numFound = 0;
+	for (uint16_t key = 1; key < 1000; ++key) {
+		if (cache.get(4, key, desc)) {
+			assert(desc.record_id == 1000u + key);
+			numFound++;
+		}
+	}
+	assert(numFound == StorageRecordCache::SIZE);
+
+	cache.clear();
+	desc.record_id = 1;
+	cache.set(3, 1, desc);
+	cache.set(4, 2, desc);
+	cache.set(5, 2, desc);
+	cache.remove(3, 1);
+	bool found = cache.get(3, 1, desc);
+	assert(!found);
+	cache.removeFileId(4);
+	found = cache.get(4, 2, desc);
+	assert(!found);
+	found = cache.get(5, 2, desc);
+	assert(found);
+	cache.removeRecordKey(2);
+	found = cache.get(5, 2, desc);
+	assert(!found);
+}
+
+void testStats() {
+	cout << "testStats" << endl;
+	StorageStats stats;
+	assert(stats.get(5) == nullptr);
+	stats.addWrite(5, 16);
+	stats.addWrite(2, 8);
+	stats.addWrite(5, 16);
+	stats.addBusy(9);
+	assert(stats.get(5)->bytesWritten == 32 && stats.get(5)->writes == 2);
+	assert(stats.get(9)->busy == 1 && stats.get(9)->writes == 0);
+	assert(stats.getTypeStats().size() == 3);
+	assert(stats.getTypeStats()[0].recordKey == 2);
+	assert(stats.getTypeStats()[2].recordKey == 9);
+	stats.getTotals().gcRuns++;
+	stats.clear();
+	assert(stats.get(5) == nullptr && stats.getTotals().gcRuns == 0);
+}
+
+
+void ignoreEvent(fds_evt_t const*) {}
+
+/**
+ * Handle the scheduled events, and execute the flash operations, until there is nothing left to do.
+ */
+void process() {
+	do {
+		app_sched_execute();
+	} while (HostFds::getInstance().process() > 0);
+}
+
+struct storage_error_t {
+	cs_storage_operation_t operation;
+	CS_TYPE type;
+	cs_state_id_t id;
+};
+
+vector<storage_error_t> storageErrors;
+
+void recordStorageError(cs_storage_operation_t operation, CS_TYPE type, cs_state_id_t id) {
+	storageErrors.push_back({operation, type, id});
+}
+
+/**
+ * Start Storage on an empty flash.
+ *
+ * Storage can't reboot, as it's a singleton: the factory reset clears its record cache and group instead.
+ */
+Storage& resetStorage(const char* path) {
+	HostFds& fds = HostFds::getInstance();
+	fds.close();
+	unlink(path);
+	bool opened = fds.open(path);
+	assert(opened);
+	eventHandler     = ignoreEvent;
+	Storage& storage = Storage::getInstance();
+	if (!storage.isInitialized()) {
+		cs_ret_code_t retCode = storage.init();
+		assert(retCode == ERR_SUCCESS);
+	}
+	else {
+		ret_code_t nrfCode = fds_init();
+		assert(nrfCode == NRF_SUCCESS);
+	}
+	process();
+	assert(storage.isInitialized());
+	cs_ret_code_t retCode = storage.factoryReset();
+	assert(retCode == ERR_SUCCESS);
+	process();
+	storage.setErrorCallback(recordStorageError);
+	storageErrors.clear();
+	fds.resetStats();
+	return storage;
+}
+
+cs_state_data_t makeData(CS_TYPE type, cs_state_id_t id, uint32_t* value) {
+	return cs_state_data_t(type, id, reinterpret_cast<uint8_t*>(value), sizeof(*value));
+}
+
+/**
+ * Read a value directly from FDS, so that the record cache of Storage isn't used.
+ */
+bool readFlash(CS_TYPE type, cs_state_id_t id, uint32_t& value) {
+	fds_record_desc_t desc;
+	if (!findLast(FILE_CONFIGURATION + id, to_underlying_type(type), desc)) {
+		return false;
+	}
+	value = readWord(desc);
+	return true;
+}
+
+uint32_t getValidRecords() {
+	fds_stat_t stat;
+	ret_code_t nrfCode = fds_stat(&stat);
+	assert(nrfCode == NRF_SUCCESS);
+	return stat.valid_records;
+}
+
+/**
+ * Write a value, and return whether its record was found in the record cache.
+ */
+bool writeCached(Storage& storage, CS_TYPE type, cs_state_id_t id, uint32_t* value) {
+	uint32_t cacheHits = storage.getStats().getTotals().cacheHits;
+	cs_ret_code_t retCode = storage.write(makeData(type, id, value));
+	assert(retCode == ERR_SUCCESS);
+	process();
+	uint32_t flashValue = 0;
+	assert(readFlash(type, id, flashValue) && flashValue == *value);
+	return storage.getStats().getTotals().cacheHits > cacheHits;
+}
+
+void testStorageGroup(const char* path) {
+	cout << "testStorageGroup" << endl;
+	Storage& storage = resetStorage(path);
+	HostFds& fds     = HostFds::getInstance();
+	CS_TYPE types[]  = {CS_TYPE::CONFIG_TX_POWER, CS_TYPE::CONFIG_BOOT_DELAY, CS_TYPE::CONFIG_MAX_CHIP_TEMP};
+
+	// Records that are on flash, but not in the record cache, like after a reboot.
+	uint32_t oldValues[] = {1, 2, 3};
+	for (int i = 0; i < 3; ++i) {
+		fds_record_t record = makeRecord(FILE_CONFIGURATION, to_underlying_type(types[i]), &oldValues[i], 1);
+		ret_code_t nrfCode = fds_record_write(nullptr, &record);
+		assert(nrfCode == NRF_SUCCESS);
+	}
+	process();
+	fds.resetStats();
+
+	// A later write of the same type and id replaces the collected one, nothing is written before the commit.
+	cs_storage_stats_t before = storage.getStats().getTotals();
+	uint32_t replacedValue    = 99;
+	uint32_t values[]         = {11, 12, 13};
+	storage.beginCommitGroup();
+	cs_ret_code_t retCode = storage.write(makeData(types[0], 0, &replacedValue));
+	assert(retCode == ERR_SUCCESS);
+	for (int i = 0; i < 3; ++i) {
+		retCode = storage.write(makeData(types[i], 0, &values[i]));
+		assert(retCode == ERR_SUCCESS);
+	}
+	assert(fds.getStats().recordsWritten == 0);
+	retCode = storage.commitGroup();
+	assert(retCode == ERR_SUCCESS);
+	process();
+	cs_storage_stats_t after = storage.getStats().getTotals();
+	assert(after.groups == before.groups + 1);
+	assert(after.cacheMisses == before.cacheMisses + 3);
+
+	// The missed records are found in a single pass, and updated.
+	assert(after.searches == before.searches + 1);
+	assert(fds.getStats().recordsWritten == 3);
+	for (int i = 0; i < 3; ++i) {
+		uint32_t value = 0;
+		assert(readFlash(types[i], 0, value) && value == values[i]);
+	}
+	assert(getValidRecords() == 3);
+
+	// The records are cached now, so there's no search.
+	before = after;
+	storage.beginCommitGroup();
+	retCode = storage.write(makeData(types[0], 0, &values[0]));
+	assert(retCode == ERR_SUCCESS);
+	retCode = storage.write(makeData(types[1], 0, &values[1]));
+	assert(retCode == ERR_SUCCESS);
+	retCode = storage.commitGroup();
+	assert(retCode == ERR_SUCCESS);
+	process();
+	after = storage.getStats().getTotals();
+	assert(after.cacheHits == before.cacheHits + 2);
+	assert(after.searches == before.searches);
+
+	// A single miss is searched for like a single write: a new record.
+	before         = after;
+	uint32_t value = 34;
+	storage.beginCommitGroup();
+	retCode = storage.write(makeData(types[0], 0, &values[0]));
+	assert(retCode == ERR_SUCCESS);
+	retCode = storage.write(makeData(CS_TYPE::CONFIG_CROWNSTONE_ID, 0, &value));
+	assert(retCode == ERR_SUCCESS);
+	retCode = storage.commitGroup();
+	assert(retCode == ERR_SUCCESS);
+	process();
+	after = storage.getStats().getTotals();
+	assert(after.cacheMisses == before.cacheMisses + 1);
+	assert(after.searches == before.searches + 1);
+	assert(getValidRecords() == 4);
+	assert(storageErrors.empty());
+}
+
+void testStorageGroupRemove(const char* path) {
+	cout << "testStorageGroupRemove" << endl;
+	Storage& storage = resetStorage(path);
+	uint32_t values[] = {1, 2, 3, 4};
+
+	// Removing a type and id, or a type, drops it from the group, even when nothing is on flash yet.
+	storage.beginCommitGroup();
+	cs_ret_code_t retCode = storage.write(makeData(CS_TYPE::CONFIG_TX_POWER, 0, &values[0]));
+	assert(retCode == ERR_SUCCESS);
+	retCode = storage.write(makeData(CS_TYPE::CONFIG_TX_POWER, 1, &values[1]));
+	assert(retCode == ERR_SUCCESS);
+	retCode = storage.write(makeData(CS_TYPE::CONFIG_BOOT_DELAY, 0, &values[2]));
+	assert(retCode == ERR_SUCCESS);
+	retCode = storage.write(makeData(CS_TYPE::CONFIG_MAX_CHIP_TEMP, 2, &values[3]));
+	assert(retCode == ERR_SUCCESS);
+	retCode = storage.remove(CS_TYPE::CONFIG_TX_POWER, 1);
+	assert(retCode == ERR_NOT_FOUND);
+	retCode = storage.remove(CS_TYPE::CONFIG_BOOT_DELAY);
+	assert(retCode == ERR_NOT_FOUND);
+	retCode = storage.commitGroup();
+	assert(retCode == ERR_SUCCESS);
+	process();
+	uint32_t value = 0;
+	assert(readFlash(CS_TYPE::CONFIG_TX_POWER, 0, value) && value == values[0]);
+	assert(!readFlash(CS_TYPE::CONFIG_TX_POWER, 1, value));
+	assert(!readFlash(CS_TYPE::CONFIG_BOOT_DELAY, 0, value));
+	assert(readFlash(CS_TYPE::CONFIG_MAX_CHIP_TEMP, 2, value) && value == values[3]);
+	assert(getValidRecords() == 2);
+
+	// Removing an id drops its values, and the other writes are reported as busy while the file is removed.
+	uint32_t newValues[] = {11, 14};
+	storage.beginCommitGroup();
+	retCode = storage.write(makeData(CS_TYPE::CONFIG_TX_POWER, 0, &newValues[0]));
+	assert(retCode == ERR_SUCCESS);
+	retCode = storage.write(makeData(CS_TYPE::CONFIG_MAX_CHIP_TEMP, 2, &newValues[1]));
+	assert(retCode == ERR_SUCCESS);
+	retCode = storage.remove(cs_state_id_t(2));
+	assert(retCode == ERR_SUCCESS);
+	retCode = storage.commitGroup();
+	assert(retCode == ERR_BUSY);
+	process();
+	assert(storageErrors.size() == 1);
+	assert(storageErrors[0].operation == CS_STORAGE_OP_WRITE);
+	assert(storageErrors[0].type == CS_TYPE::CONFIG_TX_POWER && storageErrors[0].id == 0);
+	assert(readFlash(CS_TYPE::CONFIG_TX_POWER, 0, value) && value == values[0]);
+	assert(!readFlash(CS_TYPE::CONFIG_MAX_CHIP_TEMP, 2, value));
+}
+
+void testStorageCacheInvalidation(const char* path) {
+	cout << "testStorageCacheInvalidation" << endl;
+	Storage& storage = resetStorage(path);
+	CS_TYPE type     = CS_TYPE::CONFIG_TX_POWER;
+	uint32_t value   = 1;
+	bool cached = writeCached(storage, type, 0, &value);
+	assert(!cached);
+	value++;
+	cached = writeCached(storage, type, 0, &value);
+	assert(cached);
+
+	// Each way of removing the value removes it from the cache, so the next write is a new record.
+	cs_ret_code_t retCode = storage.remove(type, 0);
+	assert(retCode == ERR_SUCCESS);
+	process();
+	value++;
+	cached = writeCached(storage, type, 0, &value);
+	assert(!cached);
+	assert(getValidRecords() == 1);
+
+	retCode = storage.remove(type);
+	assert(retCode == ERR_SUCCESS);
+	process();
+	value++;
+	cached = writeCached(storage, type, 0, &value);
+	assert(!cached);
+	assert(getValidRecords() == 1);
+
+	retCode = storage.remove(cs_state_id_t(0));
+	assert(retCode == ERR_SUCCESS);
+	process();
+	value++;
+	cached = writeCached(storage, type, 0, &value);
+	assert(!cached);
+	assert(getValidRecords() == 1);
+
+	retCode = storage.factoryReset();
+	assert(retCode == ERR_SUCCESS);
+	process();
+	assert(getValidRecords() == 0);
+	value++;
+	cached = writeCached(storage, type, 0, &value);
+	assert(!cached);
+	value++;
+	cached = writeCached(storage, type, 0, &value);
+	assert(cached);
+
+	// A failed write removes the cached descriptor, as it's of the record that failed to be written.
+	fds_evt_t event;
+	memset(&event, 0, sizeof(event));
+	event.id               = FDS_EVT_UPDATE;
+	event.result           = FDS_ERR_OPERATION_TIMEOUT;
+	event.write.file_id    = FILE_CONFIGURATION;
+	event.write.record_key = to_underlying_type(type);
+	storage.handleFileStorageEvent(&event);
+	assert(storageErrors.size() == 1);
+	assert(storageErrors[0].operation == CS_STORAGE_OP_WRITE);
+	assert(storageErrors[0].type == type && storageErrors[0].id == 0);
+	value++;
+	cached = writeCached(storage, type, 0, &value);
+	assert(!cached);
+	assert(getValidRecords() == 1);
+}
+
+enum SimulationMode { SINGLE, GROUP };
+
+const uint16_t NUM_RECORD_KEYS = 40;
+const uint32_t NUM_TICKS       = 20000;
+const uint32_t BURST_TICKS     = 5000;
+//! Number of FDS operations that finish per tick.
+const uint32_t OPS_PER_TICK    = 2;
+
+//! Record keys of writes that have to be retried.
+vector<uint16_t> retries;
+
+void retryWrite(cs_storage_operation_t operation, CS_TYPE type, cs_state_id_t id) {
+	assert(operation == CS_STORAGE_OP_WRITE && id == 0);
+	retries.push_back(to_underlying_type(type));
+}
+
+struct result_t {
+	cs_host_fds_stats_t fds;
+	cs_storage_stats_t totals;
+	uint32_t writes;
+	uint32_t busy;
+	uint32_t bytesWritten;
+	double ms;
+	vector<cs_storage_type_stats_t> types;
+};
+
+/**
+ * Returns the statistics that were counted since the given statistics.
+ */
+void getStatsSince(const StorageStats& before, const StorageStats& after, result_t& result) {
+	result.totals = after.getTotals();
+	result.totals.gcRuns -= before.getTotals().gcRuns;
+	result.totals.searches -= before.getTotals().searches;
+	result.totals.cacheHits -= before.getTotals().cacheHits;
+	result.totals.cacheMisses -= before.getTotals().cacheMisses;
+	result.totals.groups -= before.getTotals().groups;
+	result.types.clear();
+	result.writes       = 0;
+	result.busy         = 0;
+	result.bytesWritten = 0;
+	for (auto type : after.getTypeStats()) {
+		const cs_storage_type_stats_t* previous = before.get(type.recordKey);
+		if (previous != nullptr) {
+			type.writes -= previous->writes;
+			type.busy -= previous->busy;
+			type.bytesWritten -= previous->bytesWritten;
+		}
+		result.types.push_back(type);
+		result.writes += type.writes;
+		result.busy += type.busy;
+		result.bytesWritten += type.bytesWritten;
+	}
+}
+
+/**
+ * Simulates State writing records to Storage: a few records often, most records rarely.
+ * Every BURST_TICKS, half of the records are written at once, like a configuration sent by the app.
+ *
+ * Writes that can't be started, or are reported via the error callback, are retried the next tick.
+ */
+result_t simulate(const char* path, SimulationMode mode) {
+	Storage& storage = resetStorage(path);
+	HostFds& fds     = HostFds::getInstance();
+	storage.setErrorCallback(retryWrite);
+	retries.clear();
+
+	mt19937 rng(1234);
+	vector<vector<uint32_t>> data(NUM_RECORD_KEYS + 1);
+	vector<uint32_t> periods(NUM_RECORD_KEYS + 1);
+	for (uint16_t key = 1; key <= NUM_RECORD_KEYS; ++key) {
+		data[key].assign(1 + rng() % 16, key);
+		// Like switch state and power usage: every few ticks. Others: once in a while.
+		periods[key] = (key <= 4) ? 5 + rng() % 20 : 500 + rng() % 4000;
+	}
+
+	// Store all records once, like a crownstone that has been in use, but not in the record cache.
+	for (uint16_t key = 1; key <= NUM_RECORD_KEYS; ++key) {
+		uint32_t value      = 0;
+		fds_record_t record = makeRecord(FILE_CONFIGURATION, key, &value, 1);
+		ret_code_t nrfCode = fds_record_write(nullptr, &record);
+		assert(nrfCode == NRF_SUCCESS);
+		process();
+	}
+	fds.resetStats();
+	StorageStats before = storage.getStats();
+
+	auto write = [&](uint16_t key) {
+		cs_state_data_t stateData(
+				CS_TYPE(key),
+				0,
+				reinterpret_cast<uint8_t*>(data[key].data()),
+				data[key].size() * sizeof(uint32_t));
+		if (storage.write(stateData) != ERR_SUCCESS) {
+			retries.push_back(key);
+		}
+	};
+
+	auto start = chrono::high_resolution_clock::now();
+	for (uint32_t tick = 1; tick <= NUM_TICKS; ++tick) {
+		vector<uint16_t> keys;
+		keys.swap(retries);
+		for (uint16_t key = 1; key <= NUM_RECORD_KEYS; ++key) {
+			if (tick % periods[key] == 0 || (tick % BURST_TICKS == 1 && key % 2 == 0)) {
+				data[key][0] = tick;
+				keys.push_back(key);
+			}
+		}
+		sort(keys.begin(), keys.end());
+		keys.erase(unique(keys.begin(), keys.end()), keys.end());
+		if (mode == GROUP) {
+			storage.beginCommitGroup();
+		}
+		for (auto key : keys) {
+			write(key);
+		}
+		if (mode == GROUP) {
+			storage.commitGroup();
+		}
+		for (uint32_t i = 0; i < OPS_PER_TICK; ++i) {
+			fds.processOne();
+			app_sched_execute();
+		}
+	}
+	process();
+	while (!retries.empty()) {
+		vector<uint16_t> keys;
+		keys.swap(retries);
+		for (auto key : keys) {
+			write(key);
+		}
+		process();
+	}
+	auto end = chrono::high_resolution_clock::now();
+
+	// Each record has the last written data.
+	for (uint16_t key = 1; key <= NUM_RECORD_KEYS; ++key) {
+		fds_record_desc_t desc;
+		bool found = findLast(FILE_CONFIGURATION, key, desc);
+		assert(found);
+		assert(readWord(desc) == data[key][0]);
+	}
+
+	result_t result;
+	result.fds = fds.getStats();
+	getStatsSince(before, storage.getStats(), result);
+	result.ms = chrono::duration<double, milli>(end - start).count();
+	storage.setErrorCallback(recordStorageError);
+	return result;
+}
+
+void measure(const char* path) {
+	cout << "measure: " << NUM_RECORD_KEYS << " records, " << NUM_TICKS << " ticks, " << StorageRecordCache::SIZE
+		 << " cached records, burst every " << BURST_TICKS << " ticks" << endl;
+	const char* names[] = {"single", "group"};
+	cout << setw(12) << "mode" << setw(10) << "writes" << setw(10) << "busy" << setw(10) << "misses" << setw(10)
+		 << "searches" << setw(12) << "headers" << setw(10) << "located" << setw(12) << "kB written" << setw(8) << "gc"
+		 << setw(8) << "erases" << setw(10) << "ms" << endl;
+	result_t results[2];
+	for (int mode = SINGLE; mode <= GROUP; ++mode) {
+		result_t& result = results[mode];
+		result           = simulate(path, static_cast<SimulationMode>(mode));
+		cout << setw(12) << names[mode] << setw(10) << result.writes << setw(10) << result.busy << setw(10)
+			 << result.totals.cacheMisses << setw(10) << result.totals.searches << setw(12) << result.fds.headersRead
+			 << setw(10) << result.fds.headersLocated << setw(12) << fixed << setprecision(1)
+			 << result.fds.wordsWritten * 4 / 1024.0 << setw(8) << result.fds.gcRuns << setw(8)
+			 << result.fds.pageErases << setw(10) << setprecision(2) << result.ms << endl;
+	}
+
+	// Grouping searches once for all records of a tick that aren't cached.
+	assert(results[GROUP].totals.groups > 0);
+	assert(results[GROUP].totals.searches < results[SINGLE].totals.searches);
+	assert(results[GROUP].fds.headersRead <= results[SINGLE].fds.headersRead);
+
+	cout << "Most written types (group):" << endl;
+	vector<cs_storage_type_stats_t> types = results[GROUP].types;
+	sort(types.begin(), types.end(), [](const cs_storage_type_stats_t& a, const cs_storage_type_stats_t& b) {
+		return a.bytesWritten > b.bytesWritten;
+	});
+	for (size_t i = 0; i < 5 && i < types.size(); ++i) {
+		cout << "  key=" << types[i].recordKey << " writes=" << types[i].writes << " bytes=" << types[i].bytesWritten
+			 << " busy=" << types[i].busy << endl;
+	}
+}
+
+int main() {
+	cout << "Test storage batch" << endl;
+
+	char path[] = "/tmp/test_StorageBatch_XXXXXX";
+	int fd      = mkstemp(path);
+	assert(fd >= 0);
+	close(fd);
+
+	ret_code_t nrfCode = fds_register(handleEvent);
+	assert(nrfCode == NRF_SUCCESS);
+	testHostFds(nullptr);
+	unlink(path);
+	testHostFds(path);
+	testRecordCache();
+	testStats();
+	testStorageGroup(path);
+	testStorageGroupRemove(path);
+	testStorageCacheInvalidation(path);
+	measure(path);
+	HostFds::getInstance().close();
+	unlink(path);
+
+	cout << "Done" << endl;
+	return 0;
+}
@@ -0,0 +1,338 @@
+#define SERIAL_VERBOSITY SERIAL_DEBUG
+
+/**
+ * Replays switchcraft traces through the detector, and checks that it makes the same decisions as the previous
+ * implementation of RecognizeSwitch::detect().
+ *
+ * Arguments are optional trace files: each line holds the samples of the first, 2 center, and last buffer,
+ * 4 * 100 values separated by commas or spaces. This is the format of the samples of
+ * POWER_SAMPLES_TYPE_SWITCHCRAFT and POWER_SAMPLES_TYPE_SWITCHCRAFT_NON_TRIGGERED, concatenated.
+ * Without arguments, only generated traces are replayed.
+ */
+
+#include <processing/cs_SwitchcraftDetector.h>
+
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAS_CYCLE_COUNTER 1
+#endif
+
+using namespace std;
+
+const uint16_t CHANNEL_LENGTH = 100;
+const uint16_t NUM_BUFFERS    = 4;
+
+typedef SwitchcraftDetector<CHANNEL_LENGTH> Detector;
+
+/**
+ * A trace: interleaved samples of 4 buffers, like the ADC buffers with voltage at even indices.
+ */
+struct trace_t {
+	vector<int16_t> buffers[NUM_BUFFERS];
+};
+
+const Detector::thresholds_t defaultThresholds = {500000, 500000, 100.0};
+
+bool ignoreSampleReference(int16_t value0, int16_t value1, int16_t value2) {
+	return value0 == 2047 || value1 == 2047 || value2 == 2047;
+}
+
+/**
+ * Copy of the previous RecognizeSwitch::detect(bufQueue, voltageChannelId, iteration), without logs.
+ */
+Detector::FoundSwitch detectIterationReference(
+		const trace_t& trace, uint8_t iteration, const Detector::thresholds_t& thresholds) {
+	const vector<int16_t>& first  = trace.buffers[0];
+	const vector<int16_t>& center = trace.buffers[1 + iteration];
+	const vector<int16_t>& last   = trace.buffers[NUM_BUFFERS - 1];
+	uint16_t checkLength          = CHANNEL_LENGTH / 2;
+	uint16_t shift                = checkLength / 2;
+
+	float valueFirst, valueCenter, valueLast;
+	float diffCenterFirst, diffCenterLast, diffFirstLast;
+	float diffSumCenterFirst, diffSumCenterLast, diffSumFirstLast;
+	float minDiffSum;
+	float lowerTheshold = 0.1 * thresholds.different;
+	bool foundAlmost    = false;
+
+	for (uint16_t startInd = 0; startInd < (CHANNEL_LENGTH - shift); startInd += shift) {
+		diffSumCenterFirst = 0;
+		diffSumCenterLast  = 0;
+		diffSumFirstLast   = 0;
+		uint16_t endInd    = startInd + checkLength;
+		for (int i = startInd; i < endInd; ++i) {
+			valueFirst  = first[2 * i];
+			valueCenter = center[2 * i];
+			valueLast   = last[2 * i];
+			if (ignoreSampleReference(valueFirst, valueCenter, valueLast)) {
+				diffCenterFirst = 0;
+				diffCenterLast  = 0;
+				diffFirstLast   = 0;
+			}
+			else {
+				diffCenterFirst = (valueFirst - valueCenter) * (valueFirst - valueCenter);
+				diffCenterLast  = (valueCenter - valueLast) * (valueCenter - valueLast);
+				diffFirstLast   = (valueFirst - valueLast) * (valueFirst - valueLast);
+			}
+			diffSumCenterFirst += diffCenterFirst;
+			diffSumCenterLast += diffCenterLast;
+			diffSumFirstLast += diffFirstLast;
+		}
+
+		if (diffSumCenterFirst > thresholds.different && diffSumCenterLast > thresholds.different) {
+			minDiffSum = diffSumCenterFirst < diffSumCenterLast ? diffSumCenterFirst : diffSumCenterLast;
+			if (diffSumFirstLast < thresholds.similar || minDiffSum / diffSumFirstLast > thresholds.ratio) {
+				return Detector::True;
+			}
+		}
+		if (diffSumCenterFirst > lowerTheshold && diffSumCenterLast > lowerTheshold
+			&& diffSumFirstLast < thresholds.similar) {
+			foundAlmost = true;
+		}
+	}
+	return foundAlmost ? Detector::Almost : Detector::False;
+}
+
+/**
+ * Same loop over the center buffers as the previous RecognizeSwitch::detect(bufQueue, voltageChannelId).
+ */
+Detector::FoundSwitch detectReference(const trace_t& trace, const Detector::thresholds_t& thresholds) {
+	Detector::FoundSwitch found = Detector::False;
+	for (uint8_t i = 0; i < NUM_BUFFERS - 2; ++i) {
+		Detector::FoundSwitch tempFound = detectIterationReference(trace, i, thresholds);
+		if (tempFound == Detector::True) {
+			return tempFound;
+		}
+		if (tempFound == Detector::Almost) {
+			found = tempFound;
+		}
+	}
+	return found;
+}
+
+Detector::FoundSwitch detect(Detector& detector, const trace_t& trace, const Detector::thresholds_t& thresholds) {
+	const int16_t* buffers[NUM_BUFFERS];
+	for (uint8_t i = 0; i < NUM_BUFFERS; ++i) {
+		buffers[i] = trace.buffers[i].data();
+	}
+	return detector.detect(buffers, 2, thresholds);
+}
+
+/**
+ * Generates a trace of the voltage curve, where the load may change in the center buffers.
+ *
+ * Changing the load changes the voltage curve a bit, mostly near the top, where the voltage may also clip at 2047.
+ */
+trace_t generateTrace() {
+	trace_t trace;
+	double amplitude = 1600 + rand() % 600;
+	double phase     = (rand() % 1000) / 1000.0 * 2 * M_PI;
+	double noise     = 1 + rand() % 30;
+	// Change in the load, per buffer: 0 for first and last, random for the center buffers.
+	double change[NUM_BUFFERS] = {0, 0, 0, 0};
+	int type                   = rand() % 4;
+	if (type == 1 || type == 3) {
+		// A switch: the center buffers differ from both first and last.
+		change[1] = (rand() % 200) - 100;
+		change[2] = (rand() % 2) ? change[1] : (rand() % 200) - 100;
+	}
+	if (type == 2 || type == 3) {
+		// The load stays changed: first and last differ.
+		change[3] = (rand() % 100) - 50;
+	}
+	for (uint8_t b = 0; b < NUM_BUFFERS; ++b) {
+		trace.buffers[b].resize(2 * CHANNEL_LENGTH);
+		for (uint16_t i = 0; i < CHANNEL_LENGTH; ++i) {
+			double angle = phase + 2 * M_PI * i / CHANNEL_LENGTH;
+			double value = (amplitude + change[b]) * sin(angle) + change[b] * sin(3 * angle);
+			value += noise * ((rand() % 2001) - 1000) / 1000.0;
+			value                       = max(-2048.0, min(2047.0, round(value)));
+			trace.buffers[b][2 * i]     = value;
+			trace.buffers[b][2 * i + 1] = rand() % 4096 - 2048;
+		}
+	}
+	return trace;
+}
+
+/**
+ * Reads trace files, see the top of this file for the format.
+ */
+vector<trace_t> readTraces(const char* fileName) {
+	vector<trace_t> traces;
+	ifstream file(fileName);
+	if (!file) {
+		cout << "Could not open " << fileName << endl;
+		exit(1);
+	}
+	string line;
+	while (getline(file, line)) {
+		for (auto& c : line) {
+			if (c == ',') {
+				c = ' ';
+			}
+		}
+		istringstream stream(line);
+		vector<int> values;
+		int value;
+		while (stream >> value) {
+			values.push_back(value);
+		}
+		if (values.empty()) {
+			continue;
+		}
+		assert(values.size() == NUM_BUFFERS * CHANNEL_LENGTH);
+		trace_t trace;
+		for (uint8_t b = 0; b < NUM_BUFFERS; ++b) {
+			trace.buffers[b].resize(2 * CHANNEL_LENGTH);
+			for (uint16_t i = 0; i < CHANNEL_LENGTH; ++i) {
+				trace.buffers[b][2 * i] = values[b * CHANNEL_LENGTH + i];
+			}
+		}
+		traces.push_back(trace);
+	}
+	return traces;
+}
+
+const char* toString(Detector::FoundSwitch found) {
+	switch (found) {
+		case Detector::True: return "true";
+		case Detector::Almost: return "almost";
+		case Detector::False: return "false";
+	}
+	return "";
+}
+
+void testWindowSums(Detector& detector, const trace_t& trace) {
+	// Check the window sums of the second center buffer against plain sums.
+	// With these thresholds, a switch is never found, so both center buffers are checked.
+	Detector::thresholds_t thresholds = {1e9, 1e9, 1e9};
+	detect(detector, trace, thresholds);
+	for (uint8_t window = 0; window < Detector::NUM_WINDOWS; ++window) {
+		Detector::window_sums_t expected = {0, 0, 0};
+		for (uint16_t i = window * Detector::SHIFT; i < window * Detector::SHIFT + Detector::CHECK_LENGTH; ++i) {
+			int32_t first  = trace.buffers[0][2 * i];
+			int32_t center = trace.buffers[2][2 * i];
+			int32_t last   = trace.buffers[3][2 * i];
+			if (!ignoreSampleReference(first, center, last)) {
+				expected.centerFirst += (first - center) * (first - center);
+				expected.centerLast += (center - last) * (center - last);
+				expected.firstLast += (first - last) * (first - last);
+			}
+		}
+		Detector::window_sums_t sums = detector.getSums(window);
+		assert(sums.centerFirst == expected.centerFirst);
+		assert(sums.centerLast == expected.centerLast);
+		assert(sums.firstLast == expected.firstLast);
+	}
+}
+
+void replay(Detector& detector, const vector<trace_t>& traces, const char* name) {
+	const Detector::thresholds_t thresholdsList[] = {
+			defaultThresholds,
+			{100000, 100000, 100.0},
+			{2000000, 500000, 10.0},
+	};
+	int counts[3] = {0, 0, 0};
+	for (auto& trace : traces) {
+		testWindowSums(detector, trace);
+		for (auto& thresholds : thresholdsList) {
+			Detector::FoundSwitch expected = detectReference(trace, thresholds);
+			Detector::FoundSwitch found    = detect(detector, trace, thresholds);
+			if (found != expected) {
+				cout << "Decision " << toString(found) << " differs from " << toString(expected) << endl;
+				assert(false);
+			}
+			counts[found]++;
+		}
+	}
+	cout << "  " << name << ": " << traces.size() << " traces, decisions: true=" << counts[Detector::True]
+		 << " almost=" << counts[Detector::Almost] << " false=" << counts[Detector::False] << endl;
+}
+
+void testSameDecisions(Detector& detector, int argc, char** argv) {
+	cout << "Check that the detector makes the same decisions as the previous implementation." << endl;
+	srand(1);
+	vector<trace_t> traces;
+	int clipped = 0;
+	for (int i = 0; i < 5000; ++i) {
+		traces.push_back(generateTrace());
+		for (auto& buffer : traces.back().buffers) {
+			for (uint16_t j = 0; j < CHANNEL_LENGTH; ++j) {
+				if (Detector::ignoreSample(buffer[2 * j])) {
+					clipped++;
+					break;
+				}
+			}
+		}
+	}
+	// Make sure the clipping cases are covered.
+	assert(clipped > 1000);
+	replay(detector, traces, "generated");
+
+	for (int i = 1; i < argc; ++i) {
+		replay(detector, readTraces(argv[i]), argv[i]);
+	}
+}
+
+template <class Function>
+void measure(const char* name, const vector<trace_t>& traces, Function function) {
+	const int iterations = 20;
+	int check            = 0;
+#ifdef HAS_CYCLE_COUNTER
+	uint64_t startCycles = __rdtsc();
+#endif
+	auto start = chrono::steady_clock::now();
+	for (int i = 0; i < iterations; ++i) {
+		for (auto& trace : traces) {
+			check += function(trace);
+		}
+	}
+	auto end = chrono::steady_clock::now();
+#ifdef HAS_CYCLE_COUNTER
+	uint64_t cycles = __rdtsc() - startCycles;
+#endif
+	volatile int sink = check;
+	(void)sink;
+	double periods = (double)iterations * traces.size();
+	double seconds = chrono::duration<double>(end - start).count();
+	cout << setw(12) << name << setw(12) << fixed << setprecision(1) << seconds / periods * 1e9;
+#ifdef HAS_CYCLE_COUNTER
+	cout << setw(12) << (double)cycles / periods;
+#endif
+	cout << endl;
+}
+
+void benchmark(Detector& detector) {
+	cout << endl << "Per period: one detection over " << NUM_BUFFERS << " buffers" << endl;
+	cout << setw(12) << "" << setw(12) << "ns" << setw(12) << "tsc cycles" << endl;
+	srand(2);
+	vector<trace_t> traces;
+	for (int i = 0; i < 1000; ++i) {
+		traces.push_back(generateTrace());
+	}
+	// Use a threshold at which most traces need both center buffers checked.
+	Detector::thresholds_t thresholds = {1e9, 1e9, 1e9};
+	measure("reference", traces, [&](const trace_t& trace) { return detectReference(trace, thresholds); });
+	measure("detector", traces, [&](const trace_t& trace) { return detect(detector, trace, thresholds); });
+}
+
+int main(int argc, char** argv) {
+	cout << "Test switchcraft detector" << endl;
+
+	Detector detector;
+	testSameDecisions(detector, argc, argv);
+	benchmark(detector);
+
+	cout << "Done" << endl;
+	return 0;
+}
@@ -0,0 +1,221 @@
+#define SERIAL_VERBOSITY SERIAL_NONE
+
+/**
+ * Tests the timer wheel: expiry, restarting and stopping timers, and the tick count rolling over.
+ *
+ * Then simulates an hour of the periodic work of the components that used to check every tick event, to compare
+ * the number of calls with the number of calls via the timer wheel.
+ */
+
+#include <util/cs_TimerWheel.h>
+
+#include <cassert>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+void testExpiry(uint32_t startTickCount) {
+	cout << "Check that timers expire at the right tick, starting at tick " << startTickCount << "." << endl;
+	TimerWheel wheel(startTickCount);
+	vector<uint32_t> delays = {1, 2, 31, 32, 33, 63, 64, 1023, 1024, 1025, 32767, 32768, 32769, 100000, 1000000};
+	vector<uint32_t> calledAt(delays.size(), 0);
+	vector<WheelTimer> timers(delays.size());
+	for (size_t i = 0; i < delays.size(); ++i) {
+		timers[i].action = [&, i]() {
+			calledAt[i] = wheel.getTickCount();
+			return 0;
+		};
+		wheel.start(timers[i], delays[i]);
+	}
+
+	uint32_t tickCount = startTickCount;
+	for (uint32_t t = 0; t < 1000001; ++t) {
+		uint32_t ticksUntilNext = wheel.getTicksUntilNextExpiry();
+		wheel.advance(++tickCount);
+		// Never later than the first timer to expire.
+		for (size_t i = 0; i < delays.size(); ++i) {
+			if (timers[i].isStarted()) {
+				assert(ticksUntilNext <= timers[i].getExpiryTickCount() - (tickCount - 1));
+			}
+		}
+	}
+	for (size_t i = 0; i < delays.size(); ++i) {
+		assert(calledAt[i] == startTickCount + delays[i]);
+		assert(!timers[i].isStarted());
+	}
+	assert(wheel.getTicksUntilNextExpiry() == 0xFFFFFFFF);
+}
+
+void testPeriodic() {
+	cout << "Check that timers are called again after the returned delay, and can be stopped and restarted." << endl;
+	TimerWheel wheel(0xFFFFFF00);
+	int numCalls = 0;
+	WheelTimer periodic([&]() {
+		numCalls++;
+		return 10;
+	});
+	WheelTimer other;
+	int numOtherCalls = 0;
+	other.action = [&]() {
+		numOtherCalls++;
+		// Stop the periodic timer, and restart itself with a different delay.
+		wheel.stop(periodic);
+		wheel.start(other, 5);
+		return 100;
+	};
+
+	wheel.start(periodic, 10);
+	wheel.advance(0xFFFFFF00 + 1000);
+	assert(numCalls == 100);
+
+	wheel.start(other, 1);
+	wheel.advance(0xFFFFFF00 + 1001);
+	assert(numOtherCalls == 1);
+	assert(!periodic.isStarted());
+	assert(other.isStarted() && other.getExpiryTickCount() == 0xFFFFFF00 + 1006);
+
+	// Restarting replaces the expiry.
+	wheel.start(other, 3);
+	wheel.advance(0xFFFFFF00 + 1006);
+	assert(numOtherCalls == 2);
+	wheel.stop(other);
+	wheel.advance(0xFFFFFF00 + 2000);
+	assert(numOtherCalls == 2);
+	assert(numCalls == 100);
+}
+
+void testRandom() {
+	cout << "Check random timers against a model." << endl;
+	mt19937 random(7);
+	const uint32_t startTickCount = 0xFFF00000;
+	TimerWheel wheel(startTickCount);
+	const int numTimers = 50;
+	vector<WheelTimer> timers(numTimers);
+	// Expected expiry of each timer, 0 when stopped.
+	vector<uint64_t> expected(numTimers, 0);
+	uint64_t tickCount = startTickCount;
+	int numCalls = 0;
+	for (int i = 0; i < numTimers; ++i) {
+		timers[i].action = [&, i]() {
+			assert(expected[i] == tickCount);
+			numCalls++;
+			uint32_t delay = random() % 3 == 0 ? 0 : random() % 5000;
+			expected[i] = delay ? tickCount + delay : 0;
+			return delay;
+		};
+	}
+
+	for (int step = 0; step < 200000; ++step) {
+		int i = random() % numTimers;
+		switch (random() % 10) {
+			case 0: {
+				wheel.stop(timers[i]);
+				expected[i] = 0;
+				break;
+			}
+			case 1: case 2: {
+				uint32_t delay = 1 + (random() % 2 ? random() % 64 : random() % 100000);
+				wheel.start(timers[i], delay);
+				expected[i] = tickCount + delay;
+				break;
+			}
+			default: {
+				uint32_t ticks = 1 + random() % 200;
+				for (uint32_t t = 0; t < ticks; ++t) {
+					tickCount++;
+					wheel.advance(tickCount);
+					for (int j = 0; j < numTimers; ++j) {
+						assert(expected[j] == 0 || expected[j] > tickCount);
+						assert(timers[j].isStarted() == (expected[j] != 0));
+					}
+				}
+			}
+		}
+	}
+	assert(tickCount > 0xFFFFFFFF);
+	assert(numCalls > 1000);
+}
+
+/**
+ * Periodic work of the components that used to check every tick: period in ms.
+ */
+struct periodic_work_t {
+	const char* name;
+	uint32_t periodMs;
+};
+
+void simulateHour() {
+	const uint32_t tickIntervalMs = 100;
+	const uint32_t ticksPerHour   = 3600 * 1000 / tickIntervalMs;
+	vector<periodic_work_t> work = {
+			{"AssetStore last received counters", 1000},
+			{"AssetStore throttle counters", 100},
+			{"PresenceHandler tick second", 1000},
+			{"MeshTopology tick second", 1000},
+			{"TrackedDevices tick second", 1000},
+			{"TrackedDevices tick minute", 60 * 1000},
+			{"SystemTime sync", 20 * 60 * 1000},
+	};
+	// Number of components that received every tick event for this work.
+	const uint32_t numTickListeners = 5;
+
+	// Before: each listener is called every tick, and checks whether there is work to do.
+	uint32_t callsBefore = numTickListeners * ticksPerHour;
+	uint32_t workBefore  = 0;
+	for (auto& item : work) {
+		workBefore += ticksPerHour / (item.periodMs / tickIntervalMs);
+	}
+
+	// After: only the timers that are due are called.
+	TimerWheel wheel;
+	vector<WheelTimer> timers(work.size());
+	for (size_t i = 0; i < work.size(); ++i) {
+		uint32_t periodTicks = work[i].periodMs / tickIntervalMs;
+		timers[i].action = [periodTicks]() { return periodTicks; };
+		wheel.start(timers[i], periodTicks);
+	}
+	wheel.advance(ticksPerHour);
+	const cs_timer_wheel_stats_t& stats = wheel.getStats();
+	assert(stats.numCalls == workBefore);
+
+	// Without the throttle counters of the AssetStore, which have work every tick.
+	TimerWheel sparseWheel;
+	vector<WheelTimer> sparseTimers(work.size());
+	for (size_t i = 0; i < work.size(); ++i) {
+		if (work[i].periodMs == tickIntervalMs) {
+			continue;
+		}
+		uint32_t periodTicks = work[i].periodMs / tickIntervalMs;
+		sparseTimers[i].action = [periodTicks]() { return periodTicks; };
+		sparseWheel.start(sparseTimers[i], periodTicks);
+	}
+	sparseWheel.advance(ticksPerHour);
+
+	cout << endl << "Simulated hour, " << ticksPerHour << " ticks:" << endl;
+	cout << "  tick event handlers called: " << setw(7) << callsBefore << " (of which " << workBefore << " with work)"
+			<< endl;
+	cout << "  timer actions called:       " << setw(7) << stats.numCalls << ", idle ticks " << stats.numIdleTicks
+			<< ", cascades " << stats.numCascades << endl;
+	cout << "  without 100 ms timer:       " << setw(7) << sparseWheel.getStats().numCalls << ", idle ticks "
+			<< sparseWheel.getStats().numIdleTicks << endl;
+
+	assert(stats.numCalls < callsBefore / 2);
+	assert(sparseWheel.getStats().numIdleTicks > ticksPerHour * 8 / 10);
+}
+
+int main() {
+	cout << "Test timer wheel" << endl;
+
+	testExpiry(0);
+	testExpiry(0xFFFFFFFF - 50000);
+	testPeriodic();
+	testRandom();
+	simulateHour();
+
+	cout << "Done" << endl;
+	return 0;
+}
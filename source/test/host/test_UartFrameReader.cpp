@@ -0,0 +1,269 @@
+#define SERIAL_VERBOSITY SERIAL_DEBUG
+
+/**
+ * Tests the UART frame reader: streams frames written by the UART frame writer through it, byte by byte,
+ * like the UART interrupt does, while a simulated app scheduler handles the read frames.
+ */
+
+#include <uart/cs_UartFrameReader.h>
+#include <uart/cs_UartFrameWriter.h>
+
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+const uint16_t FRAME_SIZE = 192;
+
+/**
+ * Size of the smallest frame that is streamed: start byte, headers, index, and tail.
+ */
+const size_t MIN_FRAME_SIZE =
+		1 + sizeof(uart_msg_size_header_t) + sizeof(uart_msg_wrapper_header_t) + 4 + sizeof(uart_msg_tail_t);
+
+/**
+ * Sink that collects the written bytes.
+ */
+class VectorSink {
+public:
+	vector<uint8_t> bytes;
+
+	bool reserve(uint16_t) { return true; }
+
+	void write(const uint8_t* data, uint16_t size) { bytes.insert(bytes.end(), data, data + size); }
+};
+
+/**
+ * Payloads with many bytes that need escaping.
+ */
+vector<uint8_t> createPayload(uint32_t index) {
+	vector<uint8_t> payload(rand() % 150);
+	for (auto& val : payload) {
+		switch (rand() % 4) {
+			case 0: val = UART_START_BYTE; break;
+			case 1: val = UART_ESCAPE_BYTE; break;
+			default: val = rand();
+		}
+	}
+	// Put the index in front, so dropped frames can be identified.
+	payload.insert(payload.begin(), reinterpret_cast<uint8_t*>(&index), reinterpret_cast<uint8_t*>(&index) + 4);
+	return payload;
+}
+
+struct stream_t {
+	vector<uint8_t> bytes;
+	vector<vector<uint8_t>> payloads;
+};
+
+stream_t createStream(uint32_t numFrames) {
+	stream_t stream;
+	VectorSink sink;
+	UartFrameWriter<VectorSink> writer(sink);
+	for (uint32_t i = 0; i < numFrames; ++i) {
+		auto payload = createPayload(i);
+		writer.start(UartMsgType::UART_MSG, payload.size());
+		writer.write(payload.data(), payload.size(), true);
+		writer.end();
+		stream.payloads.push_back(payload);
+	}
+	stream.bytes = sink.bytes;
+	return stream;
+}
+
+/**
+ * Checks the CRC of a read frame, like UartHandler does, and returns the payload.
+ */
+vector<uint8_t> getPayload(const uint8_t* frame, uint16_t size) {
+	assert(size >= sizeof(uart_msg_wrapper_header_t) + sizeof(uart_msg_tail_t));
+	uint16_t crcSize = size - sizeof(uart_msg_tail_t);
+	uint16_t crc     = UartProtocol::crc16(frame, crcSize);
+	uint16_t tailCrc = frame[crcSize] | (frame[crcSize + 1] << 8);
+	assert(crc == tailCrc);
+	return vector<uint8_t>(frame + sizeof(uart_msg_wrapper_header_t), frame + crcSize);
+}
+
+template <uint8_t NumFrames>
+void handleAll(UartFrameReader<FRAME_SIZE, NumFrames>& reader, vector<vector<uint8_t>>& received) {
+	uint16_t size;
+	uint8_t* frame;
+	while ((frame = reader.peek(size)) != nullptr) {
+		received.push_back(getPayload(frame, size));
+		reader.pop();
+	}
+}
+
+/**
+ * Stream all bytes back to back, and handle the read frames with a delay, like the app scheduler does.
+ *
+ * @param latency     Number of bytes that are read, before the scheduled handling is executed.
+ * @return            Number of dropped frames.
+ */
+template <uint8_t NumFrames>
+uint32_t streamWithLatency(const stream_t& stream, size_t latency) {
+	UartFrameReader<FRAME_SIZE, NumFrames> reader;
+	vector<uint8_t> buffer(reader.BUFFER_SIZE);
+	reader.setBuffer(buffer.data());
+
+	vector<vector<uint8_t>> received;
+	bool scheduled      = false;
+	size_t handleAtByte = 0;
+	for (size_t i = 0; i < stream.bytes.size(); ++i) {
+		if (scheduled && i == handleAtByte) {
+			scheduled = false;
+			handleAll(reader, received);
+		}
+		if (reader.onRead(stream.bytes[i]) && !scheduled) {
+			scheduled    = true;
+			handleAtByte = i + latency;
+		}
+	}
+	handleAll(reader, received);
+
+	// Frames are either received intact and in order, or dropped and counted.
+	assert(reader.getDiscardedCount() == 0);
+	assert(reader.getFrameCount() == received.size());
+	assert(reader.getFrameCount() + reader.getOverflowCount() == stream.payloads.size());
+	size_t index = 0;
+	for (auto& payload : received) {
+		while (stream.payloads[index] != payload) {
+			index++;
+			assert(index < stream.payloads.size());
+		}
+		index++;
+	}
+	return reader.getOverflowCount();
+}
+
+void testFullRate(const stream_t& stream) {
+	cout << "Check that no frame is lost at full rate, when handling keeps up." << endl;
+	// Handling takes as long as reading 3 of the smallest frames: with 4 slots, there is always a free slot.
+	size_t latency = 3 * MIN_FRAME_SIZE;
+	assert(streamWithLatency<4>(stream, latency) == 0);
+	assert(streamWithLatency<4>(stream, 1) == 0);
+
+	// With a single slot, like the single read buffer before, frames are lost.
+	uint32_t dropped = streamWithLatency<1>(stream, latency);
+	assert(dropped > 0);
+	cout << "  " << stream.payloads.size() << " frames: 4 slots dropped 0, 1 slot dropped " << dropped << endl;
+}
+
+void testOverflow(const stream_t& stream) {
+	cout << "Check that frames are counted as overflow, when handling doesn't keep up." << endl;
+	// Handling takes as long as reading 20 average frames.
+	uint32_t dropped = streamWithLatency<4>(stream, 20 * stream.bytes.size() / stream.payloads.size());
+	assert(dropped > 0);
+	cout << "  " << dropped << " frames dropped" << endl;
+}
+
+void testMalformed() {
+	cout << "Check that malformed frames are discarded, and don't affect the next frames." << endl;
+	UartFrameReader<FRAME_SIZE, 4> reader;
+	vector<uint8_t> buffer(reader.BUFFER_SIZE);
+
+	// Bytes are ignored until there is a buffer.
+	auto stream = createStream(4);
+	for (auto val : stream.bytes) {
+		assert(!reader.onRead(val));
+	}
+	reader.setBuffer(buffer.data());
+
+	vector<vector<uint8_t>> expected;
+	vector<uint8_t> bytes;
+	auto addFrame = [&]() {
+		stream = createStream(1);
+		bytes.insert(bytes.end(), stream.bytes.begin(), stream.bytes.end());
+		expected.push_back(stream.payloads[0]);
+	};
+
+	// Noise before the first start byte is ignored.
+	bytes = {1, 2, 3, UART_ESCAPE_BYTE, 4};
+	addFrame();
+
+	// Incomplete frame, followed by a start byte.
+	stream = createStream(1);
+	bytes.insert(bytes.end(), stream.bytes.begin(), stream.bytes.begin() + stream.bytes.size() / 2);
+	addFrame();
+
+	// Escape followed by an escape.
+	bytes.insert(bytes.end(), {UART_START_BYTE, 10, 0, UART_ESCAPE_BYTE, UART_ESCAPE_BYTE, 1, 2});
+	addFrame();
+
+	// Size too large.
+	uint16_t size = FRAME_SIZE + 1;
+	bytes.insert(bytes.end(), {UART_START_BYTE, (uint8_t)size, (uint8_t)(size >> 8), 1, 2, 3});
+	addFrame();
+
+	// Size 0.
+	bytes.insert(bytes.end(), {UART_START_BYTE, 0, 0, 1, 2, 3});
+	addFrame();
+
+	vector<vector<uint8_t>> received;
+	for (auto val : bytes) {
+		if (reader.onRead(val)) {
+			handleAll(reader, received);
+		}
+	}
+	assert(received == expected);
+	assert(reader.getFrameCount() == expected.size());
+	assert(reader.getDiscardedCount() == 4);
+	assert(reader.getOverflowCount() == 0);
+}
+
+void testThreads(const stream_t& stream) {
+	cout << "Check the reader with the interrupt and the handler on different threads." << endl;
+	UartFrameReader<FRAME_SIZE, 4> reader;
+	vector<uint8_t> buffer(reader.BUFFER_SIZE);
+	reader.setBuffer(buffer.data());
+
+	vector<vector<uint8_t>> received;
+	atomic<bool> done = {false};
+	thread handler([&]() {
+		while (true) {
+			bool last = done;
+			handleAll(reader, received);
+			if (last) {
+				break;
+			}
+			this_thread::yield();
+		}
+	});
+	for (size_t i = 0; i < stream.bytes.size(); ++i) {
+		reader.onRead(stream.bytes[i]);
+		if (i % 64 == 0) {
+			this_thread::yield();
+		}
+	}
+	done = true;
+	handler.join();
+
+	// Some frames may have been dropped, depending on the thread scheduling, but never corrupted.
+	assert(reader.getDiscardedCount() == 0);
+	assert(reader.getFrameCount() == received.size());
+	assert(reader.getFrameCount() + reader.getOverflowCount() == stream.payloads.size());
+	size_t index = 0;
+	for (auto& payload : received) {
+		while (stream.payloads[index] != payload) {
+			index++;
+			assert(index < stream.payloads.size());
+		}
+		index++;
+	}
+}
+
+int main() {
+	cout << "Test UART frame reader" << endl;
+	srand(1);
+	auto stream = createStream(20000);
+
+	testFullRate(stream);
+	testOverflow(stream);
+	testMalformed();
+	testThreads(stream);
+
+	cout << "Done" << endl;
+	return 0;
+}